@@ -0,0 +1,804 @@
+/*
+    arbench.c - benchmark listing large ar archives (static libraries)
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://en.wikipedia.org/wiki/Ar_(Unix)
+    https://www.freebsd.org/cgi/man.cgi?query=ar&sektion=5
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    arbench lists each of the given ar archives three ways, and
+    reports, as JSON, the median wall time, the bytes read and the
+    number of reads for each:
+
+        list    - archive_read_next_header() for every member,
+                  without reading any data
+        members - arInfoRead(), which lists the members from their
+                  headers alone
+        symbols - arInfoRead() with ArInfoSymbolCounts, which also
+                  counts each member's symbols in the symbol index
+
+    along with the archive's size, members and symbols.  Each way is
+    run repeatedly (-r), after one warm up run that is not counted.
+    With -m, arbench instead writes a sparse GNU or BSD archive of the
+    given number of members, 512 bytes to 16KB each, with long names
+    and 1 to BENCHMAXSYMBOLS symbols each, and a 64 bit symbol index
+    if the members go past 4GB.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+#include "arinfo.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* the ways of listing an archive */
+
+enum
+{
+    gBenchList    = 0,
+    gBenchMembers = 1,
+    gBenchSymbols = 2,
+    gBenchWays    = 3,
+};
+
+/* defines */
+
+#define BENCHMAXREPS     100
+#define BENCHBLOCKSIZE   65536
+#define BENCHMAXMEMBERS  ARINFOMAXMEMBERS
+#define BENCHMINSIZE     512
+#define BENCHMAXSIZE     16384
+#define BENCHMAXSYMBOLS  8
+#define BENCHSEED        0x9E3779B97F4A7C15ULL
+
+/* ar definitions */
+
+#define ARMAGIC          "!<arch>\n"
+#define ARMAGICLEN       8
+#define ARHEADERLEN      60
+
+/* the file read by libarchive, and the bytes read from it */
+
+typedef struct benchFile
+{
+    int fd;
+    uint64_t bytesRead;
+    uint64_t reads;
+    unsigned char buf[BENCHBLOCKSIZE];
+} benchFile_t;
+
+/* the result of one archive */
+
+typedef struct benchRun
+{
+    const char *archive;
+    uint64_t compressedBytes;
+    uint64_t entries;
+    uint64_t bytesRead[gBenchWays];
+    uint64_t reads[gBenchWays];
+    double wallMs[gBenchWays];
+    arInfo_t info;
+} benchRun_t;
+
+/* globals */
+
+static const char *gWays[gBenchWays] =
+{
+    "list",
+    "members",
+    "symbols",
+};
+
+/* private functions */
+
+static void putBE(unsigned char *buf, uint64_t value, size_t width);
+static void putLE(unsigned char *buf, uint64_t value, size_t width);
+static int benchWriteHeader(FILE *fp,
+                            const char *name,
+                            uint64_t size);
+static la_ssize_t benchReadCallback(struct archive *a,
+                                    void *data,
+                                    const void **buf);
+static la_int64_t benchSkipCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t request);
+static la_int64_t benchSeekCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t offset,
+                                    int whence);
+static int benchMakeAr(const char *path,
+                       unsigned long numMembers,
+                       int isBSD);
+static int benchList(benchRun_t *run, int how);
+static void printUsage(void);
+
+/* putBE - store a big endian value of width bytes */
+
+static void putBE(unsigned char *buf, uint64_t value, size_t width)
+{
+    size_t i = 0;
+
+    for (i = 0; i < width; i++)
+    {
+        buf[width - 1 - i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+/* putLE - store a little endian value of width bytes */
+
+static void putLE(unsigned char *buf, uint64_t value, size_t width)
+{
+    size_t i = 0;
+
+    for (i = 0; i < width; i++)
+    {
+        buf[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+/* benchWriteHeader - write a member header */
+
+static int benchWriteHeader(FILE *fp,
+                            const char *name,
+                            uint64_t size)
+{
+    char h[ARHEADERLEN + 1];
+
+    snprintf(h,
+             sizeof(h),
+             "%-16.16s%-12d%-6d%-6d%-8o%-10llu`\n",
+             name,
+             1700000000,
+             0,
+             0,
+             0100644,
+             (unsigned long long)size);
+
+    return (fwrite(h, 1, ARHEADERLEN, fp) == ARHEADERLEN ?
+            gBenchOkay : gBenchErr);
+}
+
+/* benchReadCallback - read the next block of the archive */
+
+static la_ssize_t benchReadCallback(struct archive *a,
+                                    void *data,
+                                    const void **buf)
+{
+    benchFile_t *file = data;
+    ssize_t bytesRead = 0;
+
+    (void)a;
+
+    do
+    {
+        bytesRead = read(file->fd, file->buf, sizeof(file->buf));
+        file->reads++;
+    } while (bytesRead < 0 && errno == EINTR);
+
+    if (bytesRead > 0)
+    {
+        file->bytesRead += (uint64_t)bytesRead;
+    }
+
+    *buf = file->buf;
+
+    return bytesRead;
+}
+
+/* benchSkipCallback - skip part of the archive without reading it */
+
+static la_int64_t benchSkipCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t request)
+{
+    benchFile_t *file = data;
+
+    (void)a;
+
+    if (lseek(file->fd, (off_t)request, SEEK_CUR) < 0)
+    {
+        return 0;
+    }
+
+    return request;
+}
+
+/* benchSeekCallback - seek in the archive */
+
+static la_int64_t benchSeekCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t offset,
+                                    int whence)
+{
+    benchFile_t *file = data;
+
+    (void)a;
+
+    return (la_int64_t)lseek(file->fd, (off_t)offset, whence);
+}
+
+/*
+    benchMakeAr - write an archive of numMembers members, with a GNU
+                  symbol index and long name table or, if isBSD, a
+                  BSD symbol index and "#1/" long names; the members'
+                  data is left as holes
+*/
+
+static int benchMakeAr(const char *path,
+                       unsigned long numMembers,
+                       int isBSD)
+{
+    unsigned char *table = NULL;
+    unsigned char *p = NULL;
+    uint64_t *offsets = NULL;
+    uint32_t *sizes = NULL;
+    uint8_t *symbols = NULL;
+    char name[64];
+    FILE *fp = NULL;
+    uint64_t state = BENCHSEED;
+    uint64_t numSymbols = 0;
+    uint64_t stringsLen = 0;
+    uint64_t namesLen = 0;
+    uint64_t tableLen = 0;
+    uint64_t pos = 0;
+    size_t width = 4;
+    size_t len = 0;
+    unsigned long m = 0;
+    unsigned int s = 0;
+    int ret = gBenchErr;
+
+    if (numMembers == 0 || numMembers > BENCHMAXMEMBERS)
+    {
+        fprintf(stderr,
+                "arbench: ERROR: an archive has 1 to %d members\n",
+                BENCHMAXMEMBERS);
+        return gBenchErr;
+    }
+
+    offsets = malloc(numMembers * sizeof(uint64_t));
+    sizes = malloc(numMembers * sizeof(uint32_t));
+    symbols = malloc(numMembers);
+    if (offsets == NULL || sizes == NULL || symbols == NULL)
+    {
+        goto done;
+    }
+
+    /* the members and their symbols, "module%07lu_s%u" */
+
+    for (m = 0; m < numMembers; m++)
+    {
+        sizes[m] = (uint32_t)(BENCHMINSIZE +
+                              benchRand(&state) %
+                              (BENCHMAXSIZE - BENCHMINSIZE));
+        symbols[m] = (uint8_t)(1 + benchRand(&state) % BENCHMAXSYMBOLS);
+        numSymbols += symbols[m];
+        for (s = 0; s < symbols[m]; s++)
+        {
+            stringsLen += (uint64_t)snprintf(name,
+                                             sizeof(name),
+                                             "module%07lu_s%u",
+                                             m,
+                                             s) + 1;
+        }
+        namesLen += (uint64_t)snprintf(name,
+                                       sizeof(name),
+                                       "module%07lu_with_a_long_name.o",
+                                       m);
+    }
+
+    /*
+        lay the archive out twice: with a 32 bit symbol index, and
+        with a 64 bit one if the members end past 4GB
+    */
+
+    for (;;)
+    {
+        if (isBSD)
+        {
+            tableLen = 2 * width + numSymbols * 2 * width + stringsLen;
+        }
+        else
+        {
+            tableLen = width * (numSymbols + 1) + stringsLen;
+        }
+        tableLen += tableLen & 1;
+
+        pos = ARMAGICLEN + ARHEADERLEN + tableLen;
+        if (!isBSD)
+        {
+            pos += ARHEADERLEN + namesLen + 2 * numMembers;
+            pos += pos & 1;
+        }
+
+        for (m = 0; m < numMembers; m++)
+        {
+            offsets[m] = pos;
+            len = (size_t)snprintf(name,
+                                   sizeof(name),
+                                   "module%07lu_with_a_long_name.o",
+                                   m);
+            pos += ARHEADERLEN + sizes[m] + (isBSD ? len : 0);
+            pos += pos & 1;
+        }
+
+        if (width == 8 || offsets[numMembers - 1] <= UINT32_MAX)
+        {
+            break;
+        }
+        width = 8;
+    }
+
+    table = calloc(1, (size_t)(tableLen > namesLen + 2 * numMembers ?
+                               tableLen : namesLen + 2 * numMembers) + 1);
+    if (table == NULL)
+    {
+        goto done;
+    }
+
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        fprintf(stderr,
+                "arbench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    if (fwrite(ARMAGIC, 1, ARMAGICLEN, fp) != ARMAGICLEN)
+    {
+        goto done;
+    }
+
+    /* the symbol index */
+
+    p = table;
+    if (isBSD)
+    {
+        putLE(p, numSymbols * 2 * width, width);
+        p += width;
+        for (m = 0, stringsLen = 0; m < numMembers; m++)
+        {
+            for (s = 0; s < symbols[m]; s++)
+            {
+                putLE(p, stringsLen, width);
+                putLE(p + width, offsets[m], width);
+                p += 2 * width;
+                stringsLen += (uint64_t)snprintf(name,
+                                                 sizeof(name),
+                                                 "module%07lu_s%u",
+                                                 m,
+                                                 s) + 1;
+            }
+        }
+        putLE(p, stringsLen, width);
+        p += width;
+    }
+    else
+    {
+        putBE(p, numSymbols, width);
+        p += width;
+        for (m = 0; m < numMembers; m++)
+        {
+            for (s = 0; s < symbols[m]; s++)
+            {
+                putBE(p, offsets[m], width);
+                p += width;
+            }
+        }
+    }
+
+    for (m = 0; m < numMembers; m++)
+    {
+        for (s = 0; s < symbols[m]; s++)
+        {
+            p += snprintf((char *)p, 64, "module%07lu_s%u", m, s) + 1;
+        }
+    }
+
+    if (benchWriteHeader(fp,
+                         (isBSD ?
+                          (width == 8 ? "__.SYMDEF_64" : "__.SYMDEF") :
+                          (width == 8 ? "/SYM64/" : "/")),
+                         tableLen) != gBenchOkay ||
+        fwrite(table, 1, (size_t)tableLen, fp) != tableLen)
+    {
+        goto done;
+    }
+
+    /* the GNU long name table */
+
+    if (!isBSD)
+    {
+        p = table;
+        for (m = 0; m < numMembers; m++)
+        {
+            p += snprintf((char *)p,
+                          64,
+                          "module%07lu_with_a_long_name.o/\n",
+                          m);
+        }
+        len = (size_t)(p - table);
+        if (benchWriteHeader(fp, "//", len) != gBenchOkay ||
+            fwrite(table, 1, len + (len & 1), fp) != len + (len & 1))
+        {
+            goto done;
+        }
+    }
+
+    /* the members, whose data is skipped over */
+
+    for (m = 0, namesLen = 0; m < numMembers; m++)
+    {
+        len = (size_t)snprintf((char *)table,
+                               64,
+                               "module%07lu_with_a_long_name.o",
+                               m);
+        if (fseeko(fp, (off_t)offsets[m], SEEK_SET) != 0)
+        {
+            goto done;
+        }
+        if (isBSD)
+        {
+            snprintf(name, sizeof(name), "#1/%zu", len);
+            if (benchWriteHeader(fp, name, sizes[m] + len) != gBenchOkay ||
+                fwrite(table, 1, len, fp) != len)
+            {
+                goto done;
+            }
+        }
+        else
+        {
+            snprintf(name, sizeof(name), "/%llu",
+                     (unsigned long long)namesLen);
+            if (benchWriteHeader(fp, name, sizes[m]) != gBenchOkay)
+            {
+                goto done;
+            }
+            namesLen += len + 2;
+        }
+    }
+
+    if (fflush(fp) != 0 || ftruncate(fileno(fp), (off_t)pos) != 0)
+    {
+        goto done;
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (fp != NULL && fclose(fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    if (ret != gBenchOkay)
+    {
+        fprintf(stderr, "arbench: ERROR: cannot write '%s'\n", path);
+    }
+    free(table);
+    free(offsets);
+    free(sizes);
+    free(symbols);
+
+    return ret;
+}
+
+/* benchList - list run->archive one way */
+
+static int benchList(benchRun_t *run, int how)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    benchFile_t *file = NULL;
+    const char *pathname = NULL;
+    int r = ARCHIVE_OK;
+    int ret = gBenchErr;
+
+    if (how == gBenchMembers || how == gBenchSymbols)
+    {
+        arInfoFree(&run->info);
+        if (arInfoRead(run->archive,
+                       (how == gBenchSymbols ? ArInfoSymbolCounts : 0),
+                       &run->info) != gArInfoOkay)
+        {
+            fprintf(stderr,
+                    "arbench: ERROR: cannot list the members of '%s'\n",
+                    run->archive);
+            return gBenchErr;
+        }
+        run->bytesRead[how] = run->info.bytesRead;
+        run->reads[how] = run->info.reads;
+        return gBenchOkay;
+    }
+
+    file = calloc(1, sizeof(benchFile_t));
+    a = archive_read_new();
+    if (file == NULL || a == NULL)
+    {
+        goto done;
+    }
+
+    file->fd = open(run->archive, O_RDONLY | O_CLOEXEC);
+    if (file->fd < 0)
+    {
+        fprintf(stderr,
+                "arbench: ERROR: cannot open '%s': %s\n",
+                run->archive,
+                strerror(errno));
+        goto done;
+    }
+
+    archive_read_support_format_ar(a);
+    archive_read_set_callback_data(a, file);
+    archive_read_set_read_callback(a, benchReadCallback);
+    archive_read_set_skip_callback(a, benchSkipCallback);
+    archive_read_set_seek_callback(a, benchSeekCallback);
+
+    if (archive_read_open1(a) != ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "arbench: ERROR: cannot open '%s': %s\n",
+                run->archive,
+                archive_error_string(a));
+        goto done;
+    }
+
+    /* the symbol index and long name table are listed too */
+
+    run->entries = 0;
+
+    while ((r = archive_read_next_header(a, &entry)) == ARCHIVE_OK)
+    {
+        pathname = archive_entry_pathname(entry);
+        if (pathname != NULL &&
+            strcmp(pathname, "/") != 0 &&
+            strcmp(pathname, "/SYM64/") != 0 &&
+            strcmp(pathname, "//") != 0 &&
+            strncmp(pathname, "__.SYMDEF", 9) != 0)
+        {
+            run->entries++;
+        }
+    }
+
+    if (r != ARCHIVE_EOF)
+    {
+        fprintf(stderr,
+                "arbench: ERROR: cannot list '%s': %s\n",
+                run->archive,
+                archive_error_string(a));
+        goto done;
+    }
+
+    run->bytesRead[how] = file->bytesRead;
+    run->reads[how] = file->reads;
+    ret = gBenchOkay;
+
+done:
+    if (a != NULL)
+    {
+        archive_read_free(a);
+    }
+    if (file != NULL && file->fd >= 0)
+    {
+        close(file->fd);
+    }
+    free(file);
+
+    return ret;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: arbench [-r repetitions] [-o output.json] archive ...\n"
+            "       arbench -m members gnu|bsd archive\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t *runs = NULL;
+    const char *output = NULL;
+    double times[BENCHMAXREPS];
+    struct stat sb;
+    uint64_t start = 0;
+    unsigned long makeMembers = 0;
+    FILE *fp = stdout;
+    int numRuns = 0;
+    int numReps = 3;
+    int run = 0;
+    int how = 0;
+    int ret = 1;
+    int r = 0;
+    int i = 1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeMembers = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeMembers > 0)
+    {
+        if (i + 2 != argc ||
+            (strcmp(argv[i], "gnu") != 0 && strcmp(argv[i], "bsd") != 0))
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeAr(argv[i + 1],
+                            makeMembers,
+                            strcmp(argv[i], "bsd") == 0) == gBenchOkay ?
+                0 : 1);
+    }
+
+    if (i >= argc || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    numRuns = argc - i;
+    runs = calloc((size_t)numRuns, sizeof(benchRun_t));
+    if (runs == NULL)
+    {
+        return 1;
+    }
+
+    /* the first repetition of each way is a warm up */
+
+    for (run = 0; run < numRuns; run++)
+    {
+        runs[run].archive = argv[i + run];
+        if (stat(runs[run].archive, &sb) == 0)
+        {
+            runs[run].compressedBytes = (uint64_t)sb.st_size;
+        }
+
+        for (how = 0; how < gBenchWays; how++)
+        {
+            for (r = -1; r < numReps; r++)
+            {
+                start = benchNow();
+                if (benchList(&runs[run], how) != gBenchOkay)
+                {
+                    goto done;
+                }
+                if (r >= 0)
+                {
+                    times[r] = (double)(benchNow() - start) / 1000000.0;
+                }
+            }
+
+            runs[run].wallMs[how] = benchMedian(times, numReps);
+        }
+
+        if (runs[run].info.numMembers != runs[run].entries)
+        {
+            fprintf(stderr,
+                    "arbench: ERROR: '%s': %llu entries listed, but %u "
+                    "in the headers\n",
+                    runs[run].archive,
+                    (unsigned long long)runs[run].entries,
+                    runs[run].info.numMembers);
+            goto done;
+        }
+    }
+
+    fp = benchOpenOutput("arbench", output);
+    if (fp == NULL)
+    {
+        goto done;
+    }
+
+    fprintf(fp, "{\n  \"runs\": [\n");
+
+    for (run = 0; run < numRuns; run++)
+    {
+        fprintf(fp,
+                "    {\"archive\": \"%s\", \"format\": \"%s\", "
+                "\"compressedBytes\": %llu, \"entries\": %llu, "
+                "\"symbols\": %llu, \"membersWithSymbols\": %u,\n",
+                runs[run].archive,
+                arInfoFormatName(runs[run].info.format),
+                (unsigned long long)runs[run].compressedBytes,
+                (unsigned long long)runs[run].entries,
+                (unsigned long long)runs[run].info.numSymbols,
+                runs[run].info.membersWithSymbols);
+
+        for (how = 0; how < gBenchWays; how++)
+        {
+            fprintf(fp,
+                    "     \"%sMs\": %.2f, \"%sBytesRead\": %llu, "
+                    "\"%sReads\": %llu%s\n",
+                    gWays[how],
+                    runs[run].wallMs[how],
+                    gWays[how],
+                    (unsigned long long)runs[run].bytesRead[how],
+                    gWays[how],
+                    (unsigned long long)runs[run].reads[how],
+                    (how + 1 < gBenchWays ? "," : ""));
+        }
+
+        fprintf(fp,
+                "    }%s\n",
+                (run + 1 < numRuns ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    ret = 0;
+
+done:
+    if (benchCloseOutput(fp) != 0)
+    {
+        ret = 1;
+    }
+    for (run = 0; run < numRuns; run++)
+    {
+        arInfoFree(&runs[run].info);
+    }
+    free(runs);
+
+    return ret;
+}
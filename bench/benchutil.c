@@ -0,0 +1,153 @@
+/*
+    benchutil.c - timing and output functions shared by the benchmarks
+
+    History:
+
+    v. 0.1.0 (10/18/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+
+#include "benchutil.h"
+
+/* public functions */
+
+/* benchNow - get the current monotonic time in nanoseconds */
+
+uint64_t benchNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* benchRand - xorshift64* pseudo random numbers */
+
+uint64_t benchRand(uint64_t *state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+/* benchCompareDouble - qsort() comparison function for doubles */
+
+int benchCompareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x < y ? -1 : (x > y ? 1 : 0));
+}
+
+/* benchMedian - get the median of numReps times, sorting them */
+
+double benchMedian(double *times, int numReps)
+{
+    if (numReps <= 0)
+    {
+        return 0.0;
+    }
+
+    qsort(times, (size_t)numReps, sizeof(double), benchCompareDouble);
+
+    return (numReps % 2 == 1 ?
+            times[numReps / 2] :
+            (times[numReps / 2 - 1] + times[numReps / 2]) / 2.0);
+}
+
+/* benchPrintJSONString - print str as a JSON string */
+
+void benchPrintJSONString(FILE *fp, const char *str)
+{
+    fputc('"', fp);
+    for (; *str != '\0'; str++)
+    {
+        if (*str == '"' || *str == '\\')
+        {
+            fprintf(fp, "\\%c", *str);
+        }
+        else if ((unsigned char)*str < 0x20)
+        {
+            fprintf(fp, "\\u%04x", (unsigned char)*str);
+        }
+        else
+        {
+            fputc(*str, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+/*
+    benchOpenOutput - open output for the results, or return stdout if
+                      output is NULL; prints an error for the benchmark
+                      name and returns NULL if output can't be created
+*/
+
+FILE *benchOpenOutput(const char *name, const char *output)
+{
+    FILE *fp = NULL;
+
+    if (output == NULL)
+    {
+        return stdout;
+    }
+
+    fp = fopen(output, "w");
+    if (fp == NULL)
+    {
+        fprintf(stderr,
+                "%s: ERROR: cannot create '%s': %s\n",
+                name,
+                output,
+                strerror(errno));
+    }
+
+    return fp;
+}
+
+/*
+    benchCloseOutput - close fp, unless it is stdout or NULL; returns
+                       -1 if the results couldn't be written out
+*/
+
+int benchCloseOutput(FILE *fp)
+{
+    if (fp == NULL || fp == stdout)
+    {
+        return 0;
+    }
+
+    return (fclose(fp) == 0 ? 0 : -1);
+}
@@ -0,0 +1,53 @@
+/*
+    benchutil.h - timing and output functions shared by the benchmarks
+
+    History:
+
+    v. 0.1.0 (10/18/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    Each benchmark times its runs with benchNow(), reports the median
+    of the counted runs with benchMedian(), and writes its JSON to
+    the file given with -o, or to stdout, opened with
+    benchOpenOutput() and closed with benchCloseOutput().
+*/
+
+#ifndef bench_benchutil_h
+#define bench_benchutil_h
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* prototypes */
+
+uint64_t benchNow(void);
+uint64_t benchRand(uint64_t *state);
+int benchCompareDouble(const void *a, const void *b);
+double benchMedian(double *times, int numReps);
+void benchPrintJSONString(FILE *fp, const char *str);
+FILE *benchOpenOutput(const char *name, const char *output);
+int benchCloseOutput(FILE *fp);
+
+#endif /* bench_benchutil_h */
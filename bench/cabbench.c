@@ -0,0 +1,782 @@
+/*
+    cabbench.c - benchmark listing multi-folder cabinets
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://learn.microsoft.com/en-us/previous-versions/bb417343(v=msdn.10)
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    cabbench lists each of the given cabinets three ways, and reports,
+    as JSON, the median wall time and the bytes read for each:
+
+        list          - archive_read_next_header() for every entry,
+                        without reading any data
+        listAfterRead - the same, after reading the data of the first
+                        entry, as the preview does when the first
+                        entry is an archive
+        folders       - cabInfoRead(), which lists the folders, and
+                        their sizes, from the header tables alone
+
+    along with the cabinet's size, entries and, for each folder, its
+    compression, files, and compressed and uncompressed sizes.  Each
+    way is run repeatedly (-r), after one warm up run that is not
+    counted.  With -m, cabbench instead writes a cabinet of size MB
+    in the given number of MSZIP folders, each with BENCHFILES files
+    of text and random data.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+#include "cabinfo.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* the ways of listing a cabinet */
+
+enum
+{
+    gBenchList          = 0,
+    gBenchListAfterRead = 1,
+    gBenchFolders       = 2,
+    gBenchWays          = 3,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHFILES     8
+#define BENCHCHUNK     64
+#define BENCHBLOCKSIZE 65536
+#define BENCHMAXFOLDERS 4096
+
+/* cab definitions */
+
+#define CABHEADERLEN   36
+#define CABFOLDERLEN   8
+#define CABFILELEN     16
+#define CABDATALEN     8
+#define CABFRAME       32768
+#define CABMAXDATA     (CABFRAME + 6144)
+
+/* the file read by libarchive, and the bytes read from it */
+
+typedef struct benchFile
+{
+    int fd;
+    uint64_t bytesRead;
+    unsigned char buf[BENCHBLOCKSIZE];
+} benchFile_t;
+
+/* the result of one cabinet */
+
+typedef struct benchRun
+{
+    const char *cabinet;
+    uint64_t compressedBytes;
+    uint64_t entries;
+    uint64_t bytesRead[gBenchWays];
+    double wallMs[gBenchWays];
+    cabInfo_t info;
+} benchRun_t;
+
+/* globals */
+
+static const char *gWays[gBenchWays] =
+{
+    "list",
+    "listAfterRead",
+    "folders",
+};
+
+static const char *gPhrase =
+    "The setup program copies the files of the product to the computer. "
+    "Copyright (C) Example Corporation. All rights reserved. ";
+
+/* private functions */
+
+static void putLE16(unsigned char *buf, uint16_t value);
+static void putLE32(unsigned char *buf, uint32_t value);
+static void benchFill(unsigned char *p, size_t size, uint64_t seed);
+static la_ssize_t benchReadCallback(struct archive *a,
+                                    void *data,
+                                    const void **buf);
+static la_int64_t benchSkipCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t request);
+static la_int64_t benchSeekCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t offset,
+                                    int whence);
+static int benchMakeCab(const char *path,
+                        unsigned long sizeMB,
+                        unsigned long numFolders);
+static int benchList(benchRun_t *run, int how);
+static void printUsage(void);
+
+/* putLE16 - store a 16 bit little endian value */
+
+static void putLE16(unsigned char *buf, uint16_t value)
+{
+    buf[0] = (unsigned char)(value & 0xff);
+    buf[1] = (unsigned char)((value >> 8) & 0xff);
+}
+
+/* putLE32 - store a 32 bit little endian value */
+
+static void putLE32(unsigned char *buf, uint32_t value)
+{
+    putLE16(buf, (uint16_t)(value & 0xffff));
+    putLE16(buf + 2, (uint16_t)((value >> 16) & 0xffff));
+}
+
+/* benchFill - fill p with chunks of text, three quarters, and random bytes */
+
+static void benchFill(unsigned char *p, size_t size, uint64_t seed)
+{
+    uint64_t state = seed | 1;
+    size_t phraseLen = strlen(gPhrase);
+    size_t pos = 0;
+    size_t len = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    while (pos < size)
+    {
+        len = (size - pos < BENCHCHUNK ? size - pos : BENCHCHUNK);
+
+        if (benchRand(&state) % 4 != 0)
+        {
+            i = (size_t)(benchRand(&state) % phraseLen);
+            for (j = 0; j < len; j++)
+            {
+                p[pos + j] = (unsigned char)gPhrase[i];
+                i = (i + 1) % phraseLen;
+            }
+        }
+        else
+        {
+            for (j = 0; j < len; j++)
+            {
+                p[pos + j] = (unsigned char)benchRand(&state);
+            }
+        }
+
+        pos += len;
+    }
+}
+
+/* benchReadCallback - read the next block of the cabinet */
+
+static la_ssize_t benchReadCallback(struct archive *a,
+                                    void *data,
+                                    const void **buf)
+{
+    benchFile_t *file = data;
+    ssize_t bytesRead = 0;
+
+    (void)a;
+
+    do
+    {
+        bytesRead = read(file->fd, file->buf, sizeof(file->buf));
+    } while (bytesRead < 0 && errno == EINTR);
+
+    if (bytesRead > 0)
+    {
+        file->bytesRead += (uint64_t)bytesRead;
+    }
+
+    *buf = file->buf;
+
+    return bytesRead;
+}
+
+/* benchSkipCallback - skip part of the cabinet without reading it */
+
+static la_int64_t benchSkipCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t request)
+{
+    benchFile_t *file = data;
+
+    (void)a;
+
+    if (lseek(file->fd, (off_t)request, SEEK_CUR) < 0)
+    {
+        return 0;
+    }
+
+    return request;
+}
+
+/* benchSeekCallback - seek in the cabinet */
+
+static la_int64_t benchSeekCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t offset,
+                                    int whence)
+{
+    benchFile_t *file = data;
+
+    (void)a;
+
+    return (la_int64_t)lseek(file->fd, (off_t)offset, whence);
+}
+
+/*
+    benchMakeCab - write a cabinet of sizeMB in numFolders MSZIP
+                   folders of BENCHFILES files each; every 32KB frame
+                   is compressed on its own
+*/
+
+static int benchMakeCab(const char *path,
+                        unsigned long sizeMB,
+                        unsigned long numFolders)
+{
+    unsigned char hdr[CABHEADERLEN];
+    unsigned char rec[CABFILELEN];
+    unsigned char out[CABDATALEN + CABMAXDATA];
+    char name[64];
+    z_stream zs;
+    unsigned char *data = NULL;
+    FILE *fp = NULL;
+    size_t size = (size_t)sizeMB * 1024 * 1024;
+    size_t folderSize = 0;
+    size_t fileSize = 0;
+    size_t numFrames = 0;
+    size_t namesLen = 0;
+    size_t start = 0;
+    size_t end = 0;
+    size_t len = 0;
+    uint32_t dataOffset = 0;
+    long total = 0;
+    unsigned long folder = 0;
+    int zInit = 0;
+    int i = 0;
+    int ret = gBenchErr;
+
+    if (numFolders == 0 || numFolders > BENCHMAXFOLDERS)
+    {
+        fprintf(stderr,
+                "cabbench: ERROR: a cabinet has 1 to %d folders\n",
+                BENCHMAXFOLDERS);
+        return gBenchErr;
+    }
+
+    folderSize = size / numFolders;
+    fileSize = folderSize / BENCHFILES;
+    numFrames = (folderSize + CABFRAME - 1) / CABFRAME;
+
+    if (fileSize == 0 || numFrames > 65535 || size > 0xFFFFFFFFUL / 2)
+    {
+        fprintf(stderr,
+                "cabbench: ERROR: a folder holds %d bytes to 2GB, and a "
+                "cabinet under 2GB\n",
+                BENCHFILES);
+        return gBenchErr;
+    }
+
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs,
+                     Z_DEFAULT_COMPRESSION,
+                     Z_DEFLATED,
+                     -15,
+                     8,
+                     Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return gBenchErr;
+    }
+    zInit = 1;
+
+    data = malloc(folderSize);
+    if (data == NULL)
+    {
+        goto done;
+    }
+
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        fprintf(stderr,
+                "cabbench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    for (folder = 0; folder < numFolders; folder++)
+    {
+        for (i = 0; i < BENCHFILES; i++)
+        {
+            namesLen += CABFILELEN + (size_t)snprintf(name,
+                                                      sizeof(name),
+                                                      "folder%04lu/file%02d.dat",
+                                                      folder,
+                                                      i) + 1;
+        }
+    }
+
+    /* CFHEADER; cbCabinet is filled in at the end */
+
+    memset(hdr, 0, sizeof(hdr));
+    memcpy(hdr, "MSCF", 4);
+    putLE32(hdr + 16, (uint32_t)(CABHEADERLEN + CABFOLDERLEN * numFolders));
+    hdr[24] = 3;
+    hdr[25] = 1;
+    putLE16(hdr + 26, (uint16_t)numFolders);
+    putLE16(hdr + 28, (uint16_t)(BENCHFILES * numFolders));
+
+    if (fwrite(hdr, 1, CABHEADERLEN, fp) != CABHEADERLEN)
+    {
+        goto done;
+    }
+
+    /*
+        CFFOLDERs; the folders' CFDATA offsets are filled in as they
+        are written
+    */
+
+    memset(rec, 0, sizeof(rec));
+    for (folder = 0; folder < numFolders; folder++)
+    {
+        putLE16(rec + 4, (uint16_t)numFrames);
+        putLE16(rec + 6, 1);
+        if (fwrite(rec, 1, CABFOLDERLEN, fp) != CABFOLDERLEN)
+        {
+            goto done;
+        }
+    }
+
+    /* CFFILEs; the last file of a folder gets the rest of its data */
+
+    for (folder = 0; folder < numFolders; folder++)
+    {
+        for (i = 0; i < BENCHFILES; i++)
+        {
+            len = (size_t)snprintf(name,
+                                   sizeof(name),
+                                   "folder%04lu/file%02d.dat",
+                                   folder,
+                                   i);
+            putLE32(rec, (uint32_t)(i + 1 < BENCHFILES ?
+                                    fileSize :
+                                    folderSize - fileSize * (BENCHFILES - 1)));
+            putLE32(rec + 4, (uint32_t)(fileSize * i));
+            putLE16(rec + 8, (uint16_t)folder);
+            putLE16(rec + 10, (uint16_t)((2024 - 1980) << 9 | 3 << 5 | 9));
+            putLE16(rec + 12, (uint16_t)(14 << 11 | 30 << 5 | 0));
+            putLE16(rec + 14, 0x20);
+            if (fwrite(rec, 1, CABFILELEN, fp) != CABFILELEN ||
+                fwrite(name, 1, len + 1, fp) != len + 1)
+            {
+                goto done;
+            }
+        }
+    }
+
+    /* CFDATA blocks, "CK" and a deflate stream for each frame */
+
+    dataOffset = (uint32_t)(CABHEADERLEN + CABFOLDERLEN * numFolders +
+                            namesLen);
+
+    for (folder = 0; folder < numFolders; folder++)
+    {
+        putLE32(rec, dataOffset);
+        if (fseek(fp,
+                  (long)(CABHEADERLEN + CABFOLDERLEN * folder),
+                  SEEK_SET) != 0 ||
+            fwrite(rec, 1, 4, fp) != 4 ||
+            fseek(fp, (long)dataOffset, SEEK_SET) != 0)
+        {
+            goto done;
+        }
+
+        benchFill(data, folderSize, 0x9E3779B97F4A7C15ULL * (folder + 1));
+
+        for (start = 0; start < folderSize; start = end)
+        {
+            end = (start + CABFRAME < folderSize ?
+                   start + CABFRAME : folderSize);
+
+            deflateReset(&zs);
+            zs.next_in = data + start;
+            zs.avail_in = (uInt)(end - start);
+            zs.next_out = out + CABDATALEN + 2;
+            zs.avail_out = CABMAXDATA - 2;
+            if (deflate(&zs, Z_FINISH) != Z_STREAM_END)
+            {
+                fprintf(stderr, "cabbench: ERROR: frame is too large\n");
+                goto done;
+            }
+
+            len = 2 + (size_t)zs.total_out;
+            putLE32(out, 0);
+            putLE16(out + 4, (uint16_t)len);
+            putLE16(out + 6, (uint16_t)(end - start));
+            out[CABDATALEN] = 'C';
+            out[CABDATALEN + 1] = 'K';
+            if (fwrite(out, 1, CABDATALEN + len, fp) != CABDATALEN + len)
+            {
+                goto done;
+            }
+
+            dataOffset += (uint32_t)(CABDATALEN + len);
+        }
+    }
+
+    total = ftell(fp);
+    putLE32(hdr + 8, (uint32_t)total);
+    if (total < 0 || fseek(fp, 0, SEEK_SET) != 0 ||
+        fwrite(hdr, 1, CABHEADERLEN, fp) != CABHEADERLEN)
+    {
+        goto done;
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (fp != NULL && fclose(fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    if (ret != gBenchOkay)
+    {
+        fprintf(stderr, "cabbench: ERROR: cannot write '%s'\n", path);
+    }
+    if (zInit)
+    {
+        deflateEnd(&zs);
+    }
+    free(data);
+
+    return ret;
+}
+
+/* benchList - list run->cabinet one way */
+
+static int benchList(benchRun_t *run, int how)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    benchFile_t *file = NULL;
+    unsigned char buf[BENCHBLOCKSIZE];
+    la_ssize_t bytesRead = 0;
+    int r = ARCHIVE_OK;
+    int ret = gBenchErr;
+
+    if (how == gBenchFolders)
+    {
+        cabInfoFree(&run->info);
+        if (cabInfoRead(run->cabinet, &run->info) != gCabInfoOkay)
+        {
+            fprintf(stderr,
+                    "cabbench: ERROR: cannot list the folders of '%s'\n",
+                    run->cabinet);
+            return gBenchErr;
+        }
+        run->bytesRead[how] = run->info.bytesRead;
+        return gBenchOkay;
+    }
+
+    file = calloc(1, sizeof(benchFile_t));
+    a = archive_read_new();
+    if (file == NULL || a == NULL)
+    {
+        goto done;
+    }
+
+    file->fd = open(run->cabinet, O_RDONLY | O_CLOEXEC);
+    if (file->fd < 0)
+    {
+        fprintf(stderr,
+                "cabbench: ERROR: cannot open '%s': %s\n",
+                run->cabinet,
+                strerror(errno));
+        goto done;
+    }
+
+    archive_read_support_format_cab(a);
+    archive_read_set_callback_data(a, file);
+    archive_read_set_read_callback(a, benchReadCallback);
+    archive_read_set_skip_callback(a, benchSkipCallback);
+    archive_read_set_seek_callback(a, benchSeekCallback);
+
+    if (archive_read_open1(a) != ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "cabbench: ERROR: cannot open '%s': %s\n",
+                run->cabinet,
+                archive_error_string(a));
+        goto done;
+    }
+
+    run->entries = 0;
+
+    while ((r = archive_read_next_header(a, &entry)) == ARCHIVE_OK)
+    {
+        if (how == gBenchListAfterRead && run->entries == 0)
+        {
+            while ((bytesRead = archive_read_data(a, buf, sizeof(buf))) > 0)
+            {
+            }
+            if (bytesRead < 0)
+            {
+                r = ARCHIVE_FATAL;
+                break;
+            }
+        }
+        run->entries++;
+    }
+
+    if (r != ARCHIVE_EOF)
+    {
+        fprintf(stderr,
+                "cabbench: ERROR: cannot list '%s': %s\n",
+                run->cabinet,
+                archive_error_string(a));
+        goto done;
+    }
+
+    run->bytesRead[how] = file->bytesRead;
+    ret = gBenchOkay;
+
+done:
+    if (a != NULL)
+    {
+        archive_read_free(a);
+    }
+    if (file != NULL && file->fd >= 0)
+    {
+        close(file->fd);
+    }
+    free(file);
+
+    return ret;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: cabbench [-r repetitions] [-o output.json] cabinet ...\n"
+            "       cabbench -m size MB folders cabinet\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t *runs = NULL;
+    cabFolder_t *folder = NULL;
+    const char *output = NULL;
+    double times[BENCHMAXREPS];
+    struct stat sb;
+    uint64_t start = 0;
+    unsigned long makeMB = 0;
+    uint32_t f = 0;
+    FILE *fp = stdout;
+    int numRuns = 0;
+    int numReps = 3;
+    int run = 0;
+    int how = 0;
+    int ret = 1;
+    int r = 0;
+    int i = 1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeMB = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeMB > 0)
+    {
+        if (i + 2 != argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeCab(argv[i + 1],
+                             makeMB,
+                             strtoul(argv[i], NULL, 10)) == gBenchOkay ?
+                0 : 1);
+    }
+
+    if (i >= argc || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    numRuns = argc - i;
+    runs = calloc((size_t)numRuns, sizeof(benchRun_t));
+    if (runs == NULL)
+    {
+        return 1;
+    }
+
+    /* the first repetition of each way is a warm up */
+
+    for (run = 0; run < numRuns; run++)
+    {
+        runs[run].cabinet = argv[i + run];
+        if (stat(runs[run].cabinet, &sb) == 0)
+        {
+            runs[run].compressedBytes = (uint64_t)sb.st_size;
+        }
+
+        for (how = 0; how < gBenchWays; how++)
+        {
+            for (r = -1; r < numReps; r++)
+            {
+                start = benchNow();
+                if (benchList(&runs[run], how) != gBenchOkay)
+                {
+                    goto done;
+                }
+                if (r >= 0)
+                {
+                    times[r] = (double)(benchNow() - start) / 1000000.0;
+                }
+            }
+
+            runs[run].wallMs[how] = benchMedian(times, numReps);
+        }
+
+        if (runs[run].info.entries != runs[run].entries)
+        {
+            fprintf(stderr,
+                    "cabbench: ERROR: '%s': %llu entries listed, but %u "
+                    "in the tables\n",
+                    runs[run].cabinet,
+                    (unsigned long long)runs[run].entries,
+                    runs[run].info.entries);
+            goto done;
+        }
+    }
+
+    fp = benchOpenOutput("cabbench", output);
+    if (fp == NULL)
+    {
+        goto done;
+    }
+
+    fprintf(fp, "{\n  \"runs\": [\n");
+
+    for (run = 0; run < numRuns; run++)
+    {
+        fprintf(fp,
+                "    {\"cabinet\": \"%s\", \"compressedBytes\": %llu, "
+                "\"entries\": %llu,\n",
+                runs[run].cabinet,
+                (unsigned long long)runs[run].compressedBytes,
+                (unsigned long long)runs[run].entries);
+
+        for (how = 0; how < gBenchWays; how++)
+        {
+            fprintf(fp,
+                    "     \"%sMs\": %.2f, \"%sBytesRead\": %llu,\n",
+                    gWays[how],
+                    runs[run].wallMs[how],
+                    gWays[how],
+                    (unsigned long long)runs[run].bytesRead[how]);
+        }
+
+        fprintf(fp, "     \"folders\": [\n");
+
+        for (f = 0; f < runs[run].info.numFolders; f++)
+        {
+            folder = &runs[run].info.folders[f];
+            fprintf(fp,
+                    "       {\"compression\": \"%s\", \"files\": %u, "
+                    "\"compressedBytes\": %llu, \"bytes\": %llu}%s\n",
+                    cabInfoCompressName(folder->compression),
+                    folder->files,
+                    (unsigned long long)(folder->hasSizes ?
+                                         folder->compressedSize : 0),
+                    (unsigned long long)(folder->hasSizes ?
+                                         folder->uncompressedSize :
+                                         folder->filesSize),
+                    (f + 1 < runs[run].info.numFolders ? "," : ""));
+        }
+
+        fprintf(fp,
+                "     ]}%s\n",
+                (run + 1 < numRuns ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    ret = 0;
+
+done:
+    if (benchCloseOutput(fp) != 0)
+    {
+        ret = 1;
+    }
+    for (run = 0; run < numRuns; run++)
+    {
+        cabInfoFree(&runs[run].info);
+    }
+    free(runs);
+
+    return ret;
+}
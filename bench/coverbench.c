@@ -0,0 +1,589 @@
+/*
+    coverbench.c - benchmark reading the cover of a comic book or ePub
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    coverbench reads the cover of each of the given comic books
+    (.cbz) or ePubs two ways, and reports, as JSON, for each archive:
+
+        libarchive - archive_read_next_header() over every entry, to
+                     find the first page (which, for a comic, can't be
+                     known until every name is seen), then, reading
+                     the archive again, the headers up to the cover
+                     and the cover with archive_read_data()
+        cover      - coverRead() (see cover.h): the time to find and
+                     read the cover, the bytes of the archive read and
+                     decoded, and the speed up over libarchive
+
+    The libarchive way is only timed for comics, and is checked to
+    find the same cover.  Each way is run repeatedly (-r), after one
+    warm up run that is not counted, and the median wall time is
+    reported.  With -m, coverbench instead writes a comic book of
+    about the given number of MB of stored pages, BENCHMINPAGE to
+    BENCHMAXPAGE bytes of JPEG markers and noise each, in shuffled
+    order, and a ComicInfo.xml, so that the archive doesn't depend on
+    the code being measured.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <locale.h>
+#include <zlib.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+
+#include "cover.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHMAXMB     4000
+#define BENCHMINPAGE   (1024 * 1024)
+#define BENCHMAXPAGE   (4 * 1024 * 1024)
+#define BENCHMAXPAGES  4096
+#define BENCHMAXNAME   4096
+#define BENCHCDLEN     46
+
+/* private functions */
+
+static unsigned char *benchPut16(unsigned char *p, unsigned int v);
+static unsigned char *benchPut32(unsigned char *p, uint32_t v);
+static int benchIsPage(const char *name);
+static int benchMakeComic(const char *path, unsigned long megabytes);
+static ssize_t benchLibarchive(const char *path,
+                               char *name,
+                               size_t nameLen,
+                               unsigned char *buf,
+                               size_t maxLen,
+                               uint64_t *headers);
+static void printUsage(void);
+
+/* benchPut16 - put a little endian 16 bit value */
+
+static unsigned char *benchPut16(unsigned char *p, unsigned int v)
+{
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+
+    return p + 2;
+}
+
+/* benchPut32 - put a little endian 32 bit value */
+
+static unsigned char *benchPut32(unsigned char *p, uint32_t v)
+{
+    p = benchPut16(p, v & 0xFFFF);
+
+    return benchPut16(p, v >> 16);
+}
+
+/*
+    benchIsPage - check if a name is a page's, as benchMakeComic()
+                  names them, so that names sort by strcmp()
+*/
+
+static int benchIsPage(const char *name)
+{
+    size_t len = strlen(name);
+
+    return (len > 4 && strcmp(name + len - 4, ".jpg") == 0);
+}
+
+/*
+    benchMakeComic - write a comic book of about megabytes MB of
+                     stored pages, in shuffled order, and a
+                     ComicInfo.xml
+*/
+
+static int benchMakeComic(const char *path, unsigned long megabytes)
+{
+    static const char comicInfo[] =
+        "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        "<ComicInfo>\n"
+        "  <Title>Benchmark</Title>\n"
+        "  <Number>1</Number>\n"
+        "</ComicInfo>\n";
+    static const unsigned char jfif[] =
+    {
+        0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 'J', 'F', 'I', 'F', 0x00,
+        0x01, 0x01, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00,
+    };
+    unsigned long order[BENCHMAXPAGES];
+    size_t sizes[BENCHMAXPAGES];
+    unsigned char header[128];
+    unsigned char *data = NULL;
+    unsigned char *cd = NULL;
+    unsigned char *h = NULL;
+    unsigned char *c = NULL;
+    char name[64];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint64_t noise = 0;
+    uint64_t total = 0;
+    uint64_t offset = 0;
+    uint32_t crc = 0;
+    unsigned long numPages = 0;
+    unsigned long page = 0;
+    unsigned long i = 0;
+    unsigned long j = 0;
+    unsigned long t = 0;
+    size_t cdLen = 0;
+    size_t nameLen = 0;
+    size_t size = 0;
+    size_t k = 0;
+    FILE *fp = NULL;
+    int ret = gBenchErr;
+
+    if (megabytes > BENCHMAXMB)
+    {
+        fprintf(stderr, "coverbench: ERROR: too many MB\n");
+        return gBenchErr;
+    }
+
+    for (total = 0;
+         total < (uint64_t)megabytes * 1024 * 1024 &&
+         numPages < BENCHMAXPAGES;
+         numPages++)
+    {
+        sizes[numPages] = BENCHMINPAGE +
+                          (size_t)(benchRand(&state) %
+                                   (BENCHMAXPAGE - BENCHMINPAGE + 1));
+        order[numPages] = numPages;
+        total += sizes[numPages];
+    }
+
+    /* shuffle the pages, so the cover isn't where a reader starts */
+
+    for (i = numPages; i > 1; i--)
+    {
+        j = (unsigned long)(benchRand(&state) % i);
+        t = order[i - 1];
+        order[i - 1] = order[j];
+        order[j] = t;
+    }
+
+    data = malloc(BENCHMAXPAGE + sizeof(noise));
+    cd = malloc((numPages + 1) * (BENCHCDLEN + sizeof(name)));
+    fp = fopen(path, "wb");
+    if (data == NULL || cd == NULL || fp == NULL)
+    {
+        fprintf(stderr,
+                "coverbench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    for (i = 0; i <= numPages; i++)
+    {
+        if (i < numPages)
+        {
+            page = order[i];
+            size = sizes[page];
+            memcpy(data, jfif, sizeof(jfif));
+            for (k = sizeof(jfif); k + 2 < size; k += 8)
+            {
+                noise = benchRand(&state);
+                memcpy(data + k, &noise, sizeof(noise));
+            }
+            data[size - 2] = 0xFF;
+            data[size - 1] = 0xD9;
+            snprintf(name,
+                     sizeof(name),
+                     "Issue 01/page%03lu.jpg",
+                     page + 1);
+        }
+        else
+        {
+            size = sizeof(comicInfo) - 1;
+            memcpy(data, comicInfo, size);
+            snprintf(name, sizeof(name), "ComicInfo.xml");
+        }
+        nameLen = strlen(name);
+
+        crc = (uint32_t)crc32(0, data, (uInt)size);
+
+        /* the local header and the data */
+
+        h = header;
+        h = benchPut32(h, 0x04034B50);
+        h = benchPut16(h, 10);
+        h = benchPut16(h, 0);
+        h = benchPut16(h, 0);
+        h = benchPut16(h, 0x6000);
+        h = benchPut16(h, 0x5D31);
+        h = benchPut32(h, crc);
+        h = benchPut32(h, (uint32_t)size);
+        h = benchPut32(h, (uint32_t)size);
+        h = benchPut16(h, (unsigned int)nameLen);
+        h = benchPut16(h, 0);
+        memcpy(h, name, nameLen);
+        h += nameLen;
+
+        if (fwrite(header, 1, (size_t)(h - header), fp) !=
+                (size_t)(h - header) ||
+            fwrite(data, 1, size, fp) != size)
+        {
+            fprintf(stderr,
+                    "coverbench: ERROR: cannot write '%s': %s\n",
+                    path,
+                    strerror(errno));
+            goto done;
+        }
+
+        /* the central directory entry is the same, plus the offset */
+
+        c = cd + cdLen;
+        c = benchPut32(c, 0x02014B50);
+        c = benchPut16(c, 0x030A);
+        memcpy(c, header + 4, 26);
+        c += 26;
+        c = benchPut16(c, 0);
+        c = benchPut16(c, 0);
+        c = benchPut16(c, 0);
+        c = benchPut32(c, 0100644U << 16);
+        c = benchPut32(c, (uint32_t)offset);
+        memcpy(c, name, nameLen);
+        c += nameLen;
+        cdLen = (size_t)(c - cd);
+
+        offset += (uint64_t)(h - header) + size;
+    }
+
+    h = header;
+    h = benchPut32(h, 0x06054B50);
+    h = benchPut16(h, 0);
+    h = benchPut16(h, 0);
+    h = benchPut16(h, (unsigned int)numPages + 1);
+    h = benchPut16(h, (unsigned int)numPages + 1);
+    h = benchPut32(h, (uint32_t)cdLen);
+    h = benchPut32(h, (uint32_t)offset);
+    h = benchPut16(h, 0);
+
+    if (fwrite(cd, 1, cdLen, fp) != cdLen ||
+        fwrite(header, 1, (size_t)(h - header), fp) !=
+            (size_t)(h - header))
+    {
+        fprintf(stderr,
+                "coverbench: ERROR: cannot write '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (fp != NULL && fclose(fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    free(data);
+    free(cd);
+
+    return ret;
+}
+
+/*
+    benchLibarchive - list the archive to find its first page, then
+                      read the headers up to it, and it, with
+                      libarchive
+*/
+
+static ssize_t benchLibarchive(const char *path,
+                               char *name,
+                               size_t nameLen,
+                               unsigned char *buf,
+                               size_t maxLen,
+                               uint64_t *headers)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    const char *entryName = NULL;
+    ssize_t len = -1;
+    ssize_t n = 0;
+    int pass = 0;
+    int r = ARCHIVE_OK;
+
+    *headers = 0;
+    name[0] = '\0';
+
+    for (pass = 0; pass < 2; pass++)
+    {
+        a = archive_read_new();
+        if (a == NULL)
+        {
+            return -1;
+        }
+
+        archive_read_support_format_all(a);
+        archive_read_support_filter_all(a);
+
+        if (archive_read_open_filename(a, path, 65536) != ARCHIVE_OK)
+        {
+            archive_read_free(a);
+            return -1;
+        }
+
+        for (;;)
+        {
+            r = archive_read_next_header(a, &entry);
+            if (r == ARCHIVE_EOF || r < ARCHIVE_WARN)
+            {
+                break;
+            }
+            (*headers)++;
+
+            entryName = archive_entry_pathname_utf8(entry);
+            if (entryName == NULL)
+            {
+                entryName = archive_entry_pathname(entry);
+            }
+            if (entryName == NULL || !benchIsPage(entryName))
+            {
+                continue;
+            }
+
+            if (pass == 0)
+            {
+                if (name[0] == '\0' || strcmp(entryName, name) < 0)
+                {
+                    snprintf(name, nameLen, "%s", entryName);
+                }
+                continue;
+            }
+
+            if (strcmp(entryName, name) == 0)
+            {
+                for (len = 0; (size_t)len < maxLen; len += n)
+                {
+                    n = archive_read_data(a, buf + len, maxLen - len);
+                    if (n <= 0)
+                    {
+                        break;
+                    }
+                }
+                break;
+            }
+        }
+
+        archive_read_free(a);
+
+        if (name[0] == '\0')
+        {
+            return -1;
+        }
+    }
+
+    return len;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: coverbench [-r repetitions] [-o output.json] "
+            "archive ...\n"
+            "       coverbench -m MB archive.cbz\n");
+}
+
+int main(int argc, char **argv)
+{
+    cover_t cover;
+    const char *output = NULL;
+    char name[BENCHMAXNAME];
+    unsigned char *buf = NULL;
+    double times[BENCHMAXREPS];
+    double libarchiveMs = 0.0;
+    double coverMs = 0.0;
+    uint64_t start = 0;
+    uint64_t headers = 0;
+    unsigned long makeMB = 0;
+    ssize_t libarchiveLen = 0;
+    FILE *fp = stdout;
+    int numReps = 3;
+    int arc = 0;
+    int ret = 1;
+    int r = 0;
+    int i = 1;
+
+    memset(&cover, 0, sizeof(cover_t));
+
+    /* libarchive converts names that aren't ASCII for the locale */
+
+    setlocale(LC_ALL, "");
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeMB = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeMB > 0)
+    {
+        if (i + 1 != argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeComic(argv[i], makeMB) == gBenchOkay ? 0 : 1);
+    }
+
+    if (i >= argc || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    buf = malloc(COVERMAXSIZE);
+    if (buf == NULL)
+    {
+        goto done;
+    }
+
+    fp = benchOpenOutput("coverbench", output);
+    if (fp == NULL)
+    {
+        goto done;
+    }
+
+    fprintf(fp, "{\n  \"archives\": [\n");
+
+    for (arc = i; arc < argc; arc++)
+    {
+        /* the first repetition of each way is a warm up */
+
+        for (r = -1; r < numReps; r++)
+        {
+            coverFree(&cover);
+            start = benchNow();
+            if (coverRead(argv[arc], &cover) != gCoverOkay)
+            {
+                fprintf(stderr,
+                        "coverbench: ERROR: no cover in '%s'\n",
+                        argv[arc]);
+                goto done;
+            }
+            if (r >= 0)
+            {
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+            }
+        }
+        coverMs = benchMedian(times, numReps);
+
+        libarchiveMs = 0.0;
+        headers = 0;
+        if (cover.kind == CoverKindComic)
+        {
+            for (r = -1; r < numReps; r++)
+            {
+                start = benchNow();
+                libarchiveLen = benchLibarchive(argv[arc],
+                                                name,
+                                                sizeof(name),
+                                                buf,
+                                                COVERMAXSIZE,
+                                                &headers);
+                if (libarchiveLen < 0 ||
+                    strcmp(name, cover.name) != 0 ||
+                    (size_t)libarchiveLen != cover.len ||
+                    memcmp(buf, cover.data, cover.len) != 0)
+                {
+                    fprintf(stderr,
+                            "coverbench: ERROR: covers of '%s' differ\n",
+                            argv[arc]);
+                    goto done;
+                }
+                if (r >= 0)
+                {
+                    times[r] = (double)(benchNow() - start) / 1000000.0;
+                }
+            }
+            libarchiveMs = benchMedian(times, numReps);
+        }
+
+        fprintf(fp,
+                "    {\"archive\": \"%s\", \"kind\": \"%s\", "
+                "\"entries\": %u, \"cover\": \"%s\", \"bytes\": %zu,\n"
+                "     \"libarchive\": {\"headers\": %llu, "
+                "\"wallMs\": %.2f},\n"
+                "     \"cover\": {\"wallMs\": %.2f, \"bytesRead\": %llu, "
+                "\"bytesDecoded\": %llu, \"speedup\": %.1f}}%s\n",
+                argv[arc],
+                (cover.kind == CoverKindEPub ? "epub" : "comic"),
+                cover.numEntries,
+                cover.name,
+                cover.len,
+                (unsigned long long)headers,
+                libarchiveMs,
+                coverMs,
+                (unsigned long long)cover.bytesRead,
+                (unsigned long long)cover.bytesDecoded,
+                (coverMs > 0.0 ? libarchiveMs / coverMs : 0.0),
+                (arc + 1 < argc ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    ret = 0;
+
+done:
+    coverFree(&cover);
+    free(buf);
+    benchCloseOutput(fp);
+
+    return ret;
+}
@@ -0,0 +1,622 @@
+/*
+    cpiobench.c - benchmark reading the headers of large cpio archives
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://www.kernel.org/doc/html/latest/driver-api/early-userspace/buffer-format.html
+    https://pubs.opengroup.org/onlinepubs/007908799/xcu/pax.html
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    cpiobench lists each of the given cpio archives with libarchive's
+    cpio reader, calling archive_read_next_header() for every entry
+    without reading any data, as the preview does, and reports, as
+    JSON, for each archive:
+
+        archive, bytes - the archive and its size
+        entries        - the number of entries
+        wallMs         - the median wall time to list it
+        headersPerSec  - entries / wallMs
+        bytesRead      - the bytes read from the archive
+        bytesSkipped   - the bytes of member data that the reader
+                         skipped with a seek rather than reading them
+
+    The archive is listed repeatedly (-r), after one warm up run that
+    is not counted.  With -m, cpiobench instead writes an archive of
+    the given number of entries, laid out like a Linux initramfs:
+    directories, symlinks, small scripts and configuration files, and
+    larger modules.  The format is newc, odc, or junk, which is newc
+    with random bytes before each header, so that the reader has to
+    search for every header but the first.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* the formats that -m writes */
+
+enum
+{
+    gBenchNewc = 0,
+    gBenchOdc  = 1,
+    gBenchJunk = 2,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHBLOCKSIZE 65536
+#define BENCHDIRFILES  32
+#define BENCHSMALL     512
+#define BENCHLARGE     16384
+#define BENCHJUNK      256
+#define BENCHNAMEMAX   256
+#define BENCHHDRMAX    512
+#define BENCHMTIME     1700000000UL
+
+/* the file read by libarchive, and the bytes read and skipped */
+
+typedef struct benchFile
+{
+    int fd;
+    uint64_t bytesRead;
+    uint64_t bytesSkipped;
+    unsigned char buf[BENCHBLOCKSIZE];
+} benchFile_t;
+
+/* the result of one archive */
+
+typedef struct benchRun
+{
+    const char *archive;
+    uint64_t bytes;
+    uint64_t entries;
+    uint64_t bytesRead;
+    uint64_t bytesSkipped;
+    double wallMs;
+} benchRun_t;
+
+/* globals */
+
+static const char *gDirs[] =
+{
+    "usr/lib/modules/6.8.0/kernel/drivers/net",
+    "usr/lib/modules/6.8.0/kernel/drivers/gpu",
+    "usr/lib/modules/6.8.0/kernel/fs",
+    "usr/lib/firmware",
+    "usr/lib/systemd/system",
+    "usr/share/plymouth/themes",
+    "etc/udev/rules.d",
+    "usr/bin",
+};
+
+/* private functions */
+
+static la_ssize_t benchReadCallback(struct archive *a,
+                                    void *data,
+                                    const void **buf);
+static la_int64_t benchSkipCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t request);
+static int benchPutEntry(FILE *fp,
+                         int format,
+                         unsigned long ino,
+                         unsigned long mode,
+                         const char *name,
+                         const unsigned char *data,
+                         unsigned long size,
+                         uint64_t *state);
+static int benchMakeArchive(const char *path,
+                            unsigned long count,
+                            const char *format);
+static int benchList(benchRun_t *run);
+static void printUsage(void);
+
+/* benchReadCallback - read the next block of the archive */
+
+static la_ssize_t benchReadCallback(struct archive *a,
+                                    void *data,
+                                    const void **buf)
+{
+    benchFile_t *file = data;
+    ssize_t bytesRead = 0;
+
+    (void)a;
+
+    do
+    {
+        bytesRead = read(file->fd, file->buf, sizeof(file->buf));
+    } while (bytesRead < 0 && errno == EINTR);
+
+    if (bytesRead > 0)
+    {
+        file->bytesRead += (uint64_t)bytesRead;
+    }
+
+    *buf = file->buf;
+
+    return bytesRead;
+}
+
+/* benchSkipCallback - skip part of the archive without reading it */
+
+static la_int64_t benchSkipCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t request)
+{
+    benchFile_t *file = data;
+
+    (void)a;
+
+    if (lseek(file->fd, (off_t)request, SEEK_CUR) < 0)
+    {
+        return 0;
+    }
+
+    file->bytesSkipped += (uint64_t)request;
+
+    return request;
+}
+
+/*
+    benchPutEntry - write one entry; newc pads the name and the data
+                    to 4 bytes, odc does not pad
+*/
+
+static int benchPutEntry(FILE *fp,
+                         int format,
+                         unsigned long ino,
+                         unsigned long mode,
+                         const char *name,
+                         const unsigned char *data,
+                         unsigned long size,
+                         uint64_t *state)
+{
+    static const unsigned char zeros[4] = { 0, 0, 0, 0 };
+    unsigned char junk[BENCHJUNK];
+    char hdr[BENCHHDRMAX];
+    size_t nameSize = strlen(name) + 1;
+    size_t hdrLen = 0;
+    size_t junkLen = 0;
+    size_t i = 0;
+
+    if (format == gBenchJunk && ino > 1)
+    {
+        /*
+            junk that is a multiple of 4, so the next header is
+            aligned; the first header has none so that the archive
+            is recognized
+        */
+
+        junkLen = (size_t)(benchRand(state) % (BENCHJUNK / 4)) * 4;
+        for (i = 0; i < junkLen; i++)
+        {
+            junk[i] = (unsigned char)benchRand(state);
+        }
+        if (fwrite(junk, 1, junkLen, fp) != junkLen)
+        {
+            return gBenchErr;
+        }
+    }
+
+    if (format == gBenchOdc)
+    {
+        hdrLen = (size_t)snprintf(hdr, sizeof(hdr),
+                                  "070707%06o%06lo%06lo%06o%06o%06o%06o"
+                                  "%011lo%06lo%011lo%s",
+                                  0, ino & 0777777, mode, 0, 0, 1, 0,
+                                  BENCHMTIME, (unsigned long)nameSize,
+                                  size, name);
+        hdrLen++;
+    }
+    else
+    {
+        hdrLen = (size_t)snprintf(hdr, sizeof(hdr),
+                                  "070701%08lX%08lX%08X%08X%08X%08lX"
+                                  "%08lX%08X%08X%08X%08X%08lX%08X%s",
+                                  ino, mode, 0, 0, 1, BENCHMTIME, size,
+                                  8, 1, 0, 0, (unsigned long)nameSize, 0,
+                                  name);
+        for (hdrLen++; hdrLen % 4 != 0; hdrLen++)
+        {
+            hdr[hdrLen] = '\0';
+        }
+    }
+
+    if (fwrite(hdr, 1, hdrLen, fp) != hdrLen ||
+        fwrite(data, 1, size, fp) != size)
+    {
+        return gBenchErr;
+    }
+
+    if (format != gBenchOdc && size % 4 != 0 &&
+        fwrite(zeros, 1, 4 - size % 4, fp) != 4 - size % 4)
+    {
+        return gBenchErr;
+    }
+
+    return gBenchOkay;
+}
+
+/*
+    benchMakeArchive - write an archive of count entries: a directory
+                       for every BENCHDIRFILES files, and files that
+                       are mostly small, with a few symlinks and larger
+                       modules
+*/
+
+static int benchMakeArchive(const char *path,
+                            unsigned long count,
+                            const char *format)
+{
+    unsigned char data[BENCHLARGE];
+    char name[BENCHNAMEMAX];
+    char dir[BENCHNAMEMAX];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    FILE *fp = NULL;
+    unsigned long entry = 0;
+    unsigned long size = 0;
+    unsigned long mode = 0;
+    int how = gBenchNewc;
+    int r = 0;
+    int i = 0;
+    int ret = gBenchErr;
+
+    if (strcmp(format, "newc") == 0)
+    {
+        how = gBenchNewc;
+    }
+    else if (strcmp(format, "odc") == 0)
+    {
+        how = gBenchOdc;
+    }
+    else if (strcmp(format, "junk") == 0)
+    {
+        how = gBenchJunk;
+    }
+    else
+    {
+        fprintf(stderr,
+                "cpiobench: ERROR: the format is newc, odc or junk\n");
+        return gBenchErr;
+    }
+
+    for (i = 0; i < (int)sizeof(data); i++)
+    {
+        data[i] = (unsigned char)("#!/bin/sh\nmodprobe -q $1\n"[i % 26]);
+    }
+
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        fprintf(stderr,
+                "cpiobench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        return gBenchErr;
+    }
+
+    dir[0] = '\0';
+
+    for (entry = 0; entry < count; entry++)
+    {
+        if (entry % (BENCHDIRFILES + 1) == 0)
+        {
+            snprintf(dir, sizeof(dir), "%s/d%06lu",
+                     gDirs[(entry / (BENCHDIRFILES + 1)) %
+                           (sizeof(gDirs) / sizeof(gDirs[0]))],
+                     entry);
+            r = benchPutEntry(fp, how, entry + 1, 040755, dir, data, 0,
+                              &state);
+        }
+        else
+        {
+            r = (int)(benchRand(&state) % 100);
+            if (r < 5)
+            {
+                mode = 0120777;
+                size = 16;
+            }
+            else if (r < 15)
+            {
+                mode = 0100644;
+                size = BENCHSMALL +
+                       (unsigned long)(benchRand(&state) %
+                                       (BENCHLARGE - BENCHSMALL));
+            }
+            else
+            {
+                mode = 0100644;
+                size = (unsigned long)(benchRand(&state) % BENCHSMALL);
+            }
+            snprintf(name, sizeof(name), "%s/f%06lu%s", dir, entry,
+                     (mode == 0120777 ? ".lnk" : ".ko"));
+            r = benchPutEntry(fp, how, entry + 1, mode, name, data, size,
+                              &state);
+        }
+
+        if (r != gBenchOkay)
+        {
+            goto done;
+        }
+    }
+
+    if (benchPutEntry(fp, (how == gBenchJunk ? gBenchNewc : how), 0, 0,
+                      "TRAILER!!!", data, 0, &state) != gBenchOkay)
+    {
+        goto done;
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (fclose(fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    if (ret != gBenchOkay)
+    {
+        fprintf(stderr, "cpiobench: ERROR: cannot write '%s'\n", path);
+    }
+
+    return ret;
+}
+
+/* benchList - list every header of run->archive */
+
+static int benchList(benchRun_t *run)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    benchFile_t *file = NULL;
+    int r = ARCHIVE_OK;
+    int ret = gBenchErr;
+
+    file = calloc(1, sizeof(benchFile_t));
+    a = archive_read_new();
+    if (file == NULL || a == NULL)
+    {
+        goto done;
+    }
+
+    file->fd = open(run->archive, O_RDONLY | O_CLOEXEC);
+    if (file->fd < 0)
+    {
+        fprintf(stderr,
+                "cpiobench: ERROR: cannot open '%s': %s\n",
+                run->archive,
+                strerror(errno));
+        goto done;
+    }
+
+    archive_read_support_format_cpio(a);
+    archive_read_set_callback_data(a, file);
+    archive_read_set_read_callback(a, benchReadCallback);
+    archive_read_set_skip_callback(a, benchSkipCallback);
+
+    if (archive_read_open1(a) != ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "cpiobench: ERROR: cannot open '%s': %s\n",
+                run->archive,
+                archive_error_string(a));
+        goto done;
+    }
+
+    run->entries = 0;
+
+    /* the junk before each header is a warning */
+
+    while ((r = archive_read_next_header(a, &entry)) == ARCHIVE_OK ||
+           r == ARCHIVE_WARN)
+    {
+        run->entries++;
+    }
+
+    if (r != ARCHIVE_EOF)
+    {
+        fprintf(stderr,
+                "cpiobench: ERROR: cannot list '%s': %s\n",
+                run->archive,
+                archive_error_string(a));
+        goto done;
+    }
+
+    run->bytesRead = file->bytesRead;
+    run->bytesSkipped = file->bytesSkipped;
+    ret = gBenchOkay;
+
+done:
+    if (a != NULL)
+    {
+        archive_read_free(a);
+    }
+    if (file != NULL && file->fd >= 0)
+    {
+        close(file->fd);
+    }
+    free(file);
+
+    return ret;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: cpiobench [-r repetitions] [-o output.json] archive ...\n"
+            "       cpiobench -m entries newc|odc|junk archive\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t *runs = NULL;
+    const char *output = NULL;
+    double times[BENCHMAXREPS];
+    struct stat sb;
+    uint64_t start = 0;
+    unsigned long makeCount = 0;
+    FILE *fp = stdout;
+    int numRuns = 0;
+    int numReps = 3;
+    int run = 0;
+    int r = 0;
+    int i = 1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeCount = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeCount > 0)
+    {
+        if (i + 2 != argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeArchive(argv[i + 1], makeCount, argv[i]) ==
+                gBenchOkay ? 0 : 1);
+    }
+
+    if (i >= argc || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    numRuns = argc - i;
+    runs = calloc((size_t)numRuns, sizeof(benchRun_t));
+    if (runs == NULL)
+    {
+        return 1;
+    }
+
+    /* the first repetition is a warm up */
+
+    for (run = 0; run < numRuns; run++)
+    {
+        runs[run].archive = argv[i + run];
+        if (stat(runs[run].archive, &sb) == 0)
+        {
+            runs[run].bytes = (uint64_t)sb.st_size;
+        }
+
+        for (r = -1; r < numReps; r++)
+        {
+            start = benchNow();
+            if (benchList(&runs[run]) != gBenchOkay)
+            {
+                free(runs);
+                return 1;
+            }
+            if (r >= 0)
+            {
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+            }
+        }
+
+        runs[run].wallMs = benchMedian(times, numReps);
+    }
+
+    fp = benchOpenOutput("cpiobench", output);
+    if (fp == NULL)
+    {
+        free(runs);
+        return 1;
+    }
+
+    fprintf(fp, "{\n  \"runs\": [\n");
+
+    for (run = 0; run < numRuns; run++)
+    {
+        fprintf(fp,
+                "    {\"archive\": \"%s\", \"bytes\": %llu, "
+                "\"entries\": %llu,\n"
+                "     \"wallMs\": %.1f, \"headersPerSec\": %.0f, "
+                "\"bytesRead\": %llu, \"bytesSkipped\": %llu}%s\n",
+                runs[run].archive,
+                (unsigned long long)runs[run].bytes,
+                (unsigned long long)runs[run].entries,
+                runs[run].wallMs,
+                (runs[run].wallMs > 0.0 ?
+                 (double)runs[run].entries * 1000.0 / runs[run].wallMs :
+                 0.0),
+                (unsigned long long)runs[run].bytesRead,
+                (unsigned long long)runs[run].bytesSkipped,
+                (run + 1 < numRuns ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    if (benchCloseOutput(fp) != 0)
+    {
+        free(runs);
+        return 1;
+    }
+
+    free(runs);
+
+    return 0;
+}
@@ -0,0 +1,550 @@
+/*
+    encryptbench.c - benchmark counting an archive's encrypted entries
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    encryptbench counts the encrypted and the plain entries of each of
+    the given zip, 7z or rar archives two ways, and reports, as JSON,
+    for each archive:
+
+        libarchive - archive_read_next_header() for every entry, with
+                     archive_entry_is_encrypted(), which is what the
+                     preview would otherwise have to do
+        census     - summaryReadEncryption() (see summary.h), which
+                     only reads the central directory or the headers
+
+    along with both ways' counts, and whether the archive's headers
+    are encrypted.  Each way is run repeatedly (-r), after one warm up
+    run that is not counted, and the median wall time is reported.
+    With -m, encryptbench instead writes a zip archive of the given
+    number of stored files, BENCHMINFILE to BENCHMAXFILE bytes each,
+    with every other one encrypted with BENCHPASSWORD using ZipCrypto.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <zlib.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+
+#include "summary.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHMINFILE   64
+#define BENCHMAXFILE   256
+#define BENCHPASSWORD  "correct horse battery staple"
+#define BENCHCDLEN     46
+
+/* private functions */
+
+static unsigned char *benchPut16(unsigned char *p, unsigned int v);
+static unsigned char *benchPut32(unsigned char *p, uint32_t v);
+static void benchCryptUpdate(uint32_t *keys, unsigned char plain);
+static size_t benchEncrypt(const unsigned char *data,
+                           size_t len,
+                           uint32_t crc,
+                           uint64_t *state,
+                           unsigned char *out);
+static int benchMakeZip(const char *path, unsigned long numFiles);
+static int benchLibarchive(const char *path,
+                           uint64_t *encrypted,
+                           uint64_t *plain);
+static void printUsage(void);
+
+/* benchPut16 - put a little endian 16 bit value */
+
+static unsigned char *benchPut16(unsigned char *p, unsigned int v)
+{
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+
+    return p + 2;
+}
+
+/* benchPut32 - put a little endian 32 bit value */
+
+static unsigned char *benchPut32(unsigned char *p, uint32_t v)
+{
+    p = benchPut16(p, v & 0xFFFF);
+
+    return benchPut16(p, v >> 16);
+}
+
+/* benchCryptUpdate - update the ZipCrypto keys with a plain byte */
+
+static void benchCryptUpdate(uint32_t *keys, unsigned char plain)
+{
+    static uint32_t table[256];
+    uint32_t c = 0;
+    int i = 0;
+    int j = 0;
+
+    if (table[1] == 0)
+    {
+        for (i = 0; i < 256; i++)
+        {
+            for (c = (uint32_t)i, j = 0; j < 8; j++)
+            {
+                c = (c & 1 ? (c >> 1) ^ 0xEDB88320 : c >> 1);
+            }
+            table[i] = c;
+        }
+    }
+
+    keys[0] = table[(keys[0] ^ plain) & 0xFF] ^ (keys[0] >> 8);
+    keys[1] = (keys[1] + (keys[0] & 0xFF)) * 134775813 + 1;
+    keys[2] = table[(keys[2] ^ (keys[1] >> 24)) & 0xFF] ^ (keys[2] >> 8);
+}
+
+/*
+    benchEncrypt - encrypt a file's data with ZipCrypto, which puts a
+                   12 byte header, ending in the CRC's high byte, in
+                   front of the data, returns the length of the
+                   encrypted data in out
+*/
+
+static size_t benchEncrypt(const unsigned char *data,
+                           size_t len,
+                           uint32_t crc,
+                           uint64_t *state,
+                           unsigned char *out)
+{
+    unsigned char plain = 0;
+    const char *p = NULL;
+    uint32_t keys[3] = { 305419896, 591751049, 878082192 };
+    uint32_t t = 0;
+    size_t i = 0;
+
+    for (p = BENCHPASSWORD; *p != '\0'; p++)
+    {
+        benchCryptUpdate(keys, (unsigned char)*p);
+    }
+
+    for (i = 0; i < 11; i++)
+    {
+        out[i] = (unsigned char)benchRand(state);
+    }
+    out[11] = (unsigned char)(crc >> 24);
+    memcpy(out + 12, data, len);
+
+    for (i = 0; i < len + 12; i++)
+    {
+        t = (keys[2] | 2) & 0xFFFF;
+        plain = out[i];
+        out[i] ^= (unsigned char)((t * (t ^ 1)) >> 8);
+        benchCryptUpdate(keys, plain);
+    }
+
+    return len + 12;
+}
+
+/*
+    benchMakeZip - write a zip archive of numFiles stored files of
+                   text, with every other one encrypted with
+                   BENCHPASSWORD
+*/
+
+static int benchMakeZip(const char *path, unsigned long numFiles)
+{
+    static const char letters[] = "abcdefghijklmnop";
+    unsigned char data[BENCHMAXFILE];
+    unsigned char enc[BENCHMAXFILE + 12];
+    unsigned char header[128];
+    unsigned char *cd = NULL;
+    unsigned char *h = NULL;
+    unsigned char *c = NULL;
+    const unsigned char *out = NULL;
+    char name[64];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint64_t bits = 0;
+    uint64_t offset = 0;
+    uint32_t crc = 0;
+    size_t cdLen = 0;
+    size_t nameLen = 0;
+    size_t size = 0;
+    size_t outLen = 0;
+    size_t j = 0;
+    unsigned long i = 0;
+    FILE *fp = NULL;
+    int encrypted = 0;
+    int ret = gBenchErr;
+
+    if (numFiles > 0xFFFF)
+    {
+        fprintf(stderr, "encryptbench: ERROR: too many files\n");
+        return gBenchErr;
+    }
+
+    cd = malloc(numFiles * (BENCHCDLEN + sizeof(name)));
+    fp = fopen(path, "wb");
+    if (cd == NULL || fp == NULL)
+    {
+        fprintf(stderr,
+                "encryptbench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    for (i = 0; i < numFiles; i++)
+    {
+        size = BENCHMINFILE +
+               (size_t)(benchRand(&state) %
+                        (BENCHMAXFILE - BENCHMINFILE + 1));
+        for (j = 0; j < size; j++)
+        {
+            if (j % 16 == 0)
+            {
+                bits = benchRand(&state);
+            }
+            data[j] = (unsigned char)letters[bits & 15];
+            bits >>= 4;
+        }
+
+        snprintf(name,
+                 sizeof(name),
+                 "docs/%04lu/file%06lu.txt",
+                 i / 100,
+                 i);
+        nameLen = strlen(name);
+
+        crc = (uint32_t)crc32(0, data, (uInt)size);
+        encrypted = (i % 2 == 1);
+        if (encrypted)
+        {
+            outLen = benchEncrypt(data, size, crc, &state, enc);
+            out = enc;
+        }
+        else
+        {
+            outLen = size;
+            out = data;
+        }
+
+        h = header;
+        h = benchPut32(h, 0x04034B50);
+        h = benchPut16(h, 20);
+        h = benchPut16(h, (encrypted ? 0x0001 : 0));
+        h = benchPut16(h, 0);
+        h = benchPut16(h, 0x6000);
+        h = benchPut16(h, 0x5D31);
+        h = benchPut32(h, crc);
+        h = benchPut32(h, (uint32_t)outLen);
+        h = benchPut32(h, (uint32_t)size);
+        h = benchPut16(h, (unsigned int)nameLen);
+        h = benchPut16(h, 0);
+        memcpy(h, name, nameLen);
+        h += nameLen;
+
+        if (fwrite(header, 1, (size_t)(h - header), fp) !=
+                (size_t)(h - header) ||
+            fwrite(out, 1, outLen, fp) != outLen)
+        {
+            fprintf(stderr,
+                    "encryptbench: ERROR: cannot write '%s': %s\n",
+                    path,
+                    strerror(errno));
+            goto done;
+        }
+
+        /* the central directory entry is the same, plus the offset */
+
+        c = cd + cdLen;
+        c = benchPut32(c, 0x02014B50);
+        c = benchPut16(c, 0x0314);
+        memcpy(c, header + 4, 26);
+        c += 26;
+        c = benchPut16(c, 0);
+        c = benchPut16(c, 0);
+        c = benchPut16(c, 0);
+        c = benchPut32(c, 0100644U << 16);
+        c = benchPut32(c, (uint32_t)offset);
+        memcpy(c, name, nameLen);
+        c += nameLen;
+        cdLen = (size_t)(c - cd);
+
+        offset += (uint64_t)(h - header) + outLen;
+    }
+
+    h = header;
+    h = benchPut32(h, 0x06054B50);
+    h = benchPut16(h, 0);
+    h = benchPut16(h, 0);
+    h = benchPut16(h, (unsigned int)numFiles);
+    h = benchPut16(h, (unsigned int)numFiles);
+    h = benchPut32(h, (uint32_t)cdLen);
+    h = benchPut32(h, (uint32_t)offset);
+    h = benchPut16(h, 0);
+
+    if (fwrite(cd, 1, cdLen, fp) != cdLen ||
+        fwrite(header, 1, (size_t)(h - header), fp) !=
+            (size_t)(h - header))
+    {
+        fprintf(stderr,
+                "encryptbench: ERROR: cannot write '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (fp != NULL && fclose(fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    free(cd);
+
+    return ret;
+}
+
+/*
+    benchLibarchive - count the encrypted and the plain entries by
+                      reading every header with libarchive
+*/
+
+static int benchLibarchive(const char *path,
+                           uint64_t *encrypted,
+                           uint64_t *plain)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    int r = ARCHIVE_OK;
+
+    *encrypted = 0;
+    *plain = 0;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return gBenchErr;
+    }
+
+    archive_read_support_filter_all(a);
+    archive_read_support_format_all(a);
+
+    if (archive_read_open_filename(a, path, 65536) != ARCHIVE_OK)
+    {
+        archive_read_free(a);
+        return gBenchErr;
+    }
+
+    for (;;)
+    {
+        r = archive_read_next_header(a, &entry);
+        if (r == ARCHIVE_EOF)
+        {
+            break;
+        }
+        if (r < ARCHIVE_WARN)
+        {
+            /* the headers might be encrypted */
+
+            break;
+        }
+
+        if (archive_entry_is_encrypted(entry))
+        {
+            (*encrypted)++;
+        }
+        else
+        {
+            (*plain)++;
+        }
+    }
+
+    archive_read_free(a);
+
+    return gBenchOkay;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: encryptbench [-r repetitions] [-o output.json] "
+            "archive ...\n"
+            "       encryptbench -m files archive.zip\n");
+}
+
+int main(int argc, char **argv)
+{
+    summaryEncryption_t census;
+    const char *output = NULL;
+    double times[BENCHMAXREPS];
+    double libarchiveMs = 0.0;
+    double censusMs = 0.0;
+    uint64_t start = 0;
+    uint64_t libarchiveEncrypted = 0;
+    uint64_t libarchivePlain = 0;
+    unsigned long makeFiles = 0;
+    FILE *fp = stdout;
+    int numReps = 3;
+    int censusErr = gSummaryOkay;
+    int arc = 0;
+    int ret = 1;
+    int r = 0;
+    int i = 1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeFiles = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeFiles > 0)
+    {
+        if (i + 1 != argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeZip(argv[i], makeFiles) == gBenchOkay ? 0 : 1);
+    }
+
+    if (i >= argc || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    fp = benchOpenOutput("encryptbench", output);
+    if (fp == NULL)
+    {
+        return 1;
+    }
+
+    fprintf(fp, "{\n  \"archives\": [\n");
+
+    for (arc = i; arc < argc; arc++)
+    {
+        /* the first repetition of each way is a warm up */
+
+        for (r = -1; r < numReps; r++)
+        {
+            start = benchNow();
+            if (benchLibarchive(argv[arc],
+                                &libarchiveEncrypted,
+                                &libarchivePlain) != gBenchOkay)
+            {
+                fprintf(stderr,
+                        "encryptbench: ERROR: cannot read '%s'\n",
+                        argv[arc]);
+                goto done;
+            }
+            if (r >= 0)
+            {
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+            }
+        }
+        libarchiveMs = benchMedian(times, numReps);
+
+        for (r = -1; r < numReps; r++)
+        {
+            start = benchNow();
+            censusErr = summaryReadEncryption(argv[arc], &census);
+            if (r >= 0)
+            {
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+            }
+        }
+        censusMs = benchMedian(times, numReps);
+
+        if (censusErr != gSummaryOkay)
+        {
+            fprintf(stderr,
+                    "encryptbench: WARN: cannot count the entries of "
+                    "'%s'\n",
+                    argv[arc]);
+        }
+
+        fprintf(fp,
+                "    {\"archive\": \"%s\", \"format\": \"%s\",\n"
+                "     \"libarchive\": {\"encrypted\": %llu, "
+                "\"plain\": %llu, \"wallMs\": %.2f},\n"
+                "     \"census\": {\"counted\": %s, \"encrypted\": %llu, "
+                "\"plain\": %llu, \"headersEncrypted\": %s, "
+                "\"wallMs\": %.2f, \"speedup\": %.1f}}%s\n",
+                argv[arc],
+                summaryFormatName(census.format),
+                (unsigned long long)libarchiveEncrypted,
+                (unsigned long long)libarchivePlain,
+                libarchiveMs,
+                (censusErr == gSummaryOkay ? "true" : "false"),
+                (unsigned long long)census.encryptedEntries,
+                (unsigned long long)census.plainEntries,
+                (census.headersEncrypted ? "true" : "false"),
+                censusMs,
+                (censusMs > 0.0 ? libarchiveMs / censusMs : 0.0),
+                (arc + 1 < argc ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    ret = 0;
+
+done:
+    if (benchCloseOutput(fp) != 0)
+    {
+        ret = 1;
+    }
+
+    return ret;
+}
@@ -0,0 +1,423 @@
+/*
+    extractbench.c - benchmark extracting an archive with several threads
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    extractbench extracts an archive into a folder with extractRun()
+    (see extract.h), with each of the given numbers of workers (-j, a
+    comma separated list, 1,2,4 by default), and reports, as JSON:
+
+        entries, files, bytes - what was extracted
+        runs         - for each number of workers, the number of
+                       workers used and work units, the median wall
+                       time (wallMs), the MB written per second and
+                       the speed up over the first run
+
+    The folder is removed before each extraction.  Each run is
+    repeated (-r), after one warm up run that is not counted.  With
+    -m, extractbench instead writes size MB of files of
+    BENCHMINFILE to BENCHMAXFILE bytes, in folders of BENCHDIRFILES
+    files, to a folder, to be archived (see "make extract").  The
+    files are text from a 16 letter alphabet, so that they compress
+    to about half of their size.
+*/
+
+/* for nftw() on Linux */
+
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "extract.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHMAXRUNS   16
+#define BENCHDIRFILES  100
+#define BENCHMINFILE   (256 * 1024)
+#define BENCHMAXFILE   (4 * 1024 * 1024)
+#define BENCHBUFLEN    65536
+
+/* the result of one number of workers */
+
+typedef struct benchRun
+{
+    int workers;
+    unsigned int workersUsed;
+    unsigned int units;
+    double wallMs;
+} benchRun_t;
+
+/* private functions */
+
+static int benchRemoveEntry(const char *path,
+                            const struct stat *sb,
+                            int type,
+                            struct FTW *ftw);
+static int benchRemoveTree(const char *dir);
+static int benchWriteFile(const char *path, size_t size, uint64_t *state);
+static int benchMakeTree(const char *dir, unsigned long sizeMB);
+static int benchParseWorkers(const char *list, benchRun_t *runs);
+static void printUsage(void);
+
+/* benchRemoveEntry - nftw() callback that removes an entry */
+
+static int benchRemoveEntry(const char *path,
+                            const struct stat *sb,
+                            int type,
+                            struct FTW *ftw)
+{
+    return (remove(path) == 0 || errno == ENOENT ? 0 : -1);
+}
+
+/* benchRemoveTree - remove dir and everything in it */
+
+static int benchRemoveTree(const char *dir)
+{
+    if (access(dir, F_OK) != 0)
+    {
+        return gBenchOkay;
+    }
+
+    return (nftw(dir, benchRemoveEntry, 64, FTW_DEPTH | FTW_PHYS) == 0 ?
+            gBenchOkay : gBenchErr);
+}
+
+/* benchWriteFile - write size bytes of compressible text to path */
+
+static int benchWriteFile(const char *path, size_t size, uint64_t *state)
+{
+    static const char letters[] = "abcdefghijklmnop";
+    unsigned char buf[BENCHBUFLEN];
+    uint64_t bits = 0;
+    size_t len = 0;
+    size_t i = 0;
+    int fd = -1;
+    int ret = gBenchOkay;
+
+    fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+    {
+        return gBenchErr;
+    }
+
+    while (size > 0 && ret == gBenchOkay)
+    {
+        len = (size < sizeof(buf) ? size : sizeof(buf));
+
+        for (i = 0; i < len; i++)
+        {
+            if (i % 16 == 0)
+            {
+                bits = benchRand(state);
+            }
+            buf[i] = (unsigned char)letters[bits & 15];
+            bits >>= 4;
+        }
+
+        if (write(fd, buf, len) != (ssize_t)len)
+        {
+            ret = gBenchErr;
+        }
+
+        size -= len;
+    }
+
+    close(fd);
+
+    return ret;
+}
+
+/*
+    benchMakeTree - write sizeMB of files, in folders of
+                    BENCHDIRFILES, to dir
+*/
+
+static int benchMakeTree(const char *dir, unsigned long sizeMB)
+{
+    char path[4096];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint64_t remaining = (uint64_t)sizeMB * 1024 * 1024;
+    size_t size = 0;
+    unsigned long i = 0;
+
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr,
+                "extractbench: ERROR: cannot create '%s': %s\n",
+                dir,
+                strerror(errno));
+        return gBenchErr;
+    }
+
+    for (i = 0; remaining > 0; i++)
+    {
+        if (i % BENCHDIRFILES == 0)
+        {
+            snprintf(path, sizeof(path), "%s/%04lu", dir, i / BENCHDIRFILES);
+            if (mkdir(path, 0755) != 0 && errno != EEXIST)
+            {
+                fprintf(stderr,
+                        "extractbench: ERROR: cannot create '%s': %s\n",
+                        path,
+                        strerror(errno));
+                return gBenchErr;
+            }
+        }
+
+        size = BENCHMINFILE +
+               (size_t)(benchRand(&state) %
+                        (BENCHMAXFILE - BENCHMINFILE + 1));
+        if (size > remaining)
+        {
+            size = (size_t)remaining;
+        }
+
+        snprintf(path,
+                 sizeof(path),
+                 "%s/%04lu/%06lu.txt",
+                 dir,
+                 i / BENCHDIRFILES,
+                 i);
+
+        if (benchWriteFile(path, size, &state) != gBenchOkay)
+        {
+            fprintf(stderr,
+                    "extractbench: ERROR: cannot create '%s': %s\n",
+                    path,
+                    strerror(errno));
+            return gBenchErr;
+        }
+
+        remaining -= size;
+    }
+
+    return gBenchOkay;
+}
+
+/*
+    benchParseWorkers - parse a comma separated list of numbers of
+                        workers; returns the number of runs
+*/
+
+static int benchParseWorkers(const char *list, benchRun_t *runs)
+{
+    char *end = NULL;
+    long n = 0;
+    int numRuns = 0;
+
+    while (*list != '\0' && numRuns < BENCHMAXRUNS)
+    {
+        n = strtol(list, &end, 10);
+        if (end == list || n < 1 || n > EXTRACTMAXWORKERS ||
+            (*end != ',' && *end != '\0'))
+        {
+            return 0;
+        }
+
+        memset(&runs[numRuns], 0, sizeof(benchRun_t));
+        runs[numRuns].workers = (int)n;
+        numRuns++;
+
+        list = (*end == ',' ? end + 1 : end);
+    }
+
+    return numRuns;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: extractbench [-j workers,...] [-r repetitions]\n"
+            "                    [-o output.json] archive folder\n"
+            "       extractbench -m size MB folder\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t runs[BENCHMAXRUNS];
+    extractOptions_t options;
+    extractStats_t stats;
+    const char *output = NULL;
+    double times[BENCHMAXREPS];
+    double secs = 0.0;
+    uint64_t start = 0;
+    unsigned long makeMB = 0;
+    FILE *fp = stdout;
+    int numRuns = 0;
+    int numReps = 3;
+    int run = 0;
+    int r = 0;
+    int i = 1;
+
+    memset(&options, 0, sizeof(extractOptions_t));
+    memset(&stats, 0, sizeof(extractStats_t));
+    options.flags = EXTRACTDEFAULTFLAGS;
+    numRuns = benchParseWorkers("1,2,4", runs);
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            numRuns = benchParseWorkers(argv[++i], runs);
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeMB = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeMB > 0)
+    {
+        if (i + 1 != argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeTree(argv[i], makeMB) == gBenchOkay ? 0 : 1);
+    }
+
+    if (i + 2 != argc || numRuns < 1 || numReps < 1 ||
+        numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    options.archive = argv[i];
+    options.destDir = argv[i + 1];
+
+    /* the first repetition of each run is a warm up and is not counted */
+
+    for (run = 0; run < numRuns; run++)
+    {
+        options.numWorkers = runs[run].workers;
+
+        for (r = -1; r < numReps; r++)
+        {
+            if (benchRemoveTree(options.destDir) != gBenchOkay)
+            {
+                fprintf(stderr,
+                        "extractbench: ERROR: cannot remove '%s'\n",
+                        options.destDir);
+                return 1;
+            }
+            sync();
+
+            start = benchNow();
+            if (extractRun(&options, &stats) != gExtractOkay)
+            {
+                fprintf(stderr,
+                        "extractbench: ERROR: cannot extract '%s'\n",
+                        options.archive);
+                return 1;
+            }
+            if (r >= 0)
+            {
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+            }
+        }
+
+        runs[run].wallMs = benchMedian(times, numReps);
+        runs[run].workersUsed = stats.workers;
+        runs[run].units = stats.units;
+    }
+
+    fp = benchOpenOutput("extractbench", output);
+    if (fp == NULL)
+    {
+        return 1;
+    }
+
+    fprintf(fp,
+            "{\n"
+            "  \"entries\": %llu,\n"
+            "  \"files\": %llu,\n"
+            "  \"bytes\": %llu,\n"
+            "  \"runs\": [\n",
+            (unsigned long long)stats.entries,
+            (unsigned long long)stats.files,
+            (unsigned long long)stats.bytes);
+
+    for (run = 0; run < numRuns; run++)
+    {
+        secs = (runs[run].wallMs > 0.0 ? runs[run].wallMs / 1000.0 : 1e-9);
+        fprintf(fp,
+                "    {\"workers\": %d, \"workersUsed\": %u, "
+                "\"units\": %u, \"wallMs\": %.1f, \"mbPerSec\": %.1f, "
+                "\"speedup\": %.2f}%s\n",
+                runs[run].workers,
+                runs[run].workersUsed,
+                runs[run].units,
+                runs[run].wallMs,
+                (double)stats.bytes / secs / 1048576.0,
+                (runs[run].wallMs > 0.0 ?
+                 runs[0].wallMs / runs[run].wallMs : 0.0),
+                (run + 1 < numRuns ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    benchCloseOutput(fp);
+
+    return 0;
+}
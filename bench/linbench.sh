@@ -0,0 +1,177 @@
+#!/bin/sh
+#
+#    linbench.sh - check that listing pathological archives takes
+#                  linear time
+#
+#    v0.1.0 - initial release
+#
+#    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+#
+#    Permission is hereby granted, free of charge, to any person obtaining
+#    a copy of this software and associated documentation files (the
+#    "Software") to deal in the Software without restriction, including
+#    without limitation the rights to use, copy, modify, merge, publish,
+#    distribute, sublicense, and/or sell copies of the Software, and to
+#    permit persons to whom the Software is furnished to do so, subject
+#    to the following conditions:
+#
+#    The above copyright notice and this permission notice shall be
+#    included in all copies or substantial portions of the Software.
+#
+#    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+#    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+#    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+#    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+#    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+#    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+#    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#
+
+# For each of mkhostile's formats, linbench writes archives of
+# doubling size (SIZES entries), lists them all with listbench, using
+# the preview's resource limits unless -u is given, and prints the
+# time per byte at each size.  An archive that stops on a limit is
+# still timed up to the point where it stopped.
+#
+# The growth of each format is the slope of a least squares fit of
+# log(time) against log(size): about 1 (or less, while fixed costs
+# dominate) is linear and 2 is quadratic.  A slope of MAXGROWTH or
+# more is flagged as superlinear, as is an archive that runs past
+# the TIMEOUT.  The slope is used rather than the ratio of the
+# largest to the smallest times, as the time per byte steps up when
+# the reader's tables no longer fit in the caches.  linbench exits
+# with 1 if any format is flagged.
+
+MKHOSTILE="./build/mkhostile"
+LISTBENCH="./build/listbench"
+SIZES="1000 2000 4000 8000 16000 32000 64000"
+FORMATS="tarext paxbig zipdup isoce xardeep"
+NAMELEN=64
+REPS=3
+TIMEOUT=60
+NOLIMITS=""
+RESULTS="linear.json"
+MAXGROWTH=1.5
+
+usage()
+{
+    echo "Usage: $0 [-m mkhostile] [-b listbench] [-n \"sizes\"]" >& 2
+    echo "       [-f \"formats\"] [-l name length] [-r repetitions]" >& 2
+    echo "       [-t timeout] [-o results.json] [-u] [output dir]" >& 2
+    echo "Formats: $FORMATS" >& 2
+    exit 1
+}
+
+while getopts "m:b:n:f:l:r:t:o:uh" OPT ; do
+    case "$OPT" in
+        m) MKHOSTILE="$OPTARG" ;;
+        b) LISTBENCH="$OPTARG" ;;
+        n) SIZES="$OPTARG" ;;
+        f) FORMATS="$OPTARG" ;;
+        l) NAMELEN="$OPTARG" ;;
+        r) REPS="$OPTARG" ;;
+        t) TIMEOUT="$OPTARG" ;;
+        o) RESULTS="$OPTARG" ;;
+        u) NOLIMITS="-u" ;;
+        *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+OUTDIR="${1:-hostile}"
+
+for PROG in "$MKHOSTILE" "$LISTBENCH" ; do
+    if [ ! -x "$PROG" ] ; then
+        echo "ERROR: $PROG not available, run make first" >& 2
+        exit 1
+    fi
+done
+
+mkdir -p "$OUTDIR" || exit 1
+
+LOG=$(mktemp "${TMPDIR:-/tmp}/linbench.XXXXXX") || exit 1
+trap 'rm -f "$LOG"' EXIT INT TERM
+
+# extension - get the file extension for a format
+
+extension()
+{
+    case "$1" in
+        tarext|paxbig) echo "tar" ;;
+        zipdup)        echo "zip" ;;
+        isoce)         echo "iso" ;;
+        xardeep)       echo "xar" ;;
+        *)             echo "bin" ;;
+    esac
+}
+
+FILES=""
+for F in $FORMATS ; do
+    EXT=$(extension "$F")
+    for N in $SIZES ; do
+        FILE="$OUTDIR/$F-n$N.$EXT"
+        "$MKHOSTILE" -n "$N" -l "$NAMELEN" "$F" "$FILE" || exit 1
+        FILES="$FILES $FILE"
+    done
+done
+
+"$LISTBENCH" -e $NOLIMITS -r "$REPS" -t "$TIMEOUT" -o "$RESULTS" \
+    $FILES 2> "$LOG"
+
+printf "%-8s %8s %11s %11s %9s\n" "format" "entries" "bytes" "ms" "ns/byte"
+
+FLAGGED=0
+for F in $FORMATS ; do
+    EXT=$(extension "$F")
+    POINTS=""
+    TIMEDOUT=0
+    for N in $SIZES ; do
+        FILE="$OUTDIR/$F-n$N.$EXT"
+        BYTES=$(wc -c < "$FILE" | tr -d ' ')
+        BASE=$(basename "$FILE")
+        MS=$(awk -v f="$BASE" '$2 == f { print $5 }' "$LOG")
+        STOPPED=$(awk -v f="$BASE" '$2 == f && /\(stopped\)/ { print "*" }' \
+                  "$LOG")
+        if [ -z "$MS" ] ; then
+            if grep -q "'$FILE' timed out" "$LOG" ; then
+                printf "%-8s %8s %11s %11s %9s\n" \
+                    "$F" "$N" "$BYTES" "timeout" "-"
+                TIMEDOUT=1
+            else
+                printf "%-8s %8s %11s %11s %9s\n" \
+                    "$F" "$N" "$BYTES" "failed" "-"
+            fi
+            continue
+        fi
+        printf "%-8s %8s %11s %11s %9s\n" "$F" "$N" "$BYTES" "$MS$STOPPED" \
+            $(awk -v b="$BYTES" -v m="$MS" 'BEGIN { printf "%.1f", m * 1e6 / b }')
+        POINTS="$POINTS $BYTES:$MS"
+    done
+
+    if [ "$TIMEDOUT" -eq 1 ] ; then
+        echo "$F: SUPERLINEAR (timed out after $TIMEOUT seconds)"
+        FLAGGED=1
+    elif [ $(echo $POINTS | wc -w) -ge 2 ] ; then
+        GROWTH=$(echo $POINTS | tr ' ' '\n' | awk -F: '
+            {
+                if ($2 <= 0) $2 = 0.001
+                x = log($1); y = log($2)
+                n++; sx += x; sy += y; sxx += x * x; sxy += x * y
+            }
+            END {
+                d = n * sxx - sx * sx
+                printf "%.2f", (d == 0 ? 0 : (n * sxy - sx * sy) / d)
+            }')
+        if awk -v g="$GROWTH" -v m="$MAXGROWTH" 'BEGIN { exit !(g >= m) }'
+        then
+            echo "$F: SUPERLINEAR (growth $GROWTH)"
+            FLAGGED=1
+        else
+            echo "$F: linear (growth $GROWTH)"
+        fi
+    fi
+done
+
+echo "(* listing stopped with an error, e.g. on a read limit)"
+
+exit $FLAGGED
@@ -0,0 +1,490 @@
+/*
+    linkbench.c - benchmark matching up the hard links of cpio archives
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    linkbench lists each of the given cpio archives with libarchive's
+    cpio reader, which turns every link to a file after the first into
+    a hard link to the first, checks that each hard link names the
+    first link of its file, and reports, as JSON, for each archive:
+
+        archive, bytes - the archive and its size
+        entries        - the number of entries
+        hardlinks      - the number of entries that are hard links
+        wallMs         - the median wall time to list it
+        peakAnonKB     - the most anonymous memory (RssAnon) the
+                         process had while listing it
+
+    The archive is listed repeatedly (-r), after one warm up run that
+    is not counted.  With -l, the reader's memory limit is set to the
+    given number of MB, past which it moves its table of links to a
+    temporary file.  With -m, linkbench instead writes a newc archive
+    of the given number of files, each with 2 or 3 links: the first
+    link of every file, then the second, then the third, so that the
+    reader has to remember every file until the end.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHNAMEMAX   256
+#define BENCHHDRMAX    512
+#define BENCHMAXLINKS  3
+#define BENCHSAMPLE    65536
+#define BENCHMTIME     1700000000UL
+
+/* the result of one archive */
+
+typedef struct benchRun
+{
+    const char *archive;
+    uint64_t bytes;
+    uint64_t entries;
+    uint64_t hardlinks;
+    uint64_t peakAnonKB;
+    double wallMs;
+} benchRun_t;
+
+/* globals */
+
+static long long gMemoryLimit = 0;
+
+/* private functions */
+
+static uint64_t benchAnonKB(void);
+static void benchLinkName(char *name,
+                          size_t size,
+                          unsigned long file,
+                          unsigned long link);
+static int benchParseName(const char *name,
+                          unsigned long *file,
+                          unsigned long *link);
+static int benchMakeArchive(const char *path, unsigned long count);
+static int benchList(benchRun_t *run);
+static void printUsage(void);
+
+/* benchAnonKB - get the anonymous memory of this process in KB */
+
+static uint64_t benchAnonKB(void)
+{
+    char line[BENCHNAMEMAX];
+    unsigned long long kb = 0;
+    FILE *fp = NULL;
+
+    fp = fopen("/proc/self/status", "r");
+    if (fp == NULL)
+    {
+        return 0;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        if (sscanf(line, "RssAnon: %llu", &kb) == 1)
+        {
+            break;
+        }
+    }
+
+    fclose(fp);
+
+    return (uint64_t)kb;
+}
+
+/* benchLinkName - get the name of one link of a file */
+
+static void benchLinkName(char *name,
+                          size_t size,
+                          unsigned long file,
+                          unsigned long link)
+{
+    snprintf(name, size,
+             "usr/share/doc/package-%05lu/link%lu/file-%08lu.txt",
+             file / 64, link, file);
+}
+
+/* benchParseName - get the file and link numbers from a link's name */
+
+static int benchParseName(const char *name,
+                          unsigned long *file,
+                          unsigned long *link)
+{
+    unsigned long dir = 0;
+
+    if (name == NULL ||
+        sscanf(name, "usr/share/doc/package-%lu/link%lu/file-%lu.txt",
+               &dir, link, file) != 3 ||
+        dir != *file / 64)
+    {
+        return gBenchErr;
+    }
+
+    return gBenchOkay;
+}
+
+/*
+    benchMakeArchive - write a newc archive of count files, a third of
+                       them with 3 links and the rest with 2, by link
+*/
+
+static int benchMakeArchive(const char *path, unsigned long count)
+{
+    char name[BENCHNAMEMAX];
+    char hdr[BENCHHDRMAX];
+    FILE *fp = NULL;
+    unsigned long link = 0;
+    unsigned long file = 0;
+    unsigned long nlink = 0;
+    size_t hdrLen = 0;
+    int ret = gBenchErr;
+
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        fprintf(stderr,
+                "linkbench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        return gBenchErr;
+    }
+
+    for (link = 0; link <= BENCHMAXLINKS; link++)
+    {
+        for (file = 0; file < count; file++)
+        {
+            nlink = (file % 3 == 0 ? 3 : 2);
+            if (link < BENCHMAXLINKS && link >= nlink)
+            {
+                continue;
+            }
+
+            /* the last pass writes the trailer */
+
+            if (link == BENCHMAXLINKS)
+            {
+                strcpy(name, "TRAILER!!!");
+                nlink = 1;
+                file = count;
+            }
+            else
+            {
+                benchLinkName(name, sizeof(name), file, link);
+            }
+
+            hdrLen = (size_t)snprintf(hdr, sizeof(hdr),
+                                      "070701%08lX%08lX%08X%08X%08lX"
+                                      "%08lX%08X%08X%08X%08X%08X%08lX"
+                                      "%08X%s",
+                                      (link == BENCHMAXLINKS ? 0 :
+                                       file + 1),
+                                      (link == BENCHMAXLINKS ? 0 :
+                                       0100644UL),
+                                      0, 0, nlink, BENCHMTIME, 0,
+                                      8, 1, 0, 0,
+                                      (unsigned long)strlen(name) + 1,
+                                      0, name);
+            for (hdrLen++; hdrLen % 4 != 0; hdrLen++)
+            {
+                hdr[hdrLen] = '\0';
+            }
+
+            if (fwrite(hdr, 1, hdrLen, fp) != hdrLen)
+            {
+                goto done;
+            }
+        }
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (fclose(fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    if (ret != gBenchOkay)
+    {
+        fprintf(stderr, "linkbench: ERROR: cannot write '%s'\n", path);
+    }
+
+    return ret;
+}
+
+/*
+    benchList - list every header of run->archive, checking that each
+                hard link names the first link of the same file
+*/
+
+static int benchList(benchRun_t *run)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    const char *target = NULL;
+    unsigned long file = 0;
+    unsigned long link = 0;
+    unsigned long targetFile = 0;
+    unsigned long targetLink = 0;
+    uint64_t kb = 0;
+    int r = ARCHIVE_OK;
+    int ret = gBenchErr;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return gBenchErr;
+    }
+
+    archive_read_support_format_cpio(a);
+    if (gMemoryLimit > 0)
+    {
+        archive_read_set_limit(a, ARCHIVE_READ_LIMIT_MEMORY, gMemoryLimit);
+    }
+
+    if (archive_read_open_filename(a, run->archive, 65536) != ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "linkbench: ERROR: cannot open '%s': %s\n",
+                run->archive,
+                archive_error_string(a));
+        goto done;
+    }
+
+    run->entries = 0;
+    run->hardlinks = 0;
+    run->peakAnonKB = benchAnonKB();
+
+    while ((r = archive_read_next_header(a, &entry)) == ARCHIVE_OK)
+    {
+        run->entries++;
+
+        if (run->entries % BENCHSAMPLE == 0)
+        {
+            kb = benchAnonKB();
+            if (kb > run->peakAnonKB)
+            {
+                run->peakAnonKB = kb;
+            }
+        }
+
+        target = archive_entry_hardlink(entry);
+        if (target == NULL)
+        {
+            continue;
+        }
+
+        run->hardlinks++;
+
+        if (benchParseName(archive_entry_pathname(entry),
+                           &file,
+                           &link) != gBenchOkay ||
+            benchParseName(target, &targetFile, &targetLink) !=
+                gBenchOkay ||
+            targetFile != file || targetLink != 0 || link == 0)
+        {
+            fprintf(stderr,
+                    "linkbench: ERROR: '%s' is a hard link to '%s'\n",
+                    archive_entry_pathname(entry),
+                    target);
+            goto done;
+        }
+    }
+
+    if (r != ARCHIVE_EOF)
+    {
+        fprintf(stderr,
+                "linkbench: ERROR: cannot list '%s': %s\n",
+                run->archive,
+                archive_error_string(a));
+        goto done;
+    }
+
+    ret = gBenchOkay;
+
+done:
+    archive_read_free(a);
+
+    return ret;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: linkbench [-r repetitions] [-l MB] [-o output.json] "
+            "archive ...\n"
+            "       linkbench -m files archive\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t *runs = NULL;
+    const char *output = NULL;
+    double times[BENCHMAXREPS];
+    struct stat sb;
+    uint64_t start = 0;
+    unsigned long makeCount = 0;
+    FILE *fp = stdout;
+    int numRuns = 0;
+    int numReps = 3;
+    int run = 0;
+    int r = 0;
+    int i = 1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+        {
+            gMemoryLimit = atoll(argv[++i]) * 1024 * 1024;
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeCount = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeCount > 0)
+    {
+        if (i + 1 != argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeArchive(argv[i], makeCount) == gBenchOkay ?
+                0 : 1);
+    }
+
+    if (i >= argc || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    numRuns = argc - i;
+    runs = calloc((size_t)numRuns, sizeof(benchRun_t));
+    if (runs == NULL)
+    {
+        return 1;
+    }
+
+    /* the first repetition is a warm up */
+
+    for (run = 0; run < numRuns; run++)
+    {
+        runs[run].archive = argv[i + run];
+        if (stat(runs[run].archive, &sb) == 0)
+        {
+            runs[run].bytes = (uint64_t)sb.st_size;
+        }
+
+        for (r = -1; r < numReps; r++)
+        {
+            start = benchNow();
+            if (benchList(&runs[run]) != gBenchOkay)
+            {
+                free(runs);
+                return 1;
+            }
+            if (r >= 0)
+            {
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+            }
+        }
+
+        runs[run].wallMs = benchMedian(times, numReps);
+    }
+
+    fp = benchOpenOutput("linkbench", output);
+    if (fp == NULL)
+    {
+        free(runs);
+        return 1;
+    }
+
+    fprintf(fp, "{\n  \"memoryLimitMB\": %lld,\n  \"runs\": [\n",
+            gMemoryLimit / (1024 * 1024));
+
+    for (run = 0; run < numRuns; run++)
+    {
+        fprintf(fp,
+                "    {\"archive\": \"%s\", \"bytes\": %llu, "
+                "\"entries\": %llu, \"hardlinks\": %llu,\n"
+                "     \"wallMs\": %.1f, \"peakAnonKB\": %llu}%s\n",
+                runs[run].archive,
+                (unsigned long long)runs[run].bytes,
+                (unsigned long long)runs[run].entries,
+                (unsigned long long)runs[run].hardlinks,
+                runs[run].wallMs,
+                (unsigned long long)runs[run].peakAnonKB,
+                (run + 1 < numRuns ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    if (benchCloseOutput(fp) != 0)
+    {
+        free(runs);
+        return 1;
+    }
+
+    free(runs);
+
+    return 0;
+}
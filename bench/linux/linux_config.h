@@ -0,0 +1,84 @@
+/*
+    linux_config.h - libarchive configuration for building the
+                     benchmarks on Linux
+
+    This starts from the macOS config.h used by the Xcode project and
+    turns off the Darwin only features (CommonCrypto digests, ACLs,
+    xattrs, file flags, copyfile, BSD stat field names, etc.).  It is
+    selected with -DPLATFORM_CONFIG_H='"linux_config.h"' (see
+    archive_platform.h), so the Xcode build is unaffected.
+*/
+
+#ifndef qlZipInfo_bench_linux_config_h
+#define qlZipInfo_bench_linux_config_h
+
+#include "../../qlZipInfo/libarchive/config.h"
+
+#undef ARCHIVE_ACL_DARWIN
+#undef ARCHIVE_XATTR_DARWIN
+
+#undef ARCHIVE_CRYPTO_MD5_LIBSYSTEM
+#undef ARCHIVE_CRYPTO_SHA1_LIBSYSTEM
+#undef ARCHIVE_CRYPTO_SHA256_LIBSYSTEM
+#undef ARCHIVE_CRYPTO_SHA384_LIBSYSTEM
+#undef ARCHIVE_CRYPTO_SHA512_LIBSYSTEM
+
+/*
+   use OpenSSL (-lcrypto) for the digests needed by xar and 7-Zip, and
+   for the key derivation of WinZip AES zip entries, which CommonCrypto
+   does on macOS
+*/
+
+#define ARCHIVE_CRYPTO_MD5_OPENSSL 1
+#define ARCHIVE_CRYPTO_SHA1_OPENSSL 1
+#define ARCHIVE_CRYPTO_SHA256_OPENSSL 1
+#define ARCHIVE_CRYPTO_SHA384_OPENSSL 1
+#define ARCHIVE_CRYPTO_SHA512_OPENSSL 1
+#define HAVE_OPENSSL_EVP_H 1
+#define HAVE_LIBCRYPTO 1
+#define HAVE_PKCS5_PBKDF2_HMAC_SHA1 1
+
+#undef HAVE_ARC4RANDOM_BUF
+#undef HAVE_CHFLAGS
+#undef HAVE_COMPRESSION_H
+#undef HAVE_COPYFILE_H
+#undef HAVE_EFTYPE
+#undef HAVE_FCHFLAGS
+#undef HAVE_FGETXATTR
+#undef HAVE_FLISTXATTR
+#undef HAVE_FSETXATTR
+#undef HAVE_GETVFSBYNAME
+#undef HAVE_GETXATTR
+#undef HAVE_LCHFLAGS
+#undef HAVE_LCHMOD
+#undef HAVE_LIBCOMPRESSION
+#undef HAVE_LISTXATTR
+#undef HAVE_LOCALCHARSET_H
+#undef HAVE_LOCALE_CHARSET
+#undef HAVE_MEMBERSHIP_H
+#undef HAVE_SETXATTR
+#undef HAVE_STRUCT_STAT_ST_BIRTHTIME
+#undef HAVE_STRUCT_STAT_ST_BIRTHTIMESPEC_TV_NSEC
+#undef HAVE_STRUCT_STAT_ST_FLAGS
+#undef HAVE_STRUCT_STAT_ST_MTIMESPEC_TV_NSEC
+#undef HAVE_STRUCT_VFSCONF
+#undef HAVE_SYS_ACL_H
+#undef HAVE_SYS_XATTR_H
+
+#define HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC 1
+#define HAVE_LINUX_FS_H 1
+#define HAVE_LINUX_MAGIC_H 1
+#define HAVE_SYS_VFS_H 1
+#define HAVE_STATVFS 1
+#define HAVE_FSTATVFS 1
+
+/* archive_read_data_into_fd.c copies stored entries in the kernel */
+
+#define HAVE_COPY_FILE_RANGE 1
+#define HAVE_SYS_SENDFILE_H 1
+
+/* archive_read_disk_posix.c uses the Darwin name for suseconds_t */
+
+#define __darwin_suseconds_t suseconds_t
+
+#endif /* qlZipInfo_bench_linux_config_h */
@@ -0,0 +1,762 @@
+/*
+    listbench.c - benchmark listing archives the way the preview does
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    listbench lists each archive given on the command line with the
+    same libarchive filters and formats, block size and per entry
+    accessors as GeneratePreviewForURL (or with sit.c / binhex.c for
+    .sit and .hqx files) and reports, as JSON:
+
+        entries    - number of entries listed
+        ttfeUs     - median time from open to the first entry
+        totalUs    - median time to open, list and close
+        minUs      - fastest time to open, list and close
+        entriesPerSec, mbPerSec - based on the median time and the
+                     archive's size on disk
+        peakRssKb  - peak resident set size
+        stopped    - true if listing stopped with an error (-e)
+
+    Each archive is measured in its own child process so that the
+    peak RSS belongs to that archive alone.  The "label" of each
+    result is the archive's base name up to the first '-', which is
+    how mkcorpus.sh names the corpus (for example, zip64-n1000-...).
+
+    Archives are read with the same resource limits as the preview
+    (see archive_read_set_limit), unless -u is given.  With -e, an
+    archive that stops with an error, such as a hostile archive going
+    over a limit, is timed up to the error rather than failing, and
+    -t kills the child after the given number of seconds, for inputs
+    that would never finish without the limits (see linbench.sh).
+
+    With -n, archives inside the archive (see nested.h) are listed
+    too, within the preview's nested limits, and their entries are
+    counted with the others.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/utsname.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+#include "sit.h"
+#include "binhex.h"
+#include "nested.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   1000
+#define BENCHBLOCKSIZE 10240
+#define BENCHLABELMAX  64
+
+/* the preview's resource limits, see GeneratePreviewForURL.h */
+
+#define BENCHLIMITENTRIES     1000000
+#define BENCHLIMITHEADERBYTES (16 * 1024 * 1024)
+#define BENCHLIMITDEPTH       512
+#define BENCHLIMITMEMORY      (512 * 1024 * 1024)
+
+/* the preview's limits for nested archives, see GeneratePreviewForURL.h */
+
+#define BENCHNESTEDDEPTH 3
+#define BENCHNESTEDSIZE  (64 * 1024 * 1024)
+#define BENCHNESTEDTIME  5
+#define BENCHNESTEDMAGIC 64
+
+/* the result of benchmarking one archive, passed back from the child */
+
+typedef struct benchResult
+{
+    int status;
+    char format[BENCHLABELMAX];
+    unsigned long long entries;
+    unsigned long long totalBytes;
+    double ttfeUs;
+    double totalUs;
+    double minUs;
+    long peakRssKb;
+    int stopped;
+} benchResult_t;
+
+/* globals */
+
+static int gBenchLimits = 1;
+static int gBenchNested = 0;
+static int gBenchKeepErrors = 0;
+static unsigned int gBenchTimeout = 0;
+
+/* private functions */
+
+static struct archive *benchNewArchive(void);
+static void benchListNested(struct archive *parent,
+                            struct archive_entry *container,
+                            unsigned int depth,
+                            nestedLimits_t *limits,
+                            unsigned long long *entries,
+                            unsigned long long *totalBytes);
+static int benchListArchive(const char *path,
+                            unsigned long long *entries,
+                            unsigned long long *totalBytes,
+                            uint64_t *ttfe,
+                            char *format,
+                            size_t formatLen);
+static int benchListSit(const char *path,
+                        unsigned long long *entries,
+                        unsigned long long *totalBytes,
+                        uint64_t *ttfe,
+                        char *format,
+                        size_t formatLen);
+static int benchListHqx(const char *path,
+                        unsigned long long *entries,
+                        unsigned long long *totalBytes,
+                        uint64_t *ttfe,
+                        char *format,
+                        size_t formatLen);
+static int benchHasSuffix(const char *path, const char *suffix);
+static void benchRun(const char *path, int reps, benchResult_t *result);
+static int benchMeasure(const char *path, int reps, benchResult_t *result);
+static void printUsage(void);
+
+/*
+    benchNewArchive - create an archive reader with the preview's
+                      filters, formats and limits
+*/
+
+static struct archive *benchNewArchive(void)
+{
+    struct archive *a = NULL;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return NULL;
+    }
+
+    archive_read_support_filter_compress(a);
+    archive_read_support_filter_gzip(a);
+    archive_read_support_filter_bzip2(a);
+    archive_read_support_filter_xz(a);
+    archive_read_support_filter_uu(a);
+    archive_read_support_filter_rpm(a);
+    archive_read_support_filter_pbzx(a);
+    archive_read_support_filter_udif(a);
+
+    archive_read_support_format_cpio(a);
+    archive_read_support_format_tar(a);
+    archive_read_support_format_zip(a);
+    archive_read_support_format_xar(a);
+    archive_read_support_format_iso9660(a);
+    archive_read_support_format_rar(a);
+    archive_read_support_format_rar5(a);
+    archive_read_support_format_lha(a);
+    archive_read_support_format_ar(a);
+    archive_read_support_format_7zip(a);
+    archive_read_support_format_cab(a);
+
+    if (gBenchLimits)
+    {
+        archive_read_set_limit(a, ARCHIVE_READ_LIMIT_ENTRIES,
+                               BENCHLIMITENTRIES);
+        archive_read_set_limit(a, ARCHIVE_READ_LIMIT_HEADER_BYTES,
+                               BENCHLIMITHEADERBYTES);
+        archive_read_set_limit(a, ARCHIVE_READ_LIMIT_DEPTH,
+                               BENCHLIMITDEPTH);
+        archive_read_set_limit(a, ARCHIVE_READ_LIMIT_MEMORY,
+                               BENCHLIMITMEMORY);
+    }
+    else
+    {
+        archive_read_set_limit(a, ARCHIVE_READ_LIMIT_DEPTH, 0);
+    }
+
+    return a;
+}
+
+/*
+    benchListNested - list the archive in the parent's current entry,
+                      if it is one, as done by GeneratePreviewForURL
+*/
+
+static void benchListNested(struct archive *parent,
+                            struct archive_entry *container,
+                            unsigned int depth,
+                            nestedLimits_t *limits,
+                            unsigned long long *entries,
+                            unsigned long long *totalBytes)
+{
+    nestedArchive_t nested;
+    struct archive *child = NULL;
+    struct archive_entry *entry = NULL;
+    int r = 0;
+
+    if (depth > BENCHNESTEDDEPTH ||
+        archive_entry_filetype(container) != AE_IFREG ||
+        archive_entry_is_encrypted(container) ||
+        (archive_entry_size_is_set(container) &&
+         archive_entry_size(container) > BENCHNESTEDSIZE) ||
+        nestedIsExpired(limits->deadline))
+    {
+        return;
+    }
+
+    if (nestedCheck(&nested, parent, container, limits) != gNestedOkay)
+    {
+        nestedClose(&nested);
+        return;
+    }
+
+    child = benchNewArchive();
+    if (child == NULL)
+    {
+        nestedClose(&nested);
+        return;
+    }
+
+    if (nestedOpen(&nested, child) == gNestedOkay)
+    {
+        for (;;)
+        {
+            r = archive_read_next_header(child, &entry);
+            if (r != ARCHIVE_OK && r != ARCHIVE_WARN)
+            {
+                break;
+            }
+
+            (void)archive_entry_pathname(entry);
+            (void)archive_entry_filetype(entry);
+            (void)archive_entry_is_encrypted(entry);
+            (void)archive_entry_mtime(entry);
+
+            *totalBytes += (unsigned long long)archive_entry_size(entry);
+            (*entries)++;
+
+            benchListNested(child,
+                            entry,
+                            depth + 1,
+                            limits,
+                            entries,
+                            totalBytes);
+        }
+    }
+
+    nestedClose(&nested);
+    archive_read_free(child);
+}
+
+/*
+    benchListArchive - list an archive with libarchive, as done by
+                       GeneratePreviewForURL
+*/
+
+static int benchListArchive(const char *path,
+                            unsigned long long *entries,
+                            unsigned long long *totalBytes,
+                            uint64_t *ttfe,
+                            char *format,
+                            size_t formatLen)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    const char *name = NULL;
+    uint64_t start = benchNow();
+    nestedLimits_t limits;
+    int r = 0;
+    int ret = gBenchOkay;
+
+    a = benchNewArchive();
+    if (a == NULL)
+    {
+        return gBenchErr;
+    }
+
+    if (archive_read_open_filename(a, path, BENCHBLOCKSIZE) != ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "listbench: ERROR: %s: %s\n",
+                path,
+                archive_error_string(a));
+        archive_read_free(a);
+        return gBenchErr;
+    }
+
+    *entries = 0;
+    *totalBytes = 0;
+    *ttfe = 0;
+
+    limits.maxBytes = BENCHNESTEDSIZE;
+    limits.deadline = nestedDeadline(BENCHNESTEDTIME);
+    limits.magicChecks = BENCHNESTEDMAGIC;
+
+    for (;;)
+    {
+        r = archive_read_next_header(a, &entry);
+        if (r == ARCHIVE_EOF)
+        {
+            break;
+        }
+        if (r != ARCHIVE_OK && r != ARCHIVE_WARN)
+        {
+            fprintf(stderr,
+                    "listbench: ERROR: %s: %s\n",
+                    path,
+                    archive_error_string(a));
+            ret = gBenchErr;
+            break;
+        }
+
+        if (*entries == 0)
+        {
+            *ttfe = benchNow() - start;
+        }
+
+        /* the same accessors the preview uses for each row */
+
+        name = archive_entry_pathname(entry);
+        if (name == NULL)
+        {
+            name = archive_entry_pathname_utf8(entry);
+        }
+        (void)name;
+        (void)archive_entry_filetype(entry);
+        (void)archive_entry_is_encrypted(entry);
+        (void)archive_entry_mtime(entry);
+
+        *totalBytes += (unsigned long long)archive_entry_size(entry);
+        (*entries)++;
+
+        if (gBenchNested)
+        {
+            benchListNested(a, entry, 1, &limits, entries, totalBytes);
+        }
+    }
+
+    if (archive_format_name(a) != NULL)
+    {
+        snprintf(format, formatLen, "%s", archive_format_name(a));
+    }
+
+    archive_read_close(a);
+    archive_read_free(a);
+
+    return ret;
+}
+
+/* benchListSit - list a stuffit archive with sit.c */
+
+static int benchListSit(const char *path,
+                        unsigned long long *entries,
+                        unsigned long long *totalBytes,
+                        uint64_t *ttfe,
+                        char *format,
+                        size_t formatLen)
+{
+    sitFileHandle_t sitFile;
+    sitEntryHeader_t entry;
+    uint64_t start = benchNow();
+    int r = gSitOkay;
+
+    if (sitInitFileHandle(path, &sitFile) != gSitOkay)
+    {
+        return gBenchErr;
+    }
+
+    *entries = 0;
+    *totalBytes = 0;
+    *ttfe = 0;
+
+    while ((r = sitGetNextEntry(&sitFile, &entry)) == gSitOkay)
+    {
+        if (*entries == 0)
+        {
+            *ttfe = benchNow() - start;
+        }
+        (void)sitEntryGetAsciiName(&entry);
+        (void)sitIsEntryFolder(&entry);
+        *totalBytes += sitEntryGetUnCompressedSize(&entry);
+        (*entries)++;
+    }
+
+    snprintf(format, formatLen, "StuffIt %u", sitFile.version);
+    sitReleaseFileHandle(&sitFile);
+
+    return (r == gSitEOF ? gBenchOkay : gBenchErr);
+}
+
+/* benchListHqx - read the header of a binhex file with binhex.c */
+
+static int benchListHqx(const char *path,
+                        unsigned long long *entries,
+                        unsigned long long *totalBytes,
+                        uint64_t *ttfe,
+                        char *format,
+                        size_t formatLen)
+{
+    hqxFileHandle_t hqxFile;
+    uint64_t start = benchNow();
+    int ret = gBenchOkay;
+
+    if (hqxInitFileHandle(path, &hqxFile) != gHqxOkay)
+    {
+        return gBenchErr;
+    }
+
+    if (hqxGetHeader(&hqxFile) != gHqxOkay)
+    {
+        ret = gBenchErr;
+    }
+    else
+    {
+        *ttfe = benchNow() - start;
+        *entries = 1;
+        *totalBytes = (unsigned long long)(hqxFile.hqxHeader.dataLen +
+                                           hqxFile.hqxHeader.rsrcLen);
+    }
+
+    snprintf(format, formatLen, "BinHex 4.0");
+    hqxReleaseFileHandle(&hqxFile);
+
+    return ret;
+}
+
+/* benchHasSuffix - check if path ends with suffix */
+
+static int benchHasSuffix(const char *path, const char *suffix)
+{
+    size_t pathLen = strlen(path);
+    size_t suffixLen = strlen(suffix);
+
+    return (pathLen >= suffixLen &&
+            strcmp(path + pathLen - suffixLen, suffix) == 0);
+}
+
+/* benchRun - list path reps times (after one warm up) in this process */
+
+static void benchRun(const char *path, int reps, benchResult_t *result)
+{
+    double totals[BENCHMAXREPS];
+    double ttfes[BENCHMAXREPS];
+    struct rusage usage;
+    unsigned long long entries = 0;
+    unsigned long long totalBytes = 0;
+    uint64_t ttfe = 0;
+    uint64_t start = 0;
+    double elapsed = 0.0;
+    int i = 0;
+    int r = gBenchOkay;
+
+    memset(result, 0, sizeof(benchResult_t));
+
+    for (i = -1; i < reps; i++)
+    {
+        start = benchNow();
+
+        if (benchHasSuffix(path, ".sit"))
+        {
+            r = benchListSit(path, &entries, &totalBytes, &ttfe,
+                             result->format, sizeof(result->format));
+        }
+        else if (benchHasSuffix(path, ".hqx"))
+        {
+            r = benchListHqx(path, &entries, &totalBytes, &ttfe,
+                             result->format, sizeof(result->format));
+        }
+        else
+        {
+            r = benchListArchive(path, &entries, &totalBytes, &ttfe,
+                                 result->format, sizeof(result->format));
+        }
+
+        elapsed = (double)(benchNow() - start) / 1000.0;
+
+        if (r != gBenchOkay)
+        {
+            if (!gBenchKeepErrors)
+            {
+                result->status = gBenchErr;
+                return;
+            }
+            result->stopped = 1;
+        }
+
+        /* the first run warms the page cache and is not counted */
+
+        if (i < 0)
+        {
+            continue;
+        }
+
+        totals[i] = elapsed;
+        ttfes[i] = (double)ttfe / 1000.0;
+    }
+
+    result->entries = entries;
+    result->totalBytes = totalBytes;
+    result->totalUs = benchMedian(totals, reps);
+    result->minUs = totals[0];
+    result->ttfeUs = benchMedian(ttfes, reps);
+
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        result->peakRssKb = usage.ru_maxrss;
+    }
+
+    result->status = gBenchOkay;
+}
+
+/* benchMeasure - run the benchmark for path in a child process */
+
+static int benchMeasure(const char *path, int reps, benchResult_t *result)
+{
+    int fds[2];
+    pid_t pid = 0;
+    ssize_t n = 0;
+    int status = 0;
+
+    if (pipe(fds) != 0)
+    {
+        return gBenchErr;
+    }
+
+    pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return gBenchErr;
+    }
+
+    if (pid == 0)
+    {
+        close(fds[0]);
+        alarm(gBenchTimeout);
+        benchRun(path, reps, result);
+        n = write(fds[1], result, sizeof(benchResult_t));
+        close(fds[1]);
+        _exit(n == (ssize_t)sizeof(benchResult_t) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    n = read(fds[0], result, sizeof(benchResult_t));
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+
+    if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM)
+    {
+        fprintf(stderr,
+                "listbench: ERROR: '%s' timed out after %u seconds\n",
+                path,
+                gBenchTimeout);
+        return gBenchErr;
+    }
+
+    if (n != (ssize_t)sizeof(benchResult_t) ||
+        !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0)
+    {
+        return gBenchErr;
+    }
+
+    return result->status;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: listbench [-r repetitions] [-o output.json] [-e] [-u]\n"
+            "                 [-n] [-t timeout] archive ...\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchResult_t result;
+    struct utsname host;
+    struct stat sb;
+    const char *output = NULL;
+    const char *base = NULL;
+    char label[BENCHLABELMAX];
+    FILE *fp = stdout;
+    double seconds = 0.0;
+    size_t labelLen = 0;
+    int reps = 5;
+    int first = 1;
+    int failed = 0;
+    int i = 1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            reps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            gBenchTimeout = (unsigned int)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-e") == 0)
+        {
+            gBenchKeepErrors = 1;
+        }
+        else if (strcmp(argv[i], "-u") == 0)
+        {
+            gBenchLimits = 0;
+        }
+        else if (strcmp(argv[i], "-n") == 0)
+        {
+            gBenchNested = 1;
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (i >= argc || reps < 1 || reps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    fp = benchOpenOutput("listbench", output);
+    if (fp == NULL)
+    {
+        return 1;
+    }
+
+    memset(&host, 0, sizeof(host));
+    uname(&host);
+
+    fprintf(fp, "{\n  \"libarchive\": ");
+    benchPrintJSONString(fp, archive_version_string());
+    fprintf(fp, ",\n  \"host\": ");
+    benchPrintJSONString(fp, host.machine);
+    fprintf(fp, ",\n  \"system\": ");
+    benchPrintJSONString(fp, host.release);
+    fprintf(fp, ",\n  \"repetitions\": %d,\n  \"results\": [", reps);
+
+    for (; i < argc; i++)
+    {
+        if (stat(argv[i], &sb) != 0)
+        {
+            fprintf(stderr,
+                    "listbench: ERROR: cannot stat '%s': %s\n",
+                    argv[i],
+                    strerror(errno));
+            failed++;
+            continue;
+        }
+
+        base = strrchr(argv[i], '/');
+        base = (base == NULL ? argv[i] : base + 1);
+        labelLen = strcspn(base, "-.");
+        if (labelLen >= sizeof(label))
+        {
+            labelLen = sizeof(label) - 1;
+        }
+        memcpy(label, base, labelLen);
+        label[labelLen] = '\0';
+
+        if (benchMeasure(argv[i], reps, &result) != gBenchOkay)
+        {
+            fprintf(stderr, "listbench: ERROR: '%s' failed\n", argv[i]);
+            failed++;
+            continue;
+        }
+
+        seconds = result.totalUs / 1000000.0;
+
+        fprintf(fp, "%s\n    {\"label\": ", (first ? "" : ","));
+        benchPrintJSONString(fp, label);
+        fprintf(fp, ", \"file\": ");
+        benchPrintJSONString(fp, base);
+        fprintf(fp, ", \"format\": ");
+        benchPrintJSONString(fp, result.format);
+        fprintf(fp,
+                ",\n     \"bytes\": %lld, \"entries\": %llu, "
+                "\"uncompressedBytes\": %llu,\n"
+                "     \"ttfeUs\": %.1f, \"totalUs\": %.1f, "
+                "\"minUs\": %.1f,\n"
+                "     \"entriesPerSec\": %.0f, \"mbPerSec\": %.2f, "
+                "\"peakRssKb\": %ld, \"stopped\": %s}",
+                (long long)sb.st_size,
+                result.entries,
+                result.totalBytes,
+                result.ttfeUs,
+                result.totalUs,
+                result.minUs,
+                (seconds > 0 ? (double)result.entries / seconds : 0.0),
+                (seconds > 0 ?
+                 (double)sb.st_size / (1024.0 * 1024.0) / seconds : 0.0),
+                result.peakRssKb,
+                (result.stopped ? "true" : "false"));
+        first = 0;
+
+        if (output != NULL)
+        {
+            fprintf(stderr,
+                    "%-10s %-40s %9llu entries %10.1f ms%s\n",
+                    label,
+                    base,
+                    result.entries,
+                    result.totalUs / 1000.0,
+                    (result.stopped ? " (stopped)" : ""));
+        }
+    }
+
+    fprintf(fp, "\n  ]\n}\n");
+
+    benchCloseOutput(fp);
+
+    return (failed == 0 ? 0 : 1);
+}
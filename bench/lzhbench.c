@@ -0,0 +1,1261 @@
+/*
+    lzhbench.c - benchmark the lh5, lh6 and lh7 decoders of the lha reader
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://github.com/jca02266/lha/blob/master/header.doc.md
+    https://github.com/jca02266/lha/blob/master/src/slide.c
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    lzhbench reads every entry of each of the given lha archives with
+    libarchive's lha reader, once with the reference lh5, lh6 and lh7
+    decoder ("lha:lzh=reference") and once with the fast one
+    ("lha:lzh=fast"), checks that both give the same data, and
+    reports, as JSON, for each archive:
+
+        archive, compressedBytes, bytes - the archive, its size and
+                       the size of its entries
+        crc          - the CRC-32 of the entries' data
+        referenceMs, fastMs - the median wall time of each decoder
+        referenceMBPerSec, fastMBPerSec - the MB decoded per second
+        speedup      - referenceMs / fastMs
+
+    Each decoder is run repeatedly (-r), after one warm up run that is
+    not counted.  With -m, lzhbench instead writes an archive of
+    BENCHFILES files, size MB in all, compressed with the given method
+    (lh5, lh6 or lh7), like old Japanese software: Shift JIS text, x86
+    like code and some random bytes.  The encoder is a simple greedy
+    one with length limited Huffman codes; it is only meant to make
+    test data.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* the decoders */
+
+enum
+{
+    gBenchReference = 0,
+    gBenchFast      = 1,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHFILES     16
+#define BENCHCHUNK     64
+#define BENCHBLOCKSIZE 65536
+#define BENCHNAMEMAX   64
+
+/* lh5, lh6 and lh7, see lzh_decode_init() in the lha reader */
+
+#define LZHMINMATCH    3
+#define LZHMAXMATCH    256
+#define LZHLITSIZE     (256 + LZHMAXMATCH - LZHMINMATCH + 1)
+#define LZHPRESIZE     19
+#define LZHMAXPOS      17
+#define LZHMAXBITS     16
+#define LZHBLOCKSYMS   16384
+#define LZHHASHBITS    16
+#define LZHCHAIN       16
+
+/* an lzh bit stream, high bit first */
+
+typedef struct lzhBits
+{
+    unsigned char *buf;
+    size_t len;
+    uint64_t bits;
+    int count;
+} lzhBits_t;
+
+/* a symbol of a block: a literal, or a match length and distance */
+
+typedef struct lzhSym
+{
+    uint16_t lit;
+    uint16_t dist;
+} lzhSym_t;
+
+/* the encoder */
+
+typedef struct lzhEnc
+{
+    const unsigned char *data;
+    int32_t *head;
+    int32_t *prev;
+    int winBits;
+    lzhSym_t syms[LZHBLOCKSYMS];
+} lzhEnc_t;
+
+/* the result of one archive */
+
+typedef struct benchRun
+{
+    const char *archive;
+    uint64_t compressedBytes;
+    uint64_t bytes;
+    uLong crc[2];
+    double wallMs[2];
+} benchRun_t;
+
+/* a node of a Huffman tree */
+
+typedef struct lzhNode
+{
+    uint32_t weight;
+    int sym;
+} lzhNode_t;
+
+/* globals */
+
+static const char *gPhrase =
+    "\x83\x51\x81\x5B\x83\x80\x82\xF0\x8A\x4A\x8E\x6E\x82\xB5\x82\xDC"
+    "\x82\xB7\x81\x42\x83\x66\x81\x5B\x83\x5E\x82\xF0\x95\xDB\x91\xB6"
+    "\x82\xB5\x82\xC4\x82\xA9\x82\xE7\x8F\x49\x97\xB9\x82\xB5\x82\xC4"
+    "\x82\xAD\x82\xBE\x82\xB3\x82\xA2\x81\x42 README.DOC GAME.EXE "
+    "Copyright (C) 1994 Example Soft. ";
+
+static const unsigned char gOpcodes[] =
+{
+    0x8B, 0x89, 0x50, 0x83, 0xC3, 0x55, 0x5D, 0x0F,
+    0x85, 0x74, 0xFF, 0x46, 0x26, 0x00, 0x33, 0xC0,
+};
+
+/* private functions */
+
+static void putLE16(unsigned char *buf, uint16_t value);
+static void putLE32(unsigned char *buf, uint32_t value);
+static uint16_t crc16Arc(uint16_t crc, const unsigned char *buf, size_t len);
+static void benchFill(unsigned char *p, size_t size);
+static void lzhPutBits(lzhBits_t *bw, uint32_t value, int n);
+static void lzhFlushBits(lzhBits_t *bw);
+static int lzhCompareNodes(const void *a, const void *b);
+static void lzhLengths(const uint32_t *freq,
+                       int num,
+                       int limit,
+                       unsigned char *lens);
+static void lzhCodes(const unsigned char *lens, int num, uint16_t *codes);
+static int lzhUsed(const unsigned char *lens, int num);
+static void lzhPutLength(lzhBits_t *bw, int len);
+static void lzhPutPreTree(lzhBits_t *bw,
+                          const unsigned char *lens,
+                          int num,
+                          int countBits,
+                          int skip);
+static int lzhPosCode(uint32_t dist);
+static size_t lzhMatch(lzhEnc_t *enc,
+                       size_t pos,
+                       size_t end,
+                       uint32_t *dist);
+static void lzhInsert(lzhEnc_t *enc, size_t pos);
+static void lzhBlock(lzhEnc_t *enc, lzhBits_t *bw, int numSyms);
+static int lzhCompress(lzhEnc_t *enc,
+                       size_t start,
+                       size_t end,
+                       lzhBits_t *bw);
+static int benchMakeArchive(const char *path,
+                            unsigned long sizeMB,
+                            const char *method);
+static int benchRead(benchRun_t *run, int how);
+static void printUsage(void);
+
+/* putLE16 - store a 16 bit little endian value */
+
+static void putLE16(unsigned char *buf, uint16_t value)
+{
+    buf[0] = (unsigned char)(value & 0xff);
+    buf[1] = (unsigned char)((value >> 8) & 0xff);
+}
+
+/* putLE32 - store a 32 bit little endian value */
+
+static void putLE32(unsigned char *buf, uint32_t value)
+{
+    putLE16(buf, (uint16_t)(value & 0xffff));
+    putLE16(buf + 2, (uint16_t)((value >> 16) & 0xffff));
+}
+
+/* crc16Arc - CRC-16/ARC, as used by lha */
+
+static uint16_t crc16Arc(uint16_t crc, const unsigned char *buf, size_t len)
+{
+    size_t i = 0;
+    int bit = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        crc ^= buf[i];
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0xA001) :
+                              (uint16_t)(crc >> 1);
+        }
+    }
+
+    return crc;
+}
+
+/*
+    benchFill - fill p with chunks of Shift JIS text, x86 like code
+                and random bytes
+*/
+
+static void benchFill(unsigned char *p, size_t size)
+{
+    unsigned char chunk[BENCHCHUNK];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    size_t phraseLen = strlen(gPhrase);
+    size_t pos = 0;
+    size_t len = 0;
+    size_t i = 0;
+    int r = 0;
+
+    while (pos < size)
+    {
+        r = (int)(benchRand(&state) % 100);
+
+        if (r < 50)
+        {
+            i = (size_t)(benchRand(&state) % phraseLen);
+            for (len = 0; len < BENCHCHUNK; len++)
+            {
+                chunk[len] = (unsigned char)gPhrase[i];
+                i = (i + 1) % phraseLen;
+            }
+        }
+        else if (r < 90)
+        {
+            for (len = 0; len < BENCHCHUNK; len++)
+            {
+                chunk[len] = gOpcodes[benchRand(&state) % sizeof(gOpcodes)];
+            }
+        }
+        else
+        {
+            for (len = 0; len < BENCHCHUNK; len++)
+            {
+                chunk[len] = (unsigned char)benchRand(&state);
+            }
+        }
+
+        if (len > size - pos)
+        {
+            len = size - pos;
+        }
+        memcpy(p + pos, chunk, len);
+        pos += len;
+    }
+}
+
+/* lzhPutBits - write the low n bits of value */
+
+static void lzhPutBits(lzhBits_t *bw, uint32_t value, int n)
+{
+    if (n == 0)
+    {
+        return;
+    }
+
+    bw->bits = (bw->bits << n) | (value & ((1U << n) - 1));
+    bw->count += n;
+
+    while (bw->count >= 8)
+    {
+        bw->count -= 8;
+        bw->buf[bw->len++] = (unsigned char)(bw->bits >> bw->count);
+    }
+}
+
+/* lzhFlushBits - pad the last byte with zero bits */
+
+static void lzhFlushBits(lzhBits_t *bw)
+{
+    if (bw->count > 0)
+    {
+        lzhPutBits(bw, 0, 8 - bw->count);
+    }
+}
+
+/* lzhCompareNodes - qsort() comparison function for Huffman leaves */
+
+static int lzhCompareNodes(const void *a, const void *b)
+{
+    const lzhNode_t *x = a;
+    const lzhNode_t *y = b;
+
+    if (x->weight != y->weight)
+    {
+        return (x->weight < y->weight ? -1 : 1);
+    }
+
+    return x->sym - y->sym;
+}
+
+/*
+    lzhLengths - Huffman code lengths of at most limit bits for freq;
+                 the weights are halved until the tree fits
+*/
+
+static void lzhLengths(const uint32_t *freq,
+                       int num,
+                       int limit,
+                       unsigned char *lens)
+{
+    lzhNode_t leaves[LZHLITSIZE];
+    uint32_t weight[2 * LZHLITSIZE];
+    int parent[2 * LZHLITSIZE];
+    int depth[2 * LZHLITSIZE];
+    uint32_t scale = 0;
+    int n = 0;
+    int i = 0;
+    int j = 0;
+    int k = 0;
+    int pick = 0;
+    int m = 0;
+    int maxDepth = 0;
+
+    memset(lens, 0, (size_t)num);
+
+    for (i = 0; i < num; i++)
+    {
+        if (freq[i] > 0)
+        {
+            leaves[n].weight = freq[i];
+            leaves[n].sym = i;
+            n++;
+        }
+    }
+
+    /* one symbol is written as a table of one symbol, see lzhUsed() */
+
+    if (n < 2)
+    {
+        return;
+    }
+
+    for (scale = 0; ; scale++)
+    {
+        for (i = 0; i < n; i++)
+        {
+            leaves[i].weight = (freq[leaves[i].sym] >> scale) | 1;
+        }
+        qsort(leaves, (size_t)n, sizeof(lzhNode_t), lzhCompareNodes);
+
+        /* two queues: the sorted leaves and the new nodes */
+
+        for (i = 0; i < n; i++)
+        {
+            weight[i] = leaves[i].weight;
+        }
+        i = 0;
+        j = n;
+        for (k = n; k < 2 * n - 1; k++)
+        {
+            weight[k] = 0;
+            for (m = 0; m < 2; m++)
+            {
+                if (j < k && (i >= n || weight[j] < weight[i]))
+                {
+                    pick = j++;
+                }
+                else
+                {
+                    pick = i++;
+                }
+                parent[pick] = k;
+                weight[k] += weight[pick];
+            }
+        }
+
+        depth[2 * n - 2] = 0;
+        maxDepth = 0;
+        for (k = 2 * n - 3; k >= 0; k--)
+        {
+            depth[k] = depth[parent[k]] + 1;
+            if (k < n && depth[k] > maxDepth)
+            {
+                maxDepth = depth[k];
+            }
+        }
+
+        if (maxDepth <= limit)
+        {
+            break;
+        }
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        lens[leaves[i].sym] = (unsigned char)depth[i];
+    }
+}
+
+/*
+    lzhCodes - canonical codes for lens, in the order that
+               lzh_make_huffman_table() assigns them
+*/
+
+static void lzhCodes(const unsigned char *lens, int num, uint16_t *codes)
+{
+    int count[LZHMAXBITS + 1];
+    int next[LZHMAXBITS + 1];
+    int code = 0;
+    int len = 0;
+    int i = 0;
+
+    memset(count, 0, sizeof(count));
+    for (i = 0; i < num; i++)
+    {
+        count[lens[i]]++;
+    }
+    count[0] = 0;
+
+    for (len = 1; len <= LZHMAXBITS; len++)
+    {
+        code = (code + count[len - 1]) << 1;
+        next[len] = code;
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        codes[i] = (lens[i] > 0 ? (uint16_t)next[lens[i]]++ : 0);
+    }
+}
+
+/*
+    lzhUsed - the number of lengths to write (one past the last
+              symbol with a code), or 0 if there is no code
+*/
+
+static int lzhUsed(const unsigned char *lens, int num)
+{
+    while (num > 0 && lens[num - 1] == 0)
+    {
+        num--;
+    }
+
+    return num;
+}
+
+/*
+    lzhPutLength - write a code length of a pre-tree or position tree:
+                   0 to 6 in 3 bits, 7 to 16 as 111, a 1 for every
+                   length over 7, then a 0
+*/
+
+static void lzhPutLength(lzhBits_t *bw, int len)
+{
+    if (len < 7)
+    {
+        lzhPutBits(bw, (uint32_t)len, 3);
+        return;
+    }
+
+    lzhPutBits(bw, 7, 3);
+    lzhPutBits(bw, ((1U << (len - 7)) - 1) << 1, len - 6);
+}
+
+/*
+    lzhPutPreTree - write the lengths of a pre-tree or position tree,
+                    with a count of countBits bits; with skip, a 2 bit
+                    count of the zero lengths after the third one
+                    follows the third length
+*/
+
+static void lzhPutPreTree(lzhBits_t *bw,
+                          const unsigned char *lens,
+                          int num,
+                          int countBits,
+                          int skip)
+{
+    int zeros = 0;
+    int i = 0;
+
+    lzhPutBits(bw, (uint32_t)num, countBits);
+
+    for (i = 0; i < num; i++)
+    {
+        lzhPutLength(bw, lens[i]);
+        if (skip && i == 2)
+        {
+            for (zeros = 0;
+                 zeros < 3 && i + 1 + zeros < num && lens[i + 1 + zeros] == 0;
+                 zeros++)
+            {
+            }
+            lzhPutBits(bw, (uint32_t)zeros, 2);
+            i += zeros;
+        }
+    }
+}
+
+/* lzhPosCode - the position code of a distance - 1 */
+
+static int lzhPosCode(uint32_t dist)
+{
+    int code = 0;
+
+    while (dist > 0)
+    {
+        code++;
+        dist >>= 1;
+    }
+
+    return code;
+}
+
+/*
+    lzhMatch - find the longest match for pos within the window, up to
+               end, in the hash chains
+*/
+
+static size_t lzhMatch(lzhEnc_t *enc,
+                       size_t pos,
+                       size_t end,
+                       uint32_t *dist)
+{
+    const unsigned char *data = enc->data;
+    size_t maxLen = end - pos;
+    size_t window = (size_t)1 << enc->winBits;
+    size_t best = 0;
+    size_t len = 0;
+    int32_t cand = 0;
+    uint32_t h = 0;
+    int chain = LZHCHAIN;
+
+    if (maxLen < LZHMINMATCH)
+    {
+        return 0;
+    }
+    if (maxLen > LZHMAXMATCH)
+    {
+        maxLen = LZHMAXMATCH;
+    }
+
+    h = ((uint32_t)data[pos] << 16 | (uint32_t)data[pos + 1] << 8 |
+         data[pos + 2]) * 2654435761U >> (32 - LZHHASHBITS);
+
+    for (cand = enc->head[h];
+         cand >= 0 && pos - (size_t)cand <= window && chain-- > 0;
+         cand = enc->prev[cand & (window - 1)])
+    {
+        if (data[cand + best] != data[pos + best])
+        {
+            continue;
+        }
+        for (len = 0; len < maxLen && data[cand + len] == data[pos + len];
+             len++)
+        {
+        }
+        if (len > best)
+        {
+            best = len;
+            *dist = (uint32_t)(pos - (size_t)cand);
+            if (best == maxLen)
+            {
+                break;
+            }
+        }
+    }
+
+    return (best >= LZHMINMATCH ? best : 0);
+}
+
+/* lzhInsert - add pos to the hash chains */
+
+static void lzhInsert(lzhEnc_t *enc, size_t pos)
+{
+    const unsigned char *data = enc->data;
+    uint32_t h = 0;
+
+    h = ((uint32_t)data[pos] << 16 | (uint32_t)data[pos + 1] << 8 |
+         data[pos + 2]) * 2654435761U >> (32 - LZHHASHBITS);
+    enc->prev[pos & (((size_t)1 << enc->winBits) - 1)] = enc->head[h];
+    enc->head[h] = (int32_t)pos;
+}
+
+/*
+    lzhBlock - write a block of numSyms symbols: the symbol count, the
+               pre-tree, the literal and length tree coded with it,
+               the position tree and then the symbols.  A tree with
+               one symbol is written as a count of 0 and the symbol.
+*/
+
+static void lzhBlock(lzhEnc_t *enc, lzhBits_t *bw, int numSyms)
+{
+    uint32_t litFreq[LZHLITSIZE];
+    uint32_t posFreq[LZHMAXPOS];
+    uint32_t preFreq[LZHPRESIZE];
+    unsigned char litLens[LZHLITSIZE];
+    unsigned char posLens[LZHMAXPOS];
+    unsigned char preLens[LZHPRESIZE];
+    uint16_t litCodes[LZHLITSIZE];
+    uint16_t posCodes[LZHMAXPOS];
+    uint16_t preCodes[LZHPRESIZE];
+    int posSize = enc->winBits + 1;
+    int posBits = (enc->winBits >= 15 ? 5 : 4);
+    int numLit = 0;
+    int numPos = 0;
+    int numPre = 0;
+    int run = 0;
+    int code = 0;
+    int i = 0;
+    int j = 0;
+
+    memset(litFreq, 0, sizeof(litFreq));
+    memset(posFreq, 0, sizeof(posFreq));
+    memset(preFreq, 0, sizeof(preFreq));
+
+    for (i = 0; i < numSyms; i++)
+    {
+        litFreq[enc->syms[i].lit]++;
+        if (enc->syms[i].lit > 255)
+        {
+            posFreq[lzhPosCode(enc->syms[i].dist)]++;
+        }
+    }
+
+    lzhLengths(litFreq, LZHLITSIZE, LZHMAXBITS, litLens);
+    lzhLengths(posFreq, posSize, LZHMAXBITS, posLens);
+    lzhCodes(litLens, LZHLITSIZE, litCodes);
+    lzhCodes(posLens, posSize, posCodes);
+    numLit = lzhUsed(litLens, LZHLITSIZE);
+    numPos = lzhUsed(posLens, posSize);
+
+    /* the pre-tree codes the literal and length tree's lengths */
+
+    for (i = 0; i < numLit; i = j)
+    {
+        for (j = i; j < numLit && litLens[j] == 0; j++)
+        {
+        }
+        run = j - i;
+        if (run == 0)
+        {
+            preFreq[litLens[i] + 2]++;
+            j = i + 1;
+        }
+        else if (run <= 2)
+        {
+            preFreq[0] += (uint32_t)run;
+        }
+        else if (run <= 18)
+        {
+            preFreq[1]++;
+        }
+        else if (run == 19)
+        {
+            preFreq[0]++;
+            preFreq[1]++;
+        }
+        else
+        {
+            preFreq[2]++;
+        }
+    }
+
+    lzhLengths(preFreq, LZHPRESIZE, LZHMAXBITS, preLens);
+    lzhCodes(preLens, LZHPRESIZE, preCodes);
+    numPre = lzhUsed(preLens, LZHPRESIZE);
+
+    lzhPutBits(bw, (uint32_t)numSyms, 16);
+
+    if (numLit == 0)
+    {
+        /* one literal or length symbol, so no pre-tree */
+
+        for (code = 0; litFreq[code] == 0; code++)
+        {
+        }
+        lzhPutBits(bw, 0, 5);
+        lzhPutBits(bw, 0, 5);
+        lzhPutBits(bw, 0, 9);
+        lzhPutBits(bw, (uint32_t)code, 9);
+    }
+    else
+    {
+        if (numPre == 0)
+        {
+            for (code = 0; preFreq[code] == 0; code++)
+            {
+            }
+            lzhPutBits(bw, 0, 5);
+            lzhPutBits(bw, (uint32_t)code, 5);
+        }
+        else
+        {
+            lzhPutPreTree(bw, preLens, numPre, 5, 1);
+        }
+
+        lzhPutBits(bw, (uint32_t)numLit, 9);
+        for (i = 0; i < numLit; i = j)
+        {
+            for (j = i; j < numLit && litLens[j] == 0; j++)
+            {
+            }
+            run = j - i;
+            if (run == 0)
+            {
+                code = litLens[i] + 2;
+                lzhPutBits(bw, preCodes[code], preLens[code]);
+                j = i + 1;
+                continue;
+            }
+            if (run == 19)
+            {
+                lzhPutBits(bw, preCodes[0], preLens[0]);
+                run--;
+            }
+            if (run <= 2)
+            {
+                while (run-- > 0)
+                {
+                    lzhPutBits(bw, preCodes[0], preLens[0]);
+                }
+            }
+            else if (run <= 18)
+            {
+                lzhPutBits(bw, preCodes[1], preLens[1]);
+                lzhPutBits(bw, (uint32_t)(run - 3), 4);
+            }
+            else
+            {
+                lzhPutBits(bw, preCodes[2], preLens[2]);
+                lzhPutBits(bw, (uint32_t)(run - 20), 9);
+            }
+        }
+    }
+
+    if (numPos == 0)
+    {
+        for (code = 0; code < posSize && posFreq[code] == 0; code++)
+        {
+        }
+        lzhPutBits(bw, 0, posBits);
+        lzhPutBits(bw, (uint32_t)(code < posSize ? code : 0), posBits);
+    }
+    else
+    {
+        lzhPutPreTree(bw, posLens, numPos, posBits, 0);
+    }
+
+    for (i = 0; i < numSyms; i++)
+    {
+        code = enc->syms[i].lit;
+        lzhPutBits(bw, litCodes[code], litLens[code]);
+        if (code > 255)
+        {
+            code = lzhPosCode(enc->syms[i].dist);
+            lzhPutBits(bw, posCodes[code], posLens[code]);
+            if (code > 1)
+            {
+                lzhPutBits(bw,
+                           enc->syms[i].dist - (1U << (code - 1)),
+                           code - 1);
+            }
+        }
+    }
+}
+
+/*
+    lzhCompress - compress data from start to end into bw, which must
+                  have room for the worst case
+*/
+
+static int lzhCompress(lzhEnc_t *enc,
+                       size_t start,
+                       size_t end,
+                       lzhBits_t *bw)
+{
+    size_t pos = start;
+    size_t len = 0;
+    size_t i = 0;
+    uint32_t dist = 0;
+    int numSyms = 0;
+
+    memset(enc->head, 0xff, sizeof(int32_t) << LZHHASHBITS);
+
+    while (pos < end)
+    {
+        len = (end - pos >= LZHMINMATCH ? lzhMatch(enc, pos, end, &dist) : 0);
+        if (len > 0 && dist - 1 < ((uint32_t)1 << enc->winBits))
+        {
+            enc->syms[numSyms].lit = (uint16_t)(256 + len - LZHMINMATCH);
+            enc->syms[numSyms].dist = (uint16_t)(dist - 1);
+        }
+        else
+        {
+            len = 1;
+            enc->syms[numSyms].lit = enc->data[pos];
+        }
+        numSyms++;
+
+        for (i = 0; i < len; i++, pos++)
+        {
+            if (end - pos >= LZHMINMATCH)
+            {
+                lzhInsert(enc, pos);
+            }
+        }
+
+        if (numSyms == LZHBLOCKSYMS)
+        {
+            lzhBlock(enc, bw, numSyms);
+            numSyms = 0;
+        }
+    }
+
+    if (numSyms > 0)
+    {
+        lzhBlock(enc, bw, numSyms);
+    }
+    lzhFlushBits(bw);
+
+    return gBenchOkay;
+}
+
+/*
+    benchMakeArchive - write an archive of BENCHFILES files, sizeMB in
+                       all, with level 2 headers and the given method
+*/
+
+static int benchMakeArchive(const char *path,
+                            unsigned long sizeMB,
+                            const char *method)
+{
+    unsigned char hdr[24 + 5 + 3 + BENCHNAMEMAX + 2];
+    char name[BENCHNAMEMAX];
+    lzhEnc_t *enc = NULL;
+    lzhBits_t bw;
+    unsigned char *data = NULL;
+    FILE *fp = NULL;
+    size_t size = (size_t)sizeMB * 1024 * 1024;
+    size_t fileSize = size / BENCHFILES;
+    size_t start = 0;
+    size_t len = 0;
+    size_t nameLen = 0;
+    size_t hdrLen = 0;
+    int i = 0;
+    int ret = gBenchErr;
+
+    memset(&bw, 0, sizeof(bw));
+
+    enc = calloc(1, sizeof(lzhEnc_t));
+    if (enc == NULL)
+    {
+        return gBenchErr;
+    }
+
+    if (strcmp(method, "lh5") == 0)
+    {
+        enc->winBits = 13;
+    }
+    else if (strcmp(method, "lh6") == 0)
+    {
+        enc->winBits = 15;
+    }
+    else if (strcmp(method, "lh7") == 0)
+    {
+        enc->winBits = 16;
+    }
+    else
+    {
+        fprintf(stderr, "lzhbench: ERROR: the method is lh5, lh6 or lh7\n");
+        free(enc);
+        return gBenchErr;
+    }
+
+    if (size == 0 || fileSize > 0x7FFFFFFFUL)
+    {
+        fprintf(stderr, "lzhbench: ERROR: a file holds 1 byte to 2GB\n");
+        free(enc);
+        return gBenchErr;
+    }
+
+    data = malloc(size);
+    enc->head = malloc(sizeof(int32_t) << LZHHASHBITS);
+    enc->prev = malloc(sizeof(int32_t) << enc->winBits);
+
+    /* the worst case is all literals of up to 16 bits, and the trees */
+
+    bw.buf = malloc(2 * (size - fileSize * (BENCHFILES - 1)) + 65536);
+    if (data == NULL || enc->head == NULL || enc->prev == NULL ||
+        bw.buf == NULL)
+    {
+        goto done;
+    }
+    enc->data = data;
+
+    benchFill(data, size);
+
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        fprintf(stderr,
+                "lzhbench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    /* each file is compressed on its own; the last gets the rest */
+
+    for (i = 0; i < BENCHFILES; i++)
+    {
+        start = fileSize * (size_t)i;
+        len = (i + 1 < BENCHFILES ? fileSize : size - start);
+
+        bw.len = 0;
+        bw.bits = 0;
+        bw.count = 0;
+        lzhCompress(enc, start, start + len, &bw);
+
+        nameLen = (size_t)snprintf(name, sizeof(name), "GAME%02d.DAT", i);
+
+        /* a level 2 header, as mkcorpus writes them */
+
+        memset(hdr, 0, sizeof(hdr));
+        hdr[2] = '-';
+        memcpy(hdr + 3, method, 3);
+        hdr[6] = '-';
+        putLE32(hdr + 7, (uint32_t)bw.len);
+        putLE32(hdr + 11, (uint32_t)len);
+        putLE32(hdr + 15, 0x3F000000);
+        hdr[19] = 0x20;
+        hdr[20] = 2;
+        putLE16(hdr + 21, crc16Arc(0, data + start, len));
+        hdr[23] = 'M';
+        hdrLen = 24;
+
+        /* header CRC extended header, filled in below */
+
+        putLE16(hdr + hdrLen, 5);
+        hdr[hdrLen + 2] = 0x00;
+        hdrLen += 5;
+
+        /* file name */
+
+        putLE16(hdr + hdrLen, (uint16_t)(3 + nameLen));
+        hdr[hdrLen + 2] = 0x01;
+        memcpy(hdr + hdrLen + 3, name, nameLen);
+        hdrLen += 3 + nameLen;
+
+        /* end of the extended headers */
+
+        putLE16(hdr + hdrLen, 0);
+        hdrLen += 2;
+
+        putLE16(hdr, (uint16_t)hdrLen);
+        putLE16(hdr + 27, crc16Arc(0, hdr, hdrLen));
+
+        if (fwrite(hdr, 1, hdrLen, fp) != hdrLen ||
+            fwrite(bw.buf, 1, bw.len, fp) != bw.len)
+        {
+            goto done;
+        }
+    }
+
+    /* the end of the archive */
+
+    if (fputc(0, fp) == EOF)
+    {
+        goto done;
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (fp != NULL && fclose(fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    if (ret != gBenchOkay)
+    {
+        fprintf(stderr, "lzhbench: ERROR: cannot write '%s'\n", path);
+    }
+    free(enc->head);
+    free(enc->prev);
+    free(enc);
+    free(bw.buf);
+    free(data);
+
+    return ret;
+}
+
+/* benchRead - read every entry in run->archive with one decoder */
+
+static int benchRead(benchRun_t *run, int how)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    const void *buf = NULL;
+    size_t size = 0;
+    la_int64_t offset = 0;
+    int r = ARCHIVE_OK;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return gBenchErr;
+    }
+
+    archive_read_support_format_lha(a);
+    if (archive_read_set_options(a,
+                                 how == gBenchFast ?
+                                 "lha:lzh=fast" :
+                                 "lha:lzh=reference") != ARCHIVE_OK ||
+        archive_read_open_filename(a, run->archive, BENCHBLOCKSIZE) !=
+        ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "lzhbench: ERROR: cannot open '%s': %s\n",
+                run->archive,
+                archive_error_string(a));
+        archive_read_free(a);
+        return gBenchErr;
+    }
+
+    run->bytes = 0;
+    run->crc[how] = crc32(0L, Z_NULL, 0);
+
+    while ((r = archive_read_next_header(a, &entry)) == ARCHIVE_OK)
+    {
+        while ((r = archive_read_data_block(a, &buf, &size, &offset)) ==
+               ARCHIVE_OK)
+        {
+            /* the lha reader hands out empty blocks now and then */
+
+            if (size == 0)
+            {
+                continue;
+            }
+            run->crc[how] = crc32(run->crc[how], buf, (uInt)size);
+            run->bytes += size;
+        }
+        if (r != ARCHIVE_EOF)
+        {
+            break;
+        }
+    }
+
+    if (r != ARCHIVE_EOF)
+    {
+        fprintf(stderr,
+                "lzhbench: ERROR: cannot read '%s': %s\n",
+                run->archive,
+                archive_error_string(a));
+        archive_read_free(a);
+        return gBenchErr;
+    }
+
+    archive_read_free(a);
+
+    return gBenchOkay;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: lzhbench [-r repetitions] [-o output.json] archive ...\n"
+            "       lzhbench -m size MB lh5|lh6|lh7 archive\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t *runs = NULL;
+    const char *output = NULL;
+    double times[BENCHMAXREPS];
+    double secs[2];
+    struct stat sb;
+    uint64_t start = 0;
+    unsigned long makeMB = 0;
+    FILE *fp = stdout;
+    int numRuns = 0;
+    int numReps = 3;
+    int run = 0;
+    int how = 0;
+    int r = 0;
+    int i = 1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeMB = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeMB > 0)
+    {
+        if (i + 2 != argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeArchive(argv[i + 1], makeMB, argv[i]) ==
+                gBenchOkay ? 0 : 1);
+    }
+
+    if (i >= argc || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    numRuns = argc - i;
+    runs = calloc((size_t)numRuns, sizeof(benchRun_t));
+    if (runs == NULL)
+    {
+        return 1;
+    }
+
+    /* the first repetition of each decoder is a warm up */
+
+    for (run = 0; run < numRuns; run++)
+    {
+        runs[run].archive = argv[i + run];
+        if (stat(runs[run].archive, &sb) == 0)
+        {
+            runs[run].compressedBytes = (uint64_t)sb.st_size;
+        }
+
+        for (how = gBenchReference; how <= gBenchFast; how++)
+        {
+            for (r = -1; r < numReps; r++)
+            {
+                start = benchNow();
+                if (benchRead(&runs[run], how) != gBenchOkay)
+                {
+                    free(runs);
+                    return 1;
+                }
+                if (r >= 0)
+                {
+                    times[r] = (double)(benchNow() - start) / 1000000.0;
+                }
+            }
+
+            runs[run].wallMs[how] = benchMedian(times, numReps);
+        }
+
+        if (runs[run].crc[gBenchReference] != runs[run].crc[gBenchFast])
+        {
+            fprintf(stderr,
+                    "lzhbench: ERROR: '%s': the decoders disagree "
+                    "(%08lx, %08lx)\n",
+                    runs[run].archive,
+                    (unsigned long)runs[run].crc[gBenchReference],
+                    (unsigned long)runs[run].crc[gBenchFast]);
+            free(runs);
+            return 1;
+        }
+    }
+
+    fp = benchOpenOutput("lzhbench", output);
+    if (fp == NULL)
+    {
+        free(runs);
+        return 1;
+    }
+
+    fprintf(fp, "{\n  \"runs\": [\n");
+
+    for (run = 0; run < numRuns; run++)
+    {
+        for (how = gBenchReference; how <= gBenchFast; how++)
+        {
+            secs[how] = (runs[run].wallMs[how] > 0.0 ?
+                         runs[run].wallMs[how] / 1000.0 : 1e-9);
+        }
+
+        fprintf(fp,
+                "    {\"archive\": \"%s\", \"compressedBytes\": %llu, "
+                "\"bytes\": %llu, \"crc\": \"%08lx\",\n"
+                "     \"referenceMs\": %.1f, \"referenceMBPerSec\": %.1f, "
+                "\"fastMs\": %.1f, \"fastMBPerSec\": %.1f, "
+                "\"speedup\": %.2f}%s\n",
+                runs[run].archive,
+                (unsigned long long)runs[run].compressedBytes,
+                (unsigned long long)runs[run].bytes,
+                (unsigned long)runs[run].crc[gBenchFast],
+                runs[run].wallMs[gBenchReference],
+                (double)runs[run].bytes / secs[gBenchReference] / 1048576.0,
+                runs[run].wallMs[gBenchFast],
+                (double)runs[run].bytes / secs[gBenchFast] / 1048576.0,
+                secs[gBenchReference] / secs[gBenchFast],
+                (run + 1 < numRuns ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    if (benchCloseOutput(fp) != 0)
+    {
+        free(runs);
+        return 1;
+    }
+
+    free(runs);
+
+    return 0;
+}
@@ -0,0 +1,1258 @@
+/*
+    lzxbench.c - benchmark the LZX decoders of the cab reader
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://learn.microsoft.com/en-us/windows/win32/msi/cabinet-files
+    https://learn.microsoft.com/en-us/openspecs/exchange_server_protocols/ms-patch/cc78752a-b4af-4eee-88cb-01f4d8a4c2bf
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    lzxbench reads every entry of each of the given cabinets with
+    libarchive's cab reader, once with the reference LZX decoder
+    ("cab:lzx=reference") and once with the fast one ("cab:lzx=fast"),
+    checks that both give the same data, and reports, as JSON, for
+    each cabinet:
+
+        cabinet, compressedBytes, bytes - the cabinet, its size and
+                       the size of its entries
+        crc          - the CRC-32 of the entries' data
+        referenceMs, fastMs - the median wall time of each decoder
+        referenceMBPerSec, fastMBPerSec - the MB decoded per second
+        speedup      - referenceMs / fastMs
+
+    Each decoder is run repeatedly (-r), after one warm up run that is
+    not counted.  With -m, lzxbench instead writes a cabinet of
+    BENCHFILES files, size MB in all, in one LZX folder with a 2MB
+    window and E8 translation, like a driver package: x86 like code
+    whose CALL instructions go to a few functions, text and some random
+    bytes.  The LZX encoder is a simple greedy one that writes one
+    block per 32KB frame, verbatim and aligned offset in turn; it is
+    only meant to make test data.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* the decoders */
+
+enum
+{
+    gBenchReference = 0,
+    gBenchFast      = 1,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHFILES     16
+#define BENCHCHUNK     64
+#define BENCHFUNCS     64
+#define BENCHBLOCKSIZE 65536
+
+/* LZX with a 2MB window, see lzx_decode_init() in the cab reader */
+
+#define LZXWINBITS     21
+#define LZXWINSIZE     (1 << LZXWINBITS)
+#define LZXFRAME       32768
+#define LZXMAXDATA     (LZXFRAME + 6144)
+#define LZXSLOTS       50
+#define LZXMAINSIZE    (256 + LZXSLOTS * 8)
+#define LZXLENSIZE     249
+#define LZXPRESIZE     20
+#define LZXMINMATCH    3
+#define LZXMAXMATCH    257
+#define LZXHASHBITS    16
+#define LZXCHAIN       16
+#define LZXE8SIZE      12000000
+#define LZXALIGNEDSIZE 8
+#define LZXVERBATIM    1
+#define LZXALIGNED     2
+
+/* cab definitions */
+
+#define CABHEADERLEN   36
+#define CABFOLDERLEN   8
+#define CABFILELEN     16
+#define CABDATALEN     8
+
+/* an LZX bit stream: 16 bit little endian words, high bit first */
+
+typedef struct lzxBits
+{
+    unsigned char *buf;
+    size_t len;
+    uint64_t bits;
+    int count;
+} lzxBits_t;
+
+/* a symbol of a block */
+
+typedef struct lzxSym
+{
+    uint16_t main;
+    int16_t length;
+    uint32_t footer;
+    int footerBits;
+} lzxSym_t;
+
+/* the encoder */
+
+typedef struct lzxEnc
+{
+    const unsigned char *data;
+    int32_t *head;
+    int32_t *prev;
+    int slotBase[LZXSLOTS];
+    int slotBits[LZXSLOTS];
+    unsigned char mainLens[LZXMAINSIZE];
+    unsigned char lengthLens[LZXLENSIZE];
+    uint32_t r0;
+    lzxSym_t syms[LZXFRAME];
+} lzxEnc_t;
+
+/* the result of one cabinet */
+
+typedef struct benchRun
+{
+    const char *cabinet;
+    uint64_t compressedBytes;
+    uint64_t bytes;
+    uLong crc[2];
+    double wallMs[2];
+} benchRun_t;
+
+/* a node of a Huffman tree */
+
+typedef struct lzxNode
+{
+    uint32_t weight;
+    int sym;
+} lzxNode_t;
+
+/* globals */
+
+static const char *gPhrase =
+    "The driver package installs the device and its services. "
+    "Copyright (C) Example Corporation. All rights reserved. "
+    "Windows Driver Foundation - User-mode Driver Framework ";
+
+static const unsigned char gOpcodes[] =
+{
+    0x8B, 0x89, 0x48, 0x83, 0xC3, 0x55, 0x5D, 0x0F,
+    0x85, 0x74, 0xFF, 0x45, 0x24, 0x00, 0x33, 0xC0,
+};
+
+/* private functions */
+
+static void putLE16(unsigned char *buf, uint16_t value);
+static void putLE32(unsigned char *buf, uint32_t value);
+static void benchFill(unsigned char *p, size_t size);
+static void lzxE8Encode(unsigned char *p, size_t size, uint32_t offset);
+static void lzxPutBits(lzxBits_t *bw, uint32_t value, int n);
+static void lzxFlushBits(lzxBits_t *bw);
+static int lzxCompareNodes(const void *a, const void *b);
+static void lzxLengths(const uint32_t *freq,
+                       int num,
+                       int limit,
+                       unsigned char *lens);
+static void lzxCodes(const unsigned char *lens, int num, uint16_t *codes);
+static void lzxPutTree(lzxBits_t *bw,
+                       unsigned char *prev,
+                       const unsigned char *lens,
+                       int start,
+                       int end);
+static int lzxSlot(const lzxEnc_t *enc, uint32_t formatted);
+static size_t lzxMatch(lzxEnc_t *enc,
+                       size_t pos,
+                       size_t end,
+                       uint32_t *dist);
+static void lzxInsert(lzxEnc_t *enc, size_t pos);
+static size_t lzxFrame(lzxEnc_t *enc,
+                       size_t start,
+                       size_t end,
+                       unsigned char *out);
+static int benchMakeCab(const char *path, unsigned long sizeMB);
+static int benchRead(benchRun_t *run, int how);
+static void printUsage(void);
+
+/* putLE16 - store a 16 bit little endian value */
+
+static void putLE16(unsigned char *buf, uint16_t value)
+{
+    buf[0] = (unsigned char)(value & 0xff);
+    buf[1] = (unsigned char)((value >> 8) & 0xff);
+}
+
+/* putLE32 - store a 32 bit little endian value */
+
+static void putLE32(unsigned char *buf, uint32_t value)
+{
+    putLE16(buf, (uint16_t)(value & 0xffff));
+    putLE16(buf + 2, (uint16_t)((value >> 16) & 0xffff));
+}
+
+/*
+    benchFill - fill p with chunks of x86 like code (CALLs to
+                BENCHFUNCS functions among common opcodes), text and
+                random bytes
+*/
+
+static void benchFill(unsigned char *p, size_t size)
+{
+    unsigned char chunk[BENCHCHUNK + 8];
+    uint32_t funcs[BENCHFUNCS];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    size_t phraseLen = strlen(gPhrase);
+    size_t pos = 0;
+    size_t len = 0;
+    size_t i = 0;
+    int r = 0;
+
+    for (i = 0; i < BENCHFUNCS; i++)
+    {
+        funcs[i] = (uint32_t)(benchRand(&state) % (size + 1));
+    }
+
+    while (pos < size)
+    {
+        r = (int)(benchRand(&state) % 100);
+        len = 0;
+
+        if (r < 45)
+        {
+            while (len < BENCHCHUNK)
+            {
+                if (benchRand(&state) % 6 == 0)
+                {
+                    /* CALL rel32 to one of the functions */
+
+                    chunk[len] = 0xE8;
+                    putLE32(chunk + len + 1,
+                            funcs[benchRand(&state) % BENCHFUNCS] -
+                            (uint32_t)(pos + len + 5));
+                    len += 5;
+                }
+                else
+                {
+                    chunk[len++] =
+                        gOpcodes[benchRand(&state) % sizeof(gOpcodes)];
+                }
+            }
+        }
+        else if (r < 85)
+        {
+            i = (size_t)(benchRand(&state) % phraseLen);
+            while (len < BENCHCHUNK)
+            {
+                chunk[len++] = (unsigned char)gPhrase[i];
+                i = (i + 1) % phraseLen;
+            }
+        }
+        else
+        {
+            while (len < BENCHCHUNK)
+            {
+                chunk[len++] = (unsigned char)benchRand(&state);
+            }
+        }
+
+        if (len > size - pos)
+        {
+            len = size - pos;
+        }
+        memcpy(p + pos, chunk, len);
+        pos += len;
+    }
+}
+
+/*
+    lzxE8Encode - the E8 translation of a frame, the inverse of
+                  lzx_translation() in the cab reader
+*/
+
+static void lzxE8Encode(unsigned char *p, size_t size, uint32_t offset)
+{
+    unsigned char *b = p;
+    unsigned char *end = NULL;
+    int64_t cp = 0;
+    int64_t rel = 0;
+    int64_t value = 0;
+
+    if (size <= 10)
+    {
+        return;
+    }
+
+    end = p + size - 10;
+    while (b < end && (b = memchr(b, 0xE8, end - b)) != NULL)
+    {
+        cp = (int64_t)offset + (b - p);
+        rel = (int32_t)((uint32_t)b[1] | (uint32_t)b[2] << 8 |
+                        (uint32_t)b[3] << 16 | (uint32_t)b[4] << 24);
+
+        if (rel >= -cp && rel < LZXE8SIZE - cp)
+        {
+            value = rel + cp;
+        }
+        else if (rel >= LZXE8SIZE - cp && rel < LZXE8SIZE)
+        {
+            value = rel - LZXE8SIZE;
+        }
+        else
+        {
+            value = rel;
+        }
+
+        putLE32(b + 1, (uint32_t)value);
+        b += 5;
+    }
+}
+
+/* lzxPutBits - write the low n bits of value */
+
+static void lzxPutBits(lzxBits_t *bw, uint32_t value, int n)
+{
+    uint32_t word = 0;
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    bw->bits = (bw->bits << n) | (value & ((1U << n) - 1));
+    bw->count += n;
+
+    while (bw->count >= 16)
+    {
+        word = (uint32_t)(bw->bits >> (bw->count - 16)) & 0xffff;
+        putLE16(bw->buf + bw->len, (uint16_t)word);
+        bw->len += 2;
+        bw->count -= 16;
+    }
+}
+
+/* lzxFlushBits - pad the bit stream to a 16 bit boundary */
+
+static void lzxFlushBits(lzxBits_t *bw)
+{
+    if (bw->count > 0)
+    {
+        lzxPutBits(bw, 0, 16 - bw->count);
+    }
+    bw->bits = 0;
+    bw->count = 0;
+}
+
+/* lzxCompareNodes - qsort() comparison function for tree leaves */
+
+static int lzxCompareNodes(const void *a, const void *b)
+{
+    const lzxNode_t *x = a;
+    const lzxNode_t *y = b;
+
+    if (x->weight != y->weight)
+    {
+        return (x->weight < y->weight ? -1 : 1);
+    }
+
+    return x->sym - y->sym;
+}
+
+/*
+    lzxLengths - Huffman code lengths of at most limit bits for freq;
+                 the weights are halved until the tree fits
+*/
+
+static void lzxLengths(const uint32_t *freq,
+                       int num,
+                       int limit,
+                       unsigned char *lens)
+{
+    lzxNode_t leaves[LZXMAINSIZE];
+    uint32_t weight[2 * LZXMAINSIZE];
+    int parent[2 * LZXMAINSIZE];
+    int depth[2 * LZXMAINSIZE];
+    uint32_t scale = 0;
+    int n = 0;
+    int i = 0;
+    int j = 0;
+    int k = 0;
+    int pick = 0;
+    int m = 0;
+    int maxDepth = 0;
+
+    memset(lens, 0, (size_t)num);
+
+    for (i = 0; i < num; i++)
+    {
+        if (freq[i] > 0)
+        {
+            leaves[n].weight = freq[i];
+            leaves[n].sym = i;
+            n++;
+        }
+    }
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    /* a tree needs two leaves */
+
+    if (n == 1)
+    {
+        lens[leaves[0].sym] = 1;
+        lens[leaves[0].sym == 0 ? 1 : 0] = 1;
+        return;
+    }
+
+    for (scale = 0; ; scale++)
+    {
+        for (i = 0; i < n; i++)
+        {
+            leaves[i].weight = (freq[leaves[i].sym] >> scale) | 1;
+        }
+        qsort(leaves, (size_t)n, sizeof(lzxNode_t), lzxCompareNodes);
+
+        /* two queues: the sorted leaves and the new nodes */
+
+        for (i = 0; i < n; i++)
+        {
+            weight[i] = leaves[i].weight;
+        }
+        i = 0;
+        j = n;
+        for (k = n; k < 2 * n - 1; k++)
+        {
+            weight[k] = 0;
+            for (m = 0; m < 2; m++)
+            {
+                if (j < k && (i >= n || weight[j] < weight[i]))
+                {
+                    pick = j++;
+                }
+                else
+                {
+                    pick = i++;
+                }
+                parent[pick] = k;
+                weight[k] += weight[pick];
+            }
+        }
+
+        depth[2 * n - 2] = 0;
+        maxDepth = 0;
+        for (k = 2 * n - 3; k >= 0; k--)
+        {
+            depth[k] = depth[parent[k]] + 1;
+            if (k < n && depth[k] > maxDepth)
+            {
+                maxDepth = depth[k];
+            }
+        }
+
+        if (maxDepth <= limit)
+        {
+            break;
+        }
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        lens[leaves[i].sym] = (unsigned char)depth[i];
+    }
+}
+
+/*
+    lzxCodes - canonical codes for lens, in the order that
+               lzx_make_huffman_table() assigns them
+*/
+
+static void lzxCodes(const unsigned char *lens, int num, uint16_t *codes)
+{
+    int count[17];
+    int next[17];
+    int code = 0;
+    int len = 0;
+    int i = 0;
+
+    memset(count, 0, sizeof(count));
+    for (i = 0; i < num; i++)
+    {
+        count[lens[i]]++;
+    }
+    count[0] = 0;
+
+    for (len = 1; len <= 16; len++)
+    {
+        code = (code + count[len - 1]) << 1;
+        next[len] = code;
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        codes[i] = (lens[i] > 0 ? (uint16_t)next[lens[i]]++ : 0);
+    }
+}
+
+/*
+    lzxPutTree - write a pre-tree and the lengths from start to end
+                 as differences from the previous block's lengths
+*/
+
+static void lzxPutTree(lzxBits_t *bw,
+                       unsigned char *prev,
+                       const unsigned char *lens,
+                       int start,
+                       int end)
+{
+    uint32_t freq[LZXPRESIZE];
+    unsigned char preLens[LZXPRESIZE];
+    uint16_t preCodes[LZXPRESIZE];
+    int delta = 0;
+    int i = 0;
+
+    memset(freq, 0, sizeof(freq));
+    for (i = start; i < end; i++)
+    {
+        freq[(prev[i] - lens[i] + 17) % 17]++;
+    }
+
+    lzxLengths(freq, LZXPRESIZE, 10, preLens);
+    lzxCodes(preLens, LZXPRESIZE, preCodes);
+
+    for (i = 0; i < LZXPRESIZE; i++)
+    {
+        lzxPutBits(bw, preLens[i], 4);
+    }
+
+    for (i = start; i < end; i++)
+    {
+        delta = (prev[i] - lens[i] + 17) % 17;
+        lzxPutBits(bw, preCodes[delta], preLens[delta]);
+        prev[i] = lens[i];
+    }
+}
+
+/* lzxSlot - the position slot of a formatted offset */
+
+static int lzxSlot(const lzxEnc_t *enc, uint32_t formatted)
+{
+    int lo = 3;
+    int hi = LZXSLOTS - 1;
+    int mid = 0;
+
+    while (lo < hi)
+    {
+        mid = (lo + hi + 1) / 2;
+        if ((uint32_t)enc->slotBase[mid] <= formatted)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+
+    return lo;
+}
+
+/*
+    lzxMatch - the longest match for pos, up to end, in the last
+               LZXCHAIN positions with the same hash
+*/
+
+static size_t lzxMatch(lzxEnc_t *enc,
+                       size_t pos,
+                       size_t end,
+                       uint32_t *dist)
+{
+    const unsigned char *data = enc->data;
+    size_t best = 0;
+    size_t maxLen = end - pos;
+    size_t len = 0;
+    int32_t cand = 0;
+    uint32_t h = 0;
+    int chain = 0;
+
+    if (maxLen > LZXMAXMATCH)
+    {
+        maxLen = LZXMAXMATCH;
+    }
+    if (maxLen < LZXMINMATCH)
+    {
+        return 0;
+    }
+
+    /* prefer the last offset, which costs no footer bits */
+
+    if (enc->r0 <= pos)
+    {
+        for (len = 0;
+             len < maxLen && data[pos + len] == data[pos - enc->r0 + len];
+             len++)
+        {
+        }
+        if (len >= LZXMINMATCH)
+        {
+            best = len;
+            *dist = enc->r0;
+        }
+    }
+
+    h = ((uint32_t)data[pos] << 16 | (uint32_t)data[pos + 1] << 8 |
+         data[pos + 2]) * 2654435761U >> (32 - LZXHASHBITS);
+
+    for (cand = enc->head[h];
+         cand >= 0 && chain < LZXCHAIN &&
+         pos - (size_t)cand <= LZXWINSIZE - 3;
+         cand = enc->prev[cand & (LZXWINSIZE - 1)], chain++)
+    {
+        if (data[cand + best] != data[pos + best])
+        {
+            continue;
+        }
+        for (len = 0; len < maxLen && data[cand + len] == data[pos + len];
+             len++)
+        {
+        }
+        if (len > best + 1)
+        {
+            best = len;
+            *dist = (uint32_t)(pos - (size_t)cand);
+            if (best == maxLen)
+            {
+                break;
+            }
+        }
+    }
+
+    return (best >= LZXMINMATCH ? best : 0);
+}
+
+/* lzxInsert - add pos to the hash chains */
+
+static void lzxInsert(lzxEnc_t *enc, size_t pos)
+{
+    const unsigned char *data = enc->data;
+    uint32_t h = 0;
+
+    h = ((uint32_t)data[pos] << 16 | (uint32_t)data[pos + 1] << 8 |
+         data[pos + 2]) * 2654435761U >> (32 - LZXHASHBITS);
+    enc->prev[pos & (LZXWINSIZE - 1)] = enc->head[h];
+    enc->head[h] = (int32_t)pos;
+}
+
+/*
+    lzxFrame - compress the frame from start to end as one block,
+               verbatim or, for every other frame, aligned offset;
+               returns the size of the compressed frame
+*/
+
+static size_t lzxFrame(lzxEnc_t *enc,
+                       size_t start,
+                       size_t end,
+                       unsigned char *out)
+{
+    uint32_t mainFreq[LZXMAINSIZE];
+    uint32_t lengthFreq[LZXLENSIZE];
+    uint32_t alignedFreq[LZXALIGNEDSIZE];
+    unsigned char mainLens[LZXMAINSIZE];
+    unsigned char lengthLens[LZXLENSIZE];
+    unsigned char alignedLens[LZXALIGNEDSIZE];
+    uint16_t mainCodes[LZXMAINSIZE];
+    uint16_t lengthCodes[LZXLENSIZE];
+    uint16_t alignedCodes[LZXALIGNEDSIZE];
+    lzxBits_t bw;
+    int aligned = ((start / LZXFRAME) % 2 == 1);
+    lzxSym_t *sym = NULL;
+    size_t numSyms = 0;
+    size_t pos = start;
+    size_t len = 0;
+    size_t i = 0;
+    uint32_t dist = 0;
+    int slot = 0;
+
+    memset(mainFreq, 0, sizeof(mainFreq));
+    memset(lengthFreq, 0, sizeof(lengthFreq));
+    memset(alignedFreq, 0, sizeof(alignedFreq));
+
+    while (pos < end)
+    {
+        sym = &enc->syms[numSyms++];
+        len = (pos + LZXMINMATCH <= end ? lzxMatch(enc, pos, end, &dist) : 0);
+
+        if (len == 0)
+        {
+            sym->main = enc->data[pos];
+            sym->length = -1;
+            sym->footerBits = 0;
+            if (pos + LZXMINMATCH <= end)
+            {
+                lzxInsert(enc, pos);
+            }
+            pos++;
+        }
+        else
+        {
+            if (dist == enc->r0)
+            {
+                slot = 0;
+                sym->footer = 0;
+                sym->footerBits = 0;
+            }
+            else
+            {
+                slot = lzxSlot(enc, dist + 2);
+                sym->footer = dist + 2 - (uint32_t)enc->slotBase[slot];
+                sym->footerBits = enc->slotBits[slot];
+                if (sym->footerBits >= 3)
+                {
+                    alignedFreq[sym->footer & 7]++;
+                }
+                enc->r0 = dist;
+            }
+
+            sym->main = (uint16_t)(256 + slot * 8 +
+                                   (len - 2 < 7 ? len - 2 : 7));
+            sym->length = (len - 2 >= 7 ? (int16_t)(len - 9) : -1);
+            if (sym->length >= 0)
+            {
+                lengthFreq[sym->length]++;
+            }
+
+            for (i = 0; i < len; i++)
+            {
+                if (pos + i + LZXMINMATCH <= end)
+                {
+                    lzxInsert(enc, pos + i);
+                }
+            }
+            pos += len;
+        }
+        mainFreq[sym->main]++;
+    }
+
+    lzxLengths(mainFreq, LZXMAINSIZE, 16, mainLens);
+    lzxLengths(lengthFreq, LZXLENSIZE, 16, lengthLens);
+    lzxCodes(mainLens, LZXMAINSIZE, mainCodes);
+    lzxCodes(lengthLens, LZXLENSIZE, lengthCodes);
+    lzxLengths(alignedFreq, LZXALIGNEDSIZE, 7, alignedLens);
+    lzxCodes(alignedLens, LZXALIGNEDSIZE, alignedCodes);
+
+    memset(&bw, 0, sizeof(bw));
+    bw.buf = out;
+
+    /* the first frame of the folder turns on E8 translation */
+
+    if (start == 0)
+    {
+        lzxPutBits(&bw, 1, 1);
+        lzxPutBits(&bw, LZXE8SIZE >> 16, 16);
+        lzxPutBits(&bw, LZXE8SIZE & 0xffff, 16);
+    }
+
+    lzxPutBits(&bw, aligned ? LZXALIGNED : LZXVERBATIM, 3);
+    lzxPutBits(&bw, (uint32_t)((end - start) >> 16), 8);
+    lzxPutBits(&bw, (uint32_t)((end - start) & 0xffff), 16);
+
+    if (aligned)
+    {
+        for (i = 0; i < LZXALIGNEDSIZE; i++)
+        {
+            lzxPutBits(&bw, alignedLens[i], 3);
+        }
+    }
+
+    lzxPutTree(&bw, enc->mainLens, mainLens, 0, 256);
+    lzxPutTree(&bw, enc->mainLens, mainLens, 256, LZXMAINSIZE);
+    lzxPutTree(&bw, enc->lengthLens, lengthLens, 0, LZXLENSIZE);
+
+    for (i = 0; i < numSyms; i++)
+    {
+        sym = &enc->syms[i];
+        lzxPutBits(&bw, mainCodes[sym->main], mainLens[sym->main]);
+        if (sym->length >= 0)
+        {
+            lzxPutBits(&bw,
+                       lengthCodes[sym->length],
+                       lengthLens[sym->length]);
+        }
+        if (aligned && sym->footerBits >= 3)
+        {
+            /* the low 3 bits of the footer are an aligned symbol */
+
+            lzxPutBits(&bw, sym->footer >> 3, sym->footerBits - 3);
+            lzxPutBits(&bw,
+                       alignedCodes[sym->footer & 7],
+                       alignedLens[sym->footer & 7]);
+        }
+        else
+        {
+            lzxPutBits(&bw, sym->footer, sym->footerBits);
+        }
+    }
+
+    lzxFlushBits(&bw);
+
+    return bw.len;
+}
+
+/*
+    benchMakeCab - write a cabinet of BENCHFILES files, sizeMB in
+                   all, in one LZX folder
+*/
+
+static int benchMakeCab(const char *path, unsigned long sizeMB)
+{
+    unsigned char hdr[CABHEADERLEN];
+    unsigned char rec[CABFILELEN];
+    unsigned char out[2 * LZXMAXDATA];
+    char name[64];
+    lzxEnc_t *enc = NULL;
+    unsigned char *data = NULL;
+    FILE *fp = NULL;
+    size_t size = (size_t)sizeMB * 1024 * 1024;
+    size_t fileSize = size / BENCHFILES;
+    size_t numFrames = (size + LZXFRAME - 1) / LZXFRAME;
+    size_t start = 0;
+    size_t end = 0;
+    size_t len = 0;
+    long total = 0;
+    int base = 0;
+    int footer = 0;
+    int slot = 0;
+    int n = 0;
+    int i = 0;
+    int ret = gBenchErr;
+
+    if (size == 0 || numFrames > 65535)
+    {
+        fprintf(stderr, "lzxbench: ERROR: a folder holds 1MB to 2GB\n");
+        return gBenchErr;
+    }
+
+    enc = calloc(1, sizeof(lzxEnc_t));
+    data = malloc(size);
+    if (enc == NULL || data == NULL)
+    {
+        goto done;
+    }
+    enc->head = malloc(sizeof(int32_t) << LZXHASHBITS);
+    enc->prev = malloc(sizeof(int32_t) * LZXWINSIZE);
+    if (enc->head == NULL || enc->prev == NULL)
+    {
+        goto done;
+    }
+    memset(enc->head, 0xff, sizeof(int32_t) << LZXHASHBITS);
+    enc->data = data;
+    enc->r0 = 1;
+
+    /* the position slots, as lzx_decode_init() makes them */
+
+    for (slot = 0; slot < LZXSLOTS; slot++)
+    {
+        if (footer == 0)
+        {
+            base = slot;
+        }
+        else
+        {
+            base += 1 << footer;
+        }
+        if (footer < 17)
+        {
+            footer = -2;
+            for (n = base; n; n >>= 1)
+            {
+                footer++;
+            }
+            if (footer <= 0)
+            {
+                footer = 0;
+            }
+        }
+        enc->slotBase[slot] = base;
+        enc->slotBits[slot] = footer;
+    }
+
+    benchFill(data, size);
+
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        fprintf(stderr,
+                "lzxbench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    /* CFHEADER; cbCabinet is filled in at the end */
+
+    memset(hdr, 0, sizeof(hdr));
+    memcpy(hdr, "MSCF", 4);
+    putLE32(hdr + 16, CABHEADERLEN + CABFOLDERLEN);
+    hdr[24] = 3;
+    hdr[25] = 1;
+    putLE16(hdr + 26, 1);
+    putLE16(hdr + 28, BENCHFILES);
+
+    /* CFFOLDER, LZX with a 2MB window */
+
+    memset(rec, 0, sizeof(rec));
+    len = 0;
+    for (i = 0; i < BENCHFILES; i++)
+    {
+        len += CABFILELEN + (size_t)snprintf(name,
+                                             sizeof(name),
+                                             "driver\\file%02d.sys",
+                                             i) + 1;
+    }
+    putLE32(rec, (uint32_t)(CABHEADERLEN + CABFOLDERLEN + len));
+    putLE16(rec + 4, (uint16_t)numFrames);
+    putLE16(rec + 6, (uint16_t)(LZXWINBITS << 8 | 3));
+
+    if (fwrite(hdr, 1, CABHEADERLEN, fp) != CABHEADERLEN ||
+        fwrite(rec, 1, CABFOLDERLEN, fp) != CABFOLDERLEN)
+    {
+        goto done;
+    }
+
+    /* CFFILEs; the last file gets the rest of the data */
+
+    for (i = 0; i < BENCHFILES; i++)
+    {
+        len = snprintf(name, sizeof(name), "driver\\file%02d.sys", i);
+        putLE32(rec, (uint32_t)(i + 1 < BENCHFILES ?
+                                fileSize :
+                                size - fileSize * (BENCHFILES - 1)));
+        putLE32(rec + 4, (uint32_t)(fileSize * i));
+        putLE16(rec + 8, 0);
+        putLE16(rec + 10, (uint16_t)((2023 - 1980) << 9 | 11 << 5 | 14));
+        putLE16(rec + 12, (uint16_t)(22 << 11 | 13 << 5 | 10));
+        putLE16(rec + 14, 0x20);
+        if (fwrite(rec, 1, CABFILELEN, fp) != CABFILELEN ||
+            fwrite(name, 1, len + 1, fp) != len + 1)
+        {
+            goto done;
+        }
+    }
+
+    /* CFDATA blocks, one frame each, without checksums */
+
+    for (start = 0; start < size; start = end)
+    {
+        end = (start + LZXFRAME < size ? start + LZXFRAME : size);
+        lzxE8Encode(data + start, end - start, (uint32_t)start);
+        len = lzxFrame(enc, start, end, out + CABDATALEN);
+        if (len > LZXMAXDATA)
+        {
+            fprintf(stderr, "lzxbench: ERROR: frame is too large\n");
+            goto done;
+        }
+        putLE32(out, 0);
+        putLE16(out + 4, (uint16_t)len);
+        putLE16(out + 6, (uint16_t)(end - start));
+        if (fwrite(out, 1, CABDATALEN + len, fp) != CABDATALEN + len)
+        {
+            goto done;
+        }
+    }
+
+    total = ftell(fp);
+    putLE32(hdr + 8, (uint32_t)total);
+    if (total < 0 || fseek(fp, 0, SEEK_SET) != 0 ||
+        fwrite(hdr, 1, CABHEADERLEN, fp) != CABHEADERLEN)
+    {
+        goto done;
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (fp != NULL && fclose(fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    if (ret != gBenchOkay)
+    {
+        fprintf(stderr, "lzxbench: ERROR: cannot write '%s'\n", path);
+    }
+    if (enc != NULL)
+    {
+        free(enc->head);
+        free(enc->prev);
+        free(enc);
+    }
+    free(data);
+
+    return ret;
+}
+
+/* benchRead - read every entry in run->cabinet with one decoder */
+
+static int benchRead(benchRun_t *run, int how)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    const void *buf = NULL;
+    size_t size = 0;
+    la_int64_t offset = 0;
+    int r = ARCHIVE_OK;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return gBenchErr;
+    }
+
+    archive_read_support_format_cab(a);
+    if (archive_read_set_options(a,
+                                 how == gBenchFast ?
+                                 "cab:lzx=fast" :
+                                 "cab:lzx=reference") != ARCHIVE_OK ||
+        archive_read_open_filename(a, run->cabinet, BENCHBLOCKSIZE) !=
+        ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "lzxbench: ERROR: cannot open '%s': %s\n",
+                run->cabinet,
+                archive_error_string(a));
+        archive_read_free(a);
+        return gBenchErr;
+    }
+
+    run->bytes = 0;
+    run->crc[how] = crc32(0L, Z_NULL, 0);
+
+    while ((r = archive_read_next_header(a, &entry)) == ARCHIVE_OK)
+    {
+        while ((r = archive_read_data_block(a, &buf, &size, &offset)) ==
+               ARCHIVE_OK)
+        {
+            run->crc[how] = crc32(run->crc[how], buf, (uInt)size);
+            run->bytes += size;
+        }
+        if (r != ARCHIVE_EOF)
+        {
+            break;
+        }
+    }
+
+    if (r != ARCHIVE_EOF)
+    {
+        fprintf(stderr,
+                "lzxbench: ERROR: cannot read '%s': %s\n",
+                run->cabinet,
+                archive_error_string(a));
+        archive_read_free(a);
+        return gBenchErr;
+    }
+
+    archive_read_free(a);
+
+    return gBenchOkay;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: lzxbench [-r repetitions] [-o output.json] cabinet ...\n"
+            "       lzxbench -m size MB cabinet\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t *runs = NULL;
+    const char *output = NULL;
+    double times[BENCHMAXREPS];
+    double secs[2];
+    struct stat sb;
+    uint64_t start = 0;
+    unsigned long makeMB = 0;
+    FILE *fp = stdout;
+    int numRuns = 0;
+    int numReps = 3;
+    int run = 0;
+    int how = 0;
+    int r = 0;
+    int i = 1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeMB = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeMB > 0)
+    {
+        if (i + 1 != argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeCab(argv[i], makeMB) == gBenchOkay ? 0 : 1);
+    }
+
+    if (i >= argc || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    numRuns = argc - i;
+    runs = calloc((size_t)numRuns, sizeof(benchRun_t));
+    if (runs == NULL)
+    {
+        return 1;
+    }
+
+    /* the first repetition of each decoder is a warm up */
+
+    for (run = 0; run < numRuns; run++)
+    {
+        runs[run].cabinet = argv[i + run];
+        if (stat(runs[run].cabinet, &sb) == 0)
+        {
+            runs[run].compressedBytes = (uint64_t)sb.st_size;
+        }
+
+        for (how = gBenchReference; how <= gBenchFast; how++)
+        {
+            for (r = -1; r < numReps; r++)
+            {
+                start = benchNow();
+                if (benchRead(&runs[run], how) != gBenchOkay)
+                {
+                    free(runs);
+                    return 1;
+                }
+                if (r >= 0)
+                {
+                    times[r] = (double)(benchNow() - start) / 1000000.0;
+                }
+            }
+
+            runs[run].wallMs[how] = benchMedian(times, numReps);
+        }
+
+        if (runs[run].crc[gBenchReference] != runs[run].crc[gBenchFast])
+        {
+            fprintf(stderr,
+                    "lzxbench: ERROR: '%s': the decoders disagree "
+                    "(%08lx, %08lx)\n",
+                    runs[run].cabinet,
+                    (unsigned long)runs[run].crc[gBenchReference],
+                    (unsigned long)runs[run].crc[gBenchFast]);
+            free(runs);
+            return 1;
+        }
+    }
+
+    fp = benchOpenOutput("lzxbench", output);
+    if (fp == NULL)
+    {
+        free(runs);
+        return 1;
+    }
+
+    fprintf(fp, "{\n  \"runs\": [\n");
+
+    for (run = 0; run < numRuns; run++)
+    {
+        for (how = gBenchReference; how <= gBenchFast; how++)
+        {
+            secs[how] = (runs[run].wallMs[how] > 0.0 ?
+                         runs[run].wallMs[how] / 1000.0 : 1e-9);
+        }
+
+        fprintf(fp,
+                "    {\"cabinet\": \"%s\", \"compressedBytes\": %llu, "
+                "\"bytes\": %llu, \"crc\": \"%08lx\",\n"
+                "     \"referenceMs\": %.1f, \"referenceMBPerSec\": %.1f, "
+                "\"fastMs\": %.1f, \"fastMBPerSec\": %.1f, "
+                "\"speedup\": %.2f}%s\n",
+                runs[run].cabinet,
+                (unsigned long long)runs[run].compressedBytes,
+                (unsigned long long)runs[run].bytes,
+                (unsigned long)runs[run].crc[gBenchFast],
+                runs[run].wallMs[gBenchReference],
+                (double)runs[run].bytes / secs[gBenchReference] / 1048576.0,
+                runs[run].wallMs[gBenchFast],
+                (double)runs[run].bytes / secs[gBenchFast] / 1048576.0,
+                secs[gBenchReference] / secs[gBenchFast],
+                (run + 1 < numRuns ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    benchCloseOutput(fp);
+
+    free(runs);
+
+    return 0;
+}
@@ -0,0 +1,1496 @@
+/*
+    mkcorpus.c - generate reproducible archives for the benchmarks
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://www.gnu.org/software/tar/manual/html_node/Standard.html
+    https://learn.microsoft.com/en-us/windows/win32/msi/cabinet-files
+    https://github.com/jca02266/lha/blob/master/header.doc.md
+    https://files.stairways.com/other/binhex-40-specs-info.txt
+    http://fileformats.archiveteam.org/wiki/StuffIt
+    https://rpm-software-management.github.io/rpm/manual/format.html
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    mkcorpus writes an archive whose entries are a pure function of
+    the command line (entry count, name length, entry size,
+    compressibility and seed), so that the same command always
+    produces the same bytes.  It writes the formats that bsdtar
+    cannot stream from a tar (GNU ar with long names, cab, lha, sit,
+    hqx and the rpm wrapper) directly, and a tar that mkcorpus.sh
+    converts to the other formats with bsdtar.
+
+    Entries are regular files grouped into directories of
+    entriesPerDir files each.  Each entry's content is built from
+    64 byte chunks that are either a fixed English phrase (with the
+    given percent probability) or random bytes, which gives a
+    compression ratio that tracks the compressibility setting.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+/* return codes */
+
+enum
+{
+    gCorpusErr  = -1,
+    gCorpusOkay =  0,
+};
+
+/* defines */
+
+#define CORPUSCHUNK        64
+#define CORPUSBUFSIZE      65536
+#define CORPUSNAMEMAX      1024
+#define CORPUSMTIME        1700000000UL
+#define CORPUSMACEPOCH     2082844800UL
+#define TARBLOCK           512
+#define ARHDRLEN           60
+#define ARNAMEMAX          15
+#define CABDATAMAX         32768
+#define CABFOLDERMAX       0x40000000UL
+#define CABFILESMAX        65535
+#define CABNAMEMAX         255
+#define LHANAMEMAX         230
+#define SITNAMEMAX         63
+#define HQXNAMEMAX         63
+#define HQXLINELEN         64
+#define RPMLEADSIZE        96
+
+/* corpus specification */
+
+typedef struct corpusSpec
+{
+    unsigned long numEntries;
+    unsigned long nameLen;
+    unsigned long entrySize;
+    unsigned long compressibility;
+    unsigned long entriesPerDir;
+    uint64_t seed;
+    const char *payload;
+} corpusSpec_t;
+
+/* binhex output state */
+
+typedef struct hqxWriter
+{
+    FILE *fp;
+    uint16_t crc;
+    int lastByte;
+    int runLen;
+    unsigned char triple[3];
+    int tripleLen;
+    int lineLen;
+} hqxWriter_t;
+
+/* globals */
+
+static const char *gPhrase =
+    "The quick brown fox jumps over the lazy dog while the archive "
+    "lists its entries in order. ";
+
+static const char *gHqxChars =
+    "!\"#$%&'()*+,-012345689@ABCDEFGHIJKLMNPQRSTUVXYZ[`abcdefhijklmpqr";
+
+static const char *gNameChars =
+    "abcdefghijklmnopqrstuvwxyz0123456789";
+
+/* private functions */
+
+static uint64_t corpusRand(uint64_t *state);
+static uint64_t corpusEntrySeed(const corpusSpec_t *spec, unsigned long i);
+static unsigned long corpusEntrySize(const corpusSpec_t *spec,
+                                     unsigned long i);
+static void corpusEntryDir(const corpusSpec_t *spec,
+                           unsigned long i,
+                           char *buf,
+                           size_t bufLen);
+static void corpusEntryName(const corpusSpec_t *spec,
+                            unsigned long i,
+                            unsigned long maxLen,
+                            char *buf,
+                            size_t bufLen);
+static void corpusEntryFill(const corpusSpec_t *spec,
+                            unsigned long i,
+                            unsigned long offset,
+                            unsigned char *buf,
+                            size_t len);
+static int corpusWriteEntryData(const corpusSpec_t *spec,
+                                unsigned long i,
+                                FILE *fp);
+static uint16_t crc16Arc(uint16_t crc, const unsigned char *buf, size_t len);
+static uint16_t crc16Xmodem(uint16_t crc,
+                            const unsigned char *buf,
+                            size_t len);
+static uint16_t corpusEntryCRC16(const corpusSpec_t *spec, unsigned long i);
+static void putLE16(unsigned char *buf, uint16_t value);
+static void putLE32(unsigned char *buf, uint32_t value);
+static void putBE16(unsigned char *buf, uint16_t value);
+static void putBE32(unsigned char *buf, uint32_t value);
+static int writePad(FILE *fp, size_t len);
+static int writeTarHeader(FILE *fp,
+                          const char *name,
+                          unsigned long size,
+                          char type);
+static int writeTar(const corpusSpec_t *spec, FILE *fp);
+static int writeArHeader(FILE *fp, const char *name, unsigned long size);
+static int writeAr(const corpusSpec_t *spec, FILE *fp);
+static int writeCab(const corpusSpec_t *spec, FILE *fp);
+static int writeLha(const corpusSpec_t *spec, FILE *fp);
+static int writeSitEntryHeader(FILE *fp,
+                               int compType,
+                               const char *name,
+                               unsigned long dataLen,
+                               uint16_t dataCRC);
+static int writeSit(const corpusSpec_t *spec, FILE *fp);
+static void hqxPutChar(hqxWriter_t *w, int c);
+static void hqxPutRaw(hqxWriter_t *w, int c);
+static void hqxFlushRun(hqxWriter_t *w);
+static void hqxPut(hqxWriter_t *w, const unsigned char *buf, size_t len);
+static void hqxPutCRC(hqxWriter_t *w);
+static void hqxFlush(hqxWriter_t *w);
+static int writeHqx(const corpusSpec_t *spec, FILE *fp);
+static int writeRpm(const corpusSpec_t *spec, FILE *fp);
+static void printUsage(void);
+
+/* corpusRand - splitmix64 */
+
+static uint64_t corpusRand(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* corpusEntrySeed - get the seed for the ith entry */
+
+static uint64_t corpusEntrySeed(const corpusSpec_t *spec, unsigned long i)
+{
+    uint64_t state = spec->seed ^ ((uint64_t)i * 0xD6E8FEB86659FD93ULL);
+
+    return corpusRand(&state);
+}
+
+/*
+    corpusEntrySize - get the size of the ith entry, which varies
+                      between 1/2 and 3/2 of the requested size
+*/
+
+static unsigned long corpusEntrySize(const corpusSpec_t *spec,
+                                     unsigned long i)
+{
+    uint64_t state = corpusEntrySeed(spec, i);
+
+    if (spec->entrySize < 2)
+    {
+        return spec->entrySize;
+    }
+
+    return spec->entrySize / 2 +
+           (unsigned long)(corpusRand(&state) % (spec->entrySize + 1));
+}
+
+/* corpusEntryDir - get the name of the directory of the ith entry */
+
+static void corpusEntryDir(const corpusSpec_t *spec,
+                           unsigned long i,
+                           char *buf,
+                           size_t bufLen)
+{
+    snprintf(buf, bufLen, "d%05lu", i / spec->entriesPerDir);
+}
+
+/*
+    corpusEntryName - get the base name of the ith entry, which is
+                      nameLen characters long (but at least long
+                      enough to be unique, and at most maxLen)
+*/
+
+static void corpusEntryName(const corpusSpec_t *spec,
+                            unsigned long i,
+                            unsigned long maxLen,
+                            char *buf,
+                            size_t bufLen)
+{
+    uint64_t state = corpusEntrySeed(spec, i) ^ 0x6E616D65ULL;
+    unsigned long len = 0;
+    unsigned long want = spec->nameLen;
+    int n = 0;
+
+    if (want > maxLen)
+    {
+        want = maxLen;
+    }
+    if (want >= bufLen)
+    {
+        want = bufLen - 1;
+    }
+
+    n = snprintf(buf, bufLen, "f%07lu", i);
+    len = (n > 0 ? (unsigned long)n : 0);
+
+    if (len < want)
+    {
+        buf[len++] = '_';
+    }
+
+    while (len < want)
+    {
+        buf[len++] = gNameChars[corpusRand(&state) % strlen(gNameChars)];
+    }
+
+    buf[len] = '\0';
+}
+
+/*
+    corpusEntryFill - fill buf with len bytes of the ith entry's
+                      content, starting at offset
+*/
+
+static void corpusEntryFill(const corpusSpec_t *spec,
+                            unsigned long i,
+                            unsigned long offset,
+                            unsigned char *buf,
+                            size_t len)
+{
+    unsigned char chunkBuf[CORPUSCHUNK];
+    uint64_t entrySeed = corpusEntrySeed(spec, i);
+    uint64_t state = 0;
+    uint64_t r = 0;
+    unsigned long chunk = 0;
+    unsigned long pos = 0;
+    size_t phraseLen = strlen(gPhrase);
+    size_t j = 0;
+    size_t k = 0;
+    size_t n = 0;
+
+    while (j < len)
+    {
+        chunk = (offset + j) / CORPUSCHUNK;
+        pos = (offset + j) % CORPUSCHUNK;
+
+        /* each chunk depends only on the entry and its index */
+
+        state = entrySeed ^ ((uint64_t)chunk * 0xA0761D6478BD642FULL);
+        if ((corpusRand(&state) % 100) < spec->compressibility)
+        {
+            for (k = 0; k < CORPUSCHUNK; k++)
+            {
+                chunkBuf[k] = (unsigned char)
+                    gPhrase[(chunk * CORPUSCHUNK + k) % phraseLen];
+            }
+        }
+        else
+        {
+            for (k = 0; k < CORPUSCHUNK; k++)
+            {
+                if ((k & 7) == 0)
+                {
+                    r = corpusRand(&state);
+                }
+                chunkBuf[k] = (unsigned char)(r & 0xff);
+                r >>= 8;
+            }
+
+            /*
+                bsdtar's xar writer copies the first line of an entry
+                starting with "#!" into the TOC as its interpreter,
+                which is not valid XML for random bytes
+            */
+
+            if (chunk == 0 && chunkBuf[0] == '#')
+            {
+                chunkBuf[0] = '_';
+            }
+        }
+
+        n = CORPUSCHUNK - pos;
+        if (n > len - j)
+        {
+            n = len - j;
+        }
+        memcpy(buf + j, chunkBuf + pos, n);
+        j += n;
+    }
+}
+
+/* corpusWriteEntryData - write the ith entry's content */
+
+static int corpusWriteEntryData(const corpusSpec_t *spec,
+                                unsigned long i,
+                                FILE *fp)
+{
+    static unsigned char buf[CORPUSBUFSIZE];
+    unsigned long size = corpusEntrySize(spec, i);
+    unsigned long offset = 0;
+    size_t len = 0;
+
+    while (offset < size)
+    {
+        len = size - offset;
+        if (len > sizeof(buf))
+        {
+            len = sizeof(buf);
+        }
+
+        corpusEntryFill(spec, i, offset, buf, len);
+        if (fwrite(buf, 1, len, fp) != len)
+        {
+            return gCorpusErr;
+        }
+        offset += len;
+    }
+
+    return gCorpusOkay;
+}
+
+/* crc16Arc - CRC-16/ARC, as used by lha and stuffit */
+
+static uint16_t crc16Arc(uint16_t crc, const unsigned char *buf, size_t len)
+{
+    size_t i = 0;
+    int bit = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        crc ^= buf[i];
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0xA001) :
+                              (uint16_t)(crc >> 1);
+        }
+    }
+
+    return crc;
+}
+
+/* crc16Xmodem - CRC-16/XMODEM, as used by binhex */
+
+static uint16_t crc16Xmodem(uint16_t crc,
+                            const unsigned char *buf,
+                            size_t len)
+{
+    size_t i = 0;
+    int bit = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)(buf[i] << 8);
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) :
+                                   (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/* corpusEntryCRC16 - get the CRC-16/ARC of the ith entry's content */
+
+static uint16_t corpusEntryCRC16(const corpusSpec_t *spec, unsigned long i)
+{
+    static unsigned char buf[CORPUSBUFSIZE];
+    unsigned long size = corpusEntrySize(spec, i);
+    unsigned long offset = 0;
+    uint16_t crc = 0;
+    size_t len = 0;
+
+    while (offset < size)
+    {
+        len = size - offset;
+        if (len > sizeof(buf))
+        {
+            len = sizeof(buf);
+        }
+
+        corpusEntryFill(spec, i, offset, buf, len);
+        crc = crc16Arc(crc, buf, len);
+        offset += len;
+    }
+
+    return crc;
+}
+
+/* byte order helpers */
+
+static void putLE16(unsigned char *buf, uint16_t value)
+{
+    buf[0] = (unsigned char)(value & 0xff);
+    buf[1] = (unsigned char)((value >> 8) & 0xff);
+}
+
+static void putLE32(unsigned char *buf, uint32_t value)
+{
+    putLE16(buf, (uint16_t)(value & 0xffff));
+    putLE16(buf + 2, (uint16_t)((value >> 16) & 0xffff));
+}
+
+static void putBE16(unsigned char *buf, uint16_t value)
+{
+    buf[0] = (unsigned char)((value >> 8) & 0xff);
+    buf[1] = (unsigned char)(value & 0xff);
+}
+
+static void putBE32(unsigned char *buf, uint32_t value)
+{
+    putBE16(buf, (uint16_t)((value >> 16) & 0xffff));
+    putBE16(buf + 2, (uint16_t)(value & 0xffff));
+}
+
+/* writePad - write len zero bytes */
+
+static int writePad(FILE *fp, size_t len)
+{
+    static const unsigned char zeros[TARBLOCK];
+    size_t n = 0;
+
+    while (len > 0)
+    {
+        n = (len > sizeof(zeros) ? sizeof(zeros) : len);
+        if (fwrite(zeros, 1, n, fp) != n)
+        {
+            return gCorpusErr;
+        }
+        len -= n;
+    }
+
+    return gCorpusOkay;
+}
+
+/*
+    writeTarHeader - write a ustar header, preceded by a pax extended
+                     header if the name does not fit
+*/
+
+static int writeTarHeader(FILE *fp,
+                          const char *name,
+                          unsigned long size,
+                          char type)
+{
+    unsigned char hdr[TARBLOCK];
+    char pax[CORPUSNAMEMAX + 32];
+    size_t nameLen = strlen(name);
+    size_t paxLen = 0;
+    size_t recLen = 0;
+    unsigned int sum = 0;
+    size_t i = 0;
+
+    if (nameLen >= 100)
+    {
+        /* a pax record's length includes its own digits */
+
+        recLen = nameLen + strlen(" path=\n");
+        for (i = 1; ; i++)
+        {
+            snprintf(pax, sizeof(pax), "%zu", recLen + i);
+            if (strlen(pax) == i)
+            {
+                break;
+            }
+        }
+        paxLen = (size_t)snprintf(pax, sizeof(pax),
+                                  "%zu path=%s\n", recLen + i, name);
+
+        if (writeTarHeader(fp, "PaxHeader", paxLen, 'x') != gCorpusOkay ||
+            fwrite(pax, 1, paxLen, fp) != paxLen ||
+            writePad(fp, (TARBLOCK - paxLen % TARBLOCK) % TARBLOCK)
+                != gCorpusOkay)
+        {
+            return gCorpusErr;
+        }
+    }
+
+    memset(hdr, 0, sizeof(hdr));
+    memcpy(hdr, name, (nameLen < 100 ? nameLen : 99));
+    snprintf((char *)hdr + 100, 8, "%07o", (type == '5' ? 0755 : 0644));
+    snprintf((char *)hdr + 108, 8, "%07o", 0);
+    snprintf((char *)hdr + 116, 8, "%07o", 0);
+    snprintf((char *)hdr + 124, 12, "%011lo", size);
+    snprintf((char *)hdr + 136, 12, "%011lo", CORPUSMTIME);
+    memset(hdr + 148, ' ', 8);
+    hdr[156] = (unsigned char)type;
+    memcpy(hdr + 257, "ustar", 6);
+    memcpy(hdr + 263, "00", 2);
+    memcpy(hdr + 265, "bench", 5);
+    memcpy(hdr + 297, "bench", 5);
+
+    for (i = 0; i < sizeof(hdr); i++)
+    {
+        sum += hdr[i];
+    }
+    snprintf((char *)hdr + 148, 8, "%06o", sum);
+    hdr[155] = ' ';
+
+    return (fwrite(hdr, 1, sizeof(hdr), fp) == sizeof(hdr) ?
+            gCorpusOkay : gCorpusErr);
+}
+
+/* writeTar - write the corpus as a pax / ustar archive */
+
+static int writeTar(const corpusSpec_t *spec, FILE *fp)
+{
+    char dir[32];
+    char name[CORPUSNAMEMAX];
+    char path[CORPUSNAMEMAX + 64];
+    unsigned long i = 0;
+    unsigned long size = 0;
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        corpusEntryDir(spec, i, dir, sizeof(dir));
+
+        if (i % spec->entriesPerDir == 0)
+        {
+            snprintf(path, sizeof(path), "%s/", dir);
+            if (writeTarHeader(fp, path, 0, '5') != gCorpusOkay)
+            {
+                return gCorpusErr;
+            }
+        }
+
+        corpusEntryName(spec, i, CORPUSNAMEMAX - 1, name, sizeof(name));
+        snprintf(path, sizeof(path), "%s/%s", dir, name);
+        size = corpusEntrySize(spec, i);
+
+        if (writeTarHeader(fp, path, size, '0') != gCorpusOkay ||
+            corpusWriteEntryData(spec, i, fp) != gCorpusOkay ||
+            writePad(fp, (TARBLOCK - size % TARBLOCK) % TARBLOCK)
+                != gCorpusOkay)
+        {
+            return gCorpusErr;
+        }
+    }
+
+    return writePad(fp, 2 * TARBLOCK);
+}
+
+/* writeArHeader - write a GNU ar member header */
+
+static int writeArHeader(FILE *fp, const char *name, unsigned long size)
+{
+    char hdr[ARHDRLEN + 1];
+
+    snprintf(hdr, sizeof(hdr),
+             "%-16.16s%-12lu%-6d%-6d%-8o%-10lu`\n",
+             name,
+             (strcmp(name, "//") == 0 ? 0 : CORPUSMTIME),
+             0,
+             0,
+             0644,
+             size);
+
+    return (fwrite(hdr, 1, ARHDRLEN, fp) == ARHDRLEN ?
+            gCorpusOkay : gCorpusErr);
+}
+
+/*
+    writeAr - write the corpus as a GNU ar archive; ar has no
+              directories, so only the base names are stored, and
+              names longer than ARNAMEMAX go in the "//" table
+*/
+
+static int writeAr(const corpusSpec_t *spec, FILE *fp)
+{
+    char name[CORPUSNAMEMAX];
+    char member[32];
+    unsigned long tableLen = 0;
+    unsigned long tableOffset = 0;
+    unsigned long size = 0;
+    unsigned long i = 0;
+    size_t nameLen = 0;
+
+    if (fwrite("!<arch>\n", 1, 8, fp) != 8)
+    {
+        return gCorpusErr;
+    }
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        corpusEntryName(spec, i, CORPUSNAMEMAX - 2, name, sizeof(name));
+        nameLen = strlen(name);
+        if (nameLen > ARNAMEMAX)
+        {
+            tableLen += nameLen + 2;
+        }
+    }
+
+    if (tableLen > 0)
+    {
+        if (writeArHeader(fp, "//", tableLen + (tableLen & 1))
+                != gCorpusOkay)
+        {
+            return gCorpusErr;
+        }
+
+        for (i = 0; i < spec->numEntries; i++)
+        {
+            corpusEntryName(spec, i, CORPUSNAMEMAX - 2, name, sizeof(name));
+            if (strlen(name) > ARNAMEMAX &&
+                fprintf(fp, "%s/\n", name) < 0)
+            {
+                return gCorpusErr;
+            }
+        }
+
+        if ((tableLen & 1) && fputc('\n', fp) == EOF)
+        {
+            return gCorpusErr;
+        }
+    }
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        corpusEntryName(spec, i, CORPUSNAMEMAX - 2, name, sizeof(name));
+        nameLen = strlen(name);
+        size = corpusEntrySize(spec, i);
+
+        if (nameLen > ARNAMEMAX)
+        {
+            snprintf(member, sizeof(member), "/%lu", tableOffset);
+            tableOffset += nameLen + 2;
+        }
+        else
+        {
+            snprintf(member, sizeof(member), "%s/", name);
+        }
+
+        if (writeArHeader(fp, member, size) != gCorpusOkay ||
+            corpusWriteEntryData(spec, i, fp) != gCorpusOkay ||
+            ((size & 1) && fputc('\n', fp) == EOF))
+        {
+            return gCorpusErr;
+        }
+    }
+
+    return gCorpusOkay;
+}
+
+/*
+    writeCab - write the corpus as a cabinet with stored (uncompressed)
+               folders; a new folder is started every CABFOLDERMAX
+               bytes since a folder offset is limited to 31 bits
+*/
+
+static int writeCab(const corpusSpec_t *spec, FILE *fp)
+{
+    static unsigned char data[CABDATAMAX];
+    unsigned char hdr[36];
+    unsigned char rec[16];
+    char dir[32];
+    char name[CORPUSNAMEMAX];
+    char path[CORPUSNAMEMAX + 64];
+    unsigned long *folderStart = NULL;
+    unsigned long *folderBlocks = NULL;
+    unsigned long numFolders = 0;
+    unsigned long folderSize = 0;
+    unsigned long filesLen = 0;
+    unsigned long dataOffset = 0;
+    unsigned long offset = 0;
+    unsigned long size = 0;
+    unsigned long i = 0;
+    unsigned long f = 0;
+    unsigned long fileOffset = 0;
+    unsigned long entry = 0;
+    unsigned long dataLen = 0;
+    size_t n = 0;
+    int ret = gCorpusErr;
+
+    if (spec->numEntries > CABFILESMAX)
+    {
+        fprintf(stderr,
+                "mkcorpus: ERROR: cab is limited to %d entries\n",
+                CABFILESMAX);
+        return gCorpusErr;
+    }
+
+    folderStart = calloc(spec->numEntries + 1, sizeof(unsigned long));
+    folderBlocks = calloc(spec->numEntries + 1, sizeof(unsigned long));
+    if (folderStart == NULL || folderBlocks == NULL)
+    {
+        goto done;
+    }
+
+    /* lay out the folders and the size of the CFFILE records */
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        size = corpusEntrySize(spec, i);
+        if (i == 0 || folderSize + size > CABFOLDERMAX)
+        {
+            if (i > 0)
+            {
+                folderBlocks[numFolders - 1] =
+                    (folderSize + CABDATAMAX - 1) / CABDATAMAX;
+            }
+            folderStart[numFolders++] = i;
+            folderSize = 0;
+        }
+        folderSize += size;
+
+        corpusEntryDir(spec, i, dir, sizeof(dir));
+        corpusEntryName(spec, i, CABNAMEMAX - strlen(dir) - 1,
+                        name, sizeof(name));
+        filesLen += 16 + strlen(dir) + 1 + strlen(name) + 1;
+    }
+    if (numFolders == 0)
+    {
+        numFolders = 1;
+    }
+    folderBlocks[numFolders - 1] =
+        (folderSize + CABDATAMAX - 1) / CABDATAMAX;
+    folderStart[numFolders] = spec->numEntries;
+
+    dataOffset = sizeof(hdr) + 8 * numFolders + filesLen;
+
+    /* CFHEADER; cbCabinet is filled in below */
+
+    memset(hdr, 0, sizeof(hdr));
+    memcpy(hdr, "MSCF", 4);
+    putLE32(hdr + 16, (uint32_t)(sizeof(hdr) + 8 * numFolders));
+    hdr[24] = 3;
+    hdr[25] = 1;
+    putLE16(hdr + 26, (uint16_t)numFolders);
+    putLE16(hdr + 28, (uint16_t)spec->numEntries);
+
+    offset = dataOffset;
+    for (f = 0; f < numFolders; f++)
+    {
+        folderSize = 0;
+        for (i = folderStart[f]; i < folderStart[f + 1]; i++)
+        {
+            folderSize += corpusEntrySize(spec, i);
+        }
+        offset += folderBlocks[f] * 8 + folderSize;
+    }
+    putLE32(hdr + 8, (uint32_t)offset);
+
+    if (fwrite(hdr, 1, sizeof(hdr), fp) != sizeof(hdr))
+    {
+        goto done;
+    }
+
+    /* CFFOLDERs */
+
+    offset = dataOffset;
+    for (f = 0; f < numFolders; f++)
+    {
+        putLE32(rec, (uint32_t)offset);
+        putLE16(rec + 4, (uint16_t)folderBlocks[f]);
+        putLE16(rec + 6, 0);
+        if (fwrite(rec, 1, 8, fp) != 8)
+        {
+            goto done;
+        }
+
+        folderSize = 0;
+        for (i = folderStart[f]; i < folderStart[f + 1]; i++)
+        {
+            folderSize += corpusEntrySize(spec, i);
+        }
+        offset += folderBlocks[f] * 8 + folderSize;
+    }
+
+    /* CFFILEs */
+
+    for (f = 0; f < numFolders; f++)
+    {
+        fileOffset = 0;
+        for (i = folderStart[f]; i < folderStart[f + 1]; i++)
+        {
+            size = corpusEntrySize(spec, i);
+            corpusEntryDir(spec, i, dir, sizeof(dir));
+            corpusEntryName(spec, i, CABNAMEMAX - strlen(dir) - 1,
+                            name, sizeof(name));
+            snprintf(path, sizeof(path), "%s\\%s", dir, name);
+
+            putLE32(rec, (uint32_t)size);
+            putLE32(rec + 4, (uint32_t)fileOffset);
+            putLE16(rec + 8, (uint16_t)f);
+            putLE16(rec + 10, (uint16_t)((2023 - 1980) << 9 | 11 << 5 | 14));
+            putLE16(rec + 12, (uint16_t)(22 << 11 | 13 << 5 | 10));
+            putLE16(rec + 14, 0x20);
+            if (fwrite(rec, 1, 16, fp) != 16 ||
+                fwrite(path, 1, strlen(path) + 1, fp) != strlen(path) + 1)
+            {
+                goto done;
+            }
+            fileOffset += size;
+        }
+    }
+
+    /* CFDATA blocks, without checksums */
+
+    for (f = 0; f < numFolders; f++)
+    {
+        entry = folderStart[f];
+        offset = 0;
+
+        while (entry < folderStart[f + 1])
+        {
+            dataLen = 0;
+            while (dataLen < CABDATAMAX && entry < folderStart[f + 1])
+            {
+                size = corpusEntrySize(spec, entry);
+                n = size - offset;
+                if (n > CABDATAMAX - dataLen)
+                {
+                    n = CABDATAMAX - dataLen;
+                }
+                corpusEntryFill(spec, entry, offset, data + dataLen, n);
+                dataLen += n;
+                offset += n;
+                if (offset >= size)
+                {
+                    entry++;
+                    offset = 0;
+                }
+            }
+
+            if (dataLen == 0)
+            {
+                continue;
+            }
+
+            putLE32(rec, 0);
+            putLE16(rec + 4, (uint16_t)dataLen);
+            putLE16(rec + 6, (uint16_t)dataLen);
+            if (fwrite(rec, 1, 8, fp) != 8 ||
+                fwrite(data, 1, dataLen, fp) != dataLen)
+            {
+                goto done;
+            }
+        }
+    }
+
+    ret = gCorpusOkay;
+
+done:
+
+    free(folderStart);
+    free(folderBlocks);
+    return ret;
+}
+
+/*
+    writeLha - write the corpus as an lha archive with level 2 headers
+               and stored (-lh0-) entries
+*/
+
+static int writeLha(const corpusSpec_t *spec, FILE *fp)
+{
+    unsigned char hdr[24 + 3 + 2 + 3 + LHANAMEMAX + 3 + 64 + 2];
+    char dir[32];
+    char name[CORPUSNAMEMAX];
+    unsigned long size = 0;
+    unsigned long i = 0;
+    size_t nameLen = 0;
+    size_t dirLen = 0;
+    size_t hdrLen = 0;
+    uint16_t crc = 0;
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        size = corpusEntrySize(spec, i);
+        corpusEntryDir(spec, i, dir, sizeof(dir));
+        corpusEntryName(spec, i, LHANAMEMAX, name, sizeof(name));
+        nameLen = strlen(name);
+        dirLen = strlen(dir);
+
+        memset(hdr, 0, sizeof(hdr));
+        memcpy(hdr + 2, "-lh0-", 5);
+        putLE32(hdr + 7, (uint32_t)size);
+        putLE32(hdr + 11, (uint32_t)size);
+        putLE32(hdr + 15, (uint32_t)CORPUSMTIME);
+        hdr[19] = 0x20;
+        hdr[20] = 2;
+        putLE16(hdr + 21, corpusEntryCRC16(spec, i));
+        hdr[23] = 'U';
+        hdrLen = 24;
+
+        /* header CRC extended header, filled in below */
+
+        putLE16(hdr + hdrLen, 5);
+        hdr[hdrLen + 2] = 0x00;
+        hdrLen += 5;
+
+        /* file name */
+
+        putLE16(hdr + hdrLen, (uint16_t)(3 + nameLen));
+        hdr[hdrLen + 2] = 0x01;
+        memcpy(hdr + hdrLen + 3, name, nameLen);
+        hdrLen += 3 + nameLen;
+
+        /* directory name, terminated by 0xff */
+
+        putLE16(hdr + hdrLen, (uint16_t)(3 + dirLen + 1));
+        hdr[hdrLen + 2] = 0x02;
+        memcpy(hdr + hdrLen + 3, dir, dirLen);
+        hdr[hdrLen + 3 + dirLen] = 0xff;
+        hdrLen += 3 + dirLen + 1;
+
+        /* end of the extended headers */
+
+        putLE16(hdr + hdrLen, 0);
+        hdrLen += 2;
+
+        putLE16(hdr, (uint16_t)hdrLen);
+        crc = crc16Arc(0, hdr, hdrLen);
+        putLE16(hdr + 27, crc);
+
+        if (fwrite(hdr, 1, hdrLen, fp) != hdrLen ||
+            corpusWriteEntryData(spec, i, fp) != gCorpusOkay)
+        {
+            return gCorpusErr;
+        }
+    }
+
+    return writePad(fp, 1);
+}
+
+/* writeSitEntryHeader - write a stuffit 1.x entry header */
+
+static int writeSitEntryHeader(FILE *fp,
+                               int compType,
+                               const char *name,
+                               unsigned long dataLen,
+                               uint16_t dataCRC)
+{
+    unsigned char hdr[112];
+    size_t nameLen = strlen(name);
+
+    if (nameLen > SITNAMEMAX)
+    {
+        nameLen = SITNAMEMAX;
+    }
+
+    memset(hdr, 0, sizeof(hdr));
+    hdr[0] = (unsigned char)compType;
+    hdr[1] = (unsigned char)compType;
+    hdr[2] = (unsigned char)nameLen;
+    memcpy(hdr + 3, name, nameLen);
+    if (compType == 0)
+    {
+        memcpy(hdr + 66, "TEXT", 4);
+        memcpy(hdr + 70, "ttxt", 4);
+    }
+    putBE32(hdr + 76, (uint32_t)(CORPUSMTIME + CORPUSMACEPOCH));
+    putBE32(hdr + 80, (uint32_t)(CORPUSMTIME + CORPUSMACEPOCH));
+    putBE32(hdr + 88, (uint32_t)dataLen);
+    putBE32(hdr + 96, (uint32_t)dataLen);
+    putBE16(hdr + 102, dataCRC);
+    putBE16(hdr + 110, crc16Arc(0, hdr, 110));
+
+    return (fwrite(hdr, 1, sizeof(hdr), fp) == sizeof(hdr) ?
+            gCorpusOkay : gCorpusErr);
+}
+
+/*
+    writeSit - write the corpus as a stuffit 1.x archive with stored
+               data forks, one folder per directory
+*/
+
+static int writeSit(const corpusSpec_t *spec, FILE *fp)
+{
+    unsigned char hdr[22];
+    char dir[32];
+    char name[CORPUSNAMEMAX];
+    unsigned long numDirs = 0;
+    unsigned long archiveLen = sizeof(hdr);
+    unsigned long i = 0;
+    unsigned long size = 0;
+
+    numDirs = (spec->numEntries + spec->entriesPerDir - 1) /
+              spec->entriesPerDir;
+
+    if (numDirs > 0xffff)
+    {
+        fprintf(stderr,
+                "mkcorpus: ERROR: sit is limited to %d folders\n",
+                0xffff);
+        return gCorpusErr;
+    }
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        archiveLen += 112 + corpusEntrySize(spec, i);
+    }
+    archiveLen += numDirs * 2 * 112;
+
+    memset(hdr, 0, sizeof(hdr));
+    memcpy(hdr, "SIT!", 4);
+    putBE16(hdr + 4, (uint16_t)numDirs);
+    putBE32(hdr + 6, (uint32_t)archiveLen);
+    memcpy(hdr + 10, "rLau", 4);
+    hdr[14] = 1;
+
+    if (fwrite(hdr, 1, sizeof(hdr), fp) != sizeof(hdr))
+    {
+        return gCorpusErr;
+    }
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        if (i % spec->entriesPerDir == 0)
+        {
+            if (i > 0 &&
+                writeSitEntryHeader(fp, 33, "", 0, 0) != gCorpusOkay)
+            {
+                return gCorpusErr;
+            }
+            corpusEntryDir(spec, i, dir, sizeof(dir));
+            if (writeSitEntryHeader(fp, 32, dir, 0, 0) != gCorpusOkay)
+            {
+                return gCorpusErr;
+            }
+        }
+
+        size = corpusEntrySize(spec, i);
+        corpusEntryName(spec, i, SITNAMEMAX, name, sizeof(name));
+        if (writeSitEntryHeader(fp,
+                                0,
+                                name,
+                                size,
+                                corpusEntryCRC16(spec, i)) != gCorpusOkay ||
+            corpusWriteEntryData(spec, i, fp) != gCorpusOkay)
+        {
+            return gCorpusErr;
+        }
+    }
+
+    if (spec->numEntries > 0 &&
+        writeSitEntryHeader(fp, 33, "", 0, 0) != gCorpusOkay)
+    {
+        return gCorpusErr;
+    }
+
+    return gCorpusOkay;
+}
+
+/* hqxPutChar - write one 6 bit encoded character */
+
+static void hqxPutChar(hqxWriter_t *w, int c)
+{
+    fputc(gHqxChars[c & 0x3f], w->fp);
+    if (++w->lineLen == HQXLINELEN)
+    {
+        fputc('\n', w->fp);
+        w->lineLen = 0;
+    }
+}
+
+/* hqxPutRaw - add a byte to the 8 to 6 bit encoder */
+
+static void hqxPutRaw(hqxWriter_t *w, int c)
+{
+    w->triple[w->tripleLen++] = (unsigned char)c;
+    if (w->tripleLen == 3)
+    {
+        hqxPutChar(w, w->triple[0] >> 2);
+        hqxPutChar(w, (w->triple[0] << 4) | (w->triple[1] >> 4));
+        hqxPutChar(w, (w->triple[1] << 2) | (w->triple[2] >> 6));
+        hqxPutChar(w, w->triple[2]);
+        w->tripleLen = 0;
+    }
+}
+
+/* hqxFlushRun - write out the pending run of lastByte */
+
+static void hqxFlushRun(hqxWriter_t *w)
+{
+    if (w->runLen == 0)
+    {
+        return;
+    }
+
+    hqxPutRaw(w, w->lastByte);
+    if (w->lastByte == 0x90)
+    {
+        hqxPutRaw(w, 0);
+    }
+
+    if (w->runLen == 2)
+    {
+        hqxPutRaw(w, w->lastByte);
+        if (w->lastByte == 0x90)
+        {
+            hqxPutRaw(w, 0);
+        }
+    }
+    else if (w->runLen > 2)
+    {
+        hqxPutRaw(w, 0x90);
+        hqxPutRaw(w, w->runLen);
+    }
+
+    w->runLen = 0;
+}
+
+/* hqxPut - run length encode and add bytes to the crc */
+
+static void hqxPut(hqxWriter_t *w, const unsigned char *buf, size_t len)
+{
+    size_t i = 0;
+
+    w->crc = crc16Xmodem(w->crc, buf, len);
+
+    for (i = 0; i < len; i++)
+    {
+        if (w->runLen > 0 && buf[i] == w->lastByte && w->runLen < 255)
+        {
+            w->runLen++;
+            continue;
+        }
+        hqxFlushRun(w);
+        w->lastByte = buf[i];
+        w->runLen = 1;
+    }
+}
+
+/* hqxPutCRC - write the running crc and reset it */
+
+static void hqxPutCRC(hqxWriter_t *w)
+{
+    unsigned char crc[2];
+    uint16_t value = w->crc;
+
+    putBE16(crc, value);
+    hqxPut(w, crc, sizeof(crc));
+    w->crc = 0;
+}
+
+/* hqxFlush - flush the encoder and close the binhex data */
+
+static void hqxFlush(hqxWriter_t *w)
+{
+    hqxFlushRun(w);
+    if (w->tripleLen > 0)
+    {
+        while (w->tripleLen < 3)
+        {
+            w->triple[w->tripleLen++] = 0;
+        }
+        hqxPutChar(w, w->triple[0] >> 2);
+        hqxPutChar(w, (w->triple[0] << 4) | (w->triple[1] >> 4));
+        hqxPutChar(w, (w->triple[1] << 2) | (w->triple[2] >> 6));
+        hqxPutChar(w, w->triple[2]);
+    }
+    fputs(":\n", w->fp);
+}
+
+/*
+    writeHqx - write the first entry of the corpus as a binhex 4.0
+               file (binhex holds a single file, so the entry count
+               is ignored)
+*/
+
+static int writeHqx(const corpusSpec_t *spec, FILE *fp)
+{
+    static unsigned char buf[CORPUSBUFSIZE];
+    hqxWriter_t w;
+    unsigned char hdr[1 + HQXNAMEMAX + 1 + 4 + 4 + 2 + 4 + 4];
+    char name[CORPUSNAMEMAX];
+    unsigned long size = corpusEntrySize(spec, 0);
+    unsigned long offset = 0;
+    size_t nameLen = 0;
+    size_t hdrLen = 0;
+    size_t len = 0;
+
+    memset(&w, 0, sizeof(w));
+    w.fp = fp;
+
+    corpusEntryName(spec, 0, HQXNAMEMAX, name, sizeof(name));
+    nameLen = strlen(name);
+
+    hdr[hdrLen++] = (unsigned char)nameLen;
+    memcpy(hdr + hdrLen, name, nameLen);
+    hdrLen += nameLen;
+    hdr[hdrLen++] = 0;
+    memcpy(hdr + hdrLen, "TEXTttxt", 8);
+    hdrLen += 8;
+    putBE16(hdr + hdrLen, 0);
+    hdrLen += 2;
+    putBE32(hdr + hdrLen, (uint32_t)size);
+    hdrLen += 4;
+    putBE32(hdr + hdrLen, 0);
+    hdrLen += 4;
+
+    fputs("(This file must be converted with BinHex 4.0)\n\n:", fp);
+    w.lineLen = 1;
+
+    hqxPut(&w, hdr, hdrLen);
+    hqxPutCRC(&w);
+
+    while (offset < size)
+    {
+        len = size - offset;
+        if (len > sizeof(buf))
+        {
+            len = sizeof(buf);
+        }
+        corpusEntryFill(spec, 0, offset, buf, len);
+        hqxPut(&w, buf, len);
+        offset += len;
+    }
+    hqxPutCRC(&w);
+
+    /* empty resource fork */
+
+    hqxPutCRC(&w);
+    hqxFlush(&w);
+
+    return (ferror(fp) ? gCorpusErr : gCorpusOkay);
+}
+
+/*
+    writeRpm - wrap the payload (a compressed cpio archive) in an rpm
+               lead and empty signature and header sections
+*/
+
+static int writeRpm(const corpusSpec_t *spec, FILE *fp)
+{
+    static unsigned char buf[CORPUSBUFSIZE];
+    unsigned char lead[RPMLEADSIZE];
+    unsigned char section[16];
+    FILE *payload = NULL;
+    size_t n = 0;
+    int i = 0;
+
+    if (spec->payload == NULL)
+    {
+        fprintf(stderr, "mkcorpus: ERROR: rpm needs a payload (-p)\n");
+        return gCorpusErr;
+    }
+
+    payload = fopen(spec->payload, "rb");
+    if (payload == NULL)
+    {
+        fprintf(stderr,
+                "mkcorpus: ERROR: cannot open '%s': %s\n",
+                spec->payload,
+                strerror(errno));
+        return gCorpusErr;
+    }
+
+    memset(lead, 0, sizeof(lead));
+    memcpy(lead, "\xed\xab\xee\xdb", 4);
+    lead[4] = 3;
+    lead[5] = 0;
+    putBE16(lead + 6, 0);
+    putBE16(lead + 8, 1);
+    snprintf((char *)lead + 10, 66, "bench-corpus-1.0-1");
+    putBE16(lead + 76, 1);
+    putBE16(lead + 78, 5);
+
+    /* signature and header sections, both without any entries */
+
+    memset(section, 0, sizeof(section));
+    memcpy(section, "\x8e\xad\xe8\x01", 4);
+
+    if (fwrite(lead, 1, sizeof(lead), fp) != sizeof(lead))
+    {
+        fclose(payload);
+        return gCorpusErr;
+    }
+    for (i = 0; i < 2; i++)
+    {
+        if (fwrite(section, 1, sizeof(section), fp) != sizeof(section))
+        {
+            fclose(payload);
+            return gCorpusErr;
+        }
+    }
+
+    while ((n = fread(buf, 1, sizeof(buf), payload)) > 0)
+    {
+        if (fwrite(buf, 1, n, fp) != n)
+        {
+            fclose(payload);
+            return gCorpusErr;
+        }
+    }
+
+    fclose(payload);
+    return gCorpusOkay;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: mkcorpus [-n entries] [-l name length] [-s size]\n"
+            "                [-c compressibility] [-d entries per dir]\n"
+            "                [-S seed] [-p payload] "
+            "[tar|ar|cab|lha|sit|hqx|rpm] [output]\n");
+}
+
+int main(int argc, char **argv)
+{
+    corpusSpec_t spec;
+    const char *format = NULL;
+    const char *output = NULL;
+    FILE *fp = NULL;
+    int ret = gCorpusErr;
+    int i = 0;
+
+    spec.numEntries = 1000;
+    spec.nameLen = 16;
+    spec.entrySize = 1024;
+    spec.compressibility = 50;
+    spec.entriesPerDir = 1000;
+    spec.seed = 1;
+    spec.payload = NULL;
+
+    for (i = 1; i < argc; i++)
+    {
+
+        if (argv[i][0] == '-' && argv[i][1] != '\0' &&
+            argv[i][2] == '\0' && i + 1 < argc)
+        {
+            switch (argv[i][1])
+            {
+                case 'n':
+                    spec.numEntries = strtoul(argv[++i], NULL, 10);
+                    continue;
+                case 'l':
+                    spec.nameLen = strtoul(argv[++i], NULL, 10);
+                    continue;
+                case 's':
+                    spec.entrySize = strtoul(argv[++i], NULL, 10);
+                    continue;
+                case 'c':
+                    spec.compressibility = strtoul(argv[++i], NULL, 10);
+                    continue;
+                case 'd':
+                    spec.entriesPerDir = strtoul(argv[++i], NULL, 10);
+                    continue;
+                case 'S':
+                    spec.seed = strtoull(argv[++i], NULL, 10);
+                    continue;
+                case 'p':
+                    spec.payload = argv[++i];
+                    continue;
+                default:
+                    break;
+            }
+        }
+
+        if (format == NULL)
+        {
+            format = argv[i];
+        }
+        else if (output == NULL)
+        {
+            output = argv[i];
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (format == NULL || output == NULL)
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (spec.entriesPerDir == 0)
+    {
+        spec.entriesPerDir = 1;
+    }
+    if (spec.compressibility > 100)
+    {
+        spec.compressibility = 100;
+    }
+
+    fp = fopen(output, "wb");
+    if (fp == NULL)
+    {
+        fprintf(stderr,
+                "mkcorpus: ERROR: cannot create '%s': %s\n",
+                output,
+                strerror(errno));
+        return 1;
+    }
+
+    if (strcmp(format, "tar") == 0)
+    {
+        ret = writeTar(&spec, fp);
+    }
+    else if (strcmp(format, "ar") == 0)
+    {
+        ret = writeAr(&spec, fp);
+    }
+    else if (strcmp(format, "cab") == 0)
+    {
+        ret = writeCab(&spec, fp);
+    }
+    else if (strcmp(format, "lha") == 0)
+    {
+        ret = writeLha(&spec, fp);
+    }
+    else if (strcmp(format, "sit") == 0)
+    {
+        ret = writeSit(&spec, fp);
+    }
+    else if (strcmp(format, "hqx") == 0)
+    {
+        ret = writeHqx(&spec, fp);
+    }
+    else if (strcmp(format, "rpm") == 0)
+    {
+        ret = writeRpm(&spec, fp);
+    }
+    else
+    {
+        printUsage();
+    }
+
+    if (fclose(fp) != 0)
+    {
+        ret = gCorpusErr;
+    }
+
+    if (ret != gCorpusOkay)
+    {
+        fprintf(stderr, "mkcorpus: ERROR: cannot write '%s'\n", output);
+        remove(output);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,237 @@
+#!/bin/sh
+#
+#    mkcorpus.sh - generate the benchmark corpus
+#
+#    v0.1.0 - initial release
+#
+#    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+#
+#    Permission is hereby granted, free of charge, to any person obtaining
+#    a copy of this software and associated documentation files (the
+#    "Software") to deal in the Software without restriction, including
+#    without limitation the rights to use, copy, modify, merge, publish,
+#    distribute, sublicense, and/or sell copies of the Software, and to
+#    permit persons to whom the Software is furnished to do so, subject
+#    to the following conditions:
+#
+#    The above copyright notice and this permission notice shall be
+#    included in all copies or substantial portions of the Software.
+#
+#    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+#    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+#    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+#    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+#    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+#    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+#    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#
+
+# The corpus varies one thing at a time around a default of 1000
+# entries with 16 character names that are 50% compressible:
+#
+#    - the entry count, over COUNTS
+#    - the name length, over NAMELENS
+#    - the compressibility, over COMPS
+#
+# Each setting is generated as a tar by mkcorpus and then written in
+# every format, as <format>-n<count>-l<name length>-c<percent>.<ext>
+# so that listbench can label the results.  The entries, and so the
+# archives, are the same from run to run, except for the creation
+# times that bsdtar records in the iso9660 and xar headers.
+
+MKCORPUS="./build/mkcorpus"
+BSDTAR="bsdtar"
+COUNTS="10 1000 100000"
+NAMELENS="16 128"
+COMPS="0 50 100"
+SIZE=512
+SEED=1
+FORMATS="tar tgz tbz2 txz zip zip64 7z 7zns xar iso cab lha ar deb cpio rpm hqx sit"
+DEFCOUNT=1000
+DEFNAMELEN=16
+DEFCOMP=50
+MTIME=1700000000
+
+usage()
+{
+    echo "Usage: $0 [-m mkcorpus] [-n \"counts\"] [-l \"name lengths\"]" >& 2
+    echo "       [-c \"compressibilities\"] [-s entry size] [-S seed]" >& 2
+    echo "       [-f \"formats\"] [output dir]" >& 2
+    echo "Formats: $FORMATS" >& 2
+    exit 1
+}
+
+while getopts "m:n:l:c:s:S:f:h" OPT ; do
+    case "$OPT" in
+        m) MKCORPUS="$OPTARG" ;;
+        n) COUNTS="$OPTARG" ;;
+        l) NAMELENS="$OPTARG" ;;
+        c) COMPS="$OPTARG" ;;
+        s) SIZE="$OPTARG" ;;
+        S) SEED="$OPTARG" ;;
+        f) FORMATS="$OPTARG" ;;
+        *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+OUTDIR="${1:-corpus}"
+
+if [ ! -x "$MKCORPUS" ] ; then
+    echo "ERROR: $MKCORPUS not available, run make first" >& 2
+    exit 1
+fi
+
+if ! command -v "$BSDTAR" > /dev/null 2>&1 ; then
+    echo "ERROR: $BSDTAR not available" >& 2
+    exit 1
+fi
+
+SEVENZIP=""
+for CMD in 7zz 7z 7za ; do
+    if command -v "$CMD" > /dev/null 2>&1 ; then
+        SEVENZIP="$CMD"
+        break
+    fi
+done
+
+mkdir -p "$OUTDIR" || exit 1
+OUTDIR=$(cd "$OUTDIR" && pwd) || exit 1
+
+TMPDIR=$(mktemp -d "${TMPDIR:-/tmp}/mkcorpus.XXXXXX") || exit 1
+trap 'rm -rf "$TMPDIR"' EXIT INT TERM
+
+# hasFormat - check if the format was requested
+
+hasFormat()
+{
+    for F in $FORMATS ; do
+        if [ "$F" = "$1" ] ; then
+            return 0
+        fi
+    done
+    return 1
+}
+
+# convert - rewrite the tar as another format with bsdtar
+
+convert()
+{
+    "$BSDTAR" -cf "$2" --format "$1" $3 @"$TAR" || \
+        echo "WARNING: cannot create $2" >& 2
+}
+
+# makeSet - write every format for one count, name length and
+#           compressibility
+
+makeSet()
+{
+    N="$1"
+    L="$2"
+    C="$3"
+    NAME="n$N-l$L-c$C"
+    OPTS="-n $N -l $L -c $C -s $SIZE -S $SEED"
+    TAR="$TMPDIR/$NAME.tar"
+
+    echo "$NAME"
+
+    "$MKCORPUS" $OPTS tar "$TAR" || return 1
+
+    hasFormat tar  && cp "$TAR" "$OUTDIR/tar-$NAME.tar"
+    hasFormat tgz  && gzip -n -c "$TAR" > "$OUTDIR/tgz-$NAME.tgz"
+    hasFormat tbz2 && bzip2 -c "$TAR" > "$OUTDIR/tbz2-$NAME.tbz2"
+    hasFormat txz  && xz -T1 -c "$TAR" > "$OUTDIR/txz-$NAME.txz"
+
+    hasFormat zip && \
+        convert zip "$OUTDIR/zip-$NAME.zip" "--options zip:compression=deflate"
+    hasFormat zip64 && \
+        convert zip "$OUTDIR/zip64-$NAME.zip" "--options zip:zip64"
+    hasFormat 7z && convert 7zip "$OUTDIR/7z-$NAME.7z"
+    hasFormat xar && convert xar "$OUTDIR/xar-$NAME.xar"
+    hasFormat iso && convert iso9660 "$OUTDIR/iso-$NAME.iso"
+    hasFormat cpio && convert newc "$OUTDIR/cpio-$NAME.cpio"
+
+    # bsdtar's 7-Zip writer only makes solid archives, so the non-solid
+    # variant needs 7-Zip itself and the entries on disk
+
+    if hasFormat 7zns ; then
+        if [ -n "$SEVENZIP" ] ; then
+            mkdir "$TMPDIR/tree" && \
+            "$BSDTAR" -xf "$TAR" -C "$TMPDIR/tree" && \
+            (cd "$TMPDIR/tree" && \
+             "$SEVENZIP" a -bd -ms=off -mtc=off -mta=off \
+                 "$OUTDIR/7zns-$NAME.7z" . > /dev/null) || \
+                echo "WARNING: cannot create 7zns-$NAME.7z" >& 2
+            rm -rf "$TMPDIR/tree"
+        else
+            echo "WARNING: 7-Zip not found, skipping 7zns-$NAME.7z" >& 2
+        fi
+    fi
+
+    if hasFormat deb ; then
+        mkdir "$TMPDIR/deb" && \
+        printf '2.0\n' > "$TMPDIR/deb/debian-binary" && \
+        printf 'Package: bench\nVersion: 1.0\n' > "$TMPDIR/deb/control" && \
+        "$BSDTAR" -czf "$TMPDIR/deb/control.tar.gz" \
+            -C "$TMPDIR/deb" --uid 0 --gid 0 control && \
+        xz -T1 -c "$TAR" > "$TMPDIR/deb/data.tar.xz" && \
+        touch -d "@$MTIME" "$TMPDIR/deb/"* && \
+        "$BSDTAR" -cf "$OUTDIR/deb-$NAME.deb" --format argnu \
+            --uid 0 --gid 0 -C "$TMPDIR/deb" \
+            debian-binary control.tar.gz data.tar.xz || \
+            echo "WARNING: cannot create deb-$NAME.deb" >& 2
+        rm -rf "$TMPDIR/deb"
+    fi
+
+    if hasFormat rpm ; then
+        "$BSDTAR" -cf - --format newc @"$TAR" | gzip -n > "$TMPDIR/payload" && \
+        "$MKCORPUS" -p "$TMPDIR/payload" rpm "$OUTDIR/rpm-$NAME.rpm" || \
+            echo "WARNING: cannot create rpm-$NAME.rpm" >& 2
+    fi
+
+    # formats that bsdtar cannot write
+
+    if hasFormat cab ; then
+        if [ "$N" -le 65535 ] ; then
+            "$MKCORPUS" $OPTS cab "$OUTDIR/cab-$NAME.cab"
+        else
+            echo "WARNING: skipping cab-$NAME.cab (over 65535 entries)" >& 2
+        fi
+    fi
+    hasFormat ar  && "$MKCORPUS" $OPTS ar "$OUTDIR/ar-$NAME.a"
+    hasFormat lha && "$MKCORPUS" $OPTS lha "$OUTDIR/lha-$NAME.lzh"
+    hasFormat sit && "$MKCORPUS" $OPTS sit "$OUTDIR/sit-$NAME.sit"
+
+    rm -f "$TAR"
+    return 0
+}
+
+# binhex holds a single file, so it only varies by compressibility
+
+if hasFormat hqx ; then
+    for C in $COMPS ; do
+        "$MKCORPUS" -n 1 -l "$DEFNAMELEN" -c "$C" -s "$SIZE" -S "$SEED" \
+            hqx "$OUTDIR/hqx-n1-l$DEFNAMELEN-c$C.hqx"
+    done
+    FORMATS=$(echo " $FORMATS " | sed 's/ hqx / /')
+fi
+
+SETS=""
+for N in $COUNTS ; do
+    SETS="$SETS $N:$DEFNAMELEN:$DEFCOMP"
+done
+for L in $NAMELENS ; do
+    SETS="$SETS $DEFCOUNT:$L:$DEFCOMP"
+done
+for C in $COMPS ; do
+    SETS="$SETS $DEFCOUNT:$DEFNAMELEN:$C"
+done
+
+for SET in $(echo "$SETS" | tr ' ' '\n' | sort -u -t: -k1,1n -k2,2n -k3,3n) ; do
+    IFS=: read -r N L C <<EOF
+$SET
+EOF
+    makeSet "$N" "$L" "$C" || exit 1
+done
+
+exit 0
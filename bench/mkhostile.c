@@ -0,0 +1,900 @@
+/*
+    mkhostile.c - generate pathological archives for the benchmarks
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://www.gnu.org/software/tar/manual/html_node/Standard.html
+    https://pubs.opengroup.org/onlinepubs/9699919799/utilities/pax.html
+    https://pkwaredownloads.blob.core.windows.net/pem/APPNOTE.txt
+    https://ecma-international.org/publications-and-standards/standards/ecma-119/
+    https://en.wikipedia.org/wiki/Rock_Ridge
+    https://github.com/mackyle/xar/wiki/xarformat
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    mkhostile writes archives that are built to make a reader do as
+    much work as possible per byte of input, scaled by the entry
+    count (-n), so that linbench.sh can check that listing time grows
+    linearly with the size of the archive:
+
+        tarext  - every entry is preceded by a GNU long name, a GNU
+                  long link name and a pax header
+        paxbig  - one entry whose pax header holds n records
+        zipdup  - n central directory entries that all point to the
+                  same local file header
+        isoce   - n Rock Ridge entries whose names are in SUSP "CE"
+                  continuation areas, the last of which continues
+                  into itself
+        xardeep - n directories in a xar TOC, nested -d deep
+
+    The output is a pure function of the command line.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <zlib.h>
+
+/* return codes */
+
+enum
+{
+    gHostileErr  = -1,
+    gHostileOkay =  0,
+};
+
+/* defines */
+
+#define HOSTILENAMEMAX  250
+#define HOSTILEMTIME    1700000000UL
+#define TARBLOCK        512
+#define ISOBLOCK        2048
+#define ISOSYSTEMAREA   16
+#define ISODIRBLOCK     19
+#define ISORECLEN       72
+#define ISOCELEN        28
+#define XARHEADERSIZE   28
+
+/* hostile archive specification */
+
+typedef struct hostileSpec
+{
+    unsigned long numEntries;
+    unsigned long nameLen;
+    unsigned long depth;
+} hostileSpec_t;
+
+/* growable output buffer, for the xar TOC */
+
+typedef struct hostileBuf
+{
+    char *data;
+    size_t len;
+    size_t size;
+} hostileBuf_t;
+
+/* private functions */
+
+static void hostileName(const hostileSpec_t *spec,
+                        const char *prefix,
+                        unsigned long i,
+                        char *name,
+                        size_t nameSize);
+static void putLE16(unsigned char *buf, uint16_t value);
+static void putLE32(unsigned char *buf, uint32_t value);
+static void putBE16(unsigned char *buf, uint16_t value);
+static void putBE32(unsigned char *buf, uint32_t value);
+static void putBoth16(unsigned char *buf, uint16_t value);
+static void putBoth32(unsigned char *buf, uint32_t value);
+static int writePad(FILE *fp, size_t len);
+static int writeTarHeader(FILE *fp,
+                          const char *name,
+                          const char *magic,
+                          unsigned long size,
+                          char type);
+static int writeTarBody(FILE *fp, const char *body, size_t len);
+static size_t paxRecord(char *buf,
+                        size_t bufSize,
+                        const char *key,
+                        const char *value);
+static int writeTarExt(const hostileSpec_t *spec, FILE *fp);
+static int writePaxBig(const hostileSpec_t *spec, FILE *fp);
+static int writeZipDup(const hostileSpec_t *spec, FILE *fp);
+static void isoDirRecord(unsigned char *rec,
+                         size_t recLen,
+                         uint32_t location,
+                         uint32_t size,
+                         int flags,
+                         const char *name,
+                         size_t nameLen);
+static void isoCE(unsigned char *buf,
+                  uint32_t location,
+                  uint32_t offset,
+                  uint32_t size);
+static int writeIsoCE(const hostileSpec_t *spec, FILE *fp);
+static int bufAppend(hostileBuf_t *buf, const char *str);
+static int writeXarDeep(const hostileSpec_t *spec, FILE *fp);
+static void printUsage(void);
+
+/*
+    hostileName - make a name of spec->nameLen characters for entry i
+                  that starts with prefix and the entry number
+*/
+
+static void hostileName(const hostileSpec_t *spec,
+                        const char *prefix,
+                        unsigned long i,
+                        char *name,
+                        size_t nameSize)
+{
+    size_t len = 0;
+
+    len = (size_t)snprintf(name, nameSize, "%s%08lu", prefix, i);
+    while (len < spec->nameLen && len + 1 < nameSize)
+    {
+        name[len] = (char)('a' + (i + len) % 26);
+        len++;
+    }
+    name[len] = '\0';
+}
+
+/* byte order helpers */
+
+static void putLE16(unsigned char *buf, uint16_t value)
+{
+    buf[0] = (unsigned char)(value & 0xff);
+    buf[1] = (unsigned char)((value >> 8) & 0xff);
+}
+
+static void putLE32(unsigned char *buf, uint32_t value)
+{
+    putLE16(buf, (uint16_t)(value & 0xffff));
+    putLE16(buf + 2, (uint16_t)((value >> 16) & 0xffff));
+}
+
+static void putBE16(unsigned char *buf, uint16_t value)
+{
+    buf[0] = (unsigned char)((value >> 8) & 0xff);
+    buf[1] = (unsigned char)(value & 0xff);
+}
+
+static void putBE32(unsigned char *buf, uint32_t value)
+{
+    putBE16(buf, (uint16_t)((value >> 16) & 0xffff));
+    putBE16(buf + 2, (uint16_t)(value & 0xffff));
+}
+
+/* putBoth16, putBoth32 - ISO 9660 both-byte orders (7.2.3, 7.3.3) */
+
+static void putBoth16(unsigned char *buf, uint16_t value)
+{
+    putLE16(buf, value);
+    putBE16(buf + 2, value);
+}
+
+static void putBoth32(unsigned char *buf, uint32_t value)
+{
+    putLE32(buf, value);
+    putBE32(buf + 4, value);
+}
+
+/* writePad - write len zero bytes */
+
+static int writePad(FILE *fp, size_t len)
+{
+    static const unsigned char zeros[ISOBLOCK];
+    size_t n = 0;
+
+    while (len > 0)
+    {
+        n = (len > sizeof(zeros) ? sizeof(zeros) : len);
+        if (fwrite(zeros, 1, n, fp) != n)
+        {
+            return gHostileErr;
+        }
+        len -= n;
+    }
+
+    return gHostileOkay;
+}
+
+/* writeTarHeader - write a tar header with the given magic */
+
+static int writeTarHeader(FILE *fp,
+                          const char *name,
+                          const char *magic,
+                          unsigned long size,
+                          char type)
+{
+    unsigned char hdr[TARBLOCK];
+    unsigned int sum = 0;
+    size_t i = 0;
+
+    memset(hdr, 0, sizeof(hdr));
+    memcpy(hdr, name, strnlen(name, 99));
+    snprintf((char *)hdr + 100, 8, "%07o", 0644);
+    snprintf((char *)hdr + 108, 8, "%07o", 0);
+    snprintf((char *)hdr + 116, 8, "%07o", 0);
+    snprintf((char *)hdr + 124, 12, "%011lo", size);
+    snprintf((char *)hdr + 136, 12, "%011lo", HOSTILEMTIME);
+    memset(hdr + 148, ' ', 8);
+    hdr[156] = (unsigned char)type;
+    memcpy(hdr + 257, magic, 8);
+
+    for (i = 0; i < sizeof(hdr); i++)
+    {
+        sum += hdr[i];
+    }
+    snprintf((char *)hdr + 148, 8, "%06o", sum);
+    hdr[155] = ' ';
+
+    return (fwrite(hdr, 1, sizeof(hdr), fp) == sizeof(hdr) ?
+            gHostileOkay : gHostileErr);
+}
+
+/* writeTarBody - write an extension header's body and its padding */
+
+static int writeTarBody(FILE *fp, const char *body, size_t len)
+{
+    if (fwrite(body, 1, len, fp) != len)
+    {
+        return gHostileErr;
+    }
+
+    return writePad(fp, (TARBLOCK - len % TARBLOCK) % TARBLOCK);
+}
+
+/*
+    paxRecord - format a pax "length key=value" record, whose length
+                includes its own digits
+*/
+
+static size_t paxRecord(char *buf,
+                        size_t bufSize,
+                        const char *key,
+                        const char *value)
+{
+    size_t recLen = strlen(key) + strlen(value) + 3;
+    size_t digits = 1;
+    char num[32];
+
+    for (digits = 1; ; digits++)
+    {
+        snprintf(num, sizeof(num), "%zu", recLen + digits);
+        if (strlen(num) == digits)
+        {
+            break;
+        }
+    }
+
+    return (size_t)snprintf(buf, bufSize, "%zu %s=%s\n",
+                            recLen + digits, key, value);
+}
+
+/*
+    writeTarExt - write entries that are each preceded by a GNU long
+                  name ('L'), a GNU long link name ('K') and a pax
+                  header ('x') giving the path and link path again
+*/
+
+static int writeTarExt(const hostileSpec_t *spec, FILE *fp)
+{
+    char name[HOSTILENAMEMAX + 32];
+    char link[HOSTILENAMEMAX + 32];
+    char pax[4 * (HOSTILENAMEMAX + 64)];
+    size_t paxLen = 0;
+    unsigned long i = 0;
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        hostileName(spec, "name", i, name, sizeof(name));
+        hostileName(spec, "link", i, link, sizeof(link));
+
+        paxLen = paxRecord(pax, sizeof(pax), "path", name);
+        paxLen += paxRecord(pax + paxLen, sizeof(pax) - paxLen,
+                            "linkpath", link);
+        paxLen += paxRecord(pax + paxLen, sizeof(pax) - paxLen,
+                            "comment", name);
+
+        if (writeTarHeader(fp, "././@LongLink", "ustar  ",
+                           strlen(name) + 1, 'L') != gHostileOkay ||
+            writeTarBody(fp, name, strlen(name) + 1) != gHostileOkay ||
+            writeTarHeader(fp, "././@LongLink", "ustar  ",
+                           strlen(link) + 1, 'K') != gHostileOkay ||
+            writeTarBody(fp, link, strlen(link) + 1) != gHostileOkay ||
+            writeTarHeader(fp, "PaxHeader", "ustar\00000",
+                           paxLen, 'x') != gHostileOkay ||
+            writeTarBody(fp, pax, paxLen) != gHostileOkay ||
+            writeTarHeader(fp, "short", "ustar\00000", 0, '2')
+                != gHostileOkay)
+        {
+            return gHostileErr;
+        }
+    }
+
+    return writePad(fp, 2 * TARBLOCK);
+}
+
+/* writePaxBig - write one entry whose pax header has n records */
+
+static int writePaxBig(const hostileSpec_t *spec, FILE *fp)
+{
+    char value[HOSTILENAMEMAX + 32];
+    char rec[HOSTILENAMEMAX + 64];
+    unsigned long long paxLen = 0;
+    size_t recLen = 0;
+    unsigned long i = 0;
+
+    /* the records are written twice, to size them and then for real */
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        hostileName(spec, "value", i, value, sizeof(value));
+        paxLen += paxRecord(rec, sizeof(rec), "comment", value);
+    }
+
+    if (writeTarHeader(fp, "PaxHeader", "ustar\00000",
+                       (unsigned long)paxLen, 'x') != gHostileOkay)
+    {
+        return gHostileErr;
+    }
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        hostileName(spec, "value", i, value, sizeof(value));
+        recLen = paxRecord(rec, sizeof(rec), "comment", value);
+        if (fwrite(rec, 1, recLen, fp) != recLen)
+        {
+            return gHostileErr;
+        }
+    }
+
+    if (writePad(fp, (TARBLOCK - paxLen % TARBLOCK) % TARBLOCK)
+            != gHostileOkay ||
+        writeTarHeader(fp, "big", "ustar\00000", 0, '0') != gHostileOkay)
+    {
+        return gHostileErr;
+    }
+
+    return writePad(fp, 2 * TARBLOCK);
+}
+
+/*
+    writeZipDup - write a zip with one stored file and n central
+                  directory entries that all point to its local header
+*/
+
+static int writeZipDup(const hostileSpec_t *spec, FILE *fp)
+{
+    unsigned char hdr[46];
+    char name[HOSTILENAMEMAX + 32];
+    uint32_t crc = (uint32_t)crc32(0, (const Bytef *)"x", 1);
+    unsigned long cdSize = 0;
+    size_t nameLen = 0;
+    unsigned long i = 0;
+    const long cdOffset = 30 + 1 + 1;
+
+    memset(hdr, 0, sizeof(hdr));
+    putLE32(hdr, 0x04034b50);
+    putLE16(hdr + 4, 20);
+    putLE32(hdr + 14, crc);
+    putLE32(hdr + 18, 1);
+    putLE32(hdr + 22, 1);
+    putLE16(hdr + 26, 1);
+    if (fwrite(hdr, 1, 30, fp) != 30 || fwrite("ax", 1, 2, fp) != 2)
+    {
+        return gHostileErr;
+    }
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        hostileName(spec, "dup", i, name, sizeof(name));
+        nameLen = strlen(name);
+
+        memset(hdr, 0, sizeof(hdr));
+        putLE32(hdr, 0x02014b50);
+        putLE16(hdr + 4, 0x0314);
+        putLE16(hdr + 6, 20);
+        putLE32(hdr + 16, crc);
+        putLE32(hdr + 20, 1);
+        putLE32(hdr + 24, 1);
+        putLE16(hdr + 28, (uint16_t)nameLen);
+        putLE32(hdr + 38, 0100644UL << 16);
+        putLE32(hdr + 42, 0);
+        if (fwrite(hdr, 1, sizeof(hdr), fp) != sizeof(hdr) ||
+            fwrite(name, 1, nameLen, fp) != nameLen)
+        {
+            return gHostileErr;
+        }
+        cdSize += sizeof(hdr) + nameLen;
+    }
+
+    memset(hdr, 0, sizeof(hdr));
+    putLE32(hdr, 0x06054b50);
+    putLE16(hdr + 8, (uint16_t)(spec->numEntries > 0xffff ?
+                                0xffff : spec->numEntries));
+    putLE16(hdr + 10, (uint16_t)(spec->numEntries > 0xffff ?
+                                 0xffff : spec->numEntries));
+    putLE32(hdr + 12, (uint32_t)cdSize);
+    putLE32(hdr + 16, (uint32_t)cdOffset);
+
+    return (fwrite(hdr, 1, 22, fp) == 22 ? gHostileOkay : gHostileErr);
+}
+
+/* isoDirRecord - fill in an ISO 9660 directory record */
+
+static void isoDirRecord(unsigned char *rec,
+                         size_t recLen,
+                         uint32_t location,
+                         uint32_t size,
+                         int flags,
+                         const char *name,
+                         size_t nameLen)
+{
+    memset(rec, 0, recLen);
+    rec[0] = (unsigned char)recLen;
+    putBoth32(rec + 2, location);
+    putBoth32(rec + 10, size);
+    rec[25] = (unsigned char)flags;
+    putBoth16(rec + 28, 1);
+    rec[32] = (unsigned char)nameLen;
+    memcpy(rec + 33, name, nameLen);
+}
+
+/* isoCE - fill in a SUSP "CE" continuation entry */
+
+static void isoCE(unsigned char *buf,
+                  uint32_t location,
+                  uint32_t offset,
+                  uint32_t size)
+{
+    memcpy(buf, "CE", 2);
+    buf[2] = ISOCELEN;
+    buf[3] = 1;
+    putBoth32(buf + 4, location);
+    putBoth32(buf + 12, offset);
+    putBoth32(buf + 20, size);
+}
+
+/*
+    writeIsoCE - write an ISO 9660 image with n files in the root
+                 directory, each with its Rock Ridge name in a "CE"
+                 continuation area in the blocks that follow the
+                 directory; the last file's area has a "CE" that
+                 points back to itself
+*/
+
+static int writeIsoCE(const hostileSpec_t *spec, FILE *fp)
+{
+    unsigned char block[ISOBLOCK];
+    unsigned char rec[ISORECLEN];
+    char name[HOSTILENAMEMAX + 32];
+    char isoName[16];
+    unsigned long perBlock = (ISOBLOCK - 46 - 34) / ISORECLEN;
+    unsigned long areaLen = 5 + spec->nameLen + ISOCELEN;
+    unsigned long areasPerBlock = 0;
+    unsigned long dirBlocks = 0;
+    unsigned long ceBlocks = 0;
+    unsigned long volBlocks = 0;
+    unsigned long used = 0;
+    unsigned long i = 0;
+    uint32_t ceBlock = 0;
+    uint32_t ceOffset = 0;
+
+    if (spec->nameLen > HOSTILENAMEMAX || spec->numEntries == 0)
+    {
+        return gHostileErr;
+    }
+
+    areasPerBlock = ISOBLOCK / areaLen;
+    dirBlocks = (spec->numEntries + perBlock - 1) / perBlock;
+    ceBlocks = (spec->numEntries + areasPerBlock - 1) / areasPerBlock;
+    volBlocks = ISODIRBLOCK + dirBlocks + ceBlocks + 1;
+
+    /* system area, then the primary volume descriptor */
+
+    if (writePad(fp, ISOSYSTEMAREA * ISOBLOCK) != gHostileOkay)
+    {
+        return gHostileErr;
+    }
+
+    memset(block, 0, sizeof(block));
+    block[0] = 1;
+    memcpy(block + 1, "CD001", 5);
+    block[6] = 1;
+    memset(block + 8, ' ', 64);
+    putBoth32(block + 80, (uint32_t)volBlocks);
+    putBoth16(block + 120, 1);
+    putBoth16(block + 124, 1);
+    putBoth16(block + 128, ISOBLOCK);
+    putBoth32(block + 132, 10);
+    putLE32(block + 140, ISOSYSTEMAREA + 2);
+    isoDirRecord(block + 156, 34, ISODIRBLOCK,
+                 (uint32_t)(dirBlocks * ISOBLOCK), 2, "\0", 1);
+    block[881] = 1;
+    if (fwrite(block, 1, sizeof(block), fp) != sizeof(block))
+    {
+        return gHostileErr;
+    }
+
+    /* volume descriptor set terminator */
+
+    memset(block, 0, sizeof(block));
+    block[0] = 255;
+    memcpy(block + 1, "CD001", 5);
+    block[6] = 1;
+    if (fwrite(block, 1, sizeof(block), fp) != sizeof(block))
+    {
+        return gHostileErr;
+    }
+
+    /* type L path table with just the root */
+
+    memset(block, 0, sizeof(block));
+    block[0] = 1;
+    putLE32(block + 2, ISODIRBLOCK);
+    putLE16(block + 6, 1);
+    if (fwrite(block, 1, sizeof(block), fp) != sizeof(block))
+    {
+        return gHostileErr;
+    }
+
+    /*
+        root directory: "." carries the SUSP "SP" entry that enables
+        Rock Ridge (and an "RR" entry, as its system use area must
+        have one), then each file's record holds only a "CE"
+    */
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        if (i % perBlock == 0)
+        {
+            if (i > 0 &&
+                fwrite(block, 1, sizeof(block), fp) != sizeof(block))
+            {
+                return gHostileErr;
+            }
+            memset(block, 0, sizeof(block));
+            used = 0;
+
+            if (i == 0)
+            {
+                isoDirRecord(block, 46, ISODIRBLOCK,
+                             (uint32_t)(dirBlocks * ISOBLOCK), 2, "\0", 1);
+                memcpy(block + 34, "SP\x07\x01\xbe\xef\x00", 7);
+                memcpy(block + 41, "RR\x05\x01\x89", 5);
+                isoDirRecord(block + 46, 34, ISODIRBLOCK,
+                             (uint32_t)(dirBlocks * ISOBLOCK), 2, "\1", 1);
+                used = 46 + 34;
+            }
+        }
+
+        snprintf(isoName, sizeof(isoName), "F%07lu;1", i % 10000000);
+        isoDirRecord(rec, ISORECLEN, 0, 0, 0, isoName, strlen(isoName));
+        ceBlock = (uint32_t)(ISODIRBLOCK + dirBlocks + i / areasPerBlock);
+        ceOffset = (uint32_t)((i % areasPerBlock) * areaLen);
+        isoCE(rec + ISORECLEN - ISOCELEN, ceBlock, ceOffset,
+              (uint32_t)areaLen);
+        memcpy(block + used, rec, ISORECLEN);
+        used += ISORECLEN;
+    }
+    if (fwrite(block, 1, sizeof(block), fp) != sizeof(block))
+    {
+        return gHostileErr;
+    }
+
+    /*
+        continuation areas: an "NM" with the file's name, then a "CE"
+        that ends the chain ("ST"), except for the last file, whose
+        "CE" points back to its own area
+    */
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        if (i % areasPerBlock == 0)
+        {
+            if (i > 0 &&
+                fwrite(block, 1, sizeof(block), fp) != sizeof(block))
+            {
+                return gHostileErr;
+            }
+            memset(block, 0, sizeof(block));
+        }
+
+        ceBlock = (uint32_t)(ISODIRBLOCK + dirBlocks + i / areasPerBlock);
+        ceOffset = (uint32_t)((i % areasPerBlock) * areaLen);
+        hostileName(spec, "name", i, name, sizeof(name));
+        name[spec->nameLen] = '\0';
+
+        memcpy(block + ceOffset, "NM", 2);
+        block[ceOffset + 2] = (unsigned char)(5 + strlen(name));
+        block[ceOffset + 3] = 1;
+        block[ceOffset + 4] = 0;
+        memcpy(block + ceOffset + 5, name, strlen(name));
+
+        if (i + 1 == spec->numEntries)
+        {
+            isoCE(block + ceOffset + 5 + strlen(name),
+                  ceBlock, ceOffset, (uint32_t)areaLen);
+        }
+        else
+        {
+            memcpy(block + ceOffset + 5 + strlen(name), "ST\x04\x01", 4);
+        }
+    }
+    if (fwrite(block, 1, sizeof(block), fp) != sizeof(block))
+    {
+        return gHostileErr;
+    }
+
+    return writePad(fp, ISOBLOCK);
+}
+
+/* bufAppend - append str to buf */
+
+static int bufAppend(hostileBuf_t *buf, const char *str)
+{
+    size_t len = strlen(str);
+    char *data = NULL;
+
+    if (buf->len + len + 1 > buf->size)
+    {
+        buf->size = (buf->size == 0 ? 65536 : buf->size);
+        while (buf->len + len + 1 > buf->size)
+        {
+            buf->size *= 2;
+        }
+        data = realloc(buf->data, buf->size);
+        if (data == NULL)
+        {
+            return gHostileErr;
+        }
+        buf->data = data;
+    }
+
+    memcpy(buf->data + buf->len, str, len + 1);
+    buf->len += len;
+
+    return gHostileOkay;
+}
+
+/*
+    writeXarDeep - write a xar whose TOC holds n directories as
+                   chains nested spec->depth deep
+*/
+
+static int writeXarDeep(const hostileSpec_t *spec, FILE *fp)
+{
+    hostileBuf_t toc;
+    unsigned char hdr[XARHEADERSIZE];
+    char name[HOSTILENAMEMAX + 32];
+    char elem[HOSTILENAMEMAX + 128];
+    unsigned char *out = NULL;
+    uLongf outLen = 0;
+    unsigned long depth = (spec->depth == 0 ? 1 : spec->depth);
+    unsigned long nested = 0;
+    unsigned long i = 0;
+    int ret = gHostileErr;
+
+    memset(&toc, 0, sizeof(toc));
+
+    if (bufAppend(&toc, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                        "<xar><toc>\n") != gHostileOkay)
+    {
+        goto done;
+    }
+
+    for (i = 0; i < spec->numEntries; i++)
+    {
+        hostileName(spec, "d", i, name, sizeof(name));
+        snprintf(elem, sizeof(elem),
+                 "<file id=\"%lu\"><name>%s</name>"
+                 "<type>directory</type><mode>0755</mode>\n",
+                 i + 1, name);
+        if (bufAppend(&toc, elem) != gHostileOkay)
+        {
+            goto done;
+        }
+        nested++;
+
+        if (nested == depth || i + 1 == spec->numEntries)
+        {
+            for (; nested > 0; nested--)
+            {
+                if (bufAppend(&toc, "</file>") != gHostileOkay)
+                {
+                    goto done;
+                }
+            }
+            if (bufAppend(&toc, "\n") != gHostileOkay)
+            {
+                goto done;
+            }
+        }
+    }
+
+    if (bufAppend(&toc, "</toc></xar>\n") != gHostileOkay)
+    {
+        goto done;
+    }
+
+    outLen = compressBound((uLong)toc.len);
+    out = malloc(outLen);
+    if (out == NULL ||
+        compress2(out, &outLen, (const Bytef *)toc.data,
+                  (uLong)toc.len, 6) != Z_OK)
+    {
+        goto done;
+    }
+
+    /* header with no TOC checksum */
+
+    memset(hdr, 0, sizeof(hdr));
+    putBE32(hdr, 0x78617221);
+    putBE16(hdr + 4, XARHEADERSIZE);
+    putBE16(hdr + 6, 1);
+    putBE32(hdr + 8, (uint32_t)((uint64_t)outLen >> 32));
+    putBE32(hdr + 12, (uint32_t)outLen);
+    putBE32(hdr + 16, (uint32_t)((uint64_t)toc.len >> 32));
+    putBE32(hdr + 20, (uint32_t)toc.len);
+    putBE32(hdr + 24, 0);
+
+    if (fwrite(hdr, 1, sizeof(hdr), fp) == sizeof(hdr) &&
+        fwrite(out, 1, outLen, fp) == outLen)
+    {
+        ret = gHostileOkay;
+    }
+
+done:
+    free(out);
+    free(toc.data);
+
+    return ret;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: mkhostile [-n entries] [-l name length] [-d depth]\n"
+            "                 [tarext|paxbig|zipdup|isoce|xardeep] "
+            "[output]\n");
+}
+
+int main(int argc, char **argv)
+{
+    hostileSpec_t spec;
+    const char *format = NULL;
+    const char *output = NULL;
+    FILE *fp = NULL;
+    int ret = gHostileErr;
+    int i = 0;
+
+    spec.numEntries = 1000;
+    spec.nameLen = 200;
+    spec.depth = 64;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (argv[i][0] == '-' && argv[i][1] != '\0' &&
+            argv[i][2] == '\0' && i + 1 < argc)
+        {
+            switch (argv[i][1])
+            {
+                case 'n':
+                    spec.numEntries = strtoul(argv[++i], NULL, 10);
+                    continue;
+                case 'l':
+                    spec.nameLen = strtoul(argv[++i], NULL, 10);
+                    continue;
+                case 'd':
+                    spec.depth = strtoul(argv[++i], NULL, 10);
+                    continue;
+                default:
+                    break;
+            }
+        }
+
+        if (format == NULL)
+        {
+            format = argv[i];
+        }
+        else if (output == NULL)
+        {
+            output = argv[i];
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (format == NULL || output == NULL)
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (spec.nameLen > HOSTILENAMEMAX)
+    {
+        spec.nameLen = HOSTILENAMEMAX;
+    }
+
+    fp = fopen(output, "wb");
+    if (fp == NULL)
+    {
+        fprintf(stderr,
+                "mkhostile: ERROR: cannot create '%s': %s\n",
+                output,
+                strerror(errno));
+        return 1;
+    }
+
+    if (strcmp(format, "tarext") == 0)
+    {
+        ret = writeTarExt(&spec, fp);
+    }
+    else if (strcmp(format, "paxbig") == 0)
+    {
+        ret = writePaxBig(&spec, fp);
+    }
+    else if (strcmp(format, "zipdup") == 0)
+    {
+        ret = writeZipDup(&spec, fp);
+    }
+    else if (strcmp(format, "isoce") == 0)
+    {
+        ret = writeIsoCE(&spec, fp);
+    }
+    else if (strcmp(format, "xardeep") == 0)
+    {
+        ret = writeXarDeep(&spec, fp);
+    }
+    else
+    {
+        printUsage();
+    }
+
+    if (fclose(fp) != 0)
+    {
+        ret = gHostileErr;
+    }
+
+    if (ret != gHostileOkay)
+    {
+        fprintf(stderr, "mkhostile: ERROR: cannot write '%s'\n", output);
+        remove(output);
+        return 1;
+    }
+
+    return 0;
+}
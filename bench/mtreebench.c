@@ -0,0 +1,566 @@
+/*
+    mtreebench.c - benchmark listing mtree manifests
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://man.freebsd.org/cgi/man.cgi?query=mtree&sektion=5
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    mtreebench lists each of the given mtree manifests with libarchive's
+    mtree reader, calling archive_read_next_header() for every entry,
+    as the preview does, and reports, as JSON, for each manifest:
+
+        manifest, bytes - the manifest and its size
+        lines           - the number of lines
+        entries         - the number of entries
+        wallMs          - the median wall time to list it
+        linesPerSec     - lines / wallMs
+        bytesRead       - the bytes read from the manifest
+
+    The manifest is listed repeatedly (-r), after one warm up run that
+    is not counted.  With -m, mtreebench instead writes a manifest of
+    the given number of files, in directories of BENCHDIRFILES files,
+    in one of two forms:
+
+        metalog - one line per file or directory with its full path
+                  and all of its keywords, like the METALOG of a
+                  FreeBSD NO_ROOT build that its dist sets are made
+                  from
+        spec    - /set defaults, and relative names under each
+                  directory, closed with "..", like the output of
+                  mtree -c
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHBLOCKSIZE 65536
+#define BENCHDIRFILES  50
+#define BENCHMTIME     1700000000UL
+#define BENCHSEED      0x9E3779B97F4A7C15ULL
+
+/* the file read by libarchive, and the bytes read from it */
+
+typedef struct benchFile
+{
+    int fd;
+    uint64_t bytesRead;
+    unsigned char buf[BENCHBLOCKSIZE];
+} benchFile_t;
+
+/* the result of one manifest */
+
+typedef struct benchRun
+{
+    const char *manifest;
+    uint64_t bytes;
+    uint64_t lines;
+    uint64_t entries;
+    uint64_t bytesRead;
+    double wallMs;
+} benchRun_t;
+
+/* globals */
+
+static const char *gDirs[] =
+{
+    "usr/bin",
+    "usr/lib",
+    "usr/lib/debug/usr/lib",
+    "usr/include/sys",
+    "usr/share/man/man3",
+    "usr/share/locale/en_US.UTF-8",
+    "usr/src/sys/dev/e1000",
+    "usr/tests/lib/libc/string",
+};
+
+static const char *gPackages[] =
+{
+    "runtime",
+    "utilities",
+    "development",
+    "debug",
+};
+
+/* private functions */
+
+static la_ssize_t benchReadCallback(struct archive *a,
+                                    void *data,
+                                    const void **buf);
+static int benchPutDigest(FILE *fp, uint64_t *state);
+static int benchMakeManifest(const char *path,
+                             unsigned long numFiles,
+                             const char *form);
+static uint64_t benchCountLines(const char *path);
+static int benchList(benchRun_t *run);
+static void printUsage(void);
+
+/* benchReadCallback - read the next block of the manifest */
+
+static la_ssize_t benchReadCallback(struct archive *a,
+                                    void *data,
+                                    const void **buf)
+{
+    benchFile_t *file = data;
+    ssize_t bytesRead = 0;
+
+    (void)a;
+
+    do
+    {
+        bytesRead = read(file->fd, file->buf, sizeof(file->buf));
+    } while (bytesRead < 0 && errno == EINTR);
+
+    if (bytesRead > 0)
+    {
+        file->bytesRead += (uint64_t)bytesRead;
+    }
+
+    *buf = file->buf;
+
+    return bytesRead;
+}
+
+/* benchPutDigest - write a random sha256digest keyword */
+
+static int benchPutDigest(FILE *fp, uint64_t *state)
+{
+    int i = 0;
+
+    if (fputs(" sha256digest=", fp) == EOF)
+    {
+        return gBenchErr;
+    }
+
+    for (i = 0; i < 4; i++)
+    {
+        if (fprintf(fp,
+                    "%016llx",
+                    (unsigned long long)benchRand(state)) < 0)
+        {
+            return gBenchErr;
+        }
+    }
+
+    return gBenchOkay;
+}
+
+/*
+    benchMakeManifest - write a manifest of numFiles files, in the
+                        metalog or spec form
+*/
+
+static int benchMakeManifest(const char *path,
+                             unsigned long numFiles,
+                             const char *form)
+{
+    FILE *fp = NULL;
+    uint64_t state = BENCHSEED;
+    unsigned long i = 0;
+    unsigned long dir = 0;
+    size_t numDirs = sizeof(gDirs) / sizeof(gDirs[0]);
+    int spec = 0;
+    int ret = gBenchErr;
+
+    if (strcmp(form, "spec") == 0)
+    {
+        spec = 1;
+    }
+    else if (strcmp(form, "metalog") != 0)
+    {
+        printUsage();
+        return gBenchErr;
+    }
+
+    fp = fopen(path, "w");
+    if (fp == NULL)
+    {
+        fprintf(stderr,
+                "mtreebench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        return gBenchErr;
+    }
+
+    if (fputs("#mtree 2.0\n", fp) == EOF ||
+        (spec &&
+         fprintf(fp,
+                 "/set type=file uname=root gname=wheel mode=0444 "
+                 "nlink=1 flags=none\n"
+                 ". type=dir mode=0755 time=%lu.0\n",
+                 BENCHMTIME) < 0))
+    {
+        goto done;
+    }
+
+    for (i = 0; i < numFiles; i++)
+    {
+        dir = i / BENCHDIRFILES;
+
+        /* each directory, before its files */
+
+        if (i % BENCHDIRFILES == 0)
+        {
+            if (spec)
+            {
+                if ((dir > 0 && fputs("..\n", fp) == EOF) ||
+                    fprintf(fp,
+                            "d%lu type=dir mode=0755 time=%lu.0\n",
+                            dir,
+                            BENCHMTIME) < 0)
+                {
+                    goto done;
+                }
+            }
+            else if (fprintf(fp,
+                             "./%s/d%lu type=dir uname=root "
+                             "gname=wheel mode=0755 tags=package=%s\n",
+                             gDirs[dir % numDirs],
+                             dir,
+                             gPackages[dir % 4]) < 0)
+            {
+                goto done;
+            }
+        }
+
+        if (spec)
+        {
+            if (fprintf(fp,
+                        "    file%lu.so.%lu size=%llu time=%lu.%09lu",
+                        i,
+                        i % 7,
+                        (unsigned long long)(benchRand(&state) % 1000000),
+                        BENCHMTIME + i % 86400,
+                        i % 1000000000UL) < 0)
+            {
+                goto done;
+            }
+        }
+        else if (fprintf(fp,
+                         "./%s/d%lu/file%lu.so.%lu type=file uname=root "
+                         "gname=wheel mode=0444 size=%llu time=%lu.%09lu",
+                         gDirs[dir % numDirs],
+                         dir,
+                         i,
+                         i % 7,
+                         (unsigned long long)(benchRand(&state) % 1000000),
+                         BENCHMTIME + i % 86400,
+                         i % 1000000000UL) < 0)
+        {
+            goto done;
+        }
+
+        if (benchPutDigest(fp, &state) != gBenchOkay ||
+            (!spec &&
+             fprintf(fp, " tags=package=%s", gPackages[dir % 4]) < 0) ||
+            fputc('\n', fp) == EOF)
+        {
+            goto done;
+        }
+    }
+
+    if (spec && numFiles > 0 && fputs("..\n", fp) == EOF)
+    {
+        goto done;
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (fclose(fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    if (ret != gBenchOkay)
+    {
+        fprintf(stderr, "mtreebench: ERROR: cannot write '%s'\n", path);
+    }
+
+    return ret;
+}
+
+/* benchCountLines - count the lines of a manifest */
+
+static uint64_t benchCountLines(const char *path)
+{
+    FILE *fp = NULL;
+    uint64_t lines = 0;
+    int c = 0;
+
+    fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        return 0;
+    }
+
+    while ((c = getc(fp)) != EOF)
+    {
+        if (c == '\n')
+        {
+            lines++;
+        }
+    }
+
+    fclose(fp);
+
+    return lines;
+}
+
+/* benchList - list every entry of run->manifest */
+
+static int benchList(benchRun_t *run)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    benchFile_t *file = NULL;
+    int r = ARCHIVE_OK;
+    int ret = gBenchErr;
+
+    file = calloc(1, sizeof(benchFile_t));
+    a = archive_read_new();
+    if (file == NULL || a == NULL)
+    {
+        goto done;
+    }
+
+    file->fd = open(run->manifest, O_RDONLY | O_CLOEXEC);
+    if (file->fd < 0)
+    {
+        fprintf(stderr,
+                "mtreebench: ERROR: cannot open '%s': %s\n",
+                run->manifest,
+                strerror(errno));
+        goto done;
+    }
+
+    archive_read_support_format_mtree(a);
+    archive_read_set_callback_data(a, file);
+    archive_read_set_read_callback(a, benchReadCallback);
+
+    if (archive_read_open1(a) != ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "mtreebench: ERROR: cannot open '%s': %s\n",
+                run->manifest,
+                archive_error_string(a));
+        goto done;
+    }
+
+    run->entries = 0;
+
+    while ((r = archive_read_next_header(a, &entry)) == ARCHIVE_OK)
+    {
+        run->entries++;
+    }
+
+    if (r != ARCHIVE_EOF)
+    {
+        fprintf(stderr,
+                "mtreebench: ERROR: cannot list '%s': %s\n",
+                run->manifest,
+                archive_error_string(a));
+        goto done;
+    }
+
+    run->bytesRead = file->bytesRead;
+    ret = gBenchOkay;
+
+done:
+    if (a != NULL)
+    {
+        archive_read_free(a);
+    }
+    if (file != NULL && file->fd >= 0)
+    {
+        close(file->fd);
+    }
+    free(file);
+
+    return ret;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: mtreebench [-r repetitions] [-o output.json] "
+            "manifest ...\n"
+            "       mtreebench -m files metalog|spec manifest\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t *runs = NULL;
+    const char *output = NULL;
+    double times[BENCHMAXREPS];
+    struct stat sb;
+    uint64_t start = 0;
+    unsigned long makeCount = 0;
+    FILE *fp = stdout;
+    int numRuns = 0;
+    int numReps = 3;
+    int run = 0;
+    int r = 0;
+    int i = 1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeCount = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeCount > 0)
+    {
+        if (i + 2 != argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeManifest(argv[i + 1], makeCount, argv[i]) ==
+                gBenchOkay ? 0 : 1);
+    }
+
+    if (i >= argc || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    numRuns = argc - i;
+    runs = calloc((size_t)numRuns, sizeof(benchRun_t));
+    if (runs == NULL)
+    {
+        return 1;
+    }
+
+    /* the first repetition is a warm up */
+
+    for (run = 0; run < numRuns; run++)
+    {
+        runs[run].manifest = argv[i + run];
+        if (stat(runs[run].manifest, &sb) == 0)
+        {
+            runs[run].bytes = (uint64_t)sb.st_size;
+        }
+        runs[run].lines = benchCountLines(runs[run].manifest);
+
+        for (r = -1; r < numReps; r++)
+        {
+            start = benchNow();
+            if (benchList(&runs[run]) != gBenchOkay)
+            {
+                free(runs);
+                return 1;
+            }
+            if (r >= 0)
+            {
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+            }
+        }
+
+        runs[run].wallMs = benchMedian(times, numReps);
+    }
+
+    fp = benchOpenOutput("mtreebench", output);
+    if (fp == NULL)
+    {
+        free(runs);
+        return 1;
+    }
+
+    fprintf(fp, "{\n  \"runs\": [\n");
+
+    for (run = 0; run < numRuns; run++)
+    {
+        fprintf(fp,
+                "    {\"manifest\": \"%s\", \"bytes\": %llu, "
+                "\"lines\": %llu, \"entries\": %llu,\n"
+                "     \"wallMs\": %.1f, \"linesPerSec\": %.0f, "
+                "\"bytesRead\": %llu}%s\n",
+                runs[run].manifest,
+                (unsigned long long)runs[run].bytes,
+                (unsigned long long)runs[run].lines,
+                (unsigned long long)runs[run].entries,
+                runs[run].wallMs,
+                (runs[run].wallMs > 0 ?
+                 (double)runs[run].lines * 1000.0 / runs[run].wallMs : 0),
+                (unsigned long long)runs[run].bytesRead,
+                (run + 1 < numRuns ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    if (benchCloseOutput(fp) != 0)
+    {
+        free(runs);
+        return 1;
+    }
+
+    free(runs);
+
+    return 0;
+}
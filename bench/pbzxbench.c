@@ -0,0 +1,586 @@
+/*
+    pbzxbench.c - benchmark listing a package's pbzx payload
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    pbzxbench lists the entries of a pbzx payload (the Payload of a
+    flat package, or the Content of an .xip) with libarchive's pbzx
+    filter and cpio reader, with each of the given numbers of threads
+    (-j, a comma separated list, 1,2,4 by default, set with the
+    "pbzx:threads" option), and reports, as JSON:
+
+        entries, bytes - the payload's entries and decoded bytes
+        runs           - for each number of threads, the median wall
+                         time (wallMs), the decoded MB per second and
+                         the speed up over the first run
+
+    Each run is repeated (-r), after one warm up run that is not
+    counted.  With -m, pbzxbench instead writes a payload of size MB
+    of files of BENCHMINFILE to BENCHMAXFILE bytes, as an odc cpio
+    archive in pbzx chunks of BENCHCHUNK bytes, each compressed with
+    xz at BENCHPRESET.  The files are text from a 16 letter alphabet,
+    so that they compress to about half of their size.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <lzma.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHMAXRUNS   16
+#define BENCHMAXTHREADS 16
+#define BENCHMINFILE   (4 * 1024)
+#define BENCHMAXFILE   (1024 * 1024)
+#define BENCHCHUNK     (16 * 1024 * 1024)
+#define BENCHPRESET    6
+
+/* the result of one number of threads */
+
+typedef struct benchRun
+{
+    int threads;
+    double wallMs;
+} benchRun_t;
+
+/* a payload being written */
+
+typedef struct benchPayload
+{
+    FILE *fp;
+    unsigned char *chunk;
+    size_t chunkLen;
+    unsigned char *xz;
+    size_t xzLen;
+} benchPayload_t;
+
+/* private functions */
+
+static void benchPut64(unsigned char *p, uint64_t v);
+static int benchFlush(benchPayload_t *payload);
+static int benchWrite(benchPayload_t *payload,
+                      const void *data,
+                      size_t len);
+static int benchWriteHeader(benchPayload_t *payload,
+                            const char *name,
+                            unsigned int mode,
+                            uint64_t size);
+static int benchMakePayload(const char *path, unsigned long sizeMB);
+static int benchList(const char *path,
+                     int threads,
+                     uint64_t *entries,
+                     uint64_t *bytes);
+static int benchParseThreads(const char *list, benchRun_t *runs);
+static void printUsage(void);
+
+/* benchPut64 - put a big endian 64 bit value */
+
+static void benchPut64(unsigned char *p, uint64_t v)
+{
+    int i = 0;
+
+    for (i = 7; i >= 0; i--)
+    {
+        p[i] = (unsigned char)v;
+        v >>= 8;
+    }
+}
+
+/*
+    benchFlush - compress the current chunk and write it, with its
+                 header, to the payload; a chunk that doesn't
+                 compress is written as is
+*/
+
+static int benchFlush(benchPayload_t *payload)
+{
+    unsigned char header[16];
+    size_t xzPos = 0;
+
+    if (payload->chunkLen == 0)
+    {
+        return gBenchOkay;
+    }
+
+    if (lzma_easy_buffer_encode(BENCHPRESET,
+                                LZMA_CHECK_CRC64,
+                                NULL,
+                                payload->chunk,
+                                payload->chunkLen,
+                                payload->xz,
+                                &xzPos,
+                                payload->xzLen) != LZMA_OK ||
+        xzPos >= payload->chunkLen)
+    {
+        xzPos = 0;
+    }
+
+    benchPut64(header, payload->chunkLen);
+    benchPut64(header + 8, (xzPos > 0 ? xzPos : payload->chunkLen));
+
+    if (fwrite(header, 1, sizeof(header), payload->fp) != sizeof(header) ||
+        (xzPos > 0 ?
+         fwrite(payload->xz, 1, xzPos, payload->fp) != xzPos :
+         fwrite(payload->chunk, 1, payload->chunkLen, payload->fp) !=
+            payload->chunkLen))
+    {
+        return gBenchErr;
+    }
+
+    payload->chunkLen = 0;
+
+    return gBenchOkay;
+}
+
+/* benchWrite - add data to the payload's chunks */
+
+static int benchWrite(benchPayload_t *payload,
+                      const void *data,
+                      size_t len)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    size_t n = 0;
+
+    while (len > 0)
+    {
+        n = BENCHCHUNK - payload->chunkLen;
+        if (n > len)
+        {
+            n = len;
+        }
+
+        memcpy(payload->chunk + payload->chunkLen, p, n);
+        payload->chunkLen += n;
+        p += n;
+        len -= n;
+
+        if (payload->chunkLen == BENCHCHUNK &&
+            benchFlush(payload) != gBenchOkay)
+        {
+            return gBenchErr;
+        }
+    }
+
+    return gBenchOkay;
+}
+
+/* benchWriteHeader - add an odc cpio header to the payload */
+
+static int benchWriteHeader(benchPayload_t *payload,
+                            const char *name,
+                            unsigned int mode,
+                            uint64_t size)
+{
+    char header[77];
+    static unsigned long ino = 0;
+
+    snprintf(header,
+             sizeof(header),
+             "070707%06o%06lo%06o%06o%06o%06o%06o%011lo%06o%011llo",
+             0,
+             (++ino & 0777777),
+             mode,
+             0,
+             0,
+             1,
+             0,
+             1760659200UL,
+             (unsigned int)(strlen(name) + 1),
+             (unsigned long long)size);
+
+    if (benchWrite(payload, header, 76) != gBenchOkay ||
+        benchWrite(payload, name, strlen(name) + 1) != gBenchOkay)
+    {
+        return gBenchErr;
+    }
+
+    return gBenchOkay;
+}
+
+/*
+    benchMakePayload - write a pbzx payload of an odc cpio archive of
+                       sizeMB of files to path
+*/
+
+static int benchMakePayload(const char *path, unsigned long sizeMB)
+{
+    static const char alphabet[] = "abcdefghijklmnop";
+    benchPayload_t payload;
+    unsigned char header[12];
+    unsigned char *data = NULL;
+    char name[64];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint64_t remaining = (uint64_t)sizeMB * 1024 * 1024;
+    uint64_t bits = 0;
+    size_t size = 0;
+    size_t j = 0;
+    unsigned long i = 0;
+    int ret = gBenchErr;
+
+    memset(&payload, 0, sizeof(payload));
+
+    payload.fp = fopen(path, "wb");
+    if (payload.fp == NULL)
+    {
+        fprintf(stderr,
+                "pbzxbench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        return gBenchErr;
+    }
+
+    payload.chunk = malloc(BENCHCHUNK);
+    payload.xzLen = lzma_stream_buffer_bound(BENCHCHUNK);
+    payload.xz = malloc(payload.xzLen);
+    data = malloc(BENCHMAXFILE);
+    if (payload.chunk == NULL || payload.xz == NULL || data == NULL)
+    {
+        goto done;
+    }
+
+    memcpy(header, "pbzx", 4);
+    benchPut64(header + 4, BENCHCHUNK);
+    if (fwrite(header, 1, sizeof(header), payload.fp) != sizeof(header))
+    {
+        goto done;
+    }
+
+    for (i = 0; remaining > 0; i++)
+    {
+        if (i % 100 == 0)
+        {
+            snprintf(name, sizeof(name), "./%04lu", i / 100);
+            if (benchWriteHeader(&payload, name, 040755, 0) != gBenchOkay)
+            {
+                goto done;
+            }
+        }
+
+        size = BENCHMINFILE +
+               (size_t)(benchRand(&state) %
+                        (BENCHMAXFILE - BENCHMINFILE + 1));
+        if (size > remaining)
+        {
+            size = (size_t)remaining;
+        }
+
+        for (j = 0; j < size; j++)
+        {
+            if (j % 16 == 0)
+            {
+                bits = benchRand(&state);
+            }
+            data[j] = (unsigned char)alphabet[bits & 15];
+            bits >>= 4;
+        }
+
+        snprintf(name, sizeof(name), "./%04lu/%06lu.txt", i / 100, i);
+        if (benchWriteHeader(&payload, name, 0100644, size) != gBenchOkay ||
+            benchWrite(&payload, data, size) != gBenchOkay)
+        {
+            goto done;
+        }
+
+        remaining -= size;
+    }
+
+    if (benchWriteHeader(&payload, "TRAILER!!!", 0, 0) != gBenchOkay ||
+        benchFlush(&payload) != gBenchOkay)
+    {
+        goto done;
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (fclose(payload.fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    if (ret != gBenchOkay)
+    {
+        fprintf(stderr, "pbzxbench: ERROR: cannot write '%s'\n", path);
+        remove(path);
+    }
+
+    free(data);
+    free(payload.xz);
+    free(payload.chunk);
+
+    return ret;
+}
+
+/*
+    benchList - list the entries of the payload at path with the given
+                number of threads
+*/
+
+static int benchList(const char *path,
+                     int threads,
+                     uint64_t *entries,
+                     uint64_t *bytes)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    char value[16];
+    int r = ARCHIVE_OK;
+    int ret = gBenchErr;
+
+    *entries = 0;
+    *bytes = 0;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return gBenchErr;
+    }
+
+    archive_read_support_filter_pbzx(a);
+    archive_read_support_format_cpio(a);
+
+    snprintf(value, sizeof(value), "%d", threads);
+    if (archive_read_set_filter_option(a,
+                                       "pbzx",
+                                       "threads",
+                                       value) != ARCHIVE_OK ||
+        archive_read_open_filename(a, path, 65536) != ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "pbzxbench: ERROR: %s\n",
+                archive_error_string(a));
+        archive_read_free(a);
+        return gBenchErr;
+    }
+
+    for (;;)
+    {
+        r = archive_read_next_header(a, &entry);
+        if (r == ARCHIVE_EOF)
+        {
+            ret = gBenchOkay;
+            break;
+        }
+        if (r < ARCHIVE_WARN)
+        {
+            fprintf(stderr,
+                    "pbzxbench: ERROR: %s\n",
+                    archive_error_string(a));
+            break;
+        }
+
+        (*entries)++;
+    }
+
+    *bytes = (uint64_t)archive_filter_bytes(a, 0);
+
+    archive_read_free(a);
+
+    return ret;
+}
+
+/*
+    benchParseThreads - parse a comma separated list of numbers of
+                        threads; returns the number of runs
+*/
+
+static int benchParseThreads(const char *list, benchRun_t *runs)
+{
+    char *end = NULL;
+    long n = 0;
+    int numRuns = 0;
+
+    while (*list != '\0' && numRuns < BENCHMAXRUNS)
+    {
+        n = strtol(list, &end, 10);
+        if (end == list || n < 1 || n > BENCHMAXTHREADS ||
+            (*end != ',' && *end != '\0'))
+        {
+            return 0;
+        }
+
+        memset(&runs[numRuns], 0, sizeof(benchRun_t));
+        runs[numRuns].threads = (int)n;
+        numRuns++;
+
+        list = (*end == ',' ? end + 1 : end);
+    }
+
+    return numRuns;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: pbzxbench [-j threads,...] [-r repetitions] "
+            "[-o output.json] payload\n"
+            "       pbzxbench -m size payload\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t runs[BENCHMAXRUNS];
+    const char *output = NULL;
+    double times[BENCHMAXREPS];
+    uint64_t start = 0;
+    uint64_t entries = 0;
+    uint64_t bytes = 0;
+    unsigned long makeMB = 0;
+    FILE *fp = stdout;
+    int numReps = 3;
+    int numRuns = 0;
+    int ret = 1;
+    int run = 0;
+    int r = 0;
+    int i = 1;
+
+    numRuns = benchParseThreads("1,2,4", runs);
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            numRuns = benchParseThreads(argv[++i], runs);
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeMB = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (i + 1 != argc)
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (makeMB > 0)
+    {
+        return (benchMakePayload(argv[i], makeMB) == gBenchOkay ? 0 : 1);
+    }
+
+    if (numRuns < 1 || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    for (run = 0; run < numRuns; run++)
+    {
+        /* the first repetition is a warm up */
+
+        for (r = -1; r < numReps; r++)
+        {
+            start = benchNow();
+            if (benchList(argv[i],
+                          runs[run].threads,
+                          &entries,
+                          &bytes) != gBenchOkay)
+            {
+                fprintf(stderr,
+                        "pbzxbench: ERROR: cannot list '%s'\n",
+                        argv[i]);
+                return 1;
+            }
+            if (r >= 0)
+            {
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+            }
+        }
+        runs[run].wallMs = benchMedian(times, numReps);
+    }
+
+    fp = benchOpenOutput("pbzxbench", output);
+    if (fp == NULL)
+    {
+        return 1;
+    }
+
+    fprintf(fp,
+            "{\n  \"payload\": \"%s\", \"entries\": %llu, "
+            "\"bytes\": %llu,\n  \"runs\": [\n",
+            argv[i],
+            (unsigned long long)entries,
+            (unsigned long long)bytes);
+
+    for (run = 0; run < numRuns; run++)
+    {
+        fprintf(fp,
+                "    {\"threads\": %d, \"wallMs\": %.1f, "
+                "\"MBps\": %.1f, \"speedup\": %.2f}%s\n",
+                runs[run].threads,
+                runs[run].wallMs,
+                (runs[run].wallMs > 0.0 ?
+                 (double)bytes / 1048576.0 / (runs[run].wallMs / 1000.0) :
+                 0.0),
+                (runs[run].wallMs > 0.0 ?
+                 runs[0].wallMs / runs[run].wallMs : 0.0),
+                (run + 1 < numRuns ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    ret = 0;
+
+    if (benchCloseOutput(fp) != 0)
+    {
+        ret = 1;
+    }
+
+    return ret;
+}
@@ -0,0 +1,619 @@
+/*
+    peekbench.c - benchmark reading one entry through the directory
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    peekbench reads the first -n bytes (BENCHPEEKBYTES by default) of
+    one entry (-e, or else the archive's last file) of each of the
+    given zip, 7z, xar or ISO9660 archives two ways, and reports, as
+    JSON, for each archive:
+
+        libarchive - archive_read_next_header() until the entry, then
+                     archive_read_data(), as the preview lists an
+                     archive: the headers read to get to the entry
+        peek       - peekOpen(), peekFind() and peekRead() (see
+                     peek.h): the time to index the archive and the
+                     time to read the entry, the bytes of the entry
+                     read and decoded, and the speed up over
+                     libarchive
+
+    Each way is run repeatedly (-r), after one warm up run that is not
+    counted, and the median wall time is reported.  With -m,
+    peekbench instead writes a zip archive of the given number of
+    deflated text files, BENCHMINFILE to BENCHMAXFILE bytes each,
+    followed by a README.md, with zlib, so that the archive doesn't
+    depend on the code being measured.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <locale.h>
+#include <zlib.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+
+#include "peek.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHMINFILE   1024
+#define BENCHMAXFILE   65536
+#define BENCHPEEKBYTES 4096
+#define BENCHMAXNAME   4096
+#define BENCHCDLEN     46
+
+/* private functions */
+
+static unsigned char *benchPut16(unsigned char *p, unsigned int v);
+static unsigned char *benchPut32(unsigned char *p, uint32_t v);
+static int benchMakeZip(const char *path, unsigned long numFiles);
+static int benchLastFile(const char *path, char *name, size_t nameLen);
+static ssize_t benchLibarchive(const char *path,
+                               const char *name,
+                               void *buf,
+                               size_t maxLen,
+                               uint64_t *headers);
+static void printUsage(void);
+
+/* benchPut16 - put a little endian 16 bit value */
+
+static unsigned char *benchPut16(unsigned char *p, unsigned int v)
+{
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+
+    return p + 2;
+}
+
+/* benchPut32 - put a little endian 32 bit value */
+
+static unsigned char *benchPut32(unsigned char *p, uint32_t v)
+{
+    p = benchPut16(p, v & 0xFFFF);
+
+    return benchPut16(p, v >> 16);
+}
+
+/*
+    benchMakeZip - write a zip archive of numFiles deflated files of
+                   text, and a README.md after them
+*/
+
+static int benchMakeZip(const char *path, unsigned long numFiles)
+{
+    static const char *words[] =
+    {
+        "archive ", "entry ", "directory ", "header ", "preview ",
+        "index ", "offset ", "stream ", "folder ", "table\n",
+    };
+    unsigned char data[BENCHMAXFILE];
+    unsigned char header[128];
+    unsigned char *packed = NULL;
+    unsigned char *cd = NULL;
+    unsigned char *h = NULL;
+    unsigned char *c = NULL;
+    const char *word = NULL;
+    char name[64];
+    z_stream z;
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint64_t offset = 0;
+    uint32_t crc = 0;
+    size_t cdLen = 0;
+    size_t nameLen = 0;
+    size_t size = 0;
+    size_t packedLen = 0;
+    size_t len = 0;
+    size_t n = 0;
+    unsigned long i = 0;
+    FILE *fp = NULL;
+    int ret = gBenchErr;
+
+    if (numFiles >= 0xFFFF)
+    {
+        fprintf(stderr, "peekbench: ERROR: too many files\n");
+        return gBenchErr;
+    }
+
+    packed = malloc(compressBound(BENCHMAXFILE));
+    cd = malloc((numFiles + 1) * (BENCHCDLEN + sizeof(name)));
+    fp = fopen(path, "wb");
+    if (packed == NULL || cd == NULL || fp == NULL)
+    {
+        fprintf(stderr,
+                "peekbench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    for (i = 0; i <= numFiles; i++)
+    {
+        size = BENCHMINFILE +
+               (size_t)(benchRand(&state) %
+                        (BENCHMAXFILE - BENCHMINFILE + 1));
+        for (len = 0; len < size; len += n)
+        {
+            word = words[benchRand(&state) % 10];
+            n = strlen(word);
+            if (n > size - len)
+            {
+                n = size - len;
+            }
+            memcpy(data + len, word, n);
+        }
+
+        if (i < numFiles)
+        {
+            snprintf(name,
+                     sizeof(name),
+                     "docs/%04lu/file%06lu.txt",
+                     i / 100,
+                     i);
+        }
+        else
+        {
+            snprintf(name, sizeof(name), "README.md");
+        }
+        nameLen = strlen(name);
+
+        crc = (uint32_t)crc32(0, data, (uInt)size);
+
+        memset(&z, 0, sizeof(z));
+        if (deflateInit2(&z,
+                         Z_DEFAULT_COMPRESSION,
+                         Z_DEFLATED,
+                         -MAX_WBITS,
+                         8,
+                         Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            goto done;
+        }
+        z.next_in = data;
+        z.avail_in = (uInt)size;
+        z.next_out = packed;
+        z.avail_out = (uInt)compressBound(BENCHMAXFILE);
+        deflate(&z, Z_FINISH);
+        packedLen = z.total_out;
+        deflateEnd(&z);
+
+        /* the local header and the data */
+
+        h = header;
+        h = benchPut32(h, 0x04034B50);
+        h = benchPut16(h, 20);
+        h = benchPut16(h, 0);
+        h = benchPut16(h, 8);
+        h = benchPut16(h, 0x6000);
+        h = benchPut16(h, 0x5D31);
+        h = benchPut32(h, crc);
+        h = benchPut32(h, (uint32_t)packedLen);
+        h = benchPut32(h, (uint32_t)size);
+        h = benchPut16(h, (unsigned int)nameLen);
+        h = benchPut16(h, 0);
+        memcpy(h, name, nameLen);
+        h += nameLen;
+
+        if (fwrite(header, 1, (size_t)(h - header), fp) !=
+                (size_t)(h - header) ||
+            fwrite(packed, 1, packedLen, fp) != packedLen)
+        {
+            fprintf(stderr,
+                    "peekbench: ERROR: cannot write '%s': %s\n",
+                    path,
+                    strerror(errno));
+            goto done;
+        }
+
+        /* the central directory entry is the same, plus the offset */
+
+        c = cd + cdLen;
+        c = benchPut32(c, 0x02014B50);
+        c = benchPut16(c, 0x0314);
+        memcpy(c, header + 4, 26);
+        c += 26;
+        c = benchPut16(c, 0);
+        c = benchPut16(c, 0);
+        c = benchPut16(c, 0);
+        c = benchPut32(c, 0100644U << 16);
+        c = benchPut32(c, (uint32_t)offset);
+        memcpy(c, name, nameLen);
+        c += nameLen;
+        cdLen = (size_t)(c - cd);
+
+        offset += (uint64_t)(h - header) + packedLen;
+    }
+
+    h = header;
+    h = benchPut32(h, 0x06054B50);
+    h = benchPut16(h, 0);
+    h = benchPut16(h, 0);
+    h = benchPut16(h, (unsigned int)numFiles + 1);
+    h = benchPut16(h, (unsigned int)numFiles + 1);
+    h = benchPut32(h, (uint32_t)cdLen);
+    h = benchPut32(h, (uint32_t)offset);
+    h = benchPut16(h, 0);
+
+    if (fwrite(cd, 1, cdLen, fp) != cdLen ||
+        fwrite(header, 1, (size_t)(h - header), fp) !=
+            (size_t)(h - header))
+    {
+        fprintf(stderr,
+                "peekbench: ERROR: cannot write '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (fp != NULL && fclose(fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    free(packed);
+    free(cd);
+
+    return ret;
+}
+
+/* benchLastFile - get the path of the archive's last file */
+
+static int benchLastFile(const char *path, char *name, size_t nameLen)
+{
+    peek_t peek;
+    uint32_t i = 0;
+    int ret = gBenchErr;
+
+    if (peekOpen(path, &peek) != gPeekOkay)
+    {
+        return gBenchErr;
+    }
+
+    for (i = peek.numEntries; i > 0; i--)
+    {
+        if (!peek.entries[i - 1].isDir)
+        {
+            snprintf(name, nameLen, "%s", peek.entries[i - 1].name);
+            ret = gBenchOkay;
+            break;
+        }
+    }
+
+    peekClose(&peek);
+
+    return ret;
+}
+
+/*
+    benchLibarchive - read the headers up to the entry, and then up to
+                      maxLen bytes of the entry, with libarchive
+*/
+
+static ssize_t benchLibarchive(const char *path,
+                               const char *name,
+                               void *buf,
+                               size_t maxLen,
+                               uint64_t *headers)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    const char *entryName = NULL;
+    ssize_t len = -1;
+    size_t nameLen = strlen(name);
+    int r = ARCHIVE_OK;
+
+    *headers = 0;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return -1;
+    }
+
+    archive_read_support_format_all(a);
+    archive_read_support_filter_all(a);
+
+    if (archive_read_open_filename(a, path, 65536) != ARCHIVE_OK)
+    {
+        archive_read_free(a);
+        return -1;
+    }
+
+    for (;;)
+    {
+        r = archive_read_next_header(a, &entry);
+        if (r == ARCHIVE_EOF || r < ARCHIVE_WARN)
+        {
+            break;
+        }
+        (*headers)++;
+
+        entryName = archive_entry_pathname_utf8(entry);
+        if (entryName == NULL)
+        {
+            entryName = archive_entry_pathname(entry);
+        }
+        if (entryName == NULL)
+        {
+            continue;
+        }
+        if (strncmp(entryName, "./", 2) == 0)
+        {
+            entryName += 2;
+        }
+
+        if (strncmp(entryName, name, nameLen) == 0 &&
+            entryName[nameLen] == '\0')
+        {
+            len = archive_read_data(a, buf, maxLen);
+            break;
+        }
+    }
+
+    archive_read_free(a);
+
+    return len;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: peekbench [-e entry] [-n bytes] [-r repetitions]\n"
+            "                 [-o output.json] archive ...\n"
+            "       peekbench -m files archive.zip\n");
+}
+
+int main(int argc, char **argv)
+{
+    peek_t peek;
+    const peekEntry_t *entry = NULL;
+    const char *output = NULL;
+    const char *entryName = NULL;
+    char name[BENCHMAXNAME];
+    unsigned char *buf = NULL;
+    double times[BENCHMAXREPS];
+    double openTimes[BENCHMAXREPS];
+    double libarchiveMs = 0.0;
+    double peekMs = 0.0;
+    double openMs = 0.0;
+    uint64_t start = 0;
+    uint64_t opened = 0;
+    uint64_t headers = 0;
+    uint64_t bytesRead = 0;
+    uint64_t bytesDecoded = 0;
+    unsigned long makeFiles = 0;
+    size_t maxLen = BENCHPEEKBYTES;
+    ssize_t libarchiveLen = 0;
+    ssize_t peekLen = 0;
+    FILE *fp = stdout;
+    int numReps = 3;
+    int arc = 0;
+    int ret = 1;
+    int r = 0;
+    int i = 1;
+
+    memset(&peek, 0, sizeof(peek_t));
+
+    /* libarchive converts names that aren't ASCII for the locale */
+
+    setlocale(LC_ALL, "");
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-e") == 0 && i + 1 < argc)
+        {
+            entryName = argv[++i];
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            maxLen = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeFiles = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeFiles > 0)
+    {
+        if (i + 1 != argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeZip(argv[i], makeFiles) == gBenchOkay ? 0 : 1);
+    }
+
+    if (i >= argc || numReps < 1 || numReps > BENCHMAXREPS ||
+        maxLen == 0)
+    {
+        printUsage();
+        return 1;
+    }
+
+    buf = malloc(maxLen);
+    if (buf == NULL)
+    {
+        goto done;
+    }
+
+    fp = benchOpenOutput("peekbench", output);
+    if (fp == NULL)
+    {
+        goto done;
+    }
+
+    fprintf(fp, "{\n  \"bytes\": %zu,\n  \"archives\": [\n", maxLen);
+
+    for (arc = i; arc < argc; arc++)
+    {
+        if (entryName != NULL)
+        {
+            snprintf(name, sizeof(name), "%s", entryName);
+        }
+        else if (benchLastFile(argv[arc], name, sizeof(name)) !=
+                     gBenchOkay)
+        {
+            fprintf(stderr,
+                    "peekbench: ERROR: cannot index '%s'\n",
+                    argv[arc]);
+            goto done;
+        }
+
+        /* the first repetition of each way is a warm up */
+
+        for (r = -1; r < numReps; r++)
+        {
+            start = benchNow();
+            libarchiveLen = benchLibarchive(argv[arc],
+                                            name,
+                                            buf,
+                                            maxLen,
+                                            &headers);
+            if (libarchiveLen < 0)
+            {
+                fprintf(stderr,
+                        "peekbench: ERROR: cannot read '%s' in '%s'\n",
+                        name,
+                        argv[arc]);
+                goto done;
+            }
+            if (r >= 0)
+            {
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+            }
+        }
+        libarchiveMs = benchMedian(times, numReps);
+
+        for (r = -1; r < numReps; r++)
+        {
+            start = benchNow();
+            if (peekOpen(argv[arc], &peek) != gPeekOkay)
+            {
+                fprintf(stderr,
+                        "peekbench: ERROR: cannot index '%s'\n",
+                        argv[arc]);
+                goto done;
+            }
+            opened = benchNow();
+
+            entry = peekFind(&peek, name);
+            peekLen = (entry != NULL ?
+                       peekRead(&peek, entry, buf, maxLen) : -1);
+            if (peekLen != libarchiveLen)
+            {
+                fprintf(stderr,
+                        "peekbench: ERROR: cannot peek '%s' in '%s'\n",
+                        name,
+                        argv[arc]);
+                goto done;
+            }
+
+            if (r >= 0)
+            {
+                openTimes[r] = (double)(opened - start) / 1000000.0;
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+            }
+            bytesRead = peek.bytesRead;
+            bytesDecoded = peek.bytesDecoded;
+
+            if (r + 1 < numReps)
+            {
+                peekClose(&peek);
+            }
+        }
+        peekMs = benchMedian(times, numReps);
+        openMs = benchMedian(openTimes, numReps);
+
+        fprintf(fp,
+                "    {\"archive\": \"%s\", \"format\": \"%s\", "
+                "\"entries\": %u, \"entry\": \"%s\", \"read\": %zd,\n"
+                "     \"libarchive\": {\"headers\": %llu, "
+                "\"wallMs\": %.2f},\n"
+                "     \"peek\": {\"openMs\": %.2f, \"readMs\": %.2f, "
+                "\"wallMs\": %.2f, \"bytesRead\": %llu, "
+                "\"bytesDecoded\": %llu, \"speedup\": %.1f}}%s\n",
+                argv[arc],
+                peekFormatName(peek.format),
+                peek.numEntries,
+                name,
+                peekLen,
+                (unsigned long long)headers,
+                libarchiveMs,
+                openMs,
+                peekMs - openMs,
+                peekMs,
+                (unsigned long long)bytesRead,
+                (unsigned long long)bytesDecoded,
+                (peekMs > 0.0 ? libarchiveMs / peekMs : 0.0),
+                (arc + 1 < argc ? "," : ""));
+
+        peekClose(&peek);
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    ret = 0;
+
+done:
+    peekClose(&peek);
+    free(buf);
+    benchCloseOutput(fp);
+
+    return ret;
+}
@@ -0,0 +1,614 @@
+/*
+    rawbench.c - benchmark getting the size of compressed files
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    rawbench gets the uncompressed size of each of the given gzip,
+    bzip2, xz, zstd or lz4 compressed files two ways, and reports, as
+    JSON, for each file:
+
+        libarchive - archive_read_data() over the whole file, with the
+                     raw format, as the size would be found without
+                     what the format records, or null if libarchive
+                     can't decompress the format in process (zstd and
+                     lz4 need an external program without their
+                     libraries)
+        rawsize    - rawSizeRead() (see rawsize.h): the size, the
+                     number of streams or frames, the bytes of the
+                     file read, and the speed up over libarchive
+
+    Each way is run repeatedly (-r), after one warm up run that is not
+    counted, and the median wall time is reported.  With -m,
+    rawbench instead writes the given number of MB of text, compressed
+    as raw.xz (with liblzma, as streams of BENCHCHUNK bytes each),
+    raw.zst and raw.lz4 (as frames of BENCHCHUNK bytes each, of
+    uncompressed blocks, with their content sizes, which is all that
+    is read), and the first BENCHBZIP2MB MB of it as raw.bz2 (with
+    libbz2), to the given directory, so that the files don't depend
+    on the code being measured.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <bzlib.h>
+#include <lzma.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+
+#include "rawsize.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHMAXMB     4096
+#define BENCHCHUNK     (32 * 1024 * 1024)
+#define BENCHZSTDBLOCK (128 * 1024)
+#define BENCHLZ4BLOCK  (4 * 1024 * 1024)
+#define BENCHBZIP2MB   48
+#define BENCHBUFLEN    (1024 * 1024)
+#define BENCHMAXPATH   4096
+
+/* private functions */
+
+static unsigned char *benchPut32(unsigned char *p, uint32_t v);
+static void benchFillText(unsigned char *buf, size_t len, uint64_t *state);
+static int benchWrite(FILE *fp, const void *buf, size_t len);
+static int benchWriteXZ(FILE *fp, const unsigned char *text, size_t len);
+static int benchWriteZstd(FILE *fp, const unsigned char *text, size_t len);
+static int benchWriteLZ4(FILE *fp, const unsigned char *text, size_t len);
+static int benchWriteBZip2(FILE *fp, const unsigned char *text, size_t len);
+static int benchMakeFiles(const char *dir, unsigned long megabytes);
+static int64_t benchLibarchive(const char *path, unsigned char *buf);
+static void printUsage(void);
+
+/* benchPut32 - put a little endian 32 bit value */
+
+static unsigned char *benchPut32(unsigned char *p, uint32_t v)
+{
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+
+    return p + 4;
+}
+
+/* benchFillText - fill a buffer with words */
+
+static void benchFillText(unsigned char *buf, size_t len, uint64_t *state)
+{
+    static const char *words[] =
+    {
+        "archive ", "stream ", "frame ", "block ", "index ",
+        "footer ", "header ", "content ", "size ", "table\n",
+    };
+    const char *word = NULL;
+    size_t i = 0;
+    size_t n = 0;
+
+    for (i = 0; i < len; i += n)
+    {
+        word = words[benchRand(state) % 10];
+        n = strlen(word);
+        if (n > len - i)
+        {
+            n = len - i;
+        }
+        memcpy(buf + i, word, n);
+    }
+}
+
+/* benchWrite - write len bytes */
+
+static int benchWrite(FILE *fp, const void *buf, size_t len)
+{
+    if (fwrite(buf, 1, len, fp) != len)
+    {
+        fprintf(stderr,
+                "rawbench: ERROR: cannot write: %s\n",
+                strerror(errno));
+        return gBenchErr;
+    }
+
+    return gBenchOkay;
+}
+
+/* benchWriteXZ - write text as xz streams of BENCHCHUNK bytes each */
+
+static int benchWriteXZ(FILE *fp, const unsigned char *text, size_t len)
+{
+    unsigned char *out = NULL;
+    size_t outLen = 0;
+    size_t chunk = 0;
+    size_t i = 0;
+    int ret = gBenchErr;
+
+    out = malloc(lzma_stream_buffer_bound(BENCHCHUNK));
+    if (out == NULL)
+    {
+        return gBenchErr;
+    }
+
+    for (i = 0; i < len; i += chunk)
+    {
+        chunk = (len - i < BENCHCHUNK ? len - i : BENCHCHUNK);
+        outLen = 0;
+        if (lzma_easy_buffer_encode(0,
+                                    LZMA_CHECK_CRC64,
+                                    NULL,
+                                    text + i,
+                                    chunk,
+                                    out,
+                                    &outLen,
+                                    lzma_stream_buffer_bound(BENCHCHUNK)) !=
+                LZMA_OK ||
+            benchWrite(fp, out, outLen) != gBenchOkay)
+        {
+            goto done;
+        }
+    }
+
+    ret = gBenchOkay;
+
+done:
+    free(out);
+
+    return ret;
+}
+
+/*
+    benchWriteZstd - write text as zstd frames of BENCHCHUNK bytes
+                     each, of raw (uncompressed) blocks
+*/
+
+static int benchWriteZstd(FILE *fp, const unsigned char *text, size_t len)
+{
+    unsigned char header[16];
+    unsigned char *h = NULL;
+    size_t chunk = 0;
+    size_t block = 0;
+    size_t i = 0;
+    size_t j = 0;
+    uint32_t blockHeader = 0;
+
+    for (i = 0; i < len; i += chunk)
+    {
+        chunk = (len - i < BENCHCHUNK ? len - i : BENCHCHUNK);
+
+        /* a single segment, with a 4 byte content size */
+
+        h = header;
+        h = benchPut32(h, 0xFD2FB528U);
+        *h++ = 0xA0;
+        h = benchPut32(h, (uint32_t)chunk);
+        if (benchWrite(fp, header, (size_t)(h - header)) != gBenchOkay)
+        {
+            return gBenchErr;
+        }
+
+        for (j = 0; j < chunk; j += block)
+        {
+            block = (chunk - j < BENCHZSTDBLOCK ? chunk - j : BENCHZSTDBLOCK);
+            blockHeader = ((uint32_t)block << 3) |
+                          (j + block == chunk ? 1 : 0);
+            benchPut32(header, blockHeader);
+            if (benchWrite(fp, header, 3) != gBenchOkay ||
+                benchWrite(fp, text + i + j, block) != gBenchOkay)
+            {
+                return gBenchErr;
+            }
+        }
+    }
+
+    return gBenchOkay;
+}
+
+/*
+    benchWriteLZ4 - write text as lz4 frames of BENCHCHUNK bytes each,
+                    of uncompressed blocks
+*/
+
+static int benchWriteLZ4(FILE *fp, const unsigned char *text, size_t len)
+{
+    unsigned char header[16];
+    unsigned char *h = NULL;
+    size_t chunk = 0;
+    size_t block = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    for (i = 0; i < len; i += chunk)
+    {
+        chunk = (len - i < BENCHCHUNK ? len - i : BENCHCHUNK);
+
+        /* version 1, independent blocks, with the content size */
+
+        h = header;
+        h = benchPut32(h, 0x184D2204U);
+        *h++ = 0x68;
+        *h++ = 0x70;
+        h = benchPut32(h, (uint32_t)chunk);
+        h = benchPut32(h, 0);
+        *h++ = 0;
+        if (benchWrite(fp, header, (size_t)(h - header)) != gBenchOkay)
+        {
+            return gBenchErr;
+        }
+
+        for (j = 0; j < chunk; j += block)
+        {
+            block = (chunk - j < BENCHLZ4BLOCK ? chunk - j : BENCHLZ4BLOCK);
+            benchPut32(header, (uint32_t)block | 0x80000000U);
+            if (benchWrite(fp, header, 4) != gBenchOkay ||
+                benchWrite(fp, text + i + j, block) != gBenchOkay)
+            {
+                return gBenchErr;
+            }
+        }
+
+        benchPut32(header, 0);
+        if (benchWrite(fp, header, 4) != gBenchOkay)
+        {
+            return gBenchErr;
+        }
+    }
+
+    return gBenchOkay;
+}
+
+/* benchWriteBZip2 - write text as a bzip2 stream */
+
+static int benchWriteBZip2(FILE *fp, const unsigned char *text, size_t len)
+{
+    char *out = NULL;
+    unsigned int outLen = 0;
+    int ret = gBenchErr;
+
+    outLen = (unsigned int)(len + len / 100 + 600);
+    out = malloc(outLen);
+    if (out == NULL)
+    {
+        return gBenchErr;
+    }
+
+    if (BZ2_bzBuffToBuffCompress(out,
+                                 &outLen,
+                                 (char *)text,
+                                 (unsigned int)len,
+                                 9,
+                                 0,
+                                 0) == BZ_OK &&
+        benchWrite(fp, out, outLen) == gBenchOkay)
+    {
+        ret = gBenchOkay;
+    }
+
+    free(out);
+
+    return ret;
+}
+
+/* benchMakeFiles - write the compressed files to dir */
+
+static int benchMakeFiles(const char *dir, unsigned long megabytes)
+{
+    static const char *names[] = { "raw.xz", "raw.zst", "raw.lz4", "raw.bz2" };
+    unsigned char *text = NULL;
+    char path[BENCHMAXPATH];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    size_t len = (size_t)megabytes * 1024 * 1024;
+    size_t bzip2Len = 0;
+    FILE *fp = NULL;
+    int i = 0;
+    int r = gBenchErr;
+
+    if (megabytes > BENCHMAXMB)
+    {
+        fprintf(stderr, "rawbench: ERROR: too many MB\n");
+        return gBenchErr;
+    }
+
+    text = malloc(len);
+    if (text == NULL)
+    {
+        fprintf(stderr, "rawbench: ERROR: out of memory\n");
+        return gBenchErr;
+    }
+    benchFillText(text, len, &state);
+
+    bzip2Len = (len < (size_t)BENCHBZIP2MB * 1024 * 1024 ?
+                len : (size_t)BENCHBZIP2MB * 1024 * 1024);
+
+    for (i = 0; i < 4; i++)
+    {
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        fp = fopen(path, "wb");
+        if (fp == NULL)
+        {
+            fprintf(stderr,
+                    "rawbench: ERROR: cannot create '%s': %s\n",
+                    path,
+                    strerror(errno));
+            free(text);
+            return gBenchErr;
+        }
+
+        switch (i)
+        {
+            case 0:
+                r = benchWriteXZ(fp, text, len);
+                break;
+            case 1:
+                r = benchWriteZstd(fp, text, len);
+                break;
+            case 2:
+                r = benchWriteLZ4(fp, text, len);
+                break;
+            default:
+                r = benchWriteBZip2(fp, text, bzip2Len);
+                break;
+        }
+
+        if (fclose(fp) != 0 || r != gBenchOkay)
+        {
+            fprintf(stderr, "rawbench: ERROR: cannot write '%s'\n", path);
+            free(text);
+            return gBenchErr;
+        }
+    }
+
+    free(text);
+
+    return gBenchOkay;
+}
+
+/*
+    benchLibarchive - decompress the whole file with libarchive and
+                      count its bytes; returns -1 if it can't
+*/
+
+static int64_t benchLibarchive(const char *path, unsigned char *buf)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    int64_t size = -1;
+    ssize_t n = 0;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return -1;
+    }
+
+    archive_read_support_format_raw(a);
+    archive_read_support_filter_gzip(a);
+    archive_read_support_filter_bzip2(a);
+    archive_read_support_filter_xz(a);
+
+    if (archive_read_open_filename(a, path, 65536) == ARCHIVE_OK &&
+        archive_filter_count(a) > 1 &&
+        archive_read_next_header(a, &entry) == ARCHIVE_OK)
+    {
+        for (size = 0;
+             (n = archive_read_data(a, buf, BENCHBUFLEN)) > 0;
+             size += n)
+        {
+        }
+        if (n < 0)
+        {
+            size = -1;
+        }
+    }
+
+    archive_read_free(a);
+
+    return size;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: rawbench [-r repetitions] [-o output.json] file ...\n"
+            "       rawbench -m MB directory\n");
+}
+
+int main(int argc, char **argv)
+{
+    rawSize_t raw;
+    const char *output = NULL;
+    unsigned char *buf = NULL;
+    char libarchiveMs[32];
+    char speedup[32];
+    double times[BENCHMAXREPS];
+    double rawMs = 0.0;
+    uint64_t start = 0;
+    unsigned long makeMB = 0;
+    int64_t libarchiveSize = 0;
+    FILE *fp = stdout;
+    int numReps = 3;
+    int arc = 0;
+    int ret = 1;
+    int r = 0;
+    int i = 1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeMB = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeMB > 0)
+    {
+        if (i + 1 != argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeFiles(argv[i], makeMB) == gBenchOkay ? 0 : 1);
+    }
+
+    if (i >= argc || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    buf = malloc(BENCHBUFLEN);
+    if (buf == NULL)
+    {
+        goto done;
+    }
+
+    fp = benchOpenOutput("rawbench", output);
+    if (fp == NULL)
+    {
+        goto done;
+    }
+
+    fprintf(fp, "{\n  \"files\": [\n");
+
+    for (arc = i; arc < argc; arc++)
+    {
+        /* the first repetition of each way is a warm up */
+
+        for (r = -1; r < numReps; r++)
+        {
+            start = benchNow();
+            if (rawSizeRead(argv[arc], &raw) != gRawSizeOkay)
+            {
+                fprintf(stderr,
+                        "rawbench: ERROR: no size for '%s'\n",
+                        argv[arc]);
+                goto done;
+            }
+            if (r >= 0)
+            {
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+            }
+        }
+        rawMs = benchMedian(times, numReps);
+
+        snprintf(libarchiveMs, sizeof(libarchiveMs), "null");
+        snprintf(speedup, sizeof(speedup), "null");
+
+        for (r = -1; r < numReps; r++)
+        {
+            start = benchNow();
+            libarchiveSize = benchLibarchive(argv[arc], buf);
+            if (libarchiveSize < 0)
+            {
+                break;
+            }
+
+            /* gzip only records the size modulo 4GB */
+
+            if ((raw.format == RawFormatGZip ?
+                 (uint64_t)libarchiveSize % 0x100000000ULL :
+                 (uint64_t)libarchiveSize) != raw.size)
+            {
+                fprintf(stderr,
+                        "rawbench: ERROR: sizes of '%s' differ\n",
+                        argv[arc]);
+                goto done;
+            }
+            if (r >= 0)
+            {
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+            }
+        }
+
+        if (libarchiveSize >= 0)
+        {
+            snprintf(libarchiveMs,
+                     sizeof(libarchiveMs),
+                     "%.2f",
+                     benchMedian(times, numReps));
+            snprintf(speedup,
+                     sizeof(speedup),
+                     "%.1f",
+                     (rawMs > 0.0 ?
+                      benchMedian(times, numReps) / rawMs : 0.0));
+        }
+
+        fprintf(fp,
+                "    {\"file\": \"%s\", \"format\": \"%s\", "
+                "\"size\": %llu, \"streams\": %u,\n"
+                "     \"libarchive\": {\"wallMs\": %s},\n"
+                "     \"rawsize\": {\"wallMs\": %.3f, \"bytesRead\": %llu, "
+                "\"speedup\": %s}}%s\n",
+                argv[arc],
+                rawSizeFormatName(raw.format),
+                (unsigned long long)raw.size,
+                raw.numStreams,
+                libarchiveMs,
+                rawMs,
+                (unsigned long long)raw.bytesRead,
+                speedup,
+                (arc + 1 < argc ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    ret = 0;
+
+done:
+    free(buf);
+    benchCloseOutput(fp);
+
+    return ret;
+}
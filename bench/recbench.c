@@ -0,0 +1,471 @@
+/*
+    recbench.c - benchmark writing NDJSON / CBOR entry records
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    recbench writes count records, in each format, with records.c's
+    writer and reports, as JSON:
+
+        records      - number of records written
+        bytes        - size of the output
+        totalUs      - median time to write all of the records
+        recordsPerSec, mbPerSec - based on the median time
+        peakRssKb    - peak resident set size
+
+    The records have paths of the given length under a few levels of
+    directories, with some non-ASCII and some characters that JSON
+    has to escape, and a mix of files, folders, links and Mac type /
+    creator codes, so that every field is written.  The output goes
+    to /dev/null unless -w is given.  Each format and count is run in
+    its own child process, so that the peak RSS shows that memory use
+    does not grow with the number of records.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "records.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS    1000
+#define BENCHMAXCOUNTS  16
+#define BENCHMAXNAMELEN 4096
+
+/* the result of benchmarking one format and count */
+
+typedef struct benchResult
+{
+    int status;
+    unsigned long long bytes;
+    double totalUs;
+    long peakRssKb;
+} benchResult_t;
+
+/* globals */
+
+static const char *gBenchFormatNames[RecFormatMax] =
+{
+    "ndjson",
+    "cbor",
+};
+
+static const char *gBenchOutput = "/dev/null";
+
+/* private functions */
+
+static void benchMakePath(char *path,
+                          size_t nameLen,
+                          unsigned long long i);
+static int benchWrite(recFormat_t format,
+                      unsigned long long count,
+                      size_t nameLen,
+                      unsigned long long *bytes);
+static void benchRun(recFormat_t format,
+                     unsigned long long count,
+                     size_t nameLen,
+                     int reps,
+                     benchResult_t *result);
+static int benchMeasure(recFormat_t format,
+                        unsigned long long count,
+                        size_t nameLen,
+                        int reps,
+                        benchResult_t *result);
+static void printUsage(void);
+
+/*
+    benchMakePath - make the path of the i-th record, nameLen bytes
+                    long, in path (which holds nameLen + 1 bytes)
+*/
+
+static void benchMakePath(char *path,
+                          size_t nameLen,
+                          unsigned long long i)
+{
+    static const char *fill = "abcdefghijklmnopqrstuvwxyz0123456789";
+    size_t len = 0;
+
+    len = (size_t)snprintf(path,
+                           nameLen + 1,
+                           "d%02llu/d%03llu/f%07llu_",
+                           i % 97,
+                           i % 991,
+                           i);
+    if (len > nameLen)
+    {
+        len = nameLen;
+    }
+
+    while (len < nameLen)
+    {
+        path[len] = fill[(i + len) % 36];
+        len++;
+    }
+    path[nameLen] = '\0';
+
+    /* one name in 8 has UTF-8 ("é") and one in 16 a quote and a tab */
+
+    if (nameLen >= 24 && i % 8 == 0)
+    {
+        path[nameLen - 4] = (char)0xc3;
+        path[nameLen - 3] = (char)0xa9;
+    }
+    if (nameLen >= 24 && i % 16 == 1)
+    {
+        path[nameLen - 6] = '"';
+        path[nameLen - 5] = '\t';
+    }
+}
+
+/* benchWrite - write count records in format to the output */
+
+static int benchWrite(recFormat_t format,
+                      unsigned long long count,
+                      size_t nameLen,
+                      unsigned long long *bytes)
+{
+    static recWriter_t writer;
+    char path[BENCHMAXNAMELEN + 1];
+    recEntry_t rec;
+    unsigned long long i = 0;
+    int fd = -1;
+    int ret = gBenchOkay;
+
+    fd = open(gBenchOutput, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        fprintf(stderr,
+                "recbench: ERROR: cannot open '%s': %s\n",
+                gBenchOutput,
+                strerror(errno));
+        return gBenchErr;
+    }
+
+    recWriterInit(&writer, fd, format);
+
+    memset(&rec, 0, sizeof(recEntry_t));
+    rec.path = path;
+
+    for (i = 0; i < count; i++)
+    {
+        benchMakePath(path, nameLen, i);
+
+        rec.type = (i % 50 == 0 ? RecTypeDir :
+                    (i % 97 == 0 ? RecTypeLink : RecTypeFile));
+        rec.size = (int64_t)(i * 7919 % 100000000);
+        rec.hasSize = (rec.type != RecTypeDir);
+        rec.compressedSize = rec.size / 3;
+        rec.hasCompressedSize = (rec.type != RecTypeDir && i % 2 == 0);
+        rec.mtime = 1700000000 + (int64_t)i;
+        rec.hasMtime = 1;
+        rec.encrypted = (i % 33 == 0);
+        rec.depth = (unsigned int)(i % 3 == 0);
+        rec.macType = (i % 4 == 0 ? "TEXT" : NULL);
+        rec.macCreator = (i % 4 == 0 ? "ttxt" : NULL);
+
+        if (recWriterAppend(&writer, &rec) != gRecOkay)
+        {
+            ret = gBenchErr;
+            break;
+        }
+    }
+
+    if (recWriterFlush(&writer) != gRecOkay)
+    {
+        ret = gBenchErr;
+    }
+
+    if (ret != gBenchOkay)
+    {
+        fprintf(stderr,
+                "recbench: ERROR: cannot write '%s': %s\n",
+                gBenchOutput,
+                strerror(writer.err));
+    }
+
+    *bytes = writer.bytesWritten;
+
+    close(fd);
+
+    return ret;
+}
+
+/* benchRun - time writing the records, reps times */
+
+static void benchRun(recFormat_t format,
+                     unsigned long long count,
+                     size_t nameLen,
+                     int reps,
+                     benchResult_t *result)
+{
+    double totals[BENCHMAXREPS];
+    struct rusage usage;
+    uint64_t start = 0;
+    int i = 0;
+
+    memset(result, 0, sizeof(benchResult_t));
+
+    for (i = -1; i < reps; i++)
+    {
+        start = benchNow();
+
+        if (benchWrite(format, count, nameLen, &result->bytes) != gBenchOkay)
+        {
+            result->status = gBenchErr;
+            return;
+        }
+
+        /* the first run warms the caches and is not counted */
+
+        if (i >= 0)
+        {
+            totals[i] = (double)(benchNow() - start) / 1000.0;
+        }
+    }
+
+    result->totalUs = benchMedian(totals, reps);
+
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        result->peakRssKb = usage.ru_maxrss;
+    }
+
+    result->status = gBenchOkay;
+}
+
+/* benchMeasure - run the benchmark in a child process */
+
+static int benchMeasure(recFormat_t format,
+                        unsigned long long count,
+                        size_t nameLen,
+                        int reps,
+                        benchResult_t *result)
+{
+    int fds[2];
+    pid_t pid = 0;
+    ssize_t n = 0;
+    int status = 0;
+
+    if (pipe(fds) != 0)
+    {
+        return gBenchErr;
+    }
+
+    pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return gBenchErr;
+    }
+
+    if (pid == 0)
+    {
+        close(fds[0]);
+        benchRun(format, count, nameLen, reps, result);
+        n = write(fds[1], result, sizeof(benchResult_t));
+        close(fds[1]);
+        _exit(n == (ssize_t)sizeof(benchResult_t) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    n = read(fds[0], result, sizeof(benchResult_t));
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+
+    if (n != (ssize_t)sizeof(benchResult_t) ||
+        !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0)
+    {
+        return gBenchErr;
+    }
+
+    return result->status;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: recbench [-r repetitions] [-l name length]"
+            " [-f ndjson|cbor]\n"
+            "                [-w output] [count ...]\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchResult_t result;
+    unsigned long long counts[BENCHMAXCOUNTS];
+    int numCounts = 0;
+    int formats[RecFormatMax] = { 1, 1 };
+    double seconds = 0.0;
+    size_t nameLen = 64;
+    int reps = 5;
+    int first = 1;
+    int failed = 0;
+    int f = 0;
+    int i = 1;
+    int c = 0;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            reps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+        {
+            nameLen = (size_t)atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+        {
+            gBenchOutput = argv[++i];
+        }
+        else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+        {
+            i++;
+            for (f = 0; f < RecFormatMax; f++)
+            {
+                formats[f] = (strcmp(argv[i], gBenchFormatNames[f]) == 0);
+            }
+            if (!formats[RecFormatNDJSON] && !formats[RecFormatCBOR])
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    for (; i < argc && numCounts < BENCHMAXCOUNTS; i++)
+    {
+        counts[numCounts++] = strtoull(argv[i], NULL, 10);
+    }
+
+    if (numCounts == 0)
+    {
+        counts[numCounts++] = 1000;
+        counts[numCounts++] = 100000;
+        counts[numCounts++] = 1000000;
+    }
+
+    if (i < argc || reps < 1 || reps > BENCHMAXREPS ||
+        nameLen < 1 || nameLen > BENCHMAXNAMELEN)
+    {
+        printUsage();
+        return 1;
+    }
+
+    printf("{\n  \"bufferSize\": %d,\n  \"nameLength\": %zu,\n"
+           "  \"repetitions\": %d,\n  \"results\": [",
+           RECBUFSIZE,
+           nameLen,
+           reps);
+
+    for (f = 0; f < RecFormatMax; f++)
+    {
+        if (!formats[f])
+        {
+            continue;
+        }
+
+        for (c = 0; c < numCounts; c++)
+        {
+            if (benchMeasure((recFormat_t)f,
+                             counts[c],
+                             nameLen,
+                             reps,
+                             &result) != gBenchOkay)
+            {
+                fprintf(stderr,
+                        "recbench: ERROR: %s, %llu records failed\n",
+                        gBenchFormatNames[f],
+                        counts[c]);
+                failed++;
+                continue;
+            }
+
+            seconds = result.totalUs / 1000000.0;
+
+            printf("%s\n    {\"format\": \"%s\", \"records\": %llu, "
+                   "\"bytes\": %llu, \"totalUs\": %.1f,\n"
+                   "     \"recordsPerSec\": %.0f, \"mbPerSec\": %.2f, "
+                   "\"peakRssKb\": %ld}",
+                   (first ? "" : ","),
+                   gBenchFormatNames[f],
+                   counts[c],
+                   result.bytes,
+                   result.totalUs,
+                   (seconds > 0 ? (double)counts[c] / seconds : 0.0),
+                   (seconds > 0 ?
+                    (double)result.bytes / (1024.0 * 1024.0) / seconds :
+                    0.0),
+                   result.peakRssKb);
+            first = 0;
+
+            fprintf(stderr,
+                    "%-7s %10llu records %12llu bytes %10.1f ms %8.1f MB/s"
+                    " %7ld KB RSS\n",
+                    gBenchFormatNames[f],
+                    counts[c],
+                    result.bytes,
+                    result.totalUs / 1000.0,
+                    (seconds > 0 ?
+                     (double)result.bytes / (1024.0 * 1024.0) / seconds :
+                     0.0),
+                    result.peakRssKb);
+        }
+    }
+
+    printf("\n  ]\n}\n");
+
+    return (failed > 0 ? 1 : 0);
+}
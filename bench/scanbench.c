@@ -0,0 +1,487 @@
+/*
+    scanbench.c - benchmark indexing every archive under a directory
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    scanbench indexes every archive under a directory with scanRun()
+    (see scan.h), with each of the given numbers of workers (-j, a
+    comma separated list, 1,2,4 by default), and reports, as JSON:
+
+        files, dirs  - number of regular files and folders walked
+        candidates   - files with an archive's magic number or name
+        archives, failed - candidates that were, and weren't, listed
+        entries      - number of entries listed
+        indexBytes   - size of the index
+        runs         - for each number of workers, the median wall
+                       time (wallMs), the files, archives and entries
+                       listed per second, the archive MB read per
+                       second and the number of files stolen from
+                       another worker's queue
+
+    Each run is repeated (-r), after one warm up run that is not
+    counted.  The index goes to /dev/null unless -w is given, in the
+    format given by -f (ndjson or cbor).  With -m, scanbench instead
+    makes a tree of count files, in folders of BENCHDIRFILES files,
+    in which every BENCHARCHIVEEVERY'th file is a hard link to (or a
+    copy of) one of the given archives, in turn, and the rest are
+    small text files, so that a 100,000 file tree can be made from
+    the corpus.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "records.h"
+#include "scan.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS      100
+#define BENCHMAXRUNS      16
+#define BENCHDIRFILES     100
+#define BENCHARCHIVEEVERY 10
+#define BENCHTEXTLEN      512
+#define BENCHCOPYBUFLEN   65536
+
+/* the result of one number of workers */
+
+typedef struct benchRun
+{
+    int workers;
+    double wallMs;
+    uint64_t steals;
+} benchRun_t;
+
+/* private functions */
+
+static int benchCopyFile(const char *from, const char *to);
+static int benchWriteText(const char *path, unsigned long n);
+static int benchMakeTree(const char *dir,
+                         unsigned long count,
+                         char **archives,
+                         int numArchives);
+static int benchParseWorkers(const char *list, benchRun_t *runs);
+static void printUsage(void);
+
+/* benchCopyFile - copy from to to */
+
+static int benchCopyFile(const char *from, const char *to)
+{
+    char buf[BENCHCOPYBUFLEN];
+    ssize_t n = 0;
+    int in = -1, out = -1;
+    int ret = gBenchOkay;
+
+    in = open(from, O_RDONLY);
+    if (in < 0)
+    {
+        return gBenchErr;
+    }
+
+    out = open(to, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (out < 0)
+    {
+        close(in);
+        return gBenchErr;
+    }
+
+    while ((n = read(in, buf, sizeof(buf))) > 0)
+    {
+        if (write(out, buf, (size_t)n) != n)
+        {
+            ret = gBenchErr;
+            break;
+        }
+    }
+
+    if (n < 0)
+    {
+        ret = gBenchErr;
+    }
+
+    close(in);
+    close(out);
+
+    return ret;
+}
+
+/* benchWriteText - write a small text file that is not an archive */
+
+static int benchWriteText(const char *path, unsigned long n)
+{
+    char buf[BENCHTEXTLEN];
+    size_t len = 0;
+    int fd = -1;
+    int ret = gBenchOkay;
+
+    while (len < sizeof(buf) - 64)
+    {
+        len += (size_t)snprintf(buf + len,
+                                sizeof(buf) - len,
+                                "line %lu of file %lu\n",
+                                (unsigned long)len / 24,
+                                n);
+    }
+
+    fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+    {
+        return gBenchErr;
+    }
+
+    if (write(fd, buf, len) != (ssize_t)len)
+    {
+        ret = gBenchErr;
+    }
+
+    close(fd);
+
+    return ret;
+}
+
+/*
+    benchMakeTree - fill dir with count files in folders of
+                    BENCHDIRFILES, every BENCHARCHIVEEVERY'th of which
+                    is a link to (or a copy of) one of the archives
+*/
+
+static int benchMakeTree(const char *dir,
+                         unsigned long count,
+                         char **archives,
+                         int numArchives)
+{
+    char path[4096];
+    const char *base = NULL;
+    unsigned long i = 0;
+    int a = 0;
+    int rc = gBenchOkay;
+
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr,
+                "scanbench: ERROR: cannot create '%s': %s\n",
+                dir,
+                strerror(errno));
+        return gBenchErr;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (i % BENCHDIRFILES == 0)
+        {
+            snprintf(path,
+                     sizeof(path),
+                     "%s/%04lu",
+                     dir,
+                     i / BENCHDIRFILES);
+            if (mkdir(path, 0755) != 0 && errno != EEXIST)
+            {
+                fprintf(stderr,
+                        "scanbench: ERROR: cannot create '%s': %s\n",
+                        path,
+                        strerror(errno));
+                return gBenchErr;
+            }
+        }
+
+        if (i % BENCHARCHIVEEVERY == 0)
+        {
+            a = (int)((i / BENCHARCHIVEEVERY) % (unsigned long)numArchives);
+            base = strrchr(archives[a], '/');
+            base = (base == NULL ? archives[a] : base + 1);
+
+            snprintf(path,
+                     sizeof(path),
+                     "%s/%04lu/%06lu-%s",
+                     dir,
+                     i / BENCHDIRFILES,
+                     i,
+                     base);
+
+            if (link(archives[a], path) != 0 &&
+                (errno != EXDEV || benchCopyFile(archives[a], path) != 0))
+            {
+                rc = gBenchErr;
+            }
+        }
+        else
+        {
+            snprintf(path,
+                     sizeof(path),
+                     "%s/%04lu/%06lu.txt",
+                     dir,
+                     i / BENCHDIRFILES,
+                     i);
+            rc = benchWriteText(path, i);
+        }
+
+        if (rc != gBenchOkay)
+        {
+            fprintf(stderr,
+                    "scanbench: ERROR: cannot create '%s': %s\n",
+                    path,
+                    strerror(errno));
+            return gBenchErr;
+        }
+    }
+
+    return gBenchOkay;
+}
+
+/*
+    benchParseWorkers - parse a comma separated list of numbers of
+                        workers; returns the number of runs
+*/
+
+static int benchParseWorkers(const char *list, benchRun_t *runs)
+{
+    char *end = NULL;
+    long n = 0;
+    int numRuns = 0;
+
+    while (*list != '\0' && numRuns < BENCHMAXRUNS)
+    {
+        n = strtol(list, &end, 10);
+        if (end == list || n < 1 || n > SCANMAXWORKERS ||
+            (*end != ',' && *end != '\0'))
+        {
+            return 0;
+        }
+
+        memset(&runs[numRuns], 0, sizeof(benchRun_t));
+        runs[numRuns].workers = (int)n;
+        numRuns++;
+
+        list = (*end == ',' ? end + 1 : end);
+    }
+
+    return numRuns;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: scanbench [-j workers,...] [-r repetitions]\n"
+            "                 [-f ndjson | cbor] [-w index]\n"
+            "                 [-o output.json] folder\n"
+            "       scanbench -m count folder archive ...\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t runs[BENCHMAXRUNS];
+    scanOptions_t options;
+    scanStats_t stats;
+    const char *output = NULL;
+    const char *indexPath = "/dev/null";
+    double times[BENCHMAXREPS];
+    double secs = 0.0;
+    uint64_t start = 0;
+    unsigned long makeCount = 0;
+    FILE *fp = stdout;
+    int numRuns = 0;
+    int numReps = 5;
+    int run = 0;
+    int r = 0;
+    int i = 1;
+
+    memset(&options, 0, sizeof(scanOptions_t));
+    options.indexFormat = RecFormatNDJSON;
+    numRuns = benchParseWorkers("1,2,4", runs);
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            numRuns = benchParseWorkers(argv[++i], runs);
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (strcmp(argv[i], "cbor") == 0)
+            {
+                options.indexFormat = RecFormatCBOR;
+            }
+            else if (strcmp(argv[i], "ndjson") != 0)
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+        {
+            indexPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeCount = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (i >= argc || numRuns < 1 || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (makeCount > 0)
+    {
+        if (i + 1 >= argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeTree(argv[i],
+                              makeCount,
+                              argv + i + 1,
+                              argc - i - 1) == gBenchOkay ? 0 : 1);
+    }
+
+    options.root = argv[i];
+
+    /* the first repetition of each run is a warm up and is not counted */
+
+    for (run = 0; run < numRuns; run++)
+    {
+        options.numWorkers = runs[run].workers;
+
+        for (r = -1; r < numReps; r++)
+        {
+            options.indexFd = open(indexPath,
+                                   O_WRONLY | O_CREAT | O_TRUNC | O_APPEND,
+                                   0644);
+            if (options.indexFd < 0)
+            {
+                fprintf(stderr,
+                        "scanbench: ERROR: cannot open '%s': %s\n",
+                        indexPath,
+                        strerror(errno));
+                return 1;
+            }
+
+            start = benchNow();
+            if (scanRun(&options, &stats) != gScanOkay)
+            {
+                fprintf(stderr,
+                        "scanbench: ERROR: cannot scan '%s'\n",
+                        options.root);
+                close(options.indexFd);
+                return 1;
+            }
+            if (r >= 0)
+            {
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+                runs[run].steals += stats.steals;
+            }
+
+            close(options.indexFd);
+        }
+
+        runs[run].wallMs = benchMedian(times, numReps);
+        runs[run].steals /= (uint64_t)numReps;
+    }
+
+    fp = benchOpenOutput("scanbench", output);
+    if (fp == NULL)
+    {
+        return 1;
+    }
+
+    fprintf(fp,
+            "{\n"
+            "  \"files\": %llu,\n"
+            "  \"dirs\": %llu,\n"
+            "  \"candidates\": %llu,\n"
+            "  \"archives\": %llu,\n"
+            "  \"failed\": %llu,\n"
+            "  \"entries\": %llu,\n"
+            "  \"indexBytes\": %llu,\n"
+            "  \"runs\": [\n",
+            (unsigned long long)stats.files,
+            (unsigned long long)stats.dirs,
+            (unsigned long long)stats.candidates,
+            (unsigned long long)stats.archives,
+            (unsigned long long)stats.failed,
+            (unsigned long long)stats.entries,
+            (unsigned long long)stats.indexBytes);
+
+    for (run = 0; run < numRuns; run++)
+    {
+        secs = (runs[run].wallMs > 0.0 ? runs[run].wallMs / 1000.0 : 1e-9);
+        fprintf(fp,
+                "    {\"workers\": %d, \"wallMs\": %.1f, "
+                "\"filesPerSec\": %.0f, \"archivesPerSec\": %.0f, "
+                "\"entriesPerSec\": %.0f, \"mbPerSec\": %.1f, "
+                "\"steals\": %llu}%s\n",
+                runs[run].workers,
+                runs[run].wallMs,
+                (double)stats.files / secs,
+                (double)stats.archives / secs,
+                (double)stats.entries / secs,
+                (double)stats.archiveBytes / secs / 1048576.0,
+                (unsigned long long)runs[run].steals,
+                (run + 1 < numRuns ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    benchCloseOutput(fp);
+
+    return 0;
+}
@@ -0,0 +1,497 @@
+/*
+    storebench.c - benchmark extracting large stored archive members
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    storebench writes the regular files in each of the given tar, cpio
+    or (stored) zip archives to files in a folder, in two ways:
+
+        buffered - archive_read_data_block() and write(), which is
+                   how archive_read_data_into_fd() copied every entry
+        direct   - archive_read_data_into_fd(), which copies a stored
+                   entry straight from the archive file (with
+                   copy_file_range() or sendfile() where they work)
+
+    and reports, as JSON, for each archive:
+
+        archive, format - the archive and libarchive's name for it
+        entries, bytes  - what was written
+        bufferedMs, directMs - the median wall time of each way
+        bufferedMBPerSec, directMBPerSec - the MB written per second
+        speedup         - bufferedMs / directMs
+
+    The zip archives are read with the "zip:ignorecrc32" option, since
+    a zip entry is only copied directly when its CRC32 isn't checked.
+    The output files are removed before each run.  Each run is
+    repeated (-r), after one warm up run that is not counted.  With -m,
+    storebench instead writes BENCHFILES files, of size MB in all, to
+    a folder, to be archived (see "make store").
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* ways to write an entry */
+
+enum
+{
+    gBenchBuffered = 0,
+    gBenchDirect   = 1,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHFILES     4
+#define BENCHBUFLEN    65536
+#define BENCHBLOCKSIZE 65536
+
+/* the result of one archive */
+
+typedef struct benchRun
+{
+    const char *archive;
+    char format[64];
+    uint64_t entries;
+    uint64_t bytes;
+    double wallMs[2];
+} benchRun_t;
+
+/* private functions */
+
+static int benchWriteFile(const char *path, uint64_t size, uint64_t *state);
+static int benchMakeFiles(const char *dir, unsigned long sizeMB);
+static int benchCopyBuffered(struct archive *a, int fd);
+static int benchExtract(benchRun_t *run, const char *dir, int how);
+static void benchRemoveFiles(const char *dir, uint64_t entries);
+static void printUsage(void);
+
+/* benchWriteFile - write size random bytes to path */
+
+static int benchWriteFile(const char *path, uint64_t size, uint64_t *state)
+{
+    uint64_t buf[BENCHBUFLEN / sizeof(uint64_t)];
+    size_t len = 0;
+    size_t i = 0;
+    int fd = -1;
+    int ret = gBenchOkay;
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return gBenchErr;
+    }
+
+    while (size > 0 && ret == gBenchOkay)
+    {
+        len = (size < sizeof(buf) ? (size_t)size : sizeof(buf));
+
+        for (i = 0; i < sizeof(buf) / sizeof(uint64_t); i++)
+        {
+            buf[i] = benchRand(state);
+        }
+
+        if (write(fd, buf, len) != (ssize_t)len)
+        {
+            ret = gBenchErr;
+        }
+
+        size -= len;
+    }
+
+    close(fd);
+
+    return ret;
+}
+
+/* benchMakeFiles - write BENCHFILES files of sizeMB in all to dir */
+
+static int benchMakeFiles(const char *dir, unsigned long sizeMB)
+{
+    char path[4096];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint64_t size = (uint64_t)sizeMB * 1024 * 1024 / BENCHFILES;
+    int i = 0;
+
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr,
+                "storebench: ERROR: cannot create '%s': %s\n",
+                dir,
+                strerror(errno));
+        return gBenchErr;
+    }
+
+    for (i = 0; i < BENCHFILES; i++)
+    {
+        snprintf(path, sizeof(path), "%s/member%d.bin", dir, i);
+        if (benchWriteFile(path, size, &state) != gBenchOkay)
+        {
+            fprintf(stderr,
+                    "storebench: ERROR: cannot create '%s': %s\n",
+                    path,
+                    strerror(errno));
+            return gBenchErr;
+        }
+    }
+
+    return gBenchOkay;
+}
+
+/*
+    benchCopyBuffered - write the current entry's data to fd with
+                        archive_read_data_block() and write()
+*/
+
+static int benchCopyBuffered(struct archive *a, int fd)
+{
+    const void *buf = NULL;
+    size_t size = 0;
+    la_int64_t offset = 0;
+    ssize_t written = 0;
+    int r = ARCHIVE_OK;
+
+    while ((r = archive_read_data_block(a, &buf, &size, &offset)) ==
+           ARCHIVE_OK)
+    {
+        while (size > 0)
+        {
+            written = write(fd, buf, size);
+            if (written < 0)
+            {
+                return gBenchErr;
+            }
+            buf = (const char *)buf + written;
+            size -= (size_t)written;
+        }
+    }
+
+    return (r == ARCHIVE_EOF ? gBenchOkay : gBenchErr);
+}
+
+/*
+    benchExtract - write each regular file in run->archive to a file
+                   in dir, one of the two ways
+*/
+
+static int benchExtract(benchRun_t *run, const char *dir, int how)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    char path[4096];
+    const char *format = NULL;
+    int fd = -1;
+    int r = ARCHIVE_OK;
+    int ret = gBenchOkay;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return gBenchErr;
+    }
+
+    archive_read_support_filter_none(a);
+    archive_read_support_format_tar(a);
+    archive_read_support_format_cpio(a);
+    archive_read_support_format_zip(a);
+    archive_read_set_options(a, "zip:ignorecrc32");
+
+    if (archive_read_open_filename(a, run->archive, BENCHBLOCKSIZE) !=
+        ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "storebench: ERROR: cannot open '%s': %s\n",
+                run->archive,
+                archive_error_string(a));
+        archive_read_free(a);
+        return gBenchErr;
+    }
+
+    run->entries = 0;
+    run->bytes = 0;
+
+    while (ret == gBenchOkay &&
+           (r = archive_read_next_header(a, &entry)) == ARCHIVE_OK)
+    {
+        if (archive_entry_filetype(entry) != AE_IFREG)
+        {
+            continue;
+        }
+
+        snprintf(path,
+                 sizeof(path),
+                 "%s/%06llu",
+                 dir,
+                 (unsigned long long)run->entries);
+
+        fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            fprintf(stderr,
+                    "storebench: ERROR: cannot create '%s': %s\n",
+                    path,
+                    strerror(errno));
+            ret = gBenchErr;
+            break;
+        }
+
+        if (how == gBenchDirect)
+        {
+            if (archive_read_data_into_fd(a, fd) != ARCHIVE_OK)
+            {
+                ret = gBenchErr;
+            }
+        }
+        else
+        {
+            ret = benchCopyBuffered(a, fd);
+        }
+
+        close(fd);
+
+        if (ret != gBenchOkay)
+        {
+            fprintf(stderr,
+                    "storebench: ERROR: cannot write '%s': %s\n",
+                    path,
+                    archive_error_string(a));
+            break;
+        }
+
+        run->entries++;
+        run->bytes += (uint64_t)archive_entry_size(entry);
+    }
+
+    if (ret == gBenchOkay && r != ARCHIVE_EOF)
+    {
+        fprintf(stderr,
+                "storebench: ERROR: cannot read '%s': %s\n",
+                run->archive,
+                archive_error_string(a));
+        ret = gBenchErr;
+    }
+
+    format = archive_format_name(a);
+    snprintf(run->format,
+             sizeof(run->format),
+             "%s",
+             (format != NULL ? format : ""));
+
+    archive_read_free(a);
+
+    return ret;
+}
+
+/* benchRemoveFiles - remove the files that benchExtract() wrote */
+
+static void benchRemoveFiles(const char *dir, uint64_t entries)
+{
+    char path[4096];
+    uint64_t i = 0;
+
+    for (i = 0; i < entries; i++)
+    {
+        snprintf(path, sizeof(path), "%s/%06llu", dir, (unsigned long long)i);
+        unlink(path);
+    }
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: storebench [-r repetitions] [-o output.json]\n"
+            "                  folder archive ...\n"
+            "       storebench -m size MB folder\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t *runs = NULL;
+    const char *output = NULL;
+    const char *dir = NULL;
+    double times[BENCHMAXREPS];
+    double secs[2];
+    uint64_t start = 0;
+    unsigned long makeMB = 0;
+    FILE *fp = stdout;
+    int numRuns = 0;
+    int numReps = 3;
+    int run = 0;
+    int how = 0;
+    int r = 0;
+    int i = 1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeMB = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeMB > 0)
+    {
+        if (i + 1 != argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeFiles(argv[i], makeMB) == gBenchOkay ? 0 : 1);
+    }
+
+    if (i + 2 > argc || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    dir = argv[i++];
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr,
+                "storebench: ERROR: cannot create '%s': %s\n",
+                dir,
+                strerror(errno));
+        return 1;
+    }
+
+    numRuns = argc - i;
+    runs = calloc((size_t)numRuns, sizeof(benchRun_t));
+    if (runs == NULL)
+    {
+        return 1;
+    }
+
+    /* the first repetition of each way is a warm up and is not counted */
+
+    for (run = 0; run < numRuns; run++)
+    {
+        runs[run].archive = argv[i + run];
+
+        for (how = gBenchBuffered; how <= gBenchDirect; how++)
+        {
+            for (r = -1; r < numReps; r++)
+            {
+                benchRemoveFiles(dir, runs[run].entries);
+                sync();
+
+                start = benchNow();
+                if (benchExtract(&runs[run], dir, how) != gBenchOkay)
+                {
+                    free(runs);
+                    return 1;
+                }
+                if (r >= 0)
+                {
+                    times[r] = (double)(benchNow() - start) / 1000000.0;
+                }
+            }
+
+            runs[run].wallMs[how] = benchMedian(times, numReps);
+        }
+
+        benchRemoveFiles(dir, runs[run].entries);
+    }
+
+    fp = benchOpenOutput("storebench", output);
+    if (fp == NULL)
+    {
+        free(runs);
+        return 1;
+    }
+
+    fprintf(fp, "{\n  \"runs\": [\n");
+
+    for (run = 0; run < numRuns; run++)
+    {
+        for (how = gBenchBuffered; how <= gBenchDirect; how++)
+        {
+            secs[how] = (runs[run].wallMs[how] > 0.0 ?
+                         runs[run].wallMs[how] / 1000.0 : 1e-9);
+        }
+
+        fprintf(fp,
+                "    {\"archive\": \"%s\", \"format\": \"%s\", "
+                "\"entries\": %llu, \"bytes\": %llu,\n"
+                "     \"bufferedMs\": %.1f, \"bufferedMBPerSec\": %.1f, "
+                "\"directMs\": %.1f, \"directMBPerSec\": %.1f, "
+                "\"speedup\": %.2f}%s\n",
+                runs[run].archive,
+                runs[run].format,
+                (unsigned long long)runs[run].entries,
+                (unsigned long long)runs[run].bytes,
+                runs[run].wallMs[gBenchBuffered],
+                (double)runs[run].bytes / secs[gBenchBuffered] / 1048576.0,
+                runs[run].wallMs[gBenchDirect],
+                (double)runs[run].bytes / secs[gBenchDirect] / 1048576.0,
+                secs[gBenchBuffered] / secs[gBenchDirect],
+                (run + 1 < numRuns ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    benchCloseOutput(fp);
+
+    free(runs);
+
+    return 0;
+}
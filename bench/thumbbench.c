@@ -0,0 +1,553 @@
+/*
+    thumbbench.c - benchmark making thumbnails for a folder of archives
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    thumbbench makes a thumbnail, the way GenerateThumbnailForURL
+    does (summaryRead() and then thumbRender()), for every file in a
+    folder, and reports, as JSON:
+
+        files        - number of files
+        p50Us, p90Us, p99Us, maxUs - percentiles of the files' median
+                       times, in microseconds
+        overBudget   - number of files whose median time is over the
+                       budget (-b, 5000us by default)
+        filesPerSec  - based on the sum of the median times
+        formats      - the number of files, the mean and maximum time,
+                       and the number of files with an entry count and
+                       with sizes, for each format
+
+    Each pass over the folder is repeated (-r), after one warm up
+    pass that is not counted.  With -m, thumbbench instead fills the
+    folder with count hard links (or copies, if the folder is on
+    another file system) to the given archives, in turn, so that a
+    folder of 10,000 mixed archives can be made from the corpus.
+    With -i, the first thumbnail of each format is written to the
+    given folder as a PPM image.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "summary.h"
+#include "thumbnail.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS    100
+#define BENCHMAXFILES   1000000
+#define BENCHBUDGETUS   5000
+#define BENCHCOPYBUFLEN 65536
+
+/* per format results */
+
+typedef struct benchFormat
+{
+    unsigned long count;
+    unsigned long withEntries;
+    unsigned long withSizes;
+    double totalUs;
+    double maxUs;
+    int imageWritten;
+} benchFormat_t;
+
+/* private functions */
+
+static int benchCompareString(const void *a, const void *b);
+static double benchPercentile(const double *sorted, size_t count, double p);
+static int benchCopyFile(const char *from, const char *to);
+static int benchMakeFolder(const char *dir,
+                           unsigned long count,
+                           char **archives,
+                           int numArchives);
+static char **benchListFolder(const char *dir, size_t *numFiles);
+static int benchWritePPM(const char *dir,
+                         const char *name,
+                         const thumbImage_t *image);
+static void printUsage(void);
+
+/* benchCompareString - qsort() comparison function for strings */
+
+static int benchCompareString(const void *a, const void *b)
+{
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+/* benchPercentile - get the p'th percentile of sorted values */
+
+static double benchPercentile(const double *sorted, size_t count, double p)
+{
+    size_t i = 0;
+
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    i = (size_t)(p / 100.0 * (double)(count - 1) + 0.5);
+
+    return sorted[i < count ? i : count - 1];
+}
+
+/* benchCopyFile - copy from to to */
+
+static int benchCopyFile(const char *from, const char *to)
+{
+    char buf[BENCHCOPYBUFLEN];
+    ssize_t n = 0;
+    int in = -1, out = -1;
+    int ret = gBenchOkay;
+
+    in = open(from, O_RDONLY);
+    if (in < 0)
+    {
+        return gBenchErr;
+    }
+
+    out = open(to, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (out < 0)
+    {
+        close(in);
+        return gBenchErr;
+    }
+
+    while ((n = read(in, buf, sizeof(buf))) > 0)
+    {
+        if (write(out, buf, (size_t)n) != n)
+        {
+            ret = gBenchErr;
+            break;
+        }
+    }
+
+    if (n < 0)
+    {
+        ret = gBenchErr;
+    }
+
+    close(in);
+    close(out);
+
+    return ret;
+}
+
+/*
+    benchMakeFolder - fill dir with count links to (or copies of) the
+                      archives, in turn
+*/
+
+static int benchMakeFolder(const char *dir,
+                           unsigned long count,
+                           char **archives,
+                           int numArchives)
+{
+    char path[4096];
+    const char *base = NULL;
+    unsigned long i = 0;
+    int a = 0;
+
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr,
+                "thumbbench: ERROR: cannot create '%s': %s\n",
+                dir,
+                strerror(errno));
+        return gBenchErr;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        a = (int)(i % (unsigned long)numArchives);
+        base = strrchr(archives[a], '/');
+        base = (base == NULL ? archives[a] : base + 1);
+
+        snprintf(path, sizeof(path), "%s/%06lu-%s", dir, i, base);
+
+        if (link(archives[a], path) != 0 &&
+            (errno != EXDEV || benchCopyFile(archives[a], path) != 0))
+        {
+            fprintf(stderr,
+                    "thumbbench: ERROR: cannot create '%s': %s\n",
+                    path,
+                    strerror(errno));
+            return gBenchErr;
+        }
+    }
+
+    return gBenchOkay;
+}
+
+/* benchListFolder - get the sorted paths of the files in dir */
+
+static char **benchListFolder(const char *dir, size_t *numFiles)
+{
+    DIR *d = NULL;
+    struct dirent *de = NULL;
+    char **files = NULL;
+    char **newFiles = NULL;
+    size_t capacity = 0;
+    size_t len = 0;
+
+    *numFiles = 0;
+
+    d = opendir(dir);
+    if (d == NULL)
+    {
+        fprintf(stderr,
+                "thumbbench: ERROR: cannot open '%s': %s\n",
+                dir,
+                strerror(errno));
+        return NULL;
+    }
+
+    while ((de = readdir(d)) != NULL && *numFiles < BENCHMAXFILES)
+    {
+        if (de->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        if (*numFiles == capacity)
+        {
+            capacity = (capacity == 0 ? 1024 : capacity * 2);
+            newFiles = realloc(files, capacity * sizeof(char *));
+            if (newFiles == NULL)
+            {
+                break;
+            }
+            files = newFiles;
+        }
+
+        len = strlen(dir) + strlen(de->d_name) + 2;
+        files[*numFiles] = malloc(len);
+        if (files[*numFiles] == NULL)
+        {
+            break;
+        }
+        snprintf(files[*numFiles], len, "%s/%s", dir, de->d_name);
+        (*numFiles)++;
+    }
+
+    closedir(d);
+
+    if (files != NULL)
+    {
+        qsort(files, *numFiles, sizeof(char *), benchCompareString);
+    }
+
+    return files;
+}
+
+/* benchWritePPM - write image to dir/name.ppm */
+
+static int benchWritePPM(const char *dir,
+                         const char *name,
+                         const thumbImage_t *image)
+{
+    char path[4096];
+    FILE *fp = NULL;
+    size_t x = 0, y = 0;
+
+    snprintf(path, sizeof(path), "%s/%s.ppm", dir, name);
+
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        return gBenchErr;
+    }
+
+    fprintf(fp, "P6\n%zu %zu\n255\n", image->width, image->height);
+
+    for (y = 0; y < image->height; y++)
+    {
+        for (x = 0; x < image->width; x++)
+        {
+            fwrite(image->pixels + y * image->bytesPerRow + x * 4, 1, 3, fp);
+        }
+    }
+
+    fclose(fp);
+
+    return gBenchOkay;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: thumbbench [-r repetitions] [-s size] [-b budget us]\n"
+            "                  [-o output.json] [-i image dir] folder\n"
+            "       thumbbench -m count folder archive ...\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchFormat_t formats[SummaryFormatMax];
+    summary_t summary;
+    thumbImage_t image;
+    const char *output = NULL;
+    const char *imageDir = NULL;
+    char **files = NULL;
+    double *times = NULL;
+    double *medians = NULL;
+    double reps[BENCHMAXREPS];
+    double totalUs = 0.0;
+    uint64_t start = 0;
+    unsigned long makeCount = 0;
+    unsigned long overBudget = 0;
+    size_t numFiles = 0;
+    size_t size = 256;
+    size_t f = 0;
+    FILE *fp = stdout;
+    int budgetUs = BENCHBUDGETUS;
+    int numReps = 5;
+    int first = 1;
+    int r = 0;
+    int i = 1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            size = (size_t)atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+        {
+            budgetUs = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+        {
+            imageDir = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeCount = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (i >= argc || numReps < 1 || numReps > BENCHMAXREPS ||
+        size < THUMBMINSIZE || size > THUMBMAXSIZE)
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (makeCount > 0)
+    {
+        if (i + 1 >= argc)
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeFolder(argv[i],
+                                makeCount,
+                                argv + i + 1,
+                                argc - i - 1) == gBenchOkay ? 0 : 1);
+    }
+
+    files = benchListFolder(argv[i], &numFiles);
+    if (files == NULL || numFiles == 0)
+    {
+        fprintf(stderr, "thumbbench: ERROR: no files in '%s'\n", argv[i]);
+        return 1;
+    }
+
+    times = calloc(numFiles * (size_t)numReps, sizeof(double));
+    medians = calloc(numFiles, sizeof(double));
+    image.width = size;
+    image.height = size;
+    image.bytesPerRow = size * 4;
+    image.pixels = malloc(image.bytesPerRow * image.height);
+    if (times == NULL || medians == NULL || image.pixels == NULL)
+    {
+        fprintf(stderr, "thumbbench: ERROR: out of memory\n");
+        return 1;
+    }
+
+    memset(formats, 0, sizeof(formats));
+
+    /* the first pass warms the page cache and is not counted */
+
+    for (r = -1; r < numReps; r++)
+    {
+        for (f = 0; f < numFiles; f++)
+        {
+            start = benchNow();
+            summaryRead(files[f], &summary);
+            thumbRender(&summary, &image);
+            if (r >= 0)
+            {
+                times[f * (size_t)numReps + (size_t)r] =
+                    (double)(benchNow() - start) / 1000.0;
+                continue;
+            }
+
+            if (imageDir != NULL && !formats[summary.format].imageWritten)
+            {
+                benchWritePPM(imageDir,
+                              summaryFormatName(summary.format),
+                              &image);
+                formats[summary.format].imageWritten = 1;
+            }
+        }
+    }
+
+    /* each file's time is the median of its passes */
+
+    for (f = 0; f < numFiles; f++)
+    {
+        memcpy(reps, times + f * (size_t)numReps, numReps * sizeof(double));
+        qsort(reps, (size_t)numReps, sizeof(double), benchCompareDouble);
+        medians[f] = reps[numReps / 2];
+        totalUs += medians[f];
+
+        if (medians[f] > budgetUs)
+        {
+            overBudget++;
+        }
+
+        summaryRead(files[f], &summary);
+        formats[summary.format].count++;
+        formats[summary.format].totalUs += medians[f];
+        if (medians[f] > formats[summary.format].maxUs)
+        {
+            formats[summary.format].maxUs = medians[f];
+        }
+        if (summary.hasEntries)
+        {
+            formats[summary.format].withEntries++;
+        }
+        if (summary.hasSizes)
+        {
+            formats[summary.format].withSizes++;
+        }
+    }
+
+    qsort(medians, numFiles, sizeof(double), benchCompareDouble);
+
+    fp = benchOpenOutput("thumbbench", output);
+    if (fp == NULL)
+    {
+        return 1;
+    }
+
+    fprintf(fp,
+            "{\n  \"files\": %zu,\n  \"size\": %zu,\n"
+            "  \"repetitions\": %d,\n  \"budgetUs\": %d,\n"
+            "  \"p50Us\": %.1f,\n  \"p90Us\": %.1f,\n"
+            "  \"p99Us\": %.1f,\n  \"maxUs\": %.1f,\n"
+            "  \"overBudget\": %lu,\n  \"filesPerSec\": %.0f,\n"
+            "  \"formats\": [",
+            numFiles,
+            size,
+            numReps,
+            budgetUs,
+            benchPercentile(medians, numFiles, 50.0),
+            benchPercentile(medians, numFiles, 90.0),
+            benchPercentile(medians, numFiles, 99.0),
+            medians[numFiles - 1],
+            overBudget,
+            (totalUs > 0.0 ? (double)numFiles * 1000000.0 / totalUs : 0.0));
+
+    for (i = 0; i < SummaryFormatMax; i++)
+    {
+        if (formats[i].count == 0)
+        {
+            continue;
+        }
+
+        fprintf(fp,
+                "%s\n    { \"format\": \"%s\", \"files\": %lu, "
+                "\"meanUs\": %.1f, \"maxUs\": %.1f, "
+                "\"withEntries\": %lu, \"withSizes\": %lu }",
+                (first ? "" : ","),
+                summaryFormatName((summaryFormat_t)i),
+                formats[i].count,
+                formats[i].totalUs / (double)formats[i].count,
+                formats[i].maxUs,
+                formats[i].withEntries,
+                formats[i].withSizes);
+        first = 0;
+    }
+
+    fprintf(fp, "\n  ]\n}\n");
+
+    benchCloseOutput(fp);
+
+    fprintf(stderr,
+            "%zu files: p50 %.1fus, p99 %.1fus, max %.1fus, "
+            "%lu over %dus\n",
+            numFiles,
+            benchPercentile(medians, numFiles, 50.0),
+            benchPercentile(medians, numFiles, 99.0),
+            medians[numFiles - 1],
+            overBudget,
+            budgetUs);
+
+    for (f = 0; f < numFiles; f++)
+    {
+        free(files[f]);
+    }
+    free(files);
+    free(times);
+    free(medians);
+    free(image.pixels);
+
+    return (overBudget == 0 ? 0 : 2);
+}
@@ -0,0 +1,1113 @@
+/*
+    udifbench.c - benchmark listing a UDIF disk image
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    udifbench lists the files of a UDIF disk image (.dmg) of an ISO 9660
+    file system with libarchive's udif filter and iso9660 reader, and
+    then reads all of their data, with each of the given numbers of
+    threads (-j, a comma separated list, 1,2,4 by default, set with the
+    "udif:threads" option), and reports, as JSON:
+
+        entries, bytes - the image's entries and the bytes of their data
+        runs           - for each number of threads, the median wall
+                         time to list the image (listMs), which only
+                         decodes the chunks that hold its directories,
+                         and to read all of the data (readMs), the MB
+                         of data read per second and the speed up of
+                         reading over the first run
+
+    Each run is repeated (-r), after one warm up run that is not
+    counted.  With -m, udifbench instead writes an image of size MB of
+    files of BENCHMINFILE to BENCHMAXFILE bytes, BENCHDIRFILES to a
+    directory, laid out as mkisofs does, with the directories ahead of
+    the files' data, in chunks of BENCHCHUNK bytes compressed with zlib,
+    bzip2 or lzma (-c, zlib by default).  The files are text from a 16
+    letter alphabet, so that they compress to about half of their size.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <zlib.h>
+#include <bzlib.h>
+#include <lzma.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS    100
+#define BENCHMAXRUNS    16
+#define BENCHMAXTHREADS 16
+#define BENCHMINFILE    (4 * 1024)
+#define BENCHMAXFILE    (1024 * 1024)
+#define BENCHDIRFILES   100
+#define BENCHCHUNK      (1024 * 1024)
+#define BENCHSECTOR     2048
+#define BENCHDMGSECTOR  512
+#define BENCHPRESET     6
+#define BENCHDIRSECTORS 64
+#define BENCHREADSIZE   65536
+
+/* UDIF chunk types */
+
+#define BENCHZERO       0x00000002
+#define BENCHRAW        0x00000001
+#define BENCHZLIB       0x80000005
+#define BENCHBZIP2      0x80000006
+#define BENCHLZMA       0x80000008
+#define BENCHEND        0xffffffff
+
+/* the result of one number of threads */
+
+typedef struct benchRun
+{
+    int threads;
+    double listMs;
+    double readMs;
+} benchRun_t;
+
+/* an image being written */
+
+typedef struct benchImage
+{
+    FILE *fp;
+    uint32_t type;
+    unsigned char *chunk;
+    size_t chunkLen;
+    unsigned char *packed;
+    size_t packedLen;
+    unsigned char *mish;
+    size_t mishLen;
+    size_t mishAlloc;
+    uint64_t sectors;
+    uint64_t offset;
+} benchImage_t;
+
+/* private functions */
+
+static void benchPut16(unsigned char *p, uint16_t v);
+static void benchPut32(unsigned char *p, uint32_t v);
+static void benchPut64(unsigned char *p, uint64_t v);
+static void benchBoth16(unsigned char *p, uint16_t v);
+static void benchBoth32(unsigned char *p, uint32_t v);
+static int benchAddChunk(benchImage_t *image,
+                         uint32_t type,
+                         uint64_t sectors,
+                         uint64_t length);
+static int benchFlush(benchImage_t *image);
+static int benchWrite(benchImage_t *image,
+                      const void *data,
+                      size_t len);
+static size_t benchRecord(unsigned char *p,
+                          const char *name,
+                          size_t nameLen,
+                          uint32_t extent,
+                          uint32_t size,
+                          int isDir);
+static int benchWriteDir(benchImage_t *image,
+                         uint32_t self,
+                         uint32_t sectors,
+                         uint32_t parent,
+                         uint32_t parentSectors,
+                         unsigned long first,
+                         unsigned long count,
+                         const uint32_t *extents,
+                         const uint32_t *sizes,
+                         int isRoot);
+static int benchWriteTrailer(benchImage_t *image);
+static int benchMakeImage(const char *path,
+                          unsigned long sizeMB,
+                          uint32_t type);
+static int benchList(const char *path,
+                     int threads,
+                     int readData,
+                     uint64_t *entries,
+                     uint64_t *bytes);
+static int benchParseThreads(const char *list, benchRun_t *runs);
+static void printUsage(void);
+
+/* benchPut16 - put a little endian 16 bit value */
+
+static void benchPut16(unsigned char *p, uint16_t v)
+{
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+}
+
+/* benchPut32 - put a big endian 32 bit value */
+
+static void benchPut32(unsigned char *p, uint32_t v)
+{
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+/* benchPut64 - put a big endian 64 bit value */
+
+static void benchPut64(unsigned char *p, uint64_t v)
+{
+    benchPut32(p, (uint32_t)(v >> 32));
+    benchPut32(p + 4, (uint32_t)v);
+}
+
+/* benchBoth16 - put an ISO 9660 both endian 16 bit value */
+
+static void benchBoth16(unsigned char *p, uint16_t v)
+{
+    benchPut16(p, v);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+/* benchBoth32 - put an ISO 9660 both endian 32 bit value */
+
+static void benchBoth32(unsigned char *p, uint32_t v)
+{
+    benchPut16(p, (uint16_t)v);
+    benchPut16(p + 2, (uint16_t)(v >> 16));
+    benchPut32(p + 4, v);
+}
+
+/* benchAddChunk - add a chunk to the image's mish table */
+
+static int benchAddChunk(benchImage_t *image,
+                         uint32_t type,
+                         uint64_t sectors,
+                         uint64_t length)
+{
+    unsigned char *p = NULL;
+
+    if (image->mishLen + 40 > image->mishAlloc)
+    {
+        p = realloc(image->mish, image->mishAlloc * 2);
+        if (p == NULL)
+        {
+            return gBenchErr;
+        }
+        image->mish = p;
+        image->mishAlloc *= 2;
+    }
+
+    p = image->mish + image->mishLen;
+    memset(p, 0, 40);
+    benchPut32(p, type);
+    benchPut64(p + 8, image->sectors);
+    benchPut64(p + 16, sectors);
+    benchPut64(p + 24, image->offset);
+    benchPut64(p + 32, length);
+
+    image->mishLen += 40;
+    image->sectors += sectors;
+    image->offset += length;
+
+    return gBenchOkay;
+}
+
+/*
+    benchFlush - compress the current chunk and write it to the image;
+                 a chunk of zeros is only added to the table, and a
+                 chunk that doesn't compress is written as is
+*/
+
+static int benchFlush(benchImage_t *image)
+{
+    uLongf zLen = 0;
+    unsigned int bzLen = 0;
+    size_t xzPos = 0;
+    size_t len = 0;
+    size_t i = 0;
+    uint32_t type = image->type;
+
+    if (image->chunkLen == 0)
+    {
+        return gBenchOkay;
+    }
+
+    for (i = 0; i < image->chunkLen && image->chunk[i] == 0; i++)
+    {
+    }
+    if (i == image->chunkLen)
+    {
+        image->chunkLen = 0;
+        return benchAddChunk(image,
+                             BENCHZERO,
+                             i / BENCHDMGSECTOR,
+                             0);
+    }
+
+    switch (type)
+    {
+        case BENCHZLIB:
+            zLen = (uLongf)image->packedLen;
+            if (compress2(image->packed,
+                          &zLen,
+                          image->chunk,
+                          (uLong)image->chunkLen,
+                          Z_DEFAULT_COMPRESSION) == Z_OK)
+            {
+                len = (size_t)zLen;
+            }
+            break;
+        case BENCHBZIP2:
+            bzLen = (unsigned int)image->packedLen;
+            if (BZ2_bzBuffToBuffCompress((char *)image->packed,
+                                         &bzLen,
+                                         (char *)image->chunk,
+                                         (unsigned int)image->chunkLen,
+                                         9,
+                                         0,
+                                         0) == BZ_OK)
+            {
+                len = bzLen;
+            }
+            break;
+        default:
+            if (lzma_easy_buffer_encode(BENCHPRESET,
+                                        LZMA_CHECK_CRC64,
+                                        NULL,
+                                        image->chunk,
+                                        image->chunkLen,
+                                        image->packed,
+                                        &xzPos,
+                                        image->packedLen) == LZMA_OK)
+            {
+                len = xzPos;
+            }
+            break;
+    }
+
+    if (len == 0 || len >= image->chunkLen)
+    {
+        type = BENCHRAW;
+        len = image->chunkLen;
+    }
+
+    if (fwrite((type == BENCHRAW ? image->chunk : image->packed),
+               1,
+               len,
+               image->fp) != len ||
+        benchAddChunk(image,
+                      type,
+                      image->chunkLen / BENCHDMGSECTOR,
+                      len) != gBenchOkay)
+    {
+        return gBenchErr;
+    }
+
+    image->chunkLen = 0;
+
+    return gBenchOkay;
+}
+
+/* benchWrite - add data to the image's chunks */
+
+static int benchWrite(benchImage_t *image,
+                      const void *data,
+                      size_t len)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    size_t n = 0;
+
+    while (len > 0)
+    {
+        n = BENCHCHUNK - image->chunkLen;
+        if (n > len)
+        {
+            n = len;
+        }
+
+        if (p != NULL)
+        {
+            memcpy(image->chunk + image->chunkLen, p, n);
+            p += n;
+        }
+        else
+        {
+            memset(image->chunk + image->chunkLen, 0, n);
+        }
+        image->chunkLen += n;
+        len -= n;
+
+        if (image->chunkLen == BENCHCHUNK &&
+            benchFlush(image) != gBenchOkay)
+        {
+            return gBenchErr;
+        }
+    }
+
+    return gBenchOkay;
+}
+
+/* benchRecord - make an ISO 9660 directory record; returns its length */
+
+static size_t benchRecord(unsigned char *p,
+                          const char *name,
+                          size_t nameLen,
+                          uint32_t extent,
+                          uint32_t size,
+                          int isDir)
+{
+    size_t len = 33 + nameLen + (nameLen % 2 == 0 ? 1 : 0);
+
+    memset(p, 0, len);
+    p[0] = (unsigned char)len;
+    benchBoth32(p + 2, extent);
+    benchBoth32(p + 10, size);
+
+    /* 2026-10-17 00:00:00 GMT */
+
+    p[18] = 126;
+    p[19] = 10;
+    p[20] = 17;
+    p[25] = (isDir ? 2 : 0);
+    benchBoth16(p + 28, 1);
+    p[32] = (unsigned char)nameLen;
+    memcpy(p + 33, name, nameLen);
+
+    return len;
+}
+
+/*
+    benchWriteDir - write a directory of the given sectors at sector
+                    self, of count files from first, or of count
+                    directories for the root
+*/
+
+static int benchWriteDir(benchImage_t *image,
+                         uint32_t self,
+                         uint32_t sectors,
+                         uint32_t parent,
+                         uint32_t parentSectors,
+                         unsigned long first,
+                         unsigned long count,
+                         const uint32_t *extents,
+                         const uint32_t *sizes,
+                         int isRoot)
+{
+    unsigned char dir[BENCHDIRSECTORS * BENCHSECTOR];
+    unsigned char record[256];
+    char name[32];
+    size_t pos = 0;
+    size_t len = 0;
+    unsigned long i = 0;
+
+    if (sectors > BENCHDIRSECTORS)
+    {
+        return gBenchErr;
+    }
+
+    memset(dir, 0, sizeof(dir));
+
+    pos += benchRecord(dir + pos, "\0", 1, self, sectors * BENCHSECTOR, 1);
+    pos += benchRecord(dir + pos, "\1", 1, parent,
+                       parentSectors * BENCHSECTOR, 1);
+
+    for (i = 0; i < count; i++)
+    {
+        if (isRoot)
+        {
+            snprintf(name, sizeof(name), "D%04lu", i);
+        }
+        else
+        {
+            snprintf(name, sizeof(name), "F%06lu.TXT;1", first + i);
+        }
+
+        len = benchRecord(record,
+                          name,
+                          strlen(name),
+                          extents[first + i],
+                          sizes[first + i],
+                          isRoot);
+
+        /* records don't cross sectors */
+
+        if (pos / BENCHSECTOR != (pos + len - 1) / BENCHSECTOR)
+        {
+            pos = (pos / BENCHSECTOR + 1) * BENCHSECTOR;
+        }
+        if (pos + len > sectors * BENCHSECTOR)
+        {
+            return gBenchErr;
+        }
+
+        memcpy(dir + pos, record, len);
+        pos += len;
+    }
+
+    return benchWrite(image, dir, sectors * BENCHSECTOR);
+}
+
+/*
+    benchWriteTrailer - write the property list with the mish table,
+                        and the koly trailer
+*/
+
+static int benchWriteTrailer(benchImage_t *image)
+{
+    static const char b64[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    unsigned char koly[512];
+    unsigned char *mish = image->mish;
+    uint64_t dataLength = image->offset;
+    uint64_t xmlOffset = image->offset;
+    long xmlStart = 0;
+    long xmlEnd = 0;
+    uint32_t v = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    if (benchAddChunk(image, BENCHEND, 0, 0) != gBenchOkay)
+    {
+        return gBenchErr;
+    }
+    mish = image->mish;
+
+    memcpy(mish, "mish", 4);
+    benchPut32(mish + 4, 1);
+    benchPut64(mish + 16, image->sectors);
+    benchPut32(mish + 200,
+               (uint32_t)((image->mishLen - 204) / 40));
+
+    xmlStart = ftell(image->fp);
+    fprintf(image->fp,
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<!DOCTYPE plist PUBLIC \"-//Apple//DTD PLIST 1.0//EN\" "
+            "\"http://www.apple.com/DTDs/PropertyList-1.0.dtd\">\n"
+            "<plist version=\"1.0\">\n<dict>\n"
+            "\t<key>resource-fork</key>\n\t<dict>\n"
+            "\t\t<key>blkx</key>\n\t\t<array>\n\t\t\t<dict>\n"
+            "\t\t\t\t<key>Attributes</key>\n"
+            "\t\t\t\t<string>0x0050</string>\n"
+            "\t\t\t\t<key>CFName</key>\n"
+            "\t\t\t\t<string>whole disk (ISO : 0)</string>\n"
+            "\t\t\t\t<key>Data</key>\n\t\t\t\t<data>\n\t\t\t\t");
+
+    for (i = 0; i < image->mishLen; i += 3)
+    {
+        v = (uint32_t)mish[i] << 16;
+        if (i + 1 < image->mishLen)
+        {
+            v |= (uint32_t)mish[i + 1] << 8;
+        }
+        if (i + 2 < image->mishLen)
+        {
+            v |= mish[i + 2];
+        }
+
+        fputc(b64[(v >> 18) & 63], image->fp);
+        fputc(b64[(v >> 12) & 63], image->fp);
+        fputc(i + 1 < image->mishLen ? b64[(v >> 6) & 63] : '=',
+              image->fp);
+        fputc(i + 2 < image->mishLen ? b64[v & 63] : '=', image->fp);
+
+        j += 4;
+        if (j % 52 == 0)
+        {
+            fputs("\n\t\t\t\t", image->fp);
+        }
+    }
+
+    fprintf(image->fp,
+            "\n\t\t\t\t</data>\n"
+            "\t\t\t\t<key>ID</key>\n\t\t\t\t<string>0</string>\n"
+            "\t\t\t\t<key>Name</key>\n"
+            "\t\t\t\t<string>whole disk (ISO : 0)</string>\n"
+            "\t\t\t</dict>\n\t\t</array>\n\t</dict>\n</dict>\n</plist>\n");
+    xmlEnd = ftell(image->fp);
+    if (xmlStart < 0 || xmlEnd < xmlStart)
+    {
+        return gBenchErr;
+    }
+
+    memset(koly, 0, sizeof(koly));
+    memcpy(koly, "koly", 4);
+    benchPut32(koly + 4, 4);
+    benchPut32(koly + 8, sizeof(koly));
+    benchPut32(koly + 12, 1);
+    benchPut64(koly + 32, dataLength);
+    benchPut32(koly + 56, 1);
+    benchPut32(koly + 60, 1);
+    benchPut64(koly + 216, xmlOffset);
+    benchPut64(koly + 224, (uint64_t)(xmlEnd - xmlStart));
+    benchPut32(koly + 488, 1);
+    benchPut64(koly + 492, image->sectors);
+
+    if (fwrite(koly, 1, sizeof(koly), image->fp) != sizeof(koly))
+    {
+        return gBenchErr;
+    }
+
+    return gBenchOkay;
+}
+
+/*
+    benchMakeImage - write a UDIF image of an ISO 9660 file system of
+                     sizeMB of files to path
+*/
+
+static int benchMakeImage(const char *path,
+                          unsigned long sizeMB,
+                          uint32_t type)
+{
+    static const char alphabet[] = "abcdefghijklmnop";
+    benchImage_t image;
+    unsigned char sector[BENCHSECTOR];
+    unsigned char *data = NULL;
+    uint32_t *extents = NULL;
+    uint32_t *sizes = NULL;
+    uint32_t *dirExtents = NULL;
+    uint32_t *dirSizes = NULL;
+    uint32_t next = 0;
+    uint32_t rootSectors = 0;
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint64_t remaining = (uint64_t)sizeMB * 1024 * 1024;
+    uint64_t bits = 0;
+    unsigned long numFiles = 0;
+    unsigned long numDirs = 0;
+    unsigned long i = 0;
+    unsigned long n = 0;
+    size_t j = 0;
+    size_t size = 0;
+    int ret = gBenchErr;
+
+    memset(&image, 0, sizeof(image));
+    image.type = type;
+
+    /* pick the files' sizes */
+
+    n = (unsigned long)(remaining / BENCHMINFILE) + 1;
+    sizes = calloc(n, sizeof(uint32_t));
+    extents = calloc(n, sizeof(uint32_t));
+    if (sizes == NULL || extents == NULL)
+    {
+        goto done;
+    }
+
+    for (numFiles = 0; remaining > 0; numFiles++)
+    {
+        size = BENCHMINFILE +
+               (size_t)(benchRand(&state) %
+                        (BENCHMAXFILE - BENCHMINFILE + 1));
+        if (size > remaining)
+        {
+            size = (size_t)remaining;
+        }
+        sizes[numFiles] = (uint32_t)size;
+        remaining -= size;
+    }
+
+    numDirs = (numFiles + BENCHDIRFILES - 1) / BENCHDIRFILES;
+    dirSizes = calloc(numDirs, sizeof(uint32_t));
+    dirExtents = calloc(numDirs, sizeof(uint32_t));
+    if (dirSizes == NULL || dirExtents == NULL ||
+        numDirs > 40 * BENCHDIRSECTORS)
+    {
+        goto done;
+    }
+
+    /*
+        lay out the volume descriptors, the path tables, the root,
+        the directories and then the files; a directory record is at
+        most 46 bytes, so 44 fit in a sector
+    */
+
+    next = 20;
+    rootSectors = (uint32_t)((numDirs + 2 + 43) / 44);
+    next += rootSectors;
+    for (i = 0; i < numDirs; i++)
+    {
+        n = (i + 1 < numDirs ?
+             BENCHDIRFILES : numFiles - i * BENCHDIRFILES);
+        dirExtents[i] = next;
+        dirSizes[i] = (uint32_t)(((n + 2 + 43) / 44) * BENCHSECTOR);
+        next += dirSizes[i] / BENCHSECTOR;
+    }
+    for (i = 0; i < numFiles; i++)
+    {
+        extents[i] = next;
+        next += (sizes[i] + BENCHSECTOR - 1) / BENCHSECTOR;
+    }
+
+    image.fp = fopen(path, "wb");
+    if (image.fp == NULL)
+    {
+        fprintf(stderr,
+                "udifbench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    image.chunk = malloc(BENCHCHUNK);
+    image.packedLen = lzma_stream_buffer_bound(BENCHCHUNK) +
+                      compressBound(BENCHCHUNK) + BENCHCHUNK / 50 + 600;
+    image.packed = malloc(image.packedLen);
+    image.mishAlloc = 4096;
+    image.mishLen = 204;
+    image.mish = calloc(1, image.mishAlloc);
+    data = malloc(BENCHMAXFILE);
+    if (image.chunk == NULL || image.packed == NULL ||
+        image.mish == NULL || data == NULL)
+    {
+        goto done;
+    }
+
+    /* system area */
+
+    if (benchWrite(&image, NULL, 16 * BENCHSECTOR) != gBenchOkay)
+    {
+        goto done;
+    }
+
+    /* primary volume descriptor */
+
+    memset(sector, 0, sizeof(sector));
+    sector[0] = 1;
+    memcpy(sector + 1, "CD001", 5);
+    sector[6] = 1;
+    memset(sector + 8, ' ', 64);
+    memcpy(sector + 40, "UDIFBENCH", 9);
+    benchBoth32(sector + 80, next);
+    benchBoth16(sector + 120, 1);
+    benchBoth16(sector + 124, 1);
+    benchBoth16(sector + 128, BENCHSECTOR);
+    benchBoth32(sector + 132, 10);
+    sector[140] = 18;
+    benchPut32(sector + 148, 19);
+    benchRecord(sector + 156, "\0", 1, 20, rootSectors * BENCHSECTOR, 1);
+    memset(sector + 190, ' ', 623);
+    sector[881] = 1;
+    if (benchWrite(&image, sector, sizeof(sector)) != gBenchOkay)
+    {
+        goto done;
+    }
+
+    /* terminator */
+
+    memset(sector, 0, sizeof(sector));
+    sector[0] = 255;
+    memcpy(sector + 1, "CD001", 5);
+    sector[6] = 1;
+    if (benchWrite(&image, sector, sizeof(sector)) != gBenchOkay)
+    {
+        goto done;
+    }
+
+    /* path tables, with only the root */
+
+    memset(sector, 0, sizeof(sector));
+    sector[0] = 1;
+    benchPut16(sector + 2, 20);
+    benchPut16(sector + 6, 1);
+    if (benchWrite(&image, sector, sizeof(sector)) != gBenchOkay)
+    {
+        goto done;
+    }
+    memset(sector, 0, sizeof(sector));
+    sector[0] = 1;
+    benchPut32(sector + 2, 20);
+    sector[7] = 1;
+    if (benchWrite(&image, sector, sizeof(sector)) != gBenchOkay)
+    {
+        goto done;
+    }
+
+    /* directories */
+
+    if (benchWriteDir(&image, 20, rootSectors, 20, rootSectors, 0, numDirs,
+                      dirExtents, dirSizes, 1) != gBenchOkay)
+    {
+        goto done;
+    }
+    for (i = 0; i < numDirs; i++)
+    {
+        n = (i + 1 < numDirs ?
+             BENCHDIRFILES : numFiles - i * BENCHDIRFILES);
+        if (benchWriteDir(&image, dirExtents[i],
+                          dirSizes[i] / BENCHSECTOR, 20, rootSectors,
+                          i * BENCHDIRFILES, n, extents, sizes,
+                          0) != gBenchOkay)
+        {
+            goto done;
+        }
+    }
+
+    /* files */
+
+    for (i = 0; i < numFiles; i++)
+    {
+        for (j = 0; j < sizes[i]; j++)
+        {
+            if (j % 16 == 0)
+            {
+                bits = benchRand(&state);
+            }
+            data[j] = (unsigned char)alphabet[bits & 15];
+            bits >>= 4;
+        }
+
+        size = (sizes[i] + BENCHSECTOR - 1) / BENCHSECTOR * BENCHSECTOR;
+        if (benchWrite(&image, data, sizes[i]) != gBenchOkay ||
+            benchWrite(&image, NULL, size - sizes[i]) != gBenchOkay)
+        {
+            goto done;
+        }
+    }
+
+    if (benchFlush(&image) != gBenchOkay ||
+        benchWriteTrailer(&image) != gBenchOkay)
+    {
+        goto done;
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (image.fp != NULL && fclose(image.fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    if (ret != gBenchOkay)
+    {
+        fprintf(stderr, "udifbench: ERROR: cannot write '%s'\n", path);
+        remove(path);
+    }
+
+    free(data);
+    free(image.mish);
+    free(image.packed);
+    free(image.chunk);
+    free(dirExtents);
+    free(dirSizes);
+    free(extents);
+    free(sizes);
+
+    return ret;
+}
+
+/*
+    benchList - list the entries of the image at path with the given
+                number of threads, and read their data if readData
+*/
+
+static int benchList(const char *path,
+                     int threads,
+                     int readData,
+                     uint64_t *entries,
+                     uint64_t *bytes)
+{
+    static char buf[BENCHREADSIZE];
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    char value[16];
+    la_ssize_t n = 0;
+    int r = ARCHIVE_OK;
+    int ret = gBenchErr;
+
+    *entries = 0;
+    *bytes = 0;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return gBenchErr;
+    }
+
+    archive_read_support_filter_udif(a);
+    archive_read_support_format_iso9660(a);
+
+    snprintf(value, sizeof(value), "%d", threads);
+    if (archive_read_set_filter_option(a,
+                                       "udif",
+                                       "threads",
+                                       value) != ARCHIVE_OK ||
+        archive_read_open_filename(a, path, 65536) != ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "udifbench: ERROR: %s\n",
+                archive_error_string(a));
+        archive_read_free(a);
+        return gBenchErr;
+    }
+
+    for (;;)
+    {
+        r = archive_read_next_header(a, &entry);
+        if (r == ARCHIVE_EOF)
+        {
+            ret = gBenchOkay;
+            break;
+        }
+        if (r < ARCHIVE_WARN)
+        {
+            fprintf(stderr,
+                    "udifbench: ERROR: %s\n",
+                    archive_error_string(a));
+            break;
+        }
+
+        (*entries)++;
+
+        while (readData &&
+               (n = archive_read_data(a, buf, sizeof(buf))) > 0)
+        {
+            *bytes += (uint64_t)n;
+        }
+        if (n < 0)
+        {
+            fprintf(stderr,
+                    "udifbench: ERROR: %s\n",
+                    archive_error_string(a));
+            break;
+        }
+    }
+
+    archive_read_free(a);
+
+    return ret;
+}
+
+/*
+    benchParseThreads - parse a comma separated list of numbers of
+                        threads; returns the number of runs
+*/
+
+static int benchParseThreads(const char *list, benchRun_t *runs)
+{
+    char *end = NULL;
+    long n = 0;
+    int numRuns = 0;
+
+    while (*list != '\0' && numRuns < BENCHMAXRUNS)
+    {
+        n = strtol(list, &end, 10);
+        if (end == list || n < 1 || n > BENCHMAXTHREADS ||
+            (*end != ',' && *end != '\0'))
+        {
+            return 0;
+        }
+
+        memset(&runs[numRuns], 0, sizeof(benchRun_t));
+        runs[numRuns].threads = (int)n;
+        numRuns++;
+
+        list = (*end == ',' ? end + 1 : end);
+    }
+
+    return numRuns;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: udifbench [-j threads,...] [-r repetitions] "
+            "[-o output.json] image\n"
+            "       udifbench -m size [-c zlib|bzip2|lzma] image\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t runs[BENCHMAXRUNS];
+    const char *output = NULL;
+    double times[BENCHMAXREPS];
+    uint64_t start = 0;
+    uint64_t entries = 0;
+    uint64_t bytes = 0;
+    unsigned long makeMB = 0;
+    uint32_t type = BENCHZLIB;
+    FILE *fp = stdout;
+    int numReps = 3;
+    int numRuns = 0;
+    int ret = 1;
+    int run = 0;
+    int readData = 0;
+    int r = 0;
+    int i = 1;
+
+    numRuns = benchParseThreads("1,2,4", runs);
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            numRuns = benchParseThreads(argv[++i], runs);
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeMB = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (strcmp(argv[i], "zlib") == 0)
+            {
+                type = BENCHZLIB;
+            }
+            else if (strcmp(argv[i], "bzip2") == 0)
+            {
+                type = BENCHBZIP2;
+            }
+            else if (strcmp(argv[i], "lzma") == 0)
+            {
+                type = BENCHLZMA;
+            }
+            else
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (i + 1 != argc)
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (makeMB > 0)
+    {
+        return (benchMakeImage(argv[i], makeMB, type) == gBenchOkay ?
+                0 : 1);
+    }
+
+    if (numRuns < 1 || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    for (run = 0; run < numRuns; run++)
+    {
+        for (readData = 0; readData <= 1; readData++)
+        {
+            /* the first repetition is a warm up */
+
+            for (r = -1; r < numReps; r++)
+            {
+                start = benchNow();
+                if (benchList(argv[i],
+                              runs[run].threads,
+                              readData,
+                              &entries,
+                              &bytes) != gBenchOkay)
+                {
+                    fprintf(stderr,
+                            "udifbench: ERROR: cannot list '%s'\n",
+                            argv[i]);
+                    return 1;
+                }
+                if (r >= 0)
+                {
+                    times[r] = (double)(benchNow() - start) / 1000000.0;
+                }
+            }
+
+            if (readData)
+            {
+                runs[run].readMs = benchMedian(times, numReps);
+            }
+            else
+            {
+                runs[run].listMs = benchMedian(times, numReps);
+            }
+        }
+    }
+
+    fp = benchOpenOutput("udifbench", output);
+    if (fp == NULL)
+    {
+        return 1;
+    }
+
+    fprintf(fp,
+            "{\n  \"image\": \"%s\", \"entries\": %llu, "
+            "\"bytes\": %llu,\n  \"runs\": [\n",
+            argv[i],
+            (unsigned long long)entries,
+            (unsigned long long)bytes);
+
+    for (run = 0; run < numRuns; run++)
+    {
+        fprintf(fp,
+                "    {\"threads\": %d, \"listMs\": %.1f, "
+                "\"readMs\": %.1f, \"MBps\": %.1f, \"speedup\": %.2f}%s\n",
+                runs[run].threads,
+                runs[run].listMs,
+                runs[run].readMs,
+                (runs[run].readMs > 0.0 ?
+                 (double)bytes / 1048576.0 / (runs[run].readMs / 1000.0) :
+                 0.0),
+                (runs[run].readMs > 0.0 ?
+                 runs[0].readMs / runs[run].readMs : 0.0),
+                (run + 1 < numRuns ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    ret = 0;
+
+    if (benchCloseOutput(fp) != 0)
+    {
+        ret = 1;
+    }
+
+    return ret;
+}
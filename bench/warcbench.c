@@ -0,0 +1,821 @@
+/*
+    warcbench.c - benchmark listing and indexing WARC files
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://iipc.github.io/warc-specifications/specifications/warc-format/warc-1.1/
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    warcbench times each of the given .warc and .warc.gz files three
+    ways, and reports, as JSON, the median wall time and the bytes
+    read for each:
+
+        list   - archive_read_next_header() for every entry, with the
+                 warc reader (and the gzip filter), without reading
+                 any data
+        index  - warcIndexRead(), which finds the offset and length
+                 of every record (see warcindex.h)
+        lookup - reading BENCHLOOKUPS random records, each with one
+                 pread() at its offset in the index (and inflating
+                 its gzip member), as a CDX index allows
+
+    along with the file's size, entries and records.  Each way is run
+    repeatedly (-r), after one warm up run that is not counted.  With
+    -m, warcbench instead writes a file of the given number of
+    request / response pairs, with HTML like bodies of 1KB to 16KB,
+    compressed record by record if the type is gz.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+#include "warcindex.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* the ways of reading a file */
+
+enum
+{
+    gBenchList   = 0,
+    gBenchIndex  = 1,
+    gBenchLookup = 2,
+    gBenchWays   = 3,
+};
+
+/* defines */
+
+#define BENCHMAXREPS    100
+#define BENCHBLOCKSIZE  65536
+#define BENCHCHUNK      64
+#define BENCHMINBODY    1024
+#define BENCHMAXBODY    16384
+#define BENCHMAXRECORD  (BENCHMAXBODY + 4096)
+#define BENCHLOOKUPS    1000
+#define BENCHSEED       0x9E3779B97F4A7C15ULL
+
+/* the file read by libarchive, and the bytes read from it */
+
+typedef struct benchFile
+{
+    int fd;
+    uint64_t bytesRead;
+    unsigned char buf[BENCHBLOCKSIZE];
+} benchFile_t;
+
+/* the result of one file */
+
+typedef struct benchRun
+{
+    const char *warc;
+    uint64_t compressedBytes;
+    uint64_t entries;
+    uint64_t bytesRead[gBenchWays];
+    double wallMs[gBenchWays];
+    warcIndex_t index;
+} benchRun_t;
+
+/* globals */
+
+static const char *gWays[gBenchWays] =
+{
+    "list",
+    "index",
+    "lookup",
+};
+
+static const char *gPhrase =
+    "<div class=\"item\"><a href=\"/catalog/item\">Example item</a> "
+    "<span class=\"price\">$19.99</span></div>\n";
+
+/* private functions */
+
+static void benchFill(unsigned char *p, size_t size, uint64_t *state);
+static la_ssize_t benchReadCallback(struct archive *a,
+                                    void *data,
+                                    const void **buf);
+static la_int64_t benchSkipCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t request);
+static la_int64_t benchSeekCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t offset,
+                                    int whence);
+static int benchWriteRecord(FILE *fp,
+                            z_stream *zs,
+                            unsigned char *out,
+                            size_t outSize,
+                            const char *type,
+                            const char *uri,
+                            const unsigned char *body,
+                            size_t bodyLen,
+                            unsigned long id);
+static int benchMakeWarc(const char *path,
+                         unsigned long numPairs,
+                         int compressed);
+static int benchLookup(benchRun_t *run);
+static int benchList(benchRun_t *run, int how);
+static void printUsage(void);
+
+/* benchFill - fill p with chunks of HTML, seven eighths, and random bytes */
+
+static void benchFill(unsigned char *p, size_t size, uint64_t *state)
+{
+    size_t phraseLen = strlen(gPhrase);
+    size_t pos = 0;
+    size_t len = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    while (pos < size)
+    {
+        len = (size - pos < BENCHCHUNK ? size - pos : BENCHCHUNK);
+
+        if (benchRand(state) % 8 != 0)
+        {
+            i = (size_t)(benchRand(state) % phraseLen);
+            for (j = 0; j < len; j++)
+            {
+                p[pos + j] = (unsigned char)gPhrase[i];
+                i = (i + 1) % phraseLen;
+            }
+        }
+        else
+        {
+            for (j = 0; j < len; j++)
+            {
+                p[pos + j] = (unsigned char)('a' + benchRand(state) % 26);
+            }
+        }
+
+        pos += len;
+    }
+}
+
+/* benchReadCallback - read the next block of the file */
+
+static la_ssize_t benchReadCallback(struct archive *a,
+                                    void *data,
+                                    const void **buf)
+{
+    benchFile_t *file = data;
+    ssize_t bytesRead = 0;
+
+    (void)a;
+
+    do
+    {
+        bytesRead = read(file->fd, file->buf, sizeof(file->buf));
+    } while (bytesRead < 0 && errno == EINTR);
+
+    if (bytesRead > 0)
+    {
+        file->bytesRead += (uint64_t)bytesRead;
+    }
+
+    *buf = file->buf;
+
+    return bytesRead;
+}
+
+/* benchSkipCallback - skip part of the file without reading it */
+
+static la_int64_t benchSkipCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t request)
+{
+    benchFile_t *file = data;
+
+    (void)a;
+
+    if (lseek(file->fd, (off_t)request, SEEK_CUR) < 0)
+    {
+        return 0;
+    }
+
+    return request;
+}
+
+/* benchSeekCallback - seek in the file */
+
+static la_int64_t benchSeekCallback(struct archive *a,
+                                    void *data,
+                                    la_int64_t offset,
+                                    int whence)
+{
+    benchFile_t *file = data;
+
+    (void)a;
+
+    return (la_int64_t)lseek(file->fd, (off_t)offset, whence);
+}
+
+/*
+    benchWriteRecord - write a record, as its own gzip member if zs
+                       is not NULL
+*/
+
+static int benchWriteRecord(FILE *fp,
+                            z_stream *zs,
+                            unsigned char *out,
+                            size_t outSize,
+                            const char *type,
+                            const char *uri,
+                            const unsigned char *body,
+                            size_t bodyLen,
+                            unsigned long id)
+{
+    char header[1024];
+    size_t headerLen = 0;
+
+    headerLen = (size_t)snprintf(header,
+                                 sizeof(header),
+                                 "WARC/1.0\r\n"
+                                 "WARC-Type: %s\r\n"
+                                 "%s%s%s"
+                                 "WARC-Date: 2024-03-09T14:%02lu:%02luZ\r\n"
+                                 "WARC-Record-ID: <urn:uuid:%08lx-0000-4000-"
+                                 "8000-000000000000>\r\n"
+                                 "Content-Type: application/http; "
+                                 "msgtype=%s\r\n"
+                                 "Content-Length: %zu\r\n"
+                                 "\r\n",
+                                 type,
+                                 (uri != NULL ? "WARC-Target-URI: " : ""),
+                                 (uri != NULL ? uri : ""),
+                                 (uri != NULL ? "\r\n" : ""),
+                                 (id / 60) % 60,
+                                 id % 60,
+                                 id,
+                                 type,
+                                 bodyLen);
+
+    if (zs == NULL)
+    {
+        return (fwrite(header, 1, headerLen, fp) == headerLen &&
+                fwrite(body, 1, bodyLen, fp) == bodyLen &&
+                fwrite("\r\n\r\n", 1, 4, fp) == 4 ?
+                gBenchOkay : gBenchErr);
+    }
+
+    /* header, body and trailer, in one gzip member */
+
+    deflateReset(zs);
+    zs->next_out = out;
+    zs->avail_out = (uInt)outSize;
+    zs->next_in = (unsigned char *)header;
+    zs->avail_in = (uInt)headerLen;
+    if (deflate(zs, Z_NO_FLUSH) != Z_OK)
+    {
+        return gBenchErr;
+    }
+    zs->next_in = (unsigned char *)body;
+    zs->avail_in = (uInt)bodyLen;
+    if (deflate(zs, Z_NO_FLUSH) != Z_OK)
+    {
+        return gBenchErr;
+    }
+    zs->next_in = (unsigned char *)"\r\n\r\n";
+    zs->avail_in = 4;
+    if (deflate(zs, Z_FINISH) != Z_STREAM_END)
+    {
+        return gBenchErr;
+    }
+
+    return (fwrite(out, 1, outSize - zs->avail_out, fp) ==
+            outSize - zs->avail_out ? gBenchOkay : gBenchErr);
+}
+
+/*
+    benchMakeWarc - write a warcinfo record and numPairs request /
+                    response pairs, each record in its own gzip
+                    member if compressed
+*/
+
+static int benchMakeWarc(const char *path,
+                         unsigned long numPairs,
+                         int compressed)
+{
+    unsigned char *body = NULL;
+    unsigned char *out = NULL;
+    char uri[128];
+    z_stream zs;
+    z_stream *zp = NULL;
+    FILE *fp = NULL;
+    uint64_t state = BENCHSEED;
+    size_t outSize = 2 * BENCHMAXRECORD;
+    size_t bodyLen = 0;
+    size_t headerLen = 0;
+    unsigned long i = 0;
+    int ret = gBenchErr;
+
+    if (numPairs == 0)
+    {
+        printUsage();
+        return gBenchErr;
+    }
+
+    memset(&zs, 0, sizeof(zs));
+    if (compressed)
+    {
+        if (deflateInit2(&zs,
+                         Z_DEFAULT_COMPRESSION,
+                         Z_DEFLATED,
+                         15 + 16,
+                         8,
+                         Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            return gBenchErr;
+        }
+        zp = &zs;
+    }
+
+    body = malloc(BENCHMAXRECORD);
+    out = malloc(outSize);
+    if (body == NULL || out == NULL)
+    {
+        goto done;
+    }
+
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        fprintf(stderr,
+                "warcbench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    bodyLen = (size_t)snprintf((char *)body,
+                               BENCHMAXRECORD,
+                               "software: warcbench\r\n"
+                               "format: WARC File Format 1.0\r\n");
+    if (benchWriteRecord(fp, zp, out, outSize, "warcinfo", NULL,
+                         body, bodyLen, 0) != gBenchOkay)
+    {
+        goto done;
+    }
+
+    for (i = 0; i < numPairs; i++)
+    {
+        snprintf(uri,
+                 sizeof(uri),
+                 "http://www.example.com/catalog/%lu/item%lu.html",
+                 i % 1000,
+                 i);
+
+        bodyLen = (size_t)snprintf((char *)body,
+                                   BENCHMAXRECORD,
+                                   "GET /catalog/%lu/item%lu.html HTTP/1.1"
+                                   "\r\nHost: www.example.com\r\n"
+                                   "User-Agent: warcbench/0.1\r\n\r\n",
+                                   i % 1000,
+                                   i);
+        if (benchWriteRecord(fp, zp, out, outSize, "request", uri,
+                             body, bodyLen, i) != gBenchOkay)
+        {
+            goto done;
+        }
+
+        headerLen = (size_t)snprintf((char *)body,
+                                     BENCHMAXRECORD,
+                                     "HTTP/1.1 200 OK\r\n"
+                                     "Content-Type: text/html\r\n\r\n");
+        bodyLen = BENCHMINBODY +
+                  (size_t)(benchRand(&state) %
+                           (BENCHMAXBODY - BENCHMINBODY));
+        benchFill(body + headerLen, bodyLen, &state);
+        if (benchWriteRecord(fp, zp, out, outSize, "response", uri,
+                             body, headerLen + bodyLen, i) != gBenchOkay)
+        {
+            goto done;
+        }
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (fp != NULL && fclose(fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    if (ret != gBenchOkay)
+    {
+        fprintf(stderr, "warcbench: ERROR: cannot write '%s'\n", path);
+    }
+    if (zp != NULL)
+    {
+        deflateEnd(zp);
+    }
+    free(body);
+    free(out);
+
+    return ret;
+}
+
+/*
+    benchLookup - read BENCHLOOKUPS random records of run->warc at
+                  their offsets in the index, and check that each
+                  starts with a record header
+*/
+
+static int benchLookup(benchRun_t *run)
+{
+    warcRecord_t *record = NULL;
+    unsigned char *in = NULL;
+    unsigned char out[16];
+    z_stream zs;
+    uint64_t state = BENCHSEED;
+    size_t inSize = 0;
+    int fd = -1;
+    int i = 0;
+    int zr = Z_OK;
+    int ret = gBenchErr;
+
+    if (run->index.numRecords == 0)
+    {
+        return gBenchErr;
+    }
+
+    memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, 15 + 16) != Z_OK)
+    {
+        return gBenchErr;
+    }
+
+    fd = open(run->warc, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        goto done;
+    }
+
+    run->bytesRead[gBenchLookup] = 0;
+
+    for (i = 0; i < BENCHLOOKUPS; i++)
+    {
+        record = &run->index.records[benchRand(&state) %
+                                     run->index.numRecords];
+
+        if (record->length > inSize)
+        {
+            free(in);
+            inSize = (size_t)record->length;
+            in = malloc(inSize);
+            if (in == NULL)
+            {
+                goto done;
+            }
+        }
+
+        if (pread(fd, in, (size_t)record->length, (off_t)record->offset) !=
+                (ssize_t)record->length)
+        {
+            goto done;
+        }
+        run->bytesRead[gBenchLookup] += record->length;
+
+        if (run->index.compressed)
+        {
+            /* the whole member, though only its start is checked */
+
+            inflateReset(&zs);
+            zs.next_in = in;
+            zs.avail_in = (uInt)record->length;
+            do
+            {
+                zs.next_out = out;
+                zs.avail_out = sizeof(out);
+                zr = inflate(&zs, Z_NO_FLUSH);
+                if (zs.total_out == sizeof(out) &&
+                    memcmp(out, "WARC/", 5) != 0)
+                {
+                    zr = Z_DATA_ERROR;
+                }
+            } while (zr == Z_OK);
+
+            if (zr != Z_STREAM_END)
+            {
+                goto done;
+            }
+        }
+        else if (memcmp(in, "WARC/", 5) != 0)
+        {
+            goto done;
+        }
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (ret != gBenchOkay)
+    {
+        fprintf(stderr,
+                "warcbench: ERROR: '%s': a record isn't at its offset\n",
+                run->warc);
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    inflateEnd(&zs);
+    free(in);
+
+    return ret;
+}
+
+/* benchList - read run->warc one way */
+
+static int benchList(benchRun_t *run, int how)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    benchFile_t *file = NULL;
+    int r = ARCHIVE_OK;
+    int ret = gBenchErr;
+
+    if (how == gBenchIndex)
+    {
+        warcIndexFree(&run->index);
+        if (warcIndexRead(run->warc, &run->index) != gWarcIndexOkay)
+        {
+            fprintf(stderr,
+                    "warcbench: ERROR: cannot index '%s'\n",
+                    run->warc);
+            return gBenchErr;
+        }
+        run->bytesRead[how] = run->index.bytesRead;
+        return gBenchOkay;
+    }
+
+    if (how == gBenchLookup)
+    {
+        return benchLookup(run);
+    }
+
+    file = calloc(1, sizeof(benchFile_t));
+    a = archive_read_new();
+    if (file == NULL || a == NULL)
+    {
+        goto done;
+    }
+
+    file->fd = open(run->warc, O_RDONLY | O_CLOEXEC);
+    if (file->fd < 0)
+    {
+        fprintf(stderr,
+                "warcbench: ERROR: cannot open '%s': %s\n",
+                run->warc,
+                strerror(errno));
+        goto done;
+    }
+
+    archive_read_support_filter_gzip(a);
+    archive_read_support_format_warc(a);
+    archive_read_set_callback_data(a, file);
+    archive_read_set_read_callback(a, benchReadCallback);
+    archive_read_set_skip_callback(a, benchSkipCallback);
+    archive_read_set_seek_callback(a, benchSeekCallback);
+
+    if (archive_read_open1(a) != ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "warcbench: ERROR: cannot open '%s': %s\n",
+                run->warc,
+                archive_error_string(a));
+        goto done;
+    }
+
+    run->entries = 0;
+
+    while ((r = archive_read_next_header(a, &entry)) == ARCHIVE_OK)
+    {
+        run->entries++;
+    }
+
+    if (r != ARCHIVE_EOF)
+    {
+        fprintf(stderr,
+                "warcbench: ERROR: cannot list '%s': %s\n",
+                run->warc,
+                archive_error_string(a));
+        goto done;
+    }
+
+    run->bytesRead[how] = file->bytesRead;
+    ret = gBenchOkay;
+
+done:
+    if (a != NULL)
+    {
+        archive_read_free(a);
+    }
+    if (file != NULL && file->fd >= 0)
+    {
+        close(file->fd);
+    }
+    free(file);
+
+    return ret;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: warcbench [-r repetitions] [-o output.json] warc ...\n"
+            "       warcbench -m pairs plain|gz warc\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t *runs = NULL;
+    const char *output = NULL;
+    double times[BENCHMAXREPS];
+    struct stat sb;
+    uint64_t start = 0;
+    unsigned long makePairs = 0;
+    FILE *fp = stdout;
+    int numRuns = 0;
+    int numReps = 3;
+    int run = 0;
+    int how = 0;
+    int ret = 1;
+    int r = 0;
+    int i = 1;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makePairs = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makePairs > 0)
+    {
+        if (i + 2 != argc ||
+            (strcmp(argv[i], "plain") != 0 && strcmp(argv[i], "gz") != 0))
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeWarc(argv[i + 1],
+                              makePairs,
+                              strcmp(argv[i], "gz") == 0) == gBenchOkay ?
+                0 : 1);
+    }
+
+    if (i >= argc || numReps < 1 || numReps > BENCHMAXREPS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    numRuns = argc - i;
+    runs = calloc((size_t)numRuns, sizeof(benchRun_t));
+    if (runs == NULL)
+    {
+        return 1;
+    }
+
+    /* the first repetition of each way is a warm up */
+
+    for (run = 0; run < numRuns; run++)
+    {
+        runs[run].warc = argv[i + run];
+        if (stat(runs[run].warc, &sb) == 0)
+        {
+            runs[run].compressedBytes = (uint64_t)sb.st_size;
+        }
+
+        for (how = 0; how < gBenchWays; how++)
+        {
+            for (r = -1; r < numReps; r++)
+            {
+                start = benchNow();
+                if (benchList(&runs[run], how) != gBenchOkay)
+                {
+                    goto done;
+                }
+                if (r >= 0)
+                {
+                    times[r] = (double)(benchNow() - start) / 1000000.0;
+                }
+            }
+
+            runs[run].wallMs[how] = benchMedian(times, numReps);
+        }
+    }
+
+    fp = benchOpenOutput("warcbench", output);
+    if (fp == NULL)
+    {
+        goto done;
+    }
+
+    fprintf(fp, "{\n  \"runs\": [\n");
+
+    for (run = 0; run < numRuns; run++)
+    {
+        fprintf(fp,
+                "    {\"warc\": \"%s\", \"compressedBytes\": %llu, "
+                "\"entries\": %llu, \"records\": %u, "
+                "\"bytesInflated\": %llu, \"lookups\": %d,\n",
+                runs[run].warc,
+                (unsigned long long)runs[run].compressedBytes,
+                (unsigned long long)runs[run].entries,
+                runs[run].index.numRecords,
+                (unsigned long long)runs[run].index.bytesInflated,
+                BENCHLOOKUPS);
+
+        for (how = 0; how < gBenchWays; how++)
+        {
+            fprintf(fp,
+                    "     \"%sMs\": %.2f, \"%sBytesRead\": %llu%s\n",
+                    gWays[how],
+                    runs[run].wallMs[how],
+                    gWays[how],
+                    (unsigned long long)runs[run].bytesRead[how],
+                    (how + 1 < gBenchWays ? "," : ""));
+        }
+
+        fprintf(fp,
+                "    }%s\n",
+                (run + 1 < numRuns ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    ret = 0;
+
+done:
+    if (benchCloseOutput(fp) != 0)
+    {
+        ret = 1;
+    }
+    for (run = 0; run < numRuns; run++)
+    {
+        warcIndexFree(&runs[run].index);
+    }
+    free(runs);
+
+    return ret;
+}
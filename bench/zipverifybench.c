@@ -0,0 +1,757 @@
+/*
+    zipverifybench.c - benchmark checking zip passwords with verifiers
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    zipverifybench checks a list of passwords, -n wrong ones
+    (BENCHWRONGPASSWORDS by default) and then BENCHPASSWORD, against
+    each of the given encrypted zip archives two ways, and reports, as
+    JSON, for each archive:
+
+        libarchive - archive_read_next_header() and a 1 byte
+                     archive_read_data() for every entry, with the
+                     passwords added with archive_read_add_passphrase(),
+                     which derives the full keys for each password it
+                     tries
+        runs       - zipVerifyRead() (see zipverify.h) with each of
+                     the given numbers of workers (-j, a comma
+                     separated list, 1,2,4 by default): the workers
+                     used, the verifications, the keys derived, the
+                     cache hits, the verifications and entries per
+                     second, and the speed up over libarchive
+
+    along with the archive's entries, its cipher and the entries that
+    the passwords open.  Each way is run repeatedly (-r), after one
+    warm up run that is not counted, and the median wall time is
+    reported.  With -m, zipverifybench instead writes a zip archive of
+    the given number of stored files, BENCHMINFILE to BENCHMAXFILE
+    bytes each, encrypted with BENCHPASSWORD using ZipCrypto
+    ("zipcrypto") or 256 bit WinZip AES ("aes"), with OpenSSL's
+    PBKDF2, AES and HMAC, so that the archives don't depend on the
+    code being measured.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <zlib.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+
+#include "zipverify.h"
+#include "benchutil.h"
+
+/* return codes */
+
+enum
+{
+    gBenchErr  = -1,
+    gBenchOkay =  0,
+};
+
+/* defines */
+
+#define BENCHMAXREPS   100
+#define BENCHMAXRUNS   16
+#define BENCHMINFILE   256
+#define BENCHMAXFILE   4096
+#define BENCHWRONGPASSWORDS 15
+#define BENCHPASSWORD  "correct horse battery staple"
+#define BENCHPASSWORDLEN 32
+#define BENCHAESKEYLEN 32
+#define BENCHAESSALTLEN 16
+#define BENCHCDLEN     46
+
+/* the result of one number of workers */
+
+typedef struct benchRun
+{
+    int workers;
+    unsigned int workersUsed;
+    uint64_t verifications;
+    uint64_t keysDerived;
+    uint64_t cacheHits;
+    double wallMs;
+} benchRun_t;
+
+/* private functions */
+
+static unsigned char *benchPut16(unsigned char *p, unsigned int v);
+static unsigned char *benchPut32(unsigned char *p, uint32_t v);
+static void benchCryptUpdate(uint32_t *keys, unsigned char plain);
+static size_t benchEncrypt(const unsigned char *data,
+                           size_t len,
+                           uint32_t crc,
+                           int aes,
+                           uint64_t *state,
+                           unsigned char *out);
+static int benchMakeZip(const char *path,
+                        unsigned long numFiles,
+                        int aes);
+static int benchLibarchive(const char *path,
+                           const char * const *passwords,
+                           unsigned int numPasswords,
+                           uint64_t *opened);
+static int benchParseWorkers(const char *list, benchRun_t *runs);
+static void printUsage(void);
+
+/* benchPut16 - put a little endian 16 bit value */
+
+static unsigned char *benchPut16(unsigned char *p, unsigned int v)
+{
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+
+    return p + 2;
+}
+
+/* benchPut32 - put a little endian 32 bit value */
+
+static unsigned char *benchPut32(unsigned char *p, uint32_t v)
+{
+    p = benchPut16(p, v & 0xFFFF);
+
+    return benchPut16(p, v >> 16);
+}
+
+/* benchCryptUpdate - update the ZipCrypto keys with a plain byte */
+
+static void benchCryptUpdate(uint32_t *keys, unsigned char plain)
+{
+    static uint32_t table[256];
+    uint32_t c = 0;
+    int i = 0;
+    int j = 0;
+
+    if (table[1] == 0)
+    {
+        for (i = 0; i < 256; i++)
+        {
+            for (c = (uint32_t)i, j = 0; j < 8; j++)
+            {
+                c = (c & 1 ? (c >> 1) ^ 0xEDB88320 : c >> 1);
+            }
+            table[i] = c;
+        }
+    }
+
+    keys[0] = table[(keys[0] ^ plain) & 0xFF] ^ (keys[0] >> 8);
+    keys[1] = (keys[1] + (keys[0] & 0xFF)) * 134775813 + 1;
+    keys[2] = table[(keys[2] ^ (keys[1] >> 24)) & 0xFF] ^ (keys[2] >> 8);
+}
+
+/*
+    benchEncrypt - encrypt a file's data, returns the length of the
+                   encrypted data in out; ZipCrypto puts a 12 byte
+                   header, ending in the CRC's high byte, in front of
+                   the data, and WinZip AES (AE-2) puts the salt and
+                   the password verifier in front of it and 10 bytes
+                   of HMAC-SHA1 after it
+*/
+
+static size_t benchEncrypt(const unsigned char *data,
+                           size_t len,
+                           uint32_t crc,
+                           int aes,
+                           uint64_t *state,
+                           unsigned char *out)
+{
+    unsigned char key[BENCHAESKEYLEN * 2 + 2];
+    unsigned char counter[16];
+    unsigned char stream[16];
+    unsigned char mac[20];
+    unsigned char plain = 0;
+    unsigned int macLen = 0;
+    const char *p = NULL;
+    uint32_t keys[3] = { 305419896, 591751049, 878082192 };
+    uint32_t t = 0;
+    uint64_t block = 0;
+    size_t i = 0;
+    int outLen = 0;
+    int j = 0;
+    EVP_CIPHER_CTX *ctx = NULL;
+
+    if (aes == 0)
+    {
+        for (p = BENCHPASSWORD; *p != '\0'; p++)
+        {
+            benchCryptUpdate(keys, (unsigned char)*p);
+        }
+
+        for (i = 0; i < 11; i++)
+        {
+            out[i] = (unsigned char)benchRand(state);
+        }
+        out[11] = (unsigned char)(crc >> 24);
+        memcpy(out + 12, data, len);
+
+        for (i = 0; i < len + 12; i++)
+        {
+            t = (keys[2] | 2) & 0xFFFF;
+            plain = out[i];
+            out[i] ^= (unsigned char)((t * (t ^ 1)) >> 8);
+            benchCryptUpdate(keys, plain);
+        }
+
+        return len + 12;
+    }
+
+    for (i = 0; i < BENCHAESSALTLEN; i++)
+    {
+        out[i] = (unsigned char)benchRand(state);
+    }
+
+    PKCS5_PBKDF2_HMAC_SHA1(BENCHPASSWORD,
+                           (int)strlen(BENCHPASSWORD),
+                           out,
+                           BENCHAESSALTLEN,
+                           1000,
+                           (int)sizeof(key),
+                           key);
+    memcpy(out + BENCHAESSALTLEN, key + BENCHAESKEYLEN * 2, 2);
+
+    /* AES in counter mode, with a little endian counter from 1 */
+
+    ctx = EVP_CIPHER_CTX_new();
+    EVP_EncryptInit_ex(ctx, EVP_aes_256_ecb(), NULL, key, NULL);
+    EVP_CIPHER_CTX_set_padding(ctx, 0);
+
+    for (i = 0; i < len; i++)
+    {
+        if (i % 16 == 0)
+        {
+            block++;
+            memset(counter, 0, sizeof(counter));
+            for (j = 0; j < 8; j++)
+            {
+                counter[j] = (unsigned char)(block >> (8 * j));
+            }
+            EVP_EncryptUpdate(ctx, stream, &outLen, counter, 16);
+        }
+        out[BENCHAESSALTLEN + 2 + i] = data[i] ^ stream[i % 16];
+    }
+
+    EVP_CIPHER_CTX_free(ctx);
+
+    HMAC(EVP_sha1(),
+         key + BENCHAESKEYLEN,
+         BENCHAESKEYLEN,
+         out + BENCHAESSALTLEN + 2,
+         len,
+         mac,
+         &macLen);
+    memcpy(out + BENCHAESSALTLEN + 2 + len, mac, 10);
+
+    return BENCHAESSALTLEN + 2 + len + 10;
+}
+
+/*
+    benchMakeZip - write a zip archive of numFiles stored files of
+                   text, encrypted with BENCHPASSWORD
+*/
+
+static int benchMakeZip(const char *path, unsigned long numFiles, int aes)
+{
+    static const char letters[] = "abcdefghijklmnop";
+    unsigned char data[BENCHMAXFILE];
+    unsigned char enc[BENCHMAXFILE + 64];
+    unsigned char header[128];
+    unsigned char *cd = NULL;
+    unsigned char *h = NULL;
+    unsigned char *c = NULL;
+    char name[64];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint64_t bits = 0;
+    uint64_t offset = 0;
+    uint32_t crc = 0;
+    size_t cdLen = 0;
+    size_t nameLen = 0;
+    size_t size = 0;
+    size_t encLen = 0;
+    size_t j = 0;
+    unsigned long i = 0;
+    FILE *fp = NULL;
+    int ret = gBenchErr;
+
+    if (numFiles > 0xFFFF)
+    {
+        fprintf(stderr, "zipverifybench: ERROR: too many files\n");
+        return gBenchErr;
+    }
+
+    cd = malloc(numFiles * (BENCHCDLEN + sizeof(name) + 11));
+    fp = fopen(path, "wb");
+    if (cd == NULL || fp == NULL)
+    {
+        fprintf(stderr,
+                "zipverifybench: ERROR: cannot create '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    for (i = 0; i < numFiles; i++)
+    {
+        size = BENCHMINFILE +
+               (size_t)(benchRand(&state) %
+                        (BENCHMAXFILE - BENCHMINFILE + 1));
+        for (j = 0; j < size; j++)
+        {
+            if (j % 16 == 0)
+            {
+                bits = benchRand(&state);
+            }
+            data[j] = (unsigned char)letters[bits & 15];
+            bits >>= 4;
+        }
+
+        snprintf(name,
+                 sizeof(name),
+                 "docs/%04lu/file%06lu.txt",
+                 i / 100,
+                 i);
+        nameLen = strlen(name);
+
+        crc = (uint32_t)crc32(0, data, (uInt)size);
+        encLen = benchEncrypt(data, size, crc, aes, &state, enc);
+
+        /* the local header, the AES extra field, and the data */
+
+        h = header;
+        h = benchPut32(h, 0x04034B50);
+        h = benchPut16(h, (aes ? 51 : 20));
+        h = benchPut16(h, 0x0001);
+        h = benchPut16(h, (aes ? 99 : 0));
+        h = benchPut16(h, 0x6000);
+        h = benchPut16(h, 0x5D31);
+        h = benchPut32(h, (aes ? 0 : crc));
+        h = benchPut32(h, (uint32_t)encLen);
+        h = benchPut32(h, (uint32_t)size);
+        h = benchPut16(h, (unsigned int)nameLen);
+        h = benchPut16(h, (aes ? 11 : 0));
+        memcpy(h, name, nameLen);
+        h += nameLen;
+        if (aes)
+        {
+            h = benchPut16(h, 0x9901);
+            h = benchPut16(h, 7);
+            h = benchPut16(h, 2);
+            *h++ = 'A';
+            *h++ = 'E';
+            *h++ = 3;
+            h = benchPut16(h, 0);
+        }
+
+        if (fwrite(header, 1, (size_t)(h - header), fp) !=
+                (size_t)(h - header) ||
+            fwrite(enc, 1, encLen, fp) != encLen)
+        {
+            fprintf(stderr,
+                    "zipverifybench: ERROR: cannot write '%s': %s\n",
+                    path,
+                    strerror(errno));
+            goto done;
+        }
+
+        /* the central directory entry is the same, plus the offset */
+
+        c = cd + cdLen;
+        c = benchPut32(c, 0x02014B50);
+        c = benchPut16(c, 0x0314);
+        memcpy(c, header + 4, 26);
+        c += 26;
+        c = benchPut16(c, 0);
+        c = benchPut16(c, 0);
+        c = benchPut16(c, 0);
+        c = benchPut32(c, 0100644U << 16);
+        c = benchPut32(c, (uint32_t)offset);
+        memcpy(c, header + 30, (size_t)(h - header) - 30);
+        c += (size_t)(h - header) - 30;
+        cdLen = (size_t)(c - cd);
+
+        offset += (uint64_t)(h - header) + encLen;
+    }
+
+    h = header;
+    h = benchPut32(h, 0x06054B50);
+    h = benchPut16(h, 0);
+    h = benchPut16(h, 0);
+    h = benchPut16(h, (unsigned int)numFiles);
+    h = benchPut16(h, (unsigned int)numFiles);
+    h = benchPut32(h, (uint32_t)cdLen);
+    h = benchPut32(h, (uint32_t)offset);
+    h = benchPut16(h, 0);
+
+    if (fwrite(cd, 1, cdLen, fp) != cdLen ||
+        fwrite(header, 1, (size_t)(h - header), fp) !=
+            (size_t)(h - header))
+    {
+        fprintf(stderr,
+                "zipverifybench: ERROR: cannot write '%s': %s\n",
+                path,
+                strerror(errno));
+        goto done;
+    }
+
+    ret = gBenchOkay;
+
+done:
+    if (fp != NULL && fclose(fp) != 0)
+    {
+        ret = gBenchErr;
+    }
+    free(cd);
+
+    return ret;
+}
+
+/*
+    benchLibarchive - read the first byte of every entry with
+                      libarchive, which checks the passwords
+*/
+
+static int benchLibarchive(const char *path,
+                           const char * const *passwords,
+                           unsigned int numPasswords,
+                           uint64_t *opened)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    char byte = 0;
+    unsigned int i = 0;
+    int r = ARCHIVE_OK;
+
+    *opened = 0;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return gBenchErr;
+    }
+
+    archive_read_support_format_zip(a);
+    for (i = 0; i < numPasswords; i++)
+    {
+        archive_read_add_passphrase(a, passwords[i]);
+    }
+
+    if (archive_read_open_filename(a, path, 65536) != ARCHIVE_OK)
+    {
+        archive_read_free(a);
+        return gBenchErr;
+    }
+
+    for (;;)
+    {
+        r = archive_read_next_header(a, &entry);
+        if (r == ARCHIVE_EOF)
+        {
+            break;
+        }
+        if (r < ARCHIVE_WARN)
+        {
+            archive_read_free(a);
+            return gBenchErr;
+        }
+
+        if (archive_entry_is_encrypted(entry) &&
+            archive_read_data(a, &byte, 1) >= 0)
+        {
+            (*opened)++;
+        }
+    }
+
+    archive_read_free(a);
+
+    return gBenchOkay;
+}
+
+/*
+    benchParseWorkers - parse a comma separated list of numbers of
+                        workers; returns the number of runs
+*/
+
+static int benchParseWorkers(const char *list, benchRun_t *runs)
+{
+    char *end = NULL;
+    long n = 0;
+    int numRuns = 0;
+
+    while (*list != '\0' && numRuns < BENCHMAXRUNS)
+    {
+        n = strtol(list, &end, 10);
+        if (end == list || n < 1 || n > ZIPVERIFYMAXWORKERS ||
+            (*end != ',' && *end != '\0'))
+        {
+            return 0;
+        }
+
+        memset(&runs[numRuns], 0, sizeof(benchRun_t));
+        runs[numRuns].workers = (int)n;
+        numRuns++;
+
+        list = (*end == ',' ? end + 1 : end);
+    }
+
+    return numRuns;
+}
+
+/* printUsage - print the usage message */
+
+static void printUsage(void)
+{
+    fprintf(stderr,
+            "Usage: zipverifybench [-j workers,...] [-n wrong passwords]\n"
+            "                      [-r repetitions] [-o output.json] "
+            "archive ...\n"
+            "       zipverifybench -m files zipcrypto|aes archive\n");
+}
+
+int main(int argc, char **argv)
+{
+    benchRun_t runs[BENCHMAXRUNS];
+    zipVerify_t info;
+    char (*wrong)[BENCHPASSWORDLEN] = NULL;
+    const char **passwords = NULL;
+    const char *output = NULL;
+    double times[BENCHMAXREPS];
+    double libarchiveMs = 0.0;
+    double secs = 0.0;
+    uint64_t start = 0;
+    uint64_t libarchiveOpened = 0;
+    unsigned long makeFiles = 0;
+    unsigned int numPasswords = 0;
+    unsigned int p = 0;
+    long numWrong = BENCHWRONGPASSWORDS;
+    FILE *fp = stdout;
+    int numRuns = 0;
+    int numReps = 3;
+    int run = 0;
+    int arc = 0;
+    int ret = 1;
+    int r = 0;
+    int i = 1;
+
+    memset(&info, 0, sizeof(zipVerify_t));
+    numRuns = benchParseWorkers("1,2,4", runs);
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            numRuns = benchParseWorkers(argv[++i], runs);
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            numWrong = strtol(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            numReps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            makeFiles = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (makeFiles > 0)
+    {
+        if (i + 2 != argc ||
+            (strcmp(argv[i], "zipcrypto") != 0 &&
+             strcmp(argv[i], "aes") != 0))
+        {
+            printUsage();
+            return 1;
+        }
+        return (benchMakeZip(argv[i + 1],
+                             makeFiles,
+                             strcmp(argv[i], "aes") == 0) == gBenchOkay ?
+                0 : 1);
+    }
+
+    if (i >= argc || numRuns < 1 || numReps < 1 ||
+        numReps > BENCHMAXREPS || numWrong < 0 ||
+        numWrong >= ZIPVERIFYMAXPASSWORDS)
+    {
+        printUsage();
+        return 1;
+    }
+
+    /* the wrong passwords come first */
+
+    numPasswords = (unsigned int)numWrong + 1;
+    wrong = calloc(numPasswords, sizeof(*wrong));
+    passwords = calloc(numPasswords, sizeof(const char *));
+    if (wrong == NULL || passwords == NULL)
+    {
+        goto done;
+    }
+
+    for (p = 0; p < (unsigned int)numWrong; p++)
+    {
+        snprintf(wrong[p], sizeof(wrong[p]), "wrong password %u", p + 1);
+        passwords[p] = wrong[p];
+    }
+    passwords[numWrong] = BENCHPASSWORD;
+
+    fp = benchOpenOutput("zipverifybench", output);
+    if (fp == NULL)
+    {
+        goto done;
+    }
+
+    fprintf(fp, "{\n  \"passwords\": %u,\n  \"archives\": [\n", numPasswords);
+
+    for (arc = i; arc < argc; arc++)
+    {
+        /* the first repetition of each way is a warm up */
+
+        for (r = -1; r < numReps; r++)
+        {
+            start = benchNow();
+            if (benchLibarchive(argv[arc],
+                                passwords,
+                                numPasswords,
+                                &libarchiveOpened) != gBenchOkay)
+            {
+                fprintf(stderr,
+                        "zipverifybench: ERROR: cannot read '%s'\n",
+                        argv[arc]);
+                goto done;
+            }
+            if (r >= 0)
+            {
+                times[r] = (double)(benchNow() - start) / 1000000.0;
+            }
+        }
+        libarchiveMs = benchMedian(times, numReps);
+
+        for (run = 0; run < numRuns; run++)
+        {
+            for (r = -1; r < numReps; r++)
+            {
+                zipVerifyFree(&info);
+
+                start = benchNow();
+                if (zipVerifyRead(argv[arc],
+                                  passwords,
+                                  numPasswords,
+                                  runs[run].workers,
+                                  &info) != gZipVerifyOkay)
+                {
+                    fprintf(stderr,
+                            "zipverifybench: ERROR: cannot check '%s'\n",
+                            argv[arc]);
+                    goto done;
+                }
+                if (r >= 0)
+                {
+                    times[r] = (double)(benchNow() - start) / 1000000.0;
+                }
+            }
+
+            runs[run].wallMs = benchMedian(times, numReps);
+            runs[run].workersUsed = info.workers;
+            runs[run].verifications = info.verifications;
+            runs[run].keysDerived = info.keysDerived;
+            runs[run].cacheHits = info.cacheHits;
+        }
+
+        fprintf(fp,
+                "    {\"archive\": \"%s\", \"entries\": %llu, "
+                "\"encrypted\": %u, \"cipher\": \"%s\", \"opened\": %u,\n"
+                "     \"libarchive\": {\"opened\": %llu, \"wallMs\": %.1f, "
+                "\"entriesPerSec\": %.0f},\n"
+                "     \"runs\": [\n",
+                argv[arc],
+                (unsigned long long)info.numEntries,
+                info.numEncrypted,
+                (info.numEncrypted > 0 ?
+                 zipVerifyCipherName(info.entries[0].cipher) : "none"),
+                info.numOpened,
+                (unsigned long long)libarchiveOpened,
+                libarchiveMs,
+                (double)info.numEncrypted /
+                    (libarchiveMs > 0.0 ? libarchiveMs / 1000.0 : 1e-9));
+
+        for (run = 0; run < numRuns; run++)
+        {
+            secs = (runs[run].wallMs > 0.0 ?
+                    runs[run].wallMs / 1000.0 : 1e-9);
+            fprintf(fp,
+                    "       {\"workers\": %d, \"workersUsed\": %u, "
+                    "\"wallMs\": %.1f, \"verifications\": %llu, "
+                    "\"keysDerived\": %llu, \"cacheHits\": %llu, "
+                    "\"verificationsPerSec\": %.0f, "
+                    "\"entriesPerSec\": %.0f, \"speedup\": %.2f}%s\n",
+                    runs[run].workers,
+                    runs[run].workersUsed,
+                    runs[run].wallMs,
+                    (unsigned long long)runs[run].verifications,
+                    (unsigned long long)runs[run].keysDerived,
+                    (unsigned long long)runs[run].cacheHits,
+                    (double)runs[run].verifications / secs,
+                    (double)info.numEncrypted / secs,
+                    (runs[run].wallMs > 0.0 ?
+                     libarchiveMs / runs[run].wallMs : 0.0),
+                    (run + 1 < numRuns ? "," : ""));
+        }
+
+        fprintf(fp, "     ]}%s\n", (arc + 1 < argc ? "," : ""));
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    ret = 0;
+
+done:
+    if (benchCloseOutput(fp) != 0)
+    {
+        ret = 1;
+    }
+    zipVerifyFree(&info);
+    free(passwords);
+    free(wrong);
+
+    return ret;
+}
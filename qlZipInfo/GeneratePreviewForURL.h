@@ -7,6 +7,17 @@
     v. 0.2.0 (11/13/2021) - add binhex support
     v. 0.3.0 (08/01/2022) - add stuffit support
     v. 0.4.0 (10/13/2024) - update color scheme based on PR#2
+    v. 0.4.1 (10/17/2026) - add optional per-phase tracing
+    v. 0.4.2 (10/17/2026) - add the limits for reading an archive
+    v. 0.4.3 (10/17/2026) - add the limits and column indent for
+                            archives inside of archives
+    v. 0.4.4 (10/17/2026) - add the entry record environment variables
+    v. 0.4.5 (10/17/2026) - add the most cabinet folder rows
+    v. 0.4.6 (10/17/2026) - add the most ar symbol rows
+    v. 0.4.7 (10/17/2026) - add the WARC index environment variable
+    v. 0.4.8 (10/17/2026) - declare the encryption banner
+    v. 0.4.9 (10/17/2026) - add the entry peek limits and names
+    v. 0.4.10 (10/17/2026) - preview compressed files, not only gzip
  
     Copyright (c) 2015-2022, 2024 Sriranga R. Veeraraghavan <ranga@calalum.org>
 
@@ -65,6 +76,85 @@ enum
     gColFileMacType     = 58,
     gColFileMacCreator  = 58,
     gColFileMacFileName = 356,
+    gColNestedIndent    = 16,
+};
+
+/*
+    Resource limits for reading an archive (see archive_read_set_limit
+    in archive.h), so that a hostile archive fails quickly instead of
+    tying up the preview
+ */
+
+enum
+{
+    gLimitEntries       = 10000000,
+    gLimitHeaderBytes   = 16 * 1024 * 1024,
+    gLimitDepth         = 512,
+    gLimitMemory        = 512 * 1024 * 1024,
+};
+
+/*
+    Limits for listing archives inside of an archive (see nested.h):
+    how deep to go, the largest nested archive that is read, how long
+    to spend on all of them (in seconds), and how many entries without
+    an extension to check for an archive's magic number
+ */
+
+enum
+{
+    gNestedMaxDepth     = 3,
+    gNestedMaxBytes     = 64 * 1024 * 1024,
+    gNestedTimeLimit    = 5,
+    gNestedMagicChecks  = 64,
+};
+
+/*
+    Most folders of a cabinet (.cab) to show a row for, after the
+    summary row (see cabinfo.h)
+ */
+
+enum
+{
+    gCabMaxFolderRows   = 32,
+};
+
+/*
+    Most members of an ar archive (.a) to show a symbol count row for,
+    after the summary row (see arinfo.h)
+ */
+
+enum
+{
+    gArMaxSymbolRows    = 32,
+};
+
+/*
+    Most text entries (README, Info.plist, manifests) of a zip, 7z,
+    xar or ISO9660 archive to show the start of, after the listing,
+    how many bytes of each to show, and how deep in the archive they
+    can be (see peek.h)
+ */
+
+enum
+{
+    gPeekMaxEntries     = 3,
+    gPeekMaxBytes       = 4096,
+    gPeekMaxDepth       = 3,
+};
+
+/* names of the text entries that are shown, ignoring case */
+
+static const char *gPeekEntryNames[] =
+{
+    "README",
+    "README.md",
+    "README.txt",
+    "Info.plist",
+    "MANIFEST.MF",
+    "manifest.json",
+    "package.json",
+    "PKG-INFO",
+    NULL,
 };
 
 /* table headings */
@@ -141,11 +231,43 @@ static const char *gMacFileTypeSIT5        = "SIT5";
 
 /* UTIs for files that may require special handling */
 
-static const CFStringRef gUTIGZip   = CFSTR("org.gnu.gnu-zip-archive");
 static const CFStringRef gUTIBinHex = CFSTR("com.apple.binhex-archive");
 static const CFStringRef gUTISIT1   = CFSTR("com.stuffit.archive.sit");
 static const CFStringRef gUTISIT2   = CFSTR("com.allume.stuffit-archive");
 
+/*
+    environment variable naming the directory to which traces are
+    written (see trace.h)
+ */
+
+static const char *gTraceEnvVar = "QLZIPINFO_TRACE";
+
+/*
+    environment variables naming the directory to which structured
+    records of the entries are written, and their format (see
+    records.h)
+ */
+
+static const char *gRecordsEnvVar       = "QLZIPINFO_RECORDS";
+static const char *gRecordsFormatEnvVar = "QLZIPINFO_RECORDS_FORMAT";
+
+/*
+    environment variable naming the directory to which a CDX index of
+    each WARC file that is previewed is written (see warcindex.h)
+ */
+
+static const char *gWarcIndexEnvVar = "QLZIPINFO_WARC_INDEX";
+
+/*
+    seconds from the Classic MacOS reference date (Jan 1, 1904) to
+    the Unix epoch
+ */
+
+enum
+{
+    gMacOSEpochOffset = 2082844800,
+};
+
 /* structs */
 
 typedef struct fileSizeSpec
@@ -161,6 +283,11 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
                                CFURLRef url,
                                CFStringRef contentTypeUTI,
                                CFDictionaryRef options);
+static OSStatus GeneratePreviewForArchive(void *thisInterface,
+                                          QLPreviewRequestRef preview,
+                                          CFURLRef url,
+                                          CFStringRef contentTypeUTI,
+                                          CFDictionaryRef options);
 static OSStatus GeneratePreviewForHQX(void *thisInterface,
                                       QLPreviewRequestRef preview,
                                       CFURLRef url,
@@ -173,11 +300,45 @@ static OSStatus GeneratePreviewForSIT(void *thisInterface,
                                       CFDictionaryRef options);
 void CancelPreviewGeneration(void *thisInterface,
                              QLPreviewRequestRef preview);
-static off_t getGZExpandedFileSize(const char *zipFileNameStr);
+static bool isPreviewCancelled(QLPreviewRequestRef preview);
 static int getFileSizeSpec(off_t fileSizeInBytes,
                            fileSizeSpec_t *fileSpec);
 static float getCompression(off_t uncompressedSize,
                             off_t compressedSize);
+static struct archive *newArchiveReader(void);
+static bool formatEntryRow(NSMutableString *qlHtml,
+                           struct archive_entry *entry,
+                           const char *fileName,
+                           bool isFolder,
+                           bool isRawFile,
+                           off_t fileSize,
+                           unsigned int depth,
+                           NSDateFormatter *dateFormatter);
+static void recordArchiveEntry(struct archive_entry *entry,
+                               const char *fileName,
+                               bool isFolder,
+                               bool isRawFile,
+                               off_t fileSize,
+                               unsigned int depth);
+static void formatCabFolderRows(NSMutableString *qlHtml,
+                                const char *cabFileName);
+static void formatArSymbolRows(NSMutableString *qlHtml,
+                               const char *arFileName);
+static void formatEncryptionBanner(NSMutableString *qlHtml,
+                                   const char *archiveFileName);
+static void writeWarcIndex(const char *warcFileName,
+                           const char *indexDir);
+static bool isPeekEntry(const char *fileName);
+static void formatPeekEntries(NSMutableString *qlHtml,
+                              const char *archiveFileName,
+                              NSArray *fileNames);
+static void listNestedArchive(NSMutableString *qlHtml,
+                              QLPreviewRequestRef preview,
+                              struct archive *parent,
+                              struct archive_entry *container,
+                              unsigned int depth,
+                              nestedLimits_t *limits,
+                              NSDateFormatter *dateFormatter);
 static bool formatOutputHeader(NSMutableString *qlHtml);
 static bool startOutputBody(NSMutableString *qlHtml);
 static bool endOutputBody(NSMutableString *qlHtml);
@@ -31,6 +31,26 @@
     v. 0.3.0 (11/13/2021) - add support for binhex archives
     v. 0.4.0 (08/01/2022) - add support for stuffit archives
     v. 0.5.0 (10/13/2024) - update color scheme based on PR#2
+    v. 0.5.1 (10/17/2026) - add optional per-phase tracing
+    v. 0.5.2 (10/17/2026) - list archives inside of archives
+    v. 0.5.3 (10/17/2026) - add optional NDJSON / CBOR records
+    v. 0.5.4 (10/17/2026) - add support for WARC files and optional
+                            CDX indexes of them
+    v. 0.5.5 (10/17/2026) - add support for mtree manifests
+    v. 0.5.6 (10/17/2026) - preview xz, bzip2, zstd and lz4 compressed
+                            files
+    v. 0.5.7 (10/17/2026) - limit the entries, header bytes, nesting and
+                            memory used to read an archive
+    v. 0.5.8 (10/17/2026) - show a row for each folder of a cabinet
+    v. 0.5.9 (10/17/2026) - show the symbol counts of an ar archive's
+                            members
+    v. 0.5.10 (10/17/2026) - show a banner for archives with encrypted
+                             entries
+    v. 0.5.11 (10/17/2026) - list the pbzx payloads of .xip files and
+                             packages
+    v. 0.5.12 (10/17/2026) - add support for ISO9660 .dmg disk images
+    v. 0.5.13 (10/17/2026) - show the start of README and other text
+                             entries
 
     Copyright (c) 2015-2022, 2024 Sriranga R. Veeraraghavan <ranga@calalum.org>
 
@@ -62,6 +82,9 @@
 #import <stdio.h>
 #import <sys/syslimits.h>
 #import <sys/stat.h>
+#import <fcntl.h>
+#import <errno.h>
+#import <unistd.h>
 #import <iconv.h>
 
 #import "config.h"
@@ -69,6 +92,15 @@
 #import "archive_entry.h"
 #import "binhex.h"
 #import "sit.h"
+#import "nested.h"
+#import "cabinfo.h"
+#import "arinfo.h"
+#import "warcindex.h"
+#import "peek.h"
+#import "rawsize.h"
+#import "summary.h"
+#import "records.h"
+#import "trace.h"
 #import "GTMNSString+HTML.h"
 #import "GeneratePreviewForURL.h"
 
@@ -81,19 +113,77 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
                                CFURLRef url,
                                CFStringRef contentTypeUTI,
                                CFDictionaryRef options)
+{
+    OSStatus status = noErr;
+    uint64_t traceStartTime = 0;
+
+    /* record a trace of this preview, if requested */
+
+    traceStart(getenv(gTraceEnvVar));
+    if (traceIsEnabled())
+    {
+        traceStartTime = traceNow();
+    }
+
+    /* write structured records of the entries, if requested */
+
+    recStart(getenv(gRecordsEnvVar), getenv(gRecordsFormatEnvVar));
+
+    if (CFEqual(contentTypeUTI, gUTIBinHex) == true)
+    {
+        /* binhex file */
+
+        status = GeneratePreviewForHQX(thisInterface,
+                                       preview,
+                                       url,
+                                       contentTypeUTI,
+                                       options);
+    }
+    else if (CFEqual(contentTypeUTI, gUTISIT1) == true ||
+             CFEqual(contentTypeUTI, gUTISIT2) == true)
+    {
+        /* stuffit archive */
+
+        status = GeneratePreviewForSIT(thisInterface,
+                                       preview,
+                                       url,
+                                       contentTypeUTI,
+                                       options);
+    }
+    else
+    {
+        status = GeneratePreviewForArchive(thisInterface,
+                                           preview,
+                                           url,
+                                           contentTypeUTI,
+                                           options);
+    }
+
+    if (traceIsEnabled())
+    {
+        traceEnd(TracePhasePreview, traceStartTime);
+    }
+    traceStop();
+    recStop();
+
+    return status;
+}
+
+/* GeneratePreviewForArchive - generate the preview for a libarchive archive */
+
+static OSStatus GeneratePreviewForArchive(void *thisInterface,
+                                          QLPreviewRequestRef preview,
+                                          CFURLRef url,
+                                          CFStringRef contentTypeUTI,
+                                          CFDictionaryRef options)
 {
     NSMutableDictionary *qlHtmlProps = nil;
-    NSString *qlEntryIcon = nil;
     NSMutableString *qlHtml = nil;
-    NSMutableString *fileDateStringInZip = nil;
     NSMutableString *localeString = nil;
-    NSDateFormatter *fileDateFormatterInZip = nil;
     NSDateFormatter *fileLocalDateFormatterInZip = nil;
-    NSDate *fileDateInZip = nil;
     CFMutableStringRef zipFileName = NULL;
     const char *zipFileNameStr = NULL;
     char zipFileNameCStr[PATH_MAX];
-    NSString *fileNameInZipEscaped = nil;
     const char *fileNameInZip;
     struct archive *a;
     struct archive_entry *entry;
@@ -105,8 +195,24 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
     off_t totalCompressedSize = 0;
     off_t fileCompressedSize = 0;
     bool isFolder = FALSE;
-    bool isGZFile = false;
+    bool isRawFile = false;
+    rawFormat_t rawFormat = RawFormatUnknown;
+    rawSize_t rawSize;
+    char rawFileName[PATH_MAX];
+    const char *baseName = NULL;
+    size_t extensionLen = 0;
+    size_t baseNameLen = 0;
+    bool isCabFile = false;
+    bool isArFile = false;
+    bool isWarcFile = false;
+    bool isMtreeFile = false;
+    bool isPeekFile = false;
+    NSMutableArray *peekFileNames = nil;
+    NSString *peekFileName = nil;
     fileSizeSpec_t fileSizeSpecInZip;
+    nestedLimits_t nestedLimits;
+    uint64_t traceStartTime = 0;
+    uint64_t traceRowStartTime = 0;
 
     if (url == NULL)
     {
@@ -114,29 +220,6 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
         return zipQLFailed;
     }
 
-    /* binhex file */
-
-    if (CFEqual(contentTypeUTI, gUTIBinHex) == true)
-    {
-        return GeneratePreviewForHQX(thisInterface,
-                                     preview,
-                                     url,
-                                     contentTypeUTI,
-                                     options);
-    }
-
-    /* stuffit archive */
-
-    if (CFEqual(contentTypeUTI, gUTISIT1) == true ||
-        CFEqual(contentTypeUTI, gUTISIT2) == true)
-    {
-        return GeneratePreviewForSIT(thisInterface,
-                                     preview,
-                                     url,
-                                     contentTypeUTI,
-                                     options);
-    }
-
     /* get the local file system path for the specified file */
 
     zipFileName =
@@ -182,7 +265,7 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
 
     /*  exit if the user canceled the preview */
 
-    if (QLPreviewRequestIsCancelled(preview))
+    if (isPreviewCancelled(preview))
     {
         return noErr;
     }
@@ -206,35 +289,27 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
 
     /* initialize the archive object */
 
-    a = archive_read_new();
-
-    /* enable filters */
-
-    archive_read_support_filter_compress(a);
-    archive_read_support_filter_gzip(a);
-    archive_read_support_filter_bzip2(a);
-    archive_read_support_filter_xz(a);
-    archive_read_support_filter_uu(a);
-    archive_read_support_filter_rpm(a);
-
-    /* enable archive formats */
-
-    archive_read_support_format_cpio(a);
-    archive_read_support_format_tar(a);
-    archive_read_support_format_zip(a);
-    archive_read_support_format_xar(a);
-    archive_read_support_format_iso9660(a);
-    archive_read_support_format_rar(a);
-    archive_read_support_format_rar5(a);
-    archive_read_support_format_lha(a);
-    archive_read_support_format_ar(a);
-    archive_read_support_format_7zip(a);
-    archive_read_support_format_cab(a);
+    a = newArchiveReader();
+    if (a == NULL)
+    {
+        fprintf(stderr, "qlZipInfo: ERROR: can't create archive reader\n");
+        return zipQLFailed;
+    }
 
     /* open the archive for reading */
 
+    if (traceIsEnabled())
+    {
+        traceStartTime = traceNow();
+    }
+
     r = archive_read_open_filename(a, zipFileNameStr, 10240);
 
+    if (traceIsEnabled())
+    {
+        traceEnd(TracePhaseOpen, traceStartTime);
+    }
+
     /* return an error if the file couldn't be opened */
 
     if (r != ARCHIVE_OK)
@@ -251,27 +326,42 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
 
     if (r == zipQLFailed)
     {
-        /* if this is a gzip'ed file, re-try opening in raw mode */
+        /*
+            if this is a compressed file, and not a compressed
+            archive, re-try opening it in raw mode
+         */
 
-        if (CFEqual(contentTypeUTI, gUTIGZip) != true)
+        rawFormat = rawSizeGetFormat(zipFileNameStr);
+        if (rawFormat == RawFormatUnknown)
         {
             return r;
         }
 
-        isGZFile = true;
+        isRawFile = true;
 
         a = archive_read_new();
         archive_read_support_format_raw(a);
-        archive_read_support_filter_gzip(a);
+
+        /*
+            only a gzip'ed file has a header with its name and date,
+            so only it is read through its filter; the others aren't
+            decompressed at all (see rawsize.h for their sizes)
+         */
+
+        if (rawFormat == RawFormatGZip)
+        {
+            archive_read_support_filter_gzip(a);
+        }
 
         r = archive_read_open_filename(a, zipFileNameStr, 10240);
 
-        /* return an error if the gzip'ed couldn't be opened */
+        /* return an error if the compressed file couldn't be opened */
 
         if (r != ARCHIVE_OK)
         {
             fprintf(stderr,
-                    "qlZipInfo: ERROR: gz: %s\n",
+                    "qlZipInfo: ERROR: %s: %s\n",
+                    rawSizeFormatName(rawFormat),
                     archive_error_string(a));
             archive_read_close(a);
             archive_read_free(a);
@@ -281,7 +371,7 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
 
     /*  exit if the user canceled the preview */
 
-    if (QLPreviewRequestIsCancelled(preview))
+    if (isPreviewCancelled(preview))
     {
         archive_read_close(a);
         archive_read_free(a);
@@ -306,6 +396,16 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
 
     startOutputBody(qlHtml);
 
+    /*
+        show a banner if any entries are encrypted, before listing
+        the entries, which can stop at an encrypted header
+     */
+
+    if (isRawFile != true)
+    {
+        formatEncryptionBanner(qlHtml, zipFileNameStr);
+    }
+
     /*
        start the table
        based on: http://www.w3.org/TR/html4/struct/tables.html
@@ -341,6 +441,16 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
 
     [qlHtml appendString: @"<tbody>\n"];
 
+    /* initialize the date formatter for the local date format */
+
+    fileLocalDateFormatterInZip = [[NSDateFormatter alloc] init];
+
+    /* archives in the zip file are listed within these limits */
+
+    nestedLimits.maxBytes = gNestedMaxBytes;
+    nestedLimits.deadline = nestedDeadline(gNestedTimeLimit);
+    nestedLimits.magicChecks = gNestedMagicChecks;
+
     /* list the files in the zip file */
     for (i = 0; i >= 0; i++)
     {
@@ -369,10 +479,16 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
 
         /*  stop listing files if the user canceled the preview */
 
-        if (QLPreviewRequestIsCancelled(preview)) {
+        if (isPreviewCancelled(preview)) {
             break;
         }
 
+        if (traceIsEnabled())
+        {
+            traceRowStartTime = traceNow();
+            traceStartTime = traceRowStartTime;
+        }
+
         fileNameInZip = archive_entry_pathname(entry);
         if (fileNameInZip == NULL)
         {
@@ -384,201 +500,167 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
             fileNameInZip = gFileNameUnavilable;
         }
 
-        if (isGZFile == true)
+        if (isRawFile == true)
         {
             isFolder = FALSE;
-        }
-        else
-        {
-            isFolder =
-                (archive_entry_filetype(entry) == AE_IFDIR ? TRUE : FALSE);
-        }
-
-        /* start the table row for this entry */
-
-        [qlHtml appendFormat: @"<tr>"];
-
-        /*
-            add an icon depending on whether the entry is a file,
-            folder/directory, or encrypted.
-
-            based on: http://apps.timwhitlock.info/emoji/tables/unicode
-                      http://www.unicode.org/emoji/charts/full-emoji-list.html
-                      https://stackoverflow.com/questions/10580186/how-to-display-emoji-char-in-html
-                      https://github.com/nmoinvaz/minizip/blob/1.2/miniunz.c
-         */
 
-        qlEntryIcon = (NSString *)gFileIcon;
+            /*
+                a compressed file without a name of its own is named
+                after the file, without its extension, and dated
+                like it
+             */
 
-        if (isGZFile != true)
-        {
-            if (isFolder == TRUE)
-            {
-                qlEntryIcon = (NSString *)gFolderIcon;
-            }
-            else if (archive_entry_is_encrypted(entry))
-            {
-                qlEntryIcon = (NSString *)gFileEncyrptedIcon;
-            }
-            else if (archive_entry_filetype(entry) == AE_IFLNK)
+            if (strcmp(fileNameInZip, "data") == 0)
             {
-                qlEntryIcon = (NSString *)gFileLinkIcon;
+                baseName = strrchr(zipFileNameStr, '/');
+                baseName = (baseName != NULL ? baseName + 1 : zipFileNameStr);
+                snprintf(rawFileName, sizeof(rawFileName), "%s", baseName);
+
+                baseNameLen = strlen(rawFileName);
+                extensionLen = strlen(rawSizeExtension(rawFormat));
+                if (baseNameLen > extensionLen &&
+                    strcasecmp(rawFileName + baseNameLen - extensionLen,
+                               rawSizeExtension(rawFormat)) == 0)
+                {
+                    rawFileName[baseNameLen - extensionLen] = '\0';
+                }
+
+                fileNameInZip = rawFileName;
             }
-            else if (archive_entry_filetype(entry) != AE_IFREG)
+
+            if (archive_entry_mtime_is_set(entry) == 0 &&
+                stat(zipFileNameStr, &fileStats) == 0)
             {
-                qlEntryIcon = (NSString *)gFileSpecialIcon;
+                archive_entry_set_mtime(entry, fileStats.st_mtime, 0);
             }
         }
-
-        [qlHtml appendFormat: @"<td align=\"center\">%@</td>",
-                              qlEntryIcon];
-
-        /* output the filename with HTML escaping */
-
-        fileNameInZipEscaped =
-            [[NSString stringWithUTF8String: fileNameInZip]
-                                             gtm_stringByEscapingForHTML];
-        if (fileNameInZipEscaped == nil)
+        else
         {
-            fileNameInZipEscaped = (NSString *)gFileNameUnavilableStr;
+            isFolder =
+                (archive_entry_filetype(entry) == AE_IFDIR ? TRUE : FALSE);
         }
 
-        [qlHtml appendString: @"<td><div style=\"display: block; "];
-
-        [qlHtml appendFormat: @"word-wrap: break-word;\">%@</div></td>",
-                              fileNameInZipEscaped];
-
-        /*
-            if the entry is a folder, don't print out its size,
-            which is always 0
-         */
-
-        if (isFolder == TRUE) {
-            [qlHtml appendString:
-                    @"<td align=\"center\" colspan=\"2\"><pre>--</pre></td>"];
-        } else {
+        /* get the file's size, which is not shown for folders */
 
-            if (isGZFile == true)
+        if (isFolder != TRUE)
+        {
+            if (isRawFile == true)
             {
-                fileCompressedSize = getGZExpandedFileSize(zipFileNameStr);
+                /* the size is unknown (-1) if it isn't recorded */
+
+                fileCompressedSize =
+                    (rawSizeRead(zipFileNameStr, &rawSize) == gRawSizeOkay ?
+                     (off_t)rawSize.size : -1);
             }
             else
             {
                 fileCompressedSize = archive_entry_size(entry);
             }
-
-            /* clear the file size spec */
-
-            memset(&fileSizeSpecInZip, 0, sizeof(fileSizeSpec_t));
-
-            /* get the file's size spec */
-
-            getFileSizeSpec(fileCompressedSize,
-                            &fileSizeSpecInZip);
-
-            /* print out the file's size in B, K, M, G, or T */
-
-            [qlHtml appendFormat:
-                    @"<td align=\"right\">%-.1f %-1s</td>",
-                    fileSizeSpecInZip.size,
-                    fileSizeSpecInZip.spec];
-
-            [qlHtml appendString:
-                    @"<td align=\"right\">&nbsp;</td>"];
-
-            //[qlHtml appendString: @"</td>"];
         }
 
-        /*
-            print out the modified date and time for the file in the local
-            format. based on: https://stackoverflow.com/questions/9676435/how-do-i-format-the-current-date-for-the-users-locale
-                      https://stackoverflow.com/questions/4895697/nsdateformatter-datefromstring
-                      http://unicode.org/reports/tr35/tr35-4.html#Date_Format_Patterns
-         */
-
-        /* init the date string (if needed) and clear it */
-
-        if (fileDateStringInZip == nil) {
-            fileDateStringInZip =
-                [[NSMutableString alloc] initWithString: @""];
-        } else {
-            [fileDateStringInZip setString: @""];
+        formatEntryRow(qlHtml,
+                       entry,
+                       fileNameInZip,
+                       isFolder,
+                       isRawFile,
+                       fileCompressedSize,
+                       0,
+                       fileLocalDateFormatterInZip);
+
+        /* remember the first few text entries to show after the list */
+
+        if (isFolder != TRUE &&
+            isRawFile == false &&
+            [peekFileNames count] < gPeekMaxEntries &&
+            isPeekEntry(fileNameInZip) &&
+            (peekFileName =
+                [NSString stringWithUTF8String: fileNameInZip]) != nil)
+        {
+            if (peekFileNames == nil)
+            {
+                peekFileNames =
+                    [NSMutableArray arrayWithCapacity: gPeekMaxEntries];
+            }
+            [peekFileNames addObject: peekFileName];
         }
 
-        /*
-            initialize the date formatter corresponding to this file's
-            date, as stored in the zip file
-         */
-
-        if (fileDateFormatterInZip == nil) {
-            fileDateFormatterInZip = [[NSDateFormatter alloc] init];
-            [fileDateFormatterInZip setDateFormat: @"MM-dd-yy HH:mm"];
+        if (traceIsEnabled())
+        {
+            traceEnd(TracePhaseHTML, traceRowStartTime);
+            traceCount(TraceCounterRowsRendered, 1);
         }
 
-        /* initialize the date formatter for the local date format */
-
-        if (fileLocalDateFormatterInZip == nil) {
-            fileLocalDateFormatterInZip = [[NSDateFormatter alloc] init];
+        if (recIsEnabled())
+        {
+            recordArchiveEntry(entry,
+                               fileNameInZip,
+                               isFolder,
+                               isRawFile,
+                               fileCompressedSize,
+                               0);
         }
 
-        /* create a string that holds the date for this file */
-
-        fileDateInZip =
-            [NSDate dateWithTimeIntervalSince1970:
-             archive_entry_mtime(entry)];
+        /* update the total compressed size */
 
-        /*
-            if the date object is not nil, print out one table cell
-            corresponding to the date and another table cell corresponding
-            to the time, both in the local format; but if the date is nil,
-            use a default format
-         */
+        if (fileCompressedSize > 0)
+        {
+            totalSize += fileCompressedSize;
+        }
 
-        if (fileDateInZip != nil) {
+        /* if this was a compressed file, no need to repeat the loop */
 
-            /*
-                Make sure the days and months are zero prefixed.
-                Based on:
+        if (isRawFile == true)
+        {
+            break;
+        }
 
-                https://nsdateformatter.com/
-                https://developer.apple.com/documentation/foundation/nsdateformatter/1417087-setlocalizeddateformatfromtempla?language=objc
-             */
+        /* list the entries of an archive in the zip file */
 
-            [fileLocalDateFormatterInZip setLocale:
-                [NSLocale currentLocale]];
+        listNestedArchive(qlHtml,
+                          preview,
+                          a,
+                          entry,
+                          1,
+                          &nestedLimits,
+                          fileLocalDateFormatterInZip);
+    }
 
-            [fileLocalDateFormatterInZip
-                setLocalizedDateFormatFromTemplate: @"MM-dd-yyyy"];
+    /* the folders of a cabinet are listed after the summary row */
 
-            [qlHtml appendFormat:
-                @"<td align=\"right\">%@</td>",
-                [fileLocalDateFormatterInZip stringFromDate: fileDateInZip]];
+    isCabFile = (archive_format(a) == ARCHIVE_FORMAT_CAB);
 
-            [fileLocalDateFormatterInZip
-                setLocalizedDateFormatFromTemplate: @"HH:mm"];
+    /* and the symbols of a static library's members */
 
-            [qlHtml appendFormat:
-                @"<td align=\"right\">%@</td>",
-                [fileLocalDateFormatterInZip stringFromDate: fileDateInZip]];
-        } else {
-            [qlHtml appendFormat:
-                @"<td align=\"center\">&nbsp;</td>"];
-        }
+    isArFile = ((archive_format(a) & ARCHIVE_FORMAT_BASE_MASK) ==
+                ARCHIVE_FORMAT_AR);
 
-        /* close the row */
+    /* and WARC files are indexed, if requested */
 
-        [qlHtml appendString:@"</tr>\n"];
+    isWarcFile = (archive_format(a) == ARCHIVE_FORMAT_WARC);
 
-        /* update the total compressed size */
+    /*
+        an mtree manifest only describes files, so its size is not
+        a compressed size
+     */
 
-        totalSize += fileCompressedSize;
+    isMtreeFile = (archive_format(a) == ARCHIVE_FORMAT_MTREE);
 
-        /* if this was a GZip'ed file, no need to repeat the loop */
+    /*
+        the text entries of archives with a directory can be read
+        without reading the entries ahead of them
+     */
 
-        if (isGZFile == true)
-        {
+    switch (archive_format(a) & ARCHIVE_FORMAT_BASE_MASK)
+    {
+        case ARCHIVE_FORMAT_ZIP:
+        case ARCHIVE_FORMAT_7ZIP:
+        case ARCHIVE_FORMAT_XAR:
+        case ARCHIVE_FORMAT_ISO9660:
+            isPeekFile = true;
+            break;
+        default:
+            isPeekFile = false;
             break;
-        }
     }
 
     /* close the zip file */
@@ -625,7 +707,7 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
                           fileSizeSpecInZip.size,
                           fileSizeSpecInZip.spec];
 
-    if (stat(zipFileNameStr, &fileStats) == 0)
+    if (isMtreeFile == false && stat(zipFileNameStr, &fileStats) == 0)
     {
         totalCompressedSize = fileStats.st_size;
 
@@ -664,6 +746,27 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
 
     [qlHtml appendString:@"</tr>\n"];
 
+    /* add a row for each of a cabinet's folders */
+
+    if (isCabFile == true)
+    {
+        formatCabFolderRows(qlHtml, zipFileNameStr);
+    }
+
+    /* add a row for each of a static library's members with symbols */
+
+    if (isArFile == true)
+    {
+        formatArSymbolRows(qlHtml, zipFileNameStr);
+    }
+
+    /* write a CDX index of a WARC file's records, if requested */
+
+    if (isWarcFile == true)
+    {
+        writeWarcIndex(zipFileNameStr, getenv(gWarcIndexEnvVar));
+    }
+
     /* close the table body */
 
     [qlHtml appendString: @"</tbody>\n"];
@@ -672,16 +775,33 @@ OSStatus GeneratePreviewForURL(void *thisInterface,
 
     [qlHtml appendString: @"</table>\n"];
 
+    /* show the start of the archive's text entries, if it has any */
+
+    if (isPeekFile == true && peekFileNames != nil)
+    {
+        formatPeekEntries(qlHtml, zipFileNameStr, peekFileNames);
+    }
+
     /* close the html */
 
     endOutputBody(qlHtml);
 
+    if (traceIsEnabled())
+    {
+        traceStartTime = traceNow();
+    }
+
     QLPreviewRequestSetDataRepresentation(preview,
                                           (__bridge CFDataRef)[qlHtml dataUsingEncoding:
                                                 NSUTF8StringEncoding],
                                           kUTTypeHTML,
                                           (__bridge CFDictionaryRef)qlHtmlProps);
 
+    if (traceIsEnabled())
+    {
+        traceEnd(TracePhaseHTML, traceStartTime);
+    }
+
     return (zipErr == 0 ? noErr : zipQLFailed);
 }
 
@@ -702,6 +822,7 @@ static OSStatus GeneratePreviewForHQX(void *thisInterface,
     NSString *escapedStr = nil;
     hqxFileHandle_t hqxFile;
     fileSizeSpec_t fileSizeSpecInZip;
+    recEntry_t rec;
 
     if (url == NULL)
     {
@@ -761,7 +882,7 @@ static OSStatus GeneratePreviewForHQX(void *thisInterface,
 
     /*  exit if the user canceled the preview */
 
-    if (QLPreviewRequestIsCancelled(preview))
+    if (isPreviewCancelled(preview))
     {
         return noErr;
     }
@@ -775,7 +896,7 @@ static OSStatus GeneratePreviewForHQX(void *thisInterface,
 
     /*  exit if the user canceled the preview */
 
-    if (QLPreviewRequestIsCancelled(preview))
+    if (isPreviewCancelled(preview))
     {
         hqxReleaseFileHandle(&hqxFile);
         return noErr;
@@ -789,7 +910,7 @@ static OSStatus GeneratePreviewForHQX(void *thisInterface,
         return zipQLFailed;
     }
 
-    if (QLPreviewRequestIsCancelled(preview))
+    if (isPreviewCancelled(preview))
     {
         hqxReleaseFileHandle(&hqxFile);
         return noErr;
@@ -923,6 +1044,18 @@ static OSStatus GeneratePreviewForHQX(void *thisInterface,
 
     [qlHtml appendString:@"</tr>\n"];
 
+    if (recIsEnabled())
+    {
+        memset(&rec, 0, sizeof(recEntry_t));
+        rec.path = hqxFile.hqxHeader.asciiName;
+        rec.type = RecTypeFile;
+        rec.size = hqxFile.hqxHeader.dataLen + hqxFile.hqxHeader.rsrcLen;
+        rec.hasSize = 1;
+        rec.macType = hqxFile.hqxHeader.type;
+        rec.macCreator = hqxFile.hqxHeader.creator;
+        recWrite(&rec);
+    }
+
     /* close the main table's body */
 
     [qlHtml appendString: @"</tbody>\n"];
@@ -970,6 +1103,7 @@ static OSStatus GeneratePreviewForSIT(void *thisInterface,
     sitFileHandle_t sitFile;
     fileSizeSpec_t fileSizeSpecInZip;
     sitEntryHeader_t eHdr;
+    recEntry_t rec;
     size_t totalEntries = 0;
     NSDateComponents *macosRefDateComponents = nil;
     NSCalendar *gregorian = nil;
@@ -1040,7 +1174,7 @@ static OSStatus GeneratePreviewForSIT(void *thisInterface,
 
     /*  exit if the user canceled the preview */
 
-    if (QLPreviewRequestIsCancelled(preview))
+    if (isPreviewCancelled(preview))
     {
         return noErr;
     }
@@ -1054,7 +1188,7 @@ static OSStatus GeneratePreviewForSIT(void *thisInterface,
 
     /*  exit if the user canceled the preview */
 
-    if (QLPreviewRequestIsCancelled(preview))
+    if (isPreviewCancelled(preview))
     {
         sitReleaseFileHandle(&sitFile);
         return noErr;
@@ -1121,7 +1255,7 @@ static OSStatus GeneratePreviewForSIT(void *thisInterface,
             break;
         }
 
-        if (QLPreviewRequestIsCancelled(preview)) {
+        if (isPreviewCancelled(preview)) {
             break;
         }
 
@@ -1309,6 +1443,27 @@ static OSStatus GeneratePreviewForSIT(void *thisInterface,
 
         [qlHtml appendString:@"</tr>\n"];
 
+        if (recIsEnabled())
+        {
+            memset(&rec, 0, sizeof(recEntry_t));
+            rec.path = fileNameInZip;
+            rec.type = (isFolder == TRUE ? RecTypeDir : RecTypeFile);
+            if (isFolder != TRUE)
+            {
+                rec.size = sitEntryGetUnCompressedSize(&eHdr);
+                rec.hasSize = 1;
+                rec.compressedSize = sitEntryGetCompressedSize(&eHdr);
+                rec.hasCompressedSize = 1;
+            }
+            rec.mtime = (int64_t)sitEntryGetModifiedDate(&eHdr) -
+                        gMacOSEpochOffset;
+            rec.hasMtime = 1;
+            rec.encrypted = (sitIsEntryEncrypted(&eHdr) ? 1 : 0);
+            rec.macType = eHdr.type;
+            rec.macCreator = eHdr.creator;
+            recWrite(&rec);
+        }
+
     } while (zipErr == gSitOkay);
 
     totalCompressedSize = sitGetSize(&sitFile);
@@ -1419,6 +1574,906 @@ void CancelPreviewGeneration(void *thisInterface,
 
 /* private functions */
 
+/*
+    isPreviewCancelled - returns true if the user canceled the
+                         preview
+ */
+
+static bool isPreviewCancelled(QLPreviewRequestRef preview)
+{
+    if (traceIsEnabled())
+    {
+        traceCount(TraceCounterCancelChecks, 1);
+    }
+
+    return QLPreviewRequestIsCancelled(preview);
+}
+
+/*
+    newArchiveReader - create an archive reader with the filters,
+                       formats, and limits used for all archives
+ */
+
+static struct archive *newArchiveReader(void)
+{
+    struct archive *a = NULL;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return NULL;
+    }
+
+    /* enable filters */
+
+    archive_read_support_filter_compress(a);
+    archive_read_support_filter_gzip(a);
+    archive_read_support_filter_bzip2(a);
+    archive_read_support_filter_xz(a);
+    archive_read_support_filter_uu(a);
+    archive_read_support_filter_rpm(a);
+    archive_read_support_filter_pbzx(a);
+    archive_read_support_filter_udif(a);
+
+    /* enable archive formats */
+
+    archive_read_support_format_cpio(a);
+    archive_read_support_format_tar(a);
+    archive_read_support_format_zip(a);
+    archive_read_support_format_xar(a);
+    archive_read_support_format_iso9660(a);
+    archive_read_support_format_rar(a);
+    archive_read_support_format_rar5(a);
+    archive_read_support_format_lha(a);
+    archive_read_support_format_ar(a);
+    archive_read_support_format_7zip(a);
+    archive_read_support_format_cab(a);
+    archive_read_support_format_warc(a);
+    archive_read_support_format_mtree(a);
+
+    /* bound the work a hostile archive can cause */
+
+    archive_read_set_limit(a, ARCHIVE_READ_LIMIT_ENTRIES, gLimitEntries);
+    archive_read_set_limit(a,
+                           ARCHIVE_READ_LIMIT_HEADER_BYTES,
+                           gLimitHeaderBytes);
+    archive_read_set_limit(a, ARCHIVE_READ_LIMIT_DEPTH, gLimitDepth);
+    archive_read_set_limit(a, ARCHIVE_READ_LIMIT_MEMORY, gLimitMemory);
+
+    return a;
+}
+
+/* formatEntryRow - format the table row for an archive entry */
+
+static bool formatEntryRow(NSMutableString *qlHtml,
+                           struct archive_entry *entry,
+                           const char *fileName,
+                           bool isFolder,
+                           bool isRawFile,
+                           off_t fileSize,
+                           unsigned int depth,
+                           NSDateFormatter *dateFormatter)
+{
+    NSString *qlEntryIcon = nil;
+    NSString *fileNameEscaped = nil;
+    NSString *hardLinkEscaped = nil;
+    NSDate *fileDate = nil;
+    fileSizeSpec_t fileSizeSpec;
+    uint64_t traceStartTime = 0;
+
+    if (qlHtml == nil || entry == NULL || fileName == NULL)
+    {
+        return false;
+    }
+
+    /* start the table row for this entry */
+
+    [qlHtml appendFormat: @"<tr>"];
+
+    /*
+        add an icon depending on whether the entry is a file,
+        folder/directory, or encrypted.
+
+        based on: http://apps.timwhitlock.info/emoji/tables/unicode
+                  http://www.unicode.org/emoji/charts/full-emoji-list.html
+                  https://stackoverflow.com/questions/10580186/how-to-display-emoji-char-in-html
+                  https://github.com/nmoinvaz/minizip/blob/1.2/miniunz.c
+     */
+
+    qlEntryIcon = (NSString *)gFileIcon;
+
+    if (isRawFile != true)
+    {
+        if (isFolder == TRUE)
+        {
+            qlEntryIcon = (NSString *)gFolderIcon;
+        }
+        else if (archive_entry_is_encrypted(entry))
+        {
+            qlEntryIcon = (NSString *)gFileEncyrptedIcon;
+        }
+        else if (archive_entry_filetype(entry) == AE_IFLNK ||
+                 archive_entry_hardlink(entry) != NULL)
+        {
+            qlEntryIcon = (NSString *)gFileLinkIcon;
+        }
+        else if (archive_entry_filetype(entry) != AE_IFREG)
+        {
+            qlEntryIcon = (NSString *)gFileSpecialIcon;
+        }
+    }
+
+    [qlHtml appendFormat: @"<td align=\"center\">%@</td>",
+                          qlEntryIcon];
+
+    /* output the filename with HTML escaping */
+
+    if (traceIsEnabled())
+    {
+        traceStartTime = traceNow();
+    }
+
+    fileNameEscaped =
+        [[NSString stringWithUTF8String: fileName]
+                                         gtm_stringByEscapingForHTML];
+    if (fileNameEscaped == nil)
+    {
+        fileNameEscaped = (NSString *)gFileNameUnavilableStr;
+    }
+
+    if (traceIsEnabled())
+    {
+        traceEnd(TracePhaseConvert, traceStartTime);
+    }
+
+    [qlHtml appendString: @"<td><div "];
+
+    /* name the first link of a hard link's group in its tooltip */
+
+    if (isRawFile != true && archive_entry_hardlink(entry) != NULL)
+    {
+        hardLinkEscaped =
+            [[NSString stringWithUTF8String: archive_entry_hardlink(entry)]
+                                             gtm_stringByEscapingForHTML];
+        if (hardLinkEscaped != nil)
+        {
+            [qlHtml appendFormat: @"title=\"&#x2192; %@\" ",
+                                  hardLinkEscaped];
+        }
+    }
+
+    [qlHtml appendString: @"style=\"display: block; "];
+
+    /* indent the entries of nested archives under their container */
+
+    if (depth > 0)
+    {
+        [qlHtml appendFormat: @"padding-left: %upx; ",
+                              depth * gColNestedIndent];
+    }
+
+    [qlHtml appendFormat: @"word-wrap: break-word;\">%@</div></td>",
+                          fileNameEscaped];
+
+    /*
+        if the entry is a folder, don't print out its size,
+        which is always 0, nor a size that isn't known
+     */
+
+    if (isFolder == TRUE || fileSize < 0) {
+        [qlHtml appendString:
+                @"<td align=\"center\" colspan=\"2\"><pre>--</pre></td>"];
+    } else {
+
+        /* clear the file size spec */
+
+        memset(&fileSizeSpec, 0, sizeof(fileSizeSpec_t));
+
+        /* get the file's size spec */
+
+        getFileSizeSpec(fileSize,
+                        &fileSizeSpec);
+
+        /* print out the file's size in B, K, M, G, or T */
+
+        [qlHtml appendFormat:
+                @"<td align=\"right\">%-.1f %-1s</td>",
+                fileSizeSpec.size,
+                fileSizeSpec.spec];
+
+        [qlHtml appendString:
+                @"<td align=\"right\">&nbsp;</td>"];
+
+        //[qlHtml appendString: @"</td>"];
+    }
+
+    /*
+        print out the modified date and time for the file in the local
+        format. based on: https://stackoverflow.com/questions/9676435/how-do-i-format-the-current-date-for-the-users-locale
+                  https://stackoverflow.com/questions/4895697/nsdateformatter-datefromstring
+                  http://unicode.org/reports/tr35/tr35-4.html#Date_Format_Patterns
+     */
+
+    /* create a string that holds the date for this file */
+
+    fileDate =
+        [NSDate dateWithTimeIntervalSince1970:
+         archive_entry_mtime(entry)];
+
+    /*
+        if the date object is not nil, print out one table cell
+        corresponding to the date and another table cell corresponding
+        to the time, both in the local format; but if the date is nil,
+        use a default format
+     */
+
+    if (fileDate != nil) {
+
+        /*
+            Make sure the days and months are zero prefixed.
+            Based on:
+
+            https://nsdateformatter.com/
+            https://developer.apple.com/documentation/foundation/nsdateformatter/1417087-setlocalizeddateformatfromtempla?language=objc
+         */
+
+        [dateFormatter setLocale:
+            [NSLocale currentLocale]];
+
+        [dateFormatter
+            setLocalizedDateFormatFromTemplate: @"MM-dd-yyyy"];
+
+        [qlHtml appendFormat:
+            @"<td align=\"right\">%@</td>",
+            [dateFormatter stringFromDate: fileDate]];
+
+        [dateFormatter
+            setLocalizedDateFormatFromTemplate: @"HH:mm"];
+
+        [qlHtml appendFormat:
+            @"<td align=\"right\">%@</td>",
+            [dateFormatter stringFromDate: fileDate]];
+    } else {
+        [qlHtml appendFormat:
+            @"<td align=\"center\">&nbsp;</td>"];
+    }
+
+    /* close the row */
+
+    [qlHtml appendString:@"</tr>\n"];
+
+    return true;
+}
+
+/* recordArchiveEntry - write the structured record for an archive entry */
+
+static void recordArchiveEntry(struct archive_entry *entry,
+                               const char *fileName,
+                               bool isFolder,
+                               bool isRawFile,
+                               off_t fileSize,
+                               unsigned int depth)
+{
+    recEntry_t rec;
+
+    memset(&rec, 0, sizeof(recEntry_t));
+
+    rec.path = fileName;
+    rec.depth = depth;
+
+    if (isRawFile == true)
+    {
+        rec.type = RecTypeFile;
+    }
+    else if (isFolder == TRUE)
+    {
+        rec.type = RecTypeDir;
+    }
+    else if (archive_entry_filetype(entry) == AE_IFLNK)
+    {
+        rec.type = RecTypeLink;
+    }
+    else if (archive_entry_hardlink(entry) != NULL)
+    {
+        rec.type = RecTypeLink;
+        rec.link = archive_entry_hardlink(entry);
+    }
+    else if (archive_entry_filetype(entry) == AE_IFREG)
+    {
+        rec.type = RecTypeFile;
+    }
+    else
+    {
+        rec.type = RecTypeSpecial;
+    }
+
+    if (isFolder != TRUE &&
+        (isRawFile == true ?
+         fileSize >= 0 : archive_entry_size_is_set(entry)))
+    {
+        rec.size = fileSize;
+        rec.hasSize = 1;
+    }
+
+    if (archive_entry_mtime_is_set(entry))
+    {
+        rec.mtime = archive_entry_mtime(entry);
+        rec.hasMtime = 1;
+    }
+
+    rec.encrypted = (archive_entry_is_encrypted(entry) ? 1 : 0);
+
+    recWrite(&rec);
+}
+
+/*
+    formatCabFolderRows - add a row for each folder of a cabinet with
+                          more than one, with its compression, number
+                          of files and sizes, all from the cabinet's
+                          header tables (see cabinfo.h)
+ */
+
+static void formatCabFolderRows(NSMutableString *qlHtml,
+                                const char *cabFileName)
+{
+    cabInfo_t cabInfo;
+    cabFolder_t *folder = NULL;
+    fileSizeSpec_t fileSizeSpec;
+    uint32_t i = 0;
+
+    if (qlHtml == nil || cabFileName == NULL)
+    {
+        return;
+    }
+
+    if (cabInfoRead(cabFileName, &cabInfo) != gCabInfoOkay)
+    {
+        return;
+    }
+
+    if (cabInfo.numFolders < 2)
+    {
+        cabInfoFree(&cabInfo);
+        return;
+    }
+
+    for (i = 0; i < cabInfo.numFolders && i < gCabMaxFolderRows; i++)
+    {
+        folder = &cabInfo.folders[i];
+
+        [qlHtml appendString: @"<tr>\n"];
+
+        /* folder number, compression and number of files */
+
+        [qlHtml appendFormat:
+            @"<td align=\"center\" colspan=\"2\">Folder %u%s: %s, %u item%s</td>\n",
+            i + 1,
+            (folder->continued ? " (continued)" : ""),
+            cabInfoCompressName(folder->compression),
+            folder->files,
+            (folder->files != 1 ? "s" : "")];
+
+        [qlHtml appendString: @"<td align=\"right\" colspan=\"3\">"];
+
+        /*
+            the folder's uncompressed / compressed size, from its
+            CFDATA headers, or the size of its files if those are
+            incomplete
+         */
+
+        memset(&fileSizeSpec, 0, sizeof(fileSizeSpec_t));
+
+        if (folder->hasSizes)
+        {
+            getFileSizeSpec((off_t)folder->uncompressedSize, &fileSizeSpec);
+            [qlHtml appendFormat: @"%-.1f&nbsp;%-1s",
+                                  fileSizeSpec.size,
+                                  fileSizeSpec.spec];
+
+            memset(&fileSizeSpec, 0, sizeof(fileSizeSpec_t));
+
+            getFileSizeSpec((off_t)folder->compressedSize, &fileSizeSpec);
+            [qlHtml appendFormat: @" / %-.1f&nbsp;%-1s",
+                                  fileSizeSpec.size,
+                                  fileSizeSpec.spec];
+
+            if (folder->uncompressedSize > 0 && folder->compressedSize > 0)
+            {
+                [qlHtml appendFormat: @" (%3.0f%%)",
+                    getCompression((off_t)folder->uncompressedSize,
+                                   (off_t)folder->compressedSize)];
+            }
+        }
+        else
+        {
+            getFileSizeSpec((off_t)folder->filesSize, &fileSizeSpec);
+            [qlHtml appendFormat: @"%-.1f&nbsp;%-1s",
+                                  fileSizeSpec.size,
+                                  fileSizeSpec.spec];
+        }
+
+        [qlHtml appendString: @"</td>"];
+        [qlHtml appendString: @"<td><pre>&nbsp;</pre></td>\n"];
+        [qlHtml appendString: @"</tr>\n"];
+    }
+
+    if (cabInfo.numFolders > gCabMaxFolderRows)
+    {
+        [qlHtml appendFormat:
+            @"<tr><td align=\"center\" colspan=\"2\">%u more folders</td>"
+            @"<td colspan=\"4\"><pre>&nbsp;</pre></td></tr>\n",
+            cabInfo.numFolders - gCabMaxFolderRows];
+    }
+
+    cabInfoFree(&cabInfo);
+}
+
+/*
+    formatArSymbolRows - add a summary row for the symbol index of an
+                         ar archive and a row with the number of
+                         symbols each member defines, all from the
+                         archive's headers and symbol index (see
+                         arinfo.h)
+ */
+
+static void formatArSymbolRows(NSMutableString *qlHtml,
+                               const char *arFileName)
+{
+    arInfo_t arInfo;
+    arMember_t *member = NULL;
+    NSString *escapedStr = nil;
+    uint32_t i = 0;
+    uint32_t rows = 0;
+
+    if (qlHtml == nil || arFileName == NULL)
+    {
+        return;
+    }
+
+    if (arInfoRead(arFileName, ArInfoSymbolCounts, &arInfo) != gArInfoOkay)
+    {
+        return;
+    }
+
+    if (arInfo.hasSymbolIndex == 0)
+    {
+        arInfoFree(&arInfo);
+        return;
+    }
+
+    [qlHtml appendFormat:
+        @"<tr><td align=\"center\" colspan=\"2\">%s symbol index: "
+        @"%llu symbol%s in %u of %u member%s%s</td>"
+        @"<td colspan=\"4\"><pre>&nbsp;</pre></td></tr>\n",
+        arInfoFormatName(arInfo.format),
+        (unsigned long long)arInfo.numSymbols,
+        (arInfo.numSymbols != 1 ? "s" : ""),
+        arInfo.membersWithSymbols,
+        arInfo.numMembers,
+        (arInfo.numMembers != 1 ? "s" : ""),
+        (arInfo.truncated ? " (truncated)" : "")];
+
+    for (i = 0; i < arInfo.numMembers && rows < gArMaxSymbolRows; i++)
+    {
+        member = &arInfo.members[i];
+        if (member->symbols == 0)
+        {
+            continue;
+        }
+
+        escapedStr = [[NSString stringWithUTF8String: member->name]
+                                gtm_stringByEscapingForHTML];
+        if (escapedStr == nil)
+        {
+            escapedStr = (NSString *)gFileNameUnavilableStr;
+        }
+
+        [qlHtml appendString: @"<tr>\n"];
+        [qlHtml appendFormat:
+            @"<td align=\"center\" colspan=\"2\">%u symbol%s</td>\n",
+            member->symbols,
+            (member->symbols != 1 ? "s" : "")];
+        [qlHtml appendString: @"<td><div style=\"display: block; "];
+        [qlHtml appendFormat: @"word-wrap: break-word;\">%@</div></td>",
+                              escapedStr];
+        [qlHtml appendString: @"<td colspan=\"3\"><pre>&nbsp;</pre></td>\n"];
+        [qlHtml appendString: @"</tr>\n"];
+
+        rows++;
+    }
+
+    if (arInfo.membersWithSymbols > rows)
+    {
+        [qlHtml appendFormat:
+            @"<tr><td align=\"center\" colspan=\"2\">%u more members</td>"
+            @"<td colspan=\"4\"><pre>&nbsp;</pre></td></tr>\n",
+            arInfo.membersWithSymbols - rows];
+    }
+
+    arInfoFree(&arInfo);
+}
+
+/*
+    formatEncryptionBanner - add a banner with the number of encrypted
+                             entries, counted from the archive's central
+                             directory or headers (see summary.h), if
+                             there are any
+ */
+
+static void formatEncryptionBanner(NSMutableString *qlHtml,
+                                   const char *archiveFileName)
+{
+    summaryEncryption_t encryption;
+    uint64_t total = 0;
+
+    if (qlHtml == nil || archiveFileName == NULL)
+    {
+        return;
+    }
+
+    if (summaryReadEncryption(archiveFileName, &encryption) !=
+            gSummaryOkay)
+    {
+        return;
+    }
+
+    if (encryption.headersEncrypted)
+    {
+        [qlHtml appendFormat:
+            @"<p align=\"center\">%@ The list of entries is encrypted</p>\n",
+            gFileEncyrptedIcon];
+        return;
+    }
+
+    if (encryption.encryptedEntries == 0)
+    {
+        return;
+    }
+
+    total = encryption.encryptedEntries + encryption.plainEntries;
+
+    [qlHtml appendFormat:
+        @"<p align=\"center\">%@ %llu of %llu entr%s encrypted</p>\n",
+        gFileEncyrptedIcon,
+        (unsigned long long)encryption.encryptedEntries,
+        (unsigned long long)total,
+        (total != 1 ? "ies are" : "y is")];
+}
+
+/*
+    isPeekEntry - check if an entry is a text entry whose start is
+                  shown after the listing: one of gPeekEntryNames, no
+                  more than gPeekMaxDepth folders deep
+ */
+
+static bool isPeekEntry(const char *fileName)
+{
+    const char *baseName = NULL;
+    const char *p = NULL;
+    int depth = 0;
+    int i = 0;
+
+    if (fileName == NULL)
+    {
+        return false;
+    }
+
+    for (p = fileName; *p != '\0'; p++)
+    {
+        if (*p == '/' && p[1] != '\0')
+        {
+            baseName = p + 1;
+            depth++;
+        }
+    }
+
+    if (depth > gPeekMaxDepth)
+    {
+        return false;
+    }
+
+    if (baseName == NULL)
+    {
+        baseName = fileName;
+    }
+
+    for (i = 0; gPeekEntryNames[i] != NULL; i++)
+    {
+        if (strcasecmp(baseName, gPeekEntryNames[i]) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+    formatPeekEntries - show the first gPeekMaxBytes of each of the
+                        given text entries, each of which is found
+                        through the archive's directory and decoded on
+                        its own (see peek.h); entries that are not
+                        text are skipped
+ */
+
+static void formatPeekEntries(NSMutableString *qlHtml,
+                              const char *archiveFileName,
+                              NSArray *fileNames)
+{
+    peek_t peek;
+    const peekEntry_t *entry = NULL;
+    NSString *fileName = nil;
+    NSString *fileNameEscaped = nil;
+    NSString *text = nil;
+    char buf[gPeekMaxBytes];
+    ssize_t len = 0;
+    ssize_t trim = 0;
+
+    if (qlHtml == nil || archiveFileName == NULL || [fileNames count] == 0)
+    {
+        return;
+    }
+
+    if (peekOpen(archiveFileName, &peek) != gPeekOkay)
+    {
+        return;
+    }
+
+    for (fileName in fileNames)
+    {
+        entry = peekFind(&peek, [fileName UTF8String]);
+        if (entry == NULL)
+        {
+            continue;
+        }
+
+        len = peekRead(&peek, entry, buf, sizeof(buf));
+        if (len <= 0 || memchr(buf, '\0', (size_t)len) != NULL)
+        {
+            continue;
+        }
+
+        /* the last character might have been cut off */
+
+        text = nil;
+        for (trim = 0; trim < 4 && trim < len && text == nil; trim++)
+        {
+            text = [[NSString alloc] initWithBytes: buf
+                                            length: (NSUInteger)(len - trim)
+                                          encoding: NSUTF8StringEncoding];
+        }
+
+        if (text == nil)
+        {
+            continue;
+        }
+
+        fileNameEscaped = [fileName gtm_stringByEscapingForHTML];
+
+        [qlHtml appendFormat: @"<p>%@ %@</p>\n",
+                              gFileIcon,
+                              fileNameEscaped];
+        [qlHtml appendFormat: @"<pre>%@%s</pre>\n",
+                              [text gtm_stringByEscapingForHTML],
+                              ((uint64_t)len < entry->size ?
+                               "\n&hellip;" : "")];
+    }
+
+    peekClose(&peek);
+}
+
+/*
+    writeWarcIndex - write a CDX index of the records of a WARC file,
+                     with the offset and length of each, to
+                     <indexDir>/<file name>.cdx (see warcindex.h)
+ */
+
+static void writeWarcIndex(const char *warcFileName,
+                           const char *indexDir)
+{
+    warcIndex_t warcIndex;
+    const char *baseName = NULL;
+    char indexPath[PATH_MAX];
+    int fd = -1;
+
+    if (warcFileName == NULL || indexDir == NULL || indexDir[0] == '\0')
+    {
+        return;
+    }
+
+    baseName = strrchr(warcFileName, '/');
+    baseName = (baseName != NULL ? baseName + 1 : warcFileName);
+
+    if (snprintf(indexPath,
+                 sizeof(indexPath),
+                 "%s/%s.cdx",
+                 indexDir,
+                 baseName) >= (int)sizeof(indexPath))
+    {
+        return;
+    }
+
+    if (warcIndexRead(warcFileName, &warcIndex) != gWarcIndexOkay)
+    {
+        fprintf(stderr,
+                "qlZipInfo: ERROR: can't index '%s'\n",
+                warcFileName);
+        return;
+    }
+
+    fd = open(indexPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        fprintf(stderr,
+                "qlZipInfo: ERROR: can't create '%s': %s\n",
+                indexPath,
+                strerror(errno));
+        warcIndexFree(&warcIndex);
+        return;
+    }
+
+    if (warcIndexWriteCdx(&warcIndex, warcFileName, fd) != gWarcIndexOkay)
+    {
+        fprintf(stderr,
+                "qlZipInfo: ERROR: can't write '%s'\n",
+                indexPath);
+    }
+
+    close(fd);
+    warcIndexFree(&warcIndex);
+}
+
+/*
+    listNestedArchive - if the parent's current entry is an archive,
+                        list its entries, and the entries of any
+                        archives in it, as indented rows under the
+                        container's row
+ */
+
+static void listNestedArchive(NSMutableString *qlHtml,
+                              QLPreviewRequestRef preview,
+                              struct archive *parent,
+                              struct archive_entry *container,
+                              unsigned int depth,
+                              nestedLimits_t *limits,
+                              NSDateFormatter *dateFormatter)
+{
+    nestedArchive_t nested;
+    struct archive *child = NULL;
+    struct archive_entry *entry = NULL;
+    const char *fileName = NULL;
+    bool isFolder = FALSE;
+    off_t fileSize = 0;
+    uint64_t traceRowStartTime = 0;
+    int r = 0;
+
+    /*
+        skip entries that can't be listed (nestedCheck() skips the ones
+        that are too big)
+    */
+
+    if (depth > gNestedMaxDepth ||
+        archive_entry_filetype(container) != AE_IFREG ||
+        archive_entry_is_encrypted(container) ||
+        nestedIsExpired(limits->deadline))
+    {
+        return;
+    }
+
+    if (nestedCheck(&nested, parent, container, limits) != gNestedOkay)
+    {
+        nestedClose(&nested);
+        return;
+    }
+
+    child = newArchiveReader();
+    if (child == NULL)
+    {
+        nestedClose(&nested);
+        return;
+    }
+
+    if (nestedOpen(&nested, child) != gNestedOkay)
+    {
+        fprintf(stderr,
+                "qlZipInfo: WARN: nested: %s\n",
+                archive_error_string(child));
+        nestedClose(&nested);
+        archive_read_free(child);
+        return;
+    }
+
+    for (;;)
+    {
+        r = archive_read_next_header(child, &entry);
+        if (r == ARCHIVE_EOF)
+        {
+            break;
+        }
+
+        /*
+            the container is listed as far as it can be, but an error
+            in it is not an error in the archive being previewed
+         */
+
+        if (r == ARCHIVE_WARN)
+        {
+            fprintf(stderr,
+                    "qlZipInfo: WARN: nested: %s\n",
+                    archive_error_string(child));
+        }
+        else if (r != ARCHIVE_OK)
+        {
+            fprintf(stderr,
+                    "qlZipInfo: WARN: nested: %s\n",
+                    archive_error_string(child));
+            break;
+        }
+
+        if (isPreviewCancelled(preview) ||
+            nestedIsExpired(limits->deadline))
+        {
+            break;
+        }
+
+        if (traceIsEnabled())
+        {
+            traceRowStartTime = traceNow();
+        }
+
+        fileName = archive_entry_pathname(entry);
+        if (fileName == NULL)
+        {
+            fileName = archive_entry_pathname_utf8(entry);
+        }
+
+        if (fileName == NULL)
+        {
+            fileName = gFileNameUnavilable;
+        }
+
+        isFolder =
+            (archive_entry_filetype(entry) == AE_IFDIR ? TRUE : FALSE);
+        fileSize = (isFolder == TRUE ? 0 : archive_entry_size(entry));
+
+        formatEntryRow(qlHtml,
+                       entry,
+                       fileName,
+                       isFolder,
+                       false,
+                       fileSize,
+                       depth,
+                       dateFormatter);
+
+        if (traceIsEnabled())
+        {
+            traceEnd(TracePhaseHTML, traceRowStartTime);
+            traceCount(TraceCounterRowsRendered, 1);
+        }
+
+        if (recIsEnabled())
+        {
+            recordArchiveEntry(entry,
+                               fileName,
+                               isFolder,
+                               false,
+                               fileSize,
+                               depth);
+        }
+
+        listNestedArchive(qlHtml,
+                          preview,
+                          child,
+                          entry,
+                          depth + 1,
+                          limits,
+                          dateFormatter);
+    }
+
+    nestedClose(&nested);
+    archive_read_free(child);
+}
+
 /* formatOutputHeader - format the output header */
 
 static bool formatOutputHeader(NSMutableString *qlHtml)
@@ -1615,60 +2670,6 @@ static bool endOutputBody(NSMutableString *qlHtml)
     return true;
 }
 
-/*  getGZExpandedFileSize - get a gzip'ed file's expanded file size */
-
-static off_t getGZExpandedFileSize(const char *zipFileNameStr)
-{
-    FILE *gzFile = NULL;
-    UInt8 gzCompressedSize[4];
-    off_t gzExpandedFileSize = 0;
-
-    if (zipFileNameStr == NULL)
-    {
-        return gzExpandedFileSize;
-    }
-
-    /* open the file for reading */
-
-    gzFile = fopen(zipFileNameStr, "r");
-    if (gzFile == NULL)
-    {
-        return gzExpandedFileSize;
-    }
-
-    memset(gzCompressedSize, 0, 4);
-
-    /* go to last 4 bytes of the file */
-
-    if (fseek(gzFile, -4, SEEK_END) != 0)
-    {
-        fclose(gzFile);
-        return gzExpandedFileSize;
-    }
-
-    /*
-        read the last 4 bytes and convert them to the uncompressed
-        file size (which might be wrong for files greater than 4GB),
-        see:
-
-        http://www.abeel.be/content/determine-uncompressed-size-gzip-file
-        https://stackoverflow.com/questions/9209138/uncompressed-file-size-using-zlibs-gzip-file-access-function
-     */
-
-    if (fread(gzCompressedSize, 1 , 4, gzFile) == 4)
-    {
-        gzExpandedFileSize =
-            (gzCompressedSize[3] << 24) |
-            (gzCompressedSize[2] << 16) |
-            (gzCompressedSize[1] <<  8) +
-            gzCompressedSize[0];
-    }
-
-    fclose(gzFile);
-
-    return gzExpandedFileSize;
-}
-
 /* getFileSizeSpec - return a string corresponding to the size of the file */
 
 static int getFileSizeSpec(off_t fileSizeInBytes,
@@ -1,21 +1,199 @@
-#include <CoreFoundation/CoreFoundation.h>
-#include <CoreServices/CoreServices.h>
-#include <QuickLook/QuickLook.h>
+/*
+    GenerateThumbnailForURL.m - thumbnail generation for archives
 
-OSStatus GenerateThumbnailForURL(void *thisInterface, QLThumbnailRequestRef thumbnail, CFURLRef url, CFStringRef contentTypeUTI, CFDictionaryRef options, CGSize maxSize);
-void CancelThumbnailGeneration(void *thisInterface, QLThumbnailRequestRef thumbnail);
+    History:
 
-/* -----------------------------------------------------------------------------
-    Generate a thumbnail for file
+    v. 0.1.0 (10/17/2026) - Initial Release
 
-   This function's job is to create thumbnail for designated file as fast as possible
-   ----------------------------------------------------------------------------- */
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
 
-OSStatus GenerateThumbnailForURL(void *thisInterface, QLThumbnailRequestRef thumbnail, CFURLRef url, CFStringRef contentTypeUTI, CFDictionaryRef options, CGSize maxSize)
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#import <CoreFoundation/CoreFoundation.h>
+#import <CoreServices/CoreServices.h>
+#import <QuickLook/QuickLook.h>
+
+#import <stdio.h>
+#import <stdlib.h>
+#import <sys/syslimits.h>
+
+#import "summary.h"
+#import "thumbnail.h"
+#import "cover.h"
+
+/* prototypes */
+
+OSStatus GenerateThumbnailForURL(void *thisInterface,
+                                 QLThumbnailRequestRef thumbnail,
+                                 CFURLRef url,
+                                 CFStringRef contentTypeUTI,
+                                 CFDictionaryRef options,
+                                 CGSize maxSize);
+void CancelThumbnailGeneration(void *thisInterface,
+                               QLThumbnailRequestRef thumbnail);
+
+/* public functions */
+
+/*
+    GenerateThumbnailForURL - generate an archive's thumbnail, which
+                              only uses what can be read in constant
+                              time (see summary.h), so that it is
+                              fast enough for every file in a folder.
+                              Comic books and ePubs show their cover,
+                              found through the zip's directory and
+                              read on its own (see cover.h).  If the
+                              file can't be read, no thumbnail is set
+                              and the Finder shows the icon.
+*/
+
+OSStatus GenerateThumbnailForURL(void *thisInterface,
+                                 QLThumbnailRequestRef thumbnail,
+                                 CFURLRef url,
+                                 CFStringRef contentTypeUTI,
+                                 CFDictionaryRef options,
+                                 CGSize maxSize)
 {
+    char fileName[PATH_MAX];
+    summary_t summary;
+    cover_t cover;
+    CFDataRef coverData = NULL;
+    thumbImage_t image;
+    CGColorSpaceRef colorSpace = NULL;
+    CGContextRef context = NULL;
+    CGImageRef thumbImage = NULL;
+    CGFloat size = 0;
+
+    if (url == NULL)
+    {
+        fprintf(stderr, "qlZipInfo: ERROR: url is null\n");
+        return noErr;
+    }
+
+    if (CFURLGetFileSystemRepresentation(url,
+                                         true,
+                                         (UInt8 *)fileName,
+                                         sizeof(fileName)) != true)
+    {
+        fprintf(stderr, "qlZipInfo: ERROR: can't get filename\n");
+        return noErr;
+    }
+
+    /*
+        a comic book's or ePub's cover is handed to ImageIO as it is
+        stored, which scales it to the thumbnail
+    */
+
+    if (coverRead(fileName, &cover) == gCoverOkay)
+    {
+        coverData = CFDataCreate(kCFAllocatorDefault,
+                                 cover.data,
+                                 (CFIndex)cover.len);
+        coverFree(&cover);
+        if (coverData != NULL)
+        {
+            if (!QLThumbnailRequestIsCancelled(thumbnail))
+            {
+                QLThumbnailRequestSetImageWithData(thumbnail,
+                                                   coverData,
+                                                   NULL);
+            }
+            CFRelease(coverData);
+            return noErr;
+        }
+    }
+
+    if (summaryRead(fileName, &summary) != gSummaryOkay &&
+        summary.format == SummaryFormatUnknown)
+    {
+        return noErr;
+    }
+
+    /*  exit if the user canceled the thumbnail */
+
+    if (QLThumbnailRequestIsCancelled(thumbnail))
+    {
+        return noErr;
+    }
+
+    /* draw a square thumbnail that fits in maxSize */
+
+    size = (maxSize.width < maxSize.height ? maxSize.width : maxSize.height);
+    if (size < THUMBMINSIZE)
+    {
+        return noErr;
+    }
+    if (size > THUMBMAXSIZE)
+    {
+        size = THUMBMAXSIZE;
+    }
+
+    image.width = (size_t)size;
+    image.height = (size_t)size;
+    image.bytesPerRow = image.width * 4;
+    image.pixels = malloc(image.bytesPerRow * image.height);
+    if (image.pixels == NULL)
+    {
+        return noErr;
+    }
+
+    if (thumbRender(&summary, &image) != gThumbOkay)
+    {
+        free(image.pixels);
+        return noErr;
+    }
+
+    colorSpace = CGColorSpaceCreateWithName(kCGColorSpaceSRGB);
+    if (colorSpace != NULL)
+    {
+        context = CGBitmapContextCreate(image.pixels,
+                                        image.width,
+                                        image.height,
+                                        8,
+                                        image.bytesPerRow,
+                                        colorSpace,
+                                        kCGImageAlphaPremultipliedLast |
+                                        kCGBitmapByteOrder32Big);
+        CGColorSpaceRelease(colorSpace);
+    }
+
+    if (context != NULL)
+    {
+        thumbImage = CGBitmapContextCreateImage(context);
+        CGContextRelease(context);
+    }
+
+    if (thumbImage != NULL)
+    {
+        QLThumbnailRequestSetImage(thumbnail, thumbImage, NULL);
+        CGImageRelease(thumbImage);
+    }
+
+    free(image.pixels);
+
     return noErr;
 }
 
-void CancelThumbnailGeneration(void *thisInterface, QLThumbnailRequestRef thumbnail)
+/* CancelThumbnailGeneration - handle a thumbnail being canceled */
+
+void CancelThumbnailGeneration(void *thisInterface,
+                               QLThumbnailRequestRef thumbnail)
 {
 }
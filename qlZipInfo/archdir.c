@@ -0,0 +1,1335 @@
+/*
+    archdir.c - read the directories of zip and 7z archives
+
+    History:
+
+    v. 0.1.0 (10/18/2026) - initial release
+
+    Based on:
+
+    APPNOTE.TXT - .ZIP File Format Specification, sections 4.3.12 -
+    4.3.16 and 4.5.3
+    https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+
+    7zFormat.txt - 7z Format description
+    https://github.com/ip7z/7zip/blob/main/DOC/7zFormat.txt
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <lzma.h>
+
+#include "archdir.h"
+
+/* zip signatures and record sizes */
+
+#define ZIPEOCDSIG       "PK\005\006"
+#define ZIPEOCDLEN       22
+#define ZIP64LOCATORSIG  "PK\006\007"
+#define ZIP64LOCATORLEN  20
+#define ZIP64EOCDSIG     "PK\006\006"
+#define ZIP64EOCDLEN     56
+#define ZIPCDSIG         "PK\001\002"
+#define ZIP64EXTRAID     0x0001
+
+/* 7z property ids */
+
+#define SZMAXSTREAMS     32
+
+enum
+{
+    gSzEnd                = 0x00,
+    gSzHeader             = 0x01,
+    gSzArchiveProperties  = 0x02,
+    gSzAdditionalStreams  = 0x03,
+    gSzMainStreamsInfo    = 0x04,
+    gSzFilesInfo          = 0x05,
+    gSzPackInfo           = 0x06,
+    gSzUnpackInfo         = 0x07,
+    gSzSubStreamsInfo     = 0x08,
+    gSzSize               = 0x09,
+    gSzCRC                = 0x0A,
+    gSzFolder             = 0x0B,
+    gSzCodersUnpackSize   = 0x0C,
+    gSzNumUnpackStream    = 0x0D,
+    gSzEncodedHeader      = 0x17,
+};
+
+/* private functions */
+
+static void archDir7zDigests(archDirCursor_t *c,
+                             uint64_t count,
+                             archDir7z_t *s,
+                             int folders);
+static void archDir7zFolder(archDirCursor_t *c,
+                            archDir7zFolder_t *folder,
+                            uint64_t *totalOut,
+                            uint64_t *mainOut);
+static void archDir7zPackInfo(archDirCursor_t *c, archDir7z_t *s);
+static void archDir7zUnpackInfo(archDirCursor_t *c, archDir7z_t *s);
+static void archDir7zSubStreamsInfo(archDirCursor_t *c, archDir7z_t *s);
+static void archDir7zStreamsInfo(archDirCursor_t *c, archDir7z_t *s);
+static void archDir7zFreeStreams(archDir7z_t *s);
+static unsigned char *archDir7zDecode(int fd,
+                                      const archDir7z_t *s,
+                                      uint64_t maxHeader);
+
+/*
+    archDir7zDigests - skip count CRCs; for the folders' CRCs, note
+                       which folders have one
+*/
+
+static void archDir7zDigests(archDirCursor_t *c,
+                             uint64_t count,
+                             archDir7z_t *s,
+                             int folders)
+{
+    uint64_t numDefined = 0;
+    uint64_t i = 0;
+    unsigned int allDefined = 0;
+    unsigned int bits = 0;
+
+    if (count > (uint64_t)(c->end - c->p) * 8)
+    {
+        c->err = 1;
+        return;
+    }
+
+    allDefined = archDirGetByte(c);
+
+    for (i = 0; i < count && !c->err; i++)
+    {
+        if (allDefined == 0 && (i & 7) == 0)
+        {
+            bits = archDirGetByte(c);
+        }
+        if (allDefined != 0 || (bits & (0x80 >> (i & 7))) != 0)
+        {
+            numDefined++;
+            if (folders && i < s->numFolders)
+            {
+                s->folders[i].hasCRC = 1;
+            }
+        }
+    }
+
+    if (numDefined > (uint64_t)(c->end - c->p) / 4)
+    {
+        c->err = 1;
+        return;
+    }
+
+    archDirSkip(c, numDefined * 4);
+}
+
+/*
+    archDir7zFolder - parse a folder's coders, and get its number of
+                      output streams and which one is the folder's
+                      output (the one that isn't bound to a coder's
+                      input).  A folder is simple if it has one coder,
+                      with one input and one output, and encrypted if
+                      any of its coders is AES.
+*/
+
+static void archDir7zFolder(archDirCursor_t *c,
+                            archDir7zFolder_t *folder,
+                            uint64_t *totalOut,
+                            uint64_t *mainOut)
+{
+    const unsigned char *props = NULL;
+    uint64_t numCoders = 0, numIn = 0, numOut = 0, totalIn = 0;
+    uint64_t numBindPairs = 0, propsLen = 0;
+    uint64_t i = 0, j = 0, outIndex = 0;
+    uint32_t bound = 0;
+    uint32_t id = 0;
+    unsigned int flag = 0;
+
+    *totalOut = 0;
+    *mainOut = 0;
+
+    numCoders = archDirGetNumber(c);
+    if (numCoders == 0 || numCoders > SZMAXSTREAMS)
+    {
+        c->err = 1;
+        return;
+    }
+
+    for (i = 0; i < numCoders && !c->err; i++)
+    {
+        flag = archDirGetByte(c);
+        if ((flag & 0xC0) != 0)
+        {
+            c->err = 1;
+            return;
+        }
+
+        id = 0;
+        for (j = 0; j < (flag & 0x0F); j++)
+        {
+            id = (id << 8) | archDirGetByte(c);
+        }
+
+        numIn = 1;
+        numOut = 1;
+        if (flag & 0x10)
+        {
+            numIn = archDirGetNumber(c);
+            numOut = archDirGetNumber(c);
+        }
+
+        props = NULL;
+        propsLen = 0;
+        if (flag & 0x20)
+        {
+            propsLen = archDirGetNumber(c);
+            props = c->p;
+            archDirSkip(c, propsLen);
+        }
+
+        if (folder != NULL)
+        {
+            if (id == gArchDir7zCoderAES)
+            {
+                folder->encrypted = 1;
+            }
+            if (i == 0)
+            {
+                folder->numCoders = numCoders;
+                folder->coderId = id;
+                folder->props = props;
+                folder->propsLen = propsLen;
+                folder->simple = (numCoders == 1 &&
+                                  numIn == 1 &&
+                                  numOut == 1);
+            }
+        }
+
+        totalIn += numIn;
+        *totalOut += numOut;
+        if (totalIn > SZMAXSTREAMS || *totalOut > SZMAXSTREAMS)
+        {
+            c->err = 1;
+            return;
+        }
+    }
+
+    if (c->err || *totalOut == 0)
+    {
+        c->err = 1;
+        return;
+    }
+
+    numBindPairs = *totalOut - 1;
+    for (i = 0; i < numBindPairs; i++)
+    {
+        archDirGetNumber(c);
+        outIndex = archDirGetNumber(c);
+        if (outIndex < SZMAXSTREAMS)
+        {
+            bound |= (1U << outIndex);
+        }
+    }
+
+    if (totalIn < numBindPairs)
+    {
+        c->err = 1;
+        return;
+    }
+
+    if (folder != NULL)
+    {
+        folder->numPacked = totalIn - numBindPairs;
+    }
+    if (totalIn - numBindPairs > 1)
+    {
+        for (i = 0; i < totalIn - numBindPairs; i++)
+        {
+            archDirGetNumber(c);
+        }
+    }
+
+    for (i = 0; i < *totalOut; i++)
+    {
+        if ((bound & (1U << i)) == 0)
+        {
+            *mainOut = i;
+            break;
+        }
+    }
+}
+
+/* archDir7zPackInfo - parse a PackInfo, keeping the packed sizes */
+
+static void archDir7zPackInfo(archDirCursor_t *c, archDir7z_t *s)
+{
+    uint64_t i = 0;
+    unsigned int id = 0;
+
+    s->packPos = archDirGetNumber(c);
+    s->numPackStreams = archDirGetNumber(c);
+    if (s->numPackStreams > (uint64_t)(c->end - c->p) ||
+        s->packSizes != NULL)
+    {
+        c->err = 1;
+        return;
+    }
+
+    s->packSizes = calloc((size_t)s->numPackStreams + 1, sizeof(uint64_t));
+    if (s->packSizes == NULL)
+    {
+        c->err = 1;
+        return;
+    }
+
+    while (!c->err)
+    {
+        id = archDirGetByte(c);
+        if (id == gSzEnd)
+        {
+            break;
+        }
+
+        if (id == gSzSize)
+        {
+            for (i = 0; i < s->numPackStreams && !c->err; i++)
+            {
+                s->packSizes[i] = archDirGetNumber(c);
+            }
+        }
+        else if (id == gSzCRC)
+        {
+            archDir7zDigests(c, s->numPackStreams, s, 0);
+        }
+        else
+        {
+            c->err = 1;
+        }
+    }
+}
+
+/*
+    archDir7zUnpackInfo - parse an UnpackInfo, keeping each folder's
+                          coder, packed streams and unpacked size
+*/
+
+static void archDir7zUnpackInfo(archDirCursor_t *c, archDir7z_t *s)
+{
+    archDirCursor_t folders;
+    uint64_t totalOut = 0, mainOut = 0, size = 0;
+    uint64_t packIndex = 0;
+    uint64_t i = 0, j = 0;
+    unsigned int id = 0;
+
+    if (archDirGetByte(c) != gSzFolder)
+    {
+        c->err = 1;
+        return;
+    }
+
+    s->numFolders = archDirGetNumber(c);
+    if (s->numFolders > (uint64_t)(c->end - c->p) ||
+        archDirGetByte(c) != 0 ||
+        s->folders != NULL)
+    {
+        /* folders in an additional stream aren't supported */
+
+        c->err = 1;
+        return;
+    }
+
+    s->folders = calloc((size_t)s->numFolders + 1,
+                        sizeof(archDir7zFolder_t));
+    if (s->folders == NULL)
+    {
+        c->err = 1;
+        return;
+    }
+
+    folders = *c;
+
+    for (i = 0; i < s->numFolders && !c->err; i++)
+    {
+        archDir7zFolder(c, &s->folders[i], &totalOut, &mainOut);
+        s->folders[i].packIndex = packIndex;
+        s->folders[i].numSubstreams = 1;
+        packIndex += s->folders[i].numPacked;
+    }
+
+    if (archDirGetByte(c) != gSzCodersUnpackSize)
+    {
+        c->err = 1;
+        return;
+    }
+
+    /* the sizes of each folder's outputs follow all of the folders */
+
+    for (i = 0; i < s->numFolders && !c->err; i++)
+    {
+        archDir7zFolder(&folders, NULL, &totalOut, &mainOut);
+        for (j = 0; j < totalOut; j++)
+        {
+            size = archDirGetNumber(c);
+            if (j == mainOut)
+            {
+                s->folders[i].unpackSize = size;
+            }
+        }
+    }
+
+    while (!c->err)
+    {
+        id = archDirGetByte(c);
+        if (id == gSzEnd)
+        {
+            break;
+        }
+
+        if (id == gSzCRC)
+        {
+            archDir7zDigests(c, s->numFolders, s, 1);
+        }
+        else
+        {
+            c->err = 1;
+        }
+    }
+}
+
+/*
+    archDir7zSubStreamsInfo - parse a SubStreamsInfo, for the number
+                              of files in each folder and their sizes
+*/
+
+static void archDir7zSubStreamsInfo(archDirCursor_t *c, archDir7z_t *s)
+{
+    uint64_t numStreams = 0, numDigests = 0, sum = 0, size = 0;
+    uint64_t i = 0, j = 0, k = 0;
+    unsigned int id = 0;
+    int hasSizes = 0;
+
+    if (s->sizes != NULL || s->folders == NULL)
+    {
+        c->err = 1;
+        return;
+    }
+
+    id = archDirGetByte(c);
+
+    if (id == gSzNumUnpackStream)
+    {
+        for (i = 0; i < s->numFolders && !c->err; i++)
+        {
+            s->folders[i].numSubstreams = archDirGetNumber(c);
+            if (s->folders[i].numSubstreams > (uint64_t)(c->end - c->p) ||
+                s->folders[i].numSubstreams > ARCHDIR7ZMAXSTREAMS)
+            {
+                c->err = 1;
+            }
+        }
+        id = archDirGetByte(c);
+    }
+
+    for (i = 0; i < s->numFolders; i++)
+    {
+        numStreams += s->folders[i].numSubstreams;
+    }
+
+    if (c->err || numStreams > ARCHDIR7ZMAXSTREAMS)
+    {
+        c->err = 1;
+        return;
+    }
+
+    s->sizes = calloc((size_t)numStreams + 1, sizeof(uint64_t));
+    if (s->sizes == NULL)
+    {
+        c->err = 1;
+        return;
+    }
+    s->numSizes = numStreams;
+
+    /* the last file's size in a folder is what is left of it */
+
+    hasSizes = (id == gSzSize);
+    for (i = 0, k = 0; i < s->numFolders && !c->err; i++)
+    {
+        if (s->folders[i].numSubstreams == 0)
+        {
+            continue;
+        }
+
+        sum = 0;
+        for (j = 1; j < s->folders[i].numSubstreams && hasSizes; j++)
+        {
+            size = archDirGetNumber(c);
+            s->sizes[k++] = size;
+            sum += size;
+        }
+        if (sum > s->folders[i].unpackSize)
+        {
+            c->err = 1;
+            return;
+        }
+        s->sizes[k++] = s->folders[i].unpackSize - sum;
+    }
+
+    if (hasSizes)
+    {
+        id = archDirGetByte(c);
+    }
+
+    while (!c->err && id != gSzEnd)
+    {
+        if (id == gSzCRC)
+        {
+            /*
+                folders with one substream and a CRC don't repeat the
+                CRC here
+            */
+
+            numDigests = 0;
+            for (i = 0; i < s->numFolders; i++)
+            {
+                if (s->folders[i].numSubstreams != 1 ||
+                    s->folders[i].hasCRC == 0)
+                {
+                    numDigests += s->folders[i].numSubstreams;
+                }
+            }
+            archDir7zDigests(c, numDigests, s, 0);
+        }
+        else
+        {
+            c->err = 1;
+        }
+
+        id = archDirGetByte(c);
+    }
+}
+
+/* archDir7zStreamsInfo - parse a StreamsInfo */
+
+static void archDir7zStreamsInfo(archDirCursor_t *c, archDir7z_t *s)
+{
+    uint64_t i = 0;
+    unsigned int id = 0;
+
+    while (!c->err)
+    {
+        id = archDirGetByte(c);
+        if (id == gSzEnd)
+        {
+            break;
+        }
+
+        switch (id)
+        {
+            case gSzPackInfo:
+                archDir7zPackInfo(c, s);
+                break;
+            case gSzUnpackInfo:
+                archDir7zUnpackInfo(c, s);
+                break;
+            case gSzSubStreamsInfo:
+                archDir7zSubStreamsInfo(c, s);
+                break;
+            default:
+                c->err = 1;
+                break;
+        }
+    }
+
+    /* without a SubStreamsInfo, each folder is one file */
+
+    if (!c->err && s->sizes == NULL && s->folders != NULL)
+    {
+        s->sizes = calloc((size_t)s->numFolders + 1, sizeof(uint64_t));
+        if (s->sizes == NULL)
+        {
+            c->err = 1;
+            return;
+        }
+        for (i = 0; i < s->numFolders; i++)
+        {
+            s->sizes[i] = s->folders[i].unpackSize;
+        }
+        s->numSizes = s->numFolders;
+    }
+
+    for (i = 0; !c->err && i < s->numFolders; i++)
+    {
+        if (s->folders[i].packIndex + s->folders[i].numPacked >
+            s->numPackStreams)
+        {
+            c->err = 1;
+        }
+    }
+}
+
+/* archDir7zFreeStreams - release what was parsed from a StreamsInfo */
+
+static void archDir7zFreeStreams(archDir7z_t *s)
+{
+    free(s->packSizes);
+    free(s->folders);
+    free(s->sizes);
+    s->packPos = 0;
+    s->numPackStreams = 0;
+    s->packSizes = NULL;
+    s->numFolders = 0;
+    s->folders = NULL;
+    s->numSizes = 0;
+    s->sizes = NULL;
+}
+
+/*
+    archDir7zDecode - read and decode an encoded header that is one
+                      folder with one copy, LZMA or LZMA2 coder, and
+                      no larger than maxHeader, returns the decoded
+                      header, which must be freed, or NULL
+*/
+
+static unsigned char *archDir7zDecode(int fd,
+                                      const archDir7z_t *s,
+                                      uint64_t maxHeader)
+{
+    lzma_stream strm = LZMA_STREAM_INIT;
+    lzma_filter filters[2];
+    const archDir7zFolder_t *folder = NULL;
+    unsigned char *packed = NULL;
+    unsigned char *header = NULL;
+    uint64_t packSize = 0;
+    lzma_ret ret = LZMA_OK;
+
+    if (s->numFolders != 1 || s->numPackStreams < 1)
+    {
+        return NULL;
+    }
+
+    folder = &s->folders[0];
+    packSize = s->packSizes[0];
+
+    if (!folder->simple ||
+        folder->numPacked != 1 ||
+        packSize == 0 ||
+        packSize > maxHeader ||
+        folder->unpackSize == 0 ||
+        folder->unpackSize > maxHeader ||
+        (folder->coderId != gArchDir7zCoderLZMA &&
+         folder->coderId != gArchDir7zCoderLZMA2 &&
+         folder->coderId != gArchDir7zCoderCopy))
+    {
+        return NULL;
+    }
+
+    packed = malloc((size_t)packSize);
+    if (packed == NULL)
+    {
+        return NULL;
+    }
+
+    if (archDirReadAt(fd,
+                      packed,
+                      (size_t)packSize,
+                      (off_t)(ARCHDIR7ZSTARTHEADERLEN + s->packPos)) !=
+            (ssize_t)packSize)
+    {
+        free(packed);
+        return NULL;
+    }
+
+    if (folder->coderId == gArchDir7zCoderCopy)
+    {
+        if (packSize != folder->unpackSize)
+        {
+            free(packed);
+            return NULL;
+        }
+        return packed;
+    }
+
+    header = malloc((size_t)folder->unpackSize);
+    if (header == NULL)
+    {
+        free(packed);
+        return NULL;
+    }
+
+    memset(filters, 0, sizeof(filters));
+    filters[0].id = (folder->coderId == gArchDir7zCoderLZMA ?
+                     LZMA_FILTER_LZMA1 : LZMA_FILTER_LZMA2);
+    filters[1].id = LZMA_VLI_UNKNOWN;
+
+    if (lzma_properties_decode(&filters[0],
+                               NULL,
+                               folder->props,
+                               (size_t)folder->propsLen) != LZMA_OK)
+    {
+        free(packed);
+        free(header);
+        return NULL;
+    }
+
+    ret = lzma_raw_decoder(&strm, filters);
+    free(filters[0].options);
+    if (ret != LZMA_OK)
+    {
+        free(packed);
+        free(header);
+        return NULL;
+    }
+
+    strm.next_in = packed;
+    strm.avail_in = (size_t)packSize;
+    strm.next_out = header;
+    strm.avail_out = (size_t)folder->unpackSize;
+
+    ret = lzma_code(&strm, LZMA_FINISH);
+    lzma_end(&strm);
+    free(packed);
+
+    /* LZMA streams in 7z archives don't need an end marker */
+
+    if ((ret != LZMA_OK && ret != LZMA_STREAM_END) ||
+        strm.avail_out != 0)
+    {
+        free(header);
+        return NULL;
+    }
+
+    return header;
+}
+
+/* public functions */
+
+/* archDirGet16 - get a little endian 16 bit value */
+
+uint16_t archDirGet16(const unsigned char *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/* archDirGet32 - get a little endian 32 bit value */
+
+uint32_t archDirGet32(const unsigned char *p)
+{
+    return (uint32_t)p[0] |
+           ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+/* archDirGet64 - get a little endian 64 bit value */
+
+uint64_t archDirGet64(const unsigned char *p)
+{
+    return (uint64_t)archDirGet32(p) |
+           ((uint64_t)archDirGet32(p + 4) << 32);
+}
+
+/* archDirGetBE16 - get a big endian 16 bit value */
+
+uint16_t archDirGetBE16(const unsigned char *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/* archDirGetBE32 - get a big endian 32 bit value */
+
+uint32_t archDirGetBE32(const unsigned char *p)
+{
+    return ((uint32_t)p[0] << 24) |
+           ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) |
+           (uint32_t)p[3];
+}
+
+/* archDirGetBE64 - get a big endian 64 bit value */
+
+uint64_t archDirGetBE64(const unsigned char *p)
+{
+    return ((uint64_t)archDirGetBE32(p) << 32) |
+           (uint64_t)archDirGetBE32(p + 4);
+}
+
+/*
+    archDirReadAt - read up to len bytes at offset, returns the number
+                    of bytes read or -1 on error
+*/
+
+ssize_t archDirReadAt(int fd, void *buf, size_t len, off_t offset)
+{
+    size_t total = 0;
+    ssize_t bytesRead = 0;
+
+    while (total < len)
+    {
+        bytesRead = pread(fd,
+                          (unsigned char *)buf + total,
+                          len - total,
+                          offset + (off_t)total);
+        if (bytesRead < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        if (bytesRead == 0)
+        {
+            break;
+        }
+        total += (size_t)bytesRead;
+    }
+
+    return (ssize_t)total;
+}
+
+/* archDirGetByte - get the next byte at a cursor */
+
+unsigned int archDirGetByte(archDirCursor_t *c)
+{
+    if (c->err || c->p >= c->end)
+    {
+        c->err = 1;
+        return 0;
+    }
+
+    return *c->p++;
+}
+
+/*
+    archDirGetNumber - get a 7z NUMBER, where the number of leading 1
+                       bits in the first byte is the number of bytes
+                       that follow it
+*/
+
+uint64_t archDirGetNumber(archDirCursor_t *c)
+{
+    unsigned int first = archDirGetByte(c);
+    unsigned int mask = 0x80;
+    uint64_t value = 0;
+    int i = 0;
+
+    for (i = 0; i < 8; i++)
+    {
+        if ((first & mask) == 0)
+        {
+            value |= (uint64_t)(first & (mask - 1)) << (8 * i);
+            return value;
+        }
+        value |= (uint64_t)archDirGetByte(c) << (8 * i);
+        mask >>= 1;
+    }
+
+    return value;
+}
+
+/* archDirSkip - skip len bytes at a cursor */
+
+void archDirSkip(archDirCursor_t *c, uint64_t len)
+{
+    if (c->err || len > (uint64_t)(c->end - c->p))
+    {
+        c->err = 1;
+        return;
+    }
+
+    c->p += len;
+}
+
+/*
+    archDirZipFind - find a zip's end of central directory record (or
+                     its zip64 record), for the number of entries and
+                     where the central directory starts; delta is the
+                     size of anything in front of the archive (a self
+                     extracting archive's stub, for example), which is
+                     added to the local header offsets.  The last
+                     ARCHDIRZIPTAILLEN bytes of the archive are kept in
+                     zip, which must be freed with archDirZipFree().
+*/
+
+int archDirZipFind(int fd, off_t fileSize, archDirZip_t *zip)
+{
+    unsigned char zip64[ZIP64EOCDLEN];
+    const unsigned char *eocd = NULL;
+    off_t eocdOffset = 0;
+    off_t zip64Offset = 0;
+    off_t cdEnd = 0;
+    ssize_t tailLen = 0;
+    ssize_t i = 0;
+    uint64_t cdOffset = 0;
+
+    memset(zip, 0, sizeof(archDirZip_t));
+
+    if (fileSize < ZIPEOCDLEN)
+    {
+        return gArchDirErr;
+    }
+
+    tailLen = (fileSize < ARCHDIRZIPTAILLEN ?
+               (ssize_t)fileSize : ARCHDIRZIPTAILLEN);
+    zip->tailOffset = fileSize - tailLen;
+
+    zip->tail = malloc((size_t)tailLen);
+    if (zip->tail == NULL)
+    {
+        return gArchDirErr;
+    }
+
+    if (archDirReadAt(fd, zip->tail, (size_t)tailLen, zip->tailOffset) !=
+            tailLen)
+    {
+        archDirZipFree(zip);
+        return gArchDirErr;
+    }
+
+    /* find the end of central directory record, searching backwards */
+
+    for (i = tailLen - ZIPEOCDLEN; i >= 0; i--)
+    {
+        if (zip->tail[i] == 'P' &&
+            memcmp(zip->tail + i, ZIPEOCDSIG, 4) == 0 &&
+            i + ZIPEOCDLEN + archDirGet16(zip->tail + i + 20) <= tailLen)
+        {
+            eocd = zip->tail + i;
+            break;
+        }
+    }
+
+    if (eocd == NULL)
+    {
+        archDirZipFree(zip);
+        return gArchDirErr;
+    }
+
+    eocdOffset = zip->tailOffset + i;
+    zip->numEntries = archDirGet16(eocd + 10);
+    zip->cdSize = archDirGet32(eocd + 12);
+    cdOffset = archDirGet32(eocd + 16);
+    cdEnd = eocdOffset;
+
+    /*
+        use the zip64 record if there is one, since it sits between
+        the central directory and the end of central directory
+        record, even if the counts fit in the latter
+    */
+
+    if (i >= ZIP64LOCATORLEN &&
+        memcmp(eocd - ZIP64LOCATORLEN, ZIP64LOCATORSIG, 4) == 0)
+    {
+        zip64Offset = (off_t)archDirGet64(eocd - ZIP64LOCATORLEN + 8);
+        if (archDirReadAt(fd, zip64, ZIP64EOCDLEN, zip64Offset) !=
+                ZIP64EOCDLEN ||
+            memcmp(zip64, ZIP64EOCDSIG, 4) != 0)
+        {
+            /* the archive might have something in front of it */
+
+            zip64Offset = eocdOffset - ZIP64LOCATORLEN - ZIP64EOCDLEN;
+            if (zip64Offset < 0 ||
+                archDirReadAt(fd, zip64, ZIP64EOCDLEN, zip64Offset) !=
+                    ZIP64EOCDLEN ||
+                memcmp(zip64, ZIP64EOCDSIG, 4) != 0)
+            {
+                archDirZipFree(zip);
+                return gArchDirErr;
+            }
+        }
+
+        zip->numEntries = archDirGet64(zip64 + 32);
+        zip->cdSize = archDirGet64(zip64 + 40);
+        cdOffset = archDirGet64(zip64 + 48);
+        cdEnd = zip64Offset;
+    }
+    else if (zip->numEntries == 0xFFFF ||
+             zip->cdSize == 0xFFFFFFFF ||
+             cdOffset == 0xFFFFFFFF)
+    {
+        archDirZipFree(zip);
+        return gArchDirErr;
+    }
+
+    /* the central directory ends where the end records start */
+
+    if (zip->cdSize > (uint64_t)cdEnd)
+    {
+        archDirZipFree(zip);
+        return gArchDirErr;
+    }
+
+    zip->cdStart = cdEnd - (off_t)zip->cdSize;
+    if ((uint64_t)zip->cdStart < cdOffset)
+    {
+        archDirZipFree(zip);
+        return gArchDirErr;
+    }
+    zip->delta = (int64_t)((uint64_t)zip->cdStart - cdOffset);
+
+    return gArchDirOkay;
+}
+
+/*
+    archDirZipTail - set c to the central directory, if it is all in
+                     the tail that archDirZipFind() read
+*/
+
+int archDirZipTail(const archDirZip_t *zip, archDirCursor_t *c)
+{
+    if (zip->tail == NULL || zip->cdStart < zip->tailOffset)
+    {
+        return gArchDirErr;
+    }
+
+    c->p = zip->tail + (zip->cdStart - zip->tailOffset);
+    c->end = c->p + zip->cdSize;
+    c->err = 0;
+
+    return gArchDirOkay;
+}
+
+/*
+    archDirZipLoad - set c to the central directory, reading it if it
+                     isn't in the tail, and if it is no larger than
+                     maxDirectory
+*/
+
+int archDirZipLoad(int fd,
+                   archDirZip_t *zip,
+                   uint64_t maxDirectory,
+                   archDirCursor_t *c)
+{
+    if (zip->cdSize > maxDirectory ||
+        zip->numEntries > zip->cdSize / ARCHDIRZIPCDLEN)
+    {
+        return gArchDirErr;
+    }
+
+    if (archDirZipTail(zip, c) == gArchDirOkay)
+    {
+        return gArchDirOkay;
+    }
+
+    zip->cd = malloc((size_t)zip->cdSize + 1);
+    if (zip->cd == NULL)
+    {
+        return gArchDirErr;
+    }
+
+    if (archDirReadAt(fd, zip->cd, (size_t)zip->cdSize, zip->cdStart) !=
+            (ssize_t)zip->cdSize)
+    {
+        free(zip->cd);
+        zip->cd = NULL;
+        return gArchDirErr;
+    }
+
+    c->p = zip->cd;
+    c->end = zip->cd + zip->cdSize;
+    c->err = 0;
+
+    return gArchDirOkay;
+}
+
+/*
+    archDirZipNext - get the central directory entry at c, with the
+                     values that didn't fit from its zip64 extra field,
+                     and move c past it; delta is added to the local
+                     header offset
+*/
+
+int archDirZipNext(archDirCursor_t *c,
+                   int64_t delta,
+                   archDirZipEntry_t *entry)
+{
+    const unsigned char *p = c->p;
+    const unsigned char *field = NULL;
+    size_t commentLen = 0;
+    size_t fieldLen = 0;
+
+    if (c->err || c->end - p < ARCHDIRZIPCDLEN || memcmp(p, ZIPCDSIG, 4) != 0)
+    {
+        c->err = 1;
+        return gArchDirErr;
+    }
+
+    entry->flags = archDirGet16(p + 8);
+    entry->method = archDirGet16(p + 10);
+    entry->compressedSize = archDirGet32(p + 20);
+    entry->uncompressedSize = archDirGet32(p + 24);
+    entry->nameLen = archDirGet16(p + 28);
+    entry->extraLen = archDirGet16(p + 30);
+    commentLen = archDirGet16(p + 32);
+    entry->offset = archDirGet32(p + 42);
+
+    if ((size_t)(c->end - p) <
+        ARCHDIRZIPCDLEN + entry->nameLen + entry->extraLen + commentLen)
+    {
+        c->err = 1;
+        return gArchDirErr;
+    }
+
+    entry->name = p + ARCHDIRZIPCDLEN;
+    entry->extra = entry->name + entry->nameLen;
+
+    /* the zip64 field has the values that didn't fit, in order */
+
+    field = archDirZipExtra(entry, ZIP64EXTRAID, &fieldLen);
+    if (field != NULL)
+    {
+        if (entry->uncompressedSize == 0xFFFFFFFF && fieldLen >= 8)
+        {
+            entry->uncompressedSize = archDirGet64(field);
+            field += 8;
+            fieldLen -= 8;
+        }
+        if (entry->compressedSize == 0xFFFFFFFF && fieldLen >= 8)
+        {
+            entry->compressedSize = archDirGet64(field);
+            field += 8;
+            fieldLen -= 8;
+        }
+        if (entry->offset == 0xFFFFFFFF && fieldLen >= 8)
+        {
+            entry->offset = archDirGet64(field);
+        }
+    }
+
+    entry->offset += (uint64_t)delta;
+
+    c->p = entry->extra + entry->extraLen + commentLen;
+
+    return gArchDirOkay;
+}
+
+/*
+    archDirZipExtra - find an entry's extra field with the given id,
+                      returns its data and sets len, or NULL
+*/
+
+const unsigned char *archDirZipExtra(const archDirZipEntry_t *entry,
+                                     uint16_t id,
+                                     size_t *len)
+{
+    const unsigned char *extra = entry->extra;
+    const unsigned char *extraEnd = entry->extra + entry->extraLen;
+    size_t fieldLen = 0;
+
+    while (extraEnd - extra >= 4)
+    {
+        fieldLen = archDirGet16(extra + 2);
+        if ((size_t)(extraEnd - extra - 4) < fieldLen)
+        {
+            break;
+        }
+
+        if (archDirGet16(extra) == id)
+        {
+            *len = fieldLen;
+            return extra + 4;
+        }
+
+        extra += 4 + fieldLen;
+    }
+
+    return NULL;
+}
+
+/* archDirZipFree - release the tail and the central directory */
+
+void archDirZipFree(archDirZip_t *zip)
+{
+    if (zip->tail != NULL)
+    {
+        free(zip->tail);
+        zip->tail = NULL;
+    }
+
+    if (zip->cd != NULL)
+    {
+        free(zip->cd);
+        zip->cd = NULL;
+    }
+}
+
+/*
+    archDir7zLoad - read a 7z archive's header, which is decoded if it
+                    is encoded and no larger than maxHeader, and parse
+                    it up to the number of files in its FilesInfo,
+                    leaving s->files at the FilesInfo's properties; s
+                    must be freed with archDir7zFree().  headerEncrypted
+                    is set if an encoded header has an AES coder.
+*/
+
+int archDir7zLoad(int fd,
+                  off_t fileSize,
+                  uint64_t maxHeader,
+                  archDir7z_t *s,
+                  int *headerEncrypted)
+{
+    unsigned char startHeader[ARCHDIR7ZSTARTHEADERLEN];
+    archDirCursor_t c;
+    archDir7z_t additional;
+    uint64_t nextHeaderOffset = 0;
+    uint64_t nextHeaderSize = 0;
+    uint64_t i = 0;
+    unsigned int id = 0;
+
+    memset(s, 0, sizeof(archDir7z_t));
+    *headerEncrypted = 0;
+
+    if (archDirReadAt(fd, startHeader, ARCHDIR7ZSTARTHEADERLEN, 0) !=
+            ARCHDIR7ZSTARTHEADERLEN)
+    {
+        return gArchDirErr;
+    }
+
+    nextHeaderOffset = archDirGet64(startHeader + 12);
+    nextHeaderSize = archDirGet64(startHeader + 20);
+
+    if (nextHeaderSize == 0 ||
+        nextHeaderSize > maxHeader ||
+        nextHeaderOffset > (uint64_t)fileSize ||
+        ARCHDIR7ZSTARTHEADERLEN + nextHeaderOffset + nextHeaderSize >
+            (uint64_t)fileSize)
+    {
+        return gArchDirErr;
+    }
+
+    s->nextHeader = malloc((size_t)nextHeaderSize);
+    if (s->nextHeader == NULL)
+    {
+        return gArchDirErr;
+    }
+
+    if (archDirReadAt(fd,
+                      s->nextHeader,
+                      (size_t)nextHeaderSize,
+                      (off_t)(ARCHDIR7ZSTARTHEADERLEN + nextHeaderOffset)) !=
+            (ssize_t)nextHeaderSize)
+    {
+        archDir7zFree(s);
+        return gArchDirErr;
+    }
+
+    c.p = s->nextHeader;
+    c.end = s->nextHeader + nextHeaderSize;
+    c.err = 0;
+
+    if (s->nextHeader[0] == gSzEncodedHeader)
+    {
+        /* the header is compressed, and described by a StreamsInfo */
+
+        c.p++;
+        archDir7zStreamsInfo(&c, s);
+        if (!c.err)
+        {
+            s->header = archDir7zDecode(fd, s, maxHeader);
+        }
+
+        if (s->header == NULL)
+        {
+            for (i = 0; s->folders != NULL && i < s->numFolders; i++)
+            {
+                if (s->folders[i].encrypted)
+                {
+                    *headerEncrypted = 1;
+                }
+            }
+            archDir7zFree(s);
+            return gArchDirErr;
+        }
+
+        c.p = s->header;
+        c.end = s->header + s->folders[0].unpackSize;
+        c.err = 0;
+
+        archDir7zFreeStreams(s);
+    }
+
+    if (archDirGetByte(&c) != gSzHeader)
+    {
+        archDir7zFree(s);
+        return gArchDirErr;
+    }
+
+    id = archDirGetByte(&c);
+
+    if (id == gSzArchiveProperties)
+    {
+        while (!c.err && archDirGetByte(&c) != 0)
+        {
+            archDirSkip(&c, archDirGetNumber(&c));
+        }
+        id = archDirGetByte(&c);
+    }
+
+    if (id == gSzAdditionalStreams)
+    {
+        memset(&additional, 0, sizeof(additional));
+        archDir7zStreamsInfo(&c, &additional);
+        archDir7zFreeStreams(&additional);
+        id = archDirGetByte(&c);
+    }
+
+    if (id == gSzMainStreamsInfo)
+    {
+        archDir7zStreamsInfo(&c, s);
+        id = archDirGetByte(&c);
+    }
+
+    if (id == gSzFilesInfo)
+    {
+        s->numFiles = archDirGetNumber(&c);
+        s->hasFiles = 1;
+    }
+    else if (id == gSzEnd)
+    {
+        s->numFiles = 0;
+        s->hasFiles = 1;
+    }
+
+    if (c.err || !s->hasFiles)
+    {
+        archDir7zFree(s);
+        return gArchDirErr;
+    }
+
+    s->files = c;
+
+    return gArchDirOkay;
+}
+
+/* archDir7zFree - release the memory used to load a 7z header */
+
+void archDir7zFree(archDir7z_t *s)
+{
+    archDir7zFreeStreams(s);
+    free(s->header);
+    free(s->nextHeader);
+    memset(s, 0, sizeof(archDir7z_t));
+}
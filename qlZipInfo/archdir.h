@@ -0,0 +1,199 @@
+/*
+    archdir.h - read the directories of zip and 7z archives
+
+    History:
+
+    v. 0.1.0 (10/18/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    The summaries, the entry peeks (and so the covers) and the zip
+    password checks all start from an archive's directory rather than
+    its entries, so the parsing of those directories is done here,
+    once, with its bounds checks:
+
+        - zip: archDirZipFind() finds the end of central directory
+          record, searching back through the last ARCHDIRZIPTAILLEN
+          bytes, and the zip64 record if there is one, for the number
+          of entries and where the central directory is.  The central
+          directory is then either taken from the tail that was read,
+          with archDirZipTail(), which is constant time, or read with
+          archDirZipLoad().  archDirZipNext() gets each entry, with
+          the values in its zip64 extra field.
+        - 7z: archDir7zLoad() reads the header, decoding it if it is
+          encoded with one copy, LZMA or LZMA2 coder, and parses its
+          StreamsInfo (the packed streams, the folders and their
+          coders, and the files in each folder) up to the number of
+          files in its FilesInfo, which is left to the caller.
+
+    Offsets are checked against the file's size, and sizes against
+    the limits that are passed in, before anything is allocated.
+*/
+
+#ifndef qlZipInfo_archdir_h
+#define qlZipInfo_archdir_h
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/* return codes */
+
+enum
+{
+    gArchDirErr  = -1,
+    gArchDirOkay =  0,
+};
+
+/* zip record sizes, and the bytes searched for the end record */
+
+#define ARCHDIRZIPLOCALSIG "PK\003\004"
+#define ARCHDIRZIPLOCALLEN 30
+#define ARCHDIRZIPCDLEN    46
+#define ARCHDIRZIPTAILLEN  (65535 + 22)
+
+/* the 7z start header, which pack positions are relative to */
+
+#define ARCHDIR7ZSTARTHEADERLEN 32
+
+/* most files (substreams) in a 7z archive's folders */
+
+#define ARCHDIR7ZMAXSTREAMS 2000000
+
+/* 7z coder ids */
+
+enum
+{
+    gArchDir7zCoderCopy    = 0x00,
+    gArchDir7zCoderLZMA2   = 0x21,
+    gArchDir7zCoderLZMA    = 0x030101,
+    gArchDir7zCoderDeflate = 0x040108,
+    gArchDir7zCoderBzip2   = 0x040202,
+    gArchDir7zCoderAES     = 0x06F10701,
+};
+
+/* bounds checked cursor over a directory or header */
+
+typedef struct archDirCursor
+{
+    const unsigned char *p;
+    const unsigned char *end;
+    int err;
+} archDirCursor_t;
+
+/* where a zip's central directory is */
+
+typedef struct archDirZip
+{
+    uint64_t numEntries;
+    uint64_t cdSize;
+    off_t cdStart;
+    int64_t delta;
+    unsigned char *tail;
+    off_t tailOffset;
+    unsigned char *cd;
+} archDirZip_t;
+
+/* a zip central directory entry */
+
+typedef struct archDirZipEntry
+{
+    const unsigned char *name;
+    size_t nameLen;
+    const unsigned char *extra;
+    size_t extraLen;
+    uint16_t flags;
+    uint16_t method;
+    uint64_t compressedSize;
+    uint64_t uncompressedSize;
+    uint64_t offset;
+} archDirZipEntry_t;
+
+/* a 7z folder */
+
+typedef struct archDir7zFolder
+{
+    uint64_t packIndex;
+    uint64_t numPacked;
+    uint64_t unpackSize;
+    uint64_t numSubstreams;
+    uint64_t numCoders;
+    uint32_t coderId;
+    const unsigned char *props;
+    uint64_t propsLen;
+    int simple;
+    int hasCRC;
+    int encrypted;
+} archDir7zFolder_t;
+
+/* what is found in a 7z header */
+
+typedef struct archDir7z
+{
+    uint64_t packPos;
+    uint64_t numPackStreams;
+    uint64_t *packSizes;
+    uint64_t numFolders;
+    archDir7zFolder_t *folders;
+    uint64_t numSizes;
+    uint64_t *sizes;
+    uint64_t numFiles;
+    int hasFiles;
+    archDirCursor_t files;
+    unsigned char *nextHeader;
+    unsigned char *header;
+} archDir7z_t;
+
+/* prototypes */
+
+uint16_t archDirGet16(const unsigned char *p);
+uint32_t archDirGet32(const unsigned char *p);
+uint64_t archDirGet64(const unsigned char *p);
+uint16_t archDirGetBE16(const unsigned char *p);
+uint32_t archDirGetBE32(const unsigned char *p);
+uint64_t archDirGetBE64(const unsigned char *p);
+ssize_t archDirReadAt(int fd, void *buf, size_t len, off_t offset);
+unsigned int archDirGetByte(archDirCursor_t *c);
+uint64_t archDirGetNumber(archDirCursor_t *c);
+void archDirSkip(archDirCursor_t *c, uint64_t len);
+int archDirZipFind(int fd, off_t fileSize, archDirZip_t *zip);
+int archDirZipTail(const archDirZip_t *zip, archDirCursor_t *c);
+int archDirZipLoad(int fd,
+                   archDirZip_t *zip,
+                   uint64_t maxDirectory,
+                   archDirCursor_t *c);
+int archDirZipNext(archDirCursor_t *c,
+                   int64_t delta,
+                   archDirZipEntry_t *entry);
+const unsigned char *archDirZipExtra(const archDirZipEntry_t *entry,
+                                     uint16_t id,
+                                     size_t *len);
+void archDirZipFree(archDirZip_t *zip);
+int archDir7zLoad(int fd,
+                  off_t fileSize,
+                  uint64_t maxHeader,
+                  archDir7z_t *s,
+                  int *headerEncrypted);
+void archDir7zFree(archDir7z_t *s);
+
+#endif /* qlZipInfo_archdir_h */
@@ -0,0 +1,924 @@
+/*
+    arinfo.c - ar archive members and symbol index from the headers
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://en.wikipedia.org/wiki/Ar_(Unix)
+    https://www.freebsd.org/cgi/man.cgi?query=ar&sektion=5
+    https://sourceware.org/binutils/docs/binutils/ar.html
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "arinfo.h"
+
+/* the archive and member headers */
+
+#define ARMAGIC          "!<arch>\n"
+#define ARTHINMAGIC      "!<thin>\n"
+#define ARMAGICLEN       8
+#define ARHEADERLEN      60
+#define ARNAMELEN        16
+#define ARDATEOFFSET     16
+#define ARDATELEN        12
+#define ARMODEOFFSET     40
+#define ARMODELEN        8
+#define ARSIZEOFFSET     48
+#define ARSIZELEN        10
+#define ARFMAGOFFSET     58
+#define ARFMAG           "`\n"
+#define ARBSDNAMEMAX     4096
+
+/*
+    headers are read through a window of the archive: a large one when
+    the members are small enough for one read to cover many headers,
+    and otherwise a small one, so that little of each member is read
+*/
+
+#define ARINFOWINDOWMIN  512
+#define ARINFOWINDOWHEADERS 8
+#define ARINFOWINDOWMAX  65536
+
+/* the state of a listing */
+
+typedef struct arInfoReader
+{
+    int fd;
+    off_t fileSize;
+    unsigned char *window;
+    off_t windowOffset;
+    size_t windowLen;
+    arInfo_t *info;
+    int formatKnown;
+    char *longNames;
+    size_t longNamesLen;
+    uint64_t *symbols;
+    uint64_t numSymbols;
+    size_t *nameOffsets;
+    size_t namesLen;
+    size_t namesSize;
+    uint32_t membersSize;
+} arInfoReader_t;
+
+/* private functions */
+
+static uint32_t arInfoGet32(const unsigned char *p, int bigEndian);
+static uint64_t arInfoGet64(const unsigned char *p, int bigEndian);
+static uint64_t arInfoNumber(const unsigned char *p,
+                             size_t len,
+                             unsigned int base);
+static ssize_t arInfoReadAt(arInfoReader_t *reader,
+                            void *buf,
+                            size_t len,
+                            off_t offset);
+static const unsigned char *arInfoPeek(arInfoReader_t *reader,
+                                       off_t offset,
+                                       size_t len);
+static int arInfoReadTable(arInfoReader_t *reader,
+                           off_t offset,
+                           uint64_t size,
+                           unsigned char **table);
+static int arInfoReadGNUSymbols(arInfoReader_t *reader,
+                                const unsigned char *p,
+                                size_t len,
+                                int is64);
+static int arInfoReadBSDSymbols(arInfoReader_t *reader,
+                                const unsigned char *p,
+                                size_t len,
+                                int is64);
+static int arInfoAddMember(arInfoReader_t *reader,
+                           const char *name,
+                           size_t nameLen,
+                           const unsigned char *h,
+                           off_t offset,
+                           uint64_t size);
+static int arInfoCompareOffsets(const void *a, const void *b);
+static void arInfoCountSymbols(arInfoReader_t *reader);
+
+/* arInfoGet32 - get a 32 bit value of either byte order */
+
+static uint32_t arInfoGet32(const unsigned char *p, int bigEndian)
+{
+    if (bigEndian)
+    {
+        return ((uint32_t)p[0] << 24) |
+               ((uint32_t)p[1] << 16) |
+               ((uint32_t)p[2] << 8) |
+               (uint32_t)p[3];
+    }
+
+    return (uint32_t)p[0] |
+           ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+/* arInfoGet64 - get a 64 bit value of either byte order */
+
+static uint64_t arInfoGet64(const unsigned char *p, int bigEndian)
+{
+    if (bigEndian)
+    {
+        return ((uint64_t)arInfoGet32(p, 1) << 32) | arInfoGet32(p + 4, 1);
+    }
+
+    return ((uint64_t)arInfoGet32(p + 4, 0) << 32) | arInfoGet32(p, 0);
+}
+
+/*
+    arInfoNumber - get the space padded decimal or octal number in a
+                   header field, or 0 if it is blank
+*/
+
+static uint64_t arInfoNumber(const unsigned char *p,
+                             size_t len,
+                             unsigned int base)
+{
+    uint64_t value = 0;
+    size_t i = 0;
+
+    while (i < len && p[i] == ' ')
+    {
+        i++;
+    }
+
+    for (; i < len && p[i] >= '0' && p[i] < '0' + base; i++)
+    {
+        if (value > (UINT64_MAX - (p[i] - '0')) / base)
+        {
+            return UINT64_MAX;
+        }
+        value = value * base + (uint64_t)(p[i] - '0');
+    }
+
+    return value;
+}
+
+/*
+    arInfoReadAt - read up to len bytes at offset and add them to
+                   info->bytesRead, returns the number of bytes read
+                   or -1 on error
+*/
+
+static ssize_t arInfoReadAt(arInfoReader_t *reader,
+                            void *buf,
+                            size_t len,
+                            off_t offset)
+{
+    size_t total = 0;
+    ssize_t bytesRead = 0;
+
+    while (total < len)
+    {
+        bytesRead = pread(reader->fd,
+                          (unsigned char *)buf + total,
+                          len - total,
+                          offset + (off_t)total);
+        reader->info->reads++;
+        if (bytesRead < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        if (bytesRead == 0)
+        {
+            break;
+        }
+        total += (size_t)bytesRead;
+    }
+
+    reader->info->bytesRead += total;
+
+    return (ssize_t)total;
+}
+
+/*
+    arInfoPeek - get the len (at most ARINFOWINDOWMAX) bytes at offset,
+                 reading the window there if they aren't in it, or
+                 NULL if the archive ends first
+*/
+
+static const unsigned char *arInfoPeek(arInfoReader_t *reader,
+                                       off_t offset,
+                                       size_t len)
+{
+    size_t want = ARINFOWINDOWMAX;
+    uint32_t members = reader->info->numMembers;
+
+    if (len > ARINFOWINDOWMAX || offset < 0 ||
+        offset + (off_t)len > reader->fileSize)
+    {
+        return NULL;
+    }
+
+    if (offset >= reader->windowOffset &&
+        offset + (off_t)len <= reader->windowOffset +
+                               (off_t)reader->windowLen)
+    {
+        return reader->window + (offset - reader->windowOffset);
+    }
+
+    /* use the small window if the large one would cover few headers */
+
+    if (members > 0 &&
+        (uint64_t)(offset - ARMAGICLEN) / members >
+            ARINFOWINDOWMAX / ARINFOWINDOWHEADERS)
+    {
+        want = ARINFOWINDOWMIN;
+    }
+    if (want < len)
+    {
+        want = len;
+    }
+    if ((off_t)want > reader->fileSize - offset)
+    {
+        want = (size_t)(reader->fileSize - offset);
+    }
+
+    reader->windowLen = 0;
+    if (arInfoReadAt(reader, reader->window, want, offset) != (ssize_t)want)
+    {
+        return NULL;
+    }
+    reader->windowOffset = offset;
+    reader->windowLen = want;
+
+    return reader->window;
+}
+
+/*
+    arInfoReadTable - read the size bytes of a long name table or
+                      symbol index at offset into a new buffer
+*/
+
+static int arInfoReadTable(arInfoReader_t *reader,
+                           off_t offset,
+                           uint64_t size,
+                           unsigned char **table)
+{
+    *table = NULL;
+
+    if (size == 0 || size > ARINFOMAXTABLES ||
+        offset + (off_t)size > reader->fileSize)
+    {
+        return gArInfoErr;
+    }
+
+    *table = malloc((size_t)size + 1);
+    if (*table == NULL)
+    {
+        return gArInfoErr;
+    }
+
+    if (arInfoReadAt(reader, *table, (size_t)size, offset) != (ssize_t)size)
+    {
+        free(*table);
+        *table = NULL;
+        return gArInfoErr;
+    }
+
+    (*table)[size] = '\0';
+
+    return gArInfoOkay;
+}
+
+/*
+    arInfoReadGNUSymbols - get the member offsets of a GNU symbol
+                           index: a big endian count, that many big
+                           endian offsets and then the names; 32 bit
+                           for "/" and 64 bit for "/SYM64/"
+*/
+
+static int arInfoReadGNUSymbols(arInfoReader_t *reader,
+                                const unsigned char *p,
+                                size_t len,
+                                int is64)
+{
+    size_t width = (is64 ? 8 : 4);
+    uint64_t count = 0;
+    uint64_t i = 0;
+
+    if (len < width)
+    {
+        return gArInfoErr;
+    }
+
+    count = (is64 ? arInfoGet64(p, 1) : arInfoGet32(p, 1));
+    if (count > (len - width) / width)
+    {
+        return gArInfoErr;
+    }
+
+    free(reader->symbols);
+    reader->symbols = malloc((size_t)(count > 0 ? count : 1) *
+                             sizeof(uint64_t));
+    if (reader->symbols == NULL)
+    {
+        return gArInfoErr;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        reader->symbols[i] = (is64 ?
+                              arInfoGet64(p + width * (i + 1), 1) :
+                              arInfoGet32(p + width * (i + 1), 1));
+    }
+    reader->numSymbols = count;
+
+    return gArInfoOkay;
+}
+
+/*
+    arInfoReadBSDSymbols - get the member offsets of a BSD symbol
+                           index: the size of the ranlib array, the
+                           array of (name, offset) pairs, the size of
+                           the names and the names; in the byte order
+                           of the library's target, which is taken to
+                           be whichever makes the sizes add up
+*/
+
+static int arInfoReadBSDSymbols(arInfoReader_t *reader,
+                                const unsigned char *p,
+                                size_t len,
+                                int is64)
+{
+    size_t width = (is64 ? 8 : 4);
+    uint64_t ranlibSize = 0;
+    uint64_t stringsSize = 0;
+    uint64_t count = 0;
+    uint64_t i = 0;
+    int bigEndian = 0;
+
+    for (bigEndian = 0; bigEndian < 2; bigEndian++)
+    {
+        if (len < 2 * width)
+        {
+            return gArInfoErr;
+        }
+        ranlibSize = (is64 ? arInfoGet64(p, bigEndian) :
+                             arInfoGet32(p, bigEndian));
+        if (ranlibSize % (2 * width) != 0 ||
+            ranlibSize > len - 2 * width)
+        {
+            continue;
+        }
+        stringsSize = (is64 ?
+                       arInfoGet64(p + width + ranlibSize, bigEndian) :
+                       arInfoGet32(p + width + ranlibSize, bigEndian));
+        if (stringsSize <= len - 2 * width - ranlibSize)
+        {
+            break;
+        }
+    }
+
+    if (bigEndian == 2)
+    {
+        return gArInfoErr;
+    }
+
+    count = ranlibSize / (2 * width);
+
+    free(reader->symbols);
+    reader->symbols = malloc((size_t)(count > 0 ? count : 1) *
+                             sizeof(uint64_t));
+    if (reader->symbols == NULL)
+    {
+        return gArInfoErr;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        const unsigned char *ranlib = p + width + i * 2 * width;
+
+        reader->symbols[i] = (is64 ?
+                              arInfoGet64(ranlib + width, bigEndian) :
+                              arInfoGet32(ranlib + width, bigEndian));
+    }
+    reader->numSymbols = count;
+
+    return gArInfoOkay;
+}
+
+/* arInfoAddMember - add a member with the header h at offset */
+
+static int arInfoAddMember(arInfoReader_t *reader,
+                           const char *name,
+                           size_t nameLen,
+                           const unsigned char *h,
+                           off_t offset,
+                           uint64_t size)
+{
+    arInfo_t *info = reader->info;
+    arMember_t *member = NULL;
+    void *p = NULL;
+    size_t newSize = 0;
+
+    if (info->numMembers == reader->membersSize)
+    {
+        newSize = (reader->membersSize > 0 ?
+                   (size_t)reader->membersSize * 2 : 256);
+        p = realloc(info->members, newSize * sizeof(arMember_t));
+        if (p == NULL)
+        {
+            return gArInfoErr;
+        }
+        info->members = p;
+        p = realloc(reader->nameOffsets, newSize * sizeof(size_t));
+        if (p == NULL)
+        {
+            return gArInfoErr;
+        }
+        reader->nameOffsets = p;
+        reader->membersSize = (uint32_t)newSize;
+    }
+
+    if (reader->namesLen + nameLen + 1 > reader->namesSize)
+    {
+        newSize = (reader->namesSize > 0 ? reader->namesSize * 2 : 4096);
+        while (newSize < reader->namesLen + nameLen + 1)
+        {
+            newSize *= 2;
+        }
+        p = realloc(info->names, newSize);
+        if (p == NULL)
+        {
+            return gArInfoErr;
+        }
+        info->names = p;
+        reader->namesSize = newSize;
+    }
+
+    memcpy(info->names + reader->namesLen, name, nameLen);
+    info->names[reader->namesLen + nameLen] = '\0';
+    reader->nameOffsets[info->numMembers] = reader->namesLen;
+    reader->namesLen += nameLen + 1;
+
+    member = &info->members[info->numMembers];
+    memset(member, 0, sizeof(arMember_t));
+    member->offset = (uint64_t)offset;
+    member->size = size;
+    member->mtime = (int64_t)arInfoNumber(h + ARDATEOFFSET, ARDATELEN, 10);
+    member->mode = (uint32_t)arInfoNumber(h + ARMODEOFFSET, ARMODELEN, 8);
+
+    info->numMembers++;
+
+    return gArInfoOkay;
+}
+
+/* arInfoCompareOffsets - qsort() comparison function for offsets */
+
+static int arInfoCompareOffsets(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x < y ? -1 : (x > y ? 1 : 0));
+}
+
+/*
+    arInfoCountSymbols - count the symbols of each member, whose
+                         offsets are in increasing order, from the
+                         sorted offsets of the symbol index
+*/
+
+static void arInfoCountSymbols(arInfoReader_t *reader)
+{
+    arInfo_t *info = reader->info;
+    uint64_t s = 0;
+    uint32_t i = 0;
+
+    qsort(reader->symbols,
+          (size_t)reader->numSymbols,
+          sizeof(uint64_t),
+          arInfoCompareOffsets);
+
+    for (i = 0; i < info->numMembers; i++)
+    {
+        while (s < reader->numSymbols &&
+               reader->symbols[s] < info->members[i].offset)
+        {
+            s++;
+        }
+        while (s < reader->numSymbols &&
+               reader->symbols[s] == info->members[i].offset)
+        {
+            info->members[i].symbols++;
+            s++;
+        }
+        if (info->members[i].symbols > 0)
+        {
+            info->membersWithSymbols++;
+        }
+    }
+}
+
+/* public functions */
+
+/* arInfoRead - list the members of the ar archive at path */
+
+int arInfoRead(const char *path, int flags, arInfo_t *info)
+{
+    int fd = -1;
+    int err = gArInfoErr;
+
+    if (path == NULL || info == NULL)
+    {
+        return gArInfoErr;
+    }
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        memset(info, 0, sizeof(arInfo_t));
+        return gArInfoErr;
+    }
+
+    err = arInfoReadFd(fd, flags, info);
+
+    close(fd);
+
+    return err;
+}
+
+/*
+    arInfoReadFd - list the members of the ar archive open on fd,
+                   which must start with the archive's magic
+*/
+
+int arInfoReadFd(int fd, int flags, arInfo_t *info)
+{
+    arInfoReader_t reader;
+    struct stat fileStats;
+    const unsigned char *h = NULL;
+    const unsigned char *p = NULL;
+    unsigned char *table = NULL;
+    unsigned char header[ARHEADERLEN];
+    char name[ARBSDNAMEMAX + 1];
+    size_t nameLen = 0;
+    uint64_t size = 0;
+    uint64_t index = 0;
+    off_t offset = ARMAGICLEN;
+    off_t dataOffset = 0;
+    off_t next = 0;
+    uint32_t i = 0;
+    int isThin = 0;
+    int isStored = 0;
+    int r = gArInfoOkay;
+
+    if (info == NULL)
+    {
+        return gArInfoErr;
+    }
+
+    memset(info, 0, sizeof(arInfo_t));
+    memset(&reader, 0, sizeof(arInfoReader_t));
+
+    if (fd < 0 || fstat(fd, &fileStats) != 0 || !S_ISREG(fileStats.st_mode))
+    {
+        return gArInfoErr;
+    }
+
+    reader.fd = fd;
+    reader.fileSize = fileStats.st_size;
+    reader.info = info;
+    reader.window = malloc(ARINFOWINDOWMAX);
+    if (reader.window == NULL)
+    {
+        return gArInfoErr;
+    }
+
+    h = arInfoPeek(&reader, 0, ARMAGICLEN);
+    if (h == NULL)
+    {
+        goto failed;
+    }
+    if (memcmp(h, ARTHINMAGIC, ARMAGICLEN) == 0)
+    {
+        isThin = 1;
+        info->format = ArFormatThin;
+        reader.formatKnown = 1;
+    }
+    else if (memcmp(h, ARMAGIC, ARMAGICLEN) != 0)
+    {
+        goto failed;
+    }
+
+    while (offset + ARHEADERLEN <= reader.fileSize)
+    {
+        h = arInfoPeek(&reader, offset, ARHEADERLEN);
+        if (h == NULL || memcmp(h + ARFMAGOFFSET, ARFMAG, 2) != 0)
+        {
+            info->truncated = 1;
+            break;
+        }
+
+        /* a BSD long name may move the window */
+
+        memcpy(header, h, ARHEADERLEN);
+        h = header;
+
+        size = arInfoNumber(h + ARSIZEOFFSET, ARSIZELEN, 10);
+        dataOffset = offset + ARHEADERLEN;
+
+        /* the name, without the padding */
+
+        memcpy(name, h, ARNAMELEN);
+        for (nameLen = ARNAMELEN; nameLen > 0; nameLen--)
+        {
+            if (name[nameLen - 1] != ' ')
+            {
+                break;
+            }
+        }
+        name[nameLen] = '\0';
+
+        /* a thin archive stores only its symbol index and name table */
+
+        isStored = 1;
+
+        if (strcmp(name, "/") == 0 || strcmp(name, "/SYM64/") == 0)
+        {
+            /* GNU symbol index */
+
+            if (size <= ARINFOMAXTABLES)
+            {
+                if (arInfoReadTable(&reader, dataOffset, size, &table) !=
+                        gArInfoOkay ||
+                    arInfoReadGNUSymbols(&reader,
+                                         table,
+                                         (size_t)size,
+                                         name[1] == 'S') != gArInfoOkay)
+                {
+                    goto failed;
+                }
+                free(table);
+                table = NULL;
+                info->hasSymbolIndex = 1;
+            }
+            if (!reader.formatKnown)
+            {
+                info->format = ArFormatGNU;
+                reader.formatKnown = 1;
+            }
+        }
+        else if (strcmp(name, "//") == 0)
+        {
+            /* GNU long name table, used by later members */
+
+            free(reader.longNames);
+            reader.longNames = NULL;
+            if (arInfoReadTable(&reader,
+                                dataOffset,
+                                size,
+                                &table) != gArInfoOkay)
+            {
+                goto failed;
+            }
+            reader.longNames = (char *)table;
+            reader.longNamesLen = (size_t)size;
+            table = NULL;
+            if (!reader.formatKnown)
+            {
+                info->format = ArFormatGNU;
+                reader.formatKnown = 1;
+            }
+        }
+        else
+        {
+            if (name[0] == '/' && name[1] >= '0' && name[1] <= '9')
+            {
+                /* GNU long name, up to "/\n" in the name table */
+
+                index = arInfoNumber((const unsigned char *)name + 1,
+                                     nameLen - 1,
+                                     10);
+                if (reader.longNames == NULL ||
+                    index >= reader.longNamesLen)
+                {
+                    goto failed;
+                }
+                p = (const unsigned char *)reader.longNames + index;
+                nameLen = 0;
+                while (index + nameLen < reader.longNamesLen &&
+                       p[nameLen] != '\n' && p[nameLen] != '\0' &&
+                       nameLen < ARBSDNAMEMAX)
+                {
+                    nameLen++;
+                }
+                memcpy(name, p, nameLen);
+                if (nameLen > 0 && name[nameLen - 1] == '/')
+                {
+                    nameLen--;
+                }
+                name[nameLen] = '\0';
+                isStored = !isThin;
+            }
+            else if (strncmp(name, "#1/", 3) == 0)
+            {
+                /* BSD long name, at the start of the member's data */
+
+                index = arInfoNumber((const unsigned char *)name + 3,
+                                     nameLen - 3,
+                                     10);
+                if (index > ARBSDNAMEMAX || index > size)
+                {
+                    goto failed;
+                }
+                nameLen = (size_t)index;
+                if (nameLen > 0)
+                {
+                    p = arInfoPeek(&reader, dataOffset, nameLen);
+                    if (p == NULL)
+                    {
+                        goto failed;
+                    }
+                    memcpy(name, p, nameLen);
+                }
+                name[nameLen] = '\0';
+                nameLen = strlen(name);
+                dataOffset += (off_t)index;
+                size -= index;
+                if (!reader.formatKnown)
+                {
+                    info->format = ArFormatBSD;
+                    reader.formatKnown = 1;
+                }
+            }
+            else if (nameLen > 1 && name[nameLen - 1] == '/')
+            {
+                /* GNU short name, terminated by a '/' */
+
+                name[--nameLen] = '\0';
+                isStored = !isThin;
+                if (!reader.formatKnown)
+                {
+                    info->format = ArFormatGNU;
+                    reader.formatKnown = 1;
+                }
+            }
+            else if (!reader.formatKnown)
+            {
+                info->format = ArFormatBSD;
+                reader.formatKnown = 1;
+            }
+
+            if (strncmp(name, "__.SYMDEF", 9) == 0 &&
+                info->format == ArFormatBSD)
+            {
+                /* BSD symbol index */
+
+                if (size <= ARINFOMAXTABLES)
+                {
+                    if (arInfoReadTable(&reader,
+                                        dataOffset,
+                                        size,
+                                        &table) != gArInfoOkay ||
+                        arInfoReadBSDSymbols(&reader,
+                                             table,
+                                             (size_t)size,
+                                             strncmp(name,
+                                                     "__.SYMDEF_64",
+                                                     12) == 0) !=
+                            gArInfoOkay)
+                    {
+                        goto failed;
+                    }
+                    free(table);
+                    table = NULL;
+                    info->hasSymbolIndex = 1;
+                }
+            }
+            else
+            {
+                if (isStored &&
+                    size > (uint64_t)(reader.fileSize - dataOffset))
+                {
+                    info->truncated = 1;
+                    break;
+                }
+                if (info->numMembers >= ARINFOMAXMEMBERS)
+                {
+                    info->truncated = 1;
+                    break;
+                }
+                if (arInfoAddMember(&reader,
+                                    name,
+                                    nameLen,
+                                    h,
+                                    offset,
+                                    size) != gArInfoOkay)
+                {
+                    goto failed;
+                }
+            }
+        }
+
+        /* members start on even offsets */
+
+        next = (isStored ? dataOffset + (off_t)size : dataOffset);
+        offset = next + (next & 1);
+    }
+
+    /* the names moved as they were added */
+
+    for (i = 0; i < info->numMembers; i++)
+    {
+        info->members[i].name = info->names + reader.nameOffsets[i];
+    }
+
+    if (info->hasSymbolIndex)
+    {
+        info->numSymbols = reader.numSymbols;
+        if (flags & ArInfoSymbolCounts)
+        {
+            arInfoCountSymbols(&reader);
+        }
+    }
+
+    goto done;
+
+failed:
+
+    r = gArInfoErr;
+    free(table);
+    arInfoFree(info);
+
+done:
+
+    free(reader.window);
+    free(reader.longNames);
+    free(reader.symbols);
+    free(reader.nameOffsets);
+
+    return r;
+}
+
+/* arInfoFree - free the members of an archive */
+
+void arInfoFree(arInfo_t *info)
+{
+    if (info == NULL)
+    {
+        return;
+    }
+
+    free(info->members);
+    free(info->names);
+    info->members = NULL;
+    info->names = NULL;
+    info->numMembers = 0;
+    info->numSymbols = 0;
+    info->membersWithSymbols = 0;
+    info->hasSymbolIndex = 0;
+}
+
+/* arInfoFormatName - get the name of an archive variant */
+
+const char *arInfoFormatName(arFormat_t format)
+{
+    switch (format)
+    {
+        case ArFormatGNU:
+            return "GNU/SVR4";
+        case ArFormatBSD:
+            return "BSD";
+        case ArFormatThin:
+            return "GNU thin";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,127 @@
+/*
+    arinfo.h - ar archive members and symbol index from the headers
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://en.wikipedia.org/wiki/Ar_(Unix)
+    https://www.freebsd.org/cgi/man.cgi?query=ar&sektion=5
+    https://sourceware.org/binutils/docs/binutils/ar.html
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    arInfoRead() lists an ar archive (a .a static library, a .deb,
+    etc.) from its member headers alone.  It reads the 60 byte header
+    of each member with pread(), through a small window so that the
+    headers of small members cost one read between them, and goes
+    straight from each header to the next without reading the member.
+    The GNU long name table ("//") and the symbol index, if any, are
+    each read once: the GNU "/" and "/SYM64/" tables and the BSD
+    "__.SYMDEF" tables (including "__.SYMDEF SORTED" and the 64 bit
+    "__.SYMDEF_64"), whose entries give the offset of the member that
+    defines each symbol.  With ArInfoSymbolCounts, each member's
+    symbols are counted.  GNU thin archives, whose members are not
+    stored in the archive, are listed too.
+*/
+
+#ifndef qlZipInfo_arinfo_h
+#define qlZipInfo_arinfo_h
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/* return codes */
+
+enum
+{
+    gArInfoErr  = -1,
+    gArInfoOkay =  0,
+};
+
+/*
+    most bytes of the long name table or symbol index that are read;
+    a larger symbol index is skipped, a larger name table is an error
+*/
+
+#define ARINFOMAXTABLES  (256 * 1024 * 1024)
+
+/* most members that are listed */
+
+#define ARINFOMAXMEMBERS 1000000
+
+/* flags */
+
+enum
+{
+    ArInfoSymbolCounts = 0x01,
+};
+
+/* archive variants */
+
+typedef enum
+{
+    ArFormatGNU  = 0,
+    ArFormatBSD  = 1,
+    ArFormatThin = 2,
+} arFormat_t;
+
+/* a member, other than the symbol index and the long name table */
+
+typedef struct arMember
+{
+    const char *name;
+    uint64_t offset;
+    uint64_t size;
+    int64_t mtime;
+    uint32_t mode;
+    uint32_t symbols;
+} arMember_t;
+
+/* an archive */
+
+typedef struct arInfo
+{
+    arFormat_t format;
+    uint32_t numMembers;
+    arMember_t *members;
+    char *names;
+    int hasSymbolIndex;
+    int truncated;
+    uint64_t numSymbols;
+    uint32_t membersWithSymbols;
+    uint64_t bytesRead;
+    uint64_t reads;
+} arInfo_t;
+
+/* prototypes */
+
+int arInfoRead(const char *path, int flags, arInfo_t *info);
+int arInfoReadFd(int fd, int flags, arInfo_t *info);
+void arInfoFree(arInfo_t *info);
+const char *arInfoFormatName(arFormat_t format);
+
+#endif /* qlZipInfo_arinfo_h */
@@ -0,0 +1,548 @@
+/*
+    cabinfo.c - cabinet folders and sizes from the header tables
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    Microsoft Cabinet Format
+    https://learn.microsoft.com/en-us/previous-versions/bb417343(v=msdn.10)
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "cabinfo.h"
+
+/* CFHEADER, CFFOLDER, CFFILE and CFDATA */
+
+#define CABMAGIC          "MSCF"
+#define CABHEADERLEN      36
+#define CABRESERVELEN     4
+#define CABFOLDERLEN      8
+#define CABFILELEN        16
+#define CABDATALEN        8
+#define CABHEADERLEN_MAX  (CABHEADERLEN + CABRESERVELEN + 65535 + 4 * 256)
+
+#define CABFLAGPREV       0x0001
+#define CABFLAGNEXT       0x0002
+#define CABFLAGRESERVE    0x0004
+
+#define CABFOLDERPREV     0xFFFD
+#define CABFOLDERNEXT     0xFFFE
+#define CABFOLDERPREVNEXT 0xFFFF
+
+/* private functions */
+
+static uint16_t cabInfoGet16(const unsigned char *p);
+static uint32_t cabInfoGet32(const unsigned char *p);
+static ssize_t cabInfoReadAt(int fd,
+                             void *buf,
+                             size_t len,
+                             off_t offset,
+                             cabInfo_t *info);
+static ssize_t cabInfoSkipString(const unsigned char *p, size_t len);
+static int cabInfoGrow(int fd,
+                       unsigned char **tables,
+                       size_t *tablesLen,
+                       size_t len,
+                       cabInfo_t *info);
+static int cabInfoReadFiles(const unsigned char *p,
+                            size_t len,
+                            uint16_t numFiles,
+                            cabInfo_t *info);
+static void cabInfoReadData(int fd,
+                            off_t fileSize,
+                            off_t offset,
+                            unsigned int reserve,
+                            cabFolder_t *folder,
+                            cabInfo_t *info);
+
+/* cabInfoGet16 - get a little endian 16 bit value */
+
+static uint16_t cabInfoGet16(const unsigned char *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/* cabInfoGet32 - get a little endian 32 bit value */
+
+static uint32_t cabInfoGet32(const unsigned char *p)
+{
+    return (uint32_t)p[0] |
+           ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+/*
+    cabInfoReadAt - read up to len bytes at offset and add them to
+                    info->bytesRead, returns the number of bytes read
+                    or -1 on error
+*/
+
+static ssize_t cabInfoReadAt(int fd,
+                             void *buf,
+                             size_t len,
+                             off_t offset,
+                             cabInfo_t *info)
+{
+    size_t total = 0;
+    ssize_t bytesRead = 0;
+
+    while (total < len)
+    {
+        bytesRead = pread(fd,
+                          (unsigned char *)buf + total,
+                          len - total,
+                          offset + (off_t)total);
+        if (bytesRead < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        if (bytesRead == 0)
+        {
+            break;
+        }
+        total += (size_t)bytesRead;
+    }
+
+    info->bytesRead += total;
+
+    return (ssize_t)total;
+}
+
+/*
+    cabInfoSkipString - get the length, with the NUL, of the string at
+                        p, or -1 if it isn't terminated within len bytes
+*/
+
+static ssize_t cabInfoSkipString(const unsigned char *p, size_t len)
+{
+    const unsigned char *nul = memchr(p, '\0', len);
+
+    return (nul == NULL ? -1 : (nul - p) + 1);
+}
+
+/*
+    cabInfoGrow - read the tables up to len bytes from the start of
+                  the cabinet, if fewer have been read
+*/
+
+static int cabInfoGrow(int fd,
+                       unsigned char **tables,
+                       size_t *tablesLen,
+                       size_t len,
+                       cabInfo_t *info)
+{
+    unsigned char *p = NULL;
+
+    if (len <= *tablesLen)
+    {
+        return gCabInfoOkay;
+    }
+
+    p = realloc(*tables, len);
+    if (p == NULL)
+    {
+        return gCabInfoErr;
+    }
+    *tables = p;
+
+    if (cabInfoReadAt(fd,
+                      p + *tablesLen,
+                      len - *tablesLen,
+                      (off_t)*tablesLen,
+                      info) != (ssize_t)(len - *tablesLen))
+    {
+        return gCabInfoErr;
+    }
+
+    *tablesLen = len;
+
+    return gCabInfoOkay;
+}
+
+/*
+    cabInfoReadFiles - count the numFiles CFFILEs at p, and add up
+                       their sizes, by folder
+*/
+
+static int cabInfoReadFiles(const unsigned char *p,
+                            size_t len,
+                            uint16_t numFiles,
+                            cabInfo_t *info)
+{
+    cabFolder_t *folder = NULL;
+    ssize_t nameLen = 0;
+    uint16_t index = 0;
+    uint16_t i = 0;
+
+    for (i = 0; i < numFiles; i++)
+    {
+        if (len < CABFILELEN)
+        {
+            return gCabInfoErr;
+        }
+
+        nameLen = cabInfoSkipString(p + CABFILELEN, len - CABFILELEN);
+        if (nameLen < 0)
+        {
+            return gCabInfoErr;
+        }
+
+        /* a file split across cabinets is in the first or last folder */
+
+        index = cabInfoGet16(p + 8);
+        switch (index)
+        {
+            case CABFOLDERPREV:
+            case CABFOLDERPREVNEXT:
+                index = 0;
+                break;
+            case CABFOLDERNEXT:
+                index = (uint16_t)(info->numFolders - 1);
+                break;
+            default:
+                break;
+        }
+
+        if (index >= info->numFolders)
+        {
+            return gCabInfoErr;
+        }
+
+        folder = &info->folders[index];
+        folder->files++;
+        folder->filesSize += cabInfoGet32(p);
+
+        p += CABFILELEN + (size_t)nameLen;
+        len -= CABFILELEN + (size_t)nameLen;
+    }
+
+    info->entries = numFiles;
+
+    return gCabInfoOkay;
+}
+
+/*
+    cabInfoReadData - add up the sizes in the headers of a folder's
+                      CFDATA blocks, starting at offset; hasSizes is
+                      only set if every header is in the file
+*/
+
+static void cabInfoReadData(int fd,
+                            off_t fileSize,
+                            off_t offset,
+                            unsigned int reserve,
+                            cabFolder_t *folder,
+                            cabInfo_t *info)
+{
+    unsigned char hdr[CABDATALEN];
+    uint32_t i = 0;
+
+    for (i = 0; i < folder->blocks; i++)
+    {
+        if (offset + CABDATALEN > fileSize ||
+            cabInfoReadAt(fd, hdr, CABDATALEN, offset, info) != CABDATALEN)
+        {
+            return;
+        }
+
+        folder->compressedSize += cabInfoGet16(hdr + 4);
+        folder->uncompressedSize += cabInfoGet16(hdr + 6);
+        offset += CABDATALEN + reserve + cabInfoGet16(hdr + 4);
+    }
+
+    folder->hasSizes = (offset <= fileSize);
+}
+
+/* public functions */
+
+/* cabInfoRead - list the folders of the cabinet at path */
+
+int cabInfoRead(const char *path, cabInfo_t *info)
+{
+    int fd = -1;
+    int err = gCabInfoErr;
+
+    if (path == NULL || info == NULL)
+    {
+        return gCabInfoErr;
+    }
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        memset(info, 0, sizeof(cabInfo_t));
+        return gCabInfoErr;
+    }
+
+    err = cabInfoReadFd(fd, info);
+
+    close(fd);
+
+    return err;
+}
+
+/*
+    cabInfoReadFd - list the folders of the cabinet open on fd, which
+                    must start with the cabinet's CFHEADER
+*/
+
+int cabInfoReadFd(int fd, cabInfo_t *info)
+{
+    unsigned char *tables = NULL;
+    unsigned char *p = NULL;
+    struct stat fileStats;
+    size_t tablesLen = 0;
+    size_t pos = 0;
+    ssize_t strLen = 0;
+    off_t filesOffset = 0;
+    off_t tablesEnd = 0;
+    uint16_t flags = 0;
+    uint16_t numFiles = 0;
+    unsigned int folderReserve = 0;
+    unsigned int dataReserve = 0;
+    uint32_t i = 0;
+    int s = 0;
+
+    if (info == NULL)
+    {
+        return gCabInfoErr;
+    }
+
+    memset(info, 0, sizeof(cabInfo_t));
+
+    if (fd < 0 || fstat(fd, &fileStats) != 0 || !S_ISREG(fileStats.st_mode))
+    {
+        return gCabInfoErr;
+    }
+
+    /*
+        the tables end where the files do; until they are read, read
+        the most that a CFHEADER can take
+    */
+
+    tablesLen = CABHEADERLEN_MAX;
+    if ((off_t)tablesLen > fileStats.st_size)
+    {
+        tablesLen = (size_t)fileStats.st_size;
+    }
+
+    tables = malloc(CABHEADERLEN_MAX);
+    if (tables == NULL)
+    {
+        return gCabInfoErr;
+    }
+
+    if (cabInfoReadAt(fd, tables, tablesLen, 0, info) != (ssize_t)tablesLen ||
+        tablesLen < CABHEADERLEN ||
+        memcmp(tables, CABMAGIC, 4) != 0)
+    {
+        goto failed;
+    }
+
+    filesOffset = cabInfoGet32(tables + 16);
+    info->numFolders = cabInfoGet16(tables + 26);
+    numFiles = cabInfoGet16(tables + 28);
+    flags = cabInfoGet16(tables + 30);
+    pos = CABHEADERLEN;
+
+    if (flags & CABFLAGRESERVE)
+    {
+        if (tablesLen < pos + CABRESERVELEN)
+        {
+            goto failed;
+        }
+        folderReserve = tables[pos + 2];
+        dataReserve = tables[pos + 3];
+        pos += CABRESERVELEN + cabInfoGet16(tables + pos);
+    }
+
+    /* skip the names of the previous and next cabinets and disks */
+
+    for (s = 0; s < 4; s++)
+    {
+        if ((s < 2 && !(flags & CABFLAGPREV)) ||
+            (s >= 2 && !(flags & CABFLAGNEXT)))
+        {
+            continue;
+        }
+        if (pos >= tablesLen)
+        {
+            goto failed;
+        }
+        strLen = cabInfoSkipString(tables + pos, tablesLen - pos);
+        if (strLen < 0)
+        {
+            goto failed;
+        }
+        pos += (size_t)strLen;
+    }
+
+    /* the files follow the folders, and end before the first CFDATA */
+
+    if (info->numFolders == 0 ||
+        filesOffset < (off_t)(pos + (size_t)info->numFolders *
+                              (CABFOLDERLEN + folderReserve)) ||
+        filesOffset > fileStats.st_size)
+    {
+        goto failed;
+    }
+
+    if (cabInfoGrow(fd,
+                    &tables,
+                    &tablesLen,
+                    (size_t)filesOffset,
+                    info) != gCabInfoOkay)
+    {
+        goto failed;
+    }
+
+    tablesEnd = fileStats.st_size;
+    for (i = 0; i < info->numFolders; i++)
+    {
+        off_t dataOffset = cabInfoGet32(tables + pos +
+                                        i * (CABFOLDERLEN + folderReserve));
+
+        if (dataOffset >= filesOffset && dataOffset < tablesEnd)
+        {
+            tablesEnd = dataOffset;
+        }
+    }
+    if (tablesEnd - filesOffset > CABINFOMAXTABLES)
+    {
+        tablesEnd = filesOffset + CABINFOMAXTABLES;
+    }
+
+    if (cabInfoGrow(fd,
+                    &tables,
+                    &tablesLen,
+                    (size_t)tablesEnd,
+                    info) != gCabInfoOkay)
+    {
+        goto failed;
+    }
+
+    info->folders = calloc(info->numFolders, sizeof(cabFolder_t));
+    if (info->folders == NULL)
+    {
+        goto failed;
+    }
+
+    for (i = 0; i < info->numFolders; i++)
+    {
+        p = tables + pos + i * (CABFOLDERLEN + folderReserve);
+        info->folders[i].blocks = cabInfoGet16(p + 4);
+        info->folders[i].compression =
+            (cabCompress_t)(cabInfoGet16(p + 6) & 0x000F);
+    }
+
+    if ((flags & CABFLAGPREV) != 0)
+    {
+        info->folders[0].continued = 1;
+    }
+    if ((flags & CABFLAGNEXT) != 0)
+    {
+        info->folders[info->numFolders - 1].continued = 1;
+    }
+
+    if (cabInfoReadFiles(tables + filesOffset,
+                         tablesLen - (size_t)filesOffset,
+                         numFiles,
+                         info) != gCabInfoOkay)
+    {
+        goto failed;
+    }
+
+    /* the sizes of the CFDATA blocks, but not the blocks */
+
+    for (i = 0; i < info->numFolders; i++)
+    {
+        p = tables + pos + i * (CABFOLDERLEN + folderReserve);
+        cabInfoReadData(fd,
+                        fileStats.st_size,
+                        (off_t)cabInfoGet32(p),
+                        dataReserve,
+                        &info->folders[i],
+                        info);
+    }
+
+    free(tables);
+
+    return gCabInfoOkay;
+
+failed:
+
+    free(tables);
+    cabInfoFree(info);
+
+    return gCabInfoErr;
+}
+
+/* cabInfoFree - free the folders of a cabinet */
+
+void cabInfoFree(cabInfo_t *info)
+{
+    if (info == NULL)
+    {
+        return;
+    }
+
+    free(info->folders);
+    info->folders = NULL;
+    info->numFolders = 0;
+    info->entries = 0;
+}
+
+/* cabInfoCompressName - get the name of a compression type */
+
+const char *cabInfoCompressName(cabCompress_t compression)
+{
+    switch (compression)
+    {
+        case CabCompressNone:
+            return "none";
+        case CabCompressMSZIP:
+            return "MSZIP";
+        case CabCompressQuantum:
+            return "Quantum";
+        case CabCompressLZX:
+            return "LZX";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,103 @@
+/*
+    cabinfo.h - cabinet folders and sizes from the header tables
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    cabInfoRead() lists a cabinet (.cab) from its header tables alone:
+    the CFHEADER, the CFFOLDERs and the CFFILEs, which are all at the
+    start of the cabinet, and then the 8 byte header of each CFDATA
+    block, which has the block's compressed and uncompressed sizes.
+    The CFDATA blocks themselves are never read, so a cabinet of any
+    size costs the tables plus 8 bytes for every 32KB of data.
+
+    A folder (a separately compressed stream) that is continued from
+    the previous cabinet of a set or into the next one only has the
+    part that is in this cabinet; its sizes are of that part, and its
+    continued flag is set.
+*/
+
+#ifndef qlZipInfo_cabinfo_h
+#define qlZipInfo_cabinfo_h
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/* return codes */
+
+enum
+{
+    gCabInfoErr  = -1,
+    gCabInfoOkay =  0,
+};
+
+/* most bytes of header tables that are read */
+
+#define CABINFOMAXTABLES (16 * 1024 * 1024)
+
+/* compression types, the low 4 bits of a CFFOLDER's typeCompress */
+
+typedef enum
+{
+    CabCompressNone    = 0,
+    CabCompressMSZIP   = 1,
+    CabCompressQuantum = 2,
+    CabCompressLZX     = 3,
+} cabCompress_t;
+
+/* a folder */
+
+typedef struct cabFolder
+{
+    cabCompress_t compression;
+    uint32_t files;
+    uint32_t blocks;
+    uint64_t filesSize;
+    uint64_t compressedSize;
+    uint64_t uncompressedSize;
+    int hasSizes;
+    int continued;
+} cabFolder_t;
+
+/* a cabinet */
+
+typedef struct cabInfo
+{
+    uint32_t entries;
+    uint32_t numFolders;
+    cabFolder_t *folders;
+    uint64_t bytesRead;
+} cabInfo_t;
+
+/* prototypes */
+
+int cabInfoRead(const char *path, cabInfo_t *info);
+int cabInfoReadFd(int fd, cabInfo_t *info);
+void cabInfoFree(cabInfo_t *info);
+const char *cabInfoCompressName(cabCompress_t compression);
+
+#endif /* qlZipInfo_cabinfo_h */
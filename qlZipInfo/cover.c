@@ -0,0 +1,810 @@
+/*
+    cover.c - find and read the cover of a comic book or an ePub
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "archdir.h"
+#include "peek.h"
+#include "cover.h"
+
+/* ePub names */
+
+#define COVERMIMETYPE    "mimetype"
+#define COVEREPUBTYPE    "application/epub+zip"
+#define COVERCONTAINER   "META-INF/container.xml"
+
+/* longest path or attribute value */
+
+#define COVERMAXPATH     4096
+
+/* image file extensions */
+
+static const char *gCoverImageExtensions[] =
+{
+    ".jpg",
+    ".jpeg",
+    ".png",
+    ".gif",
+    ".webp",
+    ".bmp",
+    ".tif",
+    ".tiff",
+    NULL,
+};
+
+/* private functions */
+
+static int coverHasExtension(const char *path, const char *extension);
+static int coverIsImageName(const char *path);
+static int coverHasWord(const char *s, const char *word);
+static int coverIsEPubZip(const char *path);
+static int coverIsImage(const unsigned char *data, size_t len);
+static int coverCompareNames(const char *a, const char *b);
+static char *coverReadEntry(peek_t *peek,
+                            const peekEntry_t *entry,
+                            size_t maxLen,
+                            size_t *len);
+static const char *coverNextTag(const char *p,
+                                const char *name,
+                                const char **end);
+static int coverGetAttr(const char *tag,
+                        const char *end,
+                        const char *name,
+                        char *value,
+                        size_t valueLen);
+static void coverResolve(const char *base,
+                         const char *href,
+                         char *path,
+                         size_t pathLen);
+static const peekEntry_t *coverFindEPub(peek_t *peek);
+static const peekEntry_t *coverFindComic(const peek_t *peek);
+
+/* coverHasExtension - check if a path ends in an extension, ignoring case */
+
+static int coverHasExtension(const char *path, const char *extension)
+{
+    size_t pathLen = strlen(path);
+    size_t extensionLen = strlen(extension);
+
+    return (pathLen > extensionLen &&
+            strcasecmp(path + pathLen - extensionLen, extension) == 0);
+}
+
+/* coverHasWord - check if a string has a word in it, ignoring case */
+
+static int coverHasWord(const char *s, const char *word)
+{
+    size_t wordLen = strlen(word);
+
+    for (; *s != '\0'; s++)
+    {
+        if (strncasecmp(s, word, wordLen) == 0)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+    coverIsImageName - check if a path is an image's, and isn't hidden
+                       or in __MACOSX
+*/
+
+static int coverIsImageName(const char *path)
+{
+    const char *p = NULL;
+    int i = 0;
+
+    for (p = path; p != NULL; p = strchr(p, '/'))
+    {
+        if (*p == '/')
+        {
+            p++;
+        }
+        if (*p == '.' || strncmp(p, "__MACOSX/", 9) == 0)
+        {
+            return 0;
+        }
+    }
+
+    for (i = 0; gCoverImageExtensions[i] != NULL; i++)
+    {
+        if (coverHasExtension(path, gCoverImageExtensions[i]))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* coverIsImage - check the signature of an image that ImageIO reads */
+
+static int coverIsImage(const unsigned char *data, size_t len)
+{
+    if (len < 12)
+    {
+        return 0;
+    }
+
+    return ((data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF) ||
+            memcmp(data, "\211PNG\r\n\032\n", 8) == 0 ||
+            memcmp(data, "GIF8", 4) == 0 ||
+            (memcmp(data, "RIFF", 4) == 0 &&
+             memcmp(data + 8, "WEBP", 4) == 0) ||
+            (data[0] == 'B' && data[1] == 'M') ||
+            memcmp(data, "II*\0", 4) == 0 ||
+            memcmp(data, "MM\0*", 4) == 0);
+}
+
+/*
+    coverCompareNames - compare paths in natural order: runs of digits
+                        by their value, and everything else ignoring
+                        case
+*/
+
+static int coverCompareNames(const char *a, const char *b)
+{
+    const char *aStart = NULL;
+    const char *bStart = NULL;
+    size_t aLen = 0;
+    size_t bLen = 0;
+    int diff = 0;
+
+    while (*a != '\0' && *b != '\0')
+    {
+        if (isdigit((unsigned char)*a) && isdigit((unsigned char)*b))
+        {
+            while (*a == '0' && isdigit((unsigned char)a[1]))
+            {
+                a++;
+            }
+            while (*b == '0' && isdigit((unsigned char)b[1]))
+            {
+                b++;
+            }
+
+            for (aStart = a; isdigit((unsigned char)*a); a++)
+            {
+            }
+            for (bStart = b; isdigit((unsigned char)*b); b++)
+            {
+            }
+
+            aLen = (size_t)(a - aStart);
+            bLen = (size_t)(b - bStart);
+            if (aLen != bLen)
+            {
+                return (aLen < bLen ? -1 : 1);
+            }
+            diff = memcmp(aStart, bStart, aLen);
+            if (diff != 0)
+            {
+                return diff;
+            }
+            continue;
+        }
+
+        diff = tolower((unsigned char)*a) - tolower((unsigned char)*b);
+        if (diff != 0)
+        {
+            return diff;
+        }
+        a++;
+        b++;
+    }
+
+    return (unsigned char)*a - (unsigned char)*b;
+}
+
+/*
+    coverReadEntry - read a whole entry of up to maxLen bytes, NUL
+                     terminated; returns NULL if it is larger or can't
+                     be read
+*/
+
+static char *coverReadEntry(peek_t *peek,
+                            const peekEntry_t *entry,
+                            size_t maxLen,
+                            size_t *len)
+{
+    char *buf = NULL;
+    ssize_t bytesRead = 0;
+
+    if (entry == NULL || entry->isDir || entry->size > maxLen)
+    {
+        return NULL;
+    }
+
+    buf = malloc((size_t)entry->size + 1);
+    if (buf == NULL)
+    {
+        return NULL;
+    }
+
+    bytesRead = peekRead(peek, entry, buf, (size_t)entry->size);
+    if (bytesRead < 0 || (uint64_t)bytesRead != entry->size)
+    {
+        free(buf);
+        return NULL;
+    }
+
+    buf[bytesRead] = '\0';
+    if (len != NULL)
+    {
+        *len = (size_t)bytesRead;
+    }
+
+    return buf;
+}
+
+/*
+    coverNextTag - find the next start tag with the given name, with
+                   or without a namespace prefix; *end is set to its
+                   closing '>'
+*/
+
+static const char *coverNextTag(const char *p,
+                                const char *name,
+                                const char **end)
+{
+    const char *tag = NULL;
+    const char *colon = NULL;
+    size_t nameLen = strlen(name);
+    size_t tagLen = 0;
+
+    while ((p = strchr(p, '<')) != NULL)
+    {
+        tag = p + 1;
+        tagLen = strcspn(tag, " \t\r\n/>");
+        colon = memchr(tag, ':', tagLen);
+        if (colon != NULL)
+        {
+            tagLen -= (size_t)(colon + 1 - tag);
+            tag = colon + 1;
+        }
+
+        *end = strchr(tag, '>');
+        if (*end == NULL)
+        {
+            return NULL;
+        }
+
+        if (tagLen == nameLen && strncasecmp(tag, name, nameLen) == 0)
+        {
+            return p;
+        }
+
+        p = *end;
+    }
+
+    return NULL;
+}
+
+/*
+    coverGetAttr - get an attribute's value from a tag, decoding &amp;
+                   and the like; returns 1 if the tag has it
+*/
+
+static int coverGetAttr(const char *tag,
+                        const char *end,
+                        const char *name,
+                        char *value,
+                        size_t valueLen)
+{
+    const char *p = NULL;
+    const char *v = NULL;
+    size_t nameLen = strlen(name);
+    size_t len = 0;
+    char quote = 0;
+
+    for (p = tag; p + nameLen + 2 < end; p++)
+    {
+        if (!isspace((unsigned char)*p) ||
+            strncmp(p + 1, name, nameLen) != 0)
+        {
+            continue;
+        }
+
+        v = p + 1 + nameLen;
+        while (v < end && isspace((unsigned char)*v))
+        {
+            v++;
+        }
+        if (v >= end || *v != '=')
+        {
+            continue;
+        }
+        v++;
+        while (v < end && isspace((unsigned char)*v))
+        {
+            v++;
+        }
+        if (v >= end || (*v != '"' && *v != '\''))
+        {
+            continue;
+        }
+        quote = *v++;
+
+        for (len = 0; v < end && *v != quote && len + 1 < valueLen; v++)
+        {
+            if (*v == '&')
+            {
+                if (strncmp(v, "&amp;", 5) == 0)
+                {
+                    value[len++] = '&';
+                    v += 4;
+                    continue;
+                }
+                if (strncmp(v, "&apos;", 6) == 0)
+                {
+                    value[len++] = '\'';
+                    v += 5;
+                    continue;
+                }
+                if (strncmp(v, "&quot;", 6) == 0)
+                {
+                    value[len++] = '"';
+                    v += 5;
+                    continue;
+                }
+            }
+            value[len++] = *v;
+        }
+        value[len] = '\0';
+
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+    coverResolve - resolve an href, which is relative to the package
+                   document and URL encoded, to a path in the archive
+*/
+
+static void coverResolve(const char *base,
+                         const char *href,
+                         char *path,
+                         size_t pathLen)
+{
+    const char *slash = strrchr(base, '/');
+    char *segment = NULL;
+    char *p = NULL;
+    size_t len = 0;
+    unsigned int c = 0;
+
+    /* the href is relative to the package document's folder */
+
+    if (slash != NULL && href[0] != '/')
+    {
+        len = (size_t)(slash + 1 - base);
+        if (len >= pathLen)
+        {
+            len = pathLen - 1;
+        }
+        memcpy(path, base, len);
+    }
+
+    for (; *href != '\0' && *href != '#' && *href != '?' &&
+           len + 1 < pathLen; href++)
+    {
+        if (*href == '%' && isxdigit((unsigned char)href[1]) &&
+            isxdigit((unsigned char)href[2]) &&
+            sscanf(href + 1, "%2x", &c) == 1)
+        {
+            path[len++] = (char)c;
+            href += 2;
+            continue;
+        }
+        path[len++] = *href;
+    }
+    path[len] = '\0';
+
+    /* drop the "." segments, and the segments before ".." */
+
+    for (p = path; *p != '\0'; )
+    {
+        if (strncmp(p, "./", 2) == 0)
+        {
+            memmove(p, p + 2, strlen(p + 2) + 1);
+        }
+        else if (strncmp(p, "../", 3) == 0)
+        {
+            segment = p;
+            if (p > path)
+            {
+                for (segment = p - 1;
+                     segment > path && segment[-1] != '/';
+                     segment--)
+                {
+                }
+            }
+            memmove(segment, p + 3, strlen(p + 3) + 1);
+            p = segment;
+        }
+        else
+        {
+            p = strchr(p, '/');
+            if (p == NULL)
+            {
+                break;
+            }
+            p++;
+        }
+    }
+}
+
+/*
+    coverFindEPub - find an ePub's cover from the manifest of its
+                    package document
+*/
+
+static const peekEntry_t *coverFindEPub(peek_t *peek)
+{
+    const peekEntry_t *entry = NULL;
+    const peekEntry_t *cover = NULL;
+    const char *tag = NULL;
+    const char *end = NULL;
+    char *container = NULL;
+    char *opf = NULL;
+    char opfPath[COVERMAXPATH];
+    char coverId[COVERMAXPATH];
+    char value[COVERMAXPATH];
+    char href[COVERMAXPATH];
+    char path[COVERMAXPATH];
+    int pass = 0;
+
+    container = coverReadEntry(peek,
+                               peekFind(peek, COVERCONTAINER),
+                               COVERMAXDOCUMENT,
+                               NULL);
+    if (container == NULL)
+    {
+        return NULL;
+    }
+
+    opfPath[0] = '\0';
+    tag = coverNextTag(container, "rootfile", &end);
+    if (tag != NULL)
+    {
+        coverGetAttr(tag, end, "full-path", opfPath, sizeof(opfPath));
+    }
+    free(container);
+
+    if (opfPath[0] == '\0')
+    {
+        return NULL;
+    }
+
+    opf = coverReadEntry(peek,
+                         peekFind(peek, opfPath),
+                         COVERMAXDOCUMENT,
+                         NULL);
+    if (opf == NULL)
+    {
+        return NULL;
+    }
+
+    /* EPUB 2 names the cover's manifest item in a meta element */
+
+    coverId[0] = '\0';
+    for (tag = opf; (tag = coverNextTag(tag, "meta", &end)) != NULL;
+         tag = end)
+    {
+        if (coverGetAttr(tag, end, "name", value, sizeof(value)) &&
+            strcmp(value, "cover") == 0 &&
+            coverGetAttr(tag, end, "content", coverId, sizeof(coverId)))
+        {
+            break;
+        }
+        coverId[0] = '\0';
+    }
+
+    /*
+        look for the item with the cover-image property, then for the
+        item that the meta element names, and then for an image with
+        "cover" in its id or href
+    */
+
+    for (pass = 0; pass < 3 && cover == NULL; pass++)
+    {
+        for (tag = opf;
+             cover == NULL &&
+             (tag = coverNextTag(tag, "item", &end)) != NULL;
+             tag = end)
+        {
+            if (!coverGetAttr(tag, end, "href", href, sizeof(href)))
+            {
+                continue;
+            }
+
+            if (pass == 0)
+            {
+                if (!coverGetAttr(tag, end, "properties",
+                                  value, sizeof(value)) ||
+                    strstr(value, "cover-image") == NULL)
+                {
+                    continue;
+                }
+            }
+            else if (pass == 1)
+            {
+                if (coverId[0] == '\0' ||
+                    !coverGetAttr(tag, end, "id", value, sizeof(value)) ||
+                    strcmp(value, coverId) != 0)
+                {
+                    continue;
+                }
+            }
+            else
+            {
+                if (!coverGetAttr(tag, end, "media-type",
+                                  value, sizeof(value)) ||
+                    strncmp(value, "image/", 6) != 0)
+                {
+                    continue;
+                }
+                if (!coverHasWord(href, "cover") &&
+                    (!coverGetAttr(tag, end, "id", value, sizeof(value)) ||
+                     !coverHasWord(value, "cover")))
+                {
+                    continue;
+                }
+            }
+
+            coverResolve(opfPath, href, path, sizeof(path));
+            entry = peekFind(peek, path);
+            if (entry != NULL && !entry->isDir)
+            {
+                cover = entry;
+            }
+        }
+    }
+
+    free(opf);
+
+    return cover;
+}
+
+/*
+    coverIsEPubZip - check whether the .zip at path is an ePub: the
+                     first entry of an ePub is a stored "mimetype" of
+                     application/epub+zip, so only its local header
+                     is read, not the central directory
+*/
+
+static int coverIsEPubZip(const char *path)
+{
+    unsigned char header[ARCHDIRZIPLOCALLEN + sizeof(COVERMIMETYPE) - 1];
+    char type[sizeof(COVEREPUBTYPE) - 1];
+    off_t dataOffset = 0;
+    int fd = -1;
+    int ret = 0;
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return 0;
+    }
+
+    if (archDirReadAt(fd, header, sizeof(header), 0) ==
+            (ssize_t)sizeof(header) &&
+        memcmp(header, ARCHDIRZIPLOCALSIG, 4) == 0 &&
+        archDirGet16(header + 8) == 0 &&
+        archDirGet16(header + 26) == sizeof(COVERMIMETYPE) - 1 &&
+        memcmp(header + ARCHDIRZIPLOCALLEN,
+               COVERMIMETYPE,
+               sizeof(COVERMIMETYPE) - 1) == 0)
+    {
+        dataOffset = ARCHDIRZIPLOCALLEN +
+                     (off_t)(sizeof(COVERMIMETYPE) - 1) +
+                     archDirGet16(header + 28);
+        if (archDirReadAt(fd, type, sizeof(type), dataOffset) ==
+                (ssize_t)sizeof(type) &&
+            memcmp(type, COVEREPUBTYPE, sizeof(type)) == 0)
+        {
+            ret = 1;
+        }
+    }
+
+    close(fd);
+
+    return ret;
+}
+
+/* coverFindComic - find a comic's first page */
+
+static const peekEntry_t *coverFindComic(const peek_t *peek)
+{
+    const peekEntry_t *cover = NULL;
+    const peekEntry_t *entry = NULL;
+    uint32_t i = 0;
+
+    for (i = 0; i < peek->numEntries; i++)
+    {
+        entry = &peek->entries[i];
+        if (entry->isDir ||
+            entry->method == PeekMethodUnsupported ||
+            entry->size == 0 ||
+            !coverIsImageName(entry->name))
+        {
+            continue;
+        }
+
+        if (cover == NULL || coverCompareNames(entry->name, cover->name) < 0)
+        {
+            cover = entry;
+        }
+    }
+
+    return cover;
+}
+
+/* public functions */
+
+/*
+    coverRead - find the cover of the comic book or ePub at path and
+                read it; returns gCoverErr if the archive isn't a
+                comic book or an ePub, or its cover can't be found or
+                read
+*/
+
+int coverRead(const char *path, cover_t *cover)
+{
+    peek_t peek;
+    const peekEntry_t *entry = NULL;
+    char *mimetype = NULL;
+    ssize_t bytesRead = 0;
+    int ret = gCoverErr;
+
+    if (path == NULL || cover == NULL)
+    {
+        return gCoverErr;
+    }
+
+    memset(cover, 0, sizeof(cover_t));
+
+    /*
+        A plain .zip is only indexed if its first entry says it is an
+        ePub, so that the thumbnails of other zips stay as fast as
+        reading their summary
+    */
+
+    if (!coverHasExtension(path, ".cbz") &&
+        !coverHasExtension(path, ".epub") &&
+        !(coverHasExtension(path, ".zip") && coverIsEPubZip(path)))
+    {
+        return gCoverErr;
+    }
+
+    if (peekOpen(path, &peek) != gPeekOkay)
+    {
+        return gCoverErr;
+    }
+
+    if (peek.format != PeekFormatZip)
+    {
+        peekClose(&peek);
+        return gCoverErr;
+    }
+
+    cover->numEntries = peek.numEntries;
+
+    /* an ePub says so in its first entry, whatever it's called */
+
+    mimetype = coverReadEntry(&peek,
+                              peekFind(&peek, COVERMIMETYPE),
+                              64,
+                              NULL);
+    if (mimetype != NULL &&
+        strncmp(mimetype, COVEREPUBTYPE, strlen(COVEREPUBTYPE)) == 0)
+    {
+        cover->kind = CoverKindEPub;
+    }
+    else if (coverHasExtension(path, ".epub"))
+    {
+        cover->kind = CoverKindEPub;
+    }
+    else if (coverHasExtension(path, ".cbz"))
+    {
+        cover->kind = CoverKindComic;
+    }
+    free(mimetype);
+
+    if (cover->kind == CoverKindEPub)
+    {
+        entry = coverFindEPub(&peek);
+    }
+    else if (cover->kind == CoverKindComic)
+    {
+        entry = coverFindComic(&peek);
+    }
+
+    if (entry == NULL || entry->size == 0 || entry->size > COVERMAXSIZE)
+    {
+        goto done;
+    }
+
+    cover->name = strdup(entry->name);
+    cover->data = malloc((size_t)entry->size);
+    if (cover->name == NULL || cover->data == NULL)
+    {
+        goto done;
+    }
+
+    bytesRead = peekRead(&peek, entry, cover->data, (size_t)entry->size);
+    if (bytesRead < 0 || (uint64_t)bytesRead != entry->size ||
+        !coverIsImage(cover->data, (size_t)bytesRead))
+    {
+        goto done;
+    }
+    cover->len = (size_t)bytesRead;
+
+    ret = gCoverOkay;
+
+done:
+    cover->bytesRead = peek.bytesRead;
+    cover->bytesDecoded = peek.bytesDecoded;
+    peekClose(&peek);
+
+    if (ret != gCoverOkay)
+    {
+        free(cover->name);
+        free(cover->data);
+        cover->name = NULL;
+        cover->data = NULL;
+        cover->len = 0;
+    }
+
+    return ret;
+}
+
+/* coverFree - release a cover */
+
+void coverFree(cover_t *cover)
+{
+    if (cover == NULL)
+    {
+        return;
+    }
+
+    free(cover->name);
+    free(cover->data);
+    memset(cover, 0, sizeof(cover_t));
+}
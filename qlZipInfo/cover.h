@@ -0,0 +1,105 @@
+/*
+    cover.h - find and read the cover of a comic book or an ePub
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    Comic books (.cbz) and ePubs are zip archives, and their cover is
+    a better thumbnail than their format and size.  coverRead() finds
+    the cover through the zip's central directory (see peek.h), and
+    reads and decodes only the cover's entry, and the few small
+    entries that name it, so it takes about the same time however
+    large the archive is:
+
+        - ePub (a "mimetype" of application/epub+zip, or a .epub
+          file): the package document (.opf) that
+          META-INF/container.xml names, and in its manifest the item
+          with the "cover-image" property (EPUB 3), or else the item
+          that <meta name="cover"> names (EPUB 2), or else the first
+          image item with "cover" in its id or href
+        - .cbz: the first image, in natural order (page2.jpg comes
+          before page10.jpg), not counting hidden files and
+          __MACOSX
+
+    The cover is returned as it is stored (JPEG, PNG, GIF, WebP, BMP
+    or TIFF) for ImageIO to decode, if it is no larger than
+    COVERMAXSIZE.  Only .cbz and .epub files, and .zip files whose
+    first entry is an ePub's stored "mimetype" (the only part of them
+    that is read otherwise), are opened, and other archives don't
+    have a cover.
+*/
+
+#ifndef qlZipInfo_cover_h
+#define qlZipInfo_cover_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* return codes */
+
+enum
+{
+    gCoverErr  = -1,
+    gCoverOkay =  0,
+};
+
+/* largest cover that is read */
+
+#define COVERMAXSIZE     (32 * 1024 * 1024)
+
+/* largest package document (and container.xml) that is read */
+
+#define COVERMAXDOCUMENT (4 * 1024 * 1024)
+
+/* kinds of archive with a cover */
+
+typedef enum
+{
+    CoverKindNone = 0,
+    CoverKindComic,
+    CoverKindEPub,
+} coverKind_t;
+
+/* a cover */
+
+typedef struct cover
+{
+    coverKind_t kind;
+    char *name;
+    unsigned char *data;
+    size_t len;
+    uint32_t numEntries;
+    uint64_t bytesRead;
+    uint64_t bytesDecoded;
+} cover_t;
+
+/* prototypes */
+
+int coverRead(const char *path, cover_t *cover);
+void coverFree(cover_t *cover);
+
+#endif /* qlZipInfo_cover_h */
@@ -0,0 +1,879 @@
+/*
+    extract.c - extract a zip or 7z archive with several threads
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+
+#include "summary.h"
+#include "scan.h"
+#include "extract.h"
+
+/* what is done with each entry */
+
+typedef enum
+{
+    ExtractKindSkip = 0,
+    ExtractKindFile,
+    ExtractKindDir,
+    ExtractKindLink,
+} extractKind_t;
+
+/* a work unit, the entries first to last - 1 */
+
+typedef struct extractUnit
+{
+    uint64_t first;
+    uint64_t last;
+} extractUnit_t;
+
+typedef struct extractShared extractShared_t;
+
+/* a worker, with its own reader and writer */
+
+typedef struct extractWorker
+{
+    extractShared_t *shared;
+    pthread_t thread;
+    int started;
+    struct archive *reader;
+    struct archive *writer;
+    struct archive_entry *entry;
+    uint64_t next;
+    uint64_t bytes;
+    uint64_t failed;
+} extractWorker_t;
+
+/* state shared by the workers */
+
+struct extractShared
+{
+    const char *archive;
+    int reuseReader;
+    unsigned char *kinds;
+    extractUnit_t *units;
+    unsigned int numUnits;
+    unsigned int nextUnit;
+
+    /*
+        archive_write_header() sets the process' umask to 0 for a
+        moment, so headers are written one at a time
+    */
+
+    pthread_mutex_t headerLock;
+};
+
+/* private function prototypes */
+
+static struct archive *extractNewReader(const char *path);
+static struct archive *extractNewWriter(int flags);
+static int extractCopyEntry(struct archive *reader,
+                            struct archive *writer,
+                            struct archive_entry *entry,
+                            pthread_mutex_t *headerLock,
+                            uint64_t *bytes);
+static int extractMakeParent(struct archive *writer,
+                             struct archive_entry *dirEntry,
+                             const char *path,
+                             char *lastParent);
+static int extractPlan(extractShared_t *shared,
+                       struct archive *dirWriter,
+                       uint64_t *numEntries,
+                       extractStats_t *stats);
+static unsigned int extractSplit(extractShared_t *shared,
+                                 const uint64_t *weights,
+                                 uint64_t numEntries,
+                                 unsigned int numUnits);
+static int extractUnit(extractWorker_t *worker, const extractUnit_t *unit);
+static void *extractWorkerMain(void *arg);
+static int extractLinks(extractShared_t *shared,
+                        struct archive *dirWriter,
+                        uint64_t numEntries,
+                        uint64_t *bytes);
+
+/* private functions */
+
+/*
+    extractNewReader - open the archive at path with the preview's
+                       filters, formats and limits
+*/
+
+static struct archive *extractNewReader(const char *path)
+{
+    struct archive *a = NULL;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return NULL;
+    }
+
+    archive_read_support_filter_compress(a);
+    archive_read_support_filter_gzip(a);
+    archive_read_support_filter_bzip2(a);
+    archive_read_support_filter_xz(a);
+    archive_read_support_filter_uu(a);
+    archive_read_support_filter_rpm(a);
+    archive_read_support_filter_pbzx(a);
+    archive_read_support_filter_udif(a);
+
+    archive_read_support_format_cpio(a);
+    archive_read_support_format_tar(a);
+    archive_read_support_format_zip(a);
+    archive_read_support_format_xar(a);
+    archive_read_support_format_iso9660(a);
+    archive_read_support_format_rar(a);
+    archive_read_support_format_rar5(a);
+    archive_read_support_format_lha(a);
+    archive_read_support_format_ar(a);
+    archive_read_support_format_7zip(a);
+    archive_read_support_format_cab(a);
+
+    archive_read_set_limit(a, ARCHIVE_READ_LIMIT_ENTRIES, SCANLIMITENTRIES);
+    archive_read_set_limit(a,
+                           ARCHIVE_READ_LIMIT_HEADER_BYTES,
+                           SCANLIMITHEADERBYTES);
+    archive_read_set_limit(a, ARCHIVE_READ_LIMIT_DEPTH, SCANLIMITDEPTH);
+    archive_read_set_limit(a, ARCHIVE_READ_LIMIT_MEMORY, SCANLIMITMEMORY);
+
+    if (archive_read_open_filename(a, path, EXTRACTBLOCKSIZE) != ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "qlZipInfo: ERROR: can't open '%s': %s\n",
+                path,
+                archive_error_string(a));
+        archive_read_free(a);
+        return NULL;
+    }
+
+    return a;
+}
+
+/* extractNewWriter - create an archive_write_disk with flags */
+
+static struct archive *extractNewWriter(int flags)
+{
+    struct archive *writer = NULL;
+
+    writer = archive_write_disk_new();
+    if (writer == NULL)
+    {
+        return NULL;
+    }
+
+    if (archive_write_disk_set_options(writer, flags) != ARCHIVE_OK)
+    {
+        archive_write_free(writer);
+        return NULL;
+    }
+
+    return writer;
+}
+
+/*
+    extractCopyEntry - write the reader's current entry, and its
+                       data, with writer
+*/
+
+static int extractCopyEntry(struct archive *reader,
+                            struct archive *writer,
+                            struct archive_entry *entry,
+                            pthread_mutex_t *headerLock,
+                            uint64_t *bytes)
+{
+    const void *buf = NULL;
+    size_t size = 0;
+    la_int64_t offset = 0;
+    int r = ARCHIVE_OK;
+
+    if (headerLock != NULL)
+    {
+        pthread_mutex_lock(headerLock);
+    }
+    r = archive_write_header(writer, entry);
+    if (headerLock != NULL)
+    {
+        pthread_mutex_unlock(headerLock);
+    }
+
+    if (r < ARCHIVE_WARN)
+    {
+        fprintf(stderr,
+                "qlZipInfo: ERROR: can't create '%s': %s\n",
+                archive_entry_pathname(entry),
+                archive_error_string(writer));
+        return gExtractErr;
+    }
+
+    if (archive_entry_size_is_set(entry) == 0 ||
+        archive_entry_size(entry) > 0)
+    {
+        for (;;)
+        {
+            r = archive_read_data_block(reader, &buf, &size, &offset);
+            if (r == ARCHIVE_EOF)
+            {
+                break;
+            }
+
+            if (r < ARCHIVE_WARN ||
+                archive_write_data_block(writer, buf, size, offset) <
+                    ARCHIVE_WARN)
+            {
+                fprintf(stderr,
+                        "qlZipInfo: ERROR: can't extract '%s': %s\n",
+                        archive_entry_pathname(entry),
+                        (r < ARCHIVE_WARN ?
+                         archive_error_string(reader) :
+                         archive_error_string(writer)));
+                archive_write_finish_entry(writer);
+                return gExtractErr;
+            }
+
+            *bytes += size;
+        }
+    }
+
+    return (archive_write_finish_entry(writer) < ARCHIVE_WARN ?
+            gExtractErr : gExtractOkay);
+}
+
+/*
+    extractMakeParent - create the folder that path is in, if it isn't
+                        lastParent (the last folder that was created)
+*/
+
+static int extractMakeParent(struct archive *writer,
+                             struct archive_entry *dirEntry,
+                             const char *path,
+                             char *lastParent)
+{
+    const char *slash = NULL;
+    size_t len = 0;
+
+    slash = strrchr(path, '/');
+    if (slash == NULL || slash == path)
+    {
+        return gExtractOkay;
+    }
+
+    len = (size_t)(slash - path);
+    if (len >= PATH_MAX)
+    {
+        return gExtractErr;
+    }
+
+    if (strncmp(lastParent, path, len) == 0 && lastParent[len] == '\0')
+    {
+        return gExtractOkay;
+    }
+
+    memcpy(lastParent, path, len);
+    lastParent[len] = '\0';
+
+    /*
+        the folder is written like an archive entry, so that the
+        writer's checks for "..", absolute paths and symbolic links
+        apply to it, and its times and permissions are left alone
+    */
+
+    archive_entry_clear(dirEntry);
+    archive_entry_set_pathname(dirEntry, lastParent);
+    archive_entry_set_filetype(dirEntry, AE_IFDIR);
+    archive_entry_set_perm(dirEntry, 0755);
+
+    if (archive_write_header(writer, dirEntry) < ARCHIVE_WARN)
+    {
+        lastParent[0] = '\0';
+        return gExtractErr;
+    }
+
+    archive_write_finish_entry(writer);
+
+    return gExtractOkay;
+}
+
+/*
+    extractPlan - list the archive, noting what is done with each
+                  entry, create its folders, and split its files into
+                  work units
+*/
+
+static int extractPlan(extractShared_t *shared,
+                       struct archive *dirWriter,
+                       uint64_t *numEntries,
+                       extractStats_t *stats)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    struct archive_entry *dirEntry = NULL;
+    char lastParent[PATH_MAX];
+    const char *path = NULL;
+    unsigned char *kinds = NULL;
+    uint64_t *weights = NULL;
+    uint64_t capacity = 0;
+    uint64_t n = 0;
+    int rc = gExtractOkay;
+    int r = ARCHIVE_OK;
+
+    lastParent[0] = '\0';
+
+    a = extractNewReader(shared->archive);
+    entry = archive_entry_new();
+    dirEntry = archive_entry_new();
+    if (a == NULL || entry == NULL || dirEntry == NULL)
+    {
+        rc = gExtractErr;
+        goto done;
+    }
+
+    for (;;)
+    {
+        r = archive_read_next_header2(a, entry);
+        if (r == ARCHIVE_EOF)
+        {
+            break;
+        }
+
+        if (r < ARCHIVE_WARN)
+        {
+            fprintf(stderr,
+                    "qlZipInfo: ERROR: can't read '%s': %s\n",
+                    shared->archive,
+                    archive_error_string(a));
+            rc = gExtractErr;
+            break;
+        }
+
+        if (n == capacity)
+        {
+            capacity = (capacity == 0 ? 1024 : capacity * 2);
+            kinds = realloc(shared->kinds, (size_t)capacity);
+            if (kinds == NULL)
+            {
+                rc = gExtractErr;
+                break;
+            }
+            shared->kinds = kinds;
+            weights = realloc(weights, (size_t)capacity * sizeof(uint64_t));
+            if (weights == NULL)
+            {
+                rc = gExtractErr;
+                break;
+            }
+        }
+
+        path = archive_entry_pathname(entry);
+        weights[n] = 0;
+
+        if (path == NULL)
+        {
+            shared->kinds[n] = ExtractKindSkip;
+        }
+        else if (archive_entry_filetype(entry) == AE_IFDIR)
+        {
+            /* the archive's folders are created in order, here */
+
+            shared->kinds[n] = ExtractKindDir;
+            stats->dirs++;
+            if (archive_write_header(dirWriter, entry) < ARCHIVE_WARN)
+            {
+                fprintf(stderr,
+                        "qlZipInfo: ERROR: can't create '%s': %s\n",
+                        path,
+                        archive_error_string(dirWriter));
+                stats->failed++;
+            }
+            archive_write_finish_entry(dirWriter);
+        }
+        else if (archive_entry_filetype(entry) == AE_IFREG &&
+                 archive_entry_hardlink(entry) == NULL)
+        {
+            shared->kinds[n] = ExtractKindFile;
+            stats->files++;
+            weights[n] = EXTRACTENTRYCOST;
+            if (archive_entry_size_is_set(entry) &&
+                archive_entry_size(entry) > 0)
+            {
+                weights[n] += (uint64_t)archive_entry_size(entry);
+            }
+            extractMakeParent(dirWriter, dirEntry, path, lastParent);
+        }
+        else
+        {
+            /* links, devices, etc. are made after the files */
+
+            shared->kinds[n] = ExtractKindLink;
+            stats->links++;
+        }
+
+        n++;
+    }
+
+    *numEntries = n;
+    if (rc == gExtractOkay)
+    {
+        shared->numUnits = extractSplit(shared,
+                                        weights,
+                                        n,
+                                        shared->numUnits);
+    }
+
+done:
+
+    free(weights);
+    if (dirEntry != NULL)
+    {
+        archive_entry_free(dirEntry);
+    }
+    if (entry != NULL)
+    {
+        archive_entry_free(entry);
+    }
+    if (a != NULL)
+    {
+        archive_read_free(a);
+    }
+
+    return rc;
+}
+
+/*
+    extractSplit - split the entries into at most numUnits contiguous
+                   units of about the same weight; returns the number
+                   of units
+*/
+
+static unsigned int extractSplit(extractShared_t *shared,
+                                 const uint64_t *weights,
+                                 uint64_t numEntries,
+                                 unsigned int numUnits)
+{
+    uint64_t total = 0;
+    uint64_t target = 0;
+    uint64_t sum = 0;
+    uint64_t i = 0;
+    unsigned int u = 0;
+
+    for (i = 0; i < numEntries; i++)
+    {
+        total += weights[i];
+    }
+
+    shared->units = calloc(numUnits, sizeof(extractUnit_t));
+    if (shared->units == NULL || total == 0)
+    {
+        return 0;
+    }
+
+    /* close a unit once it has its share of what is left */
+
+    target = (total + numUnits - 1) / numUnits;
+    shared->units[0].first = 0;
+
+    for (i = 0; i < numEntries; i++)
+    {
+        sum += weights[i];
+        if (sum >= target && u + 1 < numUnits)
+        {
+            shared->units[u].last = i + 1;
+            total -= sum;
+            sum = 0;
+            u++;
+            shared->units[u].first = i + 1;
+            target = (total + (numUnits - u) - 1) / (numUnits - u);
+        }
+    }
+
+    shared->units[u].last = numEntries;
+
+    return u + 1;
+}
+
+/* extractUnit - extract the files in a work unit */
+
+static int extractUnit(extractWorker_t *worker, const extractUnit_t *unit)
+{
+    extractShared_t *shared = worker->shared;
+    int rc = gExtractOkay;
+    int r = ARCHIVE_OK;
+
+    /* a reader can only go forward */
+
+    if (worker->reader != NULL &&
+        (shared->reuseReader == 0 || worker->next > unit->first))
+    {
+        archive_read_free(worker->reader);
+        worker->reader = NULL;
+    }
+
+    if (worker->reader == NULL)
+    {
+        worker->reader = extractNewReader(shared->archive);
+        worker->next = 0;
+        if (worker->reader == NULL)
+        {
+            return gExtractErr;
+        }
+    }
+
+    /* skip to the unit, then extract its files */
+
+    while (worker->next < unit->last)
+    {
+        r = archive_read_next_header2(worker->reader, worker->entry);
+        if (r == ARCHIVE_EOF || r < ARCHIVE_WARN)
+        {
+            rc = gExtractErr;
+            break;
+        }
+
+        if (worker->next >= unit->first &&
+            shared->kinds[worker->next] == ExtractKindFile &&
+            extractCopyEntry(worker->reader,
+                             worker->writer,
+                             worker->entry,
+                             &(shared->headerLock),
+                             &(worker->bytes)) != gExtractOkay)
+        {
+            worker->failed++;
+        }
+
+        worker->next++;
+    }
+
+    return rc;
+}
+
+/* extractWorkerMain - extract work units until there are none left */
+
+static void *extractWorkerMain(void *arg)
+{
+    extractWorker_t *worker = (extractWorker_t *)arg;
+    extractShared_t *shared = worker->shared;
+    unsigned int u = 0;
+
+    for (;;)
+    {
+        u = __atomic_fetch_add(&(shared->nextUnit), 1, __ATOMIC_SEQ_CST);
+        if (u >= shared->numUnits)
+        {
+            break;
+        }
+
+        if (extractUnit(worker, &(shared->units[u])) != gExtractOkay)
+        {
+            worker->failed++;
+        }
+    }
+
+    if (worker->reader != NULL)
+    {
+        archive_read_free(worker->reader);
+        worker->reader = NULL;
+    }
+
+    return NULL;
+}
+
+/* extractLinks - make the links, etc., once the files are written */
+
+static int extractLinks(extractShared_t *shared,
+                        struct archive *dirWriter,
+                        uint64_t numEntries,
+                        uint64_t *bytes)
+{
+    struct archive *a = NULL;
+    struct archive_entry *entry = NULL;
+    uint64_t n = 0;
+    int failed = 0;
+
+    a = extractNewReader(shared->archive);
+    entry = archive_entry_new();
+    if (a == NULL || entry == NULL)
+    {
+        if (entry != NULL)
+        {
+            archive_entry_free(entry);
+        }
+        if (a != NULL)
+        {
+            archive_read_free(a);
+        }
+        return -1;
+    }
+
+    for (n = 0; n < numEntries; n++)
+    {
+        if (archive_read_next_header2(a, entry) < ARCHIVE_WARN)
+        {
+            failed++;
+            break;
+        }
+
+        if (shared->kinds[n] == ExtractKindLink &&
+            extractCopyEntry(a, dirWriter, entry, NULL, bytes) !=
+                gExtractOkay)
+        {
+            failed++;
+        }
+    }
+
+    archive_entry_free(entry);
+    archive_read_free(a);
+
+    return failed;
+}
+
+/* public functions */
+
+/*
+    extractRun - extract options->archive into options->destDir;
+                 stats (which may be NULL) gets the totals
+*/
+
+int extractRun(const extractOptions_t *options, extractStats_t *stats)
+{
+    extractShared_t shared;
+    extractStats_t totals;
+    extractWorker_t *workers = NULL;
+    struct archive *dirWriter = NULL;
+    summary_t summary;
+    char archivePath[PATH_MAX];
+    uint64_t numEntries = 0;
+    unsigned int numWorkers = 1;
+    unsigned int i = 0;
+    int savedDir = -1;
+    int failed = 0;
+    int rc = gExtractOkay;
+
+    memset(&totals, 0, sizeof(extractStats_t));
+    memset(&shared, 0, sizeof(extractShared_t));
+    if (stats != NULL)
+    {
+        memset(stats, 0, sizeof(extractStats_t));
+    }
+
+    if (options == NULL || options->archive == NULL ||
+        options->destDir == NULL || options->numWorkers < 1 ||
+        options->numWorkers > EXTRACTMAXWORKERS)
+    {
+        return gExtractErr;
+    }
+
+    /* the archive's path must still work after changing directories */
+
+    if (realpath(options->archive, archivePath) == NULL)
+    {
+        fprintf(stderr,
+                "qlZipInfo: ERROR: can't find '%s': %s\n",
+                options->archive,
+                strerror(errno));
+        return gExtractErr;
+    }
+
+    /* only zip and non-solid 7z archives are split between workers */
+
+    summaryRead(archivePath, &summary);
+    if (summary.format == SummaryFormatZip ||
+        (summary.format == SummaryFormat7Zip &&
+         summary.hasEntries && summary.solid == 0))
+    {
+        numWorkers = (unsigned int)options->numWorkers;
+    }
+
+    shared.archive = archivePath;
+    shared.reuseReader = (summary.format == SummaryFormatZip ? 1 : 0);
+    shared.numUnits = numWorkers * EXTRACTUNITSPERWORKER;
+    pthread_mutex_init(&(shared.headerLock), NULL);
+
+    if (mkdir(options->destDir, 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr,
+                "qlZipInfo: ERROR: can't create '%s': %s\n",
+                options->destDir,
+                strerror(errno));
+        pthread_mutex_destroy(&(shared.headerLock));
+        return gExtractErr;
+    }
+
+    savedDir = open(".", O_RDONLY);
+    if (savedDir < 0 || chdir(options->destDir) != 0)
+    {
+        fprintf(stderr,
+                "qlZipInfo: ERROR: can't change to '%s': %s\n",
+                options->destDir,
+                strerror(errno));
+        if (savedDir >= 0)
+        {
+            close(savedDir);
+        }
+        pthread_mutex_destroy(&(shared.headerLock));
+        return gExtractErr;
+    }
+
+    dirWriter = extractNewWriter(options->flags);
+    workers = calloc(numWorkers, sizeof(extractWorker_t));
+    if (dirWriter == NULL || workers == NULL)
+    {
+        rc = gExtractErr;
+        goto done;
+    }
+
+    rc = extractPlan(&shared, dirWriter, &numEntries, &totals);
+    if (rc != gExtractOkay)
+    {
+        goto done;
+    }
+
+    /*
+        the writers are made here, before any thread writes a file,
+        since archive_write_disk_new() also changes the umask
+    */
+
+    for (i = 0; i < numWorkers && i < shared.numUnits; i++)
+    {
+        workers[i].shared = &shared;
+        workers[i].writer = extractNewWriter(options->flags);
+        workers[i].entry = archive_entry_new();
+        if (workers[i].writer == NULL || workers[i].entry == NULL)
+        {
+            rc = gExtractErr;
+            break;
+        }
+    }
+
+    for (i = 0; rc == gExtractOkay && i < numWorkers &&
+                i < shared.numUnits; i++)
+    {
+        if (pthread_create(&(workers[i].thread),
+                           NULL,
+                           extractWorkerMain,
+                           &(workers[i])) != 0)
+        {
+            rc = gExtractErr;
+            break;
+        }
+        workers[i].started = 1;
+        totals.workers++;
+    }
+
+    /* a worker that couldn't be started leaves its units to the others */
+
+    for (i = 0; i < numWorkers; i++)
+    {
+        if (workers[i].started != 0)
+        {
+            pthread_join(workers[i].thread, NULL);
+        }
+        if (workers[i].writer != NULL)
+        {
+            archive_write_close(workers[i].writer);
+        }
+        totals.bytes += workers[i].bytes;
+        totals.failed += workers[i].failed;
+    }
+
+    if (totals.workers > 0 &&
+        __atomic_load_n(&(shared.nextUnit), __ATOMIC_SEQ_CST) >=
+            shared.numUnits)
+    {
+        rc = gExtractOkay;
+    }
+
+    totals.entries = numEntries;
+    totals.units = shared.numUnits;
+
+    if (rc == gExtractOkay && totals.links > 0)
+    {
+        failed = extractLinks(&shared, dirWriter, numEntries, &(totals.bytes));
+        if (failed < 0)
+        {
+            rc = gExtractErr;
+        }
+        else
+        {
+            totals.failed += (uint64_t)failed;
+        }
+    }
+
+done:
+
+    /* closing the first writer sets the folders' times and permissions */
+
+    if (dirWriter != NULL)
+    {
+        if (archive_write_close(dirWriter) < ARCHIVE_WARN)
+        {
+            totals.failed++;
+        }
+        archive_write_free(dirWriter);
+    }
+
+    for (i = 0; workers != NULL && i < numWorkers; i++)
+    {
+        if (workers[i].writer != NULL)
+        {
+            archive_write_free(workers[i].writer);
+        }
+        if (workers[i].entry != NULL)
+        {
+            archive_entry_free(workers[i].entry);
+        }
+    }
+
+    free(workers);
+    free(shared.units);
+    free(shared.kinds);
+    pthread_mutex_destroy(&(shared.headerLock));
+
+    if (fchdir(savedDir) != 0)
+    {
+        rc = gExtractErr;
+    }
+    close(savedDir);
+
+    if (stats != NULL)
+    {
+        *stats = totals;
+    }
+
+    return (rc == gExtractOkay && totals.failed == 0 ?
+            gExtractOkay : gExtractErr);
+}
@@ -0,0 +1,130 @@
+/*
+    extract.h - extract a zip or 7z archive with several threads
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    extractRun() extracts an archive into a folder with
+    archive_write_disk.  The entries of a zip archive, and of a 7z
+    archive in which every file is compressed on its own (one file
+    per folder), can be decoded independently, so for these:
+
+        1. The entries are listed once, in order, on the calling
+           thread, which also creates every folder (the archive's
+           own folders and the parents of its files), so that the
+           workers never race to create the same folder.
+        2. The files are split into contiguous work units of about
+           the same size (the files' sizes plus EXTRACTENTRYCOST
+           each), EXTRACTUNITSPERWORKER units per worker, so that a
+           worker that gets a unit of large files doesn't hold up the
+           end of the extraction.
+        3. numWorkers threads take units in order.  Each worker has
+           its own reader and its own archive_write_disk.  A zip
+           worker keeps its reader for all of its units, since
+           skipping a zip entry is a seek; a 7z worker opens a reader
+           for each unit, since libarchive only seeks to the first
+           folder that is read and decodes the ones after it.
+        4. Symbolic links and hard links are made last, on the
+           calling thread, so that a link can't redirect a file that
+           another worker is writing, and then the folders' times and
+           permissions are set.
+
+    Any other archive (or a solid 7z archive) is extracted the same
+    way with a single work unit.  The current directory is changed
+    to destDir while extractRun() runs, since archive_write_disk
+    writes paths relative to it.  flags are ARCHIVE_EXTRACT_* flags
+    (see archive.h); EXTRACTDEFAULTFLAGS refuses absolute paths,
+    ".." and paths through symbolic links.
+*/
+
+#ifndef qlZipInfo_extract_h
+#define qlZipInfo_extract_h
+
+#include <stdint.h>
+
+#include "archive.h"
+
+/* return codes */
+
+enum
+{
+    gExtractErr  = -1,
+    gExtractOkay =  0,
+};
+
+/* work units per worker */
+
+#define EXTRACTUNITSPERWORKER 4
+
+/* cost of an entry, in bytes, when the work units are balanced */
+
+#define EXTRACTENTRYCOST 16384
+
+/* size of the reader's blocks */
+
+#define EXTRACTBLOCKSIZE 65536
+
+/* most workers */
+
+#define EXTRACTMAXWORKERS 64
+
+/* default flags */
+
+#define EXTRACTDEFAULTFLAGS (ARCHIVE_EXTRACT_TIME | \
+                             ARCHIVE_EXTRACT_SECURE_SYMLINKS | \
+                             ARCHIVE_EXTRACT_SECURE_NODOTDOT | \
+                             ARCHIVE_EXTRACT_SECURE_NOABSOLUTEPATHS)
+
+/* options */
+
+typedef struct extractOptions
+{
+    const char *archive;
+    const char *destDir;
+    int numWorkers;
+    int flags;
+} extractOptions_t;
+
+/* statistics */
+
+typedef struct extractStats
+{
+    uint64_t entries;
+    uint64_t files;
+    uint64_t dirs;
+    uint64_t links;
+    uint64_t failed;
+    uint64_t bytes;
+    unsigned int units;
+    unsigned int workers;
+} extractStats_t;
+
+/* prototypes */
+
+int extractRun(const extractOptions_t *options, extractStats_t *stats);
+
+#endif /* qlZipInfo_extract_h */
@@ -280,6 +280,8 @@ typedef const char *archive_passphrase_callback(struct archive *,
 #define	ARCHIVE_FILTER_GRZIP	12
 #define	ARCHIVE_FILTER_LZ4	13
 #define	ARCHIVE_FILTER_ZSTD	14
+#define	ARCHIVE_FILTER_PBZX	15
+#define	ARCHIVE_FILTER_UDIF	16
 
 #if ARCHIVE_VERSION_NUMBER < 4000000
 #define	ARCHIVE_COMPRESSION_NONE	ARCHIVE_FILTER_NONE
@@ -441,6 +443,8 @@ __LA_DECL int archive_read_support_filter_rpm(struct archive *);
 __LA_DECL int archive_read_support_filter_uu(struct archive *);
 __LA_DECL int archive_read_support_filter_xz(struct archive *);
 __LA_DECL int archive_read_support_filter_zstd(struct archive *);
+__LA_DECL int archive_read_support_filter_pbzx(struct archive *);
+__LA_DECL int archive_read_support_filter_udif(struct archive *);
 
 __LA_DECL int archive_read_support_format_7zip(struct archive *);
 __LA_DECL int archive_read_support_format_all(struct archive *);
@@ -637,6 +641,47 @@ __LA_DECL int archive_read_set_option(struct archive *_a,
 __LA_DECL int archive_read_set_options(struct archive *_a,
 			    const char *opts);
 
+/*
+ * Resource limits for reading untrusted archives.  Each limit is
+ * per archive and zero means unlimited.  A reader that would go
+ * past a limit fails with ARCHIVE_FATAL instead.
+ *  ENTRIES: number of entries (headers) read
+ *  HEADER_BYTES: metadata bytes read for one entry, e.g. the tar
+ *    pax and GNU long name headers that precede it
+ *  DEPTH: nesting of extension headers, continuation areas and
+ *    directories within a table of contents
+ *  MEMORY: bytes of tables built from the archive's directory
+ */
+#define ARCHIVE_READ_LIMIT_ENTRIES		1
+#define ARCHIVE_READ_LIMIT_HEADER_BYTES		2
+#define ARCHIVE_READ_LIMIT_DEPTH		3
+#define ARCHIVE_READ_LIMIT_MEMORY		4
+/* Default depth limit, which stops continuation loops. */
+#define ARCHIVE_READ_LIMIT_DEPTH_DEFAULT	1024
+__LA_DECL int archive_read_set_limit(struct archive *, int, la_int64_t);
+
+/*
+ * Tracing.  An application that wants to know where a read spends
+ * its time sets hooks for the calling thread; libarchive then reports
+ * each phase (with the time from now() at its start) and adds to each
+ * counter.  With no hooks set, which is the default, each trace point
+ * costs one test of a thread local pointer.  Passing NULL clears them.
+ */
+#define ARCHIVE_TRACE_BID			1	/* phases */
+#define ARCHIVE_TRACE_READ			2
+#define ARCHIVE_TRACE_DECOMPRESS		3
+#define ARCHIVE_TRACE_HEADER			4
+#define ARCHIVE_TRACE_BYTES_READ		1	/* counters */
+#define ARCHIVE_TRACE_BYTES_DECOMPRESSED	2
+#define ARCHIVE_TRACE_HEADERS_PARSED		3
+#define ARCHIVE_TRACE_ALLOCATIONS		4
+struct archive_trace {
+	la_int64_t	(*now)(void);
+	void		(*phase)(int, la_int64_t);
+	void		(*count)(int, la_int64_t);
+};
+__LA_DECL void archive_set_trace(const struct archive_trace *);
+
 /*
  * Add a decryption passphrase.
  */
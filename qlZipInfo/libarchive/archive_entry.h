@@ -721,6 +721,46 @@ __LA_DECL void archive_entry_linkify(struct archive_entry_linkresolver *,
     struct archive_entry **, struct archive_entry **);
 __LA_DECL struct archive_entry *archive_entry_partial_links(
     struct archive_entry_linkresolver *res, unsigned int *links);
+
+/*
+ * A compact table for matching up hardlinks when reading.
+ *
+ * The 'struct archive_entry_linktable' remembers only the device,
+ * inode, number of links not yet seen and first pathname of each
+ * file with multiple links, in an open-addressed table and a pool
+ * of pathnames, so it needs a few dozen bytes per file rather than
+ * a copy of the entry.  Here's how to use it:
+ *   1. Create a table with archive_entry_linktable_new().
+ *   2. Optionally call archive_entry_linktable_set_spill() so that
+ *      a table that grows past the given size is moved to a memory
+ *      mapped temporary file in the given directory (or $TMPDIR).
+ *   3. Hand each entry to archive_entry_linktable_record().  For the
+ *      first link of a file, or a file with only one link, *first is
+ *      set to NULL.  For a later link, *first is set to the pathname
+ *      of the first link, which stays valid until the next call.
+ *      Files whose links have all been seen are dropped; as with
+ *      the link resolver, a file with an nlink of 0 is kept until
+ *      the end.
+ *   4. Optionally call archive_entry_linktable_next() until it
+ *      returns NULL to list the files with links not yet seen.
+ *   5. Call archive_entry_linktable_free() to free resources.
+ * archive_entry_linktable_size() returns the bytes the table uses,
+ * in memory or in its temporary file.
+ */
+struct archive_entry_linktable;
+
+__LA_DECL struct archive_entry_linktable *archive_entry_linktable_new(void);
+__LA_DECL int archive_entry_linktable_set_spill(
+    struct archive_entry_linktable *, const char * /* dir */,
+    size_t /* bytes */);
+__LA_DECL int archive_entry_linktable_record(struct archive_entry_linktable *,
+    struct archive_entry *, const char ** /* first */);
+__LA_DECL const char *archive_entry_linktable_next(
+    struct archive_entry_linktable *, la_int64_t * /* dev */,
+    la_int64_t * /* ino */, unsigned int * /* links */);
+__LA_DECL size_t archive_entry_linktable_size(
+    struct archive_entry_linktable *);
+__LA_DECL void archive_entry_linktable_free(struct archive_entry_linktable *);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,516 @@
+/*-
+ * Copyright (c) 2026 Sriranga R. Veeraraghavan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR(S) ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR(S) BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "archive_platform.h"
+
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#include <stdio.h>
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include "archive.h"
+#include "archive_entry.h"
+
+/*
+ * The link table is an open-addressed hash table with linear probing
+ * of fixed size slots, plus a pool holding the first pathname of each
+ * file.  A slot is 32 bytes and refers to its pathname by offset, so
+ * a table of N multiply-linked files needs about 46 * N bytes plus
+ * the pathnames, where the link resolver keeps a clone of each entry.
+ *
+ * Slots are removed with backward shift deletion, so there are no
+ * tombstones, and the pathnames of removed slots are dropped the next
+ * time the pool is full.  Both the slots and the pool live in a
+ * "region" that is either malloc()ed or, once the table has grown
+ * past the spill size, a shared mapping of an unlinked temporary
+ * file, so the kernel can page it out instead of the process growing.
+ */
+
+/* Initial number of slots; must be a power of two. */
+#define	LINKTABLE_INITIAL_SLOTS	1024
+/* Initial size of the pathname pool. */
+#define	LINKTABLE_INITIAL_POOL	(64 * 1024)
+
+struct linktable_slot {
+	int64_t		ino;
+	int64_t		dev;
+	uint64_t	path;	/* Offset of the pathname in the pool. */
+	uint32_t	links;	/* # links not yet seen; 0 if empty. */
+	uint32_t	hash;
+};
+
+struct linktable_region {
+	unsigned char	*p;
+	size_t		 size;
+	int		 fd;	/* -1 unless spilled to a file. */
+};
+
+struct archive_entry_linktable {
+	struct linktable_region	 slots;
+	struct linktable_region	 pool;
+	size_t			 number_slots;
+	size_t			 number_entries;
+	size_t			 pool_used;
+	size_t			 pool_dead;
+	size_t			 cursor;
+	size_t			 spill_size;
+	char			*spill_dir;
+};
+
+static int	region_alloc(struct archive_entry_linktable *,
+		    struct linktable_region *, size_t);
+static void	region_free(struct linktable_region *);
+static int	region_grow(struct archive_entry_linktable *,
+		    struct linktable_region *, size_t);
+static int	region_spill(struct archive_entry_linktable *,
+		    struct linktable_region *, size_t);
+static int	grow_slots(struct archive_entry_linktable *);
+static int	pool_add(struct archive_entry_linktable *, const char *,
+		    uint64_t *);
+static void	delete_slot(struct archive_entry_linktable *, size_t);
+
+static uint32_t
+link_hash(int64_t dev, int64_t ino)
+{
+	uint64_t h;
+
+	h = (uint64_t)ino * 0x9E3779B97F4A7C15ULL;
+	h ^= (uint64_t)dev * 0xC2B2AE3D27D4EB4FULL;
+	h ^= h >> 29;
+	return ((uint32_t)(h ^ (h >> 32)));
+}
+
+struct archive_entry_linktable *
+archive_entry_linktable_new(void)
+{
+	struct archive_entry_linktable *t;
+
+	t = calloc(1, sizeof(*t));
+	if (t == NULL)
+		return (NULL);
+	t->slots.fd = t->pool.fd = -1;
+	if (region_alloc(t, &t->slots, LINKTABLE_INITIAL_SLOTS *
+	    sizeof(struct linktable_slot)) != ARCHIVE_OK) {
+		free(t);
+		return (NULL);
+	}
+	t->number_slots = LINKTABLE_INITIAL_SLOTS;
+	return (t);
+}
+
+int
+archive_entry_linktable_set_spill(struct archive_entry_linktable *t,
+    const char *dir, size_t bytes)
+{
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MKSTEMP) && \
+    defined(HAVE_FTRUNCATE)
+	char *d = NULL;
+
+	if (dir != NULL && (d = strdup(dir)) == NULL)
+		return (ARCHIVE_FATAL);
+	free(t->spill_dir);
+	t->spill_dir = d;
+	t->spill_size = bytes;
+	return (ARCHIVE_OK);
+#else
+	(void)t; /* UNUSED */
+	(void)dir; /* UNUSED */
+	(void)bytes; /* UNUSED */
+	return (ARCHIVE_WARN);
+#endif
+}
+
+size_t
+archive_entry_linktable_size(struct archive_entry_linktable *t)
+{
+	return (t->slots.size + t->pool.size);
+}
+
+void
+archive_entry_linktable_free(struct archive_entry_linktable *t)
+{
+	if (t == NULL)
+		return;
+	region_free(&t->slots);
+	region_free(&t->pool);
+	free(t->spill_dir);
+	free(t);
+}
+
+int
+archive_entry_linktable_record(struct archive_entry_linktable *t,
+    struct archive_entry *entry, const char **first)
+{
+	struct linktable_slot *slots, *s;
+	const char *name;
+	size_t mask, i;
+	int64_t dev, ino;
+	uint64_t path;
+	uint32_t hash;
+	unsigned int nlink;
+
+	*first = NULL;
+	nlink = archive_entry_nlink(entry);
+	if (nlink == 1)
+		return (ARCHIVE_OK);
+
+	dev = (int64_t)archive_entry_dev(entry);
+	ino = archive_entry_ino64(entry);
+	hash = link_hash(dev, ino);
+
+	/*
+	 * First look for an earlier link to this file.  Decrement
+	 * its link count and drop it once every link has been seen;
+	 * the pathname stays in the pool until the next insertion.
+	 */
+	slots = (struct linktable_slot *)t->slots.p;
+	mask = t->number_slots - 1;
+	for (i = hash & mask; slots[i].links != 0; i = (i + 1) & mask) {
+		s = &slots[i];
+		if (s->hash != hash || s->dev != dev || s->ino != ino)
+			continue;
+		*first = (const char *)t->pool.p + s->path;
+		if (--s->links == 0) {
+			t->pool_dead += strlen(*first) + 1;
+			delete_slot(t, i);
+		}
+		return (ARCHIVE_OK);
+	}
+
+	/* Keep the load factor below 3/4. */
+	if ((t->number_entries + 1) * 4 > t->number_slots * 3) {
+		if (grow_slots(t) != ARCHIVE_OK)
+			return (ARCHIVE_FATAL);
+		slots = (struct linktable_slot *)t->slots.p;
+		mask = t->number_slots - 1;
+		for (i = hash & mask; slots[i].links != 0; i = (i + 1) & mask)
+			;
+	}
+
+	name = archive_entry_pathname(entry);
+	if (pool_add(t, name != NULL ? name : "", &path) != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
+	slots = (struct linktable_slot *)t->slots.p;
+	s = &slots[i];
+	s->ino = ino;
+	s->dev = dev;
+	s->path = path;
+	s->links = nlink - 1; /* Kept until the end if nlink is 0. */
+	s->hash = hash;
+	t->number_entries++;
+	return (ARCHIVE_OK);
+}
+
+const char *
+archive_entry_linktable_next(struct archive_entry_linktable *t,
+    la_int64_t *dev, la_int64_t *ino, unsigned int *links)
+{
+	struct linktable_slot *slots, *s;
+	const char *name;
+
+	/*
+	 * Removing a slot can only shift a later slot into its place,
+	 * so the cursor stays put after each removal.
+	 */
+	slots = (struct linktable_slot *)t->slots.p;
+	for (; t->cursor < t->number_slots; t->cursor++) {
+		s = &slots[t->cursor];
+		if (s->links == 0)
+			continue;
+		name = (const char *)t->pool.p + s->path;
+		if (dev != NULL)
+			*dev = s->dev;
+		if (ino != NULL)
+			*ino = s->ino;
+		if (links != NULL)
+			*links = s->links;
+		t->pool_dead += strlen(name) + 1;
+		delete_slot(t, t->cursor);
+		return (name);
+	}
+	t->cursor = 0;
+	return (NULL);
+}
+
+/*
+ * Remove slot i and move any later slots of the same probe run that
+ * belong at or before i back into the hole.
+ */
+static void
+delete_slot(struct archive_entry_linktable *t, size_t i)
+{
+	struct linktable_slot *slots;
+	size_t mask, j, k;
+
+	slots = (struct linktable_slot *)t->slots.p;
+	mask = t->number_slots - 1;
+	for (j = i;;) {
+		j = (j + 1) & mask;
+		if (slots[j].links == 0)
+			break;
+		k = slots[j].hash & mask;
+		if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+			continue;
+		slots[i] = slots[j];
+		i = j;
+	}
+	slots[i].links = 0;
+	t->number_entries--;
+}
+
+static int
+grow_slots(struct archive_entry_linktable *t)
+{
+	struct linktable_region r;
+	struct linktable_slot *old, *slots;
+	size_t n, mask, i, j;
+
+	n = t->number_slots * 2;
+	if (n < t->number_slots)
+		return (ARCHIVE_FATAL);
+	r.fd = -1;
+	if (region_alloc(t, &r, n * sizeof(struct linktable_slot))
+	    != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
+	old = (struct linktable_slot *)t->slots.p;
+	slots = (struct linktable_slot *)r.p;
+	mask = n - 1;
+	for (i = 0; i < t->number_slots; i++) {
+		if (old[i].links == 0)
+			continue;
+		for (j = old[i].hash & mask; slots[j].links != 0;
+		    j = (j + 1) & mask)
+			;
+		slots[j] = old[i];
+	}
+	region_free(&t->slots);
+	t->slots = r;
+	t->number_slots = n;
+	return (ARCHIVE_OK);
+}
+
+/*
+ * Append a pathname to the pool.  When it is full, copy the live
+ * pathnames into a fresh pool, twice as large unless at least half
+ * of the old one was dropped pathnames.
+ */
+static int
+pool_add(struct archive_entry_linktable *t, const char *name,
+    uint64_t *offset)
+{
+	struct linktable_region r;
+	struct linktable_slot *slots;
+	size_t len, n, used, i, l;
+
+	len = strlen(name) + 1;
+	if (t->pool.size - t->pool_used < len) {
+		n = t->pool.size;
+		if (n < LINKTABLE_INITIAL_POOL)
+			n = LINKTABLE_INITIAL_POOL;
+		if (t->pool_dead < t->pool_used / 2)
+			n *= 2;
+		while (n - (t->pool_used - t->pool_dead) < len) {
+			if (n * 2 < n)
+				return (ARCHIVE_FATAL);
+			n *= 2;
+		}
+		if (t->pool_dead == 0 && t->pool.p != NULL) {
+			/* Nothing to drop: just grow the pool. */
+			if (region_grow(t, &t->pool, n) != ARCHIVE_OK)
+				return (ARCHIVE_FATAL);
+		} else {
+			r.fd = -1;
+			if (region_alloc(t, &r, n) != ARCHIVE_OK)
+				return (ARCHIVE_FATAL);
+			slots = (struct linktable_slot *)t->slots.p;
+			used = 0;
+			for (i = 0; i < t->number_slots; i++) {
+				if (slots[i].links == 0)
+					continue;
+				l = strlen((const char *)t->pool.p +
+				    slots[i].path) + 1;
+				memcpy(r.p + used, t->pool.p + slots[i].path,
+				    l);
+				slots[i].path = used;
+				used += l;
+			}
+			region_free(&t->pool);
+			t->pool = r;
+			t->pool_used = used;
+			t->pool_dead = 0;
+		}
+	}
+	memcpy(t->pool.p + t->pool_used, name, len);
+	*offset = t->pool_used;
+	t->pool_used += len;
+	return (ARCHIVE_OK);
+}
+
+/*
+ * Allocate a zeroed region, in a temporary file if the table would
+ * then be larger than the spill size.
+ */
+static int
+region_alloc(struct archive_entry_linktable *t, struct linktable_region *r,
+    size_t size)
+{
+	if (t->spill_size != 0 &&
+	    archive_entry_linktable_size(t) + size > t->spill_size &&
+	    region_spill(t, r, size) == ARCHIVE_OK)
+		return (ARCHIVE_OK);
+	r->p = calloc(1, size);
+	if (r->p == NULL)
+		return (ARCHIVE_FATAL);
+	r->size = size;
+	r->fd = -1;
+	return (ARCHIVE_OK);
+}
+
+static void
+region_free(struct linktable_region *r)
+{
+#ifdef HAVE_SYS_MMAN_H
+	if (r->fd >= 0) {
+		if (r->p != NULL)
+			munmap(r->p, r->size);
+		close(r->fd);
+	} else
+#endif
+		free(r->p);
+	r->p = NULL;
+	r->size = 0;
+	r->fd = -1;
+}
+
+static int
+region_grow(struct archive_entry_linktable *t, struct linktable_region *r,
+    size_t size)
+{
+	struct linktable_region n;
+	unsigned char *p;
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_FTRUNCATE)
+	if (r->fd >= 0) {
+		/* The file keeps the contents while it is remapped. */
+		if (ftruncate(r->fd, (off_t)size) != 0)
+			return (ARCHIVE_FATAL);
+		munmap(r->p, r->size);
+		r->p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+		    r->fd, 0);
+		if (r->p == MAP_FAILED) {
+			r->p = NULL;
+			return (ARCHIVE_FATAL);
+		}
+		r->size = size;
+		return (ARCHIVE_OK);
+	}
+#endif
+	if (t->spill_size != 0 &&
+	    archive_entry_linktable_size(t) - r->size + size > t->spill_size) {
+		n.fd = -1;
+		if (region_spill(t, &n, size) == ARCHIVE_OK) {
+			memcpy(n.p, r->p, r->size);
+			region_free(r);
+			*r = n;
+			return (ARCHIVE_OK);
+		}
+	}
+	p = realloc(r->p, size);
+	if (p == NULL)
+		return (ARCHIVE_FATAL);
+	memset(p + r->size, 0, size - r->size);
+	r->p = p;
+	r->size = size;
+	return (ARCHIVE_OK);
+}
+
+/*
+ * Map a region from an unlinked temporary file; the file reads back
+ * as zeros.
+ */
+static int
+region_spill(struct archive_entry_linktable *t, struct linktable_region *r,
+    size_t size)
+{
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MKSTEMP) && \
+    defined(HAVE_FTRUNCATE)
+	const char *dir;
+	char *path;
+	size_t len;
+	int fd;
+
+	dir = t->spill_dir;
+	if (dir == NULL)
+		dir = getenv("TMPDIR");
+	if (dir == NULL || dir[0] == '\0')
+		dir = "/tmp";
+	len = strlen(dir);
+	path = malloc(len + sizeof("/libarchive_XXXXXX"));
+	if (path == NULL)
+		return (ARCHIVE_FATAL);
+	memcpy(path, dir, len);
+	strcpy(path + len, "/libarchive_XXXXXX");
+	fd = mkstemp(path);
+	if (fd < 0) {
+		free(path);
+		return (ARCHIVE_FATAL);
+	}
+	unlink(path);
+	free(path);
+	if (ftruncate(fd, (off_t)size) != 0) {
+		close(fd);
+		return (ARCHIVE_FATAL);
+	}
+	r->p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (r->p == MAP_FAILED) {
+		r->p = NULL;
+		close(fd);
+		return (ARCHIVE_FATAL);
+	}
+	r->size = size;
+	r->fd = fd;
+	return (ARCHIVE_OK);
+#else
+	(void)t; /* UNUSED */
+	(void)r; /* UNUSED */
+	(void)size; /* UNUSED */
+	return (ARCHIVE_FATAL);
+#endif
+}
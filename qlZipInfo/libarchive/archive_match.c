@@ -57,6 +57,12 @@ struct match_list {
 	int			 unmatched_count;
 	struct match		*unmatched_next;
 	int			 unmatched_eof;
+	/* Compiled form of the patterns; see match_list_compile(). */
+	struct archive_pathmatch_set *set;
+	struct match		**set_index;
+	int			*set_ids;
+	int			 set_count;
+	int			 set_flags;
 };
 
 struct match_file {
@@ -155,6 +161,8 @@ static void	entry_list_free(struct entry_list *);
 static void	entry_list_init(struct entry_list *);
 static int	error_nomem(struct archive_match *);
 static void	match_list_add(struct match_list *, struct match *);
+static int	match_list_compile(struct archive_match *,
+		    struct match_list *, int);
 static void	match_list_free(struct match_list *);
 static void	match_list_init(struct match_list *);
 static int	match_list_unmatched_inclusions_next(struct archive_match *,
@@ -174,6 +182,7 @@ static int	match_path_inclusion(struct archive_match *,
 static int	owner_excluded(struct archive_match *,
 		    struct archive_entry *);
 static int	path_excluded(struct archive_match *, int, const void *);
+static int	path_excluded_compiled(struct archive_match *, const char *);
 static int	set_timefilter(struct archive_match *, int, time_t, long,
 		    time_t, long);
 static int	set_timefilter_pathname_mbs(struct archive_match *,
@@ -717,6 +726,25 @@ path_excluded(struct archive_match *a, int mbs, const void *pathname)
 	if (a == NULL)
 		return (0);
 
+	/*
+	 * With more than a couple of patterns, evaluate them all in one
+	 * pass over the pathname.  Patterns that cannot be converted to
+	 * the current locale fall back to the per-pattern loop below.
+	 */
+	if (mbs && a->inclusions.count + a->exclusions.count > 2) {
+		int ri, re;
+
+		ri = match_list_compile(a, &(a->inclusions),
+		    a->recursive_include ? PATHMATCH_NO_ANCHOR_END : 0);
+		re = match_list_compile(a, &(a->exclusions),
+		    PATHMATCH_NO_ANCHOR_START | PATHMATCH_NO_ANCHOR_END);
+		if (ri < 0 || re < 0)
+			return (error_nomem(a));
+		if (ri == 0 && re == 0)
+			return (path_excluded_compiled(a,
+			    (const char *)pathname));
+	}
+
 	/* Mark off any unmatched inclusions. */
 	/* In particular, if a filename does appear in the archive and
 	 * is explicitly included and excluded, then we don't report
@@ -769,6 +797,42 @@ path_excluded(struct archive_match *a, int mbs, const void *pathname)
 	return (0);
 }
 
+/*
+ * Same as path_excluded(), but with the compiled pattern sets.
+ */
+static int
+path_excluded_compiled(struct archive_match *a, const char *pathname)
+{
+	struct match_list *inc = &(a->inclusions);
+	struct match_list *exc = &(a->exclusions);
+	struct match *match;
+	int i, n, matched;
+
+	/* Mark off any unmatched inclusions. */
+	n = __archive_pathmatch_set_match(inc->set, pathname, inc->set_ids, 0);
+	matched = (n > 0);
+	for (i = 0; i < n; i++) {
+		match = inc->set_index[inc->set_ids[i]];
+		if (!match->matched) {
+			inc->unmatched_count--;
+			match->matched = 1;
+		}
+	}
+
+	/* Exclusions take priority */
+	if (__archive_pathmatch_set_match(exc->set, pathname,
+	    exc->set_ids, 1) > 0)
+		return (1);
+
+	/* It's not excluded and we found an inclusion above, so it's
+	 * included. */
+	if (matched)
+		return (0);
+
+	/* If there were inclusions, default is to exclude. */
+	return (inc->first != NULL);
+}
+
 /*
  * This is a little odd, but it matches the default behavior of
  * gtar.  In particular, 'a*b' will match 'foo/a1111/222b/bar'
@@ -848,6 +912,9 @@ match_list_free(struct match_list *list)
 		archive_mstring_clean(&(q->pattern));
 		free(q);
 	}
+	__archive_pathmatch_set_free(list->set);
+	free(list->set_index);
+	free(list->set_ids);
 }
 
 static void
@@ -859,6 +926,63 @@ match_list_add(struct match_list *list, struct match *m)
 	list->unmatched_count++;
 }
 
+/*
+ * (Re)build the compiled pattern set of a list if patterns were added
+ * or the matching flags changed since it was last built.
+ *
+ * Returns 0 if the set is usable, 1 if some pattern cannot be
+ * converted to a multibyte string (the caller should fall back to
+ * matching the patterns one by one) and -1 if out of memory.
+ */
+static int
+match_list_compile(struct archive_match *a, struct match_list *list,
+    int flags)
+{
+	struct match *m;
+	const char *p;
+	int i;
+
+	if (list->set_count == list->count && list->set_flags == flags)
+		return ((list->set == NULL && list->count > 0) ? 1 : 0);
+
+	__archive_pathmatch_set_free(list->set);
+	free(list->set_index);
+	free(list->set_ids);
+	list->set = NULL;
+	list->set_index = NULL;
+	list->set_ids = NULL;
+	list->set_count = list->count;
+	list->set_flags = flags;
+	if (list->count == 0)
+		return (0);
+
+	list->set = __archive_pathmatch_set_new(flags);
+	list->set_index = calloc(list->count, sizeof(*list->set_index));
+	list->set_ids = calloc(list->count, sizeof(*list->set_ids));
+	if (list->set == NULL || list->set_index == NULL ||
+	    list->set_ids == NULL)
+		goto nomem;
+	for (m = list->first, i = 0; m != NULL; m = m->next, i++) {
+		if (archive_mstring_get_mbs(&(a->archive), &(m->pattern),
+		    &p) != 0) {
+			if (errno == ENOMEM)
+				goto nomem;
+			__archive_pathmatch_set_free(list->set);
+			list->set = NULL;
+			return (1);
+		}
+		if (__archive_pathmatch_set_add(list->set, p) != i)
+			goto nomem;
+		list->set_index[i] = m;
+	}
+	return (0);
+nomem:
+	__archive_pathmatch_set_free(list->set);
+	list->set = NULL;
+	list->set_count = -1;
+	return (-1);
+}
+
 static int
 match_list_unmatched_inclusions_next(struct archive_match *a,
     struct match_list *list, int mbs, const void **vp)
@@ -26,6 +26,9 @@
 
 #include "archive_platform.h"
 
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
 #ifdef HAVE_STRING_H
 #include <string.h>
 #endif
@@ -460,3 +463,489 @@ __archive_pathmatch_w(const wchar_t *p, const wchar_t *s, int flags)
 	/* Default: Match from beginning. */
 	return (pm_w(p, s, flags));
 }
+
+/*
+ * Compiled pattern sets.
+ *
+ * Matching a pathname against N patterns one at a time costs N calls
+ * to archive_pathmatch().  Instead, every pattern is filed under a
+ * literal run that any matching pathname must contain:
+ *
+ *   - its leading literal run (e.g. "META-INF" for "META-INF/x*.MF"),
+ *     which must appear where archive_pathmatch() starts matching,
+ *     i.e. at the start of the pathname or of one of its elements;
+ *   - otherwise, its trailing literal run (e.g. ".so" for "*.so"),
+ *     which must appear just before a '/' or the end of the pathname.
+ *
+ * Leading runs go in a trie walked forward from each start position,
+ * trailing runs go in a trie of reversed strings walked backward from
+ * each element end, so one pass over the pathname collects the
+ * candidates.  Only those are handed to archive_pathmatch(), which
+ * keeps the matching semantics exactly the same.
+ */
+
+/* Where archive_pathmatch() starts matching a pattern. */
+#define PMS_ANCHORED	1	/* At the start of the pathname. */
+#define PMS_SLASH	2	/* Past the leading '/'s of the pathname. */
+#define PMS_ELEMENT	4	/* At the start of any pathname element. */
+
+struct pms_node {
+	int			 child;		/* First child or -1. */
+	int			 sibling;	/* Next sibling or -1. */
+	int			 ids;		/* First pattern ending here. */
+	unsigned char		 c;
+};
+
+struct pms_trie {
+	struct pms_node		*nodes;
+	int			 count;
+	int			 size;
+};
+
+struct archive_pathmatch_set {
+	int			 flags;
+	int			 kinds;		/* Kinds of prefix patterns. */
+	int			 count;
+	int			 size;
+	char			**patterns;
+	int			*kind;
+	int			*next;		/* Next id on the same list. */
+	unsigned		*seen;
+	unsigned		 generation;
+	int			 always;	/* Patterns w/o a literal run. */
+	struct pms_trie		 prefix;
+	struct pms_trie		 suffix;
+};
+
+/*
+ * Characters that archive_pathmatch() always compares literally.
+ * '^', '$' and ']' are only special in some positions, but treating
+ * them as special here just makes a literal run shorter.
+ */
+static int
+pms_literal(char c)
+{
+	switch (c) {
+	case '\0': case '*': case '?': case '[': case ']':
+	case '\\': case '/': case '^': case '$':
+		return (0);
+	}
+	return (1);
+}
+
+/* Skip a leading "./", ".//", "././", etc. as pm() does. */
+static const char *
+pms_canon(const char *s)
+{
+	if (s[0] == '.' && s[1] == '/')
+		s = pm_slashskip(s + 1);
+	return (s);
+}
+
+static int
+pms_node_new(struct pms_trie *t, unsigned char c)
+{
+	struct pms_node *n;
+
+	if (t->count >= t->size) {
+		int size = t->size ? t->size * 2 : 64;
+
+		n = realloc(t->nodes, size * sizeof(*n));
+		if (n == NULL)
+			return (-1);
+		t->nodes = n;
+		t->size = size;
+	}
+	n = &(t->nodes[t->count]);
+	n->child = n->sibling = n->ids = -1;
+	n->c = c;
+	return (t->count++);
+}
+
+static int
+pms_child(const struct pms_trie *t, int node, unsigned char c)
+{
+	int i;
+
+	for (i = t->nodes[node].child; i >= 0; i = t->nodes[i].sibling)
+		if (t->nodes[i].c == c)
+			return (i);
+	return (-1);
+}
+
+/*
+ * Add the run p[0] .. p[len - 1] (walked backward if 'reverse' is
+ * set) to a trie and return its final node.
+ */
+static int
+pms_insert(struct pms_trie *t, const char *p, size_t len, int reverse)
+{
+	size_t i;
+	int node, n;
+
+	if (t->count == 0 && pms_node_new(t, 0) < 0)
+		return (-1);
+	node = 0;
+	for (i = 0; i < len; i++) {
+		unsigned char c = reverse ? p[len - 1 - i] : p[i];
+
+		n = pms_child(t, node, c);
+		if (n < 0) {
+			n = pms_node_new(t, c);
+			if (n < 0)
+				return (-1);
+			t->nodes[n].sibling = t->nodes[node].child;
+			t->nodes[node].child = n;
+		}
+		node = n;
+	}
+	return (node);
+}
+
+struct archive_pathmatch_set *
+__archive_pathmatch_set_new(int flags)
+{
+	struct archive_pathmatch_set *set;
+
+	set = calloc(1, sizeof(*set));
+	if (set == NULL)
+		return (NULL);
+	set->flags = flags;
+	set->always = -1;
+	return (set);
+}
+
+void
+__archive_pathmatch_set_free(struct archive_pathmatch_set *set)
+{
+	int i;
+
+	if (set == NULL)
+		return;
+	for (i = 0; i < set->count; i++)
+		free(set->patterns[i]);
+	free(set->patterns);
+	free(set->kind);
+	free(set->next);
+	free(set->seen);
+	free(set->prefix.nodes);
+	free(set->suffix.nodes);
+	free(set);
+}
+
+int
+__archive_pathmatch_set_add(struct archive_pathmatch_set *set,
+    const char *p)
+{
+	const char *q, *end;
+	int id, kind, node;
+
+	if (set->count >= set->size) {
+		int size = set->size ? set->size * 2 : 16;
+		void *v;
+
+		if ((v = realloc(set->patterns, size * sizeof(char *))) == NULL)
+			return (-1);
+		set->patterns = v;
+		if ((v = realloc(set->kind, size * sizeof(int))) == NULL)
+			return (-1);
+		set->kind = v;
+		if ((v = realloc(set->next, size * sizeof(int))) == NULL)
+			return (-1);
+		set->next = v;
+		if ((v = realloc(set->seen, size * sizeof(unsigned))) == NULL)
+			return (-1);
+		set->seen = v;
+		set->size = size;
+	}
+	id = set->count;
+	if ((set->patterns[id] = strdup(p)) == NULL)
+		return (-1);
+	set->seen[id] = 0;
+	set->kind[id] = 0;
+	set->count++;
+
+	/* Mirror the start handling of __archive_pathmatch() and pm(). */
+	kind = (set->flags & PATHMATCH_NO_ANCHOR_START) ?
+	    PMS_ELEMENT : PMS_ANCHORED;
+	q = p;
+	if (*q == '^') {
+		++q;
+		kind = PMS_ANCHORED;
+	}
+	if (*q == '/') {
+		while (*q == '/')
+			++q;
+		kind = PMS_SLASH;
+	}
+	q = pms_canon(q);
+	for (end = q; pms_literal(*end); end++)
+		;
+	if (end > q) {
+		node = pms_insert(&(set->prefix), q, end - q, 0);
+		if (node < 0)
+			return (-1);
+		set->kind[id] = kind;
+		set->kinds |= kind;
+		set->next[id] = set->prefix.nodes[node].ids;
+		set->prefix.nodes[node].ids = id;
+		return (id);
+	}
+
+	/* No leading run; try the trailing one. */
+	end = p + strlen(p);
+	for (q = end; q > p && pms_literal(q[-1]); q--)
+		;
+	if (end > q) {
+		node = pms_insert(&(set->suffix), q, end - q, 1);
+		if (node < 0)
+			return (-1);
+		set->next[id] = set->suffix.nodes[node].ids;
+		set->suffix.nodes[node].ids = id;
+		return (id);
+	}
+
+	set->next[id] = set->always;
+	set->always = id;
+	return (id);
+}
+
+/*
+ * Confirm the patterns on one candidate list.  Returns 1 if the
+ * caller only wanted the first match and it has been found.
+ */
+static int
+pms_try(struct archive_pathmatch_set *set, int id, int mask,
+    const char *s, int *ids, int *n, int first_only)
+{
+	for (; id >= 0; id = set->next[id]) {
+		if (set->seen[id] == set->generation ||
+		    (mask != 0 && (set->kind[id] & mask) == 0))
+			continue;
+		set->seen[id] = set->generation;
+		if (__archive_pathmatch(set->patterns[id], s, set->flags)) {
+			ids[(*n)++] = id;
+			if (first_only)
+				return (1);
+		}
+	}
+	return (0);
+}
+
+/* Walk the prefix trie along 'start'. */
+static int
+pms_walk_prefix(struct archive_pathmatch_set *set, const char *start,
+    int mask, const char *s, int *ids, int *n, int first_only)
+{
+	const struct pms_trie *t = &(set->prefix);
+	int node = 0;
+
+	while (*start != '\0' &&
+	    (node = pms_child(t, node, (unsigned char)*start++)) >= 0) {
+		if (pms_try(set, t->nodes[node].ids, mask, s, ids, n,
+		    first_only))
+			return (1);
+	}
+	return (0);
+}
+
+/* Walk the suffix trie backward from 'end'. */
+static int
+pms_walk_suffix(struct archive_pathmatch_set *set, const char *end,
+    const char *s, int *ids, int *n, int first_only)
+{
+	const struct pms_trie *t = &(set->suffix);
+	int node = 0;
+
+	while (end > s &&
+	    (node = pms_child(t, node, (unsigned char)*--end)) >= 0) {
+		if (pms_try(set, t->nodes[node].ids, 0, s, ids, n,
+		    first_only))
+			return (1);
+	}
+	return (0);
+}
+
+int
+__archive_pathmatch_set_match(struct archive_pathmatch_set *set,
+    const char *s, int *ids, int first_only)
+{
+	const char *e;
+	int n = 0;
+
+	if (set == NULL || s == NULL)
+		return (0);
+	if (++set->generation == 0) {
+		memset(set->seen, 0, set->count * sizeof(unsigned));
+		set->generation = 1;
+	}
+
+	if (pms_try(set, set->always, 0, s, ids, &n, first_only))
+		return (n);
+
+	if (set->prefix.count > 0) {
+		if (*s != '/') {
+			e = pms_canon(s);
+			if (pms_walk_prefix(set, e, PMS_ANCHORED | PMS_ELEMENT,
+			    s, ids, &n, first_only))
+				return (n);
+		} else if (set->kinds & PMS_SLASH) {
+			for (e = s; *e == '/'; e++)
+				;
+			if (pms_walk_prefix(set, pms_canon(e), PMS_SLASH,
+			    s, ids, &n, first_only))
+				return (n);
+		}
+		if (set->kinds & PMS_ELEMENT) {
+			for (e = strchr(s, '/'); e != NULL;
+			    e = strchr(e + 1, '/')) {
+				if (pms_walk_prefix(set, pms_canon(e + 1),
+				    PMS_ELEMENT, s, ids, &n, first_only))
+					return (n);
+			}
+		}
+	}
+
+	if (set->suffix.count > 0) {
+		for (e = s; ; e++) {
+			if ((*e == '/' || *e == '\0') &&
+			    pms_walk_suffix(set, e, s, ids, &n, first_only))
+				return (n);
+			if (*e == '\0')
+				break;
+		}
+	}
+	return (n);
+}
+
+#ifdef PATHMATCHMAIN
+
+/*
+ * Benchmark and cross-check the compiled pattern sets against calling
+ * archive_pathmatch() once per pattern:
+ *
+ *   cc -O2 -DHAVE_CONFIG_H -DPATHMATCHMAIN -I. archive_pathmatch.c
+ *   ./a.out [npatterns [npaths]]
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+static unsigned long pms_seed = 12345;
+
+static unsigned long
+pms_rand(void)
+{
+	pms_seed = pms_seed * 6364136223846793005UL + 1442695040888963407UL;
+	return (pms_seed >> 33);
+}
+
+static double
+pms_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec + ts.tv_nsec / 1e9);
+}
+
+int
+main(int argc, char **argv)
+{
+	static const char *dirs[] = { "META-INF", "lib", "res", "src",
+	    "include", "share", "doc", "bin", "x86_64", "arm64" };
+	static const char *exts[] = { ".so", ".class", ".MF", ".png",
+	    ".h", ".c", ".txt", ".xml", ".dylib", ".a" };
+	const int flagsets[] = { 0, PATHMATCH_NO_ANCHOR_END,
+	    PATHMATCH_NO_ANCHOR_START | PATHMATCH_NO_ANCHOR_END };
+	int npatterns = argc > 1 ? atoi(argv[1]) : 100;
+	int npaths = argc > 2 ? atoi(argv[2]) : 1000000;
+	char **patterns, **paths, buf[256];
+	int *ids, i, j, f, n;
+
+	patterns = calloc(npatterns, sizeof(char *));
+	paths = calloc(npaths, sizeof(char *));
+	ids = calloc(npatterns, sizeof(int));
+	if (patterns == NULL || paths == NULL || ids == NULL)
+		return (1);
+
+	for (i = 0; i < npatterns; i++) {
+		const char *d = dirs[pms_rand() % 10];
+		const char *x = exts[pms_rand() % 10];
+
+		switch (i % 5) {
+		case 0: snprintf(buf, sizeof(buf), "*%s", x); break;
+		case 1: snprintf(buf, sizeof(buf), "%s/**", d); break;
+		case 2: snprintf(buf, sizeof(buf), "%s/%s/*%s", d,
+			    dirs[pms_rand() % 10], x); break;
+		case 3: snprintf(buf, sizeof(buf), "%s%lu/file%lu%s", d,
+			    pms_rand() % 100, pms_rand() % 1000, x); break;
+		default: snprintf(buf, sizeof(buf), "*[0-9]%lu?%s",
+			    pms_rand() % 10, x); break;
+		}
+		patterns[i] = strdup(buf);
+	}
+	for (i = 0; i < npaths; i++) {
+		int depth = 1 + pms_rand() % 4, len = 0;
+
+		if (pms_rand() % 8 == 0)
+			len += snprintf(buf, sizeof(buf), "./");
+		for (j = 0; j < depth; j++)
+			len += snprintf(buf + len, sizeof(buf) - len, "%s%s/",
+			    dirs[pms_rand() % 10],
+			    pms_rand() % 3 ? "" : "1");
+		snprintf(buf + len, sizeof(buf) - len, "file%lu%s",
+		    pms_rand() % 1000, exts[pms_rand() % 10]);
+		paths[i] = strdup(buf);
+	}
+
+	for (f = 0; f < 3; f++) {
+		struct archive_pathmatch_set *set;
+		unsigned long naive = 0, compiled = 0;
+		double t0, t1, t2;
+
+		set = __archive_pathmatch_set_new(flagsets[f]);
+		for (i = 0; i < npatterns; i++)
+			__archive_pathmatch_set_add(set, patterns[i]);
+
+		t0 = pms_now();
+		for (i = 0; i < npaths; i++)
+			for (j = 0; j < npatterns; j++)
+				naive += archive_pathmatch(patterns[j],
+				    paths[i], flagsets[f]);
+		t1 = pms_now();
+		for (i = 0; i < npaths; i++)
+			compiled += __archive_pathmatch_set_match(set,
+			    paths[i], ids, 0);
+		t2 = pms_now();
+
+		/* Cross-check every path's match list. */
+		for (i = 0; i < npaths; i++) {
+			n = __archive_pathmatch_set_match(set, paths[i],
+			    ids, 0);
+			for (j = 0; j < npatterns; j++) {
+				int k, found = 0;
+
+				for (k = 0; k < n; k++)
+					found |= (ids[k] == j);
+				if (found != (archive_pathmatch(patterns[j],
+				    paths[i], flagsets[f]) != 0)) {
+					fprintf(stderr, "MISMATCH: flags %d "
+					    "'%s' '%s'\n", flagsets[f],
+					    patterns[j], paths[i]);
+					return (1);
+				}
+			}
+		}
+
+		fprintf(stdout, "flags %d: %d patterns x %d paths, "
+		    "%lu matches: per-pattern %.3fs, compiled %.3fs "
+		    "(%.1fx)\n", flagsets[f], npatterns, npaths, naive,
+		    t1 - t0, t2 - t1, (t1 - t0) / (t2 - t1));
+		if (naive != compiled)
+			return (1);
+		__archive_pathmatch_set_free(set);
+	}
+	return (0);
+}
+#endif /* PATHMATCHMAIN */
@@ -47,4 +47,28 @@ int __archive_pathmatch_w(const wchar_t *p, const wchar_t *s, int flags);
 #define archive_pathmatch(p, s, f)	__archive_pathmatch(p, s, f)
 #define archive_pathmatch_w(p, s, f)	__archive_pathmatch_w(p, s, f)
 
+/*
+ * A compiled set of patterns that all share the same flags.  Each
+ * pattern is indexed by its leading literal run (a prefix trie) or,
+ * failing that, by its trailing literal run (a reversed suffix trie),
+ * so a single pass over a pathname yields the few patterns that can
+ * possibly match; those are then confirmed with archive_pathmatch().
+ * Patterns with no literal run at either end are always candidates.
+ */
+struct archive_pathmatch_set;
+
+struct archive_pathmatch_set *__archive_pathmatch_set_new(int flags);
+void __archive_pathmatch_set_free(struct archive_pathmatch_set *);
+/* Returns the id (0, 1, 2, ...) of the added pattern or -1 on ENOMEM. */
+int __archive_pathmatch_set_add(struct archive_pathmatch_set *,
+    const char *p);
+/*
+ * Stores the ids of the patterns matching 's' in 'ids' (which must
+ * have room for as many ids as patterns were added), in no particular
+ * order, and returns their count.  If 'first_only' is set, stops at
+ * the first match found.
+ */
+int __archive_pathmatch_set_match(struct archive_pathmatch_set *,
+    const char *s, int *ids, int first_only);
+
 #endif
@@ -157,6 +157,9 @@ int	__archive_check_magic(struct archive *, unsigned int magic,
 
 __LA_NORETURN void	__archive_errx(int retvalue, const char *msg);
 
+/* The calling thread's trace hooks (see archive_set_trace()), or NULL. */
+extern __thread const struct archive_trace *__archive_trace;
+
 void	__archive_ensure_cloexec_flag(int fd);
 int	__archive_mktemp(const char *tmpdir);
 #if defined(_WIN32) && !defined(__CYGWIN__)
@@ -58,6 +58,7 @@ static int	choose_filters(struct archive_read *);
 static int	choose_format(struct archive_read *);
 static int	close_filters(struct archive_read *);
 static int64_t	_archive_filter_bytes(struct archive *, int);
+static ssize_t	filter_read(struct archive_read_filter *, const void **);
 static int	_archive_filter_code(struct archive *, int);
 static const char *_archive_filter_name(struct archive *, int);
 static int  _archive_filter_count(struct archive *);
@@ -103,6 +104,12 @@ archive_read_new(void)
 
 	a->passphrases.last = &a->passphrases.first;
 
+	a->limits[ARCHIVE_READ_LIMIT_DEPTH] = ARCHIVE_READ_LIMIT_DEPTH_DEFAULT;
+
+	a->client_fd = -1;
+	a->entry_stored_offset = -1;
+	a->entry_stored_size = -1;
+
 	return (&a->archive);
 }
 
@@ -453,6 +460,7 @@ archive_read_prepend_callback_data(struct archive *_a, void *client_data)
 static const struct archive_read_filter_vtable
 none_reader_vtable = {
 	.read = client_read_proxy,
+	.skip = client_skip_proxy,
 	.close = client_close_proxy,
 };
 
@@ -462,6 +470,8 @@ archive_read_open1(struct archive *_a)
 	struct archive_read *a = (struct archive_read *)_a;
 	struct archive_read_filter *filter, *tmp;
 	int slot, e = ARCHIVE_OK;
+	const struct archive_trace *trace = __archive_trace;
+	int64_t trace_start;
 
 	archive_check_magic(_a, ARCHIVE_READ_MAGIC, ARCHIVE_STATE_NEW,
 	    "archive_read_open");
@@ -502,7 +512,10 @@ archive_read_open1(struct archive *_a)
 	{
 		a->filter = filter;
 		/* Build out the input pipeline. */
+		trace_start = (trace != NULL) ? trace->now() : 0;
 		e = choose_filters(a);
+		if (trace != NULL)
+			trace->phase(ARCHIVE_TRACE_BID, trace_start);
 		if (e < ARCHIVE_WARN) {
 			a->archive.state = ARCHIVE_STATE_FATAL;
 			return (ARCHIVE_FATAL);
@@ -519,7 +532,10 @@ archive_read_open1(struct archive *_a)
 
 	if (!a->format)
 	{
+		trace_start = (trace != NULL) ? trace->now() : 0;
 		slot = choose_format(a);
+		if (trace != NULL)
+			trace->phase(ARCHIVE_TRACE_BID, trace_start);
 		if (slot < 0) {
 			close_filters(a);
 			a->archive.state = ARCHIVE_STATE_FATAL;
@@ -641,9 +657,19 @@ _archive_read_next_header2(struct archive *_a, struct archive_entry *entry)
 
 	/* Record start-of-header offset in uncompressed stream. */
 	a->header_position = a->filter->position;
+	a->entry_stored_offset = -1;
+	a->entry_stored_size = -1;
 
 	++_a->file_count;
-	r2 = (a->format->read_header)(a, entry);
+	if (__archive_trace != NULL) {
+		const struct archive_trace *trace = __archive_trace;
+		int64_t trace_start = trace->now();
+
+		r2 = (a->format->read_header)(a, entry);
+		trace->phase(ARCHIVE_TRACE_HEADER, trace_start);
+		trace->count(ARCHIVE_TRACE_HEADERS_PARSED, 1);
+	} else
+		r2 = (a->format->read_header)(a, entry);
 
 	/*
 	 * EOF and FATAL are persistent at this layer.  By
@@ -668,6 +694,18 @@ _archive_read_next_header2(struct archive *_a, struct archive_entry *entry)
 		break;
 	}
 
+	/*
+	 * Only a header that was read counts against the entry limit,
+	 * so an archive with exactly as many entries as the limit
+	 * still reaches its end.
+	 */
+	if ((r2 == ARCHIVE_OK || r2 == ARCHIVE_WARN) &&
+	    __archive_read_check_limit(a, ARCHIVE_READ_LIMIT_ENTRIES,
+	    _a->file_count, "entries") != ARCHIVE_OK) {
+		a->archive.state = ARCHIVE_STATE_FATAL;
+		r2 = ARCHIVE_FATAL;
+	}
+
 	__archive_reset_read_data(&a->archive);
 
 	a->data_start_node = a->client.cursor;
@@ -754,6 +792,100 @@ archive_read_header_position(struct archive *_a)
 	return (a->header_position);
 }
 
+/*
+ * Set a resource limit; see ARCHIVE_READ_LIMIT_* in archive.h.
+ */
+int
+archive_read_set_limit(struct archive *_a, int which, la_int64_t value)
+{
+	struct archive_read *a = (struct archive_read *)_a;
+
+	archive_check_magic(_a, ARCHIVE_READ_MAGIC,
+	    ARCHIVE_STATE_ANY, "archive_read_set_limit");
+	if (which < ARCHIVE_READ_LIMIT_ENTRIES ||
+	    which > ARCHIVE_READ_LIMIT_MEMORY || value < 0) {
+		archive_set_error(&a->archive, ARCHIVE_ERRNO_MISC,
+		    "Invalid read limit");
+		return (ARCHIVE_FAILED);
+	}
+	a->limits[which] = value;
+	return (ARCHIVE_OK);
+}
+
+/*
+ * Check value against a resource limit, reporting what went over.
+ */
+int
+__archive_read_check_limit(struct archive_read *a, int which,
+    int64_t value, const char *what)
+{
+	static const char *names[] = {
+		NULL, "entry count", "header size", "nesting depth",
+		"memory"
+	};
+
+	if (a->limits[which] == 0 || value <= a->limits[which])
+		return (ARCHIVE_OK);
+	archive_set_error(&a->archive, ARCHIVE_ERRNO_FILE_FORMAT,
+	    "%s exceeds the %s limit of %jd", what, names[which],
+	    (intmax_t)a->limits[which]);
+	return (ARCHIVE_FATAL);
+}
+
+/*
+ * Charge bytes of format tables built from the archive against the
+ * memory limit.
+ */
+int
+__archive_read_charge_memory(struct archive_read *a, int64_t bytes,
+    const char *what)
+{
+	a->memory_used += bytes;
+	return (__archive_read_check_limit(a, ARCHIVE_READ_LIMIT_MEMORY,
+	    a->memory_used, what));
+}
+
+/*
+ * Give back bytes charged with __archive_read_charge_memory() when
+ * the tables they paid for are freed before the archive is closed.
+ */
+void
+__archive_read_release_memory(struct archive_read *a, int64_t bytes)
+{
+	a->memory_used -= bytes;
+	if (a->memory_used < 0)
+		a->memory_used = 0;
+}
+
+/*
+ * Record the descriptor of a regular file that the archive is read
+ * from, or -1 when it is closed.
+ */
+void
+__archive_read_set_client_fd(struct archive *_a, int fd)
+{
+	struct archive_read *a = (struct archive_read *)_a;
+
+	/*
+	 * Positions in the input are offsets in the file only if the
+	 * file is read from the start.
+	 */
+	a->client_fd = -1;
+	if (fd >= 0 && lseek(fd, 0, SEEK_CUR) == 0)
+		a->client_fd = fd;
+}
+
+/*
+ * Called by a format's read_header when the next size bytes of the
+ * input are the entry's data, as is.
+ */
+void
+__archive_read_set_stored(struct archive_read *a, int64_t size)
+{
+	a->entry_stored_offset = a->filter->position;
+	a->entry_stored_size = size;
+}
+
 /*
  * Returns 1 if the archive contains at least one encrypted entry.
  * If the archive format not support encryption at all
@@ -976,6 +1108,9 @@ _archive_read_data_block(struct archive *_a,
 	archive_check_magic(_a, ARCHIVE_READ_MAGIC, ARCHIVE_STATE_DATA,
 	    "archive_read_data_block");
 
+	/* Once some of the data is read, it can't be copied in one piece. */
+	a->entry_stored_size = -1;
+
 	if (a->format->read_data == NULL) {
 		archive_set_error(&a->archive, ARCHIVE_ERRNO_PROGRAMMER,
 		    "Internal error: "
@@ -1385,8 +1520,7 @@ __archive_read_filter_ahead(struct archive_read_filter *filter,
 					*avail = filter->avail;
 				return (NULL);
 			}
-			bytes_read = (filter->vtable->read)(filter,
-			    &filter->client_buff);
+			bytes_read = filter_read(filter, &filter->client_buff);
 			if (bytes_read < 0) {		/* Read error. */
 				filter->client_total = filter->client_avail = 0;
 				filter->client_next =
@@ -1452,6 +1586,9 @@ __archive_read_filter_ahead(struct archive_read_filter *filter,
 				}
 				/* Now s >= min, so allocate a new buffer. */
 				p = malloc(s);
+				if (__archive_trace != NULL)
+					__archive_trace->count(
+					    ARCHIVE_TRACE_ALLOCATIONS, 1);
 				if (p == NULL) {
 					archive_set_error(
 						&filter->archive->archive,
@@ -1492,6 +1629,36 @@ __archive_read_filter_ahead(struct archive_read_filter *filter,
 	}
 }
 
+/*
+ * Pull the next block through a filter.  When tracing, the bottom
+ * filter's reads are counted as input and every other filter's reads
+ * as decompressed output.
+ */
+static ssize_t
+filter_read(struct archive_read_filter *filter, const void **buff)
+{
+	const struct archive_trace *trace = __archive_trace;
+	int64_t trace_start;
+	ssize_t bytes_read;
+
+	if (trace == NULL)
+		return ((filter->vtable->read)(filter, buff));
+
+	trace_start = trace->now();
+	bytes_read = (filter->vtable->read)(filter, buff);
+	if (filter->upstream == NULL) {
+		trace->phase(ARCHIVE_TRACE_READ, trace_start);
+		if (bytes_read > 0)
+			trace->count(ARCHIVE_TRACE_BYTES_READ, bytes_read);
+	} else {
+		trace->phase(ARCHIVE_TRACE_DECOMPRESS, trace_start);
+		if (bytes_read > 0)
+			trace->count(ARCHIVE_TRACE_BYTES_DECOMPRESSED,
+			    bytes_read);
+	}
+	return (bytes_read);
+}
+
 /*
  * Move the file pointer forward.
  */
@@ -1564,8 +1731,8 @@ advance_file_pointer(struct archive_read_filter *filter, int64_t request)
 		return (total_bytes_skipped);
 
 	/* If there's an optimized skip function, use it. */
-	if (filter->can_skip != 0) {
-		bytes_skipped = client_skip_proxy(filter, request);
+	if (filter->can_skip != 0 && filter->vtable->skip != NULL) {
+		bytes_skipped = (filter->vtable->skip)(filter, request);
 		if (bytes_skipped < 0) {	/* error */
 			filter->fatal = 1;
 			return (bytes_skipped);
@@ -1579,7 +1746,7 @@ advance_file_pointer(struct archive_read_filter *filter, int64_t request)
 
 	/* Use ordinary reads as necessary to complete the request. */
 	for (;;) {
-		bytes_read = (filter->vtable->read)(filter, &filter->client_buff);
+		bytes_read = filter_read(filter, &filter->client_buff);
 		if (bytes_read < 0) {
 			filter->client_buff = NULL;
 			filter->fatal = 1;
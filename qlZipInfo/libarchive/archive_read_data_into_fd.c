@@ -34,13 +34,149 @@
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif
 
 #include "archive.h"
 #include "archive_private.h"
+#include "archive_read_private.h"
 
 /* Maximum amount of data to write at one time. */
 #define	MAX_WRITE	(1024 * 1024)
 
+/* Maximum amount of data to copy in the kernel at one time. */
+#define	MAX_COPY	(1024 * 1024 * 1024)
+
+#if defined(HAVE_COPY_FILE_RANGE) || defined(HAVE_SYS_SENDFILE_H)
+/*
+ * Errors that mean a kernel copy isn't supported between these two
+ * descriptors, rather than that the copy failed.
+ */
+static int
+copy_unsupported(int err)
+{
+	return (err == EXDEV || err == EINVAL || err == ENOSYS ||
+	    err == EBADF || err == EOPNOTSUPP);
+}
+#endif
+
+/*
+ * Copy the data of a stored entry (see __archive_read_set_stored())
+ * straight from the archive file to fd: with copy_file_range() or
+ * sendfile() where they work, else with pread() and write().  The
+ * format then skips the data it didn't read.
+ */
+static int
+copy_stored(struct archive_read *a, int fd)
+{
+	int64_t offset = a->entry_stored_offset;
+	int64_t remaining = a->entry_stored_size;
+	size_t to_copy, written;
+	ssize_t bytes_copied, bytes_written;
+	char *buff = NULL;
+	int method = 0;
+	int r;
+
+	while (remaining > 0) {
+		to_copy = MAX_COPY;
+		if (remaining < (int64_t)to_copy)
+			to_copy = (size_t)remaining;
+		bytes_copied = -1;
+#ifdef HAVE_COPY_FILE_RANGE
+		if (method == 0) {
+			off_t off_in = (off_t)offset;
+
+			bytes_copied = copy_file_range(a->client_fd, &off_in,
+			    fd, NULL, to_copy, 0);
+			if (bytes_copied < 0 && errno == EINTR)
+				continue;
+			if (bytes_copied < 0 && copy_unsupported(errno)) {
+				method = 1;
+				continue;
+			}
+		}
+#else
+		if (method == 0)
+			method = 1;
+#endif
+#ifdef HAVE_SYS_SENDFILE_H
+		if (method == 1) {
+			off_t off_in = (off_t)offset;
+
+			bytes_copied = sendfile(fd, a->client_fd, &off_in,
+			    to_copy);
+			if (bytes_copied < 0 && errno == EINTR)
+				continue;
+			if (bytes_copied < 0 && copy_unsupported(errno)) {
+				method = 2;
+				continue;
+			}
+		}
+#else
+		if (method == 1)
+			method = 2;
+#endif
+		if (method == 2) {
+			if (buff == NULL) {
+				buff = malloc(MAX_WRITE);
+				if (buff == NULL) {
+					archive_set_error(&a->archive, ENOMEM,
+					    "No memory");
+					return (ARCHIVE_FATAL);
+				}
+			}
+			if (to_copy > MAX_WRITE)
+				to_copy = MAX_WRITE;
+			bytes_copied = pread(a->client_fd, buff, to_copy,
+			    (off_t)offset);
+			if (bytes_copied < 0 && errno == EINTR)
+				continue;
+			/* A short write isn't an error; write the rest. */
+			for (written = 0; bytes_copied > 0 &&
+			    written < (size_t)bytes_copied;
+			    written += bytes_written) {
+				bytes_written = write(fd, buff + written,
+				    (size_t)bytes_copied - written);
+				if (bytes_written < 0 && errno == EINTR) {
+					bytes_written = 0;
+					continue;
+				}
+				if (bytes_written <= 0) {
+					archive_set_error(&a->archive,
+					    (bytes_written < 0) ? errno :
+					    ARCHIVE_ERRNO_MISC,
+					    "Write error");
+					free(buff);
+					return (ARCHIVE_FATAL);
+				}
+			}
+		}
+		if (bytes_copied < 0) {
+			archive_set_error(&a->archive, errno, "Copy error");
+			free(buff);
+			return (ARCHIVE_FATAL);
+		}
+		if (bytes_copied == 0) {
+			archive_set_error(&a->archive, ARCHIVE_ERRNO_MISC,
+			    "Truncated archive");
+			free(buff);
+			return (ARCHIVE_FATAL);
+		}
+		offset += bytes_copied;
+		remaining -= bytes_copied;
+	}
+	free(buff);
+
+	r = archive_read_data_skip(&a->archive);
+	if (r == ARCHIVE_OK)
+		r = ARCHIVE_EOF;
+	return (r);
+}
+
 /*
  * This implementation minimizes copying of data and is sparse-file aware.
  */
@@ -79,6 +215,7 @@ pad_to(struct archive *a, int fd, int can_lseek,
 int
 archive_read_data_into_fd(struct archive *a, int fd)
 {
+	struct archive_read *ra;
 	struct stat st;
 	int r, r2;
 	const void *buff;
@@ -93,6 +230,18 @@ archive_read_data_into_fd(struct archive *a, int fd)
 	archive_check_magic(a, ARCHIVE_READ_MAGIC, ARCHIVE_STATE_DATA,
 	    "archive_read_data_into_fd");
 
+	/*
+	 * The data of a stored entry that hasn't been read yet can be
+	 * copied straight from an uncompressed archive file.
+	 */
+	ra = (struct archive_read *)a;
+	if (ra->entry_stored_size > 0 && ra->client_fd >= 0 &&
+	    ra->client.nodes <= 1 && ra->filter->upstream == NULL &&
+	    ra->filter->position == ra->entry_stored_offset) {
+		r = copy_stored(ra, fd);
+		goto cleanup;
+	}
+
 	can_lseek = (fstat(fd, &st) == 0) && S_ISREG(st.st_mode);
 	if (!can_lseek) {
 		nulls = calloc(1, nulls_size);
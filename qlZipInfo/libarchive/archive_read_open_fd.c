@@ -48,6 +48,8 @@
 #endif
 
 #include "archive.h"
+#include "archive_private.h"
+#include "archive_read_private.h"
 
 struct read_fd_data {
 	int	 fd;
@@ -95,6 +97,8 @@ archive_read_open_fd(struct archive *a, int fd, size_t block_size)
 	if (S_ISREG(st.st_mode)) {
 		archive_read_extract_set_skip_file(a, st.st_dev, st.st_ino);
 		mine->use_lseek = 1;
+		/* Stored entries can be copied straight from the file. */
+		__archive_read_set_client_fd(a, fd);
 	}
 #if defined(__CYGWIN__) || defined(_WIN32)
 	setmode(mine->fd, O_BINARY);
@@ -203,7 +207,7 @@ file_close(struct archive *a, void *client_data)
 {
 	struct read_fd_data *mine = (struct read_fd_data *)client_data;
 
-	(void)a; /* UNUSED */
+	__archive_read_set_client_fd(a, -1);
 	free(mine->buffer);
 	free(mine);
 	return (ARCHIVE_OK);
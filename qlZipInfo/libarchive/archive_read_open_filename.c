@@ -60,6 +60,7 @@
 
 #include "archive.h"
 #include "archive_private.h"
+#include "archive_read_private.h"
 #include "archive_string.h"
 
 #ifndef O_BINARY
@@ -403,6 +404,10 @@ file_open(struct archive *a, void *client_data)
 	if (is_disk_like)
 		mine->use_lseek = 1;
 
+	/* Stored entries can be copied straight from a regular file. */
+	if (S_ISREG(st.st_mode))
+		__archive_read_set_client_fd(a, fd);
+
 	return (ARCHIVE_OK);
 fail:
 	/*
@@ -565,7 +570,7 @@ file_close2(struct archive *a, void *client_data)
 {
 	struct read_file_data *mine = (struct read_file_data *)client_data;
 
-	(void)a; /* UNUSED */
+	__archive_read_set_client_fd(a, -1);
 
 	/* Only flush and close if open succeeded. */
 	if (mine->fd >= 0) {
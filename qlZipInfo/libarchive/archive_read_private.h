@@ -46,6 +46,9 @@ struct archive_read_filter_bidder_vtable {
 	    struct archive_read_filter *);
 	/* Initialize a newly-created filter. */
 	int (*init)(struct archive_read_filter *);
+	/* Set an option for the filters created from now on. */
+	int (*options)(struct archive_read_filter_bidder *,
+	    const char *key, const char *value);
 	/* Release the bidder's configuration data. */
 	void (*free)(struct archive_read_filter_bidder *);
 };
@@ -76,6 +79,9 @@ struct archive_read_filter_bidder {
 struct archive_read_filter_vtable {
 	/* Return next block. */
 	ssize_t (*read)(struct archive_read_filter *, const void **);
+	/* Skip forward without returning the data (filters that set
+	 * can_skip); returns the bytes skipped. */
+	int64_t (*skip)(struct archive_read_filter *, int64_t request);
 	/* Close (just this filter) and free(self). */
 	int (*close)(struct archive_read_filter *self);
 	/* Read any header metadata if available. */
@@ -180,6 +186,35 @@ struct archive_read {
 	/* File offset of beginning of most recently-read header. */
 	int64_t		  header_position;
 
+	/*
+	 * The descriptor of the archive, when it is a single regular
+	 * file opened with archive_read_open_fd() or
+	 * archive_read_open_filename() and read from its start, or -1.
+	 */
+	int		  client_fd;
+
+	/*
+	 * Set by a format's read_header when the entry's data is
+	 * stored as is, in one piece, starting at the current
+	 * position: the position and the size of the data, or -1.
+	 * archive_read_data_into_fd() copies such data straight from
+	 * client_fd.
+	 */
+	int64_t		  entry_stored_offset;
+	int64_t		  entry_stored_size;
+
+	/*
+	 * Resource limits set with archive_read_set_limit(), indexed
+	 * by ARCHIVE_READ_LIMIT_*; zero means unlimited.  Formats
+	 * check them with __archive_read_check_limit() and charge the
+	 * tables they build from the archive to memory_used, and
+	 * release the charge for tables they free before the archive
+	 * is closed, so memory_used is what is in use, not what has
+	 * ever been allocated.
+	 */
+	int64_t		  limits[ARCHIVE_READ_LIMIT_MEMORY + 1];
+	int64_t		  memory_used;
+
 	/* Nodes and offsets of compressed data block */
 	unsigned int data_start_node;
 	unsigned int data_end_node;
@@ -252,6 +287,13 @@ int64_t	__archive_read_filter_seek(struct archive_read_filter *, int64_t, int);
 int64_t	__archive_read_consume(struct archive_read *, int64_t);
 int64_t	__archive_read_filter_consume(struct archive_read_filter *, int64_t);
 int __archive_read_header(struct archive_read *, struct archive_entry *);
+int __archive_read_check_limit(struct archive_read *, int, int64_t,
+    const char *);
+int __archive_read_charge_memory(struct archive_read *, int64_t,
+    const char *);
+void __archive_read_release_memory(struct archive_read *, int64_t);
+void __archive_read_set_client_fd(struct archive *, int);
+void __archive_read_set_stored(struct archive_read *, int64_t);
 int __archive_read_program(struct archive_read_filter *, const char *);
 void __archive_read_free_filters(struct archive_read *);
 struct archive_read_extract *__archive_read_get_extract(struct archive_read *);
@@ -72,6 +72,9 @@ archive_read_support_filter_all(struct archive *a)
 	archive_read_support_filter_lz4(a);
 	/* Zstd falls back to "zstd -d" command-line program. */
 	archive_read_support_filter_zstd(a);
+	/* Pbzx needs liblzma; there is no command-line fallback. */
+	archive_read_support_filter_pbzx(a);
+	archive_read_support_filter_udif(a);
 
 	/* Note: We always return ARCHIVE_OK here, even if some of the
 	 * above return ARCHIVE_WARN.  The intent here is to enable
@@ -77,6 +77,11 @@ archive_read_support_filter_by_code(struct archive *a, int filter_code)
 	case ARCHIVE_FILTER_ZSTD:
 		return archive_read_support_filter_zstd(a);
 		break;
+	case ARCHIVE_FILTER_PBZX:
+		return archive_read_support_filter_pbzx(a);
+	case ARCHIVE_FILTER_UDIF:
+		return archive_read_support_filter_udif(a);
+		break;
 	}
 	return (ARCHIVE_FATAL);
 }
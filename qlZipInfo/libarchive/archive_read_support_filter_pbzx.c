@@ -0,0 +1,682 @@
+/*-
+ * Copyright (c) 2026 Sriranga R. Veeraraghavan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR(S) ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR(S) BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "archive_platform.h"
+
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#include <stdio.h>
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+#if HAVE_LZMA_H
+#include <lzma.h>
+#endif
+
+#include "archive.h"
+#include "archive_endian.h"
+#include "archive_private.h"
+#include "archive_read_private.h"
+
+/*
+ * pbzx is the compression Apple uses for the payloads of flat
+ * packages (.pkg) and of .xip files.  After the "pbzx" magic and a
+ * 64-bit chunk size, the data is a series of chunks, each with a
+ * 64-bit uncompressed size and a 64-bit compressed size (both big
+ * endian) followed by the chunk's data: a complete xz stream, or the
+ * data itself if the two sizes are equal.  Every chunk but the last
+ * holds a full chunk size of data.
+ *
+ * The chunks are independent, so they are decoded in parallel.  The
+ * reader's thread copies each chunk into the next free slot of a
+ * ring (the upstream filters may only be used from that thread), a
+ * pool of worker threads decodes the queued slots, and the read
+ * function returns the slots' data in order.  The reader's thread
+ * decodes the slot it is waiting for itself if no worker has taken
+ * it yet.
+ *
+ * The number of threads, including the reader's, is the number of
+ * online processors, at most PBZX_MAX_THREADS, unless it is set with
+ * the "pbzx:threads" option.  With 1 thread, or without pthreads,
+ * every chunk is decoded by the reader's thread.
+ */
+
+#define PBZX_MAGIC		"pbzx"
+#define PBZX_HEADER_SIZE	12
+#define PBZX_CHUNK_HEADER_SIZE	16
+#define PBZX_MAX_CHUNK_SIZE	(64 * 1024 * 1024)
+#define PBZX_MAX_THREADS	8
+#define PBZX_DECODER_MEMLIMIT	(256 * 1024 * 1024)
+
+struct pbzx_options {
+	int		 threads;	/* 0 = number of online processors */
+};
+
+#if HAVE_LZMA_H && HAVE_LIBLZMA
+
+enum pbzx_slot_state {
+	SLOT_FREE,	/* Can be filled by the reader's thread. */
+	SLOT_QUEUED,	/* Holds compressed data. */
+	SLOT_BUSY,	/* Being decoded. */
+	SLOT_DONE,	/* Holds decoded data. */
+	SLOT_FAILED	/* Couldn't be decoded. */
+};
+
+struct pbzx_slot {
+	enum pbzx_slot_state state;
+	char		 stored;
+	lzma_ret	 ret;
+	unsigned char	*in;
+	size_t		 in_size;
+	size_t		 in_alloc;
+	unsigned char	*out;
+	size_t		 out_size;
+	size_t		 out_alloc;
+};
+
+struct pbzx {
+	size_t		 chunk_size;
+	int		 threads;
+	struct pbzx_slot *slots;
+	int		 nslots;
+	uint64_t	 next_in;	/* Sequence number of the next chunk read. */
+	uint64_t	 next_out;	/* Sequence number of the next chunk returned. */
+	int		 held;		/* Slot returned by the last read, or -1. */
+	char		 end_of_input;
+	char		 started;
+	/* Error reading the input, reported after the chunks before it. */
+	int		 input_errno;
+	char		 input_error[128];
+#ifdef HAVE_PTHREAD_H
+	pthread_mutex_t	 lock;
+	pthread_cond_t	 queued;	/* A slot was queued, or stopping. */
+	pthread_cond_t	 decoded;	/* A slot was decoded. */
+	pthread_t	*workers;
+	int		 nworkers;
+	char		 stopping;
+#endif
+};
+
+#endif /* HAVE_LZMA_H && HAVE_LIBLZMA */
+
+static int	pbzx_bidder_bid(struct archive_read_filter_bidder *,
+		    struct archive_read_filter *);
+static int	pbzx_bidder_init(struct archive_read_filter *);
+static int	pbzx_bidder_options(struct archive_read_filter_bidder *,
+		    const char *, const char *);
+static void	pbzx_bidder_free(struct archive_read_filter_bidder *);
+
+static const struct archive_read_filter_bidder_vtable
+pbzx_bidder_vtable = {
+	.bid = pbzx_bidder_bid,
+	.init = pbzx_bidder_init,
+	.options = pbzx_bidder_options,
+	.free = pbzx_bidder_free,
+};
+
+int
+archive_read_support_filter_pbzx(struct archive *_a)
+{
+	struct archive_read *a = (struct archive_read *)_a;
+	struct pbzx_options *options;
+
+	archive_check_magic(_a, ARCHIVE_READ_MAGIC,
+	    ARCHIVE_STATE_NEW, "archive_read_support_filter_pbzx");
+
+	options = calloc(1, sizeof(*options));
+	if (options == NULL) {
+		archive_set_error(_a, ENOMEM,
+		    "Can't allocate data for pbzx");
+		return (ARCHIVE_FATAL);
+	}
+
+	if (__archive_read_register_bidder(a, options, "pbzx",
+				&pbzx_bidder_vtable) != ARCHIVE_OK) {
+		free(options);
+		return (ARCHIVE_FATAL);
+	}
+
+#if HAVE_LZMA_H && HAVE_LIBLZMA
+	return (ARCHIVE_OK);
+#else
+	archive_set_error(_a, ARCHIVE_ERRNO_MISC,
+	    "pbzx decompression requires liblzma");
+	return (ARCHIVE_WARN);
+#endif
+}
+
+static void
+pbzx_bidder_free(struct archive_read_filter_bidder *self)
+{
+	free(self->data);
+	self->data = NULL;
+}
+
+static int
+pbzx_bidder_options(struct archive_read_filter_bidder *self,
+    const char *key, const char *val)
+{
+	struct pbzx_options *options = (struct pbzx_options *)self->data;
+	long threads;
+	char *end;
+
+	if (strcmp(key, "threads") == 0) {
+		if (val == NULL || val[0] == '\0') {
+			options->threads = 0;
+			return (ARCHIVE_OK);
+		}
+		threads = strtol(val, &end, 10);
+		if (*end != '\0' || threads < 0)
+			return (ARCHIVE_FAILED);
+		options->threads = (threads > PBZX_MAX_THREADS) ?
+		    PBZX_MAX_THREADS : (int)threads;
+		return (ARCHIVE_OK);
+	}
+
+	/* Note: The "warn" return is just to inform the options
+	 * supervisor that we didn't handle it.  It will generate
+	 * a suitable error if no one used this option. */
+	return (ARCHIVE_WARN);
+}
+
+/*
+ * Test whether we can handle this data: the magic and a sane chunk
+ * size.
+ */
+static int
+pbzx_bidder_bid(struct archive_read_filter_bidder *self,
+    struct archive_read_filter *filter)
+{
+	const unsigned char *b;
+	ssize_t avail;
+	uint64_t chunk_size;
+
+	(void)self; /* UNUSED */
+
+	b = __archive_read_filter_ahead(filter, PBZX_HEADER_SIZE, &avail);
+	if (b == NULL)
+		return (0);
+
+	if (memcmp(b, PBZX_MAGIC, 4) != 0)
+		return (0);
+	chunk_size = archive_be64dec(b + 4);
+	if (chunk_size == 0 || chunk_size > PBZX_MAX_CHUNK_SIZE)
+		return (0);
+
+	return (48);
+}
+
+#if !(HAVE_LZMA_H && HAVE_LIBLZMA)
+
+/*
+ * If we don't have liblzma on this system, we can't actually do the
+ * decompression.
+ */
+static int
+pbzx_bidder_init(struct archive_read_filter *self)
+{
+	archive_set_error(&self->archive->archive, ARCHIVE_ERRNO_MISC,
+	    "pbzx decompression requires liblzma");
+	return (ARCHIVE_FATAL);
+}
+
+#else
+
+static ssize_t	pbzx_filter_read(struct archive_read_filter *,
+		    const void **);
+static int	pbzx_filter_close(struct archive_read_filter *);
+
+static const struct archive_read_filter_vtable
+pbzx_reader_vtable = {
+	.read = pbzx_filter_read,
+	.close = pbzx_filter_close,
+};
+
+#ifdef HAVE_PTHREAD_H
+#define	pbzx_lock(state)	pthread_mutex_lock(&(state)->lock)
+#define	pbzx_unlock(state)	pthread_mutex_unlock(&(state)->lock)
+#else
+#define	pbzx_lock(state)	((void)0)
+#define	pbzx_unlock(state)	((void)0)
+#endif
+
+static int
+pbzx_default_threads(void)
+{
+	long n = 1;
+
+#if defined(HAVE_UNISTD_H) && defined(_SC_NPROCESSORS_ONLN)
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	if (n < 1)
+		n = 1;
+	if (n > PBZX_MAX_THREADS)
+		n = PBZX_MAX_THREADS;
+	return ((int)n);
+}
+
+static int
+pbzx_bidder_init(struct archive_read_filter *self)
+{
+	struct pbzx_options *options =
+	    (struct pbzx_options *)self->bidder->data;
+	struct pbzx *state;
+	const unsigned char *b;
+	ssize_t avail;
+
+	self->code = ARCHIVE_FILTER_PBZX;
+	self->name = "pbzx";
+
+	b = __archive_read_filter_ahead(self->upstream, PBZX_HEADER_SIZE,
+	    &avail);
+	if (b == NULL) {
+		archive_set_error(&self->archive->archive,
+		    ARCHIVE_ERRNO_FILE_FORMAT, "Truncated pbzx header");
+		return (ARCHIVE_FATAL);
+	}
+
+	state = calloc(1, sizeof(*state));
+	if (state == NULL) {
+		archive_set_error(&self->archive->archive, ENOMEM,
+		    "Can't allocate data for pbzx decompression");
+		return (ARCHIVE_FATAL);
+	}
+
+	state->chunk_size = (size_t)archive_be64dec(b + 4);
+	__archive_read_filter_consume(self->upstream, PBZX_HEADER_SIZE);
+
+	state->threads = (options != NULL && options->threads > 0) ?
+	    options->threads : pbzx_default_threads();
+#ifndef HAVE_PTHREAD_H
+	state->threads = 1;
+#endif
+	/* One slot is held by the caller, one is being filled. */
+	state->nslots = state->threads + 2;
+	state->slots = calloc(state->nslots, sizeof(*state->slots));
+	if (state->slots == NULL) {
+		free(state);
+		archive_set_error(&self->archive->archive, ENOMEM,
+		    "Can't allocate data for pbzx decompression");
+		return (ARCHIVE_FATAL);
+	}
+	state->held = -1;
+
+#ifdef HAVE_PTHREAD_H
+	if (pthread_mutex_init(&state->lock, NULL) != 0 ||
+	    pthread_cond_init(&state->queued, NULL) != 0 ||
+	    pthread_cond_init(&state->decoded, NULL) != 0) {
+		free(state->slots);
+		free(state);
+		archive_set_error(&self->archive->archive, ENOMEM,
+		    "Can't initialize pbzx locks");
+		return (ARCHIVE_FATAL);
+	}
+#endif
+
+	self->data = state;
+	self->vtable = &pbzx_reader_vtable;
+
+	return (ARCHIVE_OK);
+}
+
+/*
+ * Decode a queued slot.  Called without the lock, by a worker or by
+ * the reader's thread.
+ */
+static enum pbzx_slot_state
+pbzx_decode(struct pbzx_slot *slot)
+{
+	uint64_t memlimit = PBZX_DECODER_MEMLIMIT;
+	size_t in_pos = 0, out_pos = 0;
+
+	slot->ret = lzma_stream_buffer_decode(&memlimit, 0, NULL,
+	    slot->in, &in_pos, slot->in_size,
+	    slot->out, &out_pos, slot->out_size);
+	if (slot->ret != LZMA_OK)
+		return (SLOT_FAILED);
+	if (out_pos != slot->out_size) {
+		slot->ret = LZMA_DATA_ERROR;
+		return (SLOT_FAILED);
+	}
+	return (SLOT_DONE);
+}
+
+#ifdef HAVE_PTHREAD_H
+
+/*
+ * Worker thread: decode the queued slot with the lowest sequence
+ * number until the filter is closed.
+ */
+static void *
+pbzx_worker(void *arg)
+{
+	struct pbzx *state = (struct pbzx *)arg;
+	struct pbzx_slot *slot;
+	enum pbzx_slot_state done;
+	uint64_t seq;
+
+	pbzx_lock(state);
+	for (;;) {
+		slot = NULL;
+		for (seq = state->next_out; seq < state->next_in; seq++) {
+			if (state->slots[seq % state->nslots].state ==
+			    SLOT_QUEUED) {
+				slot = &state->slots[seq % state->nslots];
+				break;
+			}
+		}
+		if (slot == NULL) {
+			if (state->stopping)
+				break;
+			pthread_cond_wait(&state->queued, &state->lock);
+			continue;
+		}
+		slot->state = SLOT_BUSY;
+		pbzx_unlock(state);
+		done = pbzx_decode(slot);
+		pbzx_lock(state);
+		slot->state = done;
+		pthread_cond_broadcast(&state->decoded);
+	}
+	pbzx_unlock(state);
+	return (NULL);
+}
+
+static void
+pbzx_start_workers(struct pbzx *state)
+{
+	int i;
+
+	if (state->threads < 2)
+		return;
+	state->workers = calloc(state->threads - 1,
+	    sizeof(*state->workers));
+	if (state->workers == NULL)
+		return;
+	/* If a thread can't be created, make do with fewer. */
+	for (i = 0; i < state->threads - 1; i++) {
+		if (pthread_create(&state->workers[i], NULL, pbzx_worker,
+		    state) != 0)
+			break;
+		state->nworkers++;
+	}
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+/*
+ * Grow a slot's buffer to size bytes, charging the memory limit for
+ * the growth.
+ */
+static int
+pbzx_reserve(struct archive_read_filter *self, unsigned char **buf,
+    size_t *alloc, size_t size)
+{
+	unsigned char *p;
+
+	if (*alloc >= size)
+		return (ARCHIVE_OK);
+	if (__archive_read_charge_memory(self->archive,
+	    (int64_t)(size - *alloc), "pbzx buffers") != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
+	p = realloc(*buf, size);
+	if (p == NULL) {
+		archive_set_error(&self->archive->archive, ENOMEM,
+		    "Can't allocate data for pbzx decompression");
+		return (ARCHIVE_FATAL);
+	}
+	*buf = p;
+	*alloc = size;
+	return (ARCHIVE_OK);
+}
+
+/*
+ * Copy the next chunk from upstream into a free slot.  Sets
+ * end_of_input after the last chunk.
+ */
+static int
+pbzx_read_chunk(struct archive_read_filter *self, struct pbzx_slot *slot)
+{
+	struct pbzx *state = (struct pbzx *)self->data;
+	const unsigned char *b;
+	ssize_t avail;
+	uint64_t usize, csize;
+	size_t copied, n;
+
+	b = __archive_read_filter_ahead(self->upstream,
+	    PBZX_CHUNK_HEADER_SIZE, &avail);
+	if (b == NULL) {
+		if (avail == 0) {
+			/* A last chunk of exactly chunk_size bytes. */
+			state->end_of_input = 1;
+			return (ARCHIVE_EOF);
+		}
+		if (avail > 0)
+			archive_set_error(&self->archive->archive,
+			    ARCHIVE_ERRNO_FILE_FORMAT,
+			    "Truncated pbzx chunk header");
+		return (ARCHIVE_FATAL);
+	}
+	usize = archive_be64dec(b);
+	csize = archive_be64dec(b + 8);
+	if (usize == 0 || usize > state->chunk_size || csize == 0 ||
+	    csize > lzma_stream_buffer_bound(state->chunk_size)) {
+		archive_set_error(&self->archive->archive,
+		    ARCHIVE_ERRNO_FILE_FORMAT, "Invalid pbzx chunk header");
+		return (ARCHIVE_FATAL);
+	}
+	__archive_read_filter_consume(self->upstream, PBZX_CHUNK_HEADER_SIZE);
+
+	if (pbzx_reserve(self, &slot->in, &slot->in_alloc,
+	    (size_t)csize) != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
+	for (copied = 0; copied < csize; copied += n) {
+		b = __archive_read_filter_ahead(self->upstream, 1, &avail);
+		if (b == NULL) {
+			if (avail >= 0)
+				archive_set_error(&self->archive->archive,
+				    ARCHIVE_ERRNO_FILE_FORMAT,
+				    "Truncated pbzx chunk");
+			return (ARCHIVE_FATAL);
+		}
+		n = (size_t)csize - copied;
+		if (n > (size_t)avail)
+			n = (size_t)avail;
+		memcpy(slot->in + copied, b, n);
+		__archive_read_filter_consume(self->upstream, n);
+	}
+	slot->in_size = (size_t)csize;
+	slot->out_size = (size_t)usize;
+
+	/* A chunk that didn't compress is stored as is. */
+	slot->stored = (csize == usize &&
+	    (csize < 6 || memcmp(slot->in, "\xFD" "7zXZ\x00", 6) != 0));
+	if (!slot->stored && pbzx_reserve(self, &slot->out,
+	    &slot->out_alloc, (size_t)usize) != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
+
+	if (usize < state->chunk_size)
+		state->end_of_input = 1;
+	return (ARCHIVE_OK);
+}
+
+/*
+ * Fill the free slots with the following chunks.  An error stops the
+ * input; it is returned once the chunks read before it have been.
+ */
+static void
+pbzx_queue_chunks(struct archive_read_filter *self)
+{
+	struct pbzx *state = (struct pbzx *)self->data;
+	struct pbzx_slot *slot;
+	int r;
+
+	while (!state->end_of_input) {
+		slot = &state->slots[state->next_in % state->nslots];
+		pbzx_lock(state);
+		r = (slot->state == SLOT_FREE);
+		pbzx_unlock(state);
+		if (!r)
+			break;
+
+		r = pbzx_read_chunk(self, slot);
+		if (r == ARCHIVE_EOF)
+			break;
+		if (r != ARCHIVE_OK) {
+			state->end_of_input = 1;
+			state->input_errno =
+			    archive_errno(&self->archive->archive);
+			if (state->input_errno == 0)
+				state->input_errno = ARCHIVE_ERRNO_MISC;
+			snprintf(state->input_error,
+			    sizeof(state->input_error), "%s",
+			    archive_error_string(&self->archive->archive) ?
+			    archive_error_string(&self->archive->archive) :
+			    "Can't read pbzx chunk");
+			break;
+		}
+
+		pbzx_lock(state);
+		slot->state = slot->stored ? SLOT_DONE : SLOT_QUEUED;
+		state->next_in++;
+#ifdef HAVE_PTHREAD_H
+		pthread_cond_signal(&state->queued);
+#endif
+		pbzx_unlock(state);
+	}
+}
+
+/*
+ * Return the next chunk's data.
+ */
+static ssize_t
+pbzx_filter_read(struct archive_read_filter *self, const void **p)
+{
+	struct pbzx *state = (struct pbzx *)self->data;
+	struct pbzx_slot *slot;
+	enum pbzx_slot_state done;
+	int idx;
+
+	*p = NULL;
+
+	/* The data returned last time is no longer needed. */
+	if (state->held >= 0) {
+		pbzx_lock(state);
+		state->slots[state->held].state = SLOT_FREE;
+		pbzx_unlock(state);
+		state->held = -1;
+	}
+
+#ifdef HAVE_PTHREAD_H
+	if (!state->started)
+		pbzx_start_workers(state);
+#endif
+	state->started = 1;
+
+	pbzx_queue_chunks(self);
+	if (state->next_out == state->next_in) {
+		if (state->input_errno != 0) {
+			archive_set_error(&self->archive->archive,
+			    state->input_errno, "%s", state->input_error);
+			return (ARCHIVE_FATAL);
+		}
+		return (0);
+	}
+
+	idx = (int)(state->next_out % state->nslots);
+	slot = &state->slots[idx];
+
+	pbzx_lock(state);
+#ifdef HAVE_PTHREAD_H
+	while (slot->state == SLOT_BUSY)
+		pthread_cond_wait(&state->decoded, &state->lock);
+#endif
+	if (slot->state == SLOT_QUEUED) {
+		/* No worker has taken it yet, so decode it here. */
+		slot->state = SLOT_BUSY;
+		pbzx_unlock(state);
+		done = pbzx_decode(slot);
+		pbzx_lock(state);
+		slot->state = done;
+	}
+	state->next_out++;
+	pbzx_unlock(state);
+
+	state->held = idx;
+	if (slot->state == SLOT_FAILED) {
+		archive_set_error(&self->archive->archive,
+		    ARCHIVE_ERRNO_MISC,
+		    "pbzx chunk %ju can't be decoded (liblzma error %d)",
+		    (uintmax_t)(state->next_out - 1), (int)slot->ret);
+		return (ARCHIVE_FATAL);
+	}
+
+	*p = slot->stored ? slot->in : slot->out;
+	return ((ssize_t)slot->out_size);
+}
+
+/*
+ * Clean up the decompressor.
+ */
+static int
+pbzx_filter_close(struct archive_read_filter *self)
+{
+	struct pbzx *state = (struct pbzx *)self->data;
+	int i;
+
+#ifdef HAVE_PTHREAD_H
+	pbzx_lock(state);
+	state->stopping = 1;
+	pthread_cond_broadcast(&state->queued);
+	pbzx_unlock(state);
+	for (i = 0; i < state->nworkers; i++)
+		pthread_join(state->workers[i], NULL);
+	free(state->workers);
+	pthread_cond_destroy(&state->decoded);
+	pthread_cond_destroy(&state->queued);
+	pthread_mutex_destroy(&state->lock);
+#endif
+
+	for (i = 0; i < state->nslots; i++) {
+		free(state->slots[i].in);
+		free(state->slots[i].out);
+	}
+	free(state->slots);
+	free(state);
+
+	return (ARCHIVE_OK);
+}
+
+#endif /* HAVE_LZMA_H && HAVE_LIBLZMA */
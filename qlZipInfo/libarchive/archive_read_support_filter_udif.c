@@ -0,0 +1,1221 @@
+/*-
+ * Copyright (c) 2026 Sriranga R. Veeraraghavan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR(S) ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR(S) BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "archive_platform.h"
+
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#include <stdio.h>
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+#ifdef HAVE_ZLIB_H
+#include <zlib.h>
+#endif
+#ifdef HAVE_BZLIB_H
+#include <bzlib.h>
+#endif
+#if HAVE_LZMA_H
+#include <lzma.h>
+#endif
+#if defined(HAVE_COMPRESSION_H) && defined(HAVE_LIBCOMPRESSION)
+#include <compression.h>
+#endif
+
+#include "archive.h"
+#include "archive_endian.h"
+#include "archive_private.h"
+#include "archive_read_private.h"
+
+/*
+ * A UDIF disk image (.dmg) is the image's sectors, in chunks that are
+ * each stored, zero filled, or compressed on their own (ADC, zlib,
+ * bzip2, LZFSE or LZMA), followed by an XML property list and a 512
+ * byte "koly" trailer that gives the property list's offset.  The
+ * property list's "blkx" array holds a base64 "mish" table for each
+ * partition, which maps runs of sectors to chunks of the file.
+ *
+ * This filter reads the trailer and the tables when it is created,
+ * so it needs an input that can seek (a file opened with
+ * archive_read_open_filename() or archive_read_open_fd()), and
+ * returns the image's sectors in order, with the chunks decoded by a
+ * pool of worker threads as in the pbzx filter.  It also skips: a
+ * chunk that is skipped over, such as the data of a file that the
+ * iso9660 reader passes over, is neither read nor decoded, so
+ * listing an image only decodes the chunks that hold the volume
+ * descriptors and directories.
+ *
+ * Chunks are read ahead with a window that starts at one chunk after
+ * each skip and doubles with each chunk read in order, up to one
+ * chunk per thread, so listing doesn't decode chunks that are then
+ * skipped, and reading the whole image keeps every thread busy.  The
+ * number of threads is set as for pbzx, with the "udif:threads"
+ * option.  Images in more than one segment (.dmgpart) aren't read.
+ */
+
+#define UDIF_KOLY_SIZE		512
+#define UDIF_MISH_SIZE		204
+#define UDIF_MISH_CHUNK_SIZE	40
+#define UDIF_SECTOR_SIZE	512
+#define UDIF_MAX_XML		(64 * 1024 * 1024)
+#define UDIF_MAX_CHUNK_SIZE	(64 * 1024 * 1024)
+#define UDIF_MAX_CHUNKS		(4 * 1024 * 1024)
+#define UDIF_PIECE_SIZE		(1024 * 1024)
+#define UDIF_MAX_THREADS	8
+#define UDIF_DECODER_MEMLIMIT	(256 * 1024 * 1024)
+
+/* Chunk types of a mish table. */
+#define UDIF_ZERO		0x00000000
+#define UDIF_RAW		0x00000001
+#define UDIF_IGNORE		0x00000002
+#define UDIF_ADC		0x80000004
+#define UDIF_ZLIB		0x80000005
+#define UDIF_BZIP2		0x80000006
+#define UDIF_LZFSE		0x80000007
+#define UDIF_LZMA		0x80000008
+#define UDIF_COMMENT		0x7ffffffe
+#define UDIF_TERMINATOR		0xffffffff
+
+struct udif_options {
+	int		 threads;	/* 0 = number of online processors */
+};
+
+enum udif_slot_state {
+	SLOT_FREE,	/* Can be filled by the reader's thread. */
+	SLOT_QUEUED,	/* Holds a chunk's data from the file. */
+	SLOT_BUSY,	/* Being decoded. */
+	SLOT_DONE,	/* Holds the chunk's sectors. */
+	SLOT_FAILED	/* Couldn't be decoded. */
+};
+
+/* A run of the image's bytes. */
+struct udif_chunk {
+	uint64_t	 start;		/* Offset in the image. */
+	uint64_t	 size;		/* Bytes in the image. */
+	uint64_t	 offset;	/* Offset of the data in the file. */
+	uint64_t	 length;	/* Bytes of data in the file. */
+	uint32_t	 type;
+};
+
+struct udif_slot {
+	enum udif_slot_state state;
+	int64_t		 chunk;		/* Index of the chunk, or -1. */
+	uint32_t	 type;
+	unsigned char	*in;
+	size_t		 in_size;
+	size_t		 in_alloc;
+	unsigned char	*out;
+	size_t		 out_size;
+	size_t		 out_alloc;
+};
+
+struct udif {
+	struct udif_chunk *chunks;
+	int64_t		 nchunks;
+	uint64_t	 size;		/* Bytes in the image. */
+	uint64_t	 pos;		/* Offset of the next byte returned. */
+	int64_t		 cur;		/* Chunk that holds pos. */
+	int64_t		 upstream_pos;	/* Offset in the file, or -1. */
+	unsigned char	*zero;
+	int		 threads;
+	int		 window;	/* Chunks to read ahead. */
+	struct udif_slot *slots;
+	int		 nslots;
+	int		 held;		/* Slot returned by the last read, or -1. */
+	char		 started;
+#ifdef HAVE_PTHREAD_H
+	pthread_mutex_t	 lock;
+	pthread_cond_t	 queued;	/* A slot was queued, or stopping. */
+	pthread_cond_t	 decoded;	/* A slot was decoded. */
+	pthread_t	*workers;
+	int		 nworkers;
+	char		 stopping;
+#endif
+};
+
+static int	udif_bidder_bid(struct archive_read_filter_bidder *,
+		    struct archive_read_filter *);
+static int	udif_bidder_init(struct archive_read_filter *);
+static int	udif_bidder_options(struct archive_read_filter_bidder *,
+		    const char *, const char *);
+static void	udif_bidder_free(struct archive_read_filter_bidder *);
+
+static ssize_t	udif_filter_read(struct archive_read_filter *,
+		    const void **);
+static int64_t	udif_filter_skip(struct archive_read_filter *, int64_t);
+static int	udif_filter_close(struct archive_read_filter *);
+
+static const struct archive_read_filter_bidder_vtable
+udif_bidder_vtable = {
+	.bid = udif_bidder_bid,
+	.init = udif_bidder_init,
+	.options = udif_bidder_options,
+	.free = udif_bidder_free,
+};
+
+static const struct archive_read_filter_vtable
+udif_reader_vtable = {
+	.read = udif_filter_read,
+	.skip = udif_filter_skip,
+	.close = udif_filter_close,
+};
+
+#ifdef HAVE_PTHREAD_H
+#define	udif_lock(state)	pthread_mutex_lock(&(state)->lock)
+#define	udif_unlock(state)	pthread_mutex_unlock(&(state)->lock)
+#else
+#define	udif_lock(state)	((void)0)
+#define	udif_unlock(state)	((void)0)
+#endif
+
+int
+archive_read_support_filter_udif(struct archive *_a)
+{
+	struct archive_read *a = (struct archive_read *)_a;
+	struct udif_options *options;
+
+	archive_check_magic(_a, ARCHIVE_READ_MAGIC,
+	    ARCHIVE_STATE_NEW, "archive_read_support_filter_udif");
+
+	options = calloc(1, sizeof(*options));
+	if (options == NULL) {
+		archive_set_error(_a, ENOMEM,
+		    "Can't allocate data for udif");
+		return (ARCHIVE_FATAL);
+	}
+
+	if (__archive_read_register_bidder(a, options, "udif",
+				&udif_bidder_vtable) != ARCHIVE_OK) {
+		free(options);
+		return (ARCHIVE_FATAL);
+	}
+	return (ARCHIVE_OK);
+}
+
+static void
+udif_bidder_free(struct archive_read_filter_bidder *self)
+{
+	free(self->data);
+	self->data = NULL;
+}
+
+static int
+udif_bidder_options(struct archive_read_filter_bidder *self,
+    const char *key, const char *val)
+{
+	struct udif_options *options = (struct udif_options *)self->data;
+	long threads;
+	char *end;
+
+	if (strcmp(key, "threads") == 0) {
+		if (val == NULL || val[0] == '\0') {
+			options->threads = 0;
+			return (ARCHIVE_OK);
+		}
+		threads = strtol(val, &end, 10);
+		if (*end != '\0' || threads < 0)
+			return (ARCHIVE_FAILED);
+		options->threads = (threads > UDIF_MAX_THREADS) ?
+		    UDIF_MAX_THREADS : (int)threads;
+		return (ARCHIVE_OK);
+	}
+
+	/* Note: The "warn" return is just to inform the options
+	 * supervisor that we didn't handle it.  It will generate
+	 * a suitable error if no one used this option. */
+	return (ARCHIVE_WARN);
+}
+
+/*
+ * Check a koly trailer.
+ */
+static int
+udif_check_koly(const unsigned char *b)
+{
+	return (memcmp(b, "koly", 4) == 0 &&
+	    archive_be32dec(b + 4) == 4 &&
+	    archive_be32dec(b + 8) == UDIF_KOLY_SIZE);
+}
+
+/*
+ * Test whether we can handle this data: the input is a file, which
+ * ends with a koly trailer.  There is nothing to check at the start
+ * of an image, so this seeks to the end and back.
+ */
+static int
+udif_bidder_bid(struct archive_read_filter_bidder *self,
+    struct archive_read_filter *filter)
+{
+	const unsigned char *b;
+	ssize_t avail;
+	int bid = 0;
+
+	(void)self; /* UNUSED */
+
+	/* Only the client's filter can seek. */
+	if (filter->upstream != NULL || filter->position != 0 ||
+	    filter->archive->client.seeker == NULL)
+		return (0);
+
+	if (__archive_read_filter_seek(filter, -UDIF_KOLY_SIZE,
+	    SEEK_END) < 0)
+		return (0);
+	b = __archive_read_filter_ahead(filter, UDIF_KOLY_SIZE, &avail);
+	if (b != NULL && udif_check_koly(b))
+		bid = 96;
+	if (__archive_read_filter_seek(filter, 0, SEEK_SET) != 0)
+		return (0);
+
+	return (bid);
+}
+
+static int
+udif_default_threads(void)
+{
+	long n = 1;
+
+#if defined(HAVE_UNISTD_H) && defined(_SC_NPROCESSORS_ONLN)
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	if (n < 1)
+		n = 1;
+	if (n > UDIF_MAX_THREADS)
+		n = UDIF_MAX_THREADS;
+	return ((int)n);
+}
+
+/*
+ * Decode base64 in place, skipping white space; returns the length
+ * of the decoded data, or -1.
+ */
+static ssize_t
+udif_base64_decode(char *buf, size_t len)
+{
+	unsigned char *out = (unsigned char *)buf;
+	uint32_t bits = 0;
+	size_t i, n = 0;
+	int nbits = 0, v;
+	char c;
+
+	for (i = 0; i < len; i++) {
+		c = buf[i];
+		if (c >= 'A' && c <= 'Z')
+			v = c - 'A';
+		else if (c >= 'a' && c <= 'z')
+			v = c - 'a' + 26;
+		else if (c >= '0' && c <= '9')
+			v = c - '0' + 52;
+		else if (c == '+')
+			v = 62;
+		else if (c == '/')
+			v = 63;
+		else if (c == '=')
+			break;
+		else if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+			continue;
+		else
+			return (-1);
+		bits = (bits << 6) | (uint32_t)v;
+		nbits += 6;
+		if (nbits >= 8) {
+			nbits -= 8;
+			out[n++] = (unsigned char)(bits >> nbits);
+		}
+	}
+	return ((ssize_t)n);
+}
+
+/*
+ * Add a chunk to the map.
+ */
+static int
+udif_add_chunk(struct archive_read_filter *self, int64_t *alloc,
+    uint64_t start, uint64_t size, uint64_t offset, uint64_t length,
+    uint32_t type)
+{
+	struct udif *state = (struct udif *)self->data;
+	struct udif_chunk *c;
+	int64_t n;
+
+	if (state->nchunks >= *alloc) {
+		if (state->nchunks >= UDIF_MAX_CHUNKS) {
+			archive_set_error(&self->archive->archive,
+			    ARCHIVE_ERRNO_FILE_FORMAT,
+			    "Too many chunks in disk image");
+			return (ARCHIVE_FATAL);
+		}
+		n = (*alloc == 0) ? 1024 : *alloc * 2;
+		if (__archive_read_charge_memory(self->archive,
+		    (n - *alloc) * (int64_t)sizeof(*c),
+		    "udif chunk map") != ARCHIVE_OK)
+			return (ARCHIVE_FATAL);
+		c = realloc(state->chunks, (size_t)n * sizeof(*c));
+		if (c == NULL) {
+			archive_set_error(&self->archive->archive, ENOMEM,
+			    "Can't allocate udif chunk map");
+			return (ARCHIVE_FATAL);
+		}
+		state->chunks = c;
+		*alloc = n;
+	}
+	c = &state->chunks[state->nchunks++];
+	c->start = start;
+	c->size = size;
+	c->offset = offset;
+	c->length = length;
+	c->type = type;
+	return (ARCHIVE_OK);
+}
+
+/*
+ * Add the chunks of a mish table to the map.  Stored runs are split
+ * into pieces, so that every chunk fits in a slot.
+ */
+static int
+udif_add_mish(struct archive_read_filter *self, int64_t *alloc,
+    const unsigned char *b, size_t len, uint64_t data_fork)
+{
+	uint64_t first, sector, count, offset, length, piece;
+	uint32_t i, n, type;
+	const unsigned char *p;
+	int r;
+
+	if (len < UDIF_MISH_SIZE || memcmp(b, "mish", 4) != 0)
+		goto bad;
+	first = archive_be64dec(b + 8);
+	offset = archive_be64dec(b + 24);
+	n = archive_be32dec(b + 200);
+	if ((len - UDIF_MISH_SIZE) / UDIF_MISH_CHUNK_SIZE < n ||
+	    first > UINT64_MAX / UDIF_SECTOR_SIZE)
+		goto bad;
+	data_fork += offset;
+
+	for (i = 0; i < n; i++) {
+		p = b + UDIF_MISH_SIZE + (size_t)i * UDIF_MISH_CHUNK_SIZE;
+		type = archive_be32dec(p);
+		sector = archive_be64dec(p + 8);
+		count = archive_be64dec(p + 16);
+		offset = archive_be64dec(p + 24);
+		length = archive_be64dec(p + 32);
+		if (type == UDIF_TERMINATOR)
+			break;
+		if (type == UDIF_COMMENT || count == 0)
+			continue;
+		/* first, sector and count are each checked before they
+		 * are subtracted, so the bound can't wrap. */
+		if (sector > UINT64_MAX / UDIF_SECTOR_SIZE - first ||
+		    count > UINT64_MAX / UDIF_SECTOR_SIZE - first - sector)
+			goto bad;
+		sector += first;
+
+		switch (type) {
+		case UDIF_ZERO:
+		case UDIF_IGNORE:
+			r = udif_add_chunk(self, alloc,
+			    sector * UDIF_SECTOR_SIZE,
+			    count * UDIF_SECTOR_SIZE, 0, 0, UDIF_ZERO);
+			break;
+		case UDIF_RAW:
+			if (length != count * UDIF_SECTOR_SIZE)
+				goto bad;
+			for (r = ARCHIVE_OK; r == ARCHIVE_OK && length > 0;
+			    length -= piece) {
+				piece = (length > UDIF_PIECE_SIZE) ?
+				    UDIF_PIECE_SIZE : length;
+				r = udif_add_chunk(self, alloc,
+				    sector * UDIF_SECTOR_SIZE, piece,
+				    data_fork + offset, piece, UDIF_RAW);
+				sector += piece / UDIF_SECTOR_SIZE;
+				offset += piece;
+			}
+			break;
+		default:
+			if (count * UDIF_SECTOR_SIZE > UDIF_MAX_CHUNK_SIZE ||
+			    length == 0 || length > UDIF_MAX_CHUNK_SIZE * 2)
+				goto bad;
+			r = udif_add_chunk(self, alloc,
+			    sector * UDIF_SECTOR_SIZE,
+			    count * UDIF_SECTOR_SIZE,
+			    data_fork + offset, length, type);
+			break;
+		}
+		if (r != ARCHIVE_OK)
+			return (r);
+	}
+	return (ARCHIVE_OK);
+bad:
+	archive_set_error(&self->archive->archive,
+	    ARCHIVE_ERRNO_FILE_FORMAT, "Invalid mish table in disk image");
+	return (ARCHIVE_FATAL);
+}
+
+/*
+ * Find the Data of each entry of the "blkx" array of the property
+ * list, and add its mish table to the map.
+ */
+static int
+udif_parse_plist(struct archive_read_filter *self, char *xml, size_t len,
+    uint64_t data_fork)
+{
+	char *p, *end, *data, *data_end;
+	ssize_t n;
+	int64_t alloc = 0;
+	int r;
+
+	xml[len] = '\0';
+	p = strstr(xml, "<key>blkx</key>");
+	if (p == NULL || (p = strstr(p, "<array>")) == NULL)
+		goto bad;
+	end = strstr(p, "</array>");
+	if (end == NULL)
+		goto bad;
+	*end = '\0';
+
+	while ((data = strstr(p, "<data>")) != NULL) {
+		data += 6;
+		data_end = strstr(data, "</data>");
+		if (data_end == NULL)
+			goto bad;
+		n = udif_base64_decode(data, (size_t)(data_end - data));
+		if (n < 0)
+			goto bad;
+		r = udif_add_mish(self, &alloc, (unsigned char *)data,
+		    (size_t)n, data_fork);
+		if (r != ARCHIVE_OK)
+			return (r);
+		p = data_end + 7;
+	}
+	return (ARCHIVE_OK);
+bad:
+	archive_set_error(&self->archive->archive,
+	    ARCHIVE_ERRNO_FILE_FORMAT,
+	    "Invalid property list in disk image");
+	return (ARCHIVE_FATAL);
+}
+
+static int
+udif_cmp_chunk(const void *a, const void *b)
+{
+	const struct udif_chunk *x = (const struct udif_chunk *)a;
+	const struct udif_chunk *y = (const struct udif_chunk *)b;
+
+	return (x->start < y->start ? -1 : (x->start > y->start ? 1 : 0));
+}
+
+/*
+ * Sort the map, and fill the gaps between the chunks (and to the
+ * end of the image) with zeros.
+ */
+static int
+udif_finish_map(struct archive_read_filter *self, uint64_t size)
+{
+	struct udif *state = (struct udif *)self->data;
+	int64_t i, n, alloc;
+	uint64_t end;
+
+	if (state->nchunks == 0) {
+		archive_set_error(&self->archive->archive,
+		    ARCHIVE_ERRNO_FILE_FORMAT, "Disk image has no chunks");
+		return (ARCHIVE_FATAL);
+	}
+	qsort(state->chunks, (size_t)state->nchunks,
+	    sizeof(state->chunks[0]), udif_cmp_chunk);
+
+	/* Add the gaps after the chunks, then sort them into place. */
+	n = state->nchunks;
+	alloc = n;
+	for (i = 0, end = 0; i < n; i++) {
+		if (state->chunks[i].start < end) {
+			archive_set_error(&self->archive->archive,
+			    ARCHIVE_ERRNO_FILE_FORMAT,
+			    "Overlapping chunks in disk image");
+			return (ARCHIVE_FATAL);
+		}
+		if (state->chunks[i].start > end &&
+		    udif_add_chunk(self, &alloc, end,
+		    state->chunks[i].start - end, 0, 0,
+		    UDIF_ZERO) != ARCHIVE_OK)
+			return (ARCHIVE_FATAL);
+		end = state->chunks[i].start + state->chunks[i].size;
+	}
+	if (size > end && udif_add_chunk(self, &alloc, end, size - end,
+	    0, 0, UDIF_ZERO) != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
+	if (state->nchunks > n)
+		qsort(state->chunks, (size_t)state->nchunks,
+		    sizeof(state->chunks[0]), udif_cmp_chunk);
+
+	state->size = (size > end) ? size : end;
+	return (ARCHIVE_OK);
+}
+
+/*
+ * Read the koly trailer and the property list, and build the map.
+ */
+static int
+udif_read_map(struct archive_read_filter *self)
+{
+	const unsigned char *b;
+	char *xml;
+	ssize_t avail;
+	int64_t file_size;
+	uint64_t data_fork, xml_offset, xml_length, sectors;
+	size_t copied, n;
+	int r;
+
+	file_size = __archive_read_filter_seek(self->upstream,
+	    -UDIF_KOLY_SIZE, SEEK_END);
+	if (file_size < 0)
+		return (ARCHIVE_FATAL);
+	b = __archive_read_filter_ahead(self->upstream, UDIF_KOLY_SIZE,
+	    &avail);
+	if (b == NULL || !udif_check_koly(b))
+		goto bad;
+	if (archive_be32dec(b + 60) > 1) {
+		archive_set_error(&self->archive->archive,
+		    ARCHIVE_ERRNO_FILE_FORMAT,
+		    "Segmented disk images are not supported");
+		return (ARCHIVE_FATAL);
+	}
+	data_fork = archive_be64dec(b + 24);
+	xml_offset = archive_be64dec(b + 216);
+	xml_length = archive_be64dec(b + 224);
+	sectors = archive_be64dec(b + 492);
+	if (xml_length == 0 || xml_length > UDIF_MAX_XML ||
+	    xml_offset > (uint64_t)file_size ||
+	    xml_length > (uint64_t)file_size - xml_offset ||
+	    sectors > UINT64_MAX / UDIF_SECTOR_SIZE)
+		goto bad;
+
+	if (__archive_read_charge_memory(self->archive,
+	    (int64_t)xml_length, "udif property list") != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
+	xml = malloc((size_t)xml_length + 1);
+	if (xml == NULL) {
+		archive_set_error(&self->archive->archive, ENOMEM,
+		    "Can't allocate udif property list");
+		return (ARCHIVE_FATAL);
+	}
+	if (__archive_read_filter_seek(self->upstream, (int64_t)xml_offset,
+	    SEEK_SET) < 0) {
+		free(xml);
+		return (ARCHIVE_FATAL);
+	}
+	for (copied = 0; copied < xml_length; copied += n) {
+		b = __archive_read_filter_ahead(self->upstream, 1, &avail);
+		if (b == NULL) {
+			free(xml);
+			goto bad;
+		}
+		n = (size_t)xml_length - copied;
+		if (n > (size_t)avail)
+			n = (size_t)avail;
+		memcpy(xml + copied, b, n);
+		__archive_read_filter_consume(self->upstream, n);
+	}
+
+	r = udif_parse_plist(self, xml, (size_t)xml_length, data_fork);
+	free(xml);
+	__archive_read_release_memory(self->archive, (int64_t)xml_length);
+	if (r != ARCHIVE_OK)
+		return (r);
+	return (udif_finish_map(self, sectors * UDIF_SECTOR_SIZE));
+bad:
+	archive_set_error(&self->archive->archive,
+	    ARCHIVE_ERRNO_FILE_FORMAT, "Invalid koly trailer in disk image");
+	return (ARCHIVE_FATAL);
+}
+
+static int
+udif_bidder_init(struct archive_read_filter *self)
+{
+	struct udif_options *options =
+	    (struct udif_options *)self->bidder->data;
+	struct udif *state;
+	int i;
+
+	self->code = ARCHIVE_FILTER_UDIF;
+	self->name = "udif";
+
+	state = calloc(1, sizeof(*state));
+	if (state == NULL) {
+		archive_set_error(&self->archive->archive, ENOMEM,
+		    "Can't allocate data for udif");
+		return (ARCHIVE_FATAL);
+	}
+	self->data = state;
+	state->held = -1;
+	state->upstream_pos = -1;
+	state->window = 1;
+
+	if (udif_read_map(self) != ARCHIVE_OK) {
+		free(state->chunks);
+		free(state);
+		self->data = NULL;
+		return (ARCHIVE_FATAL);
+	}
+
+	state->threads = (options != NULL && options->threads > 0) ?
+	    options->threads : udif_default_threads();
+#ifndef HAVE_PTHREAD_H
+	state->threads = 1;
+#endif
+	/* One slot is held by the caller, one is being filled. */
+	state->nslots = state->threads + 2;
+	state->slots = calloc(state->nslots, sizeof(*state->slots));
+	state->zero = calloc(1, UDIF_PIECE_SIZE);
+	if (state->slots == NULL || state->zero == NULL ||
+	    __archive_read_charge_memory(self->archive, UDIF_PIECE_SIZE,
+	    "udif buffers") != ARCHIVE_OK) {
+		free(state->zero);
+		free(state->slots);
+		free(state->chunks);
+		free(state);
+		self->data = NULL;
+		archive_set_error(&self->archive->archive, ENOMEM,
+		    "Can't allocate data for udif");
+		return (ARCHIVE_FATAL);
+	}
+	for (i = 0; i < state->nslots; i++)
+		state->slots[i].chunk = -1;
+
+#ifdef HAVE_PTHREAD_H
+	if (pthread_mutex_init(&state->lock, NULL) != 0 ||
+	    pthread_cond_init(&state->queued, NULL) != 0 ||
+	    pthread_cond_init(&state->decoded, NULL) != 0) {
+		free(state->zero);
+		free(state->slots);
+		free(state->chunks);
+		free(state);
+		self->data = NULL;
+		archive_set_error(&self->archive->archive, ENOMEM,
+		    "Can't initialize udif locks");
+		return (ARCHIVE_FATAL);
+	}
+#endif
+
+	self->vtable = &udif_reader_vtable;
+	self->can_skip = 1;
+
+	return (ARCHIVE_OK);
+}
+
+/*
+ * Decode Apple Data Compression; returns the bytes decoded.
+ */
+static size_t
+udif_adc_decode(unsigned char *out, size_t out_size,
+    const unsigned char *in, size_t in_size)
+{
+	size_t i = 0, o = 0, len, dist;
+
+	while (i < in_size && o < out_size) {
+		if (in[i] & 0x80) {
+			len = (in[i] & 0x7f) + 1;
+			if (i + 1 + len > in_size || o + len > out_size)
+				break;
+			memcpy(out + o, in + i + 1, len);
+			i += len + 1;
+			o += len;
+			continue;
+		}
+		if (in[i] & 0x40) {
+			if (i + 3 > in_size)
+				break;
+			len = (in[i] & 0x3f) + 4;
+			dist = ((size_t)in[i + 1] << 8 | in[i + 2]) + 1;
+			i += 3;
+		} else {
+			if (i + 2 > in_size)
+				break;
+			len = ((in[i] & 0x3c) >> 2) + 3;
+			dist = ((size_t)(in[i] & 0x03) << 8 | in[i + 1]) + 1;
+			i += 2;
+		}
+		if (dist > o || o + len > out_size)
+			break;
+		/* The copy can overlap the bytes it makes. */
+		for (; len > 0; len--, o++)
+			out[o] = out[o - dist];
+	}
+	return (o);
+}
+
+/*
+ * Decode a queued slot.  Called without the lock, by a worker or by
+ * the reader's thread.
+ */
+static enum udif_slot_state
+udif_decode(struct udif_slot *slot)
+{
+	size_t done = 0;
+
+	switch (slot->type) {
+	case UDIF_ADC:
+		done = udif_adc_decode(slot->out, slot->out_size,
+		    slot->in, slot->in_size);
+		break;
+#ifdef HAVE_ZLIB_H
+	case UDIF_ZLIB: {
+		uLongf n = (uLongf)slot->out_size;
+
+		if (uncompress(slot->out, &n, slot->in,
+		    (uLong)slot->in_size) == Z_OK)
+			done = (size_t)n;
+		break;
+	}
+#endif
+#if defined(HAVE_BZLIB_H) && defined(HAVE_LIBBZ2)
+	case UDIF_BZIP2: {
+		unsigned int n = (unsigned int)slot->out_size;
+
+		if (BZ2_bzBuffToBuffDecompress((char *)slot->out, &n,
+		    (char *)slot->in, (unsigned int)slot->in_size,
+		    0, 0) == BZ_OK)
+			done = n;
+		break;
+	}
+#endif
+#if HAVE_LZMA_H && HAVE_LIBLZMA
+	case UDIF_LZMA: {
+		lzma_stream strm = LZMA_STREAM_INIT;
+
+		/* Either an xz stream or an .lzma stream. */
+		if (lzma_auto_decoder(&strm, UDIF_DECODER_MEMLIMIT, 0) !=
+		    LZMA_OK)
+			break;
+		strm.next_in = slot->in;
+		strm.avail_in = slot->in_size;
+		strm.next_out = slot->out;
+		strm.avail_out = slot->out_size;
+		if (lzma_code(&strm, LZMA_FINISH) == LZMA_STREAM_END)
+			done = (size_t)strm.total_out;
+		lzma_end(&strm);
+		break;
+	}
+#endif
+#if defined(HAVE_COMPRESSION_H) && defined(HAVE_LIBCOMPRESSION)
+	case UDIF_LZFSE:
+		done = compression_decode_buffer(slot->out, slot->out_size,
+		    slot->in, slot->in_size, NULL, COMPRESSION_LZFSE);
+		break;
+#endif
+	default:
+		break;
+	}
+	return (done == slot->out_size ? SLOT_DONE : SLOT_FAILED);
+}
+
+#ifdef HAVE_PTHREAD_H
+
+/*
+ * Worker thread: decode the queued slot of the lowest chunk until the
+ * filter is closed.
+ */
+static void *
+udif_worker(void *arg)
+{
+	struct udif *state = (struct udif *)arg;
+	struct udif_slot *slot;
+	enum udif_slot_state done;
+	int i;
+
+	udif_lock(state);
+	for (;;) {
+		slot = NULL;
+		for (i = 0; i < state->nslots; i++) {
+			if (state->slots[i].state == SLOT_QUEUED &&
+			    (slot == NULL ||
+			     state->slots[i].chunk < slot->chunk))
+				slot = &state->slots[i];
+		}
+		if (slot == NULL) {
+			if (state->stopping)
+				break;
+			pthread_cond_wait(&state->queued, &state->lock);
+			continue;
+		}
+		slot->state = SLOT_BUSY;
+		udif_unlock(state);
+		done = udif_decode(slot);
+		udif_lock(state);
+		slot->state = done;
+		pthread_cond_broadcast(&state->decoded);
+	}
+	udif_unlock(state);
+	return (NULL);
+}
+
+static void
+udif_start_workers(struct udif *state)
+{
+	int i;
+
+	if (state->threads < 2)
+		return;
+	state->workers = calloc(state->threads - 1,
+	    sizeof(*state->workers));
+	if (state->workers == NULL)
+		return;
+	/* If a thread can't be created, make do with fewer. */
+	for (i = 0; i < state->threads - 1; i++) {
+		if (pthread_create(&state->workers[i], NULL, udif_worker,
+		    state) != 0)
+			break;
+		state->nworkers++;
+	}
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+/*
+ * Grow a slot's buffer to size bytes, charging the memory limit for
+ * the growth.
+ */
+static int
+udif_reserve(struct archive_read_filter *self, unsigned char **buf,
+    size_t *alloc, size_t size)
+{
+	unsigned char *p;
+
+	if (*alloc >= size)
+		return (ARCHIVE_OK);
+	if (__archive_read_charge_memory(self->archive,
+	    (int64_t)(size - *alloc), "udif buffers") != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
+	p = realloc(*buf, size);
+	if (p == NULL) {
+		archive_set_error(&self->archive->archive, ENOMEM,
+		    "Can't allocate data for udif");
+		return (ARCHIVE_FATAL);
+	}
+	*buf = p;
+	*alloc = size;
+	return (ARCHIVE_OK);
+}
+
+/*
+ * Copy a chunk's data from the file into a free slot.
+ */
+static int
+udif_fill(struct archive_read_filter *self, struct udif_slot *slot,
+    int64_t k)
+{
+	struct udif *state = (struct udif *)self->data;
+	struct udif_chunk *c = &state->chunks[k];
+	const unsigned char *b;
+	ssize_t avail;
+	size_t copied, n;
+
+	if (state->upstream_pos != (int64_t)c->offset) {
+		state->upstream_pos = -1;
+		if (__archive_read_filter_seek(self->upstream,
+		    (int64_t)c->offset, SEEK_SET) != (int64_t)c->offset)
+			return (ARCHIVE_FATAL);
+		state->upstream_pos = (int64_t)c->offset;
+	}
+
+	if (udif_reserve(self, &slot->in, &slot->in_alloc,
+	    (size_t)c->length) != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
+	for (copied = 0; copied < c->length; copied += n) {
+		b = __archive_read_filter_ahead(self->upstream, 1, &avail);
+		if (b == NULL) {
+			state->upstream_pos = -1;
+			if (avail >= 0)
+				archive_set_error(&self->archive->archive,
+				    ARCHIVE_ERRNO_FILE_FORMAT,
+				    "Truncated disk image");
+			return (ARCHIVE_FATAL);
+		}
+		n = (size_t)c->length - copied;
+		if (n > (size_t)avail)
+			n = (size_t)avail;
+		memcpy(slot->in + copied, b, n);
+		__archive_read_filter_consume(self->upstream, n);
+	}
+	state->upstream_pos += (int64_t)c->length;
+
+	slot->chunk = k;
+	slot->type = c->type;
+	slot->in_size = (size_t)c->length;
+	slot->out_size = (size_t)c->size;
+	if (c->type != UDIF_RAW && udif_reserve(self, &slot->out,
+	    &slot->out_alloc, slot->out_size) != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
+	return (ARCHIVE_OK);
+}
+
+/*
+ * Queue chunk k, which is needed now, and the chunks after it that
+ * are in the read ahead window.  Only a failure to read chunk k is
+ * returned; the others are read again when they are needed.
+ */
+static int
+udif_queue(struct archive_read_filter *self, int64_t k)
+{
+	struct udif *state = (struct udif *)self->data;
+	struct udif_slot *slot;
+	int64_t j, last;
+	int r;
+
+	last = k + state->window;
+	if (last > state->nchunks)
+		last = state->nchunks;
+
+	for (j = k; j < last; j++) {
+		if (state->chunks[j].type == UDIF_ZERO)
+			continue;
+		slot = &state->slots[j % state->nslots];
+
+		udif_lock(state);
+		if (slot->chunk == j && slot->state != SLOT_FREE) {
+			udif_unlock(state);
+			continue;
+		}
+		/* A chunk that was skipped may still be decoding. */
+		r = (slot->state != SLOT_BUSY);
+		if (r)
+			slot->state = SLOT_FREE;
+		udif_unlock(state);
+		if (!r) {
+			if (j == k)
+				continue;	/* Waited for below. */
+			break;
+		}
+
+		r = udif_fill(self, slot, j);
+		if (r != ARCHIVE_OK) {
+			slot->chunk = -1;
+			if (j == k)
+				return (r);
+			break;
+		}
+
+		udif_lock(state);
+		slot->state = (slot->type == UDIF_RAW) ?
+		    SLOT_DONE : SLOT_QUEUED;
+#ifdef HAVE_PTHREAD_H
+		pthread_cond_signal(&state->queued);
+#endif
+		udif_unlock(state);
+	}
+	return (ARCHIVE_OK);
+}
+
+/*
+ * Release the slot returned by the last read.
+ */
+static void
+udif_release(struct udif *state)
+{
+	if (state->held >= 0) {
+		udif_lock(state);
+		state->slots[state->held].state = SLOT_FREE;
+		state->slots[state->held].chunk = -1;
+		udif_unlock(state);
+		state->held = -1;
+	}
+}
+
+/*
+ * Return the rest of the chunk that holds the current position.
+ */
+static ssize_t
+udif_filter_read(struct archive_read_filter *self, const void **p)
+{
+	struct udif *state = (struct udif *)self->data;
+	struct udif_chunk *c;
+	struct udif_slot *slot;
+	enum udif_slot_state done;
+	uint64_t off, n;
+	int64_t k;
+	int idx;
+
+	*p = NULL;
+	udif_release(state);
+	if (state->pos >= state->size)
+		return (0);
+
+	k = state->cur;
+	c = &state->chunks[k];
+	off = state->pos - c->start;
+
+	if (c->type == UDIF_ZERO) {
+		n = c->size - off;
+		if (n > UDIF_PIECE_SIZE)
+			n = UDIF_PIECE_SIZE;
+		*p = state->zero;
+		state->pos += n;
+		if (state->pos == c->start + c->size)
+			state->cur++;
+		return ((ssize_t)n);
+	}
+
+#ifdef HAVE_PTHREAD_H
+	if (!state->started)
+		udif_start_workers(state);
+#endif
+	state->started = 1;
+
+	for (;;) {
+		if (udif_queue(self, k) != ARCHIVE_OK)
+			return (ARCHIVE_FATAL);
+		idx = (int)(k % state->nslots);
+		slot = &state->slots[idx];
+
+		udif_lock(state);
+#ifdef HAVE_PTHREAD_H
+		while (slot->state == SLOT_BUSY)
+			pthread_cond_wait(&state->decoded, &state->lock);
+#endif
+		if (slot->chunk == k)
+			break;
+		/* The slot held a chunk that was skipped; queue k now. */
+		udif_unlock(state);
+	}
+	if (slot->state == SLOT_QUEUED) {
+		/* No worker has taken it yet, so decode it here. */
+		slot->state = SLOT_BUSY;
+		udif_unlock(state);
+		done = udif_decode(slot);
+		udif_lock(state);
+		slot->state = done;
+	}
+	udif_unlock(state);
+
+	state->held = idx;
+	if (slot->state == SLOT_FAILED) {
+		archive_set_error(&self->archive->archive,
+		    ARCHIVE_ERRNO_MISC,
+		    "Disk image chunk at %ju can't be decoded (type 0x%x)",
+		    (uintmax_t)c->start, (unsigned)c->type);
+		return (ARCHIVE_FATAL);
+	}
+
+	/* Reading in order, so read further ahead. */
+	if (state->window < state->nslots - 1)
+		state->window *= 2;
+	if (state->window > state->nslots - 1)
+		state->window = state->nslots - 1;
+
+	*p = ((slot->type == UDIF_RAW) ? slot->in : slot->out) + off;
+	state->pos = c->start + c->size;
+	state->cur++;
+	return ((ssize_t)(c->size - off));
+}
+
+/*
+ * Skip forward without reading or decoding the chunks in between.
+ */
+static int64_t
+udif_filter_skip(struct archive_read_filter *self, int64_t request)
+{
+	struct udif *state = (struct udif *)self->data;
+	uint64_t target;
+	int64_t lo, hi, mid;
+	int i;
+
+	udif_release(state);
+
+	target = state->pos + (uint64_t)request;
+	if (target > state->size || target < state->pos)
+		target = state->size;
+	request = (int64_t)(target - state->pos);
+	state->pos = target;
+
+	/* Find the chunk that holds the new position. */
+	lo = state->cur;
+	hi = state->nchunks;
+	while (lo + 1 < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (state->chunks[mid].start <= target)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	state->cur = lo;
+	if (lo < state->nchunks &&
+	    target >= state->chunks[lo].start + state->chunks[lo].size)
+		state->cur = state->nchunks;
+
+	/* Don't decode the chunks that were read ahead and skipped. */
+	udif_lock(state);
+	for (i = 0; i < state->nslots; i++) {
+		if (state->slots[i].state == SLOT_QUEUED &&
+		    state->slots[i].chunk < state->cur) {
+			state->slots[i].state = SLOT_FREE;
+			state->slots[i].chunk = -1;
+		}
+	}
+	udif_unlock(state);
+	state->window = 1;
+
+	return (request);
+}
+
+/*
+ * Clean up the decompressor.
+ */
+static int
+udif_filter_close(struct archive_read_filter *self)
+{
+	struct udif *state = (struct udif *)self->data;
+	int i;
+
+#ifdef HAVE_PTHREAD_H
+	udif_lock(state);
+	state->stopping = 1;
+	pthread_cond_broadcast(&state->queued);
+	udif_unlock(state);
+	for (i = 0; i < state->nworkers; i++)
+		pthread_join(state->workers[i], NULL);
+	free(state->workers);
+	pthread_cond_destroy(&state->decoded);
+	pthread_cond_destroy(&state->queued);
+	pthread_mutex_destroy(&state->lock);
+#endif
+
+	for (i = 0; i < state->nslots; i++) {
+		free(state->slots[i].in);
+		free(state->slots[i].out);
+	}
+	free(state->slots);
+	free(state->zero);
+	free(state->chunks);
+	free(state);
+
+	return (ARCHIVE_OK);
+}
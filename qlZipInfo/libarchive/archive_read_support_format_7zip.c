@@ -2556,6 +2556,12 @@ read_Header(struct archive_read *a, struct _7z_header_info *h,
 		return (-1);
 	if (UMAX_ENTRY < zip->numFiles)
 		return (-1);
+	if (__archive_read_check_limit(a, ARCHIVE_READ_LIMIT_ENTRIES,
+	    (int64_t)zip->numFiles, "7-Zip header") != ARCHIVE_OK ||
+	    __archive_read_charge_memory(a,
+	    (int64_t)zip->numFiles * sizeof(*zip->entries),
+	    "7-Zip header") != ARCHIVE_OK)
+		return (-1);
 
 	zip->entries = calloc((size_t)zip->numFiles, sizeof(*zip->entries));
 	if (zip->entries == NULL)
@@ -274,6 +274,10 @@ _ar_read_header(struct archive_read *a, struct archive_entry *entry,
 			return (ARCHIVE_FATAL);
 		}
 
+		if (__archive_read_charge_memory(a, (int64_t)entry_size,
+		    "Filename table") != ARCHIVE_OK)
+			return (ARCHIVE_FATAL);
+
 		/* Read the filename table into memory. */
 		st = malloc(entry_size);
 		if (st == NULL) {
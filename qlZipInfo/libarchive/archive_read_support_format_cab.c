@@ -49,6 +49,13 @@
 #include "archive_endian.h"
 
 
+/* Bits of the first level of the tables of lzx_decode_fast(). */
+#define LZX_FAST_BITS	10
+/* Most input one symbol uses: three refills of 32 bits. */
+#define LZX_FAST_IN	12
+/* Most output one symbol makes, and the overrun of a match copy. */
+#define LZX_FAST_OUT	(257 + 8)
+
 struct lzx_dec {
 	/* Decoding status. */
 	int     		 state;
@@ -58,7 +65,8 @@ struct lzx_dec {
 	 */
 	int			 w_size;
 	int			 w_mask;
-	/* Window buffer, which is a loop buffer. */
+	/* Window buffer, which is a loop buffer.  lzx_decode_fast()
+	 * may read up to 8 bytes past its end. */
 	unsigned char		*w_buff;
 	/* The insert position to the window. */
 	int			 w_pos;
@@ -121,10 +129,20 @@ struct lzx_dec {
 		int		 tree_used;
 		/* Direct access table. */
 		uint16_t	*tbl;
+		/*
+		 * Two-level table for lzx_decode_fast(): the first
+		 * level is indexed by the first fbits bits of a code,
+		 * the second level by the sbits bits after them.
+		 */
+		uint32_t	*ftbl;
+		int		 fbits;
+		int		 sbits;
 	}			 at, lt, mt, pt;
 
 	int			 loop;
 	int			 error;
+	/* Use lzx_decode_fast() where there is room for it. */
+	int			 fast;
 };
 
 static const int slots[] = {
@@ -285,6 +303,9 @@ struct cab {
 	char			 end_of_entry;
 	char			 end_of_entry_cleanup;
 	char			 read_data_invoked;
+	/* Bytes of the current folder that were skipped but not yet
+	 * decompressed; they are only decompressed if the data of a
+	 * later entry in the folder is read. */
 	int64_t			 bytes_skipped;
 
 	unsigned char		*uncompressed_buffer;
@@ -295,6 +316,8 @@ struct cab {
 	struct archive_string_conv *sconv_default;
 	struct archive_string_conv *sconv_utf8;
 	char			 format_name[64];
+	/* Decode LZX with the reference decoder only. */
+	char			 lzx_reference;
 
 #ifdef HAVE_ZLIB_H
 	z_stream		 stream;
@@ -334,6 +357,7 @@ static int64_t	cab_minimum_consume_cfdata(struct archive_read *, int64_t);
 static int	lzx_decode_init(struct lzx_stream *, int);
 static int	lzx_read_blocks(struct lzx_stream *, int);
 static int	lzx_decode_blocks(struct lzx_stream *, int);
+static int	lzx_decode_fast(struct lzx_stream *);
 static void	lzx_decode_free(struct lzx_stream *);
 static void	lzx_translation(struct lzx_stream *, void *, size_t, uint32_t);
 static void	lzx_cleanup_bitstream(struct lzx_stream *);
@@ -343,6 +367,7 @@ static int	lzx_read_bitlen(struct lzx_stream *, struct huffman *, int);
 static int	lzx_huffman_init(struct huffman *, size_t, int);
 static void	lzx_huffman_free(struct huffman *);
 static int	lzx_make_huffman_table(struct huffman *);
+static int	lzx_make_fast_table(struct huffman *);
 static inline int lzx_decode_huffman(struct huffman *, unsigned);
 
 
@@ -475,6 +500,19 @@ archive_read_format_cab_options(struct archive_read *a,
 				ret = ARCHIVE_FATAL;
 		}
 		return (ret);
+	} else if (strcmp(key, "lzx") == 0) {
+		/* "reference" selects the original LZX decoder, to
+		 * check the faster one against. */
+		if (val != NULL && strcmp(val, "reference") == 0)
+			cab->lzx_reference = 1;
+		else if (val != NULL && strcmp(val, "fast") == 0)
+			cab->lzx_reference = 0;
+		else {
+			archive_set_error(&a->archive, ARCHIVE_ERRNO_MISC,
+			    "cab: lzx option needs \"fast\" or \"reference\"");
+			return (ARCHIVE_FAILED);
+		}
+		return (ARCHIVE_OK);
 	}
 
 	/* Note: The "warn" return is just to inform the options
@@ -667,6 +705,13 @@ cab_read_header(struct archive_read *a)
 	hd->file_count = archive_le16dec(p + CFHEADER_cFiles);
 	if (hd->file_count == 0)
 		goto invalid;
+	if (__archive_read_check_limit(a, ARCHIVE_READ_LIMIT_ENTRIES,
+	    hd->file_count, "CFHEADER") != ARCHIVE_OK ||
+	    __archive_read_charge_memory(a,
+	    (int64_t)hd->folder_count * sizeof(struct cffolder) +
+	    (int64_t)hd->file_count * sizeof(struct cffile),
+	    "CFHEADER") != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
 	hd->flags = archive_le16dec(p + CFHEADER_flags);
 	hd->setid = archive_le16dec(p + CFHEADER_setID);
 	hd->cabinet = archive_le16dec(p + CFHEADER_iCabinet);
@@ -930,9 +975,12 @@ archive_read_format_cab_read_header(struct archive_read *a,
 		break;
 	}
 	/* If a cffolder of this file is changed, reset a cfdata to read
-	 * file contents from next cfdata. */
-	if (prev_folder != cab->entry_cffolder)
+	 * file contents from next cfdata; the skipped data of the
+	 * previous folder is passed over without decompressing it. */
+	if (prev_folder != cab->entry_cffolder) {
 		cab->entry_cfdata = NULL;
+		cab->bytes_skipped = 0;
+	}
 
 	/* If a pathname is UTF-8, prepare a string conversion object
 	 * for UTF-8 and use it. */
@@ -1024,19 +1072,21 @@ archive_read_format_cab_read_data(struct archive_read *a,
 	default:
 		break;
 	}
-	if (cab->read_data_invoked == 0) {
-		if (cab->bytes_skipped) {
-			if (cab->entry_cfdata == NULL) {
-				r = cab_next_cfdata(a);
-				if (r < 0)
-					return (r);
-			}
-			if (cab_consume_cfdata(a, cab->bytes_skipped) < 0)
-				return (ARCHIVE_FATAL);
-			cab->bytes_skipped = 0;
+	if (cab->bytes_skipped) {
+		/* Decompress the entries skipped before this one. */
+		if (cab->entry_cfdata == NULL) {
+			r = cab_next_cfdata(a);
+			if (r < 0)
+				return (r);
 		}
-		cab->read_data_invoked = 1;
+		if (cab_consume_cfdata(a, cab->bytes_skipped) < 0)
+			return (ARCHIVE_FATAL);
+		if (cab->entry_cffolder->comptype == COMPTYPE_NONE &&
+		    cab->entry_cfdata != NULL)
+			cab->entry_cfdata->unconsumed = 0;
+		cab->bytes_skipped = 0;
 	}
+	cab->read_data_invoked = 1;
 	if (cab->entry_unconsumed) {
 		/* Consume as much as the compressor actually used. */
 		r = (int)cab_consume_cfdata(a, cab->entry_unconsumed);
@@ -1666,6 +1716,7 @@ cab_read_ahead_cfdata_lzx(struct archive_read *a, ssize_t *avail)
 			*avail = ARCHIVE_FATAL;
 			return (NULL);
 		}
+		cab->xstrm.ds->fast = !cab->lzx_reference;
 		/* We've initialized decompression for this stream. */
 		cab->entry_cffolder->decompress_init = 1;
 	}
@@ -1959,7 +2010,6 @@ static int
 archive_read_format_cab_read_data_skip(struct archive_read *a)
 {
 	struct cab *cab;
-	int64_t bytes_skipped;
 	int r;
 
 	cab = (struct cab *)(a->format->data);
@@ -1967,24 +2017,12 @@ archive_read_format_cab_read_data_skip(struct archive_read *a)
 	if (cab->end_of_archive)
 		return (ARCHIVE_EOF);
 
-	if (!cab->read_data_invoked) {
-		cab->bytes_skipped += cab->entry_bytes_remaining;
-		cab->entry_bytes_remaining = 0;
-		/* This entry is finished and done. */
-		cab->end_of_entry_cleanup = cab->end_of_entry = 1;
-		return (ARCHIVE_OK);
-	}
-
 	if (cab->entry_unconsumed) {
 		/* Consume as much as the compressor actually used. */
 		r = (int)cab_consume_cfdata(a, cab->entry_unconsumed);
 		cab->entry_unconsumed = 0;
 		if (r < 0)
 			return (r);
-	} else if (cab->entry_cfdata == NULL) {
-		r = cab_next_cfdata(a);
-		if (r < 0)
-			return (r);
 	}
 
 	/* if we've already read to end of data, we're done. */
@@ -1992,18 +2030,12 @@ archive_read_format_cab_read_data_skip(struct archive_read *a)
 		return (ARCHIVE_OK);
 
 	/*
-	 * If the length is at the beginning, we can skip the
-	 * compressed data much more quickly.
+	 * Don't decompress the rest of this entry now: a listing never
+	 * needs it, and a later folder's CFDATA is found from its
+	 * CFFOLDER without reading this folder's.
 	 */
-	bytes_skipped = cab_consume_cfdata(a, cab->entry_bytes_remaining);
-	if (bytes_skipped < 0)
-		return (ARCHIVE_FATAL);
-
-	/* If the compression type is none(uncompressed), we've already
-	 * consumed data as much as the current entry size. */
-	if (cab->entry_cffolder->comptype == COMPTYPE_NONE &&
-	    cab->entry_cfdata != NULL)
-		cab->entry_cfdata->unconsumed = 0;
+	cab->bytes_skipped += cab->entry_bytes_remaining;
+	cab->entry_bytes_remaining = 0;
 
 	/* This entry is finished and done. */
 	cab->end_of_entry_cleanup = cab->end_of_entry = 1;
@@ -2105,7 +2137,7 @@ lzx_decode_init(struct lzx_stream *strm, int w_bits)
 	ds->w_mask = ds->w_size -1;
 	if (ds->w_buff == NULL || w_size != ds->w_size) {
 		free(ds->w_buff);
-		ds->w_buff = malloc(ds->w_size);
+		ds->w_buff = malloc(ds->w_size + 8);
 		if (ds->w_buff == NULL)
 			return (ARCHIVE_FATAL);
 		free(ds->pos_tbl);
@@ -2403,7 +2435,14 @@ lzx_decode(struct lzx_stream *strm, int last)
 		if (ds->state < ST_MAIN)
 			r = lzx_read_blocks(strm, last);
 		else {
-			int64_t bytes_written = strm->avail_out;
+			int64_t bytes_written;
+
+			/* Decode what we safely can without checking
+			 * for the end of the input and output. */
+			if (ds->fast && ds->state == ST_MAIN &&
+			    lzx_decode_fast(strm) < 0)
+				return (ds->error = ARCHIVE_FAILED);
+			bytes_written = strm->avail_out;
 			r = lzx_decode_blocks(strm, last);
 			bytes_written -= strm->avail_out;
 			strm->next_out += bytes_written;
@@ -2638,6 +2677,8 @@ lzx_read_blocks(struct lzx_stream *strm, int last)
 			}
 			if (!lzx_make_huffman_table(&ds->at))
 				goto failed;
+			if (ds->fast && !lzx_make_fast_table(&ds->at))
+				goto failed;
 			/* FALL THROUGH */
 		case ST_RD_VERBATIM:
 			ds->loop = 0;
@@ -2700,6 +2741,8 @@ lzx_read_blocks(struct lzx_stream *strm, int last)
 			}
 			if (!lzx_make_huffman_table(&ds->mt))
 				goto failed;
+			if (ds->fast && !lzx_make_fast_table(&ds->mt))
+				goto failed;
 			ds->loop = 0;
 			/* FALL THROUGH */
 		case ST_RD_PRE_LENGTH_TREE:
@@ -2731,6 +2774,8 @@ lzx_read_blocks(struct lzx_stream *strm, int last)
 			}
 			if (!lzx_make_huffman_table(&ds->lt))
 				goto failed;
+			if (ds->fast && !lzx_make_fast_table(&ds->lt))
+				goto failed;
 			ds->state = ST_MAIN;
 			return (100);
 		}
@@ -3013,6 +3058,219 @@ next_data:
 	return (ARCHIVE_OK);
 }
 
+/*
+ * Decode LZX symbols while there is enough input and output for the
+ * longest symbol and match, so that, unlike lzx_decode_blocks(), it
+ * needn't check for the end of either.  The bit cache is refilled 32
+ * bits at a time, codes are looked up in two-level tables, and the
+ * decoded bytes are written to the output only, then copied into the
+ * window in one piece; a match that reaches back past the start of
+ * this output is copied from the window.  lzx_decode_blocks()
+ * decodes the rest.
+ *
+ * Returns -1 on broken data, else 0.
+ */
+#define lzx_fast_refill(cache, avail, in)				\
+	do {								\
+		if ((avail) < 32) {					\
+			(cache) = ((cache) << 32) |			\
+			    ((uint64_t)archive_le16dec(in) << 16) |	\
+			    archive_le16dec((in) + 2);			\
+			(in) += 4;					\
+			(avail) += 32;					\
+		}							\
+	} while (0)
+
+#define lzx_fast_copy(d, s, n)						\
+	do {								\
+		unsigned char *d_ = (d), *e_ = d_ + (n);		\
+		const unsigned char *s_ = (s);				\
+		while (d_ < e_) {					\
+			memcpy(d_, s_, 8);				\
+			d_ += 8;					\
+			s_ += 8;					\
+		}							\
+	} while (0)
+
+#define lzx_fast_bits(cache, avail, n)					\
+	(((uint32_t)((cache) >> ((avail) - (n)))) & cache_masks[n])
+
+/*
+ * The tables are passed in pieces so that they stay in registers;
+ * the stores to the output may alias struct huffman.
+ */
+static inline int
+lzx_fast_decode_huffman(const uint32_t *tbl, int max_bits, int sbits,
+    uint64_t cache, int *avail)
+{
+	uint32_t e, v;
+
+	v = lzx_fast_bits(cache, *avail, max_bits);
+	e = tbl[v >> sbits];
+	if (e & 0x80)
+		e = tbl[(e >> 8) + (v & ((1U << sbits) - 1))];
+	*avail -= e & 0x1f;
+	return (e >> 8);
+}
+
+static int
+lzx_decode_fast(struct lzx_stream *strm)
+{
+	struct lzx_dec *ds = strm->ds;
+	const uint32_t *at_tbl = ds->at.ftbl, *lt_tbl = ds->lt.ftbl;
+	const uint32_t *mt_tbl = ds->mt.ftbl;
+	int at_bits = ds->at.max_bits, at_sbits = ds->at.sbits;
+	int lt_bits = ds->lt.max_bits, lt_sbits = ds->lt.sbits;
+	int mt_bits = ds->mt.max_bits, mt_sbits = ds->mt.sbits;
+	const struct lzx_pos_tbl *pos_tbl = ds->pos_tbl;
+	const unsigned char *in = strm->next_in, *in_end;
+	unsigned char *out = strm->next_out, *out_end;
+	unsigned char *w_buff = ds->w_buff;
+	uint64_t cache = ds->br.cache_buffer;
+	int avail = ds->br.cache_avail;
+	size_t block_bytes_avail = ds->block_bytes_avail;
+	size_t produced;
+	int aligned = ds->block_type == ALIGNED_OFFSET_BLOCK;
+	int r0 = ds->r0, r1 = ds->r1, r2 = ds->r2;
+	int w_pos = ds->w_pos, w_mask = ds->w_mask, w_size = ds->w_size;
+	int c, copy_len, dist, offset_bits, slot, l;
+
+	if (ds->br.have_odd || strm->avail_in < LZX_FAST_IN ||
+	    strm->avail_out < LZX_FAST_OUT)
+		return (0);
+	if (mt_bits == 0)
+		return (-1);/* Empty main tree. */
+	in_end = in + strm->avail_in - LZX_FAST_IN;
+	out_end = out + strm->avail_out - LZX_FAST_OUT;
+
+	while (in <= in_end && out <= out_end && block_bytes_avail >= 257) {
+		lzx_fast_refill(cache, avail, in);
+		c = lzx_fast_decode_huffman(mt_tbl, mt_bits, mt_sbits, cache,
+		    &avail);
+		if (c <= UCHAR_MAX) {
+			*out++ = c;
+			block_bytes_avail--;
+			continue;
+		}
+		c -= UCHAR_MAX + 1;
+		slot = c >> 3;
+		copy_len = (c & 7) + 2;
+		if ((c & 7) == 7) {
+			if (lt_bits == 0)
+				return (-1);/* Empty length tree. */
+			lzx_fast_refill(cache, avail, in);
+			copy_len += lzx_fast_decode_huffman(lt_tbl, lt_bits,
+			    lt_sbits, cache, &avail);
+		}
+
+		switch (slot) {
+		case 0: /* Use repeated offset 0. */
+			dist = r0;
+			break;
+		case 1: /* Use repeated offset 1. */
+			dist = r1;
+			r1 = r0;
+			r0 = dist;
+			break;
+		case 2: /* Use repeated offset 2. */
+			dist = r2;
+			r2 = r0;
+			r0 = dist;
+			break;
+		default:
+			lzx_fast_refill(cache, avail, in);
+			offset_bits = pos_tbl[slot].footer_bits;
+			if (aligned && offset_bits >= 3) {
+				if (at_bits == 0)
+					return (-1);/* Empty aligned tree. */
+				offset_bits -= 3;
+				dist = lzx_fast_bits(cache, avail,
+				    offset_bits) << 3;
+				avail -= offset_bits;
+				dist += lzx_fast_decode_huffman(at_tbl,
+				    at_bits, at_sbits, cache, &avail);
+			} else {
+				dist = lzx_fast_bits(cache, avail,
+				    offset_bits);
+				avail -= offset_bits;
+			}
+			dist += pos_tbl[slot].base - 2;
+			r2 = r1;
+			r1 = r0;
+			r0 = dist;
+			break;
+		}
+		block_bytes_avail -= copy_len;
+
+		/* Positions in the window wrap around, as in
+		 * lzx_decode_blocks(). */
+		dist &= w_mask;
+		if (dist == 0)
+			dist = w_size;
+		produced = out - strm->next_out;
+		if ((size_t)dist > produced) {
+			/* Copy the part of the match that is in the
+			 * window, which ends at w_pos. */
+			int src = (w_pos - (dist - (int)produced)) & w_mask;
+
+			l = dist - (int)produced;
+			if (l > copy_len)
+				l = copy_len;
+			copy_len -= l;
+			if (l > w_size - src) {
+				memcpy(out, w_buff + src, w_size - src);
+				out += w_size - src;
+				l -= w_size - src;
+				src = 0;
+			}
+			/* Copy 8 bytes at a time, as below; what is
+			 * copied past the end of the match is
+			 * overwritten. */
+			lzx_fast_copy(out, w_buff + src, l);
+			out += l;
+		}
+		if (copy_len > 0) {
+			const unsigned char *s = out - dist;
+			unsigned char *d = out;
+
+			if (dist >= 8) {
+				/* The source is at least 8 bytes behind. */
+				lzx_fast_copy(d, s, copy_len);
+				out += copy_len;
+			} else {
+				out += copy_len;
+				do {
+					*d++ = *s++;
+				} while (d < out);
+			}
+		}
+	}
+
+	/* Copy the output into the window. */
+	produced = out - strm->next_out;
+	if (produced > 0) {
+		l = (int)produced;
+		if (l > w_size - w_pos) {
+			memcpy(w_buff + w_pos, strm->next_out, w_size - w_pos);
+			memcpy(w_buff, strm->next_out + (w_size - w_pos),
+			    l - (w_size - w_pos));
+		} else
+			memcpy(w_buff + w_pos, strm->next_out, l);
+		ds->w_pos = (w_pos + l) & w_mask;
+	}
+
+	ds->br.cache_buffer = cache;
+	ds->br.cache_avail = avail;
+	ds->block_bytes_avail = block_bytes_avail;
+	ds->r0 = r0; ds->r1 = r1; ds->r2 = r2;
+	strm->avail_in -= in - strm->next_in;
+	strm->next_in = in;
+	strm->next_out = out;
+	strm->avail_out -= produced;
+	strm->total_out += produced;
+	return (0);
+}
+
 static int
 lzx_read_pre_tree(struct lzx_stream *strm)
 {
@@ -3142,6 +3400,7 @@ lzx_huffman_free(struct huffman *hf)
 {
 	free(hf->bitlen);
 	free(hf->tbl);
+	free(hf->ftbl);
 }
 
 /*
@@ -3217,6 +3476,68 @@ lzx_make_huffman_table(struct huffman *hf)
 	return (1);
 }
 
+/*
+ * Make the two-level table for lzx_decode_fast() from the bit lengths
+ * lzx_make_huffman_table() checked.  An entry is a symbol and its bit
+ * length (symbol << 8 | length), or, in the first level, the start of
+ * a second-level table (start << 8 | 0x80).
+ */
+static int
+lzx_make_fast_table(struct huffman *hf)
+{
+	uint32_t *tbl;
+	int code[18], next;
+	int i, len, cnt, ptn;
+
+	if (hf->ftbl == NULL) {
+		/* The second-level tables take at most 1 << 16 entries. */
+		hf->ftbl = malloc((((size_t)1 << LZX_FAST_BITS) +
+		    ((size_t)1 << 16)) * sizeof(hf->ftbl[0]));
+		if (hf->ftbl == NULL)
+			return (0);
+	}
+	tbl = hf->ftbl;
+	hf->fbits = hf->max_bits < LZX_FAST_BITS ?
+	    hf->max_bits : LZX_FAST_BITS;
+	hf->sbits = hf->max_bits - hf->fbits;
+	memset(tbl, 0, ((size_t)1 << hf->fbits) * sizeof(tbl[0]));
+	if (hf->max_bits == 0)
+		return (1);
+
+	/* The first code of each length, as in lzx_make_huffman_table(). */
+	code[1] = 0;
+	for (len = 1; len < 17; len++)
+		code[len + 1] = (code[len] + hf->freq[len]) << 1;
+
+	next = 1 << hf->fbits;
+	for (i = 0; i < hf->len_size; i++) {
+		len = hf->bitlen[i];
+		if (len == 0)
+			continue;
+		ptn = code[len]++;
+		if (len <= hf->fbits)
+			ptn <<= hf->fbits - len;
+		else {
+			/* Index the second-level table by the rest of
+			 * the code. */
+			uint32_t *e = &tbl[ptn >> (len - hf->fbits)];
+
+			if ((*e & 0x80) == 0) {
+				*e = ((uint32_t)next << 8) | 0x80;
+				next += 1 << hf->sbits;
+			}
+			ptn = (int)(*e >> 8) +
+			    ((ptn & ((1 << (len - hf->fbits)) - 1)) <<
+			    (hf->max_bits - len));
+		}
+		cnt = 1 << (len <= hf->fbits ?
+		    hf->fbits - len : hf->max_bits - len);
+		while (--cnt >= 0)
+			tbl[ptn + cnt] = ((uint32_t)i << 8) | len;
+	}
+	return (1);
+}
+
 static inline int
 lzx_decode_huffman(struct huffman *hf, unsigned rbits)
 {
@@ -38,6 +38,7 @@
 #endif
 
 #include "archive.h"
+#include "archive_endian.h"
 #include "archive_entry.h"
 #include "archive_entry_locale.h"
 #include "archive_private.h"
@@ -161,21 +162,12 @@
 #define afiol_header_size 116
 
 
-struct links_entry {
-        struct links_entry      *next;
-        struct links_entry      *previous;
-        unsigned int             links;
-        dev_t                    dev;
-        int64_t                  ino;
-        char                    *name;
-};
-
 #define	CPIO_MAGIC   0x13141516
 struct cpio {
 	int			  magic;
 	int			(*read_header)(struct archive_read *, struct cpio *,
 				     struct archive_entry *, size_t *, size_t *);
-	struct links_entry	 *links_head;
+	struct archive_entry_linktable *links;
 	int64_t			  entry_bytes_remaining;
 	int64_t			  entry_bytes_unconsumed;
 	int64_t			  entry_offset;
@@ -214,6 +206,8 @@ static int	header_afiol(struct archive_read *, struct cpio *,
 		    struct archive_entry *, size_t *, size_t *);
 static int	is_octal(const char *, size_t);
 static int	is_hex(const char *, size_t);
+static inline int hex8(const char *, uint64_t *);
+static inline int octal8(const char *, uint64_t *);
 static int64_t	le4(const unsigned char *);
 static int	record_hardlink(struct archive_read *a,
 		    struct cpio *cpio, struct archive_entry *entry);
@@ -384,6 +378,10 @@ archive_read_format_cpio_read_header(struct archive_read *a,
 	if (r < ARCHIVE_WARN)
 		return (r);
 
+	if (__archive_read_check_limit(a, ARCHIVE_READ_LIMIT_HEADER_BYTES,
+	    (int64_t)(namelength + name_pad), "cpio name") != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
+
 	/* Read name from buffer. */
 	h = __archive_read_ahead(a, namelength + name_pad, NULL);
 	if (h == NULL)
@@ -451,6 +449,11 @@ archive_read_format_cpio_read_header(struct archive_read *a,
 		return (ARCHIVE_FATAL);
 	}
 
+	/* A regular entry's data is stored as-is after its name. */
+	if (archive_entry_filetype(entry) == AE_IFREG &&
+	    cpio->entry_bytes_remaining > 0)
+		__archive_read_set_stored(a, cpio->entry_bytes_remaining);
+
 	return (r);
 }
 
@@ -509,6 +512,64 @@ archive_read_format_cpio_skip(struct archive_read *a)
 	return (ARCHIVE_OK);
 }
 
+/*
+ * Check and convert eight ASCII hex or octal digits at once, one to
+ * each byte of a 64-bit word, rather than one at a time; the headers
+ * are nearly all eight digit fields.  Each returns 0 if any of the
+ * eight is not a digit.
+ */
+#define	SWAR_ONES	UINT64_C(0x0101010101010101)
+#define	SWAR_HIGH	UINT64_C(0x8080808080808080)
+
+static inline int
+hex8(const char *p, uint64_t *v)
+{
+	uint64_t x, l, digit, alpha, n;
+
+	x = archive_le64dec(p);
+	if (x & SWAR_HIGH)
+		return (0);
+	/* No byte is over 0x7f, so adding up to 0x50 to each cannot
+	 * carry into the next; the high bit of a byte of digit is set
+	 * if it is '0' to '9', of alpha if it is 'a' to 'f' or 'A' to
+	 * 'F'. */
+	l = x | (0x20 * SWAR_ONES);
+	digit = (x + (0x80 - '0') * SWAR_ONES) &
+	    ~(x + (0x80 - '9' - 1) * SWAR_ONES);
+	alpha = (l + (0x80 - 'a') * SWAR_ONES) &
+	    ~(l + (0x80 - 'f' - 1) * SWAR_ONES);
+	if (((digit | alpha) & SWAR_HIGH) != SWAR_HIGH)
+		return (0);
+	/* The low four bits are the value of a digit, or 9 less than
+	 * the value of a letter. */
+	n = (x & (0x0f * SWAR_ONES)) + ((alpha & SWAR_HIGH) >> 7) * 9;
+	/* The first digit is in the low byte; gather pairs, then
+	 * fours, then all eight. */
+	n = ((n & UINT64_C(0x000f000f000f000f)) << 4) |
+	    ((n >> 8) & UINT64_C(0x000f000f000f000f));
+	n = ((n & UINT64_C(0x000000ff000000ff)) << 8) |
+	    ((n >> 16) & UINT64_C(0x000000ff000000ff));
+	*v = ((n & 0xffff) << 16) | ((n >> 32) & 0xffff);
+	return (1);
+}
+
+static inline int
+octal8(const char *p, uint64_t *v)
+{
+	uint64_t n;
+
+	n = archive_le64dec(p);
+	if ((n & (0xf8 * SWAR_ONES)) != 0x30 * SWAR_ONES)
+		return (0);
+	n &= 0x07 * SWAR_ONES;
+	n = ((n & UINT64_C(0x0007000700070007)) << 3) |
+	    ((n >> 8) & UINT64_C(0x0007000700070007));
+	n = ((n & UINT64_C(0x0000003f0000003f)) << 6) |
+	    ((n >> 16) & UINT64_C(0x0000003f0000003f));
+	*v = ((n & 0xfff) << 12) | ((n >> 32) & 0xfff);
+	return (1);
+}
+
 /*
  * Skip forward to the next cpio newc header by searching for the
  * 07070[12] string.  This should be generalized and merged with
@@ -517,6 +578,12 @@ archive_read_format_cpio_skip(struct archive_read *a)
 static int
 is_hex(const char *p, size_t len)
 {
+	uint64_t v;
+
+	for (; len >= 8; len -= 8, p += 8) {
+		if (!hex8(p, &v))
+			return (0);
+	}
 	while (len-- > 0) {
 		if ((*p >= '0' && *p <= '9')
 		    || (*p >= 'a' && *p <= 'f')
@@ -551,37 +618,31 @@ find_newc_header(struct archive_read *a)
 
 		/*
 		 * Scan ahead until we find something that looks
-		 * like a newc header.
+		 * like a newc header.  memchr() finds the '0' that
+		 * starts each candidate much faster than checking
+		 * every byte here.
 		 */
-		while (p + newc_header_size <= q) {
-			switch (p[5]) {
-			case '1':
-			case '2':
-				if (memcmp("07070", p, 5) == 0
-				    && is_hex(p, newc_header_size)) {
-					skip = p - (const char *)h;
-					__archive_read_consume(a, skip);
-					skipped += skip;
-					if (skipped > 0) {
-						archive_set_error(&a->archive,
-						    0,
-						    "Skipped %d bytes before "
-						    "finding valid header",
-						    (int)skipped);
-						return (ARCHIVE_WARN);
-					}
-					return (ARCHIVE_OK);
+		q -= newc_header_size - 1;
+		while ((p = memchr(p, '0', q - p)) != NULL) {
+			if (memcmp("07070", p, 5) == 0
+			    && (p[5] == '1' || p[5] == '2')
+			    && is_hex(p, newc_header_size)) {
+				skip = p - (const char *)h;
+				__archive_read_consume(a, skip);
+				skipped += skip;
+				if (skipped > 0) {
+					archive_set_error(&a->archive,
+					    0,
+					    "Skipped %d bytes before "
+					    "finding valid header",
+					    (int)skipped);
+					return (ARCHIVE_WARN);
 				}
-				p += 2;
-				break;
-			case '0':
-				p++;
-				break;
-			default:
-				p += 6;
-				break;
+				return (ARCHIVE_OK);
 			}
+			p++;
 		}
+		p = q;
 		skip = p - (const char *)h;
 		__archive_read_consume(a, skip);
 		skipped += skip;
@@ -668,6 +729,12 @@ header_newc(struct archive_read *a, struct cpio *cpio,
 static int
 is_octal(const char *p, size_t len)
 {
+	uint64_t v;
+
+	for (; len >= 8; len -= 8, p += 8) {
+		if (!octal8(p, &v))
+			return (0);
+	}
 	while (len-- > 0) {
 		if (*p < '0' || *p > '7')
 			return (0);
@@ -701,7 +768,7 @@ static int
 find_odc_header(struct archive_read *a)
 {
 	const void *h;
-	const char *p, *q;
+	const char *p, *q, *e;
 	size_t skip, skipped = 0;
 	ssize_t bytes;
 
@@ -722,41 +789,33 @@ find_odc_header(struct archive_read *a)
 
 		/*
 		 * Scan ahead until we find something that looks
-		 * like an odc header.
+		 * like an odc header, with memchr() as for newc.
 		 */
-		while (p + odc_header_size <= q) {
-			switch (p[5]) {
-			case '7':
-				if ((memcmp("070707", p, 6) == 0
-				    && is_octal(p, odc_header_size))
-				    || (memcmp("070727", p, 6) == 0
-				        && is_afio_large(p, q - p))) {
-					skip = p - (const char *)h;
-					__archive_read_consume(a, skip);
-					skipped += skip;
-					if (p[4] == '2')
-						a->archive.archive_format =
-						    ARCHIVE_FORMAT_CPIO_AFIO_LARGE;
-					if (skipped > 0) {
-						archive_set_error(&a->archive,
-						    0,
-						    "Skipped %d bytes before "
-						    "finding valid header",
-						    (int)skipped);
-						return (ARCHIVE_WARN);
-					}
-					return (ARCHIVE_OK);
+		e = q - (odc_header_size - 1);
+		while ((p = memchr(p, '0', e - p)) != NULL) {
+			if ((memcmp("070707", p, 6) == 0
+			    && is_octal(p, odc_header_size))
+			    || (memcmp("070727", p, 6) == 0
+				&& is_afio_large(p, q - p))) {
+				skip = p - (const char *)h;
+				__archive_read_consume(a, skip);
+				skipped += skip;
+				if (p[4] == '2')
+					a->archive.archive_format =
+					    ARCHIVE_FORMAT_CPIO_AFIO_LARGE;
+				if (skipped > 0) {
+					archive_set_error(&a->archive,
+					    0,
+					    "Skipped %d bytes before "
+					    "finding valid header",
+					    (int)skipped);
+					return (ARCHIVE_WARN);
 				}
-				p += 2;
-				break;
-			case '0':
-				p++;
-				break;
-			default:
-				p += 6;
-				break;
+				return (ARCHIVE_OK);
 			}
+			p++;
 		}
+		p = e;
 		skip = p - (const char *)h;
 		__archive_read_consume(a, skip);
 		skipped += skip;
@@ -979,13 +1038,7 @@ archive_read_format_cpio_cleanup(struct archive_read *a)
 
 	cpio = (struct cpio *)(a->format->data);
         /* Free inode->name map */
-        while (cpio->links_head != NULL) {
-                struct links_entry *lp = cpio->links_head->next;
-
-                free(cpio->links_head->name);
-                free(cpio->links_head);
-                cpio->links_head = lp;
-        }
+        archive_entry_linktable_free(cpio->links);
 	free(cpio);
 	(a->format->data) = NULL;
 	return (ARCHIVE_OK);
@@ -1012,10 +1065,12 @@ be4(const unsigned char *p)
 static int64_t
 atol8(const char *p, unsigned char_cnt)
 {
-	uint64_t l;
+	uint64_t l, v;
 	int digit;
 
 	l = 0;
+	for (; char_cnt >= 8 && octal8(p, &v); char_cnt -= 8, p += 8)
+		l = (l << 24) | v;
 	while (char_cnt-- > 0) {
 		if (*p >= '0' && *p <= '7')
 			digit = *p - '0';
@@ -1031,10 +1086,12 @@ atol8(const char *p, unsigned char_cnt)
 static int64_t
 atol16(const char *p, unsigned char_cnt)
 {
-	uint64_t l;
+	uint64_t l, v;
 	int digit;
 
 	l = 0;
+	for (; char_cnt >= 8 && hex8(p, &v); char_cnt -= 8, p += 8)
+		l = (l << 32) | v;
 	while (char_cnt-- > 0) {
 		if (*p >= 'a' && *p <= 'f')
 			digit = *p - 'a' + 10;
@@ -1055,59 +1112,37 @@ static int
 record_hardlink(struct archive_read *a,
     struct cpio *cpio, struct archive_entry *entry)
 {
-	struct links_entry      *le;
-	dev_t dev;
-	int64_t ino;
+	const char *name;
 
 	if (archive_entry_nlink(entry) <= 1)
 		return (ARCHIVE_OK);
 
-	dev = archive_entry_dev(entry);
-	ino = archive_entry_ino64(entry);
-
 	/*
-	 * First look in the list of multiply-linked files.  If we've
-	 * already dumped it, convert this entry to a hard link entry.
+	 * The table of multiply-linked files keeps the first name of
+	 * each; past the memory limit it moves to a temporary file
+	 * rather than growing the process.
 	 */
-	for (le = cpio->links_head; le; le = le->next) {
-		if (le->dev == dev && le->ino == ino) {
-			archive_entry_copy_hardlink(entry, le->name);
-
-			if (--le->links <= 0) {
-				if (le->previous != NULL)
-					le->previous->next = le->next;
-				if (le->next != NULL)
-					le->next->previous = le->previous;
-				if (cpio->links_head == le)
-					cpio->links_head = le->next;
-				free(le->name);
-				free(le);
-			}
-
-			return (ARCHIVE_OK);
-		}
-	}
-
-	le = malloc(sizeof(struct links_entry));
-	if (le == NULL) {
-		archive_set_error(&a->archive,
-		    ENOMEM, "Out of memory adding file to list");
-		return (ARCHIVE_FATAL);
-	}
-	if (cpio->links_head != NULL)
-		cpio->links_head->previous = le;
-	le->next = cpio->links_head;
-	le->previous = NULL;
-	cpio->links_head = le;
-	le->dev = dev;
-	le->ino = ino;
-	le->links = archive_entry_nlink(entry) - 1;
-	le->name = strdup(archive_entry_pathname(entry));
-	if (le->name == NULL) {
-		archive_set_error(&a->archive,
-		    ENOMEM, "Out of memory adding file to list");
-		return (ARCHIVE_FATAL);
+	if (cpio->links == NULL) {
+		cpio->links = archive_entry_linktable_new();
+		if (cpio->links == NULL)
+			goto nomem;
+		if (a->limits[ARCHIVE_READ_LIMIT_MEMORY] > 0)
+			archive_entry_linktable_set_spill(cpio->links, NULL,
+			    (size_t)a->limits[ARCHIVE_READ_LIMIT_MEMORY]);
 	}
 
+	/*
+	 * If we've already dumped an earlier link, convert this entry
+	 * to a hard link entry.
+	 */
+	if (archive_entry_linktable_record(cpio->links, entry, &name)
+	    != ARCHIVE_OK)
+		goto nomem;
+	if (name != NULL)
+		archive_entry_copy_hardlink(entry, name);
 	return (ARCHIVE_OK);
+nomem:
+	archive_set_error(&a->archive,
+	    ENOMEM, "Out of memory adding file to list");
+	return (ARCHIVE_FATAL);
 }
@@ -268,6 +268,7 @@ struct file_info {
 	uint64_t	 size;		/* File size in bytes.		*/
 	uint32_t	 ce_offset;	/* Offset of CE.		*/
 	uint32_t	 ce_size;	/* Size of CE.			*/
+	int		 ce_depth;	/* Number of CEs followed.	*/
 	char		 rr_moved;	/* Flag to rr_moved.		*/
 	char		 rr_moved_has_re_only;
 	char		 re;		/* Having RRIP "RE" extension.	*/
@@ -1904,6 +1905,10 @@ parse_file_info(struct archive_read *a, struct file_info *parent,
 		}
 	}
 
+	if (__archive_read_charge_memory(a, sizeof(*file),
+	    "ISO9660 directory") != ARCHIVE_OK)
+		return (NULL);
+
 	/* Create a new file entry and copy data from the ISO dir record. */
 	file = calloc(1, sizeof(*file));
 	if (file == NULL) {
@@ -2185,6 +2190,7 @@ parse_file_info(struct archive_read *a, struct file_info *parent,
 fail:
 	archive_string_free(&file->name);
 	free(file);
+	__archive_read_release_memory(a, sizeof(*file));
 	return (NULL);
 }
 
@@ -2385,6 +2391,12 @@ register_CE(struct archive_read *a, int32_t location,
 		return (ARCHIVE_FATAL);
 	}
 
+	/* A CE may point back into the block being read, so bound
+	 * how many a single file can chain together. */
+	if (__archive_read_check_limit(a, ARCHIVE_READ_LIMIT_DEPTH,
+	    ++file->ce_depth, "SUSP \"CE\" continuations") != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
+
 	/* Expand our CE list as necessary. */
 	heap = &(iso9660->read_ce_req);
 	if (heap->cnt >= heap->allocated) {
@@ -63,6 +63,13 @@
  * Note: this used for both position table and pre literal table.*/
 #define PT_BITLEN_SIZE		(3 + 16)
 
+/* Bits of the first level of the tables of lzh_decode_fast(). */
+#define LZH_FAST_BITS		10
+/* Most input one symbol uses: one refill of 64 bits. */
+#define LZH_FAST_IN		8
+/* Most window one symbol fills, and the overrun of a match copy. */
+#define LZH_FAST_OUT		(MAXMATCH + 8)
+
 struct lzh_dec {
 	/* Decoding status. */
 	int     		 state;
@@ -73,7 +80,8 @@ struct lzh_dec {
 	 */
 	int			 w_size;
 	int			 w_mask;
-	/* Window buffer, which is a loop buffer. */
+	/* Window buffer, which is a loop buffer.  lzh_decode_fast()
+	 * may copy up to 8 bytes past the end of it. */
 	unsigned char		*w_buff;
 	/* The insert position to the window. */
 	int			 w_pos;
@@ -123,6 +131,15 @@ struct lzh_dec {
 			uint16_t left;
 			uint16_t right;
 		}		*tree;
+		/*
+		 * Two-level table for lzh_decode_fast(): the first
+		 * level is indexed by the first fbits bits of a code,
+		 * the second level by the sbits bits after them, so no
+		 * code needs the tree.
+		 */
+		uint32_t	*ftbl;
+		int		 fbits;
+		int		 sbits;
 	}			 lt, pt;
 
 	int			 blocks_avail;
@@ -133,6 +150,8 @@ struct lzh_dec {
 	int			 reading_position;
 	int			 loop;
 	int			 error;
+	/* Use lzh_decode_fast() where there is room for it. */
+	int			 fast;
 };
 
 struct lzh_stream {
@@ -198,6 +217,8 @@ struct lha {
 	char			 entry_is_compressed;
 
 	char			 format_name[64];
+	/* Decode lh5, lh6 and lh7 with the reference decoder only. */
+	char			 lzh_reference;
 
 	struct lzh_stream	 strm;
 };
@@ -251,6 +272,8 @@ static void	lzh_huffman_free(struct huffman *);
 static int	lzh_read_pt_bitlen(struct lzh_stream *, int start, int end);
 static int	lzh_make_fake_table(struct huffman *, uint16_t);
 static int	lzh_make_huffman_table(struct huffman *);
+static int	lzh_make_fast_table(struct huffman *);
+static int	lzh_decode_fast(struct lzh_stream *);
 static inline int lzh_decode_huffman(struct huffman *, unsigned);
 static int	lzh_decode_huffman_tree(struct huffman *, unsigned, int);
 
@@ -411,6 +434,19 @@ archive_read_format_lha_options(struct archive_read *a,
 				ret = ARCHIVE_FATAL;
 		}
 		return (ret);
+	} else if (strcmp(key, "lzh") == 0) {
+		/* "reference" selects the original lh5, lh6 and lh7
+		 * decoder, to check the faster one against. */
+		if (val != NULL && strcmp(val, "reference") == 0)
+			lha->lzh_reference = 1;
+		else if (val != NULL && strcmp(val, "fast") == 0)
+			lha->lzh_reference = 0;
+		else {
+			archive_set_error(&a->archive, ARCHIVE_ERRNO_MISC,
+			    "lha: lzh option needs \"fast\" or \"reference\"");
+			return (ARCHIVE_FAILED);
+		}
+		return (ARCHIVE_OK);
 	}
 
 	/* Note: The "warn" return is just to inform the options
@@ -1190,6 +1226,11 @@ lha_read_file_extended_header(struct archive_read *a, struct lha *lha,
 		if (((uint64_t)*total_size + extdsize) > limitsize ||
 		    extdsize <= (size_t)sizefield_length)
 			goto invalid;
+		if (__archive_read_check_limit(a,
+		    ARCHIVE_READ_LIMIT_HEADER_BYTES,
+		    (int64_t)*total_size + extdsize,
+		    "LHa extended headers") != ARCHIVE_OK)
+			return (ARCHIVE_FATAL);
 
 		/* Read the extended header. */
 		if ((h = __archive_read_ahead(a, extdsize, NULL)) == NULL)
@@ -1579,6 +1620,7 @@ lha_read_data_lzh(struct archive_read *a, const void **buff,
 			    "for lzh decompression");
 			return (ARCHIVE_FATAL);
 		}
+		lha->strm.ds->fast = !lha->lzh_reference;
 		/* We've initialized decompression for this stream. */
 		lha->decompress_init = 1;
 		lha->strm.avail_out = 0;
@@ -1897,7 +1939,7 @@ lzh_decode_init(struct lzh_stream *strm, const char *method)
 	ds->w_size = 1U << 17;
 	ds->w_mask = ds->w_size -1;
 	if (ds->w_buff == NULL) {
-		ds->w_buff = malloc(ds->w_size);
+		ds->w_buff = malloc(ds->w_size + 8);
 		if (ds->w_buff == NULL)
 			return (ARCHIVE_FATAL);
 	}
@@ -2105,8 +2147,12 @@ lzh_decode(struct lzh_stream *strm, int last)
 	do {
 		if (ds->state < ST_GET_LITERAL)
 			r = lzh_read_blocks(strm, last);
-		else
+		else {
+			if (ds->fast && ds->state == ST_GET_LITERAL &&
+			    lzh_decode_fast(strm) < 0)
+				return (ds->error = ARCHIVE_FAILED);
 			r = lzh_decode_blocks(strm, last);
+		}
 	} while (r == 100);
 	strm->total_in += avail_in - strm->avail_in;
 	return (r);
@@ -2198,6 +2244,9 @@ lzh_read_blocks(struct lzh_stream *strm, int last)
 				if (!lzh_make_fake_table(&(ds->pt),
 				    lzh_br_bits(br, ds->pt.len_bits)))
 					goto failed;/* Invalid data. */
+				if (ds->fast && ds->reading_position &&
+				    !lzh_make_fast_table(&(ds->pt)))
+					goto failed;
 				lzh_br_consume(br, ds->pt.len_bits);
 				if (ds->reading_position)
 					ds->state = ST_GET_LITERAL;
@@ -2250,6 +2299,9 @@ lzh_read_blocks(struct lzh_stream *strm, int last)
 			}
 			if (!lzh_make_huffman_table(&(ds->pt)))
 				goto failed;/* Invalid data */
+			if (ds->fast && ds->reading_position &&
+			    !lzh_make_fast_table(&(ds->pt)))
+				goto failed;
 			if (ds->reading_position) {
 				ds->state = ST_GET_LITERAL;
 				break;
@@ -2278,6 +2330,8 @@ lzh_read_blocks(struct lzh_stream *strm, int last)
 				if (!lzh_make_fake_table(&(ds->lt),
 				    lzh_br_bits(br, ds->lt.len_bits)))
 					goto failed;/* Invalid data */
+				if (ds->fast && !lzh_make_fast_table(&(ds->lt)))
+					goto failed;
 				lzh_br_consume(br, ds->lt.len_bits);
 				ds->state = ST_RD_POS_DATA_1;
 				break;
@@ -2336,6 +2390,8 @@ lzh_read_blocks(struct lzh_stream *strm, int last)
 			if (i > ds->lt.len_avail ||
 			    !lzh_make_huffman_table(&(ds->lt)))
 				goto failed;/* Invalid data */
+			if (ds->fast && !lzh_make_fast_table(&(ds->lt)))
+				goto failed;
 			/* FALL THROUGH */
 		case ST_RD_POS_DATA_1:
 			/*
@@ -2545,6 +2601,134 @@ next_data:
 	return (ARCHIVE_OK);
 }
 
+/*
+ * Decode lh5, lh6 and lh7 symbols while there is enough input and
+ * window for the longest symbol and match, so that, unlike
+ * lzh_decode_blocks(), it needn't check for the end of either.  The
+ * bit cache is refilled 64 bits at a time, codes are looked up in
+ * two-level tables that cover every code length, so the tree is never
+ * walked, and a match is copied 8 bytes at a time unless it overlaps
+ * itself or wraps around the window.  The window is still handed out
+ * by lzh_emit_window() without copying it.  lzh_decode_blocks()
+ * decodes the rest.
+ *
+ * Returns -1 on broken data, else 0.
+ */
+#define lzh_fast_refill(cache, avail, in)				\
+	do {								\
+		if ((avail) < 48) {					\
+			int n_ = (63 - (avail)) >> 3;			\
+			(cache) = ((cache) << (n_ << 3)) |		\
+			    (archive_be64dec(in) >> (64 - (n_ << 3)));	\
+			(in) += n_;					\
+			(avail) += n_ << 3;				\
+		}							\
+	} while (0)
+
+#define lzh_fast_copy(d, s, n)						\
+	do {								\
+		unsigned char *d_ = (d), *e_ = d_ + (n);		\
+		const unsigned char *s_ = (s);				\
+		while (d_ < e_) {					\
+			memcpy(d_, s_, 8);				\
+			d_ += 8;					\
+			s_ += 8;					\
+		}							\
+	} while (0)
+
+#define lzh_fast_bits(cache, avail, n)					\
+	(((uint32_t)((cache) >> ((avail) - (n)))) & cache_masks[n])
+
+/*
+ * The tables are passed in pieces so that they stay in registers;
+ * the stores to the window may alias struct huffman.
+ */
+static inline int
+lzh_fast_decode_huffman(const uint32_t *tbl, int bits, int sbits,
+    uint64_t cache, int *avail)
+{
+	uint32_t e, v;
+
+	v = lzh_fast_bits(cache, *avail, bits);
+	e = tbl[v >> sbits];
+	if (e & 0x80)
+		e = tbl[(e >> 8) + (v & ((1U << sbits) - 1))];
+	*avail -= e & 0x1f;
+	return (e >> 8);
+}
+
+static int
+lzh_decode_fast(struct lzh_stream *strm)
+{
+	struct lzh_dec *ds = strm->ds;
+	const uint32_t *lt_tbl = ds->lt.ftbl, *pt_tbl = ds->pt.ftbl;
+	int lt_bits = ds->lt.fbits + ds->lt.sbits, lt_sbits = ds->lt.sbits;
+	int pt_bits = ds->pt.fbits + ds->pt.sbits, pt_sbits = ds->pt.sbits;
+	const unsigned char *in = strm->next_in, *in_end;
+	unsigned char *w_buff = ds->w_buff;
+	uint64_t cache = ds->br.cache_buffer;
+	int avail = ds->br.cache_avail;
+	int blocks_avail = ds->blocks_avail;
+	int w_pos = ds->w_pos, w_mask = ds->w_mask, w_size = ds->w_size;
+	int w_end = w_size - LZH_FAST_OUT;
+	int c, copy_len, copy_pos, p;
+
+	if (strm->avail_in < LZH_FAST_IN)
+		return (0);
+	if (lt_bits == 0 || pt_bits == 0)
+		return (-1);/* The tables were not made. */
+	in_end = in + strm->avail_in - LZH_FAST_IN;
+
+	while (blocks_avail > 0 && in <= in_end && w_pos <= w_end) {
+		/* A symbol takes at most 16 + 16 + 15 bits. */
+		lzh_fast_refill(cache, avail, in);
+		c = lzh_fast_decode_huffman(lt_tbl, lt_bits, lt_sbits, cache,
+		    &avail);
+		blocks_avail--;
+		if (c <= UCHAR_MAX) {
+			w_buff[w_pos++] = c;
+			continue;
+		}
+		copy_len = c - (UCHAR_MAX + 1) + MINMATCH;
+		copy_pos = lzh_fast_decode_huffman(pt_tbl, pt_bits, pt_sbits,
+		    cache, &avail);
+		if (copy_pos > 1) {
+			p = copy_pos - 1;
+			copy_pos = (1 << p) + lzh_fast_bits(cache, avail, p);
+			avail -= p;
+		}
+
+		/* The match starts copy_pos + 1 bytes back, as in
+		 * lzh_decode_blocks(). */
+		if (copy_pos >= 7 &&
+		    ((w_pos - copy_pos - 1) & w_mask) + copy_len <= w_size) {
+			/* The source is at least 8 bytes behind and does
+			 * not wrap; what is copied past the end of the
+			 * match is overwritten, or is older than any
+			 * match can reach. */
+			lzh_fast_copy(w_buff + w_pos,
+			    w_buff + ((w_pos - copy_pos - 1) & w_mask),
+			    copy_len);
+			w_pos += copy_len;
+		} else {
+			int src = (w_pos - copy_pos - 1) & w_mask;
+
+			do {
+				w_buff[w_pos++] = w_buff[src];
+				src = (src + 1) & w_mask;
+			} while (--copy_len > 0);
+		}
+	}
+
+	ds->br.cache_buffer = cache;
+	ds->br.cache_avail = avail;
+	ds->blocks_avail = blocks_avail;
+	ds->w_pos = w_pos;
+	strm->avail_in -= (int)(in - strm->next_in);
+	strm->next_in = in;
+	return (0);
+}
+
 static int
 lzh_huffman_init(struct huffman *hf, size_t len_size, int tbl_bits)
 {
@@ -2581,6 +2765,7 @@ lzh_huffman_free(struct huffman *hf)
 	free(hf->bitlen);
 	free(hf->tbl);
 	free(hf->tree);
+	free(hf->ftbl);
 }
 
 static const char bitlen_tbl[0x400] = {
@@ -2883,6 +3068,74 @@ lzh_make_huffman_table(struct huffman *hf)
 	return (1);
 }
 
+/*
+ * Make the two-level table for lzh_decode_fast() from the bit lengths
+ * lzh_make_huffman_table() checked, or from the one symbol of a table
+ * lzh_make_fake_table() made.  An entry is a symbol and its bit
+ * length (symbol << 8 | length), or, in the first level, the start of
+ * a second-level table (start << 8 | 0x80).
+ */
+static int
+lzh_make_fast_table(struct huffman *hf)
+{
+	uint32_t *tbl;
+	int code[18], next;
+	int i, len, cnt, ptn;
+
+	if (hf->ftbl == NULL) {
+		/* The second-level tables take at most 1 << 16 entries. */
+		hf->ftbl = malloc((((size_t)1 << LZH_FAST_BITS) +
+		    ((size_t)1 << 16)) * sizeof(hf->ftbl[0]));
+		if (hf->ftbl == NULL)
+			return (0);
+	}
+	tbl = hf->ftbl;
+	if (hf->max_bits == 0) {
+		/* One symbol, which takes no bits; look up one bit. */
+		hf->fbits = 1;
+		hf->sbits = 0;
+		tbl[0] = tbl[1] = (uint32_t)hf->tbl[0] << 8;
+		return (1);
+	}
+	hf->fbits = hf->max_bits < LZH_FAST_BITS ?
+	    hf->max_bits : LZH_FAST_BITS;
+	hf->sbits = hf->max_bits - hf->fbits;
+	memset(tbl, 0, ((size_t)1 << hf->fbits) * sizeof(tbl[0]));
+
+	/* The first code of each length, as in lzh_make_huffman_table(). */
+	code[1] = 0;
+	for (len = 1; len < 17; len++)
+		code[len + 1] = (code[len] + hf->freq[len]) << 1;
+
+	next = 1 << hf->fbits;
+	for (i = 0; i < hf->len_avail; i++) {
+		len = hf->bitlen[i];
+		if (len == 0)
+			continue;
+		ptn = code[len]++;
+		if (len <= hf->fbits)
+			ptn <<= hf->fbits - len;
+		else {
+			/* Index the second-level table by the rest of
+			 * the code. */
+			uint32_t *e = &tbl[ptn >> (len - hf->fbits)];
+
+			if ((*e & 0x80) == 0) {
+				*e = ((uint32_t)next << 8) | 0x80;
+				next += 1 << hf->sbits;
+			}
+			ptn = (int)(*e >> 8) +
+			    ((ptn & ((1 << (len - hf->fbits)) - 1)) <<
+			    (hf->max_bits - len));
+		}
+		cnt = 1 << (len <= hf->fbits ?
+		    hf->fbits - len : hf->max_bits - len);
+		while (--cnt >= 0)
+			tbl[ptn + cnt] = ((uint32_t)i << 8) | len;
+	}
+	return (1);
+}
+
 static int
 lzh_decode_huffman_tree(struct huffman *hf, unsigned rbits, int c)
 {
@@ -52,7 +52,6 @@
 #include "archive_entry.h"
 #include "archive_entry_private.h"
 #include "archive_private.h"
-#include "archive_rb.h"
 #include "archive_read_private.h"
 #include "archive_string.h"
 #include "archive_pack_dev.h"
@@ -81,13 +80,80 @@
 
 #define	MAX_LINE_LEN		(1024 * 1024)
 
+/* Initial number of slots in the hash table of "full" entries. */
+#define	MTREE_HASH_MIN		1024
+
+/* Size of the chunks that entries and options are allocated from. */
+#define	MTREE_CHUNK_SIZE	(64 * 1024)
+
+/*
+ * mtree keywords.  mtree_keyword() finds them with a perfect hash of
+ * their length and their first, middle and last characters.
+ */
+enum mtree_keyword {
+	MTREE_KW_NONE = 0,
+	MTREE_KW_CKSUM, MTREE_KW_CONTENT, MTREE_KW_CONTENTS,
+	MTREE_KW_DEVICE, MTREE_KW_FLAGS, MTREE_KW_GID, MTREE_KW_GNAME,
+	MTREE_KW_IGNORE, MTREE_KW_INODE, MTREE_KW_LINK, MTREE_KW_MD5,
+	MTREE_KW_MD5DIGEST, MTREE_KW_MODE, MTREE_KW_NLINK,
+	MTREE_KW_NOCHANGE, MTREE_KW_OPTIONAL, MTREE_KW_RESDEVICE,
+	MTREE_KW_RMD160, MTREE_KW_RMD160DIGEST, MTREE_KW_SHA1,
+	MTREE_KW_SHA1DIGEST, MTREE_KW_SHA256, MTREE_KW_SHA256DIGEST,
+	MTREE_KW_SHA384, MTREE_KW_SHA384DIGEST, MTREE_KW_SHA512,
+	MTREE_KW_SHA512DIGEST, MTREE_KW_SIZE, MTREE_KW_TAGS, MTREE_KW_TIME,
+	MTREE_KW_TYPE, MTREE_KW_UID, MTREE_KW_UNAME
+};
+
+static const char * const mtree_keywords[] = {
+	NULL,
+	"cksum", "content", "contents", "device", "flags", "gid", "gname",
+	"ignore", "inode", "link", "md5", "md5digest", "mode", "nlink",
+	"nochange", "optional", "resdevice", "rmd160", "rmd160digest",
+	"sha1", "sha1digest", "sha256", "sha256digest", "sha384",
+	"sha384digest", "sha512", "sha512digest", "size", "tags", "time",
+	"type", "uid", "uname"
+};
+
+/* The keyword for each value of MTREE_KW_HASH(). */
+static const unsigned char mtree_keyword_slots[64] = {
+	 8, 31,  5,  0,  0,  0,  0,  0,  7,  0,  0,  0, 21,  0,  9, 26,
+	 0, 30,  0,  0,  3,  0, 18,  0,  0,  2, 14, 24, 23,  0,  1,  0,
+	27,  0,  0,  0, 32, 10, 17, 22, 19,  0, 15,  0,  0, 29,  0, 11,
+	20,  0,  0,  0, 33, 13,  4, 28,  6,  0, 12,  0,  0, 16, 25,  0,
+};
+
+#define	MTREE_KW_HASH(p, len)					\
+	((26 * (unsigned char)(p)[0] +				\
+	  6 * (unsigned char)(p)[(len) - 1] +			\
+	  15 * (unsigned char)(p)[((len) - 1) / 2] + (len)) & 63)
+
+/*
+ * Entries and options are allocated from a list of chunks, which are
+ * all freed together by cleanup().
+ */
+struct mtree_chunk {
+	struct mtree_chunk *next;
+	size_t used;
+	size_t size;
+};
+
+/* An option and its value are allocated together. */
 struct mtree_option {
 	struct mtree_option *next;
 	char *value;
 };
 
+/*
+ * A slot of the hash table of "full" entries.  The hash is kept in
+ * the slot so that probing does not touch the entries.
+ */
+struct mtree_slot {
+	uint32_t hash;
+	struct mtree_entry *entry;
+};
+
+/* An entry and its name are allocated together. */
 struct mtree_entry {
-	struct archive_rb_node rbnode;
 	struct mtree_entry *next_dup;
 	struct mtree_entry *next;
 	struct mtree_option *options;
@@ -106,18 +172,26 @@ struct mtree {
 	const char		*archive_format_name;
 	struct mtree_entry	*entries;
 	struct mtree_entry	*this_entry;
-	struct archive_rb_tree	 entry_rbtree;
 	struct archive_string	 current_dir;
 	struct archive_string	 contents_name;
 
 	struct archive_entry_linkresolver *resolver;
-	struct archive_rb_tree rbtree;
+
+	struct mtree_chunk	*chunks;
+
+	/* "Full" entries, hashed by name, with linear probing. */
+	struct mtree_slot	*slots;
+	size_t			 nslots;
+	size_t			 nfull;
+	int64_t			 nentries;
+	char			 truncated;
 
 	int64_t			 cur_size;
 	char checkfs;
 };
 
 static int	bid_keycmp(const char *, const char *, ssize_t);
+static int	mtree_keyword(const char *, size_t);
 static int	cleanup(struct archive_read *);
 static int	detect_form(struct archive_read *, int *);
 static int	mtree_bid(struct archive_read *, int);
@@ -230,42 +304,132 @@ archive_read_format_mtree_options(struct archive_read *a,
 	return (ARCHIVE_WARN);
 }
 
-static void
-free_options(struct mtree_option *head)
+/*
+ * Allocate size bytes for an entry or an option from the current
+ * chunk, starting a new chunk if it is full.
+ */
+static void *
+mtree_alloc(struct archive_read *a, struct mtree *mtree, size_t size)
 {
-	struct mtree_option *next;
+	struct mtree_chunk *c;
+	size_t n;
+	char *p;
 
-	for (; head != NULL; head = next) {
-		next = head->next;
-		free(head->value);
-		free(head);
+	size = (size + 7) & ~(size_t)7;
+	c = mtree->chunks;
+	if (c == NULL || c->size - c->used < size) {
+		n = size > MTREE_CHUNK_SIZE ? size : MTREE_CHUNK_SIZE;
+		if (__archive_read_charge_memory(a,
+		    (int64_t)(sizeof(*c) + n),
+		    "mtree specification") != ARCHIVE_OK)
+			return (NULL);
+		if ((c = malloc(sizeof(*c) + n)) == NULL) {
+			archive_set_error(&a->archive, ENOMEM,
+			    "Can't allocate memory");
+			return (NULL);
+		}
+		c->next = mtree->chunks;
+		c->used = 0;
+		c->size = n;
+		mtree->chunks = c;
 	}
+	p = (char *)(c + 1) + c->used;
+	c->used += size;
+	return (p);
 }
 
+/*
+ * Returns the MTREE_KW_* value of the keyword p[0..len-1], or
+ * MTREE_KW_NONE if it is not a keyword.
+ */
 static int
-mtree_cmp_node(const struct archive_rb_node *n1,
-    const struct archive_rb_node *n2)
+mtree_keyword(const char *p, size_t len)
+{
+	int kw;
+
+	if (len < 3 || len > 12)
+		return (MTREE_KW_NONE);
+	kw = mtree_keyword_slots[MTREE_KW_HASH(p, len)];
+	if (kw == MTREE_KW_NONE ||
+	    strncmp(p, mtree_keywords[kw], len) != 0 ||
+	    mtree_keywords[kw][len] != '\0')
+		return (MTREE_KW_NONE);
+	return (kw);
+}
+
+/* FNV-1a hash of an entry name. */
+static uint32_t
+mtree_hash_name(const char *name)
 {
-	const struct mtree_entry *e1 = (const struct mtree_entry *)n1;
-	const struct mtree_entry *e2 = (const struct mtree_entry *)n2;
+	uint32_t h = 2166136261U;
 
-	return (strcmp(e1->name, e2->name));
+	while (*name != '\0') {
+		h ^= (unsigned char)*name++;
+		h *= 16777619U;
+	}
+	return (h);
 }
 
+/*
+ * Add a "full" entry to the hash table, or, if an entry with the
+ * same name is already there, to the end of that entry's list of
+ * duplicates.  The table is kept at most half full.
+ */
 static int
-mtree_cmp_key(const struct archive_rb_node *n, const void *key)
+mtree_hash_insert(struct archive_read *a, struct mtree *mtree,
+    struct mtree_entry *entry)
 {
-	const struct mtree_entry *e = (const struct mtree_entry *)n;
+	struct mtree_slot *slots;
+	struct mtree_entry *e;
+	uint32_t hash;
+	size_t i, j, n;
+
+	if (mtree->nfull >= mtree->nslots / 2) {
+		n = mtree->nslots ? mtree->nslots * 2 : MTREE_HASH_MIN;
+		if (__archive_read_charge_memory(a,
+		    (int64_t)(n - mtree->nslots) * sizeof(*slots),
+		    "mtree specification") != ARCHIVE_OK)
+			return (ARCHIVE_FATAL);
+		slots = calloc(n, sizeof(*slots));
+		if (slots == NULL) {
+			archive_set_error(&a->archive, ENOMEM,
+			    "Can't allocate memory");
+			return (ARCHIVE_FATAL);
+		}
+		for (i = 0; i < mtree->nslots; i++) {
+			if (mtree->slots[i].entry == NULL)
+				continue;
+			j = mtree->slots[i].hash & (n - 1);
+			while (slots[j].entry != NULL)
+				j = (j + 1) & (n - 1);
+			slots[j] = mtree->slots[i];
+		}
+		free(mtree->slots);
+		mtree->slots = slots;
+		mtree->nslots = n;
+	}
 
-	return (strcmp(e->name, key));
+	hash = mtree_hash_name(entry->name);
+	for (i = hash & (mtree->nslots - 1); mtree->slots[i].entry != NULL;
+	    i = (i + 1) & (mtree->nslots - 1)) {
+		if (mtree->slots[i].hash == hash &&
+		    strcmp(mtree->slots[i].entry->name, entry->name) == 0) {
+			e = mtree->slots[i].entry;
+			while (e->next_dup != NULL)
+				e = e->next_dup;
+			e->next_dup = entry;
+			return (ARCHIVE_OK);
+		}
+	}
+	mtree->slots[i].hash = hash;
+	mtree->slots[i].entry = entry;
+	mtree->nfull++;
+	return (ARCHIVE_OK);
 }
 
 int
 archive_read_support_format_mtree(struct archive *_a)
 {
-	static const struct archive_rb_tree_ops rb_ops = {
-		mtree_cmp_node, mtree_cmp_key,
-	};
 	struct archive_read *a = (struct archive_read *)_a;
 	struct mtree *mtree;
 	int r;
@@ -282,8 +446,6 @@ archive_read_support_format_mtree(struct archive *_a)
 	mtree->checkfs = 0;
 	mtree->fd = -1;
 
-	__archive_rb_tree_init(&mtree->rbtree, &rb_ops);
-
 	r = __archive_read_register_format(a, mtree, "mtree",
            mtree_bid, archive_read_format_mtree_options, read_header, read_data, skip, NULL, cleanup, NULL, NULL);
 
@@ -296,18 +458,15 @@ static int
 cleanup(struct archive_read *a)
 {
 	struct mtree *mtree;
-	struct mtree_entry *p, *q;
+	struct mtree_chunk *p, *q;
 
 	mtree = (struct mtree *)(a->format->data);
 
-	p = mtree->entries;
-	while (p != NULL) {
+	for (p = mtree->chunks; p != NULL; p = q) {
 		q = p->next;
-		free(p->name);
-		free_options(p->options);
 		free(p);
-		p = q;
 	}
+	free(mtree->slots);
 	archive_string_free(&mtree->line);
 	archive_string_free(&mtree->current_dir);
 	archive_string_free(&mtree->contents_name);
@@ -454,63 +613,18 @@ bid_keycmp(const char *p, const char *key, ssize_t len)
 static int
 bid_keyword(const char *p,  ssize_t len)
 {
-	static const char * const keys_c[] = {
-		"content", "contents", "cksum", NULL
-	};
-	static const char * const keys_df[] = {
-		"device", "flags", NULL
-	};
-	static const char * const keys_g[] = {
-		"gid", "gname", NULL
-	};
-	static const char * const keys_il[] = {
-		"ignore", "inode", "link", NULL
-	};
-	static const char * const keys_m[] = {
-		"md5", "md5digest", "mode", NULL
-	};
-	static const char * const keys_no[] = {
-		"nlink", "nochange", "optional", NULL
-	};
-	static const char * const keys_r[] = {
-		"resdevice", "rmd160", "rmd160digest", NULL
-	};
-	static const char * const keys_s[] = {
-		"sha1", "sha1digest",
-		"sha256", "sha256digest",
-		"sha384", "sha384digest",
-		"sha512", "sha512digest",
-		"size", NULL
-	};
-	static const char * const keys_t[] = {
-		"tags", "time", "type", NULL
-	};
-	static const char * const keys_u[] = {
-		"uid", "uname",	NULL
-	};
-	const char * const *keys;
-	int i;
-
-	switch (*p) {
-	case 'c': keys = keys_c; break;
-	case 'd': case 'f': keys = keys_df; break;
-	case 'g': keys = keys_g; break;
-	case 'i': case 'l': keys = keys_il; break;
-	case 'm': keys = keys_m; break;
-	case 'n': case 'o': keys = keys_no; break;
-	case 'r': keys = keys_r; break;
-	case 's': keys = keys_s; break;
-	case 't': keys = keys_t; break;
-	case 'u': keys = keys_u; break;
-	default: return (0);/* Unknown key */
-	}
+	ssize_t l;
+	int kw;
 
-	for (i = 0; keys[i] != NULL; i++) {
-		int l = bid_keycmp(p, keys[i], len);
-		if (l > 0)
-			return (l);
+	/* Keywords are lower case letters and digits. */
+	for (l = 0; l < len; l++) {
+		if ((p[l] < 'a' || p[l] > 'z') && (p[l] < '0' || p[l] > '9'))
+			break;
 	}
-	return (0);/* Unknown key */
+	kw = mtree_keyword(p, (size_t)l);
+	if (kw == MTREE_KW_NONE)
+		return (0);/* Unknown key */
+	return (bid_keycmp(p, mtree_keywords[kw], len));
 }
 
 /*
@@ -814,15 +928,11 @@ add_option(struct archive_read *a, struct mtree_option **global,
 {
 	struct mtree_option *opt;
 
-	if ((opt = malloc(sizeof(*opt))) == NULL) {
-		archive_set_error(&a->archive, errno, "Can't allocate memory");
+	opt = mtree_alloc(a, (struct mtree *)(a->format->data),
+	    sizeof(*opt) + len + 1);
+	if (opt == NULL)
 		return (ARCHIVE_FATAL);
-	}
-	if ((opt->value = malloc(len + 1)) == NULL) {
-		free(opt);
-		archive_set_error(&a->archive, errno, "Can't allocate memory");
-		return (ARCHIVE_FATAL);
-	}
+	opt->value = (char *)(opt + 1);
 	memcpy(opt->value, value, len);
 	opt->value[len] = '\0';
 	opt->next = *global;
@@ -848,9 +958,6 @@ remove_option(struct mtree_option **global, const char *value, size_t len)
 		*global = iter->next;
 	else
 		last->next = iter->next;
-
-	free(iter->value);
-	free(iter);
 }
 
 static int
@@ -904,7 +1011,6 @@ process_global_unset(struct archive_read *a,
 		len = strcspn(line, " \t\r\n");
 
 		if (len == 3 && strncmp(line, "all", 3) == 0) {
-			free_options(*global);
 			*global = NULL;
 		} else {
 			remove_option(global, line, len);
@@ -925,23 +1031,6 @@ process_add_entry(struct archive_read *a, struct mtree *mtree,
 	size_t name_len, len;
 	int r, i;
 
-	if ((entry = malloc(sizeof(*entry))) == NULL) {
-		archive_set_error(&a->archive, errno, "Can't allocate memory");
-		return (ARCHIVE_FATAL);
-	}
-	entry->next = NULL;
-	entry->options = NULL;
-	entry->name = NULL;
-	entry->used = 0;
-	entry->full = 0;
-
-	/* Add this entry to list. */
-	if (*last_entry == NULL)
-		mtree->entries = entry;
-	else
-		(*last_entry)->next = entry;
-	*last_entry = entry;
-
 	if (is_form_d) {
 		/* Filename is last item on line. */
 		/* Adjust line_len to trim trailing whitespace */
@@ -978,27 +1067,31 @@ process_add_entry(struct archive_read *a, struct mtree *mtree,
 	/* name/name_len is the name within the line. */
 	/* line..end brackets the entire line except the name */
 
-	if ((entry->name = malloc(name_len + 1)) == NULL) {
-		archive_set_error(&a->archive, errno, "Can't allocate memory");
+	entry = mtree_alloc(a, mtree, sizeof(*entry) + name_len + 1);
+	if (entry == NULL)
 		return (ARCHIVE_FATAL);
-	}
+	entry->next_dup = NULL;
+	entry->next = NULL;
+	entry->options = NULL;
+	entry->name = (char *)(entry + 1);
+	entry->used = 0;
+	entry->full = 0;
+
+	/* Add this entry to list. */
+	if (*last_entry == NULL)
+		mtree->entries = entry;
+	else
+		(*last_entry)->next = entry;
+	*last_entry = entry;
 
 	memcpy(entry->name, name, name_len);
 	entry->name[name_len] = '\0';
 	parse_escapes(entry->name, entry);
 
-	entry->next_dup = NULL;
 	if (entry->full) {
-		if (!__archive_rb_tree_insert_node(&mtree->rbtree, &entry->rbnode)) {
-			struct mtree_entry *alt;
-			alt = (struct mtree_entry *)__archive_rb_tree_find_node(
-			    &mtree->rbtree, entry->name);
-			if (alt != NULL) {
-				while (alt->next_dup)
-					alt = alt->next_dup;
-				alt->next_dup = entry;
-			}
-		}
+		r = mtree_hash_insert(a, mtree, entry);
+		if (r != ARCHIVE_OK)
+			return (r);
 	}
 
 	for (iter = *global; iter != NULL; iter = iter->next) {
@@ -1053,13 +1146,10 @@ read_mtree(struct archive_read *a, struct mtree *mtree)
 		len = readline(a, mtree, &p, 65536);
 		if (len == 0) {
 			mtree->this_entry = mtree->entries;
-			free_options(global);
 			return (ARCHIVE_OK);
 		}
-		if (len < 0) {
-			free_options(global);
+		if (len < 0)
 			return ((int)len);
-		}
 		/* Leading whitespace is never significant, ignore it. */
 		while (*p == ' ' || *p == '\t') {
 			++p;
@@ -1070,9 +1160,11 @@ read_mtree(struct archive_read *a, struct mtree *mtree)
 			continue;
 		if (*p == '\r' || *p == '\n' || *p == '\0')
 			continue;
-		/* Non-printable characters are not allowed */
+		/* Non-printable characters are not allowed; printable
+		 * ASCII, by far the most common, is checked inline. */
 		for (s = p;s < p + len - 1; s++) {
-			if (!isprint((unsigned char)*s) && *s != '\t') {
+			if ((*s < 0x20 || *s > 0x7e) &&
+			    !isprint((unsigned char)*s) && *s != '\t') {
 				r = ARCHIVE_FATAL;
 				break;
 			}
@@ -1080,6 +1172,16 @@ read_mtree(struct archive_read *a, struct mtree *mtree)
 		if (r != ARCHIVE_OK)
 			break;
 		if (*p != '/') {
+			/* Stop reading lines past the entry limit; the
+			 * limit is reported after the entries so far. */
+			if (a->limits[ARCHIVE_READ_LIMIT_ENTRIES] > 0 &&
+			    mtree->nentries >=
+			    a->limits[ARCHIVE_READ_LIMIT_ENTRIES]) {
+				mtree->truncated = 1;
+				mtree->this_entry = mtree->entries;
+				return (ARCHIVE_OK);
+			}
+			mtree->nentries++;
 			r = process_add_entry(a, mtree, &global, p, len,
 			    &last_entry, is_form_d);
 		} else if (len > 4 && strncmp(p, "/set", 4) == 0) {
@@ -1093,15 +1195,12 @@ read_mtree(struct archive_read *a, struct mtree *mtree)
 		} else
 			break;
 
-		if (r != ARCHIVE_OK) {
-			free_options(global);
+		if (r != ARCHIVE_OK)
 			return r;
-		}
 	}
 
 	archive_set_error(&a->archive, ARCHIVE_ERRNO_FILE_FORMAT,
 	    "Can't parse line %ju", counter);
-	free_options(global);
 	return (ARCHIVE_FATAL);
 }
 
@@ -1138,8 +1237,16 @@ read_header(struct archive_read *a, struct archive_entry *entry)
 	a->archive.archive_format_name = mtree->archive_format_name;
 
 	for (;;) {
-		if (mtree->this_entry == NULL)
+		if (mtree->this_entry == NULL) {
+			if (mtree->truncated) {
+				(void)__archive_read_check_limit(a,
+				    ARCHIVE_READ_LIMIT_ENTRIES,
+				    mtree->nentries + 1,
+				    "mtree specification");
+				return (ARCHIVE_FATAL);
+			}
 			return (ARCHIVE_EOF);
+		}
 		if (strcmp(mtree->this_entry->name, "..") == 0) {
 			mtree->this_entry->used = 1;
 			if (archive_strlen(&mtree->current_dir) > 0) {
@@ -1203,9 +1310,12 @@ parse_file(struct archive_read *a, struct archive_entry *entry,
 		 * with pathname canonicalization, which is a very
 		 * tricky subject.)
 		 */
-		mp = (struct mtree_entry *)__archive_rb_tree_find_node(
-		    &mtree->rbtree, mentry->name);
-		for (; mp; mp = mp->next_dup) {
+		/*
+		 * mentry is the first line for its name, since the
+		 * later ones were used along with it, and they are
+		 * on its list of duplicates.
+		 */
+		for (mp = mentry->next_dup; mp; mp = mp->next_dup) {
 			if (mp->full && !mp->used) {
 				/* Later lines override earlier ones. */
 				mp->used = 1;
@@ -1602,31 +1712,38 @@ parse_keyword(struct archive_read *a, struct mtree *mtree,
     struct archive_entry *entry, struct mtree_option *opt, int *parsed_kws)
 {
 	char *val, *key;
+	int64_t m, my_time_t_max, my_time_t_min;
+	long ns;
+	dev_t dev;
+	int kw, r;
 
 	key = opt->value;
 
 	if (*key == '\0')
 		return (ARCHIVE_OK);
 
-	if (strcmp(key, "nochange") == 0) {
-		*parsed_kws |= MTREE_HAS_NOCHANGE;
-		return (ARCHIVE_OK);
-	}
-	if (strcmp(key, "optional") == 0) {
-		*parsed_kws |= MTREE_HAS_OPTIONAL;
-		return (ARCHIVE_OK);
-	}
-	if (strcmp(key, "ignore") == 0) {
-		/*
-		 * The mtree processing is not recursive, so
-		 * recursion will only happen for explicitly listed
-		 * entries.
-		 */
-		return (ARCHIVE_OK);
-	}
-
 	val = strchr(key, '=');
+	kw = mtree_keyword(key,
+	    val != NULL ? (size_t)(val - key) : strlen(key));
+
 	if (val == NULL) {
+		switch (kw) {
+		case MTREE_KW_NOCHANGE:
+			*parsed_kws |= MTREE_HAS_NOCHANGE;
+			return (ARCHIVE_OK);
+		case MTREE_KW_OPTIONAL:
+			*parsed_kws |= MTREE_HAS_OPTIONAL;
+			return (ARCHIVE_OK);
+		case MTREE_KW_IGNORE:
+			/*
+			 * The mtree processing is not recursive, so
+			 * recursion will only happen for explicitly listed
+			 * entries.
+			 */
+			return (ARCHIVE_OK);
+		default:
+			break;
+		}
 		archive_set_error(&a->archive, ARCHIVE_ERRNO_FILE_FORMAT,
 		    "Malformed attribute \"%s\" (%d)", key, key[0]);
 		return (ARCHIVE_WARN);
@@ -1635,238 +1752,186 @@ parse_keyword(struct archive_read *a, struct mtree *mtree,
 	*val = '\0';
 	++val;
 
-	switch (key[0]) {
-	case 'c':
-		if (strcmp(key, "content") == 0
-		    || strcmp(key, "contents") == 0) {
-			parse_escapes(val, NULL);
-			archive_strcpy(&mtree->contents_name, val);
-			return (ARCHIVE_OK);
-		}
-		if (strcmp(key, "cksum") == 0)
-			return (ARCHIVE_OK);
-		break;
-	case 'd':
-		if (strcmp(key, "device") == 0) {
-			/* stat(2) st_rdev field, e.g. the major/minor IDs
-			 * of a char/block special file */
-			int r;
-			dev_t dev;
-
-			*parsed_kws |= MTREE_HAS_DEVICE;
-			r = parse_device(&dev, &a->archive, val);
-			if (r == ARCHIVE_OK)
-				archive_entry_set_rdev(entry, dev);
-			return r;
-		}
-		break;
-	case 'f':
-		if (strcmp(key, "flags") == 0) {
-			*parsed_kws |= MTREE_HAS_FFLAGS;
-			archive_entry_copy_fflags_text(entry, val);
-			return (ARCHIVE_OK);
-		}
-		break;
-	case 'g':
-		if (strcmp(key, "gid") == 0) {
-			*parsed_kws |= MTREE_HAS_GID;
-			archive_entry_set_gid(entry, mtree_atol(&val, 10));
-			return (ARCHIVE_OK);
-		}
-		if (strcmp(key, "gname") == 0) {
-			*parsed_kws |= MTREE_HAS_GNAME;
-			archive_entry_copy_gname(entry, val);
-			return (ARCHIVE_OK);
-		}
-		break;
-	case 'i':
-		if (strcmp(key, "inode") == 0) {
-			archive_entry_set_ino(entry, mtree_atol(&val, 10));
-			return (ARCHIVE_OK);
-		}
-		break;
-	case 'l':
-		if (strcmp(key, "link") == 0) {
-			parse_escapes(val, NULL);
-			archive_entry_copy_symlink(entry, val);
-			return (ARCHIVE_OK);
-		}
-		break;
-	case 'm':
-		if (strcmp(key, "md5") == 0 || strcmp(key, "md5digest") == 0) {
-			return parse_digest(a, entry, val,
-			    ARCHIVE_ENTRY_DIGEST_MD5);
-		}
-		if (strcmp(key, "mode") == 0) {
-			if (val[0] < '0' || val[0] > '7') {
-				archive_set_error(&a->archive,
-				    ARCHIVE_ERRNO_FILE_FORMAT,
-				    "Symbolic or non-octal mode \"%s\" unsupported", val);
-				return (ARCHIVE_WARN);
-			}
-			*parsed_kws |= MTREE_HAS_PERM;
-			archive_entry_set_perm(entry, (mode_t)mtree_atol(&val, 8));
-			return (ARCHIVE_OK);
-		}
-		break;
-	case 'n':
-		if (strcmp(key, "nlink") == 0) {
-			*parsed_kws |= MTREE_HAS_NLINK;
-			archive_entry_set_nlink(entry,
-				(unsigned int)mtree_atol(&val, 10));
-			return (ARCHIVE_OK);
-		}
-		break;
-	case 'r':
-		if (strcmp(key, "resdevice") == 0) {
-			/* stat(2) st_dev field, e.g. the device ID where the
-			 * inode resides */
-			int r;
-			dev_t dev;
-
-			r = parse_device(&dev, &a->archive, val);
-			if (r == ARCHIVE_OK)
-				archive_entry_set_dev(entry, dev);
-			return r;
-		}
-		if (strcmp(key, "rmd160") == 0 ||
-		    strcmp(key, "rmd160digest") == 0) {
-			return parse_digest(a, entry, val,
-			    ARCHIVE_ENTRY_DIGEST_RMD160);
-		}
-		break;
-	case 's':
-		if (strcmp(key, "sha1") == 0 ||
-		    strcmp(key, "sha1digest") == 0) {
-			return parse_digest(a, entry, val,
-			    ARCHIVE_ENTRY_DIGEST_SHA1);
-		}
-		if (strcmp(key, "sha256") == 0 ||
-		    strcmp(key, "sha256digest") == 0) {
-			return parse_digest(a, entry, val,
-			    ARCHIVE_ENTRY_DIGEST_SHA256);
-		}
-		if (strcmp(key, "sha384") == 0 ||
-		    strcmp(key, "sha384digest") == 0) {
-			return parse_digest(a, entry, val,
-			    ARCHIVE_ENTRY_DIGEST_SHA384);
-		}
-		if (strcmp(key, "sha512") == 0 ||
-		    strcmp(key, "sha512digest") == 0) {
-			return parse_digest(a, entry, val,
-			    ARCHIVE_ENTRY_DIGEST_SHA512);
-		}
-		if (strcmp(key, "size") == 0) {
-			archive_entry_set_size(entry, mtree_atol(&val, 10));
-			return (ARCHIVE_OK);
-		}
-		break;
-	case 't':
-		if (strcmp(key, "tags") == 0) {
-			/*
-			 * Comma delimited list of tags.
-			 * Ignore the tags for now, but the interface
-			 * should be extended to allow inclusion/exclusion.
-			 */
-			return (ARCHIVE_OK);
-		}
-		if (strcmp(key, "time") == 0) {
-			int64_t m;
-			int64_t my_time_t_max = get_time_t_max();
-			int64_t my_time_t_min = get_time_t_min();
-			long ns = 0;
-
-			*parsed_kws |= MTREE_HAS_MTIME;
-			m = mtree_atol(&val, 10);
-			/* Replicate an old mtree bug:
-			 * 123456789.1 represents 123456789
-			 * seconds and 1 nanosecond. */
-			if (*val == '.') {
-				++val;
-				ns = (long)mtree_atol(&val, 10);
-				if (ns < 0)
-					ns = 0;
-				else if (ns > 999999999)
-					ns = 999999999;
-			}
-			if (m > my_time_t_max)
-				m = my_time_t_max;
-			else if (m < my_time_t_min)
-				m = my_time_t_min;
-			archive_entry_set_mtime(entry, (time_t)m, ns);
-			return (ARCHIVE_OK);
-		}
-		if (strcmp(key, "type") == 0) {
-			switch (val[0]) {
-			case 'b':
-				if (strcmp(val, "block") == 0) {
-					*parsed_kws |= MTREE_HAS_TYPE;
-					archive_entry_set_filetype(entry,
-						AE_IFBLK);
-					return (ARCHIVE_OK);
-				}
-				break;
-			case 'c':
-				if (strcmp(val, "char") == 0) {
-					*parsed_kws |= MTREE_HAS_TYPE;
-					archive_entry_set_filetype(entry,
-						AE_IFCHR);
-					return (ARCHIVE_OK);
-				}
-				break;
-			case 'd':
-				if (strcmp(val, "dir") == 0) {
-					*parsed_kws |= MTREE_HAS_TYPE;
-					archive_entry_set_filetype(entry,
-						AE_IFDIR);
-					return (ARCHIVE_OK);
-				}
-				break;
-			case 'f':
-				if (strcmp(val, "fifo") == 0) {
-					*parsed_kws |= MTREE_HAS_TYPE;
-					archive_entry_set_filetype(entry,
-						AE_IFIFO);
-					return (ARCHIVE_OK);
-				}
-				if (strcmp(val, "file") == 0) {
-					*parsed_kws |= MTREE_HAS_TYPE;
-					archive_entry_set_filetype(entry,
-						AE_IFREG);
-					return (ARCHIVE_OK);
-				}
-				break;
-			case 'l':
-				if (strcmp(val, "link") == 0) {
-					*parsed_kws |= MTREE_HAS_TYPE;
-					archive_entry_set_filetype(entry,
-						AE_IFLNK);
-					return (ARCHIVE_OK);
-				}
-				break;
-			default:
-				break;
-			}
+	switch (kw) {
+	case MTREE_KW_CONTENT:
+	case MTREE_KW_CONTENTS:
+		parse_escapes(val, NULL);
+		archive_strcpy(&mtree->contents_name, val);
+		return (ARCHIVE_OK);
+	case MTREE_KW_CKSUM:
+		return (ARCHIVE_OK);
+	case MTREE_KW_DEVICE:
+		/* stat(2) st_rdev field, e.g. the major/minor IDs
+		 * of a char/block special file */
+		*parsed_kws |= MTREE_HAS_DEVICE;
+		r = parse_device(&dev, &a->archive, val);
+		if (r == ARCHIVE_OK)
+			archive_entry_set_rdev(entry, dev);
+		return r;
+	case MTREE_KW_FLAGS:
+		*parsed_kws |= MTREE_HAS_FFLAGS;
+		archive_entry_copy_fflags_text(entry, val);
+		return (ARCHIVE_OK);
+	case MTREE_KW_GID:
+		*parsed_kws |= MTREE_HAS_GID;
+		archive_entry_set_gid(entry, mtree_atol(&val, 10));
+		return (ARCHIVE_OK);
+	case MTREE_KW_GNAME:
+		*parsed_kws |= MTREE_HAS_GNAME;
+		archive_entry_copy_gname(entry, val);
+		return (ARCHIVE_OK);
+	case MTREE_KW_INODE:
+		archive_entry_set_ino(entry, mtree_atol(&val, 10));
+		return (ARCHIVE_OK);
+	case MTREE_KW_LINK:
+		parse_escapes(val, NULL);
+		archive_entry_copy_symlink(entry, val);
+		return (ARCHIVE_OK);
+	case MTREE_KW_MD5:
+	case MTREE_KW_MD5DIGEST:
+		return parse_digest(a, entry, val,
+		    ARCHIVE_ENTRY_DIGEST_MD5);
+	case MTREE_KW_MODE:
+		if (val[0] < '0' || val[0] > '7') {
 			archive_set_error(&a->archive,
 			    ARCHIVE_ERRNO_FILE_FORMAT,
-			    "Unrecognized file type \"%s\"; "
-			    "assuming \"file\"", val);
-			archive_entry_set_filetype(entry, AE_IFREG);
+			    "Symbolic or non-octal mode \"%s\" unsupported", val);
 			return (ARCHIVE_WARN);
 		}
-		break;
-	case 'u':
-		if (strcmp(key, "uid") == 0) {
-			*parsed_kws |= MTREE_HAS_UID;
-			archive_entry_set_uid(entry, mtree_atol(&val, 10));
-			return (ARCHIVE_OK);
-		}
-		if (strcmp(key, "uname") == 0) {
-			*parsed_kws |= MTREE_HAS_UNAME;
-			archive_entry_copy_uname(entry, val);
-			return (ARCHIVE_OK);
+		*parsed_kws |= MTREE_HAS_PERM;
+		archive_entry_set_perm(entry, (mode_t)mtree_atol(&val, 8));
+		return (ARCHIVE_OK);
+	case MTREE_KW_NLINK:
+		*parsed_kws |= MTREE_HAS_NLINK;
+		archive_entry_set_nlink(entry,
+			(unsigned int)mtree_atol(&val, 10));
+		return (ARCHIVE_OK);
+	case MTREE_KW_RESDEVICE:
+		/* stat(2) st_dev field, e.g. the device ID where the
+		 * inode resides */
+		r = parse_device(&dev, &a->archive, val);
+		if (r == ARCHIVE_OK)
+			archive_entry_set_dev(entry, dev);
+		return r;
+	case MTREE_KW_RMD160:
+	case MTREE_KW_RMD160DIGEST:
+		return parse_digest(a, entry, val,
+		    ARCHIVE_ENTRY_DIGEST_RMD160);
+	case MTREE_KW_SHA1:
+	case MTREE_KW_SHA1DIGEST:
+		return parse_digest(a, entry, val,
+		    ARCHIVE_ENTRY_DIGEST_SHA1);
+	case MTREE_KW_SHA256:
+	case MTREE_KW_SHA256DIGEST:
+		return parse_digest(a, entry, val,
+		    ARCHIVE_ENTRY_DIGEST_SHA256);
+	case MTREE_KW_SHA384:
+	case MTREE_KW_SHA384DIGEST:
+		return parse_digest(a, entry, val,
+		    ARCHIVE_ENTRY_DIGEST_SHA384);
+	case MTREE_KW_SHA512:
+	case MTREE_KW_SHA512DIGEST:
+		return parse_digest(a, entry, val,
+		    ARCHIVE_ENTRY_DIGEST_SHA512);
+	case MTREE_KW_SIZE:
+		archive_entry_set_size(entry, mtree_atol(&val, 10));
+		return (ARCHIVE_OK);
+	case MTREE_KW_TAGS:
+		/*
+		 * Comma delimited list of tags.
+		 * Ignore the tags for now, but the interface
+		 * should be extended to allow inclusion/exclusion.
+		 */
+		return (ARCHIVE_OK);
+	case MTREE_KW_TIME:
+		my_time_t_max = get_time_t_max();
+		my_time_t_min = get_time_t_min();
+		ns = 0;
+
+		*parsed_kws |= MTREE_HAS_MTIME;
+		m = mtree_atol(&val, 10);
+		/* Replicate an old mtree bug:
+		 * 123456789.1 represents 123456789
+		 * seconds and 1 nanosecond. */
+		if (*val == '.') {
+			++val;
+			ns = (long)mtree_atol(&val, 10);
+			if (ns < 0)
+				ns = 0;
+			else if (ns > 999999999)
+				ns = 999999999;
+		}
+		if (m > my_time_t_max)
+			m = my_time_t_max;
+		else if (m < my_time_t_min)
+			m = my_time_t_min;
+		archive_entry_set_mtime(entry, (time_t)m, ns);
+		return (ARCHIVE_OK);
+	case MTREE_KW_TYPE:
+		switch (val[0]) {
+		case 'b':
+			if (strcmp(val, "block") == 0) {
+				*parsed_kws |= MTREE_HAS_TYPE;
+				archive_entry_set_filetype(entry,
+					AE_IFBLK);
+				return (ARCHIVE_OK);
+			}
+			break;
+		case 'c':
+			if (strcmp(val, "char") == 0) {
+				*parsed_kws |= MTREE_HAS_TYPE;
+				archive_entry_set_filetype(entry,
+					AE_IFCHR);
+				return (ARCHIVE_OK);
+			}
+			break;
+		case 'd':
+			if (strcmp(val, "dir") == 0) {
+				*parsed_kws |= MTREE_HAS_TYPE;
+				archive_entry_set_filetype(entry,
+					AE_IFDIR);
+				return (ARCHIVE_OK);
+			}
+			break;
+		case 'f':
+			if (strcmp(val, "fifo") == 0) {
+				*parsed_kws |= MTREE_HAS_TYPE;
+				archive_entry_set_filetype(entry,
+					AE_IFIFO);
+				return (ARCHIVE_OK);
+			}
+			if (strcmp(val, "file") == 0) {
+				*parsed_kws |= MTREE_HAS_TYPE;
+				archive_entry_set_filetype(entry,
+					AE_IFREG);
+				return (ARCHIVE_OK);
+			}
+			break;
+		case 'l':
+			if (strcmp(val, "link") == 0) {
+				*parsed_kws |= MTREE_HAS_TYPE;
+				archive_entry_set_filetype(entry,
+					AE_IFLNK);
+				return (ARCHIVE_OK);
+			}
+			break;
+		default:
+			break;
 		}
-		break;
+		archive_set_error(&a->archive,
+		    ARCHIVE_ERRNO_FILE_FORMAT,
+		    "Unrecognized file type \"%s\"; "
+		    "assuming \"file\"", val);
+		archive_entry_set_filetype(entry, AE_IFREG);
+		return (ARCHIVE_WARN);
+	case MTREE_KW_UID:
+		*parsed_kws |= MTREE_HAS_UID;
+		archive_entry_set_uid(entry, mtree_atol(&val, 10));
+		return (ARCHIVE_OK);
+	case MTREE_KW_UNAME:
+		*parsed_kws |= MTREE_HAS_UNAME;
+		archive_entry_copy_uname(entry, val);
+		return (ARCHIVE_OK);
 	default:
 		break;
 	}
@@ -2127,7 +2192,12 @@ readline(struct archive_read *a, struct mtree *mtree, char **start,
 		total_size += bytes_read;
 		mtree->line.s[total_size] = '\0';
 
-		for (u = mtree->line.s + find_off; *u; ++u) {
+		/*
+		 * Only newlines, backslashes and, until the newline has
+		 * been read, '#' matter; strcspn() skips the rest.
+		 */
+		for (u = mtree->line.s + find_off;
+		    *(u += strcspn(u, nl != NULL ? "\n\\" : "\n\\#")); ++u) {
 			if (u[0] == '\n') {
 				/* Ends with unescaped newline. */
 				*start = mtree->line.s;
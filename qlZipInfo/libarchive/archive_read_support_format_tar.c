@@ -587,6 +587,17 @@ archive_read_format_tar_read_header(struct archive_read *a,
 			}
 		}
 	}
+
+	/*
+	 * The data of a regular entry that isn't sparse is stored
+	 * as-is, so it can be copied straight from the input.
+	 */
+	if (r == ARCHIVE_OK && archive_entry_filetype(entry) == AE_IFREG &&
+	    tar->entry_bytes_remaining > 0 &&
+	    tar->sparse_list != NULL && tar->sparse_list->next == NULL &&
+	    !tar->sparse_list->hole && tar->sparse_list->offset == 0 &&
+	    tar->sparse_list->remaining == tar->entry_bytes_remaining)
+		__archive_read_set_stored(a, tar->entry_bytes_remaining);
 	return (r);
 }
 
@@ -701,6 +712,9 @@ tar_read_header(struct archive_read *a, struct tar *tar,
 	ssize_t bytes;
 	int err = ARCHIVE_OK, err2;
 	int eof_fatal = 0; /* EOF is okay at some points... */
+	int64_t ext_bytes = 0; /* Extension headers read for this entry. */
+	int64_t ext_size;
+	int ext_depth = 0;
 	const char *h;
 	const struct archive_entry_header_ustar *header;
 	const struct archive_entry_header_gnutar *gnuheader;
@@ -801,6 +815,41 @@ tar_read_header(struct archive_read *a, struct tar *tar,
 
 		/* Determine the format variant. */
 		header = (const struct archive_entry_header_ustar *)h;
+
+		/* Extension headers count against the read limits
+		 * before their bodies are read. */
+		switch(header->typeflag[0]) {
+		case 'A': case 'g': case 'K': case 'L':
+		case 'V': case 'X': case 'x':
+			/* A negative (base-256) size would wind the
+			 * count back, and a huge one would wrap it. */
+			ext_size = tar_atol(header->size,
+			    sizeof(header->size));
+			if (ext_size < 0) {
+				archive_set_error(&a->archive,
+				    ARCHIVE_ERRNO_FILE_FORMAT,
+				    "Invalid tar extension header size");
+				tar_flush_unconsumed(a, unconsumed);
+				return (ARCHIVE_FATAL);
+			}
+			if (ext_size > INT64_MAX - 512 - ext_bytes)
+				ext_bytes = INT64_MAX;
+			else
+				ext_bytes += 512 + ext_size;
+			if (__archive_read_check_limit(a,
+			    ARCHIVE_READ_LIMIT_HEADER_BYTES, ext_bytes,
+			    "tar extension headers") != ARCHIVE_OK ||
+			    __archive_read_check_limit(a,
+			    ARCHIVE_READ_LIMIT_DEPTH, ++ext_depth,
+			    "tar extension headers") != ARCHIVE_OK) {
+				tar_flush_unconsumed(a, unconsumed);
+				return (ARCHIVE_FATAL);
+			}
+			break;
+		default:
+			break;
+		}
+
 		switch(header->typeflag[0]) {
 		case 'A': /* Solaris tar ACL */
 			if (seen_headers & seen_A_header) {
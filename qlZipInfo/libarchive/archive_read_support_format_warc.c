@@ -65,6 +65,7 @@
 #ifdef HAVE_TIME_H
 #include <time.h>
 #endif
+#include <stddef.h>
 
 #include "archive.h"
 #include "archive_entry.h"
@@ -103,6 +104,15 @@ typedef struct {
 	char *str;
 } warc_strbuf_t;
 
+/* the values of the header fields we use, from one pass over the header */
+typedef struct {
+	warc_string_t typ;
+	warc_string_t uri;
+	warc_string_t len;
+	warc_string_t rtm;
+	warc_string_t mtm;
+} warc_hdr_t;
+
 struct warc_s {
 	/* content length ahead */
 	size_t cntlen;
@@ -127,13 +137,13 @@ static int _warc_rdhdr(struct archive_read *a, struct archive_entry *e);
 
 /* private routines */
 static unsigned int _warc_rdver(const char *buf, size_t bsz);
-static unsigned int _warc_rdtyp(const char *buf, size_t bsz);
-static warc_string_t _warc_rduri(const char *buf, size_t bsz);
-static ssize_t _warc_rdlen(const char *buf, size_t bsz);
-static time_t _warc_rdrtm(const char *buf, size_t bsz);
-static time_t _warc_rdmtm(const char *buf, size_t bsz);
-static const char *_warc_find_eoh(const char *buf, size_t bsz);
-static const char *_warc_find_eol(const char *buf, size_t bsz);
+static int _warc_namecmp(const char *s, const char *name, size_t len);
+static const char *_warc_tokenize(const char *buf, size_t bsz,
+    warc_hdr_t *hdr);
+static unsigned int _warc_rdtyp(warc_string_t val);
+static warc_string_t _warc_rduri(warc_string_t val);
+static ssize_t _warc_rdlen(warc_string_t val);
+static time_t _warc_rdtm(warc_string_t val);
 
 int
 archive_read_support_format_warc(struct archive *_a)
@@ -210,11 +220,15 @@ static int
 _warc_rdhdr(struct archive_read *a, struct archive_entry *entry)
 {
 #define HDR_PROBE_LEN		(12U)
+#define HDR_MAX_LEN		(1024U * 1024U)
 	struct warc_s *w = a->format->data;
 	unsigned int ver;
 	const char *buf;
 	ssize_t nrd;
+	size_t want;
 	const char *eoh;
+	/* the header's fields */
+	warc_hdr_t hdr;
 	char *tmp;
 	/* for the file name, saves some strndup()'ing */
 	warc_string_t fnam;
@@ -230,30 +244,50 @@ _warc_rdhdr(struct archive_read *a, struct archive_entry *entry)
 start_over:
 	/* just use read_ahead() they keep track of unconsumed
 	 * bits and bobs for us; no need to put an extra shift in
-	 * and reproduce that functionality here */
-	buf = __archive_read_ahead(a, HDR_PROBE_LEN, &nrd);
-
-	if (nrd < 0) {
-		/* no good */
-		archive_set_error(
-			&a->archive, ARCHIVE_ERRNO_MISC,
-			"Bad record header");
-		return (ARCHIVE_FATAL);
-	} else if (buf == NULL) {
-		/* there should be room for at least WARC/bla\r\n
-		 * must be EOF therefore */
-		return (ARCHIVE_EOF);
-	}
- 	/* looks good so far, try and find the end of the header now */
-	eoh = _warc_find_eoh(buf, nrd);
-	if (eoh == NULL) {
-		/* still no good, the header end might be beyond the
-		 * probe we've requested, but then again who'd cram
-		 * so much stuff into the header *and* be 28500-compliant */
-		archive_set_error(
-			&a->archive, ARCHIVE_ERRNO_MISC,
-			"Bad record header");
-		return (ARCHIVE_FATAL);
+	 * and reproduce that functionality here; a header that runs
+	 * past what is buffered is asked for again, twice as long */
+	for (want = HDR_PROBE_LEN;; want *= 2U) {
+		buf = __archive_read_ahead(a, want, &nrd);
+
+		if (nrd < 0) {
+			/* no good */
+			archive_set_error(
+				&a->archive, ARCHIVE_ERRNO_MISC,
+				"Bad record header");
+			return (ARCHIVE_FATAL);
+		} else if (buf == NULL && want == HDR_PROBE_LEN) {
+			/* there should be room for at least WARC/bla\r\n
+			 * must be EOF therefore */
+			return (ARCHIVE_EOF);
+		} else if (buf == NULL) {
+			/* the archive ends inside the header */
+			archive_set_error(
+				&a->archive, ARCHIVE_ERRNO_MISC,
+				"Truncated record header");
+			return (ARCHIVE_FATAL);
+		}
+		/* looks good so far, try and find the end of the header
+		 * and its fields, in one pass */
+		eoh = _warc_tokenize(buf, nrd, &hdr);
+		if (eoh != NULL) {
+			break;
+		}
+		if ((size_t)nrd >= HDR_MAX_LEN) {
+			/* still no good, who'd cram so much stuff into
+			 * the header *and* be 28500-compliant */
+			archive_set_error(
+				&a->archive, ARCHIVE_ERRNO_MISC,
+				"Bad record header");
+			return (ARCHIVE_FATAL);
+		}
+		if (want < (size_t)nrd) {
+			want = (size_t)nrd;
+		}
+		if (__archive_read_check_limit(a,
+		    ARCHIVE_READ_LIMIT_HEADER_BYTES,
+		    (int64_t)want * 2, "WARC record header") != ARCHIVE_OK) {
+			return (ARCHIVE_FATAL);
+		}
 	}
 	ver = _warc_rdver(buf, eoh - buf);
 	/* we currently support WARC 0.12 to 1.0 */
@@ -269,7 +303,7 @@ start_over:
 			ver / 10000, (ver % 10000) / 100);
 		return (ARCHIVE_FATAL);
 	}
-	cntlen = _warc_rdlen(buf, eoh - buf);
+	cntlen = _warc_rdlen(hdr.len);
 	if (cntlen < 0) {
 		/* nightmare!  the specs say content-length is mandatory
 		 * so I don't feel overly bad stopping the reader here */
@@ -278,7 +312,7 @@ start_over:
 			"Bad content length");
 		return (ARCHIVE_FATAL);
 	}
-	rtime = _warc_rdrtm(buf, eoh - buf);
+	rtime = _warc_rdtm(hdr.rtm);
 	if (rtime == (time_t)-1) {
 		/* record time is mandatory as per WARC/1.0,
 		 * so just barf here, fast and loud */
@@ -298,7 +332,7 @@ start_over:
 		w->pver = ver;
 	}
 	/* start off with the type */
-	ftyp = _warc_rdtyp(buf, eoh - buf);
+	ftyp = _warc_rdtyp(hdr.typ);
 	/* and let future calls know about the content */
 	w->cntlen = cntlen;
 	w->cntoff = 0U;
@@ -309,7 +343,7 @@ start_over:
 	case WT_RSP:
 		/* only try and read the filename in the cases that are
 		 * guaranteed to have one */
-		fnam = _warc_rduri(buf, eoh - buf);
+		fnam = _warc_rduri(hdr.uri);
 		/* check the last character in the URI to avoid creating
 		 * directory endpoints as files, see Todo above */
 		if (fnam.len == 0 || fnam.str[fnam.len - 1] == '/') {
@@ -340,7 +374,7 @@ start_over:
 		 * this is a custom header added by our writer, it's quite
 		 * hard to believe anyone else would go through with it
 		 * (apart from being part of some http responses of course) */
-		if ((mtime = _warc_rdmtm(buf, eoh - buf)) == (time_t)-1) {
+		if ((mtime = _warc_rdtm(hdr.mtm)) == (time_t)-1) {
 			mtime = rtime;
 		}
 		break;
@@ -658,81 +692,142 @@ _warc_rdver(const char *buf, size_t bsz)
 	return ver;
 }
 
-static unsigned int
-_warc_rdtyp(const char *buf, size_t bsz)
+/* compare a field name, ignoring the case of ASCII letters */
+static int
+_warc_namecmp(const char *s, const char *name, size_t len)
 {
-	static const char _key[] = "\r\nWARC-Type:";
-	const char *val, *eol;
+	size_t i;
 
-	if ((val = xmemmem(buf, bsz, _key, sizeof(_key) - 1U)) == NULL) {
-		/* no bother */
-		return WT_NONE;
+	for (i = 0U; i < len; i++) {
+		if ((s[i] | 0x20) != (name[i] | 0x20) ||
+		    ((s[i] ^ name[i]) != 0 && !isalpha((unsigned char)s[i]))) {
+			return 1;
+		}
 	}
-	val += sizeof(_key) - 1U;
-	if ((eol = _warc_find_eol(val, buf + bsz - val)) == NULL) {
-		/* no end of line */
-		return WT_NONE;
+	return 0;
+}
+
+/*
+ * Walk the header once, line by line, up to the empty line that ends
+ * it, and note where the values of the fields we use are.  Field
+ * names are case-insensitive, values lose their leading whitespace
+ * and their CRLF.  Returns the first byte after the header, or NULL
+ * if the header doesn't end within buf.
+ */
+static const char*
+_warc_tokenize(const char *buf, size_t bsz, warc_hdr_t *hdr)
+{
+	static const struct {
+		const char *name;
+		size_t len;
+		size_t off;
+	} fields[] = {
+		{ "WARC-Type", 9U, offsetof(warc_hdr_t, typ) },
+		{ "WARC-Target-URI", 15U, offsetof(warc_hdr_t, uri) },
+		{ "Content-Length", 14U, offsetof(warc_hdr_t, len) },
+		{ "WARC-Date", 9U, offsetof(warc_hdr_t, rtm) },
+		{ "Last-Modified", 13U, offsetof(warc_hdr_t, mtm) },
+	};
+	const char *const eob = buf + bsz;
+	const char *p, *eol, *col, *val;
+	warc_string_t *fld;
+	size_t i;
+
+	memset(hdr, 0, sizeof(*hdr));
+
+	/* the version line, which _warc_rdver() checks */
+	if ((p = memchr(buf, '\n', bsz)) == NULL) {
+		return NULL;
 	}
 
-	/* overread whitespace */
-	while (val < eol && (*val == ' ' || *val == '\t'))
-		++val;
+	for (p++; p < eob; p = eol + 1U) {
+		if ((eol = memchr(p, '\n', eob - p)) == NULL) {
+			/* the header goes on past buf */
+			return NULL;
+		}
+		if (eol == p + 1U && *p == '\r') {
+			/* the empty line */
+			return eol + 1U;
+		}
+		if (eol == p || eol[-1] != '\r' || *p == ' ' || *p == '\t') {
+			/* not CRLF terminated, or a continuation line */
+			continue;
+		}
+		if ((col = memchr(p, ':', eol - p)) == NULL) {
+			continue;
+		}
+		for (i = 0U; i < sizeof(fields) / sizeof(fields[0]); i++) {
+			if ((size_t)(col - p) == fields[i].len &&
+			    _warc_namecmp(p, fields[i].name, fields[i].len) == 0) {
+				break;
+			}
+		}
+		if (i == sizeof(fields) / sizeof(fields[0])) {
+			continue;
+		}
+		fld = (warc_string_t *)((char *)hdr + fields[i].off);
+		if (fld->str != NULL) {
+			/* the first occurrence wins */
+			continue;
+		}
+		/* overread whitespace */
+		for (val = col + 1U; val < eol - 1U &&
+		    (*val == ' ' || *val == '\t'); val++);
+		fld->str = val;
+		fld->len = (eol - 1U) - val;
+	}
+	return NULL;
+}
 
-	if (val + 8U == eol) {
-		if (memcmp(val, "resource", 8U) == 0)
+static unsigned int
+_warc_rdtyp(warc_string_t val)
+{
+	if (val.len == 8U) {
+		if (memcmp(val.str, "resource", 8U) == 0)
 			return WT_RSRC;
-		else if (memcmp(val, "response", 8U) == 0)
+		else if (memcmp(val.str, "response", 8U) == 0)
 			return WT_RSP;
 	}
 	return WT_NONE;
 }
 
 static warc_string_t
-_warc_rduri(const char *buf, size_t bsz)
+_warc_rduri(warc_string_t val)
 {
-	static const char _key[] = "\r\nWARC-Target-URI:";
-	const char *val, *uri, *eol, *p;
+	const char *uri, *eol, *p;
 	warc_string_t res = {0U, NULL};
 
-	if ((val = xmemmem(buf, bsz, _key, sizeof(_key) - 1U)) == NULL) {
+	if (val.str == NULL) {
 		/* no bother */
 		return res;
 	}
-	/* overread whitespace */
-	val += sizeof(_key) - 1U;
-	if ((eol = _warc_find_eol(val, buf + bsz - val)) == NULL) {
-		/* no end of line */
-		return res;
-	}
-
-	while (val < eol && (*val == ' ' || *val == '\t'))
-		++val;
+	eol = val.str + val.len;
 
 	/* overread URL designators */
-	if ((uri = xmemmem(val, eol - val, "://", 3U)) == NULL) {
+	if ((uri = xmemmem(val.str, val.len, "://", 3U)) == NULL) {
 		/* not touching that! */
 		return res;
 	}
 
 	/* spaces inside uri are not allowed, CRLF should follow */
-	for (p = val; p < eol; p++) {
+	for (p = val.str; p < eol; p++) {
 		if (isspace((unsigned char)*p))
 			return res;
 	}
 
 	/* there must be at least space for ftp */
-	if (uri < (val + 3U))
+	if (uri < (val.str + 3U))
 		return res;
 
 	/* move uri to point to after :// */
 	uri += 3U;
 
 	/* now then, inspect the URI */
-	if (memcmp(val, "file", 4U) == 0) {
+	if (memcmp(val.str, "file", 4U) == 0) {
 		/* perfect, nothing left to do here */
 
-	} else if (memcmp(val, "http", 4U) == 0 ||
-		   memcmp(val, "ftp", 3U) == 0) {
+	} else if (memcmp(val.str, "http", 4U) == 0 ||
+		   memcmp(val.str, "ftp", 3U) == 0) {
 		/* overread domain, and the first / */
 		while (uri < eol && *uri++ != '/');
 	} else {
@@ -745,111 +840,43 @@ _warc_rduri(const char *buf, size_t bsz)
 }
 
 static ssize_t
-_warc_rdlen(const char *buf, size_t bsz)
+_warc_rdlen(warc_string_t val)
 {
-	static const char _key[] = "\r\nContent-Length:";
-	const char *val, *eol;
-	char *on = NULL;
-	long int len;
-
-	if ((val = xmemmem(buf, bsz, _key, sizeof(_key) - 1U)) == NULL) {
-		/* no bother */
-		return -1;
-	}
-	val += sizeof(_key) - 1U;
-	if ((eol = _warc_find_eol(val, buf + bsz - val)) == NULL) {
-		/* no end of line */
-		return -1;
-	}
-
-	/* skip leading whitespace */
-	while (val < eol && (*val == ' ' || *val == '\t'))
-		val++;
-	/* there must be at least one digit */
-	if (!isdigit((unsigned char)*val))
-		return -1;
-	errno = 0;
-	len = strtol(val, &on, 10);
-	if (errno != 0 || on != eol) {
-		/* line must end here */
-		return -1;
-	}
-
-	return (size_t)len;
-}
-
-static time_t
-_warc_rdrtm(const char *buf, size_t bsz)
-{
-	static const char _key[] = "\r\nWARC-Date:";
-	const char *val, *eol;
-	char *on = NULL;
-	time_t res;
+	size_t len = 0U;
+	size_t i;
 
-	if ((val = xmemmem(buf, bsz, _key, sizeof(_key) - 1U)) == NULL) {
-		/* no bother */
-		return (time_t)-1;
-	}
-	val += sizeof(_key) - 1U;
-	if ((eol = _warc_find_eol(val, buf + bsz - val)) == NULL ) {
-		/* no end of line */
+	/* there must be at least one digit, and the line must end
+	 * with them */
+	if (val.str == NULL || val.len == 0U) {
 		return -1;
 	}
-
-	/* xstrpisotime() kindly overreads whitespace for us, so use that */
-	res = xstrpisotime(val, &on);
-	if (on != eol) {
-		/* line must end here */
-		return -1;
+	for (i = 0U; i < val.len; i++) {
+		if (!isdigit((unsigned char)val.str[i]) ||
+		    len > ((size_t)SSIZE_MAX - 9U) / 10U) {
+			return -1;
+		}
+		len = len * 10U + (size_t)(val.str[i] - '0');
 	}
-	return res;
+	return (ssize_t)len;
 }
 
 static time_t
-_warc_rdmtm(const char *buf, size_t bsz)
+_warc_rdtm(warc_string_t val)
 {
-	static const char _key[] = "\r\nLast-Modified:";
-	const char *val, *eol;
 	char *on = NULL;
 	time_t res;
 
-	if ((val = xmemmem(buf, bsz, _key, sizeof(_key) - 1U)) == NULL) {
+	if (val.str == NULL) {
 		/* no bother */
 		return (time_t)-1;
 	}
-	val += sizeof(_key) - 1U;
-	if ((eol = _warc_find_eol(val, buf + bsz - val)) == NULL ) {
-		/* no end of line */
-		return -1;
-	}
 
-	/* xstrpisotime() kindly overreads whitespace for us, so use that */
-	res = xstrpisotime(val, &on);
-	if (on != eol) {
+	/* the line ends with \r, so xstrpisotime() stops at the end */
+	res = xstrpisotime(val.str, &on);
+	if (on != val.str + val.len) {
 		/* line must end here */
 		return -1;
 	}
 	return res;
 }
-
-static const char*
-_warc_find_eoh(const char *buf, size_t bsz)
-{
-	static const char _marker[] = "\r\n\r\n";
-	const char *hit = xmemmem(buf, bsz, _marker, sizeof(_marker) - 1U);
-
-	if (hit != NULL) {
-		hit += sizeof(_marker) - 1U;
-	}
-	return hit;
-}
-
-static const char*
-_warc_find_eol(const char *buf, size_t bsz)
-{
-	static const char _marker[] = "\r\n";
-	const char *hit = xmemmem(buf, bsz, _marker, sizeof(_marker) - 1U);
-
-	return hit;
-}
 /* archive_read_support_format_warc.c ends here */
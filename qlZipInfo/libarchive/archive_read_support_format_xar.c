@@ -149,6 +149,8 @@ struct xar_file {
 	struct xar_file		*hdnext;
 	struct xar_file		*parent;
 	int			 subdirs;
+	int			 depth;
+	int64_t			 charged;	/* against the memory limit */
 
 	unsigned int		 has;
 #define HAS_DATA		0x00001
@@ -404,7 +406,7 @@ static int	decompression_cleanup(struct archive_read *);
 static void	xmlattr_cleanup(struct xmlattr_list *);
 static int	file_new(struct archive_read *,
     struct xar *, struct xmlattr_list *);
-static void	file_free(struct xar_file *);
+static void	file_free(struct archive_read *, struct xar_file *);
 static int	xattr_new(struct archive_read *,
     struct xar *, struct xmlattr_list *);
 static void	xattr_free(struct xattr *);
@@ -702,7 +704,7 @@ xar_read_header(struct archive_read *a, struct archive_entry *entry)
 		 * If a file type is a directory and it does not have
 		 * any metadata, do not export.
 		 */
-		file_free(file);
+		file_free(a, file);
 	}
         if (file->has & HAS_ATIME) {
           archive_entry_set_atime(entry, file->atime, 0);
@@ -846,7 +848,7 @@ xar_read_header(struct archive_read *a, struct archive_entry *entry)
 		xattr = xattr->next;
 	}
 	if (r != ARCHIVE_OK) {
-		file_free(file);
+		file_free(a, file);
 		return (r);
 	}
 
@@ -857,7 +859,7 @@ xar_read_header(struct archive_read *a, struct archive_entry *entry)
 	else
 		r = ARCHIVE_OK;
 
-	file_free(file);
+	file_free(a, file);
 	return (r);
 }
 
@@ -962,7 +964,7 @@ xar_cleanup(struct archive_read *a)
 		hdlink = next;
 	}
 	for (i = 0; i < xar->file_queue.used; i++)
-		file_free(xar->file_queue.files[i]);
+		file_free(a, xar->file_queue.files[i]);
 	free(xar->file_queue.files);
 	while (xar->unknowntags != NULL) {
 		struct unknown_tag *tag;
@@ -1790,13 +1792,27 @@ file_new(struct archive_read *a, struct xar *xar, struct xmlattr_list *list)
 {
 	struct xar_file *file;
 	struct xmlattr *attr;
+	int64_t charged;
+	int depth;
+
+	/* Each nested <file> copies its parent's path, so deep
+	 * nesting is quadratic in the TOC size. */
+	depth = (xar->file != NULL) ? xar->file->depth + 1 : 1;
+	charged = sizeof(*file) +
+	    ((xar->file != NULL) ? archive_strlen(&xar->file->pathname) : 0);
+	if (__archive_read_check_limit(a, ARCHIVE_READ_LIMIT_DEPTH,
+	    depth, "xar TOC <file> nesting") != ARCHIVE_OK ||
+	    __archive_read_charge_memory(a, charged, "xar TOC") != ARCHIVE_OK)
+		return (ARCHIVE_FATAL);
 
 	file = calloc(1, sizeof(*file));
 	if (file == NULL) {
 		archive_set_error(&a->archive, ENOMEM, "Out of memory");
 		return (ARCHIVE_FATAL);
 	}
+	file->charged = charged;
 	file->parent = xar->file;
+	file->depth = depth;
 	file->mode = 0777 | AE_IFREG;
 	file->atime =  0;
 	file->mtime = 0;
@@ -1813,10 +1829,11 @@ file_new(struct archive_read *a, struct xar *xar, struct xmlattr_list *list)
 }
 
 static void
-file_free(struct xar_file *file)
+file_free(struct archive_read *a, struct xar_file *file)
 {
 	struct xattr *xattr;
 
+	__archive_read_release_memory(a, file->charged);
 	archive_string_free(&(file->pathname));
 	archive_string_free(&(file->symlink));
 	archive_string_free(&(file->uname));
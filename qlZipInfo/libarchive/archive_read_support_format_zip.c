@@ -1296,6 +1296,19 @@ zip_read_local_file_header(struct archive_read *a, struct archive_entry *entry,
 	    && zip->entry_bytes_remaining < 1)
 		zip->end_of_entry = 1;
 
+	/*
+	 * The data of a stored, unencrypted entry whose length is
+	 * known is a copy of the file, so it can be copied straight
+	 * from the input.  That bypasses the CRC32 check, so only
+	 * do this when the "ignorecrc32" option is set.
+	 */
+	if (zip->ignore_crc32 && zip_entry->compression == 0
+	    && 0 == (zip_entry->zip_flags
+		& (ZIP_ENCRYPTED | ZIP_STRONG_ENCRYPTED | ZIP_LENGTH_AT_END))
+	    && archive_entry_filetype(entry) == AE_IFREG
+	    && zip->entry_bytes_remaining > 0)
+		__archive_read_set_stored(a, zip->entry_bytes_remaining);
+
 	/* Set up a more descriptive format name. */
         archive_string_empty(&zip->format_name);
 	archive_string_sprintf(&zip->format_name, "ZIP %d.%d (%s)",
@@ -3967,6 +3980,14 @@ slurp_central_directory(struct archive_read *a, struct archive_entry* entry,
 		if ((p = __archive_read_ahead(a, 46, NULL)) == NULL)
 			return ARCHIVE_FATAL;
 
+		if (__archive_read_check_limit(a, ARCHIVE_READ_LIMIT_ENTRIES,
+		    zip->central_directory_entries_total + 1,
+		    "Central directory") != ARCHIVE_OK ||
+		    __archive_read_charge_memory(a, sizeof(struct zip_entry)
+		    + archive_le16dec(p + 28), "Central directory")
+		    != ARCHIVE_OK)
+			return ARCHIVE_FATAL;
+
 		zip_entry = calloc(1, sizeof(struct zip_entry));
 		if (zip_entry == NULL) {
 			archive_set_error(&a->archive, ENOMEM,
@@ -314,6 +314,8 @@ archive_string_ensure(struct archive_string *as, size_t s)
 		new_length = s;
 	/* Now we can reallocate the buffer. */
 	p = realloc(as->s, new_length);
+	if (__archive_trace != NULL)
+		__archive_trace->count(ARCHIVE_TRACE_ALLOCATIONS, 1);
 	if (p == NULL) {
 		/* On failure, wipe the string and return NULL. */
 		archive_string_free(as);
@@ -79,6 +79,8 @@
 
 static int archive_utility_string_sort_helper(char **, unsigned int);
 
+__thread const struct archive_trace *__archive_trace = NULL;
+
 /* Generic initialization of 'struct archive' objects. */
 int
 __archive_clean(struct archive *a)
@@ -87,6 +89,13 @@ __archive_clean(struct archive *a)
 	return (ARCHIVE_OK);
 }
 
+/* Set (or, with NULL, clear) the calling thread's trace hooks. */
+void
+archive_set_trace(const struct archive_trace *trace)
+{
+	__archive_trace = trace;
+}
+
 int
 archive_version_number(void)
 {
@@ -0,0 +1,454 @@
+/*
+    nested.c - list archives that are stored inside other archives
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    libarchive - archive_read_open2(3), custom read callbacks
+    https://github.com/libarchive/libarchive/wiki/Examples
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <time.h>
+
+#include "nested.h"
+
+/* globals */
+
+/* file extensions of the archives that are listed */
+
+static const char *gNestedExtensions[] =
+{
+    ".zip", ".jar", ".war", ".ear", ".apk", ".ipa", ".xpi",
+    ".tar", ".tgz", ".taz", ".tbz", ".tbz2", ".txz",
+    ".tar.gz", ".tar.bz2", ".tar.xz", ".tar.z",
+    ".7z", ".rar", ".xar", ".pkg", ".iso", ".cab",
+    ".lha", ".lzh", ".a", ".ar", ".deb", ".rpm", ".cpio",
+    ".warc", ".warc.gz", ".mtree",
+    NULL
+};
+
+/* magic numbers of the archives and filters that are listed */
+
+typedef struct nestedMagic
+{
+    size_t offset;
+    size_t len;
+    const char *magic;
+} nestedMagic_t;
+
+static const nestedMagic_t gNestedMagics[] =
+{
+    {   0, 4, "PK\003\004"                  },  /* zip            */
+    {   0, 2, "\037\213"                    },  /* gzip           */
+    {   0, 2, "\037\235"                    },  /* compress       */
+    {   0, 3, "BZh"                         },  /* bzip2          */
+    {   0, 6, "\3757zXZ\000"                },  /* xz             */
+    {   0, 6, "7z\274\257\047\034"          },  /* 7zip           */
+    {   0, 6, "Rar!\032\007"                },  /* rar, rar5      */
+    {   0, 4, "xar!"                        },  /* xar            */
+    {   0, 4, "pbzx"                        },  /* pbzx payload   */
+    {   0, 8, "!<arch>\n"                   },  /* ar, deb        */
+    {   0, 4, "MSCF"                        },  /* cab            */
+    {   0, 4, "\355\253\356\333"            },  /* rpm            */
+    {   0, 6, "070707"                      },  /* odc cpio       */
+    {   0, 6, "070701"                      },  /* newc cpio      */
+    {   0, 6, "070702"                      },  /* newc crc cpio  */
+    {   2, 3, "-lh"                         },  /* lha            */
+    {   0, 5, "WARC/"                       },  /* warc           */
+    {   0, 6, "#mtree"                      },  /* mtree          */
+    { 257, 5, "ustar"                       },  /* tar            */
+    {   0, 0, NULL                          },
+};
+
+/* magic number of a package's payload, which has no size limit */
+
+static const nestedMagic_t gNestedPayloadMagic =
+    {   0, 4, "pbzx"                        };
+
+/* private functions */
+
+static int nestedIsPayloadMagic(const unsigned char *buf, size_t len);
+static la_ssize_t nestedRead(struct archive *a,
+                             void *clientData,
+                             const void **buf);
+
+/* nestedNow - get the current monotonic time in nanoseconds */
+
+static uint64_t nestedNow(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+    {
+        return 0;
+    }
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*
+    nestedIsPayloadMagic - returns 1 if buf has the magic number of a
+                           package's payload
+*/
+
+static int nestedIsPayloadMagic(const unsigned char *buf, size_t len)
+{
+    return (len >= gNestedPayloadMagic.offset + gNestedPayloadMagic.len &&
+            memcmp(buf + gNestedPayloadMagic.offset,
+                   gNestedPayloadMagic.magic,
+                   gNestedPayloadMagic.len) == 0 ? 1 : 0);
+}
+
+/*
+    nestedRead - archive_read_open2() read callback for the child,
+                 returns the bytes read by nestedOpen() first, and
+                 then the rest of the entry from the parent
+*/
+
+static la_ssize_t nestedRead(struct archive *a,
+                             void *clientData,
+                             const void **buf)
+{
+    nestedArchive_t *nested = (nestedArchive_t *)clientData;
+    la_ssize_t bytesRead = 0;
+
+    if (nested == NULL || nested->buf == NULL)
+    {
+        return -1;
+    }
+
+    *buf = nested->buf;
+
+    if (nested->bufLen > 0)
+    {
+        bytesRead = (la_ssize_t)nested->bufLen;
+        nested->bufLen = 0;
+        return bytesRead;
+    }
+
+    if (nestedIsExpired(nested->deadline))
+    {
+        archive_set_error(a,
+                          ETIMEDOUT,
+                          "Nested archive exceeds the time limit");
+        return -1;
+    }
+
+    bytesRead = archive_read_data(nested->parent,
+                                  nested->buf,
+                                  NESTEDBUFSIZE);
+    if (bytesRead < 0)
+    {
+        archive_set_error(a,
+                          archive_errno(nested->parent),
+                          "%s",
+                          (archive_error_string(nested->parent) != NULL ?
+                           archive_error_string(nested->parent) :
+                           "Cannot read the nested archive"));
+        return -1;
+    }
+
+    nested->bytesRead += bytesRead;
+    if (nested->maxBytes > 0 && nested->bytesRead > nested->maxBytes)
+    {
+        archive_set_error(a,
+                          EFBIG,
+                          "Nested archive exceeds the size limit of %jd",
+                          (intmax_t)nested->maxBytes);
+        return -1;
+    }
+
+    return bytesRead;
+}
+
+/* public functions */
+
+/*
+    nestedDeadline - get the deadline for nested archives that are
+                     read from now on, 0 (no deadline) if seconds
+                     is 0
+*/
+
+uint64_t nestedDeadline(unsigned int seconds)
+{
+    if (seconds == 0)
+    {
+        return 0;
+    }
+
+    return nestedNow() + (uint64_t)seconds * 1000000000ULL;
+}
+
+/* nestedIsExpired - returns 1 if the deadline has passed */
+
+int nestedIsExpired(uint64_t deadline)
+{
+    return (deadline != 0 && nestedNow() >= deadline ? 1 : 0);
+}
+
+/*
+    nestedHasExtension - returns 1 if the last component of name has a
+                         file extension
+*/
+
+int nestedHasExtension(const char *name)
+{
+    const char *base = NULL;
+    const char *ext = NULL;
+
+    if (name == NULL)
+    {
+        return 0;
+    }
+
+    base = strrchr(name, '/');
+    base = (base == NULL ? name : base + 1);
+    ext = strrchr(base, '.');
+
+    return (ext != NULL && ext != base && ext[1] != '\0' ? 1 : 0);
+}
+
+/*
+    nestedIsArchiveName - returns 1 if name ends with an archive's
+                          file extension
+*/
+
+int nestedIsArchiveName(const char *name)
+{
+    size_t nameLen = 0;
+    size_t extLen = 0;
+    int i = 0;
+
+    if (name == NULL)
+    {
+        return 0;
+    }
+
+    nameLen = strlen(name);
+
+    for (i = 0; gNestedExtensions[i] != NULL; i++)
+    {
+        extLen = strlen(gNestedExtensions[i]);
+        if (nameLen > extLen &&
+            strcasecmp(name + nameLen - extLen, gNestedExtensions[i]) == 0)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+    nestedIsArchiveMagic - returns 1 if buf has the magic number of an
+                           archive or a compressed file
+*/
+
+int nestedIsArchiveMagic(const unsigned char *buf, size_t len)
+{
+    int i = 0;
+
+    if (buf == NULL)
+    {
+        return 0;
+    }
+
+    for (i = 0; gNestedMagics[i].magic != NULL; i++)
+    {
+        if (len >= gNestedMagics[i].offset + gNestedMagics[i].len &&
+            memcmp(buf + gNestedMagics[i].offset,
+                   gNestedMagics[i].magic,
+                   gNestedMagics[i].len) == 0)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+    nestedCheck - check whether the parent's current entry is an
+                  archive; returns gNestedOkay if it is, in which case
+                  the start of the entry has been read, and
+                  gNestedNotArchive if it is not.  nestedClose() must
+                  be called in all cases.
+*/
+
+int nestedCheck(nestedArchive_t *nested,
+                struct archive *parent,
+                struct archive_entry *entry,
+                nestedLimits_t *limits)
+{
+    const char *name = NULL;
+    int isArchiveName = 0;
+    int isTooBig = 0;
+    la_ssize_t bytesRead = 0;
+
+    if (nested == NULL)
+    {
+        return gNestedErr;
+    }
+
+    memset(nested, 0, sizeof(nestedArchive_t));
+
+    if (parent == NULL || entry == NULL || limits == NULL)
+    {
+        return gNestedErr;
+    }
+
+    isTooBig = (limits->maxBytes > 0 &&
+                archive_entry_size_is_set(entry) &&
+                archive_entry_size(entry) > limits->maxBytes);
+
+    /* only check the magic number of entries without an extension */
+
+    name = archive_entry_pathname(entry);
+    isArchiveName = nestedIsArchiveName(name);
+    if (isArchiveName == 1 && isTooBig == 1)
+    {
+        return gNestedNotArchive;
+    }
+    if (isArchiveName == 0)
+    {
+        if (nestedHasExtension(name) == 1 || limits->magicChecks == 0)
+        {
+            return gNestedNotArchive;
+        }
+        limits->magicChecks--;
+    }
+
+    nested->parent = parent;
+    nested->maxBytes = limits->maxBytes;
+    nested->deadline = limits->deadline;
+
+    nested->buf = malloc(NESTEDBUFSIZE);
+    if (nested->buf == NULL)
+    {
+        return gNestedErr;
+    }
+
+    /* read enough of the entry to check its magic number */
+
+    while (nested->bufLen < NESTEDSNIFFLEN)
+    {
+        bytesRead = archive_read_data(parent,
+                                      nested->buf + nested->bufLen,
+                                      NESTEDSNIFFLEN - nested->bufLen);
+        if (bytesRead < 0)
+        {
+            return gNestedErr;
+        }
+        if (bytesRead == 0)
+        {
+            break;
+        }
+        nested->bufLen += (size_t)bytesRead;
+    }
+
+    nested->bytesRead = (int64_t)nested->bufLen;
+
+    if (nested->bufLen == 0 ||
+        (isArchiveName == 0 &&
+         nestedIsArchiveMagic(nested->buf, nested->bufLen) == 0))
+    {
+        return gNestedNotArchive;
+    }
+
+    /* a package's payload is only limited by the deadline */
+
+    if (nestedIsPayloadMagic(nested->buf, nested->bufLen) == 1)
+    {
+        nested->maxBytes = 0;
+    }
+    else if (isTooBig == 1)
+    {
+        return gNestedNotArchive;
+    }
+
+    return gNestedOkay;
+}
+
+/*
+    nestedOpen - open the child archive over the rest of the entry
+                 accepted by nestedCheck(); the child must have its
+                 formats and filters set, and is closed, but not
+                 freed, by nestedClose()
+*/
+
+int nestedOpen(nestedArchive_t *nested, struct archive *child)
+{
+    if (nested == NULL || nested->buf == NULL || child == NULL)
+    {
+        return gNestedErr;
+    }
+
+    if (archive_read_open2(child,
+                           nested,
+                           NULL,
+                           nestedRead,
+                           NULL,
+                           NULL) != ARCHIVE_OK)
+    {
+        return gNestedErr;
+    }
+
+    nested->child = child;
+
+    return gNestedOkay;
+}
+
+/* nestedClose - close the child archive, if it was opened */
+
+int nestedClose(nestedArchive_t *nested)
+{
+    if (nested == NULL)
+    {
+        return gNestedErr;
+    }
+
+    if (nested->child != NULL)
+    {
+        archive_read_close(nested->child);
+        nested->child = NULL;
+    }
+
+    if (nested->buf != NULL)
+    {
+        free(nested->buf);
+        nested->buf = NULL;
+    }
+
+    nested->bufLen = 0;
+
+    return gNestedOkay;
+}
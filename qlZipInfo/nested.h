@@ -0,0 +1,121 @@
+/*
+    nested.h - list archives that are stored inside other archives
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    A nested archive (a jar in a zip, the data.tar.xz in a .deb, etc.)
+    is read by a child struct archive whose read callback pulls the
+    container entry's data from the parent with archive_read_data(),
+    so the nested archive is never written to a temporary file and
+    only one block of it is in memory at a time.  Since the child is
+    just another struct archive, its entries can contain archives
+    too, which are opened in the same way.
+
+    nestedCheck() only accepts an entry if the entry's name has an
+    archive's extension or, for a name without an extension (such as
+    a package's Payload), if the first NESTEDSNIFFLEN bytes of the
+    entry have an archive's magic number.  Reading the start of an
+    entry can cost as much as listing it, so only the first
+    magicChecks entries without an extension are checked.
+
+    Each nested archive is limited to maxBytes of data from its
+    parent, and all of them must be read before the deadline (see
+    nestedDeadline()), after which the child's reads fail.  The
+    caller limits the depth.
+
+    The payload of an .xip or a flat package (a pbzx stream around
+    a cpio archive) is often many times maxBytes, and is where the
+    package's files are listed, so it is only limited by the
+    deadline.  The pbzx filter decodes its chunks on all of the
+    processors, so the most is listed before the deadline.
+*/
+
+#ifndef qlZipInfo_nested_h
+#define qlZipInfo_nested_h
+
+#include <stdint.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+
+/* return codes */
+
+enum
+{
+    gNestedErr        = -1,
+    gNestedOkay       =  0,
+    gNestedNotArchive =  1,
+};
+
+/* number of bytes read to check for an archive's magic number */
+
+#define NESTEDSNIFFLEN 512
+
+/* size of the buffer used to pass data from the parent to the child */
+
+#define NESTEDBUFSIZE  65536
+
+/* structures */
+
+/* limits shared by all of the nested archives in a listing */
+
+typedef struct nestedLimits
+{
+    int64_t maxBytes;
+    uint64_t deadline;
+    unsigned int magicChecks;
+} nestedLimits_t;
+
+/* nested archive handle */
+
+typedef struct nestedArchive
+{
+    struct archive *parent;
+    struct archive *child;
+    unsigned char *buf;
+    size_t bufLen;
+    int64_t bytesRead;
+    int64_t maxBytes;
+    uint64_t deadline;
+} nestedArchive_t;
+
+/* prototypes */
+
+uint64_t nestedDeadline(unsigned int seconds);
+int nestedIsExpired(uint64_t deadline);
+int nestedHasExtension(const char *name);
+int nestedIsArchiveName(const char *name);
+int nestedIsArchiveMagic(const unsigned char *buf, size_t len);
+int nestedCheck(nestedArchive_t *nested,
+                struct archive *parent,
+                struct archive_entry *entry,
+                nestedLimits_t *limits);
+int nestedOpen(nestedArchive_t *nested, struct archive *child);
+int nestedClose(nestedArchive_t *nested);
+
+#endif /* qlZipInfo_nested_h */
@@ -0,0 +1,2249 @@
+/*
+    peek.c - read one entry of an archive through its directory
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <zlib.h>
+#include <bzlib.h>
+#include <lzma.h>
+
+#include "archdir.h"
+#include "peek.h"
+
+/* zip flags, and the header of an LZMA entry's data */
+
+#define ZIPFLAGENCRYPTED 0x0001
+#define ZIPLZMAHEADERLEN 4
+#define ZIPLZMAPROPSLEN  5
+
+/* zip methods */
+
+enum
+{
+    gZipMethodStored  = 0,
+    gZipMethodDeflate = 8,
+    gZipMethodBzip2   = 12,
+    gZipMethodLZMA    = 14,
+};
+
+/* 7z FilesInfo property ids */
+
+enum
+{
+    gSzEnd                = 0x00,
+    gSzEmptyStream        = 0x0E,
+    gSzEmptyFile          = 0x0F,
+    gSzName               = 0x11,
+};
+
+/* xar header */
+
+#define XARMAGIC         "xar!"
+#define XARHEADERLEN     28
+#define XARMAXDEPTH      256
+
+/* ISO9660 volume descriptors and directory records */
+
+#define ISO9660MAGIC      "CD001"
+#define ISO9660FIRSTVD    16
+#define ISO9660MAXVDS     64
+#define ISO9660SECTOR     2048
+#define ISO9660RECORDLEN  33
+#define ISO9660FLAGDIR    0x02
+#define ISO9660MAXNAME    1024
+#define ISO9660MAXDEPTH   256
+
+/* bytes read and decoded at a time */
+
+#define PEEKREADSIZE     65536
+
+/* the end of a hash chain */
+
+#define PEEKNOENTRY      0xFFFFFFFF
+
+/* an index being built */
+
+typedef struct peekBuild
+{
+    peek_t *peek;
+    uint32_t entriesAlloc;
+    size_t *nameOffsets;
+    size_t namesLen;
+    size_t namesAlloc;
+    size_t propsLen;
+    size_t propsAlloc;
+} peekBuild_t;
+
+/* a file of a xar table of contents */
+
+typedef struct peekXarFile
+{
+    int64_t parent;
+    size_t name;
+    size_t nameLen;
+    size_t path;
+    size_t pathLen;
+    uint64_t offset;
+    uint64_t length;
+    uint64_t size;
+    peekMethod_t method;
+    int isDir;
+    int hasName;
+    int hasData;
+} peekXarFile_t;
+
+/* elements of a xar table of contents that are looked at */
+
+typedef enum
+{
+    XarOther = 0,
+    XarFile,
+    XarName,
+    XarType,
+    XarData,
+    XarOffset,
+    XarLength,
+    XarSize,
+    XarEncoding,
+} peekXarElement_t;
+
+/* a decoder */
+
+typedef struct peekDecoder
+{
+    peekMethod_t method;
+    z_stream z;
+    bz_stream bz;
+    lzma_stream xz;
+    int started;
+} peekDecoder_t;
+
+/* format names */
+
+static const char *gPeekFormatNames[] =
+{
+    "ARCHIVE",
+    "ZIP",
+    "7Z",
+    "XAR",
+    "ISO",
+};
+
+/* private functions */
+
+static uint32_t peekHash(const char *name, size_t len);
+static void peekTrim(const char **name, size_t *len);
+static size_t peekPutUtf8(char *p, uint32_t c);
+static peekEntry_t *peekAddEntry(peekBuild_t *b,
+                                 const char *name,
+                                 size_t nameLen);
+static int peekAddProps(peekBuild_t *b,
+                        peekEntry_t *entry,
+                        const unsigned char *props,
+                        size_t propsLen);
+static int peekFinish(peekBuild_t *b);
+static int peekDecoderInit(peekDecoder_t *d,
+                           peekMethod_t method,
+                           const unsigned char *props,
+                           size_t propsLen);
+static int peekDecoderRun(peekDecoder_t *d,
+                          const unsigned char **in,
+                          size_t *inLen,
+                          int lastInput,
+                          unsigned char *out,
+                          size_t *outLen,
+                          int *finished);
+static void peekDecoderEnd(peekDecoder_t *d);
+static ssize_t peekDecode(peek_t *peek,
+                          peekMethod_t method,
+                          const unsigned char *props,
+                          size_t propsLen,
+                          uint64_t offset,
+                          uint64_t packedSize,
+                          uint64_t skip,
+                          unsigned char *buf,
+                          size_t maxLen);
+static int peekOpenZip(int fd, off_t fileSize, peekBuild_t *b);
+static peekMethod_t peek7zMethod(const archDir7zFolder_t *folder);
+static int peek7zFiles(archDir7z_t *s, peekBuild_t *b);
+static int peekOpen7Zip(int fd, off_t fileSize, peekBuild_t *b);
+static size_t peekXarText(char *text, size_t len);
+static peekXarElement_t peekXarGetElement(const char *tag, size_t len);
+static peekMethod_t peekXarMethod(const char *attrs, size_t len);
+static int peekXarParse(char *toc, uint64_t heap, peekBuild_t *b);
+static int peekOpenXar(int fd, off_t fileSize, peekBuild_t *b);
+static size_t peekISO9660Name(const unsigned char *record,
+                              int rockRidge,
+                              int joliet,
+                              char *name,
+                              int *skip,
+                              int *zisofs);
+static int peekISO9660Seen(uint64_t **seen,
+                           size_t *seenAlloc,
+                           size_t numSeen,
+                           uint64_t offset);
+static int peekOpenISO9660(int fd, off_t fileSize, peekBuild_t *b);
+static int peekOpenBuild(int fd, peek_t *peek);
+
+/* peekHash - FNV-1a hash of a path */
+
+static uint32_t peekHash(const char *name, size_t len)
+{
+    uint32_t hash = 2166136261U;
+    size_t i = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+/*
+    peekTrim - drop a path's leading "./" and "/", and its trailing
+               "/", so that paths match however they were stored
+*/
+
+static void peekTrim(const char **name, size_t *len)
+{
+    for (;;)
+    {
+        if (*len >= 2 && (*name)[0] == '.' && (*name)[1] == '/')
+        {
+            *name += 2;
+            *len -= 2;
+        }
+        else if (*len >= 1 && (*name)[0] == '/')
+        {
+            *name += 1;
+            *len -= 1;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    while (*len > 0 && (*name)[*len - 1] == '/')
+    {
+        (*len)--;
+    }
+}
+
+/* peekPutUtf8 - put a code point as UTF-8, returns its length */
+
+static size_t peekPutUtf8(char *p, uint32_t c)
+{
+    if (c < 0x80)
+    {
+        p[0] = (char)c;
+        return 1;
+    }
+    if (c < 0x800)
+    {
+        p[0] = (char)(0xC0 | (c >> 6));
+        p[1] = (char)(0x80 | (c & 0x3F));
+        return 2;
+    }
+    if (c < 0x10000)
+    {
+        p[0] = (char)(0xE0 | (c >> 12));
+        p[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+        p[2] = (char)(0x80 | (c & 0x3F));
+        return 3;
+    }
+
+    p[0] = (char)(0xF0 | (c >> 18));
+    p[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+    p[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+    p[3] = (char)(0x80 | (c & 0x3F));
+    return 4;
+}
+
+/*
+    peekAddEntry - add an entry with the given path to the index,
+                   returns the entry, which is zeroed, or NULL if the
+                   path is empty or the index is full
+*/
+
+static peekEntry_t *peekAddEntry(peekBuild_t *b,
+                                 const char *name,
+                                 size_t nameLen)
+{
+    peek_t *peek = b->peek;
+    peekEntry_t *entries = NULL;
+    size_t *offsets = NULL;
+    char *names = NULL;
+    uint32_t n = 0;
+    size_t size = 0;
+
+    peekTrim(&name, &nameLen);
+    if (nameLen == 0 || peek->numEntries >= PEEKMAXENTRIES)
+    {
+        return NULL;
+    }
+
+    if (peek->numEntries == b->entriesAlloc)
+    {
+        n = (b->entriesAlloc == 0 ? 256 : b->entriesAlloc * 2);
+        entries = realloc(peek->entries, n * sizeof(peekEntry_t));
+        if (entries == NULL)
+        {
+            return NULL;
+        }
+        peek->entries = entries;
+        offsets = realloc(b->nameOffsets, n * sizeof(size_t));
+        if (offsets == NULL)
+        {
+            return NULL;
+        }
+        b->nameOffsets = offsets;
+        b->entriesAlloc = n;
+    }
+
+    if (b->namesLen + nameLen + 1 > b->namesAlloc)
+    {
+        size = (b->namesAlloc == 0 ? 16384 : b->namesAlloc * 2);
+        while (size < b->namesLen + nameLen + 1)
+        {
+            size *= 2;
+        }
+        names = realloc(peek->names, size);
+        if (names == NULL)
+        {
+            return NULL;
+        }
+        peek->names = names;
+        b->namesAlloc = size;
+    }
+
+    memcpy(peek->names + b->namesLen, name, nameLen);
+    b->nameOffsets[peek->numEntries] = b->namesLen;
+    b->namesLen += nameLen;
+    peek->names[b->namesLen++] = '\0';
+
+    memset(&peek->entries[peek->numEntries], 0, sizeof(peekEntry_t));
+
+    return &peek->entries[peek->numEntries++];
+}
+
+/* peekAddProps - keep a copy of an entry's coder properties */
+
+static int peekAddProps(peekBuild_t *b,
+                        peekEntry_t *entry,
+                        const unsigned char *props,
+                        size_t propsLen)
+{
+    unsigned char *p = NULL;
+    size_t size = 0;
+
+    if (propsLen == 0)
+    {
+        return gPeekOkay;
+    }
+
+    if (propsLen > 64)
+    {
+        return gPeekErr;
+    }
+
+    if (b->propsLen + propsLen > b->propsAlloc)
+    {
+        size = (b->propsAlloc == 0 ? 1024 : b->propsAlloc * 2);
+        while (size < b->propsLen + propsLen)
+        {
+            size *= 2;
+        }
+        p = realloc(b->peek->props, size);
+        if (p == NULL)
+        {
+            return gPeekErr;
+        }
+        b->peek->props = p;
+        b->propsAlloc = size;
+    }
+
+    memcpy(b->peek->props + b->propsLen, props, propsLen);
+    entry->props = (uint32_t)b->propsLen;
+    entry->propsLen = (uint32_t)propsLen;
+    b->propsLen += propsLen;
+
+    return gPeekOkay;
+}
+
+/*
+    peekFinish - point the entries at their names, and hash them; a
+                 later entry with the same path hides an earlier one
+*/
+
+static int peekFinish(peekBuild_t *b)
+{
+    peek_t *peek = b->peek;
+    peekEntry_t *entry = NULL;
+    uint32_t numBuckets = 16;
+    uint32_t i = 0;
+    uint32_t h = 0;
+
+    while (numBuckets < peek->numEntries * 2)
+    {
+        numBuckets *= 2;
+    }
+
+    peek->buckets = malloc(numBuckets * sizeof(uint32_t));
+    if (peek->buckets == NULL)
+    {
+        return gPeekErr;
+    }
+    memset(peek->buckets, 0xFF, numBuckets * sizeof(uint32_t));
+    peek->numBuckets = numBuckets;
+
+    for (i = 0; i < peek->numEntries; i++)
+    {
+        entry = &peek->entries[i];
+        entry->name = peek->names + b->nameOffsets[i];
+        h = peekHash(entry->name, strlen(entry->name)) & (numBuckets - 1);
+        entry->next = peek->buckets[h];
+        peek->buckets[h] = i;
+    }
+
+    return gPeekOkay;
+}
+
+/* peekDecoderInit - set up a decoder for an entry's method */
+
+static int peekDecoderInit(peekDecoder_t *d,
+                           peekMethod_t method,
+                           const unsigned char *props,
+                           size_t propsLen)
+{
+    lzma_filter filters[2];
+    lzma_stream init = LZMA_STREAM_INIT;
+    lzma_ret ret = LZMA_OK;
+
+    memset(d, 0, sizeof(peekDecoder_t));
+    d->method = method;
+    d->xz = init;
+
+    switch (method)
+    {
+        case PeekMethodStored:
+            break;
+        case PeekMethodDeflate:
+        case PeekMethodZlib:
+            if (inflateInit2(&d->z,
+                             (method == PeekMethodDeflate ?
+                              -MAX_WBITS : MAX_WBITS + 32)) != Z_OK)
+            {
+                return gPeekErr;
+            }
+            break;
+        case PeekMethodBzip2:
+            if (BZ2_bzDecompressInit(&d->bz, 0, 0) != BZ_OK)
+            {
+                return gPeekErr;
+            }
+            break;
+        case PeekMethodLZMA:
+        case PeekMethodZipLZMA:
+        case PeekMethodLZMA2:
+            memset(filters, 0, sizeof(filters));
+            filters[0].id = (method == PeekMethodLZMA2 ?
+                             LZMA_FILTER_LZMA2 : LZMA_FILTER_LZMA1);
+            filters[1].id = LZMA_VLI_UNKNOWN;
+            if (lzma_properties_decode(&filters[0],
+                                       NULL,
+                                       props,
+                                       propsLen) != LZMA_OK)
+            {
+                return gPeekErr;
+            }
+            ret = lzma_raw_decoder(&d->xz, filters);
+            free(filters[0].options);
+            if (ret != LZMA_OK)
+            {
+                return gPeekErr;
+            }
+            break;
+        case PeekMethodXZ:
+            if (lzma_auto_decoder(&d->xz, UINT64_MAX, 0) != LZMA_OK)
+            {
+                return gPeekErr;
+            }
+            break;
+        default:
+            return gPeekErr;
+    }
+
+    d->started = 1;
+
+    return gPeekOkay;
+}
+
+/*
+    peekDecoderRun - decode some of *in into out, updating *in and
+                     *inLen, and setting *outLen to the bytes decoded
+                     and *finished at the end of the stream
+*/
+
+static int peekDecoderRun(peekDecoder_t *d,
+                          const unsigned char **in,
+                          size_t *inLen,
+                          int lastInput,
+                          unsigned char *out,
+                          size_t *outLen,
+                          int *finished)
+{
+    size_t n = 0;
+    int ret = 0;
+    lzma_ret xzRet = LZMA_OK;
+
+    *finished = 0;
+
+    switch (d->method)
+    {
+        case PeekMethodStored:
+            n = (*inLen < *outLen ? *inLen : *outLen);
+            memcpy(out, *in, n);
+            *in += n;
+            *inLen -= n;
+            *outLen = n;
+            *finished = (lastInput && *inLen == 0);
+            return gPeekOkay;
+
+        case PeekMethodDeflate:
+        case PeekMethodZlib:
+            d->z.next_in = (Bytef *)*in;
+            d->z.avail_in = (uInt)*inLen;
+            d->z.next_out = out;
+            d->z.avail_out = (uInt)*outLen;
+            ret = inflate(&d->z, Z_NO_FLUSH);
+            *outLen -= d->z.avail_out;
+            *in += *inLen - d->z.avail_in;
+            *inLen = d->z.avail_in;
+            if (ret == Z_STREAM_END)
+            {
+                *finished = 1;
+                return gPeekOkay;
+            }
+            if (ret == Z_BUF_ERROR && *outLen == 0 && lastInput &&
+                *inLen == 0)
+            {
+                return gPeekErr;
+            }
+            return (ret == Z_OK || ret == Z_BUF_ERROR ?
+                    gPeekOkay : gPeekErr);
+
+        case PeekMethodBzip2:
+            d->bz.next_in = (char *)*in;
+            d->bz.avail_in = (unsigned int)*inLen;
+            d->bz.next_out = (char *)out;
+            d->bz.avail_out = (unsigned int)*outLen;
+            ret = BZ2_bzDecompress(&d->bz);
+            *outLen -= d->bz.avail_out;
+            *in += *inLen - d->bz.avail_in;
+            *inLen = d->bz.avail_in;
+            if (ret == BZ_STREAM_END)
+            {
+                *finished = 1;
+                return gPeekOkay;
+            }
+            if (ret == BZ_OK && *outLen == 0 && lastInput && *inLen == 0)
+            {
+                return gPeekErr;
+            }
+            return (ret == BZ_OK ? gPeekOkay : gPeekErr);
+
+        default:
+            d->xz.next_in = *in;
+            d->xz.avail_in = *inLen;
+            d->xz.next_out = out;
+            d->xz.avail_out = *outLen;
+            xzRet = lzma_code(&d->xz, (lastInput ? LZMA_FINISH : LZMA_RUN));
+            *outLen -= d->xz.avail_out;
+            *in += *inLen - d->xz.avail_in;
+            *inLen = d->xz.avail_in;
+            if (xzRet == LZMA_STREAM_END)
+            {
+                *finished = 1;
+                return gPeekOkay;
+            }
+
+            /* LZMA streams in 7z archives don't need an end marker */
+
+            if (xzRet == LZMA_BUF_ERROR && lastInput && *inLen == 0)
+            {
+                *finished = 1;
+                return gPeekOkay;
+            }
+            return (xzRet == LZMA_OK ? gPeekOkay : gPeekErr);
+    }
+}
+
+/* peekDecoderEnd - release a decoder */
+
+static void peekDecoderEnd(peekDecoder_t *d)
+{
+    if (!d->started)
+    {
+        return;
+    }
+
+    switch (d->method)
+    {
+        case PeekMethodDeflate:
+        case PeekMethodZlib:
+            inflateEnd(&d->z);
+            break;
+        case PeekMethodBzip2:
+            BZ2_bzDecompressEnd(&d->bz);
+            break;
+        case PeekMethodStored:
+            break;
+        default:
+            lzma_end(&d->xz);
+            break;
+    }
+
+    d->started = 0;
+}
+
+/*
+    peekDecode - decode packedSize bytes at offset, throw away the
+                 first skip bytes of the output, and copy up to maxLen
+                 bytes of the rest into buf, returns the number of
+                 bytes copied or -1
+*/
+
+static ssize_t peekDecode(peek_t *peek,
+                          peekMethod_t method,
+                          const unsigned char *props,
+                          size_t propsLen,
+                          uint64_t offset,
+                          uint64_t packedSize,
+                          uint64_t skip,
+                          unsigned char *buf,
+                          size_t maxLen)
+{
+    peekDecoder_t d;
+    unsigned char *inBuf = NULL;
+    unsigned char *outBuf = NULL;
+    const unsigned char *in = NULL;
+    size_t inLen = 0;
+    size_t outLen = 0;
+    size_t copied = 0;
+    size_t n = 0;
+    uint64_t remaining = packedSize;
+    ssize_t bytesRead = 0;
+    int finished = 0;
+    int stalls = 0;
+
+    if (skip > PEEKMAXSKIP ||
+        peekDecoderInit(&d, method, props, propsLen) != gPeekOkay)
+    {
+        return gPeekErr;
+    }
+
+    inBuf = malloc(PEEKREADSIZE);
+    outBuf = malloc(PEEKREADSIZE);
+    if (inBuf == NULL || outBuf == NULL)
+    {
+        free(inBuf);
+        free(outBuf);
+        peekDecoderEnd(&d);
+        return gPeekErr;
+    }
+
+    while (copied < maxLen && !finished)
+    {
+        if (inLen == 0 && remaining > 0)
+        {
+            n = (remaining < PEEKREADSIZE ? (size_t)remaining :
+                 PEEKREADSIZE);
+            bytesRead = archDirReadAt(peek->fd, inBuf, n, (off_t)offset);
+            if (bytesRead <= 0)
+            {
+                break;
+            }
+            peek->bytesRead += (uint64_t)bytesRead;
+            offset += (uint64_t)bytesRead;
+            remaining -= (uint64_t)bytesRead;
+            in = inBuf;
+            inLen = (size_t)bytesRead;
+        }
+
+        /* decode no more than is still wanted */
+
+        outLen = PEEKREADSIZE;
+        if (skip + (maxLen - copied) < outLen)
+        {
+            outLen = (size_t)skip + (maxLen - copied);
+        }
+        if (peekDecoderRun(&d,
+                           &in,
+                           &inLen,
+                           (remaining == 0),
+                           outBuf,
+                           &outLen,
+                           &finished) != gPeekOkay)
+        {
+            break;
+        }
+        peek->bytesDecoded += outLen;
+
+        /* give up on a decoder that neither reads nor writes */
+
+        if (outLen == 0 && inLen > 0)
+        {
+            if (++stalls > 4)
+            {
+                break;
+            }
+        }
+        else
+        {
+            stalls = 0;
+        }
+        if (outLen == 0 && inLen == 0 && remaining == 0)
+        {
+            finished = 1;
+        }
+
+        n = 0;
+        if (skip > 0)
+        {
+            n = (outLen < skip ? outLen : (size_t)skip);
+            skip -= n;
+        }
+        if (outLen - n > maxLen - copied)
+        {
+            outLen = maxLen - copied + n;
+        }
+        memcpy(buf + copied, outBuf + n, outLen - n);
+        copied += outLen - n;
+    }
+
+    free(inBuf);
+    free(outBuf);
+    peekDecoderEnd(&d);
+
+    /* a damaged entry is still shown up to where it's damaged */
+
+    if (copied == 0 && !finished)
+    {
+        return gPeekErr;
+    }
+
+    return (ssize_t)copied;
+}
+
+/*
+    peekOpenZip - index a zip's entries from its central directory;
+                  an entry's offset is that of its local header
+*/
+
+static int peekOpenZip(int fd, off_t fileSize, peekBuild_t *b)
+{
+    archDirZip_t zip;
+    archDirCursor_t c;
+    archDirZipEntry_t zipEntry;
+    peekEntry_t *entry = NULL;
+    uint64_t i = 0;
+
+    if (archDirZipFind(fd, fileSize, &zip) != gArchDirOkay)
+    {
+        return gPeekErr;
+    }
+
+    if (archDirZipLoad(fd, &zip, PEEKMAXDIRECTORY, &c) != gArchDirOkay)
+    {
+        archDirZipFree(&zip);
+        return gPeekErr;
+    }
+
+    for (i = 0; i < zip.numEntries; i++)
+    {
+        if (archDirZipNext(&c, zip.delta, &zipEntry) != gArchDirOkay)
+        {
+            archDirZipFree(&zip);
+            return gPeekErr;
+        }
+
+        entry = peekAddEntry(b,
+                             (const char *)zipEntry.name,
+                             zipEntry.nameLen);
+        if (entry != NULL)
+        {
+            entry->offset = zipEntry.offset;
+            entry->packedSize = zipEntry.compressedSize;
+            entry->size = zipEntry.uncompressedSize;
+            entry->isDir = (zipEntry.nameLen > 0 &&
+                            zipEntry.name[zipEntry.nameLen - 1] == '/');
+
+            switch (zipEntry.method)
+            {
+                case gZipMethodStored:
+                    entry->method = PeekMethodStored;
+                    break;
+                case gZipMethodDeflate:
+                    entry->method = PeekMethodDeflate;
+                    break;
+                case gZipMethodBzip2:
+                    entry->method = PeekMethodBzip2;
+                    break;
+                case gZipMethodLZMA:
+                    entry->method = PeekMethodZipLZMA;
+                    break;
+                default:
+                    entry->method = PeekMethodUnsupported;
+                    break;
+            }
+
+            if (zipEntry.flags & ZIPFLAGENCRYPTED)
+            {
+                entry->method = PeekMethodUnsupported;
+            }
+        }
+        else if (b->peek->numEntries >= PEEKMAXENTRIES)
+        {
+            break;
+        }
+    }
+
+    archDirZipFree(&zip);
+
+    return gPeekOkay;
+}
+
+/* peek7zMethod - get the method of a folder's coder */
+
+static peekMethod_t peek7zMethod(const archDir7zFolder_t *folder)
+{
+    if (!folder->simple || folder->numPacked != 1)
+    {
+        return PeekMethodUnsupported;
+    }
+
+    switch (folder->coderId)
+    {
+        case gArchDir7zCoderCopy:
+            return PeekMethodStored;
+        case gArchDir7zCoderLZMA:
+            return PeekMethodLZMA;
+        case gArchDir7zCoderLZMA2:
+            return PeekMethodLZMA2;
+        case gArchDir7zCoderDeflate:
+            return PeekMethodDeflate;
+        case gArchDir7zCoderBzip2:
+            return PeekMethodBzip2;
+        default:
+            return PeekMethodUnsupported;
+    }
+}
+
+/*
+    peek7zFiles - parse a FilesInfo, and add each file with its
+                  folder's packed stream and its offset in the folder
+*/
+
+static int peek7zFiles(archDir7z_t *s, peekBuild_t *b)
+{
+    archDirCursor_t *c = &s->files;
+    const unsigned char *emptyStream = NULL;
+    const unsigned char *emptyFile = NULL;
+    const unsigned char *names = NULL;
+    const unsigned char *namesEnd = NULL;
+    const archDir7zFolder_t *folder = NULL;
+    peekEntry_t *entry = NULL;
+    char *name = NULL;
+    uint64_t numFiles = 0, size = 0, i = 0;
+    uint64_t folderIndex = 0, substream = 0, streamIndex = 0;
+    uint64_t emptyIndex = 0, skip = 0, packOffset = 0, j = 0;
+    uint32_t ch = 0, low = 0;
+    size_t nameLen = 0;
+    unsigned int id = 0;
+    int isEmpty = 0;
+    int ret = gPeekOkay;
+
+    numFiles = s->numFiles;
+    if (numFiles == 0)
+    {
+        return gPeekOkay;
+    }
+    if (numFiles > PEEKMAXENTRIES * 2ULL)
+    {
+        return gPeekErr;
+    }
+
+    for (;;)
+    {
+        id = (unsigned int)archDirGetNumber(c);
+        if (c->err || id == gSzEnd)
+        {
+            break;
+        }
+
+        size = archDirGetNumber(c);
+        if (c->err || size > (uint64_t)(c->end - c->p))
+        {
+            return gPeekErr;
+        }
+
+        if (id == gSzEmptyStream && size * 8 >= numFiles)
+        {
+            emptyStream = c->p;
+        }
+        else if (id == gSzEmptyFile)
+        {
+            emptyFile = c->p;
+        }
+        else if (id == gSzName && size > 0 && c->p[0] == 0)
+        {
+            names = c->p + 1;
+        }
+
+        if (id == gSzName)
+        {
+            namesEnd = c->p + size;
+        }
+
+        archDirSkip(c, size);
+    }
+
+    if (c->err || names == NULL)
+    {
+        return gPeekErr;
+    }
+
+    /* names are UTF-16LE, and each is at most 4 times as long in UTF-8 */
+
+    name = malloc((size_t)(namesEnd - names) * 2 + 4);
+    if (name == NULL)
+    {
+        return gPeekErr;
+    }
+
+    for (i = 0; i < numFiles && ret == gPeekOkay; i++)
+    {
+        nameLen = 0;
+        while (names + 2 <= namesEnd)
+        {
+            ch = archDirGet16(names);
+            names += 2;
+            if (ch == 0)
+            {
+                break;
+            }
+            if (ch >= 0xD800 && ch < 0xDC00 && names + 2 <= namesEnd)
+            {
+                low = archDirGet16(names);
+                if (low >= 0xDC00 && low < 0xE000)
+                {
+                    names += 2;
+                    ch = 0x10000 + ((ch - 0xD800) << 10) + (low - 0xDC00);
+                }
+            }
+            nameLen += peekPutUtf8(name + nameLen, ch);
+        }
+
+        isEmpty = (emptyStream != NULL &&
+                   (emptyStream[i / 8] & (0x80 >> (i % 8))) != 0);
+
+        entry = peekAddEntry(b, name, nameLen);
+
+        if (isEmpty)
+        {
+            if (entry != NULL)
+            {
+                entry->method = PeekMethodStored;
+                entry->isDir = (emptyFile == NULL ||
+                                (emptyFile[emptyIndex / 8] &
+                                 (0x80 >> (emptyIndex % 8))) == 0);
+            }
+            emptyIndex++;
+            continue;
+        }
+
+        /* the next file with data is in the next folder with files */
+
+        while (folderIndex < s->numFolders &&
+               substream >= s->folders[folderIndex].numSubstreams)
+        {
+            folderIndex++;
+            substream = 0;
+            skip = 0;
+        }
+
+        if (folderIndex >= s->numFolders || streamIndex >= s->numSizes)
+        {
+            ret = gPeekErr;
+            break;
+        }
+
+        folder = &s->folders[folderIndex];
+
+        if (entry != NULL)
+        {
+            packOffset = ARCHDIR7ZSTARTHEADERLEN + s->packPos;
+            for (j = 0; j < folder->packIndex; j++)
+            {
+                packOffset += s->packSizes[j];
+            }
+
+            entry->offset = packOffset;
+            entry->packedSize = s->packSizes[folder->packIndex];
+            entry->size = s->sizes[streamIndex];
+            entry->skip = skip;
+            entry->method = peek7zMethod(folder);
+            if (entry->method != PeekMethodUnsupported &&
+                peekAddProps(b,
+                             entry,
+                             folder->props,
+                             (size_t)folder->propsLen) != gPeekOkay)
+            {
+                entry->method = PeekMethodUnsupported;
+            }
+        }
+
+        skip += s->sizes[streamIndex];
+        substream++;
+        streamIndex++;
+    }
+
+    free(name);
+
+    return ret;
+}
+
+/*
+    peekOpen7Zip - index a 7z archive's files from its header, which
+                   is decoded first if it is encoded
+*/
+
+static int peekOpen7Zip(int fd, off_t fileSize, peekBuild_t *b)
+{
+    archDir7z_t s;
+    int headerEncrypted = 0;
+    int ret = gPeekErr;
+
+    if (archDir7zLoad(fd,
+                      fileSize,
+                      PEEKMAXDIRECTORY,
+                      &s,
+                      &headerEncrypted) != gArchDirOkay)
+    {
+        return gPeekErr;
+    }
+
+    ret = peek7zFiles(&s, b);
+
+    archDir7zFree(&s);
+
+    return ret;
+}
+
+/*
+    peekXarText - decode the character references in an element's
+                  text in place, returns its new length
+*/
+
+static size_t peekXarText(char *text, size_t len)
+{
+    static const struct
+    {
+        const char *name;
+        char c;
+    } entities[] =
+    {
+        { "&amp;",  '&'  },
+        { "&lt;",   '<'  },
+        { "&gt;",   '>'  },
+        { "&quot;", '"'  },
+        { "&apos;", '\'' },
+    };
+    size_t i = 0, j = 0, k = 0, n = 0;
+    unsigned long c = 0;
+    char *end = NULL;
+
+    for (i = 0; i < len; )
+    {
+        if (text[i] != '&')
+        {
+            text[j++] = text[i++];
+            continue;
+        }
+
+        if (i + 2 < len && text[i + 1] == '#')
+        {
+            c = (text[i + 2] == 'x' ?
+                 strtoul(text + i + 3, &end, 16) :
+                 strtoul(text + i + 2, &end, 10));
+            if (end < text + len && *end == ';' && c > 0 && c < 0x110000)
+            {
+                j += peekPutUtf8(text + j, (uint32_t)c);
+                i = (size_t)(end - text) + 1;
+                continue;
+            }
+        }
+
+        for (k = 0; k < sizeof(entities) / sizeof(entities[0]); k++)
+        {
+            n = strlen(entities[k].name);
+            if (len - i >= n && memcmp(text + i, entities[k].name, n) == 0)
+            {
+                break;
+            }
+        }
+
+        if (k < sizeof(entities) / sizeof(entities[0]))
+        {
+            text[j++] = entities[k].c;
+            i += n;
+        }
+        else
+        {
+            text[j++] = text[i++];
+        }
+    }
+
+    return j;
+}
+
+/* peekXarGetElement - get which element a tag is */
+
+static peekXarElement_t peekXarGetElement(const char *tag, size_t len)
+{
+    static const struct
+    {
+        const char *name;
+        peekXarElement_t element;
+    } elements[] =
+    {
+        { "file",     XarFile     },
+        { "name",     XarName     },
+        { "type",     XarType     },
+        { "data",     XarData     },
+        { "offset",   XarOffset   },
+        { "length",   XarLength   },
+        { "size",     XarSize     },
+        { "encoding", XarEncoding },
+    };
+    size_t i = 0;
+
+    for (i = 0; i < sizeof(elements) / sizeof(elements[0]); i++)
+    {
+        if (strlen(elements[i].name) == len &&
+            memcmp(tag, elements[i].name, len) == 0)
+        {
+            return elements[i].element;
+        }
+    }
+
+    return XarOther;
+}
+
+/* peekXarMethod - get the method from an encoding's style attribute */
+
+static peekMethod_t peekXarMethod(const char *attrs, size_t len)
+{
+    static const struct
+    {
+        const char *style;
+        peekMethod_t method;
+    } styles[] =
+    {
+        { "application/octet-stream", PeekMethodStored },
+        { "application/x-gzip",       PeekMethodZlib   },
+        { "application/x-bzip2",      PeekMethodBzip2  },
+        { "application/x-lzma",       PeekMethodXZ     },
+        { "application/x-xz",         PeekMethodXZ     },
+    };
+    const char *style = NULL;
+    const char *end = attrs + len;
+    size_t i = 0, n = 0;
+
+    for (style = attrs; style + 7 <= end; style++)
+    {
+        if (memcmp(style, "style=", 6) == 0 &&
+            (style[6] == '"' || style[6] == '\''))
+        {
+            break;
+        }
+    }
+
+    if (style + 7 > end)
+    {
+        return PeekMethodStored;
+    }
+    style += 7;
+
+    for (i = 0; i < sizeof(styles) / sizeof(styles[0]); i++)
+    {
+        n = strlen(styles[i].style);
+        if ((size_t)(end - style) > n &&
+            memcmp(style, styles[i].style, n) == 0 &&
+            (style[n] == '"' || style[n] == '\''))
+        {
+            return styles[i].method;
+        }
+    }
+
+    return PeekMethodUnsupported;
+}
+
+/*
+    peekXarParse - find the files of a xar table of contents, with the
+                   elements of each file's data, which are the file
+                   element's own and not those of its extended
+                   attributes, and add them to the index with their
+                   paths
+*/
+
+static int peekXarParse(char *toc, uint64_t heap, peekBuild_t *b)
+{
+    peekXarElement_t stack[XARMAXDEPTH];
+    int64_t fileStack[XARMAXDEPTH];
+    peekXarFile_t *files = NULL;
+    peekXarFile_t *file = NULL;
+    peekXarFile_t *parent = NULL;
+    peekEntry_t *entry = NULL;
+    char *p = toc;
+    char *end = NULL;
+    char *tag = NULL;
+    char *text = NULL;
+    char *paths = NULL;
+    size_t pathsLen = 0, pathsAlloc = 0;
+    size_t tagLen = 0, textLen = 0, nameLen = 0, parentLen = 0;
+    uint64_t value = 0;
+    int64_t numFiles = 0, filesAlloc = 0, current = -1, i = 0;
+    peekXarElement_t element = XarOther;
+    int depth = 0;
+    int closing = 0;
+    int selfClosing = 0;
+    int ret = gPeekErr;
+
+    /* names are decoded in place, and kept as offsets into the toc */
+
+    while ((p = strchr(p, '<')) != NULL)
+    {
+        if (p[1] == '?' || p[1] == '!')
+        {
+            end = strstr(p, (p[1] == '!' && p[2] == '-') ? "-->" : ">");
+            if (end == NULL)
+            {
+                break;
+            }
+            p = end + 1;
+            continue;
+        }
+
+        end = strchr(p, '>');
+        if (end == NULL)
+        {
+            break;
+        }
+
+        closing = (p[1] == '/');
+        selfClosing = (end[-1] == '/');
+        tag = p + 1 + closing;
+        tagLen = strcspn(tag, " \t\r\n/>");
+        element = peekXarGetElement(tag, tagLen);
+
+        if (closing)
+        {
+            if (depth == 0)
+            {
+                goto done;
+            }
+            depth--;
+            if (stack[depth] == XarFile)
+            {
+                current = (depth > 0 ? fileStack[depth - 1] : -1);
+            }
+            p = end + 1;
+            continue;
+        }
+
+        if (depth >= XARMAXDEPTH)
+        {
+            goto done;
+        }
+
+        /* a file's data elements are under its data element */
+
+        file = (current >= 0 ? &files[current] : NULL);
+
+        if (element == XarFile)
+        {
+            if (numFiles >= PEEKMAXENTRIES)
+            {
+                goto done;
+            }
+            if (numFiles == filesAlloc)
+            {
+                filesAlloc = (filesAlloc == 0 ? 256 : filesAlloc * 2);
+                file = realloc(files,
+                               (size_t)filesAlloc * sizeof(peekXarFile_t));
+                if (file == NULL)
+                {
+                    goto done;
+                }
+                files = file;
+            }
+            file = &files[numFiles];
+            memset(file, 0, sizeof(peekXarFile_t));
+            file->parent = current;
+            file->method = PeekMethodStored;
+            current = numFiles++;
+        }
+        else if (element == XarEncoding && file != NULL && depth >= 2 &&
+                 stack[depth - 1] == XarData &&
+                 stack[depth - 2] == XarFile)
+        {
+            file->method = peekXarMethod(tag + tagLen,
+                                         (size_t)(end - tag) - tagLen);
+        }
+
+        stack[depth] = element;
+        fileStack[depth] = current;
+        depth++;
+
+        if (selfClosing)
+        {
+            depth--;
+            if (element == XarFile)
+            {
+                current = (depth > 0 ? fileStack[depth - 1] : -1);
+            }
+            p = end + 1;
+            continue;
+        }
+
+        /* the element's text, up to the next tag */
+
+        text = end + 1;
+        p = strchr(text, '<');
+        if (p == NULL)
+        {
+            break;
+        }
+        textLen = (size_t)(p - text);
+        file = (current >= 0 ? &files[current] : NULL);
+
+        if (file == NULL || depth < 2)
+        {
+            continue;
+        }
+
+        if (stack[depth - 2] == XarFile)
+        {
+            if (element == XarName)
+            {
+                file->name = (size_t)(text - toc);
+                file->nameLen = peekXarText(text, textLen);
+                file->hasName = (file->nameLen > 0);
+            }
+            else if (element == XarType)
+            {
+                file->isDir = (textLen == 9 &&
+                               memcmp(text, "directory", 9) == 0);
+            }
+        }
+        else if (depth >= 3 &&
+                 stack[depth - 2] == XarData &&
+                 stack[depth - 3] == XarFile &&
+                 (element == XarOffset ||
+                  element == XarLength ||
+                  element == XarSize))
+        {
+            value = strtoull(text, NULL, 10);
+            file->hasData = 1;
+            if (element == XarOffset)
+            {
+                file->offset = value;
+            }
+            else if (element == XarLength)
+            {
+                file->length = value;
+            }
+            else
+            {
+                file->size = value;
+            }
+        }
+    }
+
+    /* a parent comes before its files, so its path is known first */
+
+    for (i = 0; i < numFiles; i++)
+    {
+        file = &files[i];
+        if (!file->hasName)
+        {
+            continue;
+        }
+
+        parent = (file->parent >= 0 && files[file->parent].hasName ?
+                  &files[file->parent] : NULL);
+        nameLen = file->nameLen;
+        parentLen = (parent != NULL ? parent->pathLen : 0);
+
+        if (pathsLen + parentLen + nameLen + 1 > pathsAlloc)
+        {
+            pathsAlloc = (pathsAlloc == 0 ? 16384 : pathsAlloc * 2);
+            while (pathsAlloc < pathsLen + parentLen + nameLen + 1)
+            {
+                pathsAlloc *= 2;
+            }
+            text = realloc(paths, pathsAlloc);
+            if (text == NULL)
+            {
+                goto done;
+            }
+            paths = text;
+        }
+
+        file->path = pathsLen;
+        if (parent != NULL)
+        {
+            memcpy(paths + pathsLen, paths + parent->path, parentLen);
+            pathsLen += parentLen;
+            paths[pathsLen++] = '/';
+        }
+        memcpy(paths + pathsLen, toc + file->name, nameLen);
+        pathsLen += nameLen;
+        file->pathLen = pathsLen - file->path;
+
+        entry = peekAddEntry(b, paths + file->path, file->pathLen);
+        if (entry == NULL)
+        {
+            continue;
+        }
+
+        entry->isDir = file->isDir;
+        entry->method = file->method;
+        if (file->hasData)
+        {
+            entry->offset = heap + file->offset;
+            entry->packedSize = file->length;
+            entry->size = file->size;
+        }
+    }
+
+    ret = gPeekOkay;
+
+done:
+    free(paths);
+    free(files);
+
+    return ret;
+}
+
+/* peekOpenXar - index a xar archive's files from its table of contents */
+
+static int peekOpenXar(int fd, off_t fileSize, peekBuild_t *b)
+{
+    unsigned char header[XARHEADERLEN];
+    unsigned char *packed = NULL;
+    char *toc = NULL;
+    z_stream z;
+    uint64_t packedLen = 0;
+    uint64_t tocLen = 0;
+    uint16_t headerLen = 0;
+    int ret = gPeekErr;
+
+    if (archDirReadAt(fd, header, XARHEADERLEN, 0) != XARHEADERLEN ||
+        memcmp(header, XARMAGIC, 4) != 0)
+    {
+        return gPeekErr;
+    }
+
+    headerLen = archDirGetBE16(header + 4);
+    packedLen = archDirGetBE64(header + 8);
+    tocLen = archDirGetBE64(header + 16);
+
+    if (headerLen < XARHEADERLEN ||
+        packedLen == 0 || packedLen > PEEKMAXDIRECTORY ||
+        tocLen == 0 || tocLen > PEEKMAXDIRECTORY ||
+        headerLen + packedLen > (uint64_t)fileSize)
+    {
+        return gPeekErr;
+    }
+
+    packed = malloc((size_t)packedLen);
+    toc = malloc((size_t)tocLen + 1);
+    if (packed == NULL || toc == NULL)
+    {
+        free(packed);
+        free(toc);
+        return gPeekErr;
+    }
+
+    if (archDirReadAt(fd, packed, (size_t)packedLen, headerLen) ==
+            (ssize_t)packedLen)
+    {
+        memset(&z, 0, sizeof(z));
+        if (inflateInit(&z) == Z_OK)
+        {
+            z.next_in = packed;
+            z.avail_in = (uInt)packedLen;
+            z.next_out = (Bytef *)toc;
+            z.avail_out = (uInt)tocLen;
+            if (inflate(&z, Z_FINISH) == Z_STREAM_END)
+            {
+                toc[tocLen - z.avail_out] = '\0';
+                ret = peekXarParse(toc, headerLen + packedLen, b);
+            }
+            inflateEnd(&z);
+        }
+    }
+
+    free(packed);
+    free(toc);
+
+    return ret;
+}
+
+/*
+    peekISO9660Name - get a directory record's name: its Rock Ridge
+                      name, its Joliet (UCS-2) name, or its ISO9660
+                      name without its version and a trailing ".";
+                      skip is set for the "." and ".." records and for
+                      relocated directories, and zisofs is set for a
+                      file that is compressed with zisofs
+*/
+
+static size_t peekISO9660Name(const unsigned char *record,
+                              int rockRidge,
+                              int joliet,
+                              char *name,
+                              int *skip,
+                              int *zisofs)
+{
+    const unsigned char *id = record + ISO9660RECORDLEN;
+    const unsigned char *su = NULL;
+    const unsigned char *suEnd = record + record[0];
+    size_t idLen = record[32];
+    size_t len = 0;
+    size_t i = 0;
+    int hasName = 0;
+
+    *skip = (idLen == 1 && (id[0] == 0 || id[0] == 1));
+    *zisofs = 0;
+
+    if (rockRidge)
+    {
+        su = id + idLen + ((idLen & 1) == 0 ? 1 : 0);
+        while (su + 4 <= suEnd && su[2] >= 4 && su + su[2] <= suEnd)
+        {
+            if (su[0] == 'N' && su[1] == 'M' && su[2] > 5 &&
+                (su[4] & 0x06) == 0 && len + su[2] <= ISO9660MAXNAME)
+            {
+                memcpy(name + len, su + 5, su[2] - 5);
+                len += su[2] - 5;
+                hasName = 1;
+            }
+            else if (su[0] == 'R' && su[1] == 'E')
+            {
+                *skip = 1;
+            }
+            else if (su[0] == 'Z' && su[1] == 'F')
+            {
+                *zisofs = 1;
+            }
+            su += su[2];
+        }
+
+        if (hasName)
+        {
+            return len;
+        }
+    }
+
+    if (joliet)
+    {
+        for (i = 0; i + 1 < idLen; i += 2)
+        {
+            len += peekPutUtf8(name + len, archDirGetBE16(id + i));
+        }
+    }
+    else
+    {
+        memcpy(name, id, idLen);
+        len = idLen;
+    }
+
+    for (i = 0; i < len; i++)
+    {
+        if (name[i] == ';')
+        {
+            len = i;
+            break;
+        }
+    }
+
+    if (len > 0 && name[len - 1] == '.')
+    {
+        len--;
+    }
+
+    return len;
+}
+
+/*
+    peekISO9660Seen - add a directory's offset to the set of the
+                      directories that have been queued, which has
+                      numSeen of them; returns 1 if it was already in
+                      the set, 0 if it was added, or -1 on error
+*/
+
+static int peekISO9660Seen(uint64_t **seen,
+                           size_t *seenAlloc,
+                           size_t numSeen,
+                           uint64_t offset)
+{
+    uint64_t *more = NULL;
+    uint64_t key = offset + 1;
+    size_t alloc = 0;
+    size_t slot = 0;
+    size_t i = 0;
+
+    /* keep the set no more than half full, rehashing as it grows */
+
+    if ((numSeen + 1) * 2 > *seenAlloc)
+    {
+        alloc = (*seenAlloc > 0 ? *seenAlloc * 2 : 64);
+        more = calloc(alloc, sizeof(uint64_t));
+        if (more == NULL)
+        {
+            return -1;
+        }
+        for (i = 0; i < *seenAlloc; i++)
+        {
+            if ((*seen)[i] == 0)
+            {
+                continue;
+            }
+            slot = (size_t)(((*seen)[i] * 0x9E3779B97F4A7C15ULL) >> 32) &
+                   (alloc - 1);
+            while (more[slot] != 0)
+            {
+                slot = (slot + 1) & (alloc - 1);
+            }
+            more[slot] = (*seen)[i];
+        }
+        free(*seen);
+        *seen = more;
+        *seenAlloc = alloc;
+    }
+
+    slot = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (*seenAlloc - 1);
+    while ((*seen)[slot] != 0)
+    {
+        if ((*seen)[slot] == key)
+        {
+            return 1;
+        }
+        slot = (slot + 1) & (*seenAlloc - 1);
+    }
+    (*seen)[slot] = key;
+
+    return 0;
+}
+
+/*
+    peekOpenISO9660 - index an ISO9660 image's files by walking its
+                      directory tree from the primary (or the Joliet)
+                      volume descriptor; a directory whose extent
+                      has already been queued (a loop, or a directory
+                      that is linked twice) is not walked again, and
+                      neither is one more than ISO9660MAXDEPTH deep
+*/
+
+static int peekOpenISO9660(int fd, off_t fileSize, peekBuild_t *b)
+{
+    typedef struct isoDir
+    {
+        uint64_t offset;
+        uint64_t size;
+        size_t path;
+        size_t pathLen;
+        int depth;
+    } isoDir_t;
+
+    unsigned char vd[ISO9660SECTOR];
+    unsigned char primary[34];
+    unsigned char jolietRoot[34];
+    unsigned char *dir = NULL;
+    const unsigned char *record = NULL;
+    const unsigned char *root = NULL;
+    isoDir_t *dirs = NULL;
+    isoDir_t *more = NULL;
+    uint64_t *seen = NULL;
+    peekEntry_t *entry = NULL;
+    char *paths = NULL;
+    char *path = NULL;
+    char name[ISO9660MAXNAME];
+    size_t pathsLen = 0, pathsAlloc = 0, nameLen = 0, pathLen = 0;
+    size_t numDirs = 0, dirsAlloc = 0, next = 0, pos = 0, seenAlloc = 0;
+    uint64_t total = 0;
+    uint64_t blockSize = ISO9660SECTOR;
+    uint32_t extent = 0;
+    uint32_t size = 0;
+    int hasPrimary = 0, hasJoliet = 0, rockRidge = 0;
+    int skip = 0, zisofs = 0;
+    int i = 0;
+    int ret = gPeekErr;
+
+    for (i = 0; i < ISO9660MAXVDS; i++)
+    {
+        if (archDirReadAt(fd,
+                       vd,
+                       ISO9660SECTOR,
+                       (off_t)(ISO9660FIRSTVD + i) * ISO9660SECTOR) !=
+                ISO9660SECTOR ||
+            memcmp(vd + 1, ISO9660MAGIC, 5) != 0 ||
+            vd[0] == 255)
+        {
+            break;
+        }
+
+        if (vd[0] == 1 && !hasPrimary)
+        {
+            memcpy(primary, vd + 156, sizeof(primary));
+            blockSize = archDirGet16(vd + 128);
+            hasPrimary = 1;
+        }
+        else if (vd[0] == 2 && vd[88] == '%' && vd[89] == '/' &&
+                 (vd[90] == '@' || vd[90] == 'C' || vd[90] == 'E'))
+        {
+            memcpy(jolietRoot, vd + 156, sizeof(jolietRoot));
+            hasJoliet = 1;
+        }
+    }
+
+    if (!hasPrimary || blockSize == 0 || blockSize > ISO9660SECTOR)
+    {
+        return gPeekErr;
+    }
+
+    /* Rock Ridge names, from the SUSP "SP" entry of the root's "." */
+
+    extent = archDirGet32(primary + 2);
+    if (archDirReadAt(fd, vd, ISO9660SECTOR, (off_t)extent * blockSize) ==
+            ISO9660SECTOR &&
+        vd[0] >= ISO9660RECORDLEN + 1 + 7 &&
+        vd[ISO9660RECORDLEN + 1] == 'S' &&
+        vd[ISO9660RECORDLEN + 2] == 'P' &&
+        vd[ISO9660RECORDLEN + 5] == 0xBE &&
+        vd[ISO9660RECORDLEN + 6] == 0xEF)
+    {
+        rockRidge = 1;
+    }
+
+    root = (!rockRidge && hasJoliet ? jolietRoot : primary);
+
+    dirs = malloc(16 * sizeof(isoDir_t));
+    if (dirs == NULL)
+    {
+        return gPeekErr;
+    }
+    dirsAlloc = 16;
+    dirs[0].offset = (uint64_t)archDirGet32(root + 2) * blockSize;
+    dirs[0].size = archDirGet32(root + 10);
+    dirs[0].path = 0;
+    dirs[0].pathLen = 0;
+    dirs[0].depth = 0;
+    numDirs = 1;
+
+    pathsAlloc = 16384;
+    paths = malloc(pathsAlloc);
+    if (paths == NULL ||
+        peekISO9660Seen(&seen, &seenAlloc, 0, dirs[0].offset) != 0)
+    {
+        free(seen);
+        free(paths);
+        free(dirs);
+        return gPeekErr;
+    }
+
+    /* walk the tree breadth first, within the directory budget */
+
+    for (next = 0; next < numDirs; next++)
+    {
+        total += dirs[next].size;
+        if (total > PEEKMAXDIRECTORY ||
+            dirs[next].offset + dirs[next].size > (uint64_t)fileSize)
+        {
+            goto done;
+        }
+
+        free(dir);
+        dir = malloc((size_t)dirs[next].size + 1);
+        if (dir == NULL ||
+            archDirReadAt(fd,
+                       dir,
+                       (size_t)dirs[next].size,
+                       (off_t)dirs[next].offset) !=
+                (ssize_t)dirs[next].size)
+        {
+            goto done;
+        }
+
+        for (pos = 0; pos < dirs[next].size; )
+        {
+            record = dir + pos;
+
+            /* records don't cross sectors; the rest is padding */
+
+            if (record[0] == 0)
+            {
+                pos = (pos / ISO9660SECTOR + 1) * ISO9660SECTOR;
+                continue;
+            }
+            if (record[0] < ISO9660RECORDLEN + 1 ||
+                pos + record[0] > dirs[next].size ||
+                ISO9660RECORDLEN + (size_t)record[32] > record[0])
+            {
+                goto done;
+            }
+            pos += record[0];
+
+            nameLen = peekISO9660Name(record,
+                                      rockRidge,
+                                      (root == jolietRoot),
+                                      name,
+                                      &skip,
+                                      &zisofs);
+            if (skip || nameLen == 0)
+            {
+                continue;
+            }
+
+            /* the path is the directory's path, a "/" and the name */
+
+            pathLen = dirs[next].pathLen +
+                      (dirs[next].pathLen > 0 ? 1 : 0) + nameLen;
+
+            /* the directories' paths count against the budget too */
+
+            if (total + pathsLen + pathLen + 1 > PEEKMAXDIRECTORY)
+            {
+                goto done;
+            }
+            if (pathsLen + pathLen + 1 > pathsAlloc)
+            {
+                while (pathsLen + pathLen + 1 > pathsAlloc)
+                {
+                    pathsAlloc *= 2;
+                }
+                path = realloc(paths, pathsAlloc);
+                if (path == NULL)
+                {
+                    goto done;
+                }
+                paths = path;
+            }
+
+            path = paths + pathsLen;
+            if (dirs[next].pathLen > 0)
+            {
+                memcpy(path, paths + dirs[next].path, dirs[next].pathLen);
+                path[dirs[next].pathLen] = '/';
+            }
+            memcpy(path + pathLen - nameLen, name, nameLen);
+            path[pathLen] = '\0';
+
+            extent = archDirGet32(record + 2);
+            size = archDirGet32(record + 10);
+
+            entry = peekAddEntry(b, path, pathLen);
+            if (entry == NULL)
+            {
+                if (b->peek->numEntries >= PEEKMAXENTRIES)
+                {
+                    ret = gPeekOkay;
+                    goto done;
+                }
+                continue;
+            }
+
+            entry->offset = (uint64_t)extent * blockSize;
+            entry->packedSize = size;
+            entry->size = size;
+            entry->method = (zisofs ?
+                             PeekMethodUnsupported : PeekMethodStored);
+            entry->isDir = ((record[25] & ISO9660FLAGDIR) != 0);
+
+            if (!entry->isDir || dirs[next].depth >= ISO9660MAXDEPTH)
+            {
+                continue;
+            }
+
+            switch (peekISO9660Seen(&seen,
+                                    &seenAlloc,
+                                    numDirs,
+                                    entry->offset))
+            {
+                case 0:
+                    break;
+                case 1:
+                    continue;
+                default:
+                    goto done;
+            }
+
+            if (numDirs == dirsAlloc)
+            {
+                dirsAlloc *= 2;
+                more = realloc(dirs, dirsAlloc * sizeof(isoDir_t));
+                if (more == NULL)
+                {
+                    goto done;
+                }
+                dirs = more;
+            }
+
+            dirs[numDirs].offset = entry->offset;
+            dirs[numDirs].size = size;
+            dirs[numDirs].path = pathsLen;
+            dirs[numDirs].pathLen = pathLen;
+            dirs[numDirs].depth = dirs[next].depth + 1;
+            numDirs++;
+            pathsLen += pathLen + 1;
+        }
+    }
+
+    ret = gPeekOkay;
+
+done:
+    free(dir);
+    free(dirs);
+    free(seen);
+    free(paths);
+
+    return ret;
+}
+
+/* peekOpenBuild - find the archive's format and index its entries */
+
+static int peekOpenBuild(int fd, peek_t *peek)
+{
+    unsigned char head[8];
+    unsigned char iso[5];
+    peekBuild_t b;
+    struct stat st;
+    ssize_t headLen = 0;
+    int ret = gPeekErr;
+
+    if (fstat(fd, &st) != 0)
+    {
+        return gPeekErr;
+    }
+
+    memset(&b, 0, sizeof(b));
+    b.peek = peek;
+
+    headLen = archDirReadAt(fd, head, sizeof(head), 0);
+    if (headLen < 0)
+    {
+        return gPeekErr;
+    }
+
+    if (headLen >= 6 && memcmp(head, "7z\274\257\047\034", 6) == 0)
+    {
+        peek->format = PeekFormat7Zip;
+        ret = peekOpen7Zip(fd, st.st_size, &b);
+    }
+    else if (headLen >= 4 && memcmp(head, XARMAGIC, 4) == 0)
+    {
+        peek->format = PeekFormatXar;
+        ret = peekOpenXar(fd, st.st_size, &b);
+    }
+    else if (archDirReadAt(fd,
+                        iso,
+                        sizeof(iso),
+                        ISO9660FIRSTVD * ISO9660SECTOR + 1) ==
+                 (ssize_t)sizeof(iso) &&
+             memcmp(iso, ISO9660MAGIC, sizeof(iso)) == 0)
+    {
+        peek->format = PeekFormatISO9660;
+        ret = peekOpenISO9660(fd, st.st_size, &b);
+    }
+    else
+    {
+        /* a zip can have something (a self extractor) in front of it */
+
+        peek->format = PeekFormatZip;
+        ret = peekOpenZip(fd, st.st_size, &b);
+    }
+
+    if (ret == gPeekOkay)
+    {
+        ret = peekFinish(&b);
+    }
+
+    free(b.nameOffsets);
+
+    return ret;
+}
+
+/* public functions */
+
+/*
+    peekOpen - index the entries of the archive at path; the archive
+               stays open until peekClose()
+*/
+
+int peekOpen(const char *path, peek_t *peek)
+{
+    int fd = -1;
+
+    if (path == NULL || peek == NULL)
+    {
+        return gPeekErr;
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        memset(peek, 0, sizeof(peek_t));
+        peek->fd = -1;
+        return gPeekErr;
+    }
+
+    if (peekOpenFd(fd, peek) != gPeekOkay)
+    {
+        close(fd);
+        return gPeekErr;
+    }
+
+    peek->closeFd = 1;
+
+    return gPeekOkay;
+}
+
+/*
+    peekOpenFd - index the entries of the archive open on fd, which
+                 is read with pread() and is not closed by
+                 peekClose()
+*/
+
+int peekOpenFd(int fd, peek_t *peek)
+{
+    if (peek == NULL)
+    {
+        return gPeekErr;
+    }
+
+    memset(peek, 0, sizeof(peek_t));
+    peek->fd = fd;
+
+    if (fd < 0 || peekOpenBuild(fd, peek) != gPeekOkay)
+    {
+        peek->fd = -1;
+        peekClose(peek);
+        return gPeekErr;
+    }
+
+    return gPeekOkay;
+}
+
+/* peekFind - find an entry by its path, returns NULL if there is none */
+
+const peekEntry_t *peekFind(const peek_t *peek, const char *name)
+{
+    const peekEntry_t *entry = NULL;
+    size_t len = 0;
+    uint32_t i = 0;
+
+    if (peek == NULL || name == NULL || peek->buckets == NULL)
+    {
+        return NULL;
+    }
+
+    len = strlen(name);
+    peekTrim(&name, &len);
+
+    i = peek->buckets[peekHash(name, len) & (peek->numBuckets - 1)];
+    while (i != PEEKNOENTRY)
+    {
+        entry = &peek->entries[i];
+        if (strncmp(entry->name, name, len) == 0 &&
+            entry->name[len] == '\0')
+        {
+            return entry;
+        }
+        i = entry->next;
+    }
+
+    return NULL;
+}
+
+/*
+    peekRead - read and decode up to maxLen bytes of an entry's data
+               into buf, returns the number of bytes read or -1
+*/
+
+ssize_t peekRead(peek_t *peek,
+                 const peekEntry_t *entry,
+                 void *buf,
+                 size_t maxLen)
+{
+    unsigned char local[ARCHDIRZIPLOCALLEN];
+    unsigned char lzma[ZIPLZMAHEADERLEN + ZIPLZMAPROPSLEN];
+    const unsigned char *props = NULL;
+    size_t propsLen = 0;
+    uint64_t offset = 0;
+    uint64_t packedSize = 0;
+    ssize_t bytesRead = 0;
+
+    if (peek == NULL || entry == NULL || buf == NULL || peek->fd < 0 ||
+        entry->isDir || entry->method == PeekMethodUnsupported)
+    {
+        return gPeekErr;
+    }
+
+    if (maxLen > entry->size)
+    {
+        maxLen = (size_t)entry->size;
+    }
+    if (maxLen == 0)
+    {
+        return 0;
+    }
+
+    offset = entry->offset;
+    packedSize = entry->packedSize;
+    props = peek->props + entry->props;
+    propsLen = entry->propsLen;
+
+    /* a zip entry's data is after its local header */
+
+    if (peek->format == PeekFormatZip)
+    {
+        if (archDirReadAt(peek->fd, local, ARCHDIRZIPLOCALLEN, (off_t)offset) !=
+                ARCHDIRZIPLOCALLEN ||
+            memcmp(local, ARCHDIRZIPLOCALSIG, 4) != 0)
+        {
+            return gPeekErr;
+        }
+        peek->bytesRead += ARCHDIRZIPLOCALLEN;
+        offset += ARCHDIRZIPLOCALLEN + archDirGet16(local + 26) +
+                  archDirGet16(local + 28);
+
+        /* and an LZMA entry's properties are in front of its data */
+
+        if (entry->method == PeekMethodZipLZMA)
+        {
+            if (packedSize < sizeof(lzma) ||
+                archDirReadAt(peek->fd, lzma, sizeof(lzma), (off_t)offset) !=
+                    (ssize_t)sizeof(lzma) ||
+                archDirGet16(lzma + 2) != ZIPLZMAPROPSLEN)
+            {
+                return gPeekErr;
+            }
+            peek->bytesRead += sizeof(lzma);
+            offset += sizeof(lzma);
+            packedSize -= sizeof(lzma);
+            props = lzma + ZIPLZMAHEADERLEN;
+            propsLen = ZIPLZMAPROPSLEN;
+        }
+    }
+
+    /* stored data is read straight into buf */
+
+    if (entry->method == PeekMethodStored)
+    {
+        if (entry->skip + maxLen > packedSize)
+        {
+            return gPeekErr;
+        }
+        bytesRead = archDirReadAt(peek->fd,
+                               buf,
+                               maxLen,
+                               (off_t)(offset + entry->skip));
+        if (bytesRead > 0)
+        {
+            peek->bytesRead += (uint64_t)bytesRead;
+        }
+        return (bytesRead > 0 ? bytesRead : gPeekErr);
+    }
+
+    return peekDecode(peek,
+                      entry->method,
+                      props,
+                      propsLen,
+                      offset,
+                      packedSize,
+                      entry->skip,
+                      buf,
+                      maxLen);
+}
+
+/* peekClose - release an index, and close its archive if it opened it */
+
+void peekClose(peek_t *peek)
+{
+    if (peek == NULL)
+    {
+        return;
+    }
+
+    if (peek->closeFd && peek->fd >= 0)
+    {
+        close(peek->fd);
+    }
+
+    free(peek->entries);
+    free(peek->names);
+    free(peek->props);
+    free(peek->buckets);
+
+    memset(peek, 0, sizeof(peek_t));
+    peek->fd = -1;
+}
+
+/* peekFormatName - get a format's name */
+
+const char *peekFormatName(peekFormat_t format)
+{
+    if (format < PeekFormatUnknown || format > PeekFormatISO9660)
+    {
+        return gPeekFormatNames[PeekFormatUnknown];
+    }
+
+    return gPeekFormatNames[format];
+}
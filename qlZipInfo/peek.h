@@ -0,0 +1,161 @@
+/*
+    peek.h - read one entry of an archive through its directory
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    peekOpen() reads the directory of a zip, 7z, xar or ISO9660
+    archive, which has the offset of every entry's data, into a table
+    of the entries with a hash of their paths.  peekRead() then reads
+    one entry, found by its path in constant time with peekFind(),
+    with one seek, and decodes only that entry, up to a given number
+    of bytes.  Listing an archive with archive_read_next_header()
+    instead reads, and for most formats decodes, every entry ahead of
+    the one that is wanted.
+
+        - zip: the central directory, if it is no larger than
+          PEEKMAXDIRECTORY, for each entry's local header offset,
+          method and sizes.  Stored, deflate, bzip2 and LZMA entries
+          can be read; encrypted entries can't.
+        - 7z: the header (decoded, if it is encoded), for each
+          folder's packed stream and coder, and each file's folder and
+          offset in it.  Folders with one copy, LZMA, LZMA2, deflate
+          or bzip2 coder can be read.  A file that is not the first
+          in a solid folder is read by decoding the folder from its
+          start, and the files ahead of it (up to PEEKMAXSKIP bytes)
+          are thrown away.
+        - xar: the table of contents, inflated, for each file's heap
+          offset, length and encoding (none, gzip, bzip2, lzma or
+          xz).
+        - ISO9660: the directory tree, with the Rock Ridge names if
+          there are any, or else the Joliet tree if there is one.
+          Each directory is walked once, up to 256 deep, so loops
+          in the tree end.  The entries' data is stored.
+
+    Paths are looked up as libarchive lists them, without a leading
+    "./" or "/", or a trailing "/".  At most PEEKMAXENTRIES entries
+    are indexed.
+*/
+
+#ifndef qlZipInfo_peek_h
+#define qlZipInfo_peek_h
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/* return codes */
+
+enum
+{
+    gPeekErr  = -1,
+    gPeekOkay =  0,
+};
+
+/* most bytes of directory (or table of contents, or header) read */
+
+#define PEEKMAXDIRECTORY (64 * 1024 * 1024)
+
+/* most entries that are indexed */
+
+#define PEEKMAXENTRIES   1000000
+
+/* most bytes of a solid 7z folder decoded ahead of an entry */
+
+#define PEEKMAXSKIP      (16 * 1024 * 1024)
+
+/* formats */
+
+typedef enum
+{
+    PeekFormatUnknown = 0,
+    PeekFormatZip,
+    PeekFormat7Zip,
+    PeekFormatXar,
+    PeekFormatISO9660,
+} peekFormat_t;
+
+/* how an entry's data is stored */
+
+typedef enum
+{
+    PeekMethodStored = 0,
+    PeekMethodDeflate,
+    PeekMethodZlib,
+    PeekMethodBzip2,
+    PeekMethodLZMA,
+    PeekMethodLZMA2,
+    PeekMethodXZ,
+    PeekMethodZipLZMA,
+    PeekMethodUnsupported,
+} peekMethod_t;
+
+/* an entry */
+
+typedef struct peekEntry
+{
+    const char *name;
+    uint64_t offset;
+    uint64_t packedSize;
+    uint64_t size;
+    uint64_t skip;
+    uint32_t props;
+    uint32_t propsLen;
+    uint32_t next;
+    peekMethod_t method;
+    int isDir;
+} peekEntry_t;
+
+/* an archive's index */
+
+typedef struct peek
+{
+    peekFormat_t format;
+    int fd;
+    int closeFd;
+    uint32_t numEntries;
+    peekEntry_t *entries;
+    char *names;
+    unsigned char *props;
+    uint32_t *buckets;
+    uint32_t numBuckets;
+    uint64_t bytesRead;
+    uint64_t bytesDecoded;
+} peek_t;
+
+/* prototypes */
+
+int peekOpen(const char *path, peek_t *peek);
+int peekOpenFd(int fd, peek_t *peek);
+const peekEntry_t *peekFind(const peek_t *peek, const char *name);
+ssize_t peekRead(peek_t *peek,
+                 const peekEntry_t *entry,
+                 void *buf,
+                 size_t maxLen);
+void peekClose(peek_t *peek);
+const char *peekFormatName(peekFormat_t format);
+
+#endif /* qlZipInfo_peek_h */
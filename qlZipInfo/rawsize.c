@@ -0,0 +1,1409 @@
+/*
+    rawsize.c - get the uncompressed size of a compressed file
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <bzlib.h>
+#include <lzma.h>
+
+#include "rawsize.h"
+
+/* magic numbers */
+
+#define RAWZSTDMAGIC      0xFD2FB528U
+#define RAWLZ4MAGIC       0x184D2204U
+#define RAWLZ4LEGACYMAGIC 0x184C2102U
+#define RAWSKIPMAGIC      0x184D2A50U
+#define RAWSKIPMASK       0xFFFFFFF0U
+#define RAWSEEKMAGIC      0x8F92EAB1U
+#define RAWSEEKFRAME      0x184D2A5EU
+#define RAWBZIP2BLOCK     0x314159265359ULL
+#define RAWBZIP2END       0x177245385090ULL
+
+/* sizes */
+
+#define RAWHEADLEN        32
+#define RAWSEEKFOOTERLEN  9
+#define RAWBZIP2HEADERLEN 4
+#define RAWBZIP2OUTLEN    65536
+#define RAWBZIP2MINSCAN   65536
+
+/* most skippable frames ahead of the first frame */
+
+#define RAWMAXSKIPPABLE   16
+
+/* bzip2 blocks found by a thread's scan */
+
+typedef struct rawBZip2Marks
+{
+    uint64_t *marks;
+    size_t numMarks;
+    size_t maxMarks;
+} rawBZip2Marks_t;
+
+/* a thread's share of a bzip2 file */
+
+typedef struct rawBZip2Job
+{
+    const unsigned char *buf;
+    size_t len;
+    size_t start;
+    size_t end;
+    const uint64_t *marks;
+    size_t numMarks;
+    size_t first;
+    size_t step;
+    rawBZip2Marks_t found;
+    uint64_t size;
+    int err;
+    volatile int *failed;
+} rawBZip2Job_t;
+
+/* format names */
+
+static const char *gRawFormatNames[RawFormatMax] =
+{
+    "Unknown",
+    "gzip",
+    "bzip2",
+    "xz",
+    "zstd",
+    "lz4",
+};
+
+/* file extensions */
+
+static const char *gRawExtensions[RawFormatMax] =
+{
+    "",
+    ".gz",
+    ".bz2",
+    ".xz",
+    ".zst",
+    ".lz4",
+};
+
+/* private functions */
+
+static uint32_t rawGet32(const unsigned char *p);
+static uint64_t rawGet64(const unsigned char *p);
+static ssize_t rawReadAt(int fd,
+                         rawSize_t *raw,
+                         void *buf,
+                         size_t len,
+                         off_t offset);
+static rawFormat_t rawGetFormat(int fd, off_t fileSize);
+static int rawReadGZip(int fd, rawSize_t *raw);
+static int rawReadXZ(int fd, rawSize_t *raw);
+static int rawReadSeekTable(int fd, rawSize_t *raw);
+static int rawZstdFrame(int fd,
+                        rawSize_t *raw,
+                        off_t offset,
+                        uint32_t hint,
+                        uint32_t *numBlocks,
+                        off_t *end,
+                        uint64_t *size);
+static int rawLZ4Frame(int fd,
+                       rawSize_t *raw,
+                       off_t offset,
+                       uint32_t *numBlocks,
+                       off_t *end,
+                       uint64_t *size);
+static int rawReadFrames(int fd, rawSize_t *raw);
+static int rawAddMark(rawBZip2Marks_t *found, uint64_t mark);
+static void *rawBZip2Scan(void *arg);
+static void rawCopyBits(unsigned char *dst,
+                        const unsigned char *src,
+                        size_t srcLen,
+                        uint64_t srcBit,
+                        uint64_t numBits);
+static void rawPutBits(unsigned char *dst,
+                       uint64_t dstBit,
+                       uint64_t value,
+                       unsigned int numBits);
+static int rawBZip2Block(const unsigned char *buf,
+                         size_t len,
+                         uint64_t start,
+                         uint64_t end,
+                         uint64_t *size);
+static void *rawBZip2Decode(void *arg);
+static int rawBZip2Run(rawBZip2Job_t *jobs,
+                       unsigned int numJobs,
+                       void *(*func)(void *));
+static int rawReadBZip2(int fd, rawSize_t *raw);
+
+/* rawGet32 - get a little endian 32 bit value */
+
+static uint32_t rawGet32(const unsigned char *p)
+{
+    return (uint32_t)p[0] |
+           ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+/* rawGet64 - get a little endian 64 bit value */
+
+static uint64_t rawGet64(const unsigned char *p)
+{
+    return (uint64_t)rawGet32(p) | ((uint64_t)rawGet32(p + 4) << 32);
+}
+
+/*
+    rawReadAt - read up to len bytes at offset, returns the number of
+                bytes read or -1 on error
+*/
+
+static ssize_t rawReadAt(int fd,
+                         rawSize_t *raw,
+                         void *buf,
+                         size_t len,
+                         off_t offset)
+{
+    size_t total = 0;
+    ssize_t bytesRead = 0;
+
+    if (offset < 0)
+    {
+        return -1;
+    }
+
+    while (total < len)
+    {
+        bytesRead = pread(fd,
+                          (unsigned char *)buf + total,
+                          len - total,
+                          offset + (off_t)total);
+        if (bytesRead < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        if (bytesRead == 0)
+        {
+            break;
+        }
+        total += (size_t)bytesRead;
+    }
+
+    raw->bytesRead += total;
+
+    return (ssize_t)total;
+}
+
+/*
+    rawGetFormat - get a compressed file's format from its magic
+                   number, skipping the skippable frames that can be
+                   ahead of a zstd or lz4 frame
+*/
+
+static rawFormat_t rawGetFormat(int fd, off_t fileSize)
+{
+    rawSize_t scratch;
+    unsigned char head[RAWHEADLEN];
+    uint32_t magic = 0;
+    off_t offset = 0;
+    int i = 0;
+
+    memset(&scratch, 0, sizeof(rawSize_t));
+
+    for (i = 0; i <= RAWMAXSKIPPABLE; i++)
+    {
+        memset(head, 0, sizeof(head));
+        if (rawReadAt(fd, &scratch, head, sizeof(head), offset) < 8)
+        {
+            return RawFormatUnknown;
+        }
+
+        if (offset == 0)
+        {
+            if (head[0] == 0x1F && head[1] == 0x8B)
+            {
+                return RawFormatGZip;
+            }
+
+            if (memcmp(head, "BZh", 3) == 0 &&
+                head[3] >= '1' && head[3] <= '9' &&
+                (memcmp(head + 4, "\061\101\131\046\123\131", 6) == 0 ||
+                 memcmp(head + 4, "\027\162\105\070\120\220", 6) == 0))
+            {
+                return RawFormatBZip2;
+            }
+
+            if (memcmp(head, "\3757zXZ\000", 6) == 0)
+            {
+                return RawFormatXZ;
+            }
+        }
+
+        magic = rawGet32(head);
+        if (magic == RAWZSTDMAGIC)
+        {
+            return RawFormatZstd;
+        }
+        if (magic == RAWLZ4MAGIC || magic == RAWLZ4LEGACYMAGIC)
+        {
+            return RawFormatLZ4;
+        }
+        if ((magic & RAWSKIPMASK) != RAWSKIPMAGIC)
+        {
+            return RawFormatUnknown;
+        }
+
+        offset += 8 + (off_t)rawGet32(head + 4);
+        if (offset >= fileSize)
+        {
+            return RawFormatUnknown;
+        }
+    }
+
+    return RawFormatUnknown;
+}
+
+/*
+    rawReadGZip - get a gzip'ed file's uncompressed size (modulo 4GB)
+                  from its last 4 bytes
+*/
+
+static int rawReadGZip(int fd, rawSize_t *raw)
+{
+    unsigned char isize[4];
+
+    if (raw->fileSize < 18 ||
+        rawReadAt(fd, raw, isize, 4, raw->fileSize - 4) != 4)
+    {
+        return gRawSizeErr;
+    }
+
+    raw->size = rawGet32(isize);
+    raw->numStreams = 1;
+    raw->hasSize = 1;
+
+    return gRawSizeOkay;
+}
+
+/*
+    rawReadXZ - add up the uncompressed sizes in the indexes of an xz
+                file's streams, from the last stream back to the first
+*/
+
+static int rawReadXZ(int fd, rawSize_t *raw)
+{
+    lzma_stream_flags footerFlags;
+    lzma_stream_flags headerFlags;
+    lzma_index *index = NULL;
+    unsigned char footer[LZMA_STREAM_HEADER_SIZE];
+    unsigned char *buf = NULL;
+    uint64_t memLimit = UINT64_MAX;
+    uint64_t size = 0;
+    lzma_vli streamSize = 0;
+    off_t pos = raw->fileSize;
+    size_t indexLen = 0;
+    size_t inPos = 0;
+    uint32_t numPadding = 0;
+    int ret = gRawSizeErr;
+
+    while (pos > 0)
+    {
+        if (raw->numStreams >= RAWMAXSTREAMS ||
+            pos < 2 * LZMA_STREAM_HEADER_SIZE)
+        {
+            goto done;
+        }
+
+        if (rawReadAt(fd, raw, footer, sizeof(footer),
+                      pos - LZMA_STREAM_HEADER_SIZE) !=
+                (ssize_t)sizeof(footer))
+        {
+            goto done;
+        }
+
+        /* stream padding is a multiple of 4 zero bytes */
+
+        if (rawGet32(footer + LZMA_STREAM_HEADER_SIZE - 4) == 0)
+        {
+            if (++numPadding > RAWMAXBLOCKS)
+            {
+                goto done;
+            }
+            pos -= 4;
+            continue;
+        }
+
+        if (lzma_stream_footer_decode(&footerFlags, footer) != LZMA_OK)
+        {
+            goto done;
+        }
+
+        if (footerFlags.backward_size > RAWMAXINDEX ||
+            (off_t)footerFlags.backward_size >
+                pos - 2 * LZMA_STREAM_HEADER_SIZE)
+        {
+            goto done;
+        }
+
+        indexLen = (size_t)footerFlags.backward_size;
+        buf = malloc(indexLen);
+        if (buf == NULL ||
+            rawReadAt(fd, raw, buf, indexLen,
+                      pos - LZMA_STREAM_HEADER_SIZE - (off_t)indexLen) !=
+                (ssize_t)indexLen)
+        {
+            goto done;
+        }
+
+        memLimit = UINT64_MAX;
+        inPos = 0;
+        if (lzma_index_buffer_decode(&index,
+                                     &memLimit,
+                                     NULL,
+                                     buf,
+                                     &inPos,
+                                     indexLen) != LZMA_OK)
+        {
+            index = NULL;
+            goto done;
+        }
+        free(buf);
+        buf = NULL;
+
+        streamSize = lzma_index_stream_size(index);
+        size += lzma_index_uncompressed_size(index);
+        lzma_index_end(index, NULL);
+        index = NULL;
+
+        if (streamSize > (lzma_vli)pos)
+        {
+            goto done;
+        }
+        pos -= (off_t)streamSize;
+
+        /* the stream's header must agree with its footer */
+
+        if (rawReadAt(fd, raw, footer, sizeof(footer), pos) !=
+                (ssize_t)sizeof(footer) ||
+            lzma_stream_header_decode(&headerFlags, footer) != LZMA_OK ||
+            lzma_stream_flags_compare(&headerFlags, &footerFlags) !=
+                LZMA_OK)
+        {
+            goto done;
+        }
+
+        raw->numStreams++;
+    }
+
+    raw->size = size;
+    raw->hasSize = 1;
+    ret = gRawSizeOkay;
+
+done:
+    if (index != NULL)
+    {
+        lzma_index_end(index, NULL);
+    }
+    free(buf);
+
+    return ret;
+}
+
+/*
+    rawReadSeekTable - add up the uncompressed sizes of the frames in
+                       a seekable zstd file's seek table
+*/
+
+static int rawReadSeekTable(int fd, rawSize_t *raw)
+{
+    unsigned char footer[RAWSEEKFOOTERLEN];
+    unsigned char head[8];
+    unsigned char *table = NULL;
+    uint64_t size = 0;
+    uint32_t numFrames = 0;
+    uint32_t i = 0;
+    size_t entryLen = 0;
+    size_t tableLen = 0;
+    int ret = gRawSizeErr;
+
+    if (raw->fileSize < RAWSEEKFOOTERLEN + 8 ||
+        rawReadAt(fd, raw, footer, sizeof(footer),
+                  raw->fileSize - RAWSEEKFOOTERLEN) !=
+            (ssize_t)sizeof(footer) ||
+        rawGet32(footer + 5) != RAWSEEKMAGIC ||
+        (footer[4] & 0x7C) != 0)
+    {
+        return gRawSizeErr;
+    }
+
+    numFrames = rawGet32(footer);
+    entryLen = ((footer[4] & 0x80) != 0 ? 12 : 8);
+    if (numFrames > RAWMAXFRAMES)
+    {
+        return gRawSizeErr;
+    }
+
+    tableLen = (size_t)numFrames * entryLen;
+    if ((off_t)(tableLen + RAWSEEKFOOTERLEN + 8) > raw->fileSize)
+    {
+        return gRawSizeErr;
+    }
+
+    /* the table is a skippable frame */
+
+    if (rawReadAt(fd, raw, head, sizeof(head),
+                  raw->fileSize -
+                  (off_t)(tableLen + RAWSEEKFOOTERLEN + 8)) !=
+            (ssize_t)sizeof(head) ||
+        rawGet32(head) != RAWSEEKFRAME ||
+        rawGet32(head + 4) != tableLen + RAWSEEKFOOTERLEN)
+    {
+        return gRawSizeErr;
+    }
+
+    table = malloc(tableLen + 1);
+    if (table == NULL ||
+        rawReadAt(fd, raw, table, tableLen,
+                  raw->fileSize - (off_t)(tableLen + RAWSEEKFOOTERLEN)) !=
+            (ssize_t)tableLen)
+    {
+        goto done;
+    }
+
+    for (i = 0; i < numFrames; i++)
+    {
+        size += rawGet32(table + (size_t)i * entryLen + 4);
+    }
+
+    raw->size = size;
+    raw->numStreams = numFrames;
+    raw->hasSize = 1;
+    ret = gRawSizeOkay;
+
+done:
+    free(table);
+
+    return ret;
+}
+
+/*
+    rawZstdFrame - get a zstd frame's content size from its header,
+                   and its end from the hint that pzstd writes ahead of
+                   it, or else from its block headers; *end is 0 if
+                   there are too many blocks to walk
+*/
+
+static int rawZstdFrame(int fd,
+                        rawSize_t *raw,
+                        off_t offset,
+                        uint32_t hint,
+                        uint32_t *numBlocks,
+                        off_t *end,
+                        uint64_t *size)
+{
+    static const unsigned int dictIdLens[4] = { 0, 1, 2, 4 };
+    unsigned char head[18];
+    unsigned char block[3];
+    uint32_t blockHeader = 0;
+    uint32_t blockLen = 0;
+    unsigned int fhd = 0;
+    unsigned int pos = 5;
+    unsigned int sizeLen = 0;
+    unsigned int i = 0;
+    off_t p = 0;
+
+    memset(head, 0, sizeof(head));
+    if (rawReadAt(fd, raw, head, sizeof(head), offset) < 6)
+    {
+        return gRawSizeErr;
+    }
+
+    fhd = head[4];
+    if ((fhd & 0x08) != 0)
+    {
+        return gRawSizeErr;
+    }
+
+    /* the window descriptor isn't there for a single segment */
+
+    if ((fhd & 0x20) == 0)
+    {
+        pos++;
+    }
+    pos += dictIdLens[fhd & 0x03];
+
+    switch (fhd >> 6)
+    {
+        case 0:
+            sizeLen = ((fhd & 0x20) != 0 ? 1 : 0);
+            break;
+        case 1:
+            sizeLen = 2;
+            break;
+        case 2:
+            sizeLen = 4;
+            break;
+        default:
+            sizeLen = 8;
+            break;
+    }
+
+    /* without a content size, the frame has to be decompressed */
+
+    if (sizeLen == 0)
+    {
+        return gRawSizeErr;
+    }
+
+    for (*size = 0, i = sizeLen; i > 0; i--)
+    {
+        *size = (*size << 8) | head[pos + i - 1];
+    }
+    if (sizeLen == 2)
+    {
+        *size += 256;
+    }
+
+    if (hint > 0)
+    {
+        *end = offset + (off_t)hint;
+        return gRawSizeOkay;
+    }
+
+    for (p = offset + (off_t)(pos + sizeLen); ; )
+    {
+        if (*numBlocks >= RAWMAXBLOCKS)
+        {
+            *end = 0;
+            return gRawSizeOkay;
+        }
+        (*numBlocks)++;
+
+        if (rawReadAt(fd, raw, block, sizeof(block), p) !=
+                (ssize_t)sizeof(block))
+        {
+            return gRawSizeErr;
+        }
+
+        blockHeader = (uint32_t)block[0] |
+                      ((uint32_t)block[1] << 8) |
+                      ((uint32_t)block[2] << 16);
+        blockLen = blockHeader >> 3;
+
+        /* an RLE block is one byte, repeated */
+
+        switch ((blockHeader >> 1) & 0x03)
+        {
+            case 1:
+                blockLen = 1;
+                break;
+            case 3:
+                return gRawSizeErr;
+            default:
+                break;
+        }
+
+        p += (off_t)sizeof(block) + (off_t)blockLen;
+        if ((blockHeader & 0x01) != 0)
+        {
+            break;
+        }
+    }
+
+    /* the content checksum */
+
+    if ((fhd & 0x04) != 0)
+    {
+        p += 4;
+    }
+
+    *end = p;
+
+    return gRawSizeOkay;
+}
+
+/*
+    rawLZ4Frame - get an lz4 frame's content size from its header, and
+                  its end from its block headers; *end is 0 if there
+                  are too many blocks to walk
+*/
+
+static int rawLZ4Frame(int fd,
+                       rawSize_t *raw,
+                       off_t offset,
+                       uint32_t *numBlocks,
+                       off_t *end,
+                       uint64_t *size)
+{
+    unsigned char head[19];
+    unsigned char block[4];
+    uint32_t blockLen = 0;
+    unsigned int flg = 0;
+    unsigned int pos = 6;
+    off_t p = 0;
+
+    memset(head, 0, sizeof(head));
+    if (rawReadAt(fd, raw, head, sizeof(head), offset) < 7)
+    {
+        return gRawSizeErr;
+    }
+
+    /* a legacy frame has no content size, nor does the frame without it */
+
+    flg = head[4];
+    if (rawGet32(head) != RAWLZ4MAGIC ||
+        (flg >> 6) != 0x01 ||
+        (flg & 0x08) == 0)
+    {
+        return gRawSizeErr;
+    }
+
+    *size = rawGet64(head + pos);
+    pos += 8;
+    if ((flg & 0x01) != 0)
+    {
+        pos += 4;
+    }
+
+    /* the header checksum */
+
+    pos++;
+
+    for (p = offset + (off_t)pos; ; )
+    {
+        if (*numBlocks >= RAWMAXBLOCKS)
+        {
+            *end = 0;
+            return gRawSizeOkay;
+        }
+        (*numBlocks)++;
+
+        if (rawReadAt(fd, raw, block, sizeof(block), p) !=
+                (ssize_t)sizeof(block))
+        {
+            return gRawSizeErr;
+        }
+        p += (off_t)sizeof(block);
+
+        /* the end mark */
+
+        blockLen = rawGet32(block);
+        if (blockLen == 0)
+        {
+            break;
+        }
+
+        /* the high bit is set for an uncompressed block */
+
+        p += (off_t)(blockLen & 0x7FFFFFFFU);
+        if ((flg & 0x10) != 0)
+        {
+            p += 4;
+        }
+    }
+
+    /* the content checksum */
+
+    if ((flg & 0x04) != 0)
+    {
+        p += 4;
+    }
+
+    *end = p;
+
+    return gRawSizeOkay;
+}
+
+/*
+    rawReadFrames - add up the content sizes of a zstd or lz4 file's
+                    frames
+*/
+
+static int rawReadFrames(int fd, rawSize_t *raw)
+{
+    unsigned char head[12];
+    uint64_t size = 0;
+    uint64_t frameSize = 0;
+    uint32_t magic = 0;
+    uint32_t skipLen = 0;
+    uint32_t hint = 0;
+    uint32_t numBlocks = 0;
+    off_t offset = 0;
+    off_t end = 0;
+    int r = gRawSizeErr;
+
+    while (offset < raw->fileSize)
+    {
+        memset(head, 0, sizeof(head));
+        if (rawReadAt(fd, raw, head, sizeof(head), offset) < 4)
+        {
+            return gRawSizeErr;
+        }
+
+        magic = rawGet32(head);
+
+        /*
+            skip skippable frames, but keep the size of the frame
+            after it from the one that pzstd writes
+        */
+
+        if ((magic & RAWSKIPMASK) == RAWSKIPMAGIC)
+        {
+            skipLen = rawGet32(head + 4);
+            hint = 0;
+            if (magic == RAWSKIPMAGIC && skipLen == 4 &&
+                raw->format == RawFormatZstd)
+            {
+                hint = rawGet32(head + 8);
+            }
+            offset += 8 + (off_t)skipLen;
+            continue;
+        }
+
+        if (raw->numStreams >= RAWMAXFRAMES)
+        {
+            return gRawSizeErr;
+        }
+
+        if (magic == RAWZSTDMAGIC && raw->format == RawFormatZstd)
+        {
+            r = rawZstdFrame(fd,
+                             raw,
+                             offset,
+                             hint,
+                             &numBlocks,
+                             &end,
+                             &frameSize);
+        }
+        else if (magic == RAWLZ4MAGIC && raw->format == RawFormatLZ4)
+        {
+            r = rawLZ4Frame(fd, raw, offset, &numBlocks, &end, &frameSize);
+        }
+        else
+        {
+            r = gRawSizeErr;
+        }
+
+        if (r != gRawSizeOkay || (end != 0 && end <= offset))
+        {
+            return gRawSizeErr;
+        }
+
+        size += frameSize;
+        raw->numStreams++;
+        hint = 0;
+
+        /* a frame too long to walk is taken to be the last */
+
+        if (end == 0)
+        {
+            break;
+        }
+
+        offset = end;
+    }
+
+    if (offset > raw->fileSize || raw->numStreams == 0)
+    {
+        return gRawSizeErr;
+    }
+
+    raw->size = size;
+    raw->hasSize = 1;
+
+    return gRawSizeOkay;
+}
+
+/* rawAddMark - add the bit offset of a bzip2 block or end of stream */
+
+static int rawAddMark(rawBZip2Marks_t *found, uint64_t mark)
+{
+    uint64_t *marks = NULL;
+    size_t maxMarks = 0;
+
+    if (found->numMarks == found->maxMarks)
+    {
+        maxMarks = (found->maxMarks == 0 ? 64 : found->maxMarks * 2);
+        marks = realloc(found->marks, maxMarks * sizeof(uint64_t));
+        if (marks == NULL)
+        {
+            return gRawSizeErr;
+        }
+        found->marks = marks;
+        found->maxMarks = maxMarks;
+    }
+
+    found->marks[found->numMarks++] = mark;
+
+    return gRawSizeOkay;
+}
+
+/*
+    rawBZip2Scan - find the block and end of stream magic numbers,
+                   which are not byte aligned, that start in a
+                   thread's share of a bzip2 file; each is marked with
+                   its bit offset times 2, plus 1 for an end of stream
+*/
+
+static void *rawBZip2Scan(void *arg)
+{
+    rawBZip2Job_t *job = arg;
+    uint64_t window = 0;
+    uint64_t bits = 0;
+    size_t i = 0;
+    size_t j = 0;
+    unsigned int k = 0;
+
+    /* the window holds the 8 bytes from i, the first 7 to start */
+
+    for (j = job->start; j < job->start + 7; j++)
+    {
+        window = (window << 8) | (j < job->len ? job->buf[j] : 0);
+    }
+
+    for (i = job->start; i < job->end; i++)
+    {
+        if ((i & 0xFFFF) == 0 && *job->failed)
+        {
+            return NULL;
+        }
+
+        window = (window << 8) |
+                 (i + 7 < job->len ? job->buf[i + 7] : 0);
+
+        for (k = 0; k < 8; k++)
+        {
+            bits = (window >> (16 - k)) & 0xFFFFFFFFFFFFULL;
+            if (bits != RAWBZIP2BLOCK && bits != RAWBZIP2END)
+            {
+                continue;
+            }
+            if (rawAddMark(&job->found,
+                           (((uint64_t)i * 8 + k) << 1) |
+                           (bits == RAWBZIP2END ? 1 : 0)) != gRawSizeOkay)
+            {
+                job->err = 1;
+                *job->failed = 1;
+                return NULL;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/*
+    rawCopyBits - copy numBits bits, starting at bit srcBit of src, to
+                  the start of dst
+*/
+
+static void rawCopyBits(unsigned char *dst,
+                        const unsigned char *src,
+                        size_t srcLen,
+                        uint64_t srcBit,
+                        uint64_t numBits)
+{
+    size_t byte = (size_t)(srcBit >> 3);
+    size_t numBytes = (size_t)((numBits + 7) >> 3);
+    unsigned int shift = (unsigned int)(srcBit & 7);
+    unsigned int v = 0;
+    size_t i = 0;
+
+    for (i = 0; i < numBytes; i++)
+    {
+        v = (unsigned int)src[byte + i] << shift;
+        if (shift != 0 && byte + i + 1 < srcLen)
+        {
+            v |= src[byte + i + 1] >> (8 - shift);
+        }
+        dst[i] = (unsigned char)v;
+    }
+
+    if ((numBits & 7) != 0)
+    {
+        dst[numBytes - 1] &= (unsigned char)(0xFF << (8 - (numBits & 7)));
+    }
+}
+
+/* rawPutBits - put the low numBits bits of value at bit dstBit of dst */
+
+static void rawPutBits(unsigned char *dst,
+                       uint64_t dstBit,
+                       uint64_t value,
+                       unsigned int numBits)
+{
+    unsigned int i = 0;
+    unsigned int bit = 0;
+
+    for (i = 0; i < numBits; i++, dstBit++)
+    {
+        bit = (unsigned int)(value >> (numBits - 1 - i)) & 1;
+        if (bit != 0)
+        {
+            dst[dstBit >> 3] |= (unsigned char)(0x80 >> (dstBit & 7));
+        }
+        else
+        {
+            dst[dstBit >> 3] &= (unsigned char)~(0x80 >> (dstBit & 7));
+        }
+    }
+}
+
+/*
+    rawBZip2Block - decode the block between bits start and end of a
+                    bzip2 file as a stream of its own, a stream header,
+                    the block and an end of stream, whose CRC is the
+                    block's, and count its bytes
+*/
+
+static int rawBZip2Block(const unsigned char *buf,
+                         size_t len,
+                         uint64_t start,
+                         uint64_t end,
+                         uint64_t *size)
+{
+    bz_stream bz;
+    unsigned char out[RAWBZIP2OUTLEN];
+    unsigned char *stream = NULL;
+    uint64_t numBits = end - start;
+    uint64_t crc = 0;
+    size_t streamLen = 0;
+    int r = BZ_OK;
+    int ret = gRawSizeErr;
+
+    /* the block's magic number and CRC */
+
+    if (numBits < 80)
+    {
+        return gRawSizeErr;
+    }
+
+    streamLen = RAWBZIP2HEADERLEN + (size_t)((numBits + 80 + 7) >> 3);
+    stream = calloc(1, streamLen);
+    if (stream == NULL)
+    {
+        return gRawSizeErr;
+    }
+
+    memcpy(stream, "BZh9", RAWBZIP2HEADERLEN);
+    rawCopyBits(stream + RAWBZIP2HEADERLEN, buf, len, start, numBits);
+    rawCopyBits(out, buf, len, start + 48, 32);
+    crc = ((uint64_t)out[0] << 24) | ((uint64_t)out[1] << 16) |
+          ((uint64_t)out[2] << 8) | (uint64_t)out[3];
+    rawPutBits(stream,
+               RAWBZIP2HEADERLEN * 8 + numBits,
+               RAWBZIP2END,
+               48);
+    rawPutBits(stream,
+               RAWBZIP2HEADERLEN * 8 + numBits + 48,
+               crc,
+               32);
+
+    memset(&bz, 0, sizeof(bz));
+    if (BZ2_bzDecompressInit(&bz, 0, 0) != BZ_OK)
+    {
+        free(stream);
+        return gRawSizeErr;
+    }
+
+    bz.next_in = (char *)stream;
+    bz.avail_in = (unsigned int)streamLen;
+
+    do
+    {
+        bz.next_out = (char *)out;
+        bz.avail_out = sizeof(out);
+        r = BZ2_bzDecompress(&bz);
+        *size += sizeof(out) - bz.avail_out;
+    } while (r == BZ_OK && (bz.avail_in > 0 || bz.avail_out == 0));
+
+    if (r == BZ_STREAM_END)
+    {
+        ret = gRawSizeOkay;
+    }
+
+    BZ2_bzDecompressEnd(&bz);
+    free(stream);
+
+    return ret;
+}
+
+/* rawBZip2Decode - decode every step'th block, from the first */
+
+static void *rawBZip2Decode(void *arg)
+{
+    rawBZip2Job_t *job = arg;
+    size_t i = 0;
+
+    for (i = job->first; i < job->numMarks; i += job->step)
+    {
+        if (*job->failed)
+        {
+            return NULL;
+        }
+
+        /* blocks end where the next block, or the stream, does */
+
+        if ((job->marks[i] & 1) != 0)
+        {
+            continue;
+        }
+
+        if (i + 1 >= job->numMarks ||
+            rawBZip2Block(job->buf,
+                          job->len,
+                          job->marks[i] >> 1,
+                          job->marks[i + 1] >> 1,
+                          &job->size) != gRawSizeOkay)
+        {
+            job->err = 1;
+            *job->failed = 1;
+            return NULL;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+    rawBZip2Run - run func on each job, in a thread of its own if
+                  possible, and wait for them
+*/
+
+static int rawBZip2Run(rawBZip2Job_t *jobs,
+                       unsigned int numJobs,
+                       void *(*func)(void *))
+{
+    pthread_t threads[RAWMAXTHREADS];
+    int started[RAWMAXTHREADS];
+    unsigned int i = 0;
+    int ret = gRawSizeOkay;
+
+    for (i = 1; i < numJobs; i++)
+    {
+        started[i] = (pthread_create(&threads[i], NULL, func, &jobs[i]) == 0);
+    }
+
+    /* this thread takes the first job, and any that didn't start */
+
+    func(&jobs[0]);
+    for (i = 1; i < numJobs; i++)
+    {
+        if (started[i])
+        {
+            pthread_join(threads[i], NULL);
+        }
+        else
+        {
+            func(&jobs[i]);
+        }
+    }
+
+    for (i = 0; i < numJobs; i++)
+    {
+        if (jobs[i].err)
+        {
+            ret = gRawSizeErr;
+        }
+    }
+
+    return ret;
+}
+
+/*
+    rawReadBZip2 - get a bzip2 file's uncompressed size by decoding
+                   its blocks in parallel
+*/
+
+static int rawReadBZip2(int fd, rawSize_t *raw)
+{
+    rawBZip2Job_t jobs[RAWMAXTHREADS];
+    unsigned char *buf = NULL;
+    uint64_t *marks = NULL;
+    volatile int failed = 0;
+    size_t len = 0;
+    size_t chunk = 0;
+    size_t numMarks = 0;
+    size_t i = 0;
+    long numCPUs = 0;
+    unsigned int numJobs = 1;
+    unsigned int j = 0;
+    int ret = gRawSizeErr;
+
+    if (raw->fileSize > RAWMAXBZIP2)
+    {
+        return gRawSizeErr;
+    }
+
+    len = (size_t)raw->fileSize;
+    buf = malloc(len);
+    if (buf == NULL || rawReadAt(fd, raw, buf, len, 0) != (ssize_t)len)
+    {
+        free(buf);
+        return gRawSizeErr;
+    }
+
+    numCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+    if (numCPUs > 1)
+    {
+        numJobs = (numCPUs > RAWMAXTHREADS ?
+                   RAWMAXTHREADS : (unsigned int)numCPUs);
+    }
+    if (numJobs > len / RAWBZIP2MINSCAN + 1)
+    {
+        numJobs = (unsigned int)(len / RAWBZIP2MINSCAN + 1);
+    }
+
+    memset(jobs, 0, sizeof(jobs));
+    chunk = (len + numJobs - 1) / numJobs;
+    for (j = 0; j < numJobs; j++)
+    {
+        jobs[j].buf = buf;
+        jobs[j].len = len;
+        jobs[j].start = (size_t)j * chunk;
+        jobs[j].end = (jobs[j].start + chunk < len ?
+                       jobs[j].start + chunk : len);
+        if (jobs[j].start > len)
+        {
+            jobs[j].start = len;
+        }
+        jobs[j].failed = &failed;
+    }
+
+    /* find the blocks */
+
+    if (rawBZip2Run(jobs, numJobs, rawBZip2Scan) != gRawSizeOkay)
+    {
+        goto done;
+    }
+
+    for (j = 0; j < numJobs; j++)
+    {
+        numMarks += jobs[j].found.numMarks;
+    }
+    if (numMarks == 0)
+    {
+        goto done;
+    }
+
+    marks = malloc(numMarks * sizeof(uint64_t));
+    if (marks == NULL)
+    {
+        goto done;
+    }
+    for (numMarks = 0, j = 0; j < numJobs; j++)
+    {
+        for (i = 0; i < jobs[j].found.numMarks; i++)
+        {
+            marks[numMarks++] = jobs[j].found.marks[i];
+        }
+    }
+
+    /* the streams must end */
+
+    if ((marks[numMarks - 1] & 1) == 0)
+    {
+        goto done;
+    }
+
+    /* and decode them */
+
+    for (j = 0; j < numJobs; j++)
+    {
+        jobs[j].marks = marks;
+        jobs[j].numMarks = numMarks;
+        jobs[j].first = j;
+        jobs[j].step = numJobs;
+    }
+
+    if (rawBZip2Run(jobs, numJobs, rawBZip2Decode) != gRawSizeOkay)
+    {
+        goto done;
+    }
+
+    raw->size = 0;
+    for (j = 0; j < numJobs; j++)
+    {
+        raw->size += jobs[j].size;
+    }
+    for (i = 0; i < numMarks; i++)
+    {
+        if ((marks[i] & 1) != 0)
+        {
+            raw->numStreams++;
+        }
+    }
+    raw->hasSize = 1;
+    ret = gRawSizeOkay;
+
+done:
+    for (j = 0; j < numJobs; j++)
+    {
+        free(jobs[j].found.marks);
+    }
+    free(marks);
+    free(buf);
+
+    return ret;
+}
+
+/* public functions */
+
+/*
+    rawSizeGetFormat - get the format of a compressed file from its
+                       magic number
+*/
+
+rawFormat_t rawSizeGetFormat(const char *path)
+{
+    struct stat st;
+    rawFormat_t format = RawFormatUnknown;
+    int fd = -1;
+
+    if (path == NULL)
+    {
+        return RawFormatUnknown;
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return RawFormatUnknown;
+    }
+
+    if (fstat(fd, &st) == 0)
+    {
+        format = rawGetFormat(fd, st.st_size);
+    }
+
+    close(fd);
+
+    return format;
+}
+
+/*
+    rawSizeRead - get the format and uncompressed size of the
+                  compressed file at path
+*/
+
+int rawSizeRead(const char *path, rawSize_t *raw)
+{
+    struct stat st;
+    int fd = -1;
+    int ret = gRawSizeErr;
+
+    if (path == NULL || raw == NULL)
+    {
+        return gRawSizeErr;
+    }
+
+    memset(raw, 0, sizeof(rawSize_t));
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return gRawSizeErr;
+    }
+
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        close(fd);
+        return gRawSizeErr;
+    }
+
+    raw->fileSize = st.st_size;
+    raw->format = rawGetFormat(fd, raw->fileSize);
+
+    switch (raw->format)
+    {
+        case RawFormatGZip:
+            ret = rawReadGZip(fd, raw);
+            break;
+        case RawFormatXZ:
+            ret = rawReadXZ(fd, raw);
+            break;
+        case RawFormatZstd:
+            ret = rawReadSeekTable(fd, raw);
+            if (ret != gRawSizeOkay)
+            {
+                raw->numStreams = 0;
+                ret = rawReadFrames(fd, raw);
+            }
+            break;
+        case RawFormatLZ4:
+            ret = rawReadFrames(fd, raw);
+            break;
+        case RawFormatBZip2:
+            ret = rawReadBZip2(fd, raw);
+            break;
+        default:
+            ret = gRawSizeErr;
+            break;
+    }
+
+    close(fd);
+
+    if (ret != gRawSizeOkay)
+    {
+        raw->size = 0;
+        raw->hasSize = 0;
+    }
+
+    return ret;
+}
+
+/* rawSizeFormatName - get a format's name */
+
+const char *rawSizeFormatName(rawFormat_t format)
+{
+    if (format < RawFormatUnknown || format >= RawFormatMax)
+    {
+        format = RawFormatUnknown;
+    }
+
+    return gRawFormatNames[format];
+}
+
+/* rawSizeExtension - get a format's file extension */
+
+const char *rawSizeExtension(rawFormat_t format)
+{
+    if (format < RawFormatUnknown || format >= RawFormatMax)
+    {
+        format = RawFormatUnknown;
+    }
+
+    return gRawExtensions[format];
+}
@@ -0,0 +1,117 @@
+/*
+    rawsize.h - get the uncompressed size of a compressed file
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    A file that is a single compressed stream, and not an archive, is
+    previewed as one row, and rawSizeRead() gets the row's size from
+    what the format records about it, without decompressing the file:
+
+        - gzip: the last 4 bytes (ISIZE), the uncompressed size of
+          the last member modulo 4GB.
+        - xz: the index at the end of each stream, found from the
+          stream footer, walking back over the streams (and their
+          padding) to the start of the file, up to RAWMAXSTREAMS
+          streams with indexes of no more than RAWMAXINDEX bytes.
+        - zstd: the seek table of a seekable file, if it has one, or
+          else each frame's content size.  A frame's end is found
+          from the skippable frame that pzstd writes ahead of it, or
+          by walking its block headers, up to RAWMAXBLOCKS of them
+          in all; a frame that is longer than that is taken to be the
+          last one, as it is in a file written by zstd.
+        - lz4: each frame's content size, with the frames' ends found
+          as for zstd.  Frames without a content size (which the lz4
+          tool doesn't write unless asked to) have no size.
+        - bzip2: which records no size, but whose blocks can be
+          found by their magic number and decoded on their own: a file
+          of no more than RAWMAXBZIP2 bytes is read, and its blocks
+          are found and decoded by up to RAWMAXTHREADS threads at
+          once, counting the bytes and keeping none of them.  Larger
+          files have no size.
+
+    Files in other formats (and zstd or lz4 frames without a content
+    size, and legacy lz4 files) have no size (see hasSize), and
+    gRawSizeErr is returned.
+*/
+
+#ifndef qlZipInfo_rawsize_h
+#define qlZipInfo_rawsize_h
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/* return codes */
+
+enum
+{
+    gRawSizeErr  = -1,
+    gRawSizeOkay =  0,
+};
+
+/* read budget */
+
+#define RAWMAXSTREAMS 1024
+#define RAWMAXINDEX   (16 * 1024 * 1024)
+#define RAWMAXBLOCKS  4096
+#define RAWMAXFRAMES  (1024 * 1024)
+#define RAWMAXBZIP2   (16 * 1024 * 1024)
+#define RAWMAXTHREADS 8
+
+/* formats */
+
+typedef enum
+{
+    RawFormatUnknown = 0,
+    RawFormatGZip,
+    RawFormatBZip2,
+    RawFormatXZ,
+    RawFormatZstd,
+    RawFormatLZ4,
+    RawFormatMax,
+} rawFormat_t;
+
+/* a compressed file's size */
+
+typedef struct rawSize
+{
+    rawFormat_t format;
+    off_t fileSize;
+    uint64_t size;
+    int hasSize;
+    uint32_t numStreams;
+    uint64_t bytesRead;
+} rawSize_t;
+
+/* prototypes */
+
+rawFormat_t rawSizeGetFormat(const char *path);
+int rawSizeRead(const char *path, rawSize_t *raw);
+const char *rawSizeFormatName(rawFormat_t format);
+const char *rawSizeExtension(rawFormat_t format);
+
+#endif /* qlZipInfo_rawsize_h */
@@ -0,0 +1,816 @@
+/*
+    records.c - structured (NDJSON / CBOR) listing output
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    Newline Delimited JSON
+    https://github.com/ndjson/ndjson-spec
+
+    RFC 8949 - Concise Binary Object Representation (CBOR)
+    https://www.rfc-editor.org/rfc/rfc8949
+
+    RFC 8742 - Concise Binary Object Representation (CBOR) Sequences
+    https://www.rfc-editor.org/rfc/rfc8742
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "records.h"
+
+/* defines */
+
+/* CBOR major types (RFC 8949, section 3.1) */
+
+#define RECCBORUINT  0
+#define RECCBORNINT  1
+#define RECCBORBYTES 2
+#define RECCBORTEXT  3
+#define RECCBORMAP   5
+
+/* CBOR simple values (RFC 8949, section 3.3) */
+
+#define RECCBORFALSE 0xf4
+#define RECCBORTRUE  0xf5
+#define RECCBORNULL  0xf6
+
+/* structs */
+
+typedef struct recState
+{
+    char path[PATH_MAX];
+    recWriter_t writer;
+} recState_t;
+
+/* globals */
+
+__thread int gRecEnabled = 0;
+
+static __thread recState_t *gRecState = NULL;
+static unsigned long gRecSeq = 0;
+
+static const char *gRecTypeNames[RecTypeMax] =
+{
+    "file",
+    "dir",
+    "link",
+    "special",
+};
+
+static const char *gRecFormatExtensions[RecFormatMax] =
+{
+    "ndjson",
+    "cbor",
+};
+
+static const char gRecHexDigits[] = "0123456789abcdef";
+
+/* private functions */
+
+static int recWriteOut(recWriter_t *writer, size_t len);
+static int recSpill(recWriter_t *writer);
+static int recPutBytes(recWriter_t *writer, const void *data, size_t len);
+static int recPutString(recWriter_t *writer, const char *str);
+static int recPutInt(recWriter_t *writer, int64_t value);
+static size_t recUTF8Len(const unsigned char *str, size_t len);
+static int recIsUTF8(const unsigned char *str, size_t len);
+static int recPutJSONString(recWriter_t *writer, const char *str);
+static int recAppendJSON(recWriter_t *writer, const recEntry_t *entry);
+static int recPutCBORHead(recWriter_t *writer,
+                          unsigned int major,
+                          uint64_t value);
+static int recPutCBORText(recWriter_t *writer, const char *str);
+static int recPutCBORInt(recWriter_t *writer, int64_t value);
+static int recAppendCBOR(recWriter_t *writer, const recEntry_t *entry);
+
+/*
+    recWriteOut - write out the first len bytes of the buffer, and
+                  move the rest to the start of the buffer
+*/
+
+static int recWriteOut(recWriter_t *writer, size_t len)
+{
+    size_t off = 0;
+    ssize_t n = 0;
+
+    while (off < len)
+    {
+        n = write(writer->fd, writer->buf + off, len - off);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            writer->err = errno;
+            return gRecErr;
+        }
+        off += (size_t)n;
+    }
+
+    if (len < writer->len)
+    {
+        memmove(writer->buf, writer->buf + len, writer->len - len);
+    }
+
+    writer->bytesWritten += len;
+    writer->len -= len;
+    writer->mark = (writer->mark > len ? writer->mark - len : 0);
+
+    return gRecOkay;
+}
+
+/*
+    recSpill - make room in a full buffer by writing out the whole
+               records in it, so that each write() only has whole
+               records, unless one record fills the buffer
+*/
+
+static int recSpill(recWriter_t *writer)
+{
+    if (writer->err != 0)
+    {
+        return gRecErr;
+    }
+
+    return recWriteOut(writer,
+                       (writer->mark > 0 ? writer->mark : writer->len));
+}
+
+/* recPutByte - add one byte to the buffer, writing it out if full */
+
+#define recPutByte(writer, byte)                                   \
+    (((writer)->len < RECBUFSIZE ||                                \
+      recSpill(writer) == gRecOkay) ?                              \
+     ((writer)->buf[(writer)->len++] = (unsigned char)(byte),      \
+      gRecOkay) : gRecErr)
+
+/* recPutLiteral - add a string literal */
+
+#define recPutLiteral(writer, str) \
+    recPutBytes((writer), (str), sizeof(str) - 1)
+
+/* recPutBytes - add len bytes to the buffer, writing it out as it fills */
+
+static int recPutBytes(recWriter_t *writer, const void *data, size_t len)
+{
+    const unsigned char *src = (const unsigned char *)data;
+    size_t chunk = 0;
+
+    while (len > 0)
+    {
+        if (writer->len == RECBUFSIZE &&
+            recSpill(writer) != gRecOkay)
+        {
+            return gRecErr;
+        }
+
+        chunk = RECBUFSIZE - writer->len;
+        if (chunk > len)
+        {
+            chunk = len;
+        }
+
+        memcpy(writer->buf + writer->len, src, chunk);
+        writer->len += chunk;
+        src += chunk;
+        len -= chunk;
+    }
+
+    return gRecOkay;
+}
+
+/* recPutString - add a nul terminated string without escaping it */
+
+static int recPutString(recWriter_t *writer, const char *str)
+{
+    return recPutBytes(writer, str, strlen(str));
+}
+
+/* recPutInt - add a decimal integer */
+
+static int recPutInt(recWriter_t *writer, int64_t value)
+{
+    char digits[24];
+    uint64_t magnitude = 0;
+    size_t i = sizeof(digits);
+
+    magnitude = (value < 0 ? (uint64_t)0 - (uint64_t)value :
+                             (uint64_t)value);
+
+    do
+    {
+        digits[--i] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (value < 0)
+    {
+        digits[--i] = '-';
+    }
+
+    return recPutBytes(writer, digits + i, sizeof(digits) - i);
+}
+
+/*
+    recUTF8Len - returns the length of the UTF-8 sequence at the start
+                 of str, or 0 if it is not a valid (shortest form,
+                 non-surrogate) sequence
+*/
+
+static size_t recUTF8Len(const unsigned char *str, size_t len)
+{
+    uint32_t codePoint = 0;
+    size_t seqLen = 0;
+    size_t i = 0;
+
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    if (str[0] < 0x80)
+    {
+        return 1;
+    }
+    else if ((str[0] & 0xe0) == 0xc0)
+    {
+        seqLen = 2;
+        codePoint = str[0] & 0x1f;
+    }
+    else if ((str[0] & 0xf0) == 0xe0)
+    {
+        seqLen = 3;
+        codePoint = str[0] & 0x0f;
+    }
+    else if ((str[0] & 0xf8) == 0xf0)
+    {
+        seqLen = 4;
+        codePoint = str[0] & 0x07;
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (seqLen > len)
+    {
+        return 0;
+    }
+
+    for (i = 1; i < seqLen; i++)
+    {
+        if ((str[i] & 0xc0) != 0x80)
+        {
+            return 0;
+        }
+        codePoint = (codePoint << 6) | (str[i] & 0x3f);
+    }
+
+    if ((seqLen == 2 && codePoint < 0x80) ||
+        (seqLen == 3 && codePoint < 0x800) ||
+        (seqLen == 4 && codePoint < 0x10000) ||
+        codePoint > 0x10ffff ||
+        (codePoint >= 0xd800 && codePoint <= 0xdfff))
+    {
+        return 0;
+    }
+
+    return seqLen;
+}
+
+/* recIsUTF8 - returns 1 if str is valid UTF-8 */
+
+static int recIsUTF8(const unsigned char *str, size_t len)
+{
+    size_t seqLen = 0;
+
+    while (len > 0)
+    {
+        if (*str < 0x80)
+        {
+            str++;
+            len--;
+            continue;
+        }
+
+        seqLen = recUTF8Len(str, len);
+        if (seqLen == 0)
+        {
+            return 0;
+        }
+        str += seqLen;
+        len -= seqLen;
+    }
+
+    return 1;
+}
+
+/*
+    recPutJSONString - add a quoted, escaped JSON string; bytes that
+                       are not valid UTF-8 are written as the Latin-1
+                       character with the same value, so that the
+                       output is always valid JSON
+*/
+
+static int recPutJSONString(recWriter_t *writer, const char *str)
+{
+    const unsigned char *src = (const unsigned char *)str;
+    const unsigned char *run = NULL;
+    size_t len = strlen(str);
+    size_t seqLen = 0;
+    char escape[6];
+
+    if (recPutByte(writer, '"') != gRecOkay)
+    {
+        return gRecErr;
+    }
+
+    while (len > 0)
+    {
+        /* copy runs of characters that don't need escaping at once */
+
+        run = src;
+        while (len > 0 && *src >= 0x20 && *src < 0x80 &&
+               *src != '"' && *src != '\\')
+        {
+            src++;
+            len--;
+        }
+
+        if (src > run &&
+            recPutBytes(writer, run, (size_t)(src - run)) != gRecOkay)
+        {
+            return gRecErr;
+        }
+
+        if (len == 0)
+        {
+            break;
+        }
+
+        if (*src >= 0x80)
+        {
+            seqLen = recUTF8Len(src, len);
+            if (seqLen > 0)
+            {
+                if (recPutBytes(writer, src, seqLen) != gRecOkay)
+                {
+                    return gRecErr;
+                }
+                src += seqLen;
+                len -= seqLen;
+                continue;
+            }
+        }
+
+        escape[0] = '\\';
+
+        switch (*src)
+        {
+            case '"':
+            case '\\':
+                escape[1] = (char)*src;
+                seqLen = 2;
+                break;
+            case '\n':
+                escape[1] = 'n';
+                seqLen = 2;
+                break;
+            case '\r':
+                escape[1] = 'r';
+                seqLen = 2;
+                break;
+            case '\t':
+                escape[1] = 't';
+                seqLen = 2;
+                break;
+            default:
+                escape[1] = 'u';
+                escape[2] = '0';
+                escape[3] = '0';
+                escape[4] = gRecHexDigits[*src >> 4];
+                escape[5] = gRecHexDigits[*src & 0x0f];
+                seqLen = 6;
+                break;
+        }
+
+        if (recPutBytes(writer, escape, seqLen) != gRecOkay)
+        {
+            return gRecErr;
+        }
+
+        src++;
+        len--;
+    }
+
+    return recPutByte(writer, '"');
+}
+
+/* recAppendJSON - add an entry as one line of JSON */
+
+static int recAppendJSON(recWriter_t *writer, const recEntry_t *entry)
+{
+    int err = gRecOkay;
+
+    if (entry->archive != NULL)
+    {
+        err |= recPutLiteral(writer, "{\"archive\":");
+        err |= recPutJSONString(writer, entry->archive);
+        err |= recPutLiteral(writer, ",\"path\":");
+    }
+    else
+    {
+        err |= recPutLiteral(writer, "{\"path\":");
+    }
+    err |= recPutJSONString(writer, entry->path);
+    err |= recPutLiteral(writer, ",\"type\":\"");
+    err |= recPutString(writer, gRecTypeNames[entry->type]);
+
+    err |= recPutLiteral(writer, "\",\"size\":");
+    if (entry->hasSize)
+    {
+        err |= recPutInt(writer, entry->size);
+    }
+    else
+    {
+        err |= recPutLiteral(writer, "null");
+    }
+
+    err |= recPutLiteral(writer, ",\"csize\":");
+    if (entry->hasCompressedSize)
+    {
+        err |= recPutInt(writer, entry->compressedSize);
+    }
+    else
+    {
+        err |= recPutLiteral(writer, "null");
+    }
+
+    err |= recPutLiteral(writer, ",\"mtime\":");
+    if (entry->hasMtime)
+    {
+        err |= recPutInt(writer, entry->mtime);
+    }
+    else
+    {
+        err |= recPutLiteral(writer, "null");
+    }
+
+    err |= recPutLiteral(writer, ",\"encrypted\":");
+    err |= (entry->encrypted ?
+            recPutLiteral(writer, "true") :
+            recPutLiteral(writer, "false"));
+    err |= recPutLiteral(writer, ",\"depth\":");
+    err |= recPutInt(writer, entry->depth);
+
+    if (entry->link != NULL)
+    {
+        err |= recPutLiteral(writer, ",\"link\":");
+        err |= recPutJSONString(writer, entry->link);
+    }
+
+    if (entry->macType != NULL && entry->macCreator != NULL)
+    {
+        err |= recPutLiteral(writer, ",\"macType\":");
+        err |= recPutJSONString(writer, entry->macType);
+        err |= recPutLiteral(writer, ",\"macCreator\":");
+        err |= recPutJSONString(writer, entry->macCreator);
+    }
+
+    err |= recPutLiteral(writer, "}\n");
+
+    return (err == gRecOkay ? gRecOkay : gRecErr);
+}
+
+/* recPutCBORHead - add the initial bytes of a CBOR data item */
+
+static int recPutCBORHead(recWriter_t *writer,
+                          unsigned int major,
+                          uint64_t value)
+{
+    unsigned char head[9];
+    size_t len = 0;
+    int shift = 0;
+
+    major <<= 5;
+
+    if (value < 24)
+    {
+        head[0] = (unsigned char)(major | value);
+        return recPutBytes(writer, head, 1);
+    }
+
+    if (value <= 0xff)
+    {
+        head[0] = (unsigned char)(major | 24);
+        len = 1;
+    }
+    else if (value <= 0xffff)
+    {
+        head[0] = (unsigned char)(major | 25);
+        len = 2;
+    }
+    else if (value <= 0xffffffffULL)
+    {
+        head[0] = (unsigned char)(major | 26);
+        len = 4;
+    }
+    else
+    {
+        head[0] = (unsigned char)(major | 27);
+        len = 8;
+    }
+
+    /* the argument is big endian */
+
+    for (shift = (int)(len - 1) * 8; shift >= 0; shift -= 8)
+    {
+        head[len - (size_t)(shift / 8)] = (unsigned char)(value >> shift);
+    }
+
+    return recPutBytes(writer, head, len + 1);
+}
+
+/* recPutCBORText - add a text string, or a byte string if not UTF-8 */
+
+static int recPutCBORText(recWriter_t *writer, const char *str)
+{
+    size_t len = strlen(str);
+    unsigned int major = RECCBORTEXT;
+
+    if (recIsUTF8((const unsigned char *)str, len) == 0)
+    {
+        major = RECCBORBYTES;
+    }
+
+    if (recPutCBORHead(writer, major, len) != gRecOkay)
+    {
+        return gRecErr;
+    }
+
+    return recPutBytes(writer, str, len);
+}
+
+/* recPutCBORInt - add a signed integer */
+
+static int recPutCBORInt(recWriter_t *writer, int64_t value)
+{
+    if (value < 0)
+    {
+        return recPutCBORHead(writer,
+                              RECCBORNINT,
+                              (uint64_t)(-1 - value));
+    }
+
+    return recPutCBORHead(writer, RECCBORUINT, (uint64_t)value);
+}
+
+/* recAppendCBOR - add an entry as a CBOR map */
+
+static int recAppendCBOR(recWriter_t *writer, const recEntry_t *entry)
+{
+    int hasMac = (entry->macType != NULL && entry->macCreator != NULL);
+    int err = gRecOkay;
+
+    err |= recPutCBORHead(writer,
+                          RECCBORMAP,
+                          7 + (hasMac ? 2 : 0) +
+                          (entry->link != NULL ? 1 : 0) +
+                          (entry->archive != NULL ? 1 : 0));
+
+    if (entry->archive != NULL)
+    {
+        err |= recPutLiteral(writer, "\147" "archive");
+        err |= recPutCBORText(writer, entry->archive);
+    }
+
+    err |= recPutLiteral(writer, "\144" "path");
+    err |= recPutCBORText(writer, entry->path);
+    err |= recPutLiteral(writer, "\144" "type");
+    err |= recPutCBORHead(writer,
+                          RECCBORTEXT,
+                          strlen(gRecTypeNames[entry->type]));
+    err |= recPutString(writer, gRecTypeNames[entry->type]);
+
+    err |= recPutLiteral(writer, "\144" "size");
+    err |= (entry->hasSize ?
+            recPutCBORInt(writer, entry->size) :
+            recPutByte(writer, RECCBORNULL));
+
+    err |= recPutLiteral(writer, "\145" "csize");
+    err |= (entry->hasCompressedSize ?
+            recPutCBORInt(writer, entry->compressedSize) :
+            recPutByte(writer, RECCBORNULL));
+
+    err |= recPutLiteral(writer, "\145" "mtime");
+    err |= (entry->hasMtime ?
+            recPutCBORInt(writer, entry->mtime) :
+            recPutByte(writer, RECCBORNULL));
+
+    err |= recPutLiteral(writer, "\151" "encrypted");
+    err |= recPutByte(writer,
+                      (entry->encrypted ? RECCBORTRUE : RECCBORFALSE));
+
+    err |= recPutLiteral(writer, "\145" "depth");
+    err |= recPutCBORHead(writer, RECCBORUINT, entry->depth);
+
+    if (entry->link != NULL)
+    {
+        err |= recPutLiteral(writer, "\144" "link");
+        err |= recPutCBORText(writer, entry->link);
+    }
+
+    if (hasMac)
+    {
+        err |= recPutLiteral(writer, "\147" "macType");
+        err |= recPutCBORText(writer, entry->macType);
+        err |= recPutLiteral(writer, "\152" "macCreator");
+        err |= recPutCBORText(writer, entry->macCreator);
+    }
+
+    return (err == gRecOkay ? gRecOkay : gRecErr);
+}
+
+/* public functions */
+
+/* recWriterInit - initialize a writer for the file descriptor fd */
+
+int recWriterInit(recWriter_t *writer, int fd, recFormat_t format)
+{
+    if (writer == NULL || fd < 0 || format < 0 || format >= RecFormatMax)
+    {
+        return gRecErr;
+    }
+
+    writer->fd = fd;
+    writer->format = format;
+    writer->err = 0;
+    writer->len = 0;
+    writer->mark = 0;
+    writer->bytesWritten = 0;
+
+    return gRecOkay;
+}
+
+/*
+    recWriterAppend - add a record for entry; once a write fails, no
+                      more records are added
+*/
+
+int recWriterAppend(recWriter_t *writer, const recEntry_t *entry)
+{
+    int err = gRecOkay;
+
+    if (writer == NULL || writer->err != 0 || entry == NULL ||
+        entry->path == NULL || entry->type < 0 || entry->type >= RecTypeMax)
+    {
+        return gRecErr;
+    }
+
+    err = (writer->format == RecFormatCBOR ?
+           recAppendCBOR(writer, entry) :
+           recAppendJSON(writer, entry));
+
+    writer->mark = writer->len;
+
+    return err;
+}
+
+/* recWriterFlush - write out the buffered records */
+
+int recWriterFlush(recWriter_t *writer)
+{
+    if (writer == NULL || writer->err != 0)
+    {
+        return gRecErr;
+    }
+
+    return recWriteOut(writer, writer->len);
+}
+
+/*
+    recStart - start writing records on the current thread, if recDir
+               is not NULL or empty; format is "ndjson" (the default
+               if NULL) or "cbor"
+*/
+
+int recStart(const char *recDir, const char *format)
+{
+    recState_t *state = NULL;
+    recFormat_t recFormat = RecFormatNDJSON;
+    int fd = -1;
+
+    if (recDir == NULL || recDir[0] == '\0' || gRecState != NULL)
+    {
+        return gRecOkay;
+    }
+
+    if (format != NULL && strcasecmp(format, "cbor") == 0)
+    {
+        recFormat = RecFormatCBOR;
+    }
+
+    state = malloc(sizeof(recState_t));
+    if (state == NULL)
+    {
+        return gRecErr;
+    }
+
+    snprintf(state->path,
+             sizeof(state->path),
+             "%s/qlZipInfo-%d-%lu.%s",
+             recDir,
+             (int)getpid(),
+             __sync_fetch_and_add(&gRecSeq, 1),
+             gRecFormatExtensions[recFormat]);
+
+    fd = open(state->path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        fprintf(stderr,
+                "qlZipInfo: ERROR: cannot create records '%s'\n",
+                state->path);
+        free(state);
+        return gRecErr;
+    }
+
+    recWriterInit(&state->writer, fd, recFormat);
+
+    gRecState = state;
+    gRecEnabled = 1;
+
+    return gRecOkay;
+}
+
+/* recWrite - add a record to the current thread's output */
+
+int recWrite(const recEntry_t *entry)
+{
+    if (gRecState == NULL)
+    {
+        return gRecOkay;
+    }
+
+    return recWriterAppend(&gRecState->writer, entry);
+}
+
+/* recStop - stop writing records on the current thread */
+
+int recStop(void)
+{
+    recState_t *state = gRecState;
+    int err = gRecOkay;
+
+    if (state == NULL)
+    {
+        return gRecOkay;
+    }
+
+    gRecEnabled = 0;
+    gRecState = NULL;
+
+    if (recWriterFlush(&state->writer) != gRecOkay)
+    {
+        fprintf(stderr,
+                "qlZipInfo: ERROR: cannot write records '%s'\n",
+                state->path);
+        err = gRecErr;
+    }
+
+    close(state->writer.fd);
+    free(state);
+
+    return err;
+}
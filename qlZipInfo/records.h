@@ -0,0 +1,156 @@
+/*
+    records.h - structured (NDJSON / CBOR) listing output
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    Record output is off unless the environment variable
+    QLZIPINFO_RECORDS names a directory.  When it is on, each preview
+    also writes one record per entry, as it is listed, to:
+
+        $QLZIPINFO_RECORDS/qlZipInfo-<pid>-<n>.ndjson
+
+    or, if QLZIPINFO_RECORDS_FORMAT is "cbor", as a CBOR sequence
+    (RFC 8742) of maps to qlZipInfo-<pid>-<n>.cbor.  Each record has:
+
+        path       - the entry's name
+        type       - "file", "dir", "link" or "special"
+        size       - uncompressed size, or null if unknown
+        csize      - compressed size, or null if unknown
+        mtime      - modification time (seconds since 1970), or null
+        encrypted  - true if the entry is encrypted
+        depth      - 0 for the archive's own entries, 1 for the
+                     entries of an archive inside it, etc.
+        macType, macCreator - the Mac type and creator (hqx and sit
+                     only)
+
+    Records go through a fixed size buffer that is written to the
+    file descriptor whenever it fills, so memory use does not grow
+    with the number of entries.  Like tracing, the state is
+    per-thread, and each record costs one test of a thread local
+    flag when record output is off (see recIsEnabled()).
+
+    The writer (recWriter*) can also be used on its own with any
+    file descriptor.  It only writes whole records (unless a single
+    record is larger than its buffer), so several writers can share
+    one file opened with O_APPEND.
+*/
+
+#ifndef qlZipInfo_records_h
+#define qlZipInfo_records_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* return codes */
+
+enum
+{
+    gRecErr  = -1,
+    gRecOkay =  0,
+};
+
+/* size of the output buffer */
+
+#define RECBUFSIZE 65536
+
+/* output formats */
+
+typedef enum
+{
+    RecFormatNDJSON = 0,
+    RecFormatCBOR,
+    RecFormatMax,
+} recFormat_t;
+
+/* entry types */
+
+typedef enum
+{
+    RecTypeFile = 0,
+    RecTypeDir,
+    RecTypeLink,
+    RecTypeSpecial,
+    RecTypeMax,
+} recType_t;
+
+/* structs */
+
+/*
+    one entry; sizes and mtime are only written if their flag is set,
+    and archive (the path of the archive that has the entry, for an
+    index of many archives) and link (the path of the first link, for
+    a hard link) are only written if they are not NULL
+*/
+
+typedef struct recEntry
+{
+    const char *archive;
+    const char *path;
+    recType_t type;
+    int64_t size;
+    int64_t compressedSize;
+    int64_t mtime;
+    int hasSize;
+    int hasCompressedSize;
+    int hasMtime;
+    int encrypted;
+    unsigned int depth;
+    const char *link;
+    const char *macType;
+    const char *macCreator;
+} recEntry_t;
+
+/* writer */
+
+typedef struct recWriter
+{
+    int fd;
+    recFormat_t format;
+    int err;
+    size_t len;
+    size_t mark;
+    uint64_t bytesWritten;
+    unsigned char buf[RECBUFSIZE];
+} recWriter_t;
+
+/* set while records are being written on the current thread */
+
+extern __thread int gRecEnabled;
+
+#define recIsEnabled() (gRecEnabled != 0)
+
+/* prototypes */
+
+int recWriterInit(recWriter_t *writer, int fd, recFormat_t format);
+int recWriterAppend(recWriter_t *writer, const recEntry_t *entry);
+int recWriterFlush(recWriter_t *writer);
+int recStart(const char *recDir, const char *format);
+int recWrite(const recEntry_t *entry);
+int recStop(void);
+
+#endif /* qlZipInfo_records_h */
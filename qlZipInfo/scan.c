@@ -0,0 +1,832 @@
+/*
+    scan.c - list every archive under a directory
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+#include "archive.h"
+#include "archive_entry.h"
+
+#include "nested.h"
+#include "records.h"
+#include "scan.h"
+
+/* structs */
+
+/* a worker's queue of files, a ring of SCANQUEUELEN paths */
+
+typedef struct scanQueue
+{
+    pthread_mutex_t lock;
+    char *paths[SCANQUEUELEN];
+    unsigned int head;
+    unsigned int count;
+} scanQueue_t;
+
+typedef struct scanShared scanShared_t;
+
+/* a worker, with the buffers it reuses for every archive */
+
+typedef struct scanWorker
+{
+    scanShared_t *shared;
+    unsigned int index;
+    pthread_t thread;
+    int started;
+    scanQueue_t queue;
+    int fd;
+    unsigned char *buf;
+    struct archive_entry *entry;
+    recWriter_t *writer;
+    scanStats_t stats;
+} scanWorker_t;
+
+/* state shared by the walker and the workers */
+
+struct scanShared
+{
+    const scanOptions_t *options;
+    scanWorker_t *workers;
+    unsigned int numWorkers;
+
+    /*
+        queued is the number of files in all of the queues; the
+        workers sleep on hasWork when it is 0 and the walker sleeps on
+        notFull when every queue is full
+    */
+
+    pthread_mutex_t lock;
+    pthread_cond_t hasWork;
+    pthread_cond_t notFull;
+    unsigned int queued;
+    unsigned int idleWorkers;
+    unsigned int walkerWaiting;
+    int walkerDone;
+};
+
+/* private function prototypes */
+
+static int scanPush(scanShared_t *shared, unsigned int first, char *path);
+static char *scanPop(scanWorker_t *worker);
+static char *scanTake(scanWorker_t *worker);
+static void *scanWorkerMain(void *arg);
+static int scanListFile(scanWorker_t *worker, const char *path);
+static int scanListArchive(scanWorker_t *worker, const char *path);
+static void scanRecordEntry(scanWorker_t *worker,
+                            const char *archivePath,
+                            struct archive_entry *entry);
+static la_ssize_t scanRead(struct archive *a, void *client, const void **buf);
+static la_int64_t scanSkip(struct archive *a, void *client,
+                           la_int64_t request);
+static la_int64_t scanSeek(struct archive *a, void *client,
+                           la_int64_t offset, int whence);
+static int scanWalk(scanShared_t *shared, const char *root,
+                    scanStats_t *stats);
+static int scanStartWorkers(scanShared_t *shared);
+static void scanStopWorkers(scanShared_t *shared);
+
+/* private functions */
+
+/*
+    scanPush - add path to the first queue, starting at first, that
+               has room, waiting for room if every queue is full;
+               returns the index of the queue it was added to
+*/
+
+static int scanPush(scanShared_t *shared, unsigned int first, char *path)
+{
+    scanQueue_t *queue = NULL;
+    unsigned int i = 0;
+    unsigned int n = 0;
+
+    for (;;)
+    {
+        for (i = 0; i < shared->numWorkers; i++)
+        {
+            n = (first + i) % shared->numWorkers;
+            queue = &(shared->workers[n].queue);
+
+            pthread_mutex_lock(&(queue->lock));
+            if (queue->count < SCANQUEUELEN)
+            {
+                queue->paths[(queue->head + queue->count) % SCANQUEUELEN] =
+                    path;
+                queue->count++;
+                __atomic_add_fetch(&(shared->queued), 1, __ATOMIC_SEQ_CST);
+                pthread_mutex_unlock(&(queue->lock));
+
+                if (__atomic_load_n(&(shared->idleWorkers),
+                                    __ATOMIC_SEQ_CST) > 0)
+                {
+                    pthread_mutex_lock(&(shared->lock));
+                    pthread_cond_signal(&(shared->hasWork));
+                    pthread_mutex_unlock(&(shared->lock));
+                }
+
+                return (int)n;
+            }
+            pthread_mutex_unlock(&(queue->lock));
+        }
+
+        /* every queue is full, wait for a worker to take a file */
+
+        pthread_mutex_lock(&(shared->lock));
+        __atomic_store_n(&(shared->walkerWaiting), 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&(shared->queued), __ATOMIC_SEQ_CST) >=
+               shared->numWorkers * SCANQUEUELEN)
+        {
+            pthread_cond_wait(&(shared->notFull), &(shared->lock));
+        }
+        __atomic_store_n(&(shared->walkerWaiting), 0, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&(shared->lock));
+    }
+}
+
+/* scanPop - take the file at the front of the worker's own queue */
+
+static char *scanPop(scanWorker_t *worker)
+{
+    scanQueue_t *queue = &(worker->queue);
+    char *path = NULL;
+
+    pthread_mutex_lock(&(queue->lock));
+    if (queue->count > 0)
+    {
+        path = queue->paths[queue->head];
+        queue->head = (queue->head + 1) % SCANQUEUELEN;
+        queue->count--;
+    }
+    pthread_mutex_unlock(&(queue->lock));
+
+    return path;
+}
+
+/*
+    scanTake - take the next file from the worker's own queue or,
+               if that is empty, steal the file at the back of another
+               worker's queue; waits until there is a file, and
+               returns NULL once the walker is done and every queue
+               is empty
+*/
+
+static char *scanTake(scanWorker_t *worker)
+{
+    scanShared_t *shared = worker->shared;
+    scanQueue_t *queue = NULL;
+    char *path = NULL;
+    unsigned int i = 0;
+
+    for (;;)
+    {
+        path = scanPop(worker);
+
+        for (i = 1; path == NULL && i < shared->numWorkers; i++)
+        {
+            queue = &(shared->workers[(worker->index + i) %
+                                      shared->numWorkers].queue);
+
+            pthread_mutex_lock(&(queue->lock));
+            if (queue->count > 0)
+            {
+                queue->count--;
+                path = queue->paths[(queue->head + queue->count) %
+                                    SCANQUEUELEN];
+                worker->stats.steals++;
+            }
+            pthread_mutex_unlock(&(queue->lock));
+        }
+
+        if (path != NULL)
+        {
+            __atomic_sub_fetch(&(shared->queued), 1, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&(shared->walkerWaiting),
+                                __ATOMIC_SEQ_CST) != 0)
+            {
+                pthread_mutex_lock(&(shared->lock));
+                pthread_cond_signal(&(shared->notFull));
+                pthread_mutex_unlock(&(shared->lock));
+            }
+            return path;
+        }
+
+        /* nothing to take, wait for the walker */
+
+        pthread_mutex_lock(&(shared->lock));
+        __atomic_add_fetch(&(shared->idleWorkers), 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&(shared->queued), __ATOMIC_SEQ_CST) == 0 &&
+               shared->walkerDone == 0)
+        {
+            pthread_cond_wait(&(shared->hasWork), &(shared->lock));
+        }
+        __atomic_sub_fetch(&(shared->idleWorkers), 1, __ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&(shared->queued), __ATOMIC_SEQ_CST) == 0 &&
+            shared->walkerDone != 0)
+        {
+            pthread_mutex_unlock(&(shared->lock));
+            return NULL;
+        }
+        pthread_mutex_unlock(&(shared->lock));
+    }
+}
+
+/* scanWorkerMain - list the files given to a worker */
+
+static void *scanWorkerMain(void *arg)
+{
+    scanWorker_t *worker = (scanWorker_t *)arg;
+    char *path = NULL;
+
+    while ((path = scanTake(worker)) != NULL)
+    {
+        scanListFile(worker, path);
+        free(path);
+    }
+
+    if (worker->writer != NULL)
+    {
+        recWriterFlush(worker->writer);
+        worker->stats.indexBytes = worker->writer->bytesWritten;
+    }
+
+    return NULL;
+}
+
+/*
+    scanListFile - list the file at path if it starts with an
+                   archive's magic number or has an archive's
+                   extension; returns gScanNotArchive if it was
+                   skipped
+*/
+
+static int scanListFile(scanWorker_t *worker, const char *path)
+{
+    ssize_t bytesRead = 0;
+    int rc = gScanOkay;
+
+    worker->stats.files++;
+
+    worker->fd = open(path, O_RDONLY);
+    if (worker->fd < 0)
+    {
+        return gScanErr;
+    }
+
+    bytesRead = pread(worker->fd, worker->buf, SCANSNIFFLEN, 0);
+    if (bytesRead <= 0 ||
+        (nestedIsArchiveMagic(worker->buf, (size_t)bytesRead) == 0 &&
+         nestedIsArchiveName(path) == 0))
+    {
+        close(worker->fd);
+        worker->fd = -1;
+        return gScanNotArchive;
+    }
+
+    worker->stats.candidates++;
+
+    rc = scanListArchive(worker, path);
+    if (rc == gScanOkay)
+    {
+        worker->stats.archives++;
+    }
+    else
+    {
+        worker->stats.failed++;
+    }
+
+    close(worker->fd);
+    worker->fd = -1;
+
+    return rc;
+}
+
+/*
+    scanListArchive - write a record for each entry of the archive
+                      open on the worker's fd
+*/
+
+static int scanListArchive(scanWorker_t *worker, const char *path)
+{
+    struct archive *a = NULL;
+    int64_t entries = 0;
+    int r = ARCHIVE_OK;
+
+    a = archive_read_new();
+    if (a == NULL)
+    {
+        return gScanErr;
+    }
+
+    /* the preview's filters, formats and limits */
+
+    archive_read_support_filter_compress(a);
+    archive_read_support_filter_gzip(a);
+    archive_read_support_filter_bzip2(a);
+    archive_read_support_filter_xz(a);
+    archive_read_support_filter_uu(a);
+    archive_read_support_filter_rpm(a);
+    archive_read_support_filter_pbzx(a);
+    archive_read_support_filter_udif(a);
+
+    archive_read_support_format_cpio(a);
+    archive_read_support_format_tar(a);
+    archive_read_support_format_zip(a);
+    archive_read_support_format_xar(a);
+    archive_read_support_format_iso9660(a);
+    archive_read_support_format_rar(a);
+    archive_read_support_format_rar5(a);
+    archive_read_support_format_lha(a);
+    archive_read_support_format_ar(a);
+    archive_read_support_format_7zip(a);
+    archive_read_support_format_cab(a);
+    archive_read_support_format_warc(a);
+    archive_read_support_format_mtree(a);
+
+    archive_read_set_limit(a, ARCHIVE_READ_LIMIT_ENTRIES, SCANLIMITENTRIES);
+    archive_read_set_limit(a,
+                           ARCHIVE_READ_LIMIT_HEADER_BYTES,
+                           SCANLIMITHEADERBYTES);
+    archive_read_set_limit(a, ARCHIVE_READ_LIMIT_DEPTH, SCANLIMITDEPTH);
+    archive_read_set_limit(a, ARCHIVE_READ_LIMIT_MEMORY, SCANLIMITMEMORY);
+
+    /* read from the worker's fd into the worker's buffer */
+
+    if (lseek(worker->fd, 0, SEEK_SET) != 0)
+    {
+        archive_read_free(a);
+        return gScanErr;
+    }
+
+    archive_read_set_read_callback(a, scanRead);
+    archive_read_set_skip_callback(a, scanSkip);
+    archive_read_set_seek_callback(a, scanSeek);
+    archive_read_set_callback_data(a, worker);
+
+    if (archive_read_open1(a) != ARCHIVE_OK)
+    {
+        archive_read_free(a);
+        return gScanErr;
+    }
+
+    for (;;)
+    {
+        r = archive_read_next_header2(a, worker->entry);
+        if (r == ARCHIVE_EOF || r < ARCHIVE_WARN)
+        {
+            break;
+        }
+
+        entries++;
+        scanRecordEntry(worker, path, worker->entry);
+    }
+
+    worker->stats.entries += (uint64_t)entries;
+    worker->stats.archiveBytes += (uint64_t)archive_filter_bytes(a, -1);
+
+    archive_read_free(a);
+
+    /* an archive is only listed if it had entries or ended cleanly */
+
+    return (r == ARCHIVE_EOF || entries > 0 ? gScanOkay : gScanErr);
+}
+
+/*
+    scanRecordEntry - write an entry's record to the index, with the
+                      same fields as the preview's records
+*/
+
+static void scanRecordEntry(scanWorker_t *worker,
+                            const char *archivePath,
+                            struct archive_entry *entry)
+{
+    recEntry_t rec;
+
+    if (worker->writer == NULL)
+    {
+        return;
+    }
+
+    memset(&rec, 0, sizeof(recEntry_t));
+
+    rec.archive = archivePath;
+    rec.path = archive_entry_pathname(entry);
+    if (rec.path == NULL)
+    {
+        rec.path = "";
+    }
+
+    switch (archive_entry_filetype(entry))
+    {
+        case AE_IFDIR:
+            rec.type = RecTypeDir;
+            break;
+        case AE_IFLNK:
+            rec.type = RecTypeLink;
+            break;
+        case AE_IFREG:
+            rec.type = RecTypeFile;
+            break;
+        default:
+            rec.type = RecTypeSpecial;
+            break;
+    }
+
+    if (rec.type != RecTypeDir && archive_entry_size_is_set(entry))
+    {
+        rec.size = archive_entry_size(entry);
+        rec.hasSize = 1;
+    }
+
+    if (archive_entry_mtime_is_set(entry))
+    {
+        rec.mtime = archive_entry_mtime(entry);
+        rec.hasMtime = 1;
+    }
+
+    rec.encrypted = (archive_entry_is_encrypted(entry) ? 1 : 0);
+
+    recWriterAppend(worker->writer, &rec);
+}
+
+/* scanRead - libarchive read callback for the worker's fd */
+
+static la_ssize_t scanRead(struct archive *a, void *client, const void **buf)
+{
+    scanWorker_t *worker = (scanWorker_t *)client;
+    ssize_t bytesRead = 0;
+
+    do
+    {
+        bytesRead = read(worker->fd, worker->buf, SCANBLOCKSIZE);
+    } while (bytesRead < 0 && errno == EINTR);
+
+    if (bytesRead < 0)
+    {
+        archive_set_error(a, errno, "Error reading file");
+        return ARCHIVE_FATAL;
+    }
+
+    *buf = worker->buf;
+    return bytesRead;
+}
+
+/* scanSkip - libarchive skip callback for the worker's fd */
+
+static la_int64_t scanSkip(struct archive *a, void *client,
+                           la_int64_t request)
+{
+    scanWorker_t *worker = (scanWorker_t *)client;
+
+    if (request <= 0 || lseek(worker->fd, request, SEEK_CUR) < 0)
+    {
+        return 0;
+    }
+
+    return request;
+}
+
+/* scanSeek - libarchive seek callback for the worker's fd */
+
+static la_int64_t scanSeek(struct archive *a, void *client,
+                           la_int64_t offset, int whence)
+{
+    scanWorker_t *worker = (scanWorker_t *)client;
+    off_t pos = 0;
+
+    pos = lseek(worker->fd, (off_t)offset, whence);
+    if (pos < 0)
+    {
+        archive_set_error(a, errno, "Error seeking in file");
+        return ARCHIVE_FATAL;
+    }
+
+    return (la_int64_t)pos;
+}
+
+/*
+    scanWalk - walk the tree under root, giving each regular file to
+               the workers in turn
+*/
+
+static int scanWalk(scanShared_t *shared, const char *root,
+                    scanStats_t *stats)
+{
+    struct archive *disk = NULL;
+    struct archive_entry *entry = NULL;
+    const char *path = NULL;
+    char *copy = NULL;
+    unsigned int next = 0;
+    int behavior = 0;
+    int rc = gScanOkay;
+    int r = ARCHIVE_OK;
+
+    disk = archive_read_disk_new();
+    entry = archive_entry_new();
+    if (disk == NULL || entry == NULL)
+    {
+        archive_entry_free(entry);
+        archive_read_free(disk);
+        return gScanErr;
+    }
+
+    /* only the directories are read, not each file's metadata */
+
+    behavior = ARCHIVE_READDISK_NO_XATTR |
+               ARCHIVE_READDISK_NO_ACL |
+               ARCHIVE_READDISK_NO_FFLAGS |
+               ARCHIVE_READDISK_NO_SPARSE;
+    if (shared->options->crossMounts == 0)
+    {
+        behavior |= ARCHIVE_READDISK_NO_TRAVERSE_MOUNTS;
+    }
+
+    archive_read_disk_set_symlink_physical(disk);
+    archive_read_disk_set_behavior(disk, behavior);
+
+    if (archive_read_disk_open(disk, root) != ARCHIVE_OK)
+    {
+        fprintf(stderr,
+                "qlZipInfo: ERROR: can't open '%s': %s\n",
+                root,
+                archive_error_string(disk));
+        archive_entry_free(entry);
+        archive_read_free(disk);
+        return gScanErr;
+    }
+
+    for (;;)
+    {
+        r = archive_read_next_header2(disk, entry);
+        if (r == ARCHIVE_EOF)
+        {
+            break;
+        }
+
+        if (r == ARCHIVE_FATAL)
+        {
+            fprintf(stderr,
+                    "qlZipInfo: ERROR: can't read '%s': %s\n",
+                    root,
+                    archive_error_string(disk));
+            rc = gScanErr;
+            break;
+        }
+
+        if (r < ARCHIVE_WARN)
+        {
+            continue;
+        }
+
+        archive_read_disk_descend(disk);
+
+        switch (archive_entry_filetype(entry))
+        {
+            case AE_IFDIR:
+                stats->dirs++;
+                break;
+
+            case AE_IFREG:
+                path = archive_entry_sourcepath(entry);
+                if (path == NULL)
+                {
+                    path = archive_entry_pathname(entry);
+                }
+                if (path == NULL || (copy = strdup(path)) == NULL)
+                {
+                    break;
+                }
+                next = (unsigned int)(scanPush(shared, next, copy) + 1);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    archive_entry_free(entry);
+    archive_read_free(disk);
+
+    return rc;
+}
+
+/* scanStartWorkers - create the workers and start their threads */
+
+static int scanStartWorkers(scanShared_t *shared)
+{
+    scanWorker_t *worker = NULL;
+    unsigned int i = 0;
+
+    for (i = 0; i < shared->numWorkers; i++)
+    {
+        worker = &(shared->workers[i]);
+        worker->shared = shared;
+        worker->index = i;
+        worker->fd = -1;
+
+        worker->buf = malloc(SCANBLOCKSIZE);
+        worker->entry = archive_entry_new();
+        if (worker->buf == NULL || worker->entry == NULL)
+        {
+            return gScanErr;
+        }
+
+        if (shared->options->indexFd >= 0)
+        {
+            worker->writer = malloc(sizeof(recWriter_t));
+            if (worker->writer == NULL ||
+                recWriterInit(worker->writer,
+                              shared->options->indexFd,
+                              shared->options->indexFormat) != gRecOkay)
+            {
+                return gScanErr;
+            }
+        }
+
+        if (pthread_create(&(worker->thread),
+                           NULL,
+                           scanWorkerMain,
+                           worker) != 0)
+        {
+            return gScanErr;
+        }
+        worker->started = 1;
+    }
+
+    return gScanOkay;
+}
+
+/*
+    scanStopWorkers - tell the workers that the walk is done, wait for
+                      them to list the files still in their queues,
+                      and free them
+*/
+
+static void scanStopWorkers(scanShared_t *shared)
+{
+    scanWorker_t *worker = NULL;
+    char *path = NULL;
+    unsigned int i = 0;
+
+    pthread_mutex_lock(&(shared->lock));
+    shared->walkerDone = 1;
+    pthread_cond_broadcast(&(shared->hasWork));
+    pthread_mutex_unlock(&(shared->lock));
+
+    for (i = 0; i < shared->numWorkers; i++)
+    {
+        worker = &(shared->workers[i]);
+        if (worker->started != 0)
+        {
+            pthread_join(worker->thread, NULL);
+        }
+    }
+
+    for (i = 0; i < shared->numWorkers; i++)
+    {
+        worker = &(shared->workers[i]);
+
+        /* only left over if a worker couldn't be started */
+
+        while ((path = scanPop(worker)) != NULL)
+        {
+            free(path);
+        }
+
+        if (worker->entry != NULL)
+        {
+            archive_entry_free(worker->entry);
+        }
+        free(worker->buf);
+        free(worker->writer);
+        pthread_mutex_destroy(&(worker->queue.lock));
+    }
+}
+
+/* public functions */
+
+/*
+    scanRun - list every archive under options->root; stats (which
+              may be NULL) gets the totals
+*/
+
+int scanRun(const scanOptions_t *options, scanStats_t *stats)
+{
+    scanShared_t shared;
+    scanStats_t totals;
+    scanStats_t *w = NULL;
+    char root[PATH_MAX];
+    unsigned int i = 0;
+    int rc = gScanOkay;
+
+    memset(&totals, 0, sizeof(scanStats_t));
+    if (stats != NULL)
+    {
+        memset(stats, 0, sizeof(scanStats_t));
+    }
+
+    if (options == NULL || options->root == NULL ||
+        options->numWorkers < 1 || options->numWorkers > SCANMAXWORKERS ||
+        options->indexFormat < RecFormatNDJSON ||
+        options->indexFormat >= RecFormatMax)
+    {
+        return gScanErr;
+    }
+
+    /* the walker may change directories, so use an absolute root */
+
+    if (realpath(options->root, root) == NULL)
+    {
+        fprintf(stderr,
+                "qlZipInfo: ERROR: can't find '%s': %s\n",
+                options->root,
+                strerror(errno));
+        return gScanErr;
+    }
+
+    memset(&shared, 0, sizeof(scanShared_t));
+    shared.options = options;
+    shared.numWorkers = (unsigned int)options->numWorkers;
+    shared.workers = calloc(shared.numWorkers, sizeof(scanWorker_t));
+    if (shared.workers == NULL)
+    {
+        return gScanErr;
+    }
+
+    pthread_mutex_init(&(shared.lock), NULL);
+    pthread_cond_init(&(shared.hasWork), NULL);
+    pthread_cond_init(&(shared.notFull), NULL);
+    for (i = 0; i < shared.numWorkers; i++)
+    {
+        pthread_mutex_init(&(shared.workers[i].queue.lock), NULL);
+    }
+
+    rc = scanStartWorkers(&shared);
+    if (rc == gScanOkay)
+    {
+        rc = scanWalk(&shared, root, &totals);
+    }
+    else
+    {
+        fprintf(stderr, "qlZipInfo: ERROR: can't start the scan workers\n");
+    }
+
+    scanStopWorkers(&shared);
+
+    for (i = 0; i < shared.numWorkers; i++)
+    {
+        w = &(shared.workers[i].stats);
+        totals.files += w->files;
+        totals.candidates += w->candidates;
+        totals.archives += w->archives;
+        totals.failed += w->failed;
+        totals.entries += w->entries;
+        totals.archiveBytes += w->archiveBytes;
+        totals.steals += w->steals;
+        totals.indexBytes += w->indexBytes;
+    }
+
+    pthread_cond_destroy(&(shared.notFull));
+    pthread_cond_destroy(&(shared.hasWork));
+    pthread_mutex_destroy(&(shared.lock));
+    free(shared.workers);
+
+    if (stats != NULL)
+    {
+        *stats = totals;
+    }
+
+    return rc;
+}
@@ -0,0 +1,129 @@
+/*
+    scan.h - list every archive under a directory
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    scanRun() walks a directory tree with archive_read_disk on the
+    calling thread and lists the archives it finds on numWorkers
+    worker threads:
+
+        - The walker only reads directories (no xattrs, ACLs, file
+          flags or sparse maps) and queues each regular file, so it
+          runs ahead of the workers, reading the next directories
+          while the workers list archives, by up to SCANQUEUELEN
+          files per worker.
+        - Each worker has its own queue, which the walker fills in
+          turn.  A worker takes files from the front of its own
+          queue and, once that is empty, steals from the back of the
+          other workers' queues, so one large archive doesn't hold up
+          the files queued behind it.
+        - A worker reads the first SCANSNIFFLEN bytes of each file and
+          only lists it if it has an archive's magic number or
+          extension (see nested.h).  Each worker reuses one read
+          buffer, one struct archive_entry and one record writer for
+          all of its archives; libarchive readers can't be reopened,
+          so a new reader is made for each archive.
+        - If indexFd is not -1, one record per entry (see records.h),
+          with the archive's path, is written to indexFd, which must
+          be open with O_APPEND since every worker writes to it.
+
+    Paths in the index are absolute.  The walker may change the
+    current directory while it runs (archive_read_disk does on some
+    systems).
+*/
+
+#ifndef qlZipInfo_scan_h
+#define qlZipInfo_scan_h
+
+#include <stdint.h>
+
+#include "records.h"
+
+/* return codes */
+
+enum
+{
+    gScanErr         = -1,
+    gScanOkay        =  0,
+    gScanNotArchive  =  1,
+};
+
+/* number of files queued for each worker */
+
+#define SCANQUEUELEN 256
+
+/* number of bytes read to check for an archive's magic number */
+
+#define SCANSNIFFLEN 512
+
+/* size of each worker's read buffer */
+
+#define SCANBLOCKSIZE 65536
+
+/* most workers */
+
+#define SCANMAXWORKERS 64
+
+/* the preview's resource limits, see GeneratePreviewForURL.h */
+
+#define SCANLIMITENTRIES     1000000
+#define SCANLIMITHEADERBYTES (16 * 1024 * 1024)
+#define SCANLIMITDEPTH       512
+#define SCANLIMITMEMORY      (512 * 1024 * 1024)
+
+/* options */
+
+typedef struct scanOptions
+{
+    const char *root;
+    int numWorkers;
+    int indexFd;
+    recFormat_t indexFormat;
+    int crossMounts;
+} scanOptions_t;
+
+/* statistics */
+
+typedef struct scanStats
+{
+    uint64_t dirs;
+    uint64_t files;
+    uint64_t candidates;
+    uint64_t archives;
+    uint64_t failed;
+    uint64_t entries;
+    uint64_t archiveBytes;
+    uint64_t steals;
+    uint64_t indexBytes;
+} scanStats_t;
+
+/* prototypes */
+
+int scanRun(const scanOptions_t *options, scanStats_t *stats);
+
+#endif /* qlZipInfo_scan_h */
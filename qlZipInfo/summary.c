@@ -0,0 +1,985 @@
+/*
+    summary.c - constant time archive summaries for thumbnails
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    APPNOTE.TXT - .ZIP File Format Specification, sections 4.3.14 -
+    4.3.16
+    https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+
+    7zFormat.txt - 7z Format description
+    https://github.com/ip7z/7zip/blob/main/DOC/7zFormat.txt
+
+    RFC 1952 - GZIP file format specification, section 2.3.1
+    https://www.rfc-editor.org/rfc/rfc1952
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "archdir.h"
+#include "summary.h"
+
+/* zip flags */
+
+#define ZIPFLAGENCRYPTED 0x0001
+#define ZIPCDENCRYPTED   0x2000
+
+/* rar signature lengths, and how much of a block header is read */
+
+#define RAR5SIGLEN       8
+#define RAR4SIGLEN       7
+#define RARREADLEN       512
+#define RAR5MAXHEADER    (2 * 1024 * 1024)
+
+/* RAR 5 header types, header flags and extra record types */
+
+enum
+{
+    gRar5HeaderFile       = 2,
+    gRar5HeaderEncryption = 4,
+    gRar5HeaderEnd        = 5,
+    gRar5FlagExtra        = 0x0001,
+    gRar5FlagData         = 0x0002,
+    gRar5ExtraEncryption  = 0x01,
+};
+
+/* RAR 4 block types and flags */
+
+enum
+{
+    gRar4HeaderMain    = 0x73,
+    gRar4HeaderFile    = 0x74,
+    gRar4HeaderService = 0x7A,
+    gRar4HeaderEnd     = 0x7B,
+    gRar4MainPassword  = 0x0080,
+    gRar4FilePassword  = 0x0004,
+    gRar4FileLarge     = 0x0100,
+    gRar4LongBlock     = 0x8000,
+    gRar4FileHeaderLen = 32,
+};
+
+/* magic numbers */
+
+typedef struct summaryMagic
+{
+    summaryFormat_t format;
+    size_t offset;
+    size_t len;
+    const char *magic;
+} summaryMagic_t;
+
+static const summaryMagic_t gSummaryMagics[] =
+{
+    { SummaryFormatZip,      0, 4, "PK\003\004"                 },
+    { SummaryFormatZip,      0, 4, "PK\005\006"                 },
+    { SummaryFormatZip,      0, 4, "PK\007\010"                 },
+    { SummaryFormat7Zip,     0, 6, "7z\274\257\047\034"         },
+    { SummaryFormatGZip,     0, 2, "\037\213"                   },
+    { SummaryFormatCompress, 0, 2, "\037\235"                   },
+    { SummaryFormatBZip2,    0, 3, "BZh"                        },
+    { SummaryFormatXZ,       0, 6, "\3757zXZ\000"               },
+    { SummaryFormatRar,      0, 6, "Rar!\032\007"               },
+    { SummaryFormatXar,      0, 4, "xar!"                       },
+    { SummaryFormatDeb,      0, 21, "!<arch>\ndebian-binary"    },
+    { SummaryFormatAr,       0, 8, "!<arch>\n"                  },
+    { SummaryFormatCab,      0, 4, "MSCF"                       },
+    { SummaryFormatRpm,      0, 4, "\355\253\356\333"           },
+    { SummaryFormatCpio,     0, 6, "070707"                     },
+    { SummaryFormatCpio,     0, 6, "070701"                     },
+    { SummaryFormatCpio,     0, 6, "070702"                     },
+    { SummaryFormatSit,      0, 4, "SIT!"                       },
+    { SummaryFormatSit,      0, 8, "StuffIt "                   },
+    { SummaryFormatBinHex,   0, 40,
+      "(This file must be converted with BinHex"                },
+    { SummaryFormatLha,      2, 3, "-lh"                        },
+    { SummaryFormatTar,    257, 5, "ustar"                      },
+    { SummaryFormatUnknown,  0, 0, NULL                         },
+};
+
+/* the ISO9660 primary volume descriptor's identifier */
+
+#define ISO9660MAGICOFFSET 32769
+#define ISO9660MAGIC       "CD001"
+
+/* format names */
+
+static const char *gSummaryFormatNames[SummaryFormatMax] =
+{
+    "ARCHIVE",
+    "ZIP",
+    "7Z",
+    "GZIP",
+    "BZIP2",
+    "XZ",
+    "Z",
+    "RAR",
+    "XAR",
+    "TAR",
+    "AR",
+    "DEB",
+    "CAB",
+    "RPM",
+    "CPIO",
+    "LHA",
+    "ISO",
+    "SIT",
+    "HQX",
+};
+
+/* private functions */
+
+static summaryFormat_t summaryGetFormat(int fd,
+                                        const unsigned char *head,
+                                        size_t headLen);
+static int summaryReadZip(int fd, summary_t *summary);
+static int summaryCountZip(int fd,
+                           off_t fileSize,
+                           summaryEncryption_t *encryption);
+static void summaryAddZipSizes(archDirCursor_t *c,
+                               uint64_t entries,
+                               summary_t *summary);
+static int summaryReadGZip(int fd, summary_t *summary);
+static int summaryRead7Zip(int fd, summary_t *summary);
+static int summaryCount7Zip(int fd,
+                            off_t fileSize,
+                            summaryEncryption_t *encryption);
+static uint64_t summaryGetVint(archDirCursor_t *c);
+static int summaryCountRar5(int fd,
+                            off_t fileSize,
+                            summaryEncryption_t *encryption);
+static int summaryCountRar4(int fd,
+                            off_t fileSize,
+                            summaryEncryption_t *encryption);
+
+/* summaryGetFormat - get an archive's format from its magic number */
+
+static summaryFormat_t summaryGetFormat(int fd,
+                                        const unsigned char *head,
+                                        size_t headLen)
+{
+    unsigned char iso[sizeof(ISO9660MAGIC) - 1];
+    int i = 0;
+
+    for (i = 0; gSummaryMagics[i].magic != NULL; i++)
+    {
+        if (headLen >= gSummaryMagics[i].offset + gSummaryMagics[i].len &&
+            memcmp(head + gSummaryMagics[i].offset,
+                   gSummaryMagics[i].magic,
+                   gSummaryMagics[i].len) == 0)
+        {
+            return gSummaryMagics[i].format;
+        }
+    }
+
+    if (archDirReadAt(fd, iso, sizeof(iso), ISO9660MAGICOFFSET) ==
+            (ssize_t)sizeof(iso) &&
+        memcmp(iso, ISO9660MAGIC, sizeof(iso)) == 0)
+    {
+        return SummaryFormatISO9660;
+    }
+
+    return SummaryFormatUnknown;
+}
+
+/*
+    summaryReadZip - get the number of entries from a zip's end of
+                     central directory record (or its zip64 record),
+                     and, if the central directory is small, the
+                     entries' sizes
+*/
+
+static int summaryReadZip(int fd, summary_t *summary)
+{
+    archDirZip_t zip;
+    archDirCursor_t c;
+
+    if (archDirZipFind(fd, summary->fileSize, &zip) != gArchDirOkay)
+    {
+        return gSummaryErr;
+    }
+
+    summary->entries = zip.numEntries;
+    summary->hasEntries = 1;
+
+    /*
+        the sizes are only added up if the central directory is in
+        the tail that was read, so that nothing more is read
+    */
+
+    if (zip.numEntries <= SUMMARYMAXHEADERS &&
+        archDirZipTail(&zip, &c) == gArchDirOkay)
+    {
+        summaryAddZipSizes(&c, zip.numEntries, summary);
+    }
+
+    archDirZipFree(&zip);
+
+    return gSummaryOkay;
+}
+
+/*
+    summaryCountZip - count the encrypted and the plain entries in a
+                      zip's central directory
+*/
+
+static int summaryCountZip(int fd,
+                           off_t fileSize,
+                           summaryEncryption_t *encryption)
+{
+    unsigned char local[ARCHDIRZIPLOCALLEN];
+    archDirZip_t zip;
+    archDirCursor_t c;
+    archDirZipEntry_t entry;
+    uint64_t encrypted = 0;
+    uint64_t i = 0;
+    int err = gSummaryErr;
+
+    if (archDirZipFind(fd, fileSize, &zip) != gArchDirOkay)
+    {
+        return gSummaryErr;
+    }
+
+    if (archDirZipLoad(fd, &zip, SUMMARYMAXDIRECTORY, &c) != gArchDirOkay)
+    {
+        archDirZipFree(&zip);
+        return gSummaryErr;
+    }
+
+    for (i = 0; i < zip.numEntries; i++)
+    {
+        if (archDirZipNext(&c, zip.delta, &entry) != gArchDirOkay)
+        {
+            break;
+        }
+
+        if (entry.flags & ZIPFLAGENCRYPTED)
+        {
+            encrypted++;
+        }
+    }
+
+    if (i == zip.numEntries)
+    {
+        encryption->encryptedEntries = encrypted;
+        encryption->plainEntries = zip.numEntries - encrypted;
+        err = gSummaryOkay;
+    }
+    else if (i == 0 &&
+             archDirReadAt(fd, local, ARCHDIRZIPLOCALLEN, 0) ==
+                 ARCHDIRZIPLOCALLEN &&
+             memcmp(local, ARCHDIRZIPLOCALSIG, 4) == 0 &&
+             (archDirGet16(local + 6) & ZIPCDENCRYPTED))
+    {
+        /*
+            the central directory is encrypted (PKWARE strong
+            encryption), which the first local header says
+        */
+
+        encryption->headersEncrypted = 1;
+        err = gSummaryOkay;
+    }
+
+    archDirZipFree(&zip);
+
+    return err;
+}
+
+/*
+    summaryAddZipSizes - add up the sizes in the central directory
+                         entries, and check if any are encrypted
+*/
+
+static void summaryAddZipSizes(archDirCursor_t *c,
+                               uint64_t entries,
+                               summary_t *summary)
+{
+    archDirZipEntry_t entry;
+    uint64_t totalCompressed = 0;
+    uint64_t totalUncompressed = 0;
+    uint64_t i = 0;
+    int encrypted = 0;
+
+    for (i = 0; i < entries; i++)
+    {
+        if (archDirZipNext(c, 0, &entry) != gArchDirOkay)
+        {
+            return;
+        }
+
+        if (entry.flags & ZIPFLAGENCRYPTED)
+        {
+            encrypted = 1;
+        }
+
+        totalCompressed += entry.compressedSize;
+        totalUncompressed += entry.uncompressedSize;
+    }
+
+    summary->compressedSize = totalCompressed;
+    summary->uncompressedSize = totalUncompressed;
+    summary->hasSizes = 1;
+    summary->encrypted = encrypted;
+}
+
+/*
+    summaryReadGZip - get a gzip'ed file's uncompressed size (modulo
+                      4GB) from its last 4 bytes
+*/
+
+static int summaryReadGZip(int fd, summary_t *summary)
+{
+    unsigned char isize[4];
+
+    /* a 10 byte header, an empty deflate block, and an 8 byte trailer */
+
+    if (summary->fileSize < 20 ||
+        archDirReadAt(fd, isize, 4, summary->fileSize - 4) != 4)
+    {
+        return gSummaryErr;
+    }
+
+    summary->uncompressedSize = archDirGet32(isize);
+    summary->compressedSize = (uint64_t)summary->fileSize;
+    summary->hasSizes = 1;
+
+    return gSummaryOkay;
+}
+
+/*
+    summaryRead7Zip - get the number of entries and the packed and
+                      unpacked sizes from a 7z archive's header
+*/
+
+static int summaryRead7Zip(int fd, summary_t *summary)
+{
+    archDir7z_t s;
+    uint64_t packSize = 0;
+    uint64_t unpackSize = 0;
+    uint64_t i = 0;
+    int headerEncrypted = 0;
+
+    if (archDir7zLoad(fd,
+                      summary->fileSize,
+                      SUMMARYMAXHEADER,
+                      &s,
+                      &headerEncrypted) != gArchDirOkay)
+    {
+        summary->encrypted = headerEncrypted;
+        return gSummaryErr;
+    }
+
+    summary->entries = s.numFiles;
+    summary->hasEntries = 1;
+
+    for (i = 0; i < s.numPackStreams; i++)
+    {
+        packSize += s.packSizes[i];
+    }
+
+    /* a folder with more than one file makes the archive solid */
+
+    for (i = 0; i < s.numFolders; i++)
+    {
+        unpackSize += s.folders[i].unpackSize;
+        if (s.folders[i].encrypted)
+        {
+            summary->encrypted = 1;
+        }
+        if (s.folders[i].numSubstreams > 1)
+        {
+            summary->solid = 1;
+        }
+    }
+
+    if (unpackSize > 0)
+    {
+        summary->uncompressedSize = unpackSize;
+        summary->compressedSize = packSize;
+        summary->hasSizes = 1;
+    }
+
+    archDir7zFree(&s);
+
+    return gSummaryOkay;
+}
+
+/*
+    summaryCount7Zip - count the files in a 7z archive's folders that
+                       have an AES coder, which are encrypted, and the
+                       other files, which are plain
+*/
+
+static int summaryCount7Zip(int fd,
+                            off_t fileSize,
+                            summaryEncryption_t *encryption)
+{
+    archDir7z_t s;
+    uint64_t encrypted = 0;
+    uint64_t i = 0;
+    int headerEncrypted = 0;
+    int err = gSummaryErr;
+
+    if (archDir7zLoad(fd,
+                      fileSize,
+                      SUMMARYMAXDIRECTORY,
+                      &s,
+                      &headerEncrypted) != gArchDirOkay)
+    {
+        if (headerEncrypted)
+        {
+            encryption->headersEncrypted = 1;
+            return gSummaryOkay;
+        }
+        return gSummaryErr;
+    }
+
+    /*
+        a folder has one file unless the SubStreamsInfo says otherwise,
+        and the files without data (which don't count here) aren't in
+        any folder
+    */
+
+    for (i = 0; i < s.numFolders; i++)
+    {
+        if (s.folders[i].encrypted)
+        {
+            encrypted += s.folders[i].numSubstreams;
+        }
+    }
+
+    if (encrypted <= s.numFiles)
+    {
+        encryption->encryptedEntries = encrypted;
+        encryption->plainEntries = s.numFiles - encrypted;
+        err = gSummaryOkay;
+    }
+
+    archDir7zFree(&s);
+
+    return err;
+}
+
+/*
+    summaryGetVint - get a RAR 5 vint, 7 bits a byte, low bits first,
+                     with the high bit set in all but the last byte
+*/
+
+static uint64_t summaryGetVint(archDirCursor_t *c)
+{
+    uint64_t value = 0;
+    unsigned int byte = 0;
+    int shift = 0;
+
+    for (shift = 0; shift < 64 && !c->err; shift += 7)
+    {
+        byte = archDirGetByte(c);
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+
+    c->err = 1;
+
+    return 0;
+}
+
+/*
+    summaryCountRar5 - count the encrypted and the plain file headers
+                       of a RAR 5 archive, seeking past each block's
+                       data
+*/
+
+static int summaryCountRar5(int fd,
+                            off_t fileSize,
+                            summaryEncryption_t *encryption)
+{
+    unsigned char buf[RARREADLEN];
+    unsigned char *header = NULL;
+    const unsigned char *block = NULL;
+    const unsigned char *record = NULL;
+    archDirCursor_t c;
+    archDirCursor_t extra;
+    off_t offset = RAR5SIGLEN;
+    ssize_t len = 0;
+    uint64_t headerSize = 0, headerType = 0, headerFlags = 0;
+    uint64_t extraSize = 0, dataSize = 0, recordSize = 0;
+    uint64_t blockLen = 0;
+    uint64_t encrypted = 0, plain = 0;
+    unsigned long numBlocks = 0;
+    int isEncrypted = 0;
+    int err = gSummaryErr;
+
+    for (numBlocks = 0; numBlocks < SUMMARYMAXBLOCKS; numBlocks++)
+    {
+        /* an archive can end without an end of archive header */
+
+        if (offset >= fileSize)
+        {
+            if (offset == fileSize)
+            {
+                err = gSummaryOkay;
+            }
+            break;
+        }
+
+        len = archDirReadAt(fd, buf, sizeof(buf), offset);
+        if (len < 5)
+        {
+            break;
+        }
+
+        /*
+            a block starts with a CRC32 and the header size, which
+            doesn't count the CRC32 or itself
+        */
+
+        c.p = buf + 4;
+        c.end = buf + len;
+        c.err = 0;
+
+        headerSize = summaryGetVint(&c);
+        if (c.err || headerSize == 0 || headerSize > RAR5MAXHEADER)
+        {
+            break;
+        }
+
+        blockLen = (uint64_t)(c.p - buf) + headerSize;
+        block = buf;
+
+        if (blockLen > (uint64_t)len)
+        {
+            /* a header with a long name or extra area is read whole */
+
+            free(header);
+            header = malloc((size_t)blockLen);
+            if (header == NULL ||
+                archDirReadAt(fd, header, (size_t)blockLen, offset) !=
+                    (ssize_t)blockLen)
+            {
+                break;
+            }
+            block = header;
+        }
+
+        c.p = block + (blockLen - headerSize);
+        c.end = block + blockLen;
+
+        headerType = summaryGetVint(&c);
+        headerFlags = summaryGetVint(&c);
+        extraSize = (headerFlags & gRar5FlagExtra ? summaryGetVint(&c) : 0);
+        dataSize = (headerFlags & gRar5FlagData ? summaryGetVint(&c) : 0);
+        if (c.err || extraSize > (uint64_t)(c.end - c.p))
+        {
+            break;
+        }
+
+        if (headerType == gRar5HeaderEncryption)
+        {
+            encryption->headersEncrypted = 1;
+            err = gSummaryOkay;
+            break;
+        }
+
+        if (headerType == gRar5HeaderEnd)
+        {
+            err = gSummaryOkay;
+            break;
+        }
+
+        if (headerType == gRar5HeaderFile)
+        {
+            /* the extra area, a list of records, ends the header */
+
+            extra.p = c.end - extraSize;
+            extra.end = c.end;
+            extra.err = 0;
+            isEncrypted = 0;
+
+            while (extra.p < extra.end)
+            {
+                recordSize = summaryGetVint(&extra);
+                record = extra.p;
+                if (extra.err ||
+                    recordSize > (uint64_t)(extra.end - extra.p))
+                {
+                    break;
+                }
+
+                if (summaryGetVint(&extra) == gRar5ExtraEncryption &&
+                    !extra.err)
+                {
+                    isEncrypted = 1;
+                    break;
+                }
+
+                extra.p = record + recordSize;
+                extra.err = 0;
+            }
+
+            if (isEncrypted)
+            {
+                encrypted++;
+            }
+            else
+            {
+                plain++;
+            }
+        }
+
+        if (dataSize > (uint64_t)fileSize)
+        {
+            break;
+        }
+
+        offset += (off_t)(blockLen + dataSize);
+    }
+
+    free(header);
+
+    encryption->encryptedEntries = encrypted;
+    encryption->plainEntries = plain;
+
+    return err;
+}
+
+/*
+    summaryCountRar4 - count the encrypted and the plain file headers
+                       of a RAR 4 archive, seeking past each block's
+                       data
+*/
+
+static int summaryCountRar4(int fd,
+                            off_t fileSize,
+                            summaryEncryption_t *encryption)
+{
+    unsigned char buf[gRar4FileHeaderLen + 8];
+    off_t offset = RAR4SIGLEN;
+    ssize_t len = 0;
+    uint64_t dataSize = 0;
+    uint64_t encrypted = 0, plain = 0;
+    unsigned long numBlocks = 0;
+    unsigned int type = 0, flags = 0, headSize = 0;
+    int err = gSummaryErr;
+
+    for (numBlocks = 0; numBlocks < SUMMARYMAXBLOCKS; numBlocks++)
+    {
+        if (offset >= fileSize)
+        {
+            if (offset == fileSize)
+            {
+                err = gSummaryOkay;
+            }
+            break;
+        }
+
+        /* a block starts with a CRC16, its type, flags and size */
+
+        len = archDirReadAt(fd, buf, sizeof(buf), offset);
+        if (len < 7)
+        {
+            break;
+        }
+
+        type = buf[2];
+        flags = archDirGet16(buf + 3);
+        headSize = archDirGet16(buf + 5);
+        if (headSize < 7)
+        {
+            break;
+        }
+
+        if (type == gRar4HeaderMain && (flags & gRar4MainPassword))
+        {
+            encryption->headersEncrypted = 1;
+            err = gSummaryOkay;
+            break;
+        }
+
+        if (type == gRar4HeaderEnd)
+        {
+            err = gSummaryOkay;
+            break;
+        }
+
+        dataSize = 0;
+
+        if (type == gRar4HeaderFile || type == gRar4HeaderService)
+        {
+            /* the packed size, and its high 32 bits for large files */
+
+            if (headSize < gRar4FileHeaderLen || len < gRar4FileHeaderLen)
+            {
+                break;
+            }
+
+            dataSize = archDirGet32(buf + 7);
+            if (flags & gRar4FileLarge)
+            {
+                if (headSize < gRar4FileHeaderLen + 8 ||
+                    len < gRar4FileHeaderLen + 8)
+                {
+                    break;
+                }
+                dataSize |= (uint64_t)archDirGet32(buf + 32) << 32;
+            }
+
+            if (type == gRar4HeaderFile)
+            {
+                if (flags & gRar4FilePassword)
+                {
+                    encrypted++;
+                }
+                else
+                {
+                    plain++;
+                }
+            }
+        }
+        else if (flags & gRar4LongBlock)
+        {
+            if (len < 11)
+            {
+                break;
+            }
+            dataSize = archDirGet32(buf + 7);
+        }
+
+        if (dataSize > (uint64_t)fileSize)
+        {
+            break;
+        }
+
+        offset += (off_t)(headSize + dataSize);
+    }
+
+    encryption->encryptedEntries = encrypted;
+    encryption->plainEntries = plain;
+
+    return err;
+}
+
+/* public functions */
+
+/* summaryRead - get the summary of the archive at path */
+
+int summaryRead(const char *path, summary_t *summary)
+{
+    int fd = -1;
+    int err = gSummaryErr;
+
+    if (path == NULL || summary == NULL)
+    {
+        return gSummaryErr;
+    }
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        memset(summary, 0, sizeof(summary_t));
+        return gSummaryErr;
+    }
+
+    err = summaryReadFd(fd, summary);
+
+    close(fd);
+
+    return err;
+}
+
+/*
+    summaryReadFd - get the summary of the archive open on fd; the
+                    format and size are set even if the rest of the
+                    summary can't be found
+*/
+
+int summaryReadFd(int fd, summary_t *summary)
+{
+    unsigned char head[SUMMARYHEADLEN];
+    struct stat fileStats;
+    ssize_t headLen = 0;
+
+    if (summary == NULL)
+    {
+        return gSummaryErr;
+    }
+
+    memset(summary, 0, sizeof(summary_t));
+
+    if (fd < 0 || fstat(fd, &fileStats) != 0 || !S_ISREG(fileStats.st_mode))
+    {
+        return gSummaryErr;
+    }
+
+    summary->fileSize = fileStats.st_size;
+
+    headLen = archDirReadAt(fd, head, sizeof(head), 0);
+    if (headLen < 0)
+    {
+        return gSummaryErr;
+    }
+
+    summary->format = summaryGetFormat(fd, head, (size_t)headLen);
+
+    switch (summary->format)
+    {
+        case SummaryFormatZip:
+            return summaryReadZip(fd, summary);
+        case SummaryFormat7Zip:
+            return summaryRead7Zip(fd, summary);
+        case SummaryFormatGZip:
+            return summaryReadGZip(fd, summary);
+        case SummaryFormatUnknown:
+
+            /* it could be a zip with something in front of it */
+
+            if (summaryReadZip(fd, summary) == gSummaryOkay)
+            {
+                summary->format = SummaryFormatZip;
+            }
+            return gSummaryOkay;
+        default:
+            return gSummaryOkay;
+    }
+}
+
+/*
+    summaryReadEncryption - count the encrypted and the plain entries
+                            of the archive at path
+*/
+
+int summaryReadEncryption(const char *path,
+                          summaryEncryption_t *encryption)
+{
+    int fd = -1;
+    int err = gSummaryErr;
+
+    if (path == NULL || encryption == NULL)
+    {
+        return gSummaryErr;
+    }
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        memset(encryption, 0, sizeof(summaryEncryption_t));
+        return gSummaryErr;
+    }
+
+    err = summaryReadEncryptionFd(fd, encryption);
+
+    close(fd);
+
+    return err;
+}
+
+/*
+    summaryReadEncryptionFd - count the encrypted and the plain entries
+                              of the archive open on fd; the format is
+                              set even if they can't be counted
+*/
+
+int summaryReadEncryptionFd(int fd, summaryEncryption_t *encryption)
+{
+    unsigned char head[SUMMARYHEADLEN];
+    struct stat fileStats;
+    ssize_t headLen = 0;
+
+    if (encryption == NULL)
+    {
+        return gSummaryErr;
+    }
+
+    memset(encryption, 0, sizeof(summaryEncryption_t));
+
+    if (fd < 0 || fstat(fd, &fileStats) != 0 || !S_ISREG(fileStats.st_mode))
+    {
+        return gSummaryErr;
+    }
+
+    headLen = archDirReadAt(fd, head, sizeof(head), 0);
+    if (headLen < 0)
+    {
+        return gSummaryErr;
+    }
+
+    encryption->format = summaryGetFormat(fd, head, (size_t)headLen);
+
+    switch (encryption->format)
+    {
+        case SummaryFormatZip:
+            return summaryCountZip(fd, fileStats.st_size, encryption);
+        case SummaryFormat7Zip:
+            return summaryCount7Zip(fd, fileStats.st_size, encryption);
+        case SummaryFormatRar:
+
+            /* RAR 5 has an 8 byte signature, RAR 4 a 7 byte one */
+
+            if (headLen >= RAR5SIGLEN && head[6] == 0x01 && head[7] == 0x00)
+            {
+                return summaryCountRar5(fd, fileStats.st_size, encryption);
+            }
+            if (head[6] == 0x00)
+            {
+                return summaryCountRar4(fd, fileStats.st_size, encryption);
+            }
+            return gSummaryErr;
+        case SummaryFormatUnknown:
+
+            /* it could be a zip with something in front of it */
+
+            if (summaryCountZip(fd, fileStats.st_size, encryption) ==
+                    gSummaryOkay)
+            {
+                encryption->format = SummaryFormatZip;
+                return gSummaryOkay;
+            }
+            return gSummaryErr;
+        default:
+            return gSummaryErr;
+    }
+}
+
+/* summaryFormatName - get the short name of a format */
+
+const char *summaryFormatName(summaryFormat_t format)
+{
+    if (format < SummaryFormatUnknown || format >= SummaryFormatMax)
+    {
+        format = SummaryFormatUnknown;
+    }
+
+    return gSummaryFormatNames[format];
+}
@@ -0,0 +1,168 @@
+/*
+    summary.h - constant time archive summaries for thumbnails
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    A summary is the archive's format, its size and, when they can be
+    found without listing the archive, its number of entries and its
+    uncompressed size.  summaryRead() never reads more than a fixed
+    number of bytes, however large the archive is:
+
+        - the first SUMMARYHEADLEN bytes, for the magic number (and
+          the 5 bytes of an ISO9660 volume descriptor)
+        - zip: the last ARCHDIRZIPTAILLEN bytes (see archdir.h), for
+          the end of central directory record (and the zip64 record,
+          if there is one), which has the number of entries.  If the whole central
+          directory is in those bytes and it has no more than
+          SUMMARYMAXHEADERS entries, the entries' sizes are added up.
+        - 7z: the header, if it is no larger than SUMMARYMAXHEADER,
+          which has the number of entries and the packed and
+          unpacked sizes.  A compressed (LZMA or LZMA2) header is
+          decompressed if it is no larger than SUMMARYMAXHEADER
+          when uncompressed.
+          It is solid if any folder (a separately compressed block)
+          has more than one file.
+        - gzip: the last 4 bytes (ISIZE), the uncompressed size
+          modulo 4GB.
+
+    Anything that is not found is left unset (see the has* flags).
+
+    summaryReadEncryption() counts the encrypted and the plain entries
+    from the structures that a listing reads first, without reading
+    any entry's data, so an archive with encrypted entries can be
+    flagged before (or instead of) listing it:
+
+        - zip: the central directory, if it is no larger than
+          SUMMARYMAXDIRECTORY, where bit 0 of each entry's flags is
+          set if the entry is encrypted.
+        - 7z: the header, if it is no larger than SUMMARYMAXDIRECTORY
+          (and, if it is compressed, when uncompressed).  The files
+          in a folder that has an AES coder are encrypted, and the
+          other files, including empty files and directories, are
+          plain.  If the header itself is encrypted, there are no
+          counts, but headersEncrypted is set.
+        - rar (RAR 5 and RAR 4): the block headers, up to
+          SUMMARYMAXBLOCKS of them, skipping the data after each one
+          with a seek.  A RAR 5 file header is encrypted if its
+          extra area has an encryption record, and a RAR 4 file
+          header if it has the password flag.  If the archive's
+          headers are encrypted (an encryption header, or the
+          password flag in a RAR 4 main header), there are no counts,
+          but headersEncrypted is set.  Only the entries in this
+          volume of a multi-volume archive are counted.
+
+    For other formats there are no counts, and gSummaryErr is
+    returned.
+*/
+
+#ifndef qlZipInfo_summary_h
+#define qlZipInfo_summary_h
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/* return codes */
+
+enum
+{
+    gSummaryErr  = -1,
+    gSummaryOkay =  0,
+};
+
+/* read budget */
+
+#define SUMMARYHEADLEN    512
+#define SUMMARYMAXHEADER  131072
+#define SUMMARYMAXHEADERS 1024
+
+/* encryption census budget */
+
+#define SUMMARYMAXDIRECTORY (64 * 1024 * 1024)
+#define SUMMARYMAXBLOCKS    1000000
+
+/* formats */
+
+typedef enum
+{
+    SummaryFormatUnknown = 0,
+    SummaryFormatZip,
+    SummaryFormat7Zip,
+    SummaryFormatGZip,
+    SummaryFormatBZip2,
+    SummaryFormatXZ,
+    SummaryFormatCompress,
+    SummaryFormatRar,
+    SummaryFormatXar,
+    SummaryFormatTar,
+    SummaryFormatAr,
+    SummaryFormatDeb,
+    SummaryFormatCab,
+    SummaryFormatRpm,
+    SummaryFormatCpio,
+    SummaryFormatLha,
+    SummaryFormatISO9660,
+    SummaryFormatSit,
+    SummaryFormatBinHex,
+    SummaryFormatMax,
+} summaryFormat_t;
+
+/* summary */
+
+typedef struct summary
+{
+    summaryFormat_t format;
+    off_t fileSize;
+    uint64_t entries;
+    uint64_t uncompressedSize;
+    uint64_t compressedSize;
+    int hasEntries;
+    int hasSizes;
+    int encrypted;
+    int solid;
+} summary_t;
+
+/* encryption census */
+
+typedef struct summaryEncryption
+{
+    summaryFormat_t format;
+    uint64_t encryptedEntries;
+    uint64_t plainEntries;
+    int headersEncrypted;
+} summaryEncryption_t;
+
+/* prototypes */
+
+int summaryRead(const char *path, summary_t *summary);
+int summaryReadFd(int fd, summary_t *summary);
+int summaryReadEncryption(const char *path,
+                          summaryEncryption_t *encryption);
+int summaryReadEncryptionFd(int fd, summaryEncryption_t *encryption);
+const char *summaryFormatName(summaryFormat_t format);
+
+#endif /* qlZipInfo_summary_h */
@@ -0,0 +1,496 @@
+/*
+    thumbnail.c - render an archive summary as a thumbnail
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "thumbnail.h"
+
+/* font metrics, each glyph is drawn in a 6x8 cell */
+
+#define THUMBGLYPHWIDTH  5
+#define THUMBGLYPHHEIGHT 7
+#define THUMBCELLWIDTH   6
+#define THUMBCELLHEIGHT  8
+
+/* maximum number of lines below the band */
+
+#define THUMBMAXLINES 4
+
+/* colors, as 0xRRGGBB */
+
+enum
+{
+    gThumbColorBackground = 0xF4F5F5,
+    gThumbColorBorder     = 0xDDDDDD,
+    gThumbColorText       = 0x231D2D,
+    gThumbColorBandText   = 0xFFFFFF,
+};
+
+/* band colors for each format */
+
+static const uint32_t gThumbBandColors[SummaryFormatMax] =
+{
+    0x5A6270,   /* unknown          */
+    0x2F6DB5,   /* zip              */
+    0x3C8D40,   /* 7z               */
+    0xC8702A,   /* gzip             */
+    0xC8702A,   /* bzip2            */
+    0xC8702A,   /* xz               */
+    0xC8702A,   /* compress         */
+    0x7A4FA3,   /* rar              */
+    0x2F8F8F,   /* xar              */
+    0x8A6440,   /* tar              */
+    0x8A6440,   /* ar               */
+    0xB23A48,   /* deb              */
+    0x2F6DB5,   /* cab              */
+    0xB23A48,   /* rpm              */
+    0x8A6440,   /* cpio             */
+    0x3C8D40,   /* lha              */
+    0x5A6270,   /* iso9660          */
+    0x2F8F8F,   /* sit              */
+    0x2F8F8F,   /* binhex           */
+};
+
+/* 5x7 glyphs, one byte per row, with the leftmost pixel in bit 4 */
+
+static const uint8_t gThumbLetters[26][THUMBGLYPHHEIGHT] =
+{
+    { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 },   /* A */
+    { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E },   /* B */
+    { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E },   /* C */
+    { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C },   /* D */
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F },   /* E */
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 },   /* F */
+    { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F },   /* G */
+    { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 },   /* H */
+    { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E },   /* I */
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C },   /* J */
+    { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 },   /* K */
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F },   /* L */
+    { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 },   /* M */
+    { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },   /* N */
+    { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },   /* O */
+    { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 },   /* P */
+    { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D },   /* Q */
+    { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 },   /* R */
+    { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E },   /* S */
+    { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },   /* T */
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },   /* U */
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 },   /* V */
+    { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A },   /* W */
+    { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 },   /* X */
+    { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 },   /* Y */
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F },   /* Z */
+};
+
+static const uint8_t gThumbDigits[10][THUMBGLYPHHEIGHT] =
+{
+    { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E },   /* 0 */
+    { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E },   /* 1 */
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F },   /* 2 */
+    { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },   /* 3 */
+    { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 },   /* 4 */
+    { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E },   /* 5 */
+    { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E },   /* 6 */
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },   /* 7 */
+    { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E },   /* 8 */
+    { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C },   /* 9 */
+};
+
+static const uint8_t gThumbPeriod[THUMBGLYPHHEIGHT] =
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C };
+static const uint8_t gThumbComma[THUMBGLYPHHEIGHT] =
+    { 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 };
+static const uint8_t gThumbPercent[THUMBGLYPHHEIGHT] =
+    { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 };
+static const uint8_t gThumbDash[THUMBGLYPHHEIGHT] =
+    { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 };
+static const uint8_t gThumbQuestion[THUMBGLYPHHEIGHT] =
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 };
+
+/* private functions */
+
+static const uint8_t *thumbGetGlyph(char c);
+static void thumbFillRect(thumbImage_t *image,
+                          size_t x,
+                          size_t y,
+                          size_t width,
+                          size_t height,
+                          uint32_t color);
+static size_t thumbTextWidth(const char *text, size_t scale);
+static size_t thumbTextScale(const char *text,
+                             size_t maxWidth,
+                             size_t maxHeight);
+static void thumbDrawText(thumbImage_t *image,
+                          size_t x,
+                          size_t y,
+                          size_t scale,
+                          const char *text,
+                          uint32_t color);
+static void thumbFormatCount(char *buf, size_t bufLen, uint64_t count);
+static void thumbFormatSize(char *buf, size_t bufLen, uint64_t size);
+
+/* thumbGetGlyph - get the glyph for c, or NULL for a space */
+
+static const uint8_t *thumbGetGlyph(char c)
+{
+    if (c >= 'a' && c <= 'z')
+    {
+        c = (char)(c - 'a' + 'A');
+    }
+
+    if (c >= 'A' && c <= 'Z')
+    {
+        return gThumbLetters[c - 'A'];
+    }
+
+    if (c >= '0' && c <= '9')
+    {
+        return gThumbDigits[c - '0'];
+    }
+
+    switch (c)
+    {
+        case ' ':
+            return NULL;
+        case '.':
+            return gThumbPeriod;
+        case ',':
+            return gThumbComma;
+        case '%':
+            return gThumbPercent;
+        case '-':
+            return gThumbDash;
+        default:
+            return gThumbQuestion;
+    }
+}
+
+/* thumbFillRect - fill a rectangle, clipped to the image */
+
+static void thumbFillRect(thumbImage_t *image,
+                          size_t x,
+                          size_t y,
+                          size_t width,
+                          size_t height,
+                          uint32_t color)
+{
+    uint8_t pixel[4];
+    uint8_t *row = NULL;
+    size_t i = 0, j = 0;
+
+    if (x >= image->width || y >= image->height)
+    {
+        return;
+    }
+
+    if (width > image->width - x)
+    {
+        width = image->width - x;
+    }
+
+    if (height > image->height - y)
+    {
+        height = image->height - y;
+    }
+
+    if (width == 0 || height == 0)
+    {
+        return;
+    }
+
+    pixel[0] = (uint8_t)(color >> 16);
+    pixel[1] = (uint8_t)(color >> 8);
+    pixel[2] = (uint8_t)color;
+    pixel[3] = 0xFF;
+
+    /* fill the first row, and copy it to the others */
+
+    row = image->pixels + y * image->bytesPerRow + x * 4;
+    for (i = 0; i < width; i++)
+    {
+        memcpy(row + i * 4, pixel, 4);
+    }
+
+    for (j = 1; j < height; j++)
+    {
+        memcpy(row + j * image->bytesPerRow, row, width * 4);
+    }
+}
+
+/* thumbTextWidth - get the width of text drawn at scale */
+
+static size_t thumbTextWidth(const char *text, size_t scale)
+{
+    size_t len = strlen(text);
+
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    return (len * THUMBCELLWIDTH - 1) * scale;
+}
+
+/*
+    thumbTextScale - get the largest scale at which text fits in
+                     maxWidth x maxHeight, or 0 if it doesn't fit
+*/
+
+static size_t thumbTextScale(const char *text,
+                             size_t maxWidth,
+                             size_t maxHeight)
+{
+    size_t widthScale = 0;
+    size_t heightScale = 0;
+    size_t unitWidth = thumbTextWidth(text, 1);
+
+    if (unitWidth == 0)
+    {
+        return 0;
+    }
+
+    widthScale = maxWidth / unitWidth;
+    heightScale = maxHeight / THUMBCELLHEIGHT;
+
+    return (widthScale < heightScale ? widthScale : heightScale);
+}
+
+/* thumbDrawText - draw text with its top left corner at x, y */
+
+static void thumbDrawText(thumbImage_t *image,
+                          size_t x,
+                          size_t y,
+                          size_t scale,
+                          const char *text,
+                          uint32_t color)
+{
+    const uint8_t *glyph = NULL;
+    size_t row = 0, col = 0;
+
+    for (; *text != '\0'; text++, x += THUMBCELLWIDTH * scale)
+    {
+        glyph = thumbGetGlyph(*text);
+        if (glyph == NULL)
+        {
+            continue;
+        }
+
+        for (row = 0; row < THUMBGLYPHHEIGHT; row++)
+        {
+            for (col = 0; col < THUMBGLYPHWIDTH; col++)
+            {
+                if (glyph[row] & (0x10 >> col))
+                {
+                    thumbFillRect(image,
+                                  x + col * scale,
+                                  y + row * scale,
+                                  scale,
+                                  scale,
+                                  color);
+                }
+            }
+        }
+    }
+}
+
+/* thumbFormatCount - format an entry count, with commas */
+
+static void thumbFormatCount(char *buf, size_t bufLen, uint64_t count)
+{
+    char digits[24];
+    size_t numDigits = 0;
+    size_t i = 0, j = 0;
+
+    numDigits = (size_t)snprintf(digits, sizeof(digits), "%llu",
+                                 (unsigned long long)count);
+
+    for (i = 0; i < numDigits && j + 1 < bufLen; i++)
+    {
+        if (i > 0 && (numDigits - i) % 3 == 0 && j + 2 < bufLen)
+        {
+            buf[j++] = ',';
+        }
+        buf[j++] = digits[i];
+    }
+    buf[j] = '\0';
+
+    snprintf(buf + j, bufLen - j, (count == 1 ? " ITEM" : " ITEMS"));
+}
+
+/* thumbFormatSize - format a size in B, KB, MB, GB, or TB */
+
+static void thumbFormatSize(char *buf, size_t bufLen, uint64_t size)
+{
+    static const char *units[] = { "KB", "MB", "GB", "TB" };
+    double value = (double)size;
+    int unit = -1;
+
+    if (size < 1000)
+    {
+        snprintf(buf, bufLen, "%llu B", (unsigned long long)size);
+        return;
+    }
+
+    while (value >= 1000.0 && unit < 3)
+    {
+        value /= 1000.0;
+        unit++;
+    }
+
+    snprintf(buf, bufLen, (value < 100.0 ? "%.1f %s" : "%.0f %s"),
+             value, units[unit]);
+}
+
+/* public functions */
+
+/*
+    thumbRender - draw the thumbnail for summary into image, which
+                  must be between THUMBMINSIZE and THUMBMAXSIZE pixels
+                  on each side
+*/
+
+int thumbRender(const summary_t *summary, thumbImage_t *image)
+{
+    char lines[THUMBMAXLINES][THUMBMAXLINE];
+    const char *label = NULL;
+    size_t numLines = 0;
+    size_t bandHeight = 0;
+    size_t scale = 0, lineScale = 0;
+    size_t margin = 0;
+    size_t lineHeight = 0;
+    size_t y = 0;
+    size_t i = 0;
+    double saved = 0.0;
+
+    if (summary == NULL ||
+        image == NULL ||
+        image->pixels == NULL ||
+        image->width < THUMBMINSIZE || image->width > THUMBMAXSIZE ||
+        image->height < THUMBMINSIZE || image->height > THUMBMAXSIZE ||
+        image->bytesPerRow < image->width * 4)
+    {
+        return gThumbErr;
+    }
+
+    /* the card, with a border */
+
+    thumbFillRect(image, 0, 0, image->width, image->height,
+                  gThumbColorBorder);
+    thumbFillRect(image, 1, 1, image->width - 2, image->height - 2,
+                  gThumbColorBackground);
+
+    /* the format, in a colored band */
+
+    bandHeight = image->height * 3 / 10;
+    margin = image->width / 12;
+
+    thumbFillRect(image, 1, 1, image->width - 2, bandHeight,
+                  gThumbBandColors[summary->format < SummaryFormatMax ?
+                                   summary->format :
+                                   SummaryFormatUnknown]);
+
+    label = summaryFormatName(summary->format);
+    scale = thumbTextScale(label, image->width - 2 * margin, bandHeight);
+    if (scale > 0)
+    {
+        thumbDrawText(image,
+                      (image->width - thumbTextWidth(label, scale)) / 2,
+                      1 + (bandHeight - THUMBGLYPHHEIGHT * scale) / 2,
+                      scale,
+                      label,
+                      gThumbColorBandText);
+    }
+
+    /* the details, if there is room for them */
+
+    if (summary->hasEntries)
+    {
+        thumbFormatCount(lines[numLines++], THUMBMAXLINE, summary->entries);
+    }
+
+    thumbFormatSize(lines[numLines++], THUMBMAXLINE,
+                    (uint64_t)summary->fileSize);
+
+    if (summary->hasSizes &&
+        summary->uncompressedSize > 0 &&
+        summary->compressedSize > 0)
+    {
+        saved = 100.0 * (1.0 - (double)summary->compressedSize /
+                               (double)summary->uncompressedSize);
+        if (saved >= 1.0 && saved < 99.95)
+        {
+            snprintf(lines[numLines++], THUMBMAXLINE, "%.0f%% SAVED", saved);
+        }
+        else if (saved < 1.0)
+        {
+            snprintf(lines[numLines++], THUMBMAXLINE, "STORED");
+        }
+    }
+
+    if (summary->encrypted)
+    {
+        snprintf(lines[numLines++], THUMBMAXLINE, "ENCRYPTED");
+    }
+
+    /* all of the lines are drawn at the same scale */
+
+    lineHeight = (image->height - bandHeight - 2 * margin) / THUMBMAXLINES;
+    scale = 0;
+    for (i = 0; i < numLines; i++)
+    {
+        lineScale = thumbTextScale(lines[i],
+                                   image->width - 2 * margin,
+                                   lineHeight);
+        if (i == 0 || lineScale < scale)
+        {
+            scale = lineScale;
+        }
+    }
+
+    if (scale == 0)
+    {
+        return gThumbOkay;
+    }
+
+    y = 1 + bandHeight + margin;
+    for (i = 0; i < numLines; i++)
+    {
+        thumbDrawText(image,
+                      margin,
+                      y,
+                      scale,
+                      lines[i],
+                      gThumbColorText);
+        y += lineHeight;
+    }
+
+    return gThumbOkay;
+}
@@ -0,0 +1,82 @@
+/*
+    thumbnail.h - render an archive summary as a thumbnail
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    The thumbnail is drawn into a caller supplied 32 bit RGBA buffer
+    (R, G, B, A in memory order, which is what CGBitmapContextCreate()
+    takes with kCGImageAlphaPremultipliedLast | kCGBitmapByteOrder32Big)
+    with a built in 5x7 pixel font, so it doesn't need CoreGraphics or
+    CoreText and takes the same time on every platform.  It shows:
+
+        - the format, in a band whose color depends on the format
+        - the number of entries, if known
+        - the archive's size
+        - how much smaller the archive is than its contents, if known
+*/
+
+#ifndef qlZipInfo_thumbnail_h
+#define qlZipInfo_thumbnail_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "summary.h"
+
+/* return codes */
+
+enum
+{
+    gThumbErr  = -1,
+    gThumbOkay =  0,
+};
+
+/* smallest and largest thumbnails that are drawn */
+
+#define THUMBMINSIZE 16
+#define THUMBMAXSIZE 1024
+
+/* longest line of text */
+
+#define THUMBMAXLINE 32
+
+/* image */
+
+typedef struct thumbImage
+{
+    uint8_t *pixels;
+    size_t width;
+    size_t height;
+    size_t bytesPerRow;
+} thumbImage_t;
+
+/* prototypes */
+
+int thumbRender(const summary_t *summary, thumbImage_t *image);
+
+#endif /* qlZipInfo_thumbnail_h */
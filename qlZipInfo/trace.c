@@ -0,0 +1,361 @@
+/*
+    trace.c - per-phase timing and counters for preview generation
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    Trace Event Format
+    https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "archive.h"
+
+#include "trace.h"
+
+/* defines */
+
+/*
+    maximum number of individual phase events kept per trace; phases
+    past this limit are still added to the per-phase totals
+*/
+
+#define TRACEMAXEVENTS 65536
+
+/* structs */
+
+typedef struct traceEvent
+{
+    uint64_t start;
+    uint64_t duration;
+    tracePhase_t phase;
+} traceEvent_t;
+
+typedef struct traceState
+{
+    char path[PATH_MAX];
+    uint64_t start;
+    traceEvent_t *events;
+    size_t numEvents;
+    size_t droppedEvents;
+    uint64_t phaseTime[TracePhaseMax];
+    uint64_t phaseCalls[TracePhaseMax];
+    int64_t counters[TraceCounterMax];
+} traceState_t;
+
+/* globals */
+
+__thread int gTraceEnabled = 0;
+
+static __thread traceState_t *gTraceState = NULL;
+static unsigned long gTraceSeq = 0;
+
+/* private functions */
+
+static la_int64_t traceArchiveNow(void);
+static void traceArchivePhase(int phase, la_int64_t start);
+static void traceArchiveCount(int counter, la_int64_t value);
+
+/* hooks through which libarchive reports its phases and counters */
+
+static const struct archive_trace gTraceArchiveHooks =
+{
+    traceArchiveNow,
+    traceArchivePhase,
+    traceArchiveCount,
+};
+
+static const char *gTracePhaseNames[TracePhaseMax] =
+{
+    "preview",
+    "open",
+    "bid",
+    "read",
+    "decompress",
+    "header",
+    "convert",
+    "html",
+};
+
+static const char *gTraceCounterNames[TraceCounterMax] =
+{
+    "bytesRead",
+    "bytesDecompressed",
+    "headersParsed",
+    "allocations",
+    "rowsRendered",
+    "cancelChecks",
+};
+
+/* traceNow - get the current monotonic time in nanoseconds */
+
+uint64_t traceNow(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+    {
+        return 0;
+    }
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* traceArchiveNow - archive_trace hook for traceNow() */
+
+static la_int64_t traceArchiveNow(void)
+{
+    return (la_int64_t)traceNow();
+}
+
+/* traceArchivePhase - archive_trace hook for traceEnd() */
+
+static void traceArchivePhase(int phase, la_int64_t start)
+{
+    switch (phase)
+    {
+        case ARCHIVE_TRACE_BID:
+            traceEnd(TracePhaseBid, (uint64_t)start);
+            break;
+        case ARCHIVE_TRACE_READ:
+            traceEnd(TracePhaseRead, (uint64_t)start);
+            break;
+        case ARCHIVE_TRACE_DECOMPRESS:
+            traceEnd(TracePhaseDecompress, (uint64_t)start);
+            break;
+        case ARCHIVE_TRACE_HEADER:
+            traceEnd(TracePhaseHeader, (uint64_t)start);
+            break;
+        default:
+            break;
+    }
+}
+
+/* traceArchiveCount - archive_trace hook for traceCount() */
+
+static void traceArchiveCount(int counter, la_int64_t value)
+{
+    switch (counter)
+    {
+        case ARCHIVE_TRACE_BYTES_READ:
+            traceCount(TraceCounterBytesRead, value);
+            break;
+        case ARCHIVE_TRACE_BYTES_DECOMPRESSED:
+            traceCount(TraceCounterBytesDecompressed, value);
+            break;
+        case ARCHIVE_TRACE_HEADERS_PARSED:
+            traceCount(TraceCounterHeadersParsed, value);
+            break;
+        case ARCHIVE_TRACE_ALLOCATIONS:
+            traceCount(TraceCounterAllocations, value);
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+    traceStart - start recording a trace on the current thread, if
+                 traceDir is not NULL or empty
+*/
+
+int traceStart(const char *traceDir)
+{
+    traceState_t *state = NULL;
+
+    if (traceDir == NULL || traceDir[0] == '\0' || gTraceState != NULL)
+    {
+        return gTraceOkay;
+    }
+
+    state = calloc(1, sizeof(traceState_t));
+    if (state == NULL)
+    {
+        return gTraceErr;
+    }
+
+    state->events = malloc(TRACEMAXEVENTS * sizeof(traceEvent_t));
+    if (state->events == NULL)
+    {
+        free(state);
+        return gTraceErr;
+    }
+
+    snprintf(state->path,
+             sizeof(state->path),
+             "%s/qlZipInfo-%d-%lu.json",
+             traceDir,
+             (int)getpid(),
+             __sync_fetch_and_add(&gTraceSeq, 1));
+
+    state->start = traceNow();
+    gTraceState = state;
+    gTraceEnabled = 1;
+    archive_set_trace(&gTraceArchiveHooks);
+
+    return gTraceOkay;
+}
+
+/* traceEnd - record a phase that began at start */
+
+void traceEnd(tracePhase_t phase, uint64_t start)
+{
+    traceState_t *state = gTraceState;
+    uint64_t duration = 0;
+
+    if (state == NULL || phase < 0 || phase >= TracePhaseMax)
+    {
+        return;
+    }
+
+    duration = traceNow() - start;
+
+    state->phaseTime[phase] += duration;
+    state->phaseCalls[phase]++;
+
+    if (state->numEvents >= TRACEMAXEVENTS)
+    {
+        state->droppedEvents++;
+        return;
+    }
+
+    state->events[state->numEvents].start = start;
+    state->events[state->numEvents].duration = duration;
+    state->events[state->numEvents].phase = phase;
+    state->numEvents++;
+}
+
+/* traceCount - add value to a counter */
+
+void traceCount(traceCounter_t counter, int64_t value)
+{
+    if (gTraceState == NULL || counter < 0 || counter >= TraceCounterMax)
+    {
+        return;
+    }
+
+    gTraceState->counters[counter] += value;
+}
+
+/*
+    traceStop - stop recording on the current thread and write the
+                trace as Chrome trace event JSON
+*/
+
+int traceStop(void)
+{
+    traceState_t *state = gTraceState;
+    FILE *fp = NULL;
+    uint64_t end = 0;
+    size_t i = 0;
+    int pid = 0;
+
+    if (state == NULL)
+    {
+        return gTraceOkay;
+    }
+
+    gTraceEnabled = 0;
+    gTraceState = NULL;
+    archive_set_trace(NULL);
+
+    end = traceNow();
+    pid = (int)getpid();
+
+    fp = fopen(state->path, "w");
+    if (fp == NULL)
+    {
+        fprintf(stderr,
+                "qlZipInfo: ERROR: cannot write trace '%s'\n",
+                state->path);
+        free(state->events);
+        free(state);
+        return gTraceErr;
+    }
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(fp,
+            "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+            "\"tid\":1,\"args\":{\"name\":\"qlZipInfo\"}}",
+            pid);
+
+    /* timestamps and durations are in microseconds */
+
+    for (i = 0; i < state->numEvents; i++)
+    {
+        fprintf(fp,
+                ",\n{\"name\":\"%s\",\"cat\":\"qlZipInfo\",\"ph\":\"X\","
+                "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":1}",
+                gTracePhaseNames[state->events[i].phase],
+                (state->events[i].start - state->start) / 1000.0,
+                state->events[i].duration / 1000.0,
+                pid);
+    }
+
+    fprintf(fp,
+            ",\n{\"name\":\"counters\",\"ph\":\"C\",\"ts\":%.3f,"
+            "\"pid\":%d,\"tid\":1,\"args\":{",
+            (end - state->start) / 1000.0,
+            pid);
+    for (i = 0; i < TraceCounterMax; i++)
+    {
+        fprintf(fp,
+                "%s\"%s\":%lld",
+                (i > 0 ? "," : ""),
+                gTraceCounterNames[i],
+                (long long)state->counters[i]);
+    }
+    fprintf(fp, "}}\n],\n");
+
+    /* per-phase totals, including events past TRACEMAXEVENTS */
+
+    fprintf(fp,
+            "\"otherData\":{\"droppedEvents\":%lu,\"phases\":{",
+            (unsigned long)state->droppedEvents);
+    for (i = 0; i < TracePhaseMax; i++)
+    {
+        fprintf(fp,
+                "%s\"%s\":{\"calls\":%llu,\"us\":%.3f}",
+                (i > 0 ? "," : ""),
+                gTracePhaseNames[i],
+                (unsigned long long)state->phaseCalls[i],
+                state->phaseTime[i] / 1000.0);
+    }
+    fprintf(fp, "}}}\n");
+
+    fclose(fp);
+    free(state->events);
+    free(state);
+
+    return gTraceOkay;
+}
@@ -0,0 +1,104 @@
+/*
+    trace.h - per-phase timing and counters for preview generation
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    Tracing is off unless the environment variable QLZIPINFO_TRACE
+    names a directory.  When it is on, each preview writes a Chrome
+    trace (chrome://tracing, https://ui.perfetto.dev) to:
+
+        $QLZIPINFO_TRACE/qlZipInfo-<pid>-<n>.json
+
+    The trace state is per-thread, so concurrent previews do not
+    interfere with each other.  When tracing is off, each trace point
+    costs one test of a thread local flag (see traceIsEnabled()).
+    libarchive reports its phases and counters through the hooks
+    that traceStart() sets with archive_set_trace(), so it doesn't
+    depend on this file.
+
+    Phases nest along the call stack (for example, a decompress phase
+    inside a header phase includes the read phase of the filter
+    beneath it), so phase durations are inclusive.
+*/
+
+#ifndef qlZipInfo_trace_h
+#define qlZipInfo_trace_h
+
+#include <stdint.h>
+
+/* return codes */
+
+enum
+{
+    gTraceErr  = -1,
+    gTraceOkay =  0,
+};
+
+/* phases */
+
+typedef enum
+{
+    TracePhasePreview = 0,
+    TracePhaseOpen,
+    TracePhaseBid,
+    TracePhaseRead,
+    TracePhaseDecompress,
+    TracePhaseHeader,
+    TracePhaseConvert,
+    TracePhaseHTML,
+    TracePhaseMax,
+} tracePhase_t;
+
+/* counters */
+
+typedef enum
+{
+    TraceCounterBytesRead = 0,
+    TraceCounterBytesDecompressed,
+    TraceCounterHeadersParsed,
+    TraceCounterAllocations,
+    TraceCounterRowsRendered,
+    TraceCounterCancelChecks,
+    TraceCounterMax,
+} traceCounter_t;
+
+/* set while a trace is being recorded on the current thread */
+
+extern __thread int gTraceEnabled;
+
+#define traceIsEnabled() (gTraceEnabled != 0)
+
+/* prototypes */
+
+int traceStart(const char *traceDir);
+int traceStop(void);
+uint64_t traceNow(void);
+void traceEnd(tracePhase_t phase, uint64_t start);
+void traceCount(traceCounter_t counter, int64_t value);
+
+#endif /* qlZipInfo_trace_h */
@@ -0,0 +1,1019 @@
+/*
+    warcindex.c - index the records of a WARC file
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://iipc.github.io/warc-specifications/specifications/warc-format/warc-1.1/
+    https://iipc.github.io/warc-specifications/specifications/cdx-format/cdx-2015/
+    https://www.rfc-editor.org/rfc/rfc1952
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include "warcindex.h"
+
+/* defines */
+
+#define WARCMAGIC           "WARC/"
+#define WARCMAGICLEN        5
+#define WARCTRAILERLEN      4
+#define WARCDATELEN         14
+#define WARCINDEXWINDOW     16384
+#define WARCINDEXWINDOWMIN  4096
+#define WARCINDEXINLEN      65536
+#define WARCINDEXOUTLEN     65536
+#define WARCINDEXCDXBUFLEN  65536
+
+/* the fields of a record header that are indexed */
+
+typedef struct warcFields
+{
+    const char *type;
+    size_t typeLen;
+    const char *uri;
+    size_t uriLen;
+    const char *date;
+    size_t dateLen;
+    const char *length;
+    size_t lengthLen;
+} warcFields_t;
+
+/* where a record's strings are, until the string pool stops moving */
+
+typedef struct warcStrings
+{
+    size_t type;
+    size_t uri;
+} warcStrings_t;
+
+/* the state of an index being read */
+
+typedef struct warcIndexReader
+{
+    int fd;
+    off_t fileSize;
+    warcIndex_t *index;
+    warcStrings_t *strings;
+    uint32_t recordsSize;
+    size_t stringsLen;
+    size_t stringsSize;
+    unsigned char *buf;
+    off_t bufOffset;
+    size_t bufLen;
+    unsigned char *header;
+    size_t headerLen;
+    uint64_t skip;
+    uint32_t pending;
+} warcIndexReader_t;
+
+/* private functions */
+
+static ssize_t warcIndexReadAt(warcIndexReader_t *reader,
+                               void *buf,
+                               size_t len,
+                               off_t offset);
+static int warcIndexNameIs(const char *p, size_t len, const char *name);
+static size_t warcIndexTokenize(const unsigned char *buf,
+                                size_t len,
+                                warcFields_t *fields);
+static int warcIndexAddString(warcIndexReader_t *reader,
+                              const char *str,
+                              size_t len,
+                              size_t *offset);
+static int warcIndexAddRecord(warcIndexReader_t *reader,
+                              const warcFields_t *fields,
+                              uint64_t offset);
+static int warcIndexReadPlain(warcIndexReader_t *reader);
+static int warcIndexConsume(warcIndexReader_t *reader,
+                            const unsigned char *p,
+                            size_t n,
+                            uint64_t memberStart);
+static void warcIndexEndMember(warcIndexReader_t *reader,
+                               uint64_t memberEnd,
+                               int atEnd);
+static int warcIndexReadGzip(warcIndexReader_t *reader);
+static int warcIndexCdxPut(int fd,
+                           char *buf,
+                           size_t *bufLen,
+                           const char *str,
+                           int escape);
+
+/*
+    warcIndexReadAt - read up to len bytes at offset and add them to
+                      index->bytesRead, returns the number of bytes
+                      read or -1 on error
+*/
+
+static ssize_t warcIndexReadAt(warcIndexReader_t *reader,
+                               void *buf,
+                               size_t len,
+                               off_t offset)
+{
+    size_t total = 0;
+    ssize_t bytesRead = 0;
+
+    while (total < len)
+    {
+        bytesRead = pread(reader->fd,
+                          (unsigned char *)buf + total,
+                          len - total,
+                          offset + (off_t)total);
+        reader->index->reads++;
+        if (bytesRead < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        if (bytesRead == 0)
+        {
+            break;
+        }
+        total += (size_t)bytesRead;
+    }
+
+    reader->index->bytesRead += total;
+
+    return (ssize_t)total;
+}
+
+/*
+    warcIndexNameIs - check if the len bytes at p are the field name
+                      name, whose case doesn't matter
+*/
+
+static int warcIndexNameIs(const char *p, size_t len, const char *name)
+{
+    size_t i = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        if (name[i] == '\0' ||
+            (p[i] != name[i] &&
+             !((p[i] | 0x20) == (name[i] | 0x20) &&
+               (name[i] | 0x20) >= 'a' && (name[i] | 0x20) <= 'z')))
+        {
+            return 0;
+        }
+    }
+
+    return (name[len] == '\0');
+}
+
+/*
+    warcIndexTokenize - find the indexed fields of the record header
+                        at the start of buf in one pass over its
+                        lines, returns the length of the header, up
+                        to and including the empty line that ends it,
+                        or 0 if it doesn't end within buf
+*/
+
+static size_t warcIndexTokenize(const unsigned char *buf,
+                                size_t len,
+                                warcFields_t *fields)
+{
+    const unsigned char *end = buf + len;
+    const unsigned char *p = NULL;
+    const unsigned char *eol = NULL;
+    const unsigned char *colon = NULL;
+    const unsigned char *value = NULL;
+    const char **field = NULL;
+    size_t *fieldLen = NULL;
+    size_t nameLen = 0;
+
+    memset(fields, 0, sizeof(warcFields_t));
+
+    /* the version line */
+
+    p = memchr(buf, '\n', len);
+    if (p == NULL)
+    {
+        return 0;
+    }
+
+    for (p++; p < end; p = eol + 1)
+    {
+        eol = memchr(p, '\n', (size_t)(end - p));
+        if (eol == NULL)
+        {
+            return 0;
+        }
+
+        /* the empty line */
+
+        if (eol == p + 1 && *p == '\r')
+        {
+            return (size_t)(eol + 1 - buf);
+        }
+
+        /* skip lines that aren't CRLF terminated and continuations */
+
+        if (eol == p || eol[-1] != '\r' || *p == ' ' || *p == '\t')
+        {
+            continue;
+        }
+
+        colon = memchr(p, ':', (size_t)(eol - p));
+        if (colon == NULL)
+        {
+            continue;
+        }
+        nameLen = (size_t)(colon - p);
+
+        if (warcIndexNameIs((const char *)p, nameLen, "WARC-Type"))
+        {
+            field = &fields->type;
+            fieldLen = &fields->typeLen;
+        }
+        else if (warcIndexNameIs((const char *)p,
+                                 nameLen,
+                                 "WARC-Target-URI"))
+        {
+            field = &fields->uri;
+            fieldLen = &fields->uriLen;
+        }
+        else if (warcIndexNameIs((const char *)p, nameLen, "WARC-Date"))
+        {
+            field = &fields->date;
+            fieldLen = &fields->dateLen;
+        }
+        else if (warcIndexNameIs((const char *)p,
+                                 nameLen,
+                                 "Content-Length"))
+        {
+            field = &fields->length;
+            fieldLen = &fields->lengthLen;
+        }
+        else
+        {
+            continue;
+        }
+
+        /* the first of a repeated field is used */
+
+        if (*field != NULL)
+        {
+            continue;
+        }
+
+        for (value = colon + 1;
+             value < eol - 1 && (*value == ' ' || *value == '\t');
+             value++)
+        {
+        }
+
+        *field = (const char *)value;
+        *fieldLen = (size_t)(eol - 1 - value);
+    }
+
+    return 0;
+}
+
+/*
+    warcIndexAddString - add a string to the string pool, and get its
+                         offset in the pool
+*/
+
+static int warcIndexAddString(warcIndexReader_t *reader,
+                              const char *str,
+                              size_t len,
+                              size_t *offset)
+{
+    size_t newSize = 0;
+    char *p = NULL;
+
+    if (reader->stringsLen + len + 1 > reader->stringsSize)
+    {
+        newSize = (reader->stringsSize > 0 ?
+                   reader->stringsSize * 2 : 65536);
+        while (newSize < reader->stringsLen + len + 1)
+        {
+            newSize *= 2;
+        }
+        p = realloc(reader->index->strings, newSize);
+        if (p == NULL)
+        {
+            return gWarcIndexErr;
+        }
+        reader->index->strings = p;
+        reader->stringsSize = newSize;
+    }
+
+    if (len > 0)
+    {
+        memcpy(reader->index->strings + reader->stringsLen, str, len);
+    }
+    reader->index->strings[reader->stringsLen + len] = '\0';
+    *offset = reader->stringsLen;
+    reader->stringsLen += len + 1;
+
+    return gWarcIndexOkay;
+}
+
+/*
+    warcIndexAddRecord - add the record with the header fields at
+                         offset; its length is set by the caller
+*/
+
+static int warcIndexAddRecord(warcIndexReader_t *reader,
+                              const warcFields_t *fields,
+                              uint64_t offset)
+{
+    warcIndex_t *index = reader->index;
+    warcRecord_t *record = NULL;
+    uint64_t contentLength = 0;
+    size_t newSize = 0;
+    size_t i = 0;
+    size_t d = 0;
+    void *p = NULL;
+
+    /* Content-Length is mandatory, and all digits */
+
+    if (fields->length == NULL || fields->lengthLen == 0)
+    {
+        return gWarcIndexErr;
+    }
+    for (i = 0; i < fields->lengthLen; i++)
+    {
+        if (fields->length[i] < '0' || fields->length[i] > '9' ||
+            contentLength > (UINT64_MAX - 9) / 10)
+        {
+            return gWarcIndexErr;
+        }
+        contentLength = contentLength * 10 +
+                        (uint64_t)(fields->length[i] - '0');
+    }
+
+    if (index->numRecords == reader->recordsSize)
+    {
+        newSize = (reader->recordsSize > 0 ?
+                   (size_t)reader->recordsSize * 2 : 1024);
+        p = realloc(index->records, newSize * sizeof(warcRecord_t));
+        if (p == NULL)
+        {
+            return gWarcIndexErr;
+        }
+        index->records = p;
+        p = realloc(reader->strings, newSize * sizeof(warcStrings_t));
+        if (p == NULL)
+        {
+            return gWarcIndexErr;
+        }
+        reader->strings = p;
+        reader->recordsSize = (uint32_t)newSize;
+    }
+
+    if (warcIndexAddString(reader,
+                           fields->type,
+                           fields->typeLen,
+                           &reader->strings[index->numRecords].type) !=
+            gWarcIndexOkay ||
+        warcIndexAddString(reader,
+                           fields->uri,
+                           fields->uriLen,
+                           &reader->strings[index->numRecords].uri) !=
+            gWarcIndexOkay)
+    {
+        return gWarcIndexErr;
+    }
+
+    record = &index->records[index->numRecords];
+    memset(record, 0, sizeof(warcRecord_t));
+    record->offset = offset;
+    record->contentLength = contentLength;
+
+    /* the date's digits, 2024-03-09T14:30:00Z as 20240309143000 */
+
+    for (i = 0; i < fields->dateLen && d < WARCDATELEN; i++)
+    {
+        if (fields->date[i] >= '0' && fields->date[i] <= '9')
+        {
+            record->date[d++] = fields->date[i];
+        }
+    }
+    record->date[d] = '\0';
+
+    index->numRecords++;
+
+    return gWarcIndexOkay;
+}
+
+/*
+    warcIndexReadPlain - index an uncompressed WARC file, reading only
+                         the record headers, through a window that
+                         covers the headers of several small records,
+                         or just one header if the records are large
+*/
+
+static int warcIndexReadPlain(warcIndexReader_t *reader)
+{
+    warcIndex_t *index = reader->index;
+    warcFields_t fields;
+    warcRecord_t *record = NULL;
+    const unsigned char *p = NULL;
+    ssize_t bytesRead = 0;
+    uint64_t offset = 0;
+    size_t avail = 0;
+    size_t want = 0;
+    size_t headerLen = 0;
+
+    while (offset < (uint64_t)reader->fileSize)
+    {
+        if (index->numRecords >= WARCINDEXMAXRECORDS)
+        {
+            index->truncated = 1;
+            break;
+        }
+
+        /* the header, from the window if it is there */
+
+        want = WARCINDEXWINDOW;
+        if (index->numRecords > 0 &&
+            offset / index->numRecords > WARCINDEXWINDOW / 4)
+        {
+            want = WARCINDEXWINDOWMIN;
+        }
+
+        for (;;)
+        {
+            if ((off_t)offset >= reader->bufOffset &&
+                (off_t)offset < reader->bufOffset + (off_t)reader->bufLen)
+            {
+                p = reader->buf + (offset - (uint64_t)reader->bufOffset);
+                avail = reader->bufLen -
+                        (size_t)(offset - (uint64_t)reader->bufOffset);
+                headerLen = warcIndexTokenize(p, avail, &fields);
+                if (headerLen > 0 ||
+                    (off_t)(offset + avail) >= reader->fileSize ||
+                    avail >= WARCINDEXMAXHEADER)
+                {
+                    break;
+                }
+                want = (avail * 2 > WARCINDEXMAXHEADER ?
+                        WARCINDEXMAXHEADER : avail * 2);
+            }
+
+            if ((uint64_t)want > (uint64_t)reader->fileSize - offset)
+            {
+                want = (size_t)((uint64_t)reader->fileSize - offset);
+            }
+
+            reader->bufLen = 0;
+            bytesRead = warcIndexReadAt(reader,
+                                        reader->buf,
+                                        want,
+                                        (off_t)offset);
+            if (bytesRead <= 0)
+            {
+                return gWarcIndexErr;
+            }
+            reader->bufOffset = (off_t)offset;
+            reader->bufLen = (size_t)bytesRead;
+        }
+
+        if (avail < WARCMAGICLEN ||
+            memcmp(p, WARCMAGIC, WARCMAGICLEN) != 0 ||
+            headerLen == 0 ||
+            warcIndexAddRecord(reader, &fields, offset) != gWarcIndexOkay)
+        {
+            if (index->numRecords == 0)
+            {
+                return gWarcIndexErr;
+            }
+            index->truncated = 1;
+            break;
+        }
+
+        /* skip the content, and the CRLF CRLF after it */
+
+        record = &index->records[index->numRecords - 1];
+        record->length = headerLen + record->contentLength + WARCTRAILERLEN;
+        if (record->length > (uint64_t)reader->fileSize - offset)
+        {
+            record->length = (uint64_t)reader->fileSize - offset;
+            index->truncated = 1;
+        }
+        offset += record->length;
+    }
+
+    return gWarcIndexOkay;
+}
+
+/*
+    warcIndexConsume - pass n inflated bytes through the record
+                       parser: headers are parsed, and collected in
+                       reader->header if they span outputs, and the
+                       content after each is skipped
+*/
+
+static int warcIndexConsume(warcIndexReader_t *reader,
+                            const unsigned char *p,
+                            size_t n,
+                            uint64_t memberStart)
+{
+    warcIndex_t *index = reader->index;
+    warcFields_t fields;
+    warcRecord_t *record = NULL;
+    const unsigned char *header = NULL;
+    size_t headerLen = 0;
+    size_t used = 0;
+    size_t k = 0;
+
+    while (n > 0)
+    {
+        if (reader->skip > 0)
+        {
+            k = (reader->skip < n ? (size_t)reader->skip : n);
+            reader->skip -= k;
+            p += k;
+            n -= k;
+            continue;
+        }
+
+        if (reader->headerLen == 0)
+        {
+            /* a header that is all in this output is parsed in place */
+
+            headerLen = warcIndexTokenize(p, n, &fields);
+            if (headerLen == 0)
+            {
+                if (n > WARCINDEXMAXHEADER)
+                {
+                    return gWarcIndexErr;
+                }
+                memcpy(reader->header, p, n);
+                reader->headerLen = n;
+                return gWarcIndexOkay;
+            }
+            header = p;
+            used = headerLen;
+        }
+        else
+        {
+            /* add to the header that started in an earlier output */
+
+            k = WARCINDEXMAXHEADER - reader->headerLen;
+            if (k > n)
+            {
+                k = n;
+            }
+            memcpy(reader->header + reader->headerLen, p, k);
+            headerLen = warcIndexTokenize(reader->header,
+                                          reader->headerLen + k,
+                                          &fields);
+            if (headerLen == 0)
+            {
+                if (k < n)
+                {
+                    return gWarcIndexErr;
+                }
+                reader->headerLen += k;
+                return gWarcIndexOkay;
+            }
+            header = reader->header;
+            used = headerLen - reader->headerLen;
+        }
+
+        if (index->numRecords >= WARCINDEXMAXRECORDS)
+        {
+            index->truncated = 1;
+            return gWarcIndexErr;
+        }
+
+        if (memcmp(header, WARCMAGIC, WARCMAGICLEN) != 0 ||
+            warcIndexAddRecord(reader, &fields, memberStart) !=
+                gWarcIndexOkay)
+        {
+            return gWarcIndexErr;
+        }
+
+        record = &index->records[index->numRecords - 1];
+        reader->skip = record->contentLength + WARCTRAILERLEN;
+        reader->pending++;
+        reader->headerLen = 0;
+        p += used;
+        n -= used;
+    }
+
+    return gWarcIndexOkay;
+}
+
+/*
+    warcIndexEndMember - set the length of the records that started
+                         in the members up to memberEnd, once the
+                         last of them has ended
+*/
+
+static void warcIndexEndMember(warcIndexReader_t *reader,
+                               uint64_t memberEnd,
+                               int atEnd)
+{
+    warcIndex_t *index = reader->index;
+    uint32_t i = 0;
+
+    if (reader->pending == 0 ||
+        (!atEnd && (reader->skip > 0 || reader->headerLen > 0)))
+    {
+        /* a record goes on into the next member */
+
+        if (reader->pending > 0)
+        {
+            index->sharedMembers = 1;
+        }
+        return;
+    }
+
+    if (reader->pending > 1)
+    {
+        index->sharedMembers = 1;
+    }
+
+    for (i = index->numRecords - reader->pending; i < index->numRecords; i++)
+    {
+        index->records[i].length = memberEnd - index->records[i].offset;
+    }
+
+    reader->pending = 0;
+}
+
+/*
+    warcIndexReadGzip - index a WARC file of gzip members, inflating
+                        each member and keeping only the record
+                        headers
+*/
+
+static int warcIndexReadGzip(warcIndexReader_t *reader)
+{
+    warcIndex_t *index = reader->index;
+    unsigned char *out = NULL;
+    z_stream zs;
+    ssize_t bytesRead = 0;
+    uint64_t inOffset = 0;
+    uint64_t memberStart = 0;
+    uint64_t memberEnd = 0;
+    size_t produced = 0;
+    int inMember = 0;
+    int zr = Z_OK;
+    int r = gWarcIndexErr;
+
+    memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, 15 + 16) != Z_OK)
+    {
+        return gWarcIndexErr;
+    }
+
+    out = malloc(WARCINDEXOUTLEN);
+    reader->header = malloc(WARCINDEXMAXHEADER);
+    if (out == NULL || reader->header == NULL)
+    {
+        goto done;
+    }
+
+    for (;;)
+    {
+        if (zs.avail_in == 0)
+        {
+            bytesRead = warcIndexReadAt(reader,
+                                        reader->buf,
+                                        WARCINDEXINLEN,
+                                        (off_t)inOffset);
+            if (bytesRead < 0)
+            {
+                goto done;
+            }
+            if (bytesRead == 0)
+            {
+                break;
+            }
+            zs.next_in = reader->buf;
+            zs.avail_in = (uInt)bytesRead;
+            inOffset += (uint64_t)bytesRead;
+        }
+
+        zs.next_out = out;
+        zs.avail_out = WARCINDEXOUTLEN;
+        inMember = 1;
+        zr = inflate(&zs, Z_NO_FLUSH);
+        if (zr != Z_OK && zr != Z_STREAM_END && zr != Z_BUF_ERROR)
+        {
+            break;
+        }
+
+        produced = WARCINDEXOUTLEN - zs.avail_out;
+        index->bytesInflated += produced;
+
+        if (warcIndexConsume(reader, out, produced, memberStart) !=
+                gWarcIndexOkay)
+        {
+            break;
+        }
+
+        if (zr == Z_STREAM_END)
+        {
+            memberEnd = inOffset - zs.avail_in;
+            warcIndexEndMember(reader, memberEnd, 0);
+            memberStart = memberEnd;
+            inMember = 0;
+            inflateReset(&zs);
+        }
+    }
+
+    /* anything after the last whole member is ignored */
+
+    if (inMember || reader->pending > 0 || reader->headerLen > 0 ||
+        memberStart < (uint64_t)reader->fileSize)
+    {
+        if (index->numRecords == 0)
+        {
+            goto done;
+        }
+        index->truncated = 1;
+        warcIndexEndMember(reader, (uint64_t)reader->fileSize, 1);
+    }
+
+    r = gWarcIndexOkay;
+
+done:
+    inflateEnd(&zs);
+    free(out);
+
+    return r;
+}
+
+/* warcIndexCdxPut - add a field to a CDX line */
+
+static int warcIndexCdxPut(int fd,
+                           char *buf,
+                           size_t *bufLen,
+                           const char *str,
+                           int escape)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    unsigned char c = 0;
+    ssize_t written = 0;
+    size_t off = 0;
+
+    if (str == NULL || str[0] == '\0')
+    {
+        str = "-";
+    }
+
+    for (; *str != '\0'; str++)
+    {
+        if (*bufLen + 3 > WARCINDEXCDXBUFLEN)
+        {
+            for (off = 0; off < *bufLen; off += (size_t)written)
+            {
+                written = write(fd, buf + off, *bufLen - off);
+                if (written < 0 && errno == EINTR)
+                {
+                    written = 0;
+                    continue;
+                }
+                if (written <= 0)
+                {
+                    return gWarcIndexErr;
+                }
+            }
+            *bufLen = 0;
+        }
+
+        /* spaces and control characters would split the line */
+
+        c = (unsigned char)*str;
+        if (escape && (c <= ' ' || c == 0x7f))
+        {
+            buf[(*bufLen)++] = '%';
+            buf[(*bufLen)++] = hex[c >> 4];
+            buf[(*bufLen)++] = hex[c & 0x0f];
+        }
+        else
+        {
+            buf[(*bufLen)++] = (char)c;
+        }
+    }
+
+    return gWarcIndexOkay;
+}
+
+/* public functions */
+
+/* warcIndexRead - index the WARC file at path */
+
+int warcIndexRead(const char *path, warcIndex_t *index)
+{
+    int fd = -1;
+    int err = gWarcIndexErr;
+
+    if (path == NULL || index == NULL)
+    {
+        return gWarcIndexErr;
+    }
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        memset(index, 0, sizeof(warcIndex_t));
+        return gWarcIndexErr;
+    }
+
+    err = warcIndexReadFd(fd, index);
+
+    close(fd);
+
+    return err;
+}
+
+/*
+    warcIndexReadFd - index the WARC file open on fd, which is
+                      compressed if it starts with a gzip header
+*/
+
+int warcIndexReadFd(int fd, warcIndex_t *index)
+{
+    warcIndexReader_t reader;
+    struct stat fileStats;
+    unsigned char magic[2];
+    uint32_t i = 0;
+    int r = gWarcIndexErr;
+
+    if (index == NULL)
+    {
+        return gWarcIndexErr;
+    }
+
+    memset(index, 0, sizeof(warcIndex_t));
+    memset(&reader, 0, sizeof(warcIndexReader_t));
+
+    if (fd < 0 || fstat(fd, &fileStats) != 0 || !S_ISREG(fileStats.st_mode))
+    {
+        return gWarcIndexErr;
+    }
+
+    reader.fd = fd;
+    reader.fileSize = fileStats.st_size;
+    reader.index = index;
+    reader.buf = malloc(WARCINDEXINLEN > WARCINDEXMAXHEADER ?
+                        WARCINDEXINLEN : WARCINDEXMAXHEADER);
+    if (reader.buf == NULL)
+    {
+        return gWarcIndexErr;
+    }
+
+    if (warcIndexReadAt(&reader, magic, 2, 0) != 2)
+    {
+        goto done;
+    }
+
+    if (magic[0] == 0x1f && magic[1] == 0x8b)
+    {
+        index->compressed = 1;
+        r = warcIndexReadGzip(&reader);
+    }
+    else
+    {
+        r = warcIndexReadPlain(&reader);
+    }
+
+    if (r == gWarcIndexOkay)
+    {
+        /* the string pool has stopped moving */
+
+        for (i = 0; i < index->numRecords; i++)
+        {
+            index->records[i].type = index->strings + reader.strings[i].type;
+            index->records[i].uri = index->strings + reader.strings[i].uri;
+        }
+    }
+
+done:
+    if (r != gWarcIndexOkay)
+    {
+        warcIndexFree(index);
+    }
+    free(reader.buf);
+    free(reader.header);
+    free(reader.strings);
+
+    return r;
+}
+
+/*
+    warcIndexWriteCdx - write the index to fd as a CDX file, with the
+                        URI, date, length and offset of each record
+                        and the name of the WARC file, in file order
+*/
+
+int warcIndexWriteCdx(const warcIndex_t *index,
+                      const char *warcName,
+                      int fd)
+{
+    char buf[WARCINDEXCDXBUFLEN];
+    char number[32];
+    const char *name = NULL;
+    ssize_t written = 0;
+    size_t bufLen = 0;
+    size_t off = 0;
+    uint32_t i = 0;
+
+    if (index == NULL || fd < 0)
+    {
+        return gWarcIndexErr;
+    }
+
+    name = (warcName != NULL ? strrchr(warcName, '/') : NULL);
+    name = (name != NULL ? name + 1 : warcName);
+
+    if (warcIndexCdxPut(fd, buf, &bufLen, " CDX a b S V g\n", 0) !=
+            gWarcIndexOkay)
+    {
+        return gWarcIndexErr;
+    }
+
+    for (i = 0; i < index->numRecords; i++)
+    {
+        snprintf(number,
+                 sizeof(number),
+                 " %llu %llu ",
+                 (unsigned long long)index->records[i].length,
+                 (unsigned long long)index->records[i].offset);
+
+        if (warcIndexCdxPut(fd, buf, &bufLen,
+                            index->records[i].uri, 1) != gWarcIndexOkay ||
+            warcIndexCdxPut(fd, buf, &bufLen, " ", 0) != gWarcIndexOkay ||
+            warcIndexCdxPut(fd, buf, &bufLen,
+                            index->records[i].date, 1) != gWarcIndexOkay ||
+            warcIndexCdxPut(fd, buf, &bufLen, number, 0) != gWarcIndexOkay ||
+            warcIndexCdxPut(fd, buf, &bufLen, name, 1) != gWarcIndexOkay ||
+            warcIndexCdxPut(fd, buf, &bufLen, "\n", 0) != gWarcIndexOkay)
+        {
+            return gWarcIndexErr;
+        }
+    }
+
+    for (off = 0; off < bufLen; off += (size_t)written)
+    {
+        written = write(fd, buf + off, bufLen - off);
+        if (written < 0 && errno == EINTR)
+        {
+            written = 0;
+            continue;
+        }
+        if (written <= 0)
+        {
+            return gWarcIndexErr;
+        }
+    }
+
+    return gWarcIndexOkay;
+}
+
+/* warcIndexFree - free the records of an index */
+
+void warcIndexFree(warcIndex_t *index)
+{
+    if (index == NULL)
+    {
+        return;
+    }
+
+    free(index->records);
+    free(index->strings);
+    index->records = NULL;
+    index->strings = NULL;
+    index->numRecords = 0;
+}
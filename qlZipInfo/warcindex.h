@@ -0,0 +1,116 @@
+/*
+    warcindex.h - index the records of a WARC file
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://iipc.github.io/warc-specifications/specifications/warc-format/warc-1.1/
+    https://iipc.github.io/warc-specifications/specifications/cdx-format/cdx-2015/
+    https://www.rfc-editor.org/rfc/rfc1952
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    warcIndexRead() finds the offset and length of every record of a
+    .warc or .warc.gz file, with its type, target URI and date, so
+    that any record can later be read with one seek.
+
+    In a .warc file, only the record headers are read: each header is
+    parsed in one pass over its lines, and the record's content is
+    skipped with its Content-Length, without being read.
+
+    A .warc.gz file is a series of gzip members, normally one per
+    record.  Each member is inflated, with the output after the
+    record's header thrown away, and the record's offset and length
+    are those of its member, which is all that is needed to read the
+    record again.  deflate data has no lengths, so finding where a
+    member ends takes inflating it, but this is done once: the index
+    can be written as a CDX file with warcIndexWriteCdx(), whose
+    offsets and lengths go straight to a member.  A file that was
+    compressed as one stream, rather than record by record, is
+    indexed too, but its records all share the one member, and
+    sharedMembers is set.
+*/
+
+#ifndef qlZipInfo_warcindex_h
+#define qlZipInfo_warcindex_h
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/* return codes */
+
+enum
+{
+    gWarcIndexErr  = -1,
+    gWarcIndexOkay =  0,
+};
+
+/* longest record header that is parsed */
+
+#define WARCINDEXMAXHEADER  (1024 * 1024)
+
+/* most records that are indexed */
+
+#define WARCINDEXMAXRECORDS 10000000
+
+/* a record */
+
+typedef struct warcRecord
+{
+    const char *type;
+    const char *uri;
+    char date[15];
+    uint64_t offset;
+    uint64_t length;
+    uint64_t contentLength;
+} warcRecord_t;
+
+/* the index of a file */
+
+typedef struct warcIndex
+{
+    int compressed;
+    int sharedMembers;
+    int truncated;
+    uint32_t numRecords;
+    warcRecord_t *records;
+    char *strings;
+    uint64_t bytesRead;
+    uint64_t bytesInflated;
+    uint64_t reads;
+} warcIndex_t;
+
+/* prototypes */
+
+int warcIndexRead(const char *path, warcIndex_t *index);
+int warcIndexReadFd(int fd, warcIndex_t *index);
+int warcIndexWriteCdx(const warcIndex_t *index,
+                      const char *warcName,
+                      int fd);
+void warcIndexFree(warcIndex_t *index);
+
+#endif /* qlZipInfo_warcindex_h */
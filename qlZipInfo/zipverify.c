@@ -0,0 +1,1006 @@
+/*
+    zipverify.c - check zip passwords with the entries' verifiers
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+    https://www.winzip.com/en/support/aes-encryption/
+    https://www.rfc-editor.org/rfc/rfc8018
+    https://www.rfc-editor.org/rfc/rfc3174
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "archdir.h"
+#include "zipverify.h"
+
+/* zip fields */
+
+#define ZIPAESEXTRAID    0x9901
+#define ZIPAESMETHOD     99
+
+#define ZIPFLAGENCRYPTED 0x0001
+#define ZIPFLAGDATADESC  0x0008
+#define ZIPFLAGSTRONG    0x0040
+
+/* the ZipCrypto header, and the WinZip AES salt and key derivation */
+
+#define ZIPCRYPTHEADERLEN 12
+#define ZIPAESMAXSALT     16
+#define ZIPAESVERIFIERLEN 2
+#define ZIPAESITERATIONS  1000
+
+/* bytes read at each local header, enough for most names and extras */
+
+#define ZIPVERIFYPEEKLEN  512
+
+/* SHA-1 */
+
+#define SHA1BLOCKLEN      64
+#define SHA1DIGESTLEN     20
+
+/* HMAC-SHA1 states, after the key's inner and outer pad blocks */
+
+typedef struct zipVerifyHmac
+{
+    uint32_t inner[5];
+    uint32_t outer[5];
+} zipVerifyHmac_t;
+
+/* a cached WinZip AES verifier */
+
+typedef struct zipVerifyCacheSlot
+{
+    uint32_t password;
+    uint8_t used;
+    uint8_t saltLen;
+    uint8_t verifier[ZIPAESVERIFIERLEN];
+    uint8_t salt[ZIPAESMAXSALT];
+} zipVerifyCacheSlot_t;
+
+typedef struct zipVerifyShared zipVerifyShared_t;
+
+/* a worker */
+
+typedef struct zipVerifyWorker
+{
+    zipVerifyShared_t *shared;
+    pthread_t thread;
+    int started;
+    unsigned int lastPassword;
+    uint32_t opened;
+    uint32_t unreadable;
+    uint64_t verifications;
+    uint64_t keysDerived;
+    uint64_t cacheHits;
+} zipVerifyWorker_t;
+
+/* state shared by the workers */
+
+struct zipVerifyShared
+{
+    int fd;
+    zipVerify_t *info;
+    const char * const *passwords;
+    unsigned int numPasswords;
+    zipVerifyHmac_t *hmacs;
+    uint32_t *cryptKeys;
+    uint32_t crcTable[256];
+    uint32_t nextEntry;
+    zipVerifyCacheSlot_t *cache;
+    pthread_mutex_t cacheLock;
+};
+
+/* private functions */
+
+static void zipVerifySha1Words(uint32_t *h, const uint32_t *w);
+static void zipVerifySha1Block(uint32_t *h, const unsigned char *block);
+static void zipVerifySha1(const unsigned char *data,
+                          size_t len,
+                          unsigned char *digest);
+static void zipVerifyHmacInit(zipVerifyHmac_t *hmac,
+                              const char *password);
+static void zipVerifyPbkdf2Block(const zipVerifyHmac_t *hmac,
+                                 const unsigned char *salt,
+                                 size_t saltLen,
+                                 uint32_t blockIndex,
+                                 unsigned char *out);
+static void zipVerifyCryptInit(const uint32_t *crcTable,
+                               const char *password,
+                               uint32_t *keys);
+static int zipVerifyCryptCheck(const uint32_t *crcTable,
+                               const uint32_t *passwordKeys,
+                               const unsigned char *header);
+static void zipVerifyAESVerifier(zipVerifyWorker_t *worker,
+                                 unsigned int password,
+                                 zipCipher_t cipher,
+                                 const unsigned char *salt,
+                                 size_t saltLen,
+                                 unsigned char *verifier);
+static void zipVerifyEntry(zipVerifyWorker_t *worker,
+                           zipVerifyEntry_t *entry);
+static void *zipVerifyWorkerMain(void *arg);
+static int zipVerifyParseCD(const archDirCursor_t *cd,
+                            uint64_t numEntries,
+                            int64_t delta,
+                            zipVerify_t *info);
+static int zipVerifyRun(int fd,
+                        const char * const *passwords,
+                        unsigned int numPasswords,
+                        int numWorkers,
+                        zipVerify_t *info);
+
+/*
+    zipVerifySha1Words - add a block, given as 16 big endian words, to
+                         the SHA-1 state h
+*/
+
+#define SHA1ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static void zipVerifySha1Words(uint32_t *h, const uint32_t *w)
+{
+    uint32_t x[16];
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    uint32_t f = 0, t = 0;
+    int i = 0;
+
+    memcpy(x, w, sizeof(x));
+
+    for (i = 0; i < 80; i++)
+    {
+        if (i >= 16)
+        {
+            t = x[(i + 13) & 15] ^ x[(i + 8) & 15] ^
+                x[(i + 2) & 15] ^ x[i & 15];
+            x[i & 15] = SHA1ROTL(t, 1);
+        }
+
+        if (i < 20)
+        {
+            f = ((b & c) | (~b & d)) + 0x5A827999;
+        }
+        else if (i < 40)
+        {
+            f = (b ^ c ^ d) + 0x6ED9EBA1;
+        }
+        else if (i < 60)
+        {
+            f = ((b & c) | (b & d) | (c & d)) + 0x8F1BBCDC;
+        }
+        else
+        {
+            f = (b ^ c ^ d) + 0xCA62C1D6;
+        }
+
+        t = SHA1ROTL(a, 5) + f + e + x[i & 15];
+        e = d;
+        d = c;
+        c = SHA1ROTL(b, 30);
+        b = a;
+        a = t;
+    }
+
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+}
+
+/* zipVerifySha1Block - add a 64 byte block to the SHA-1 state h */
+
+static void zipVerifySha1Block(uint32_t *h, const unsigned char *block)
+{
+    uint32_t w[16];
+    int i = 0;
+
+    for (i = 0; i < 16; i++)
+    {
+        w[i] = ((uint32_t)block[4 * i] << 24) |
+               ((uint32_t)block[4 * i + 1] << 16) |
+               ((uint32_t)block[4 * i + 2] << 8) |
+               (uint32_t)block[4 * i + 3];
+    }
+
+    zipVerifySha1Words(h, w);
+}
+
+/* zipVerifySha1 - get the SHA-1 digest of data */
+
+static void zipVerifySha1(const unsigned char *data,
+                          size_t len,
+                          unsigned char *digest)
+{
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE,
+                      0x10325476, 0xC3D2E1F0 };
+    unsigned char block[SHA1BLOCKLEN];
+    uint64_t bits = (uint64_t)len * 8;
+    size_t rest = 0;
+    int i = 0;
+
+    for (; len >= SHA1BLOCKLEN; data += SHA1BLOCKLEN, len -= SHA1BLOCKLEN)
+    {
+        zipVerifySha1Block(h, data);
+    }
+
+    memset(block, 0, sizeof(block));
+    memcpy(block, data, len);
+    block[len] = 0x80;
+    rest = len + 1;
+
+    if (rest > SHA1BLOCKLEN - 8)
+    {
+        zipVerifySha1Block(h, block);
+        memset(block, 0, sizeof(block));
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        block[SHA1BLOCKLEN - 1 - i] = (unsigned char)(bits >> (8 * i));
+    }
+    zipVerifySha1Block(h, block);
+
+    for (i = 0; i < SHA1DIGESTLEN; i++)
+    {
+        digest[i] = (unsigned char)(h[i / 4] >> (24 - 8 * (i % 4)));
+    }
+}
+
+/*
+    zipVerifyHmacInit - set up the HMAC-SHA1 states of a password,
+                        which are the same for every salt
+*/
+
+static void zipVerifyHmacInit(zipVerifyHmac_t *hmac, const char *password)
+{
+    static const uint32_t iv[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE,
+                                    0x10325476, 0xC3D2E1F0 };
+    unsigned char key[SHA1BLOCKLEN];
+    unsigned char pad[SHA1BLOCKLEN];
+    size_t keyLen = strlen(password);
+    int i = 0;
+
+    memset(key, 0, sizeof(key));
+    if (keyLen > SHA1BLOCKLEN)
+    {
+        zipVerifySha1((const unsigned char *)password, keyLen, key);
+    }
+    else
+    {
+        memcpy(key, password, keyLen);
+    }
+
+    memcpy(hmac->inner, iv, sizeof(iv));
+    memcpy(hmac->outer, iv, sizeof(iv));
+
+    for (i = 0; i < SHA1BLOCKLEN; i++)
+    {
+        pad[i] = key[i] ^ 0x36;
+    }
+    zipVerifySha1Block(hmac->inner, pad);
+
+    for (i = 0; i < SHA1BLOCKLEN; i++)
+    {
+        pad[i] = key[i] ^ 0x5C;
+    }
+    zipVerifySha1Block(hmac->outer, pad);
+}
+
+/*
+    zipVerifyPbkdf2Block - derive block blockIndex (from 1) of
+                           PBKDF2-HMAC-SHA1 with ZIPAESITERATIONS
+                           iterations; each iteration hashes one
+                           padded block from each of the password's
+                           HMAC states
+*/
+
+static void zipVerifyPbkdf2Block(const zipVerifyHmac_t *hmac,
+                                 const unsigned char *salt,
+                                 size_t saltLen,
+                                 uint32_t blockIndex,
+                                 unsigned char *out)
+{
+    unsigned char first[SHA1BLOCKLEN];
+    uint32_t w[16];
+    uint32_t u[5];
+    uint32_t t[5];
+    uint64_t bits = (uint64_t)(SHA1BLOCKLEN + saltLen + 4) * 8;
+    int i = 0;
+
+    /* U1 = HMAC(salt || blockIndex), the salt fits in one block */
+
+    memset(first, 0, sizeof(first));
+    memcpy(first, salt, saltLen);
+    first[saltLen] = (unsigned char)(blockIndex >> 24);
+    first[saltLen + 1] = (unsigned char)(blockIndex >> 16);
+    first[saltLen + 2] = (unsigned char)(blockIndex >> 8);
+    first[saltLen + 3] = (unsigned char)blockIndex;
+    first[saltLen + 4] = 0x80;
+    for (i = 0; i < 8; i++)
+    {
+        first[SHA1BLOCKLEN - 1 - i] = (unsigned char)(bits >> (8 * i));
+    }
+
+    memcpy(u, hmac->inner, sizeof(u));
+    zipVerifySha1Block(u, first);
+
+    /* every other block hashed is a 20 byte digest, padded */
+
+    memset(w, 0, sizeof(w));
+    w[5] = 0x80000000;
+    w[15] = (SHA1BLOCKLEN + SHA1DIGESTLEN) * 8;
+
+    memcpy(w, u, sizeof(u));
+    memcpy(u, hmac->outer, sizeof(u));
+    zipVerifySha1Words(u, w);
+    memcpy(t, u, sizeof(t));
+
+    for (i = 1; i < ZIPAESITERATIONS; i++)
+    {
+        memcpy(w, u, sizeof(u));
+        memcpy(u, hmac->inner, sizeof(u));
+        zipVerifySha1Words(u, w);
+
+        memcpy(w, u, sizeof(u));
+        memcpy(u, hmac->outer, sizeof(u));
+        zipVerifySha1Words(u, w);
+
+        t[0] ^= u[0];
+        t[1] ^= u[1];
+        t[2] ^= u[2];
+        t[3] ^= u[3];
+        t[4] ^= u[4];
+    }
+
+    for (i = 0; i < SHA1DIGESTLEN; i++)
+    {
+        out[i] = (unsigned char)(t[i / 4] >> (24 - 8 * (i % 4)));
+    }
+}
+
+/* zipVerifyCrc - update a CRC-32 with one byte */
+
+#define zipVerifyCrc(table, crc, c) \
+    ((table)[((crc) ^ (c)) & 0xFF] ^ ((crc) >> 8))
+
+/* zipVerifyCryptUpdate - update the ZipCrypto keys with one byte */
+
+#define zipVerifyCryptUpdate(table, keys, c) \
+    do \
+    { \
+        (keys)[0] = zipVerifyCrc((table), (keys)[0], (c)); \
+        (keys)[1] = ((keys)[1] + ((keys)[0] & 0xFF)) * 134775813 + 1; \
+        (keys)[2] = zipVerifyCrc((table), (keys)[2], (keys)[1] >> 24); \
+    } while (0)
+
+/*
+    zipVerifyCryptInit - set up the ZipCrypto keys of a password,
+                         which are the same for every entry
+*/
+
+static void zipVerifyCryptInit(const uint32_t *crcTable,
+                               const char *password,
+                               uint32_t *keys)
+{
+    const unsigned char *p = (const unsigned char *)password;
+
+    keys[0] = 305419896;
+    keys[1] = 591751049;
+    keys[2] = 878082192;
+
+    for (; *p != '\0'; p++)
+    {
+        zipVerifyCryptUpdate(crcTable, keys, *p);
+    }
+}
+
+/*
+    zipVerifyCryptCheck - decrypt a ZipCrypto header with a
+                          password's keys, returns its last byte
+*/
+
+static int zipVerifyCryptCheck(const uint32_t *crcTable,
+                               const uint32_t *passwordKeys,
+                               const unsigned char *header)
+{
+    uint32_t keys[3];
+    uint32_t t = 0;
+    unsigned char c = 0;
+    int i = 0;
+
+    keys[0] = passwordKeys[0];
+    keys[1] = passwordKeys[1];
+    keys[2] = passwordKeys[2];
+
+    for (i = 0; i < ZIPCRYPTHEADERLEN; i++)
+    {
+        t = (keys[2] | 2) & 0xFFFF;
+        c = (unsigned char)(header[i] ^ ((t * (t ^ 1)) >> 8));
+        zipVerifyCryptUpdate(crcTable, keys, c);
+    }
+
+    return c;
+}
+
+/*
+    zipVerifyAESVerifier - get the 2 byte verifier of a password and
+                           salt, from the cache or by deriving the
+                           PBKDF2 block that holds it; the derived key
+                           is the AES key, the HMAC key and then the
+                           verifier, so for a key of n bytes the
+                           verifier is at byte 2n
+*/
+
+static void zipVerifyAESVerifier(zipVerifyWorker_t *worker,
+                                 unsigned int password,
+                                 zipCipher_t cipher,
+                                 const unsigned char *salt,
+                                 size_t saltLen,
+                                 unsigned char *verifier)
+{
+    zipVerifyShared_t *shared = worker->shared;
+    zipVerifyCacheSlot_t *slot = NULL;
+    unsigned char block[SHA1DIGESTLEN];
+    size_t at = (size_t)(8 + 8 * (int)cipher) * 2;
+    uint32_t hash = 2166136261U;
+    size_t i = 0;
+
+    for (i = 0; i < saltLen; i++)
+    {
+        hash = (hash ^ salt[i]) * 16777619U;
+    }
+    hash = (hash ^ password) * 16777619U;
+    slot = &(shared->cache[hash & (ZIPVERIFYCACHESLOTS - 1)]);
+
+    pthread_mutex_lock(&(shared->cacheLock));
+    if (slot->used && slot->password == password &&
+        slot->saltLen == saltLen && memcmp(slot->salt, salt, saltLen) == 0)
+    {
+        verifier[0] = slot->verifier[0];
+        verifier[1] = slot->verifier[1];
+        pthread_mutex_unlock(&(shared->cacheLock));
+        worker->cacheHits++;
+        return;
+    }
+    pthread_mutex_unlock(&(shared->cacheLock));
+
+    zipVerifyPbkdf2Block(&(shared->hmacs[password]),
+                         salt,
+                         saltLen,
+                         (uint32_t)(at / SHA1DIGESTLEN + 1),
+                         block);
+    worker->keysDerived++;
+
+    verifier[0] = block[at % SHA1DIGESTLEN];
+    verifier[1] = block[at % SHA1DIGESTLEN + 1];
+
+    pthread_mutex_lock(&(shared->cacheLock));
+    slot->used = 1;
+    slot->password = password;
+    slot->saltLen = (uint8_t)saltLen;
+    memcpy(slot->salt, salt, saltLen);
+    slot->verifier[0] = verifier[0];
+    slot->verifier[1] = verifier[1];
+    pthread_mutex_unlock(&(shared->cacheLock));
+}
+
+/*
+    zipVerifyEntry - read an entry's local header and encryption
+                     header, and find the first password that passes
+                     its verifier
+*/
+
+static void zipVerifyEntry(zipVerifyWorker_t *worker,
+                           zipVerifyEntry_t *entry)
+{
+    zipVerifyShared_t *shared = worker->shared;
+    unsigned char buf[ZIPVERIFYPEEKLEN];
+    unsigned char verifier[ZIPAESVERIFIERLEN];
+    const unsigned char *data = NULL;
+    size_t saltLen = 0;
+    size_t need = 0;
+    size_t dataOffset = 0;
+    ssize_t len = 0;
+    unsigned int p = 0;
+    unsigned int i = 0;
+    int check = 0;
+
+    entry->password = ZIPVERIFYNOPASSWORD;
+
+    if (entry->cipher == ZipCipherOther)
+    {
+        return;
+    }
+
+    saltLen = (size_t)(4 + 4 * (int)entry->cipher);
+    need = (entry->cipher == ZipCipherZipCrypto ?
+            ZIPCRYPTHEADERLEN : saltLen + ZIPAESVERIFIERLEN);
+
+    len = archDirReadAt(shared->fd, buf, sizeof(buf), (off_t)entry->offset);
+    if (len < ARCHDIRZIPLOCALLEN || memcmp(buf, ARCHDIRZIPLOCALSIG, 4) != 0)
+    {
+        worker->unreadable++;
+        return;
+    }
+
+    /*
+        the ZipCrypto check byte is the high byte of the CRC, or of
+        the modification time if the CRC comes after the data
+    */
+
+    check = (archDirGet16(buf + 6) & ZIPFLAGDATADESC ? buf[11] : buf[17]);
+
+    dataOffset = ARCHDIRZIPLOCALLEN +
+                 archDirGet16(buf + 26) +
+                 archDirGet16(buf + 28);
+    if (dataOffset + need <= (size_t)len)
+    {
+        data = buf + dataOffset;
+    }
+    else if (archDirReadAt(shared->fd,
+                             buf,
+                             need,
+                             (off_t)(entry->offset + dataOffset)) ==
+             (ssize_t)need)
+    {
+        data = buf;
+    }
+    else
+    {
+        worker->unreadable++;
+        return;
+    }
+
+    /* the password that opened the last entry is tried first */
+
+    for (i = 0; i <= shared->numPasswords; i++)
+    {
+        if (i == 0)
+        {
+            p = worker->lastPassword;
+        }
+        else if (i - 1 == worker->lastPassword)
+        {
+            continue;
+        }
+        else
+        {
+            p = i - 1;
+        }
+
+        worker->verifications++;
+
+        if (entry->cipher == ZipCipherZipCrypto)
+        {
+            if (zipVerifyCryptCheck(shared->crcTable,
+                                    &(shared->cryptKeys[3 * p]),
+                                    data) == check)
+            {
+                break;
+            }
+            continue;
+        }
+
+        zipVerifyAESVerifier(worker,
+                             p,
+                             entry->cipher,
+                             data,
+                             saltLen,
+                             verifier);
+        if (verifier[0] == data[saltLen] && verifier[1] == data[saltLen + 1])
+        {
+            break;
+        }
+    }
+
+    if (i <= shared->numPasswords)
+    {
+        entry->password = (int)p;
+        worker->lastPassword = p;
+        worker->opened++;
+    }
+}
+
+/* zipVerifyWorkerMain - check batches of entries until none are left */
+
+static void *zipVerifyWorkerMain(void *arg)
+{
+    zipVerifyWorker_t *worker = (zipVerifyWorker_t *)arg;
+    zipVerifyShared_t *shared = worker->shared;
+    zipVerify_t *info = shared->info;
+    uint32_t first = 0;
+    uint32_t i = 0;
+
+    for (;;)
+    {
+        first = __atomic_fetch_add(&(shared->nextEntry),
+                                   ZIPVERIFYBATCH,
+                                   __ATOMIC_SEQ_CST);
+        if (first >= info->numEncrypted)
+        {
+            break;
+        }
+
+        for (i = first; i < info->numEncrypted && i < first + ZIPVERIFYBATCH;
+             i++)
+        {
+            zipVerifyEntry(worker, &(info->entries[i]));
+        }
+    }
+
+    return NULL;
+}
+
+/*
+    zipVerifyParseCD - list the encrypted entries in the central
+                       directory: the first pass counts them and their
+                       names' bytes, the second fills in info
+*/
+
+static int zipVerifyParseCD(const archDirCursor_t *cd,
+                            uint64_t numEntries,
+                            int64_t delta,
+                            zipVerify_t *info)
+{
+    archDirCursor_t c;
+    archDirZipEntry_t zipEntry;
+    zipVerifyEntry_t *entry = NULL;
+    const unsigned char *aes = NULL;
+    size_t aesLen = 0;
+    size_t namesLen = 0;
+    size_t namesSize = 0;
+    uint64_t i = 0;
+    uint32_t numEncrypted = 0;
+    int pass = 0;
+
+    for (pass = 0; pass < 2; pass++)
+    {
+        c = *cd;
+        numEncrypted = 0;
+        namesLen = 0;
+
+        for (i = 0; i < numEntries && numEncrypted < ZIPVERIFYMAXENTRIES;
+             i++)
+        {
+            if (archDirZipNext(&c, delta, &zipEntry) != gArchDirOkay)
+            {
+                return gZipVerifyErr;
+            }
+
+            if ((zipEntry.flags & ZIPFLAGENCRYPTED) == 0)
+            {
+                continue;
+            }
+
+            if (pass == 0)
+            {
+                numEncrypted++;
+                namesSize += zipEntry.nameLen + 1;
+                continue;
+            }
+
+            entry = &(info->entries[numEncrypted++]);
+            entry->name = info->names + namesLen;
+            memcpy(info->names + namesLen, zipEntry.name, zipEntry.nameLen);
+            namesLen += zipEntry.nameLen;
+            info->names[namesLen++] = '\0';
+
+            entry->cipher = (zipEntry.flags & ZIPFLAGSTRONG ?
+                             ZipCipherOther : ZipCipherZipCrypto);
+            entry->password = ZIPVERIFYNOPASSWORD;
+            entry->offset = zipEntry.offset;
+
+            /* the AES extra field has the key's strength */
+
+            if (zipEntry.method == ZIPAESMETHOD &&
+                entry->cipher == ZipCipherZipCrypto)
+            {
+                entry->cipher = ZipCipherOther;
+                aes = archDirZipExtra(&zipEntry, ZIPAESEXTRAID, &aesLen);
+                if (aes != NULL && aesLen >= 7 &&
+                    aes[4] >= 1 && aes[4] <= 3)
+                {
+                    entry->cipher = (zipCipher_t)aes[4];
+                }
+            }
+        }
+
+        if (pass == 0)
+        {
+            info->numEntries = i;
+            if (numEncrypted == 0)
+            {
+                return gZipVerifyOkay;
+            }
+
+            info->entries = calloc(numEncrypted, sizeof(zipVerifyEntry_t));
+            info->names = malloc(namesSize);
+            if (info->entries == NULL || info->names == NULL)
+            {
+                return gZipVerifyErr;
+            }
+        }
+    }
+
+    info->numEncrypted = numEncrypted;
+
+    return gZipVerifyOkay;
+}
+
+/*
+    zipVerifyRun - set up each password's ZipCrypto keys and HMAC
+                   states, and check the entries on numWorkers threads
+*/
+
+static int zipVerifyRun(int fd,
+                        const char * const *passwords,
+                        unsigned int numPasswords,
+                        int numWorkers,
+                        zipVerify_t *info)
+{
+    zipVerifyShared_t shared;
+    zipVerifyWorker_t *workers = NULL;
+    unsigned int maxWorkers = 0;
+    unsigned int i = 0;
+    uint32_t crc = 0;
+    int j = 0;
+    int rc = gZipVerifyOkay;
+
+    memset(&shared, 0, sizeof(zipVerifyShared_t));
+    shared.fd = fd;
+    shared.info = info;
+    shared.passwords = passwords;
+    shared.numPasswords = numPasswords;
+
+    for (i = 0; i < 256; i++)
+    {
+        crc = i;
+        for (j = 0; j < 8; j++)
+        {
+            crc = (crc & 1 ? (crc >> 1) ^ 0xEDB88320 : crc >> 1);
+        }
+        shared.crcTable[i] = crc;
+    }
+
+    shared.hmacs = malloc(numPasswords * sizeof(zipVerifyHmac_t));
+    shared.cryptKeys = malloc(numPasswords * 3 * sizeof(uint32_t));
+    shared.cache = calloc(ZIPVERIFYCACHESLOTS, sizeof(zipVerifyCacheSlot_t));
+    if (shared.hmacs == NULL || shared.cryptKeys == NULL ||
+        shared.cache == NULL)
+    {
+        free(shared.hmacs);
+        free(shared.cryptKeys);
+        free(shared.cache);
+        return gZipVerifyErr;
+    }
+
+    for (i = 0; i < numPasswords; i++)
+    {
+        zipVerifyHmacInit(&(shared.hmacs[i]), passwords[i]);
+        zipVerifyCryptInit(shared.crcTable,
+                           passwords[i],
+                           &(shared.cryptKeys[3 * i]));
+    }
+
+    pthread_mutex_init(&(shared.cacheLock), NULL);
+
+    /* no more workers than batches */
+
+    maxWorkers = (info->numEncrypted + ZIPVERIFYBATCH - 1) / ZIPVERIFYBATCH;
+    if ((unsigned int)numWorkers < maxWorkers)
+    {
+        maxWorkers = (unsigned int)numWorkers;
+    }
+
+    workers = calloc(maxWorkers > 0 ? maxWorkers : 1,
+                     sizeof(zipVerifyWorker_t));
+    if (workers == NULL)
+    {
+        rc = gZipVerifyErr;
+        maxWorkers = 0;
+    }
+
+    for (i = 0; i < maxWorkers; i++)
+    {
+        workers[i].shared = &shared;
+        if (pthread_create(&(workers[i].thread),
+                           NULL,
+                           zipVerifyWorkerMain,
+                           &(workers[i])) != 0)
+        {
+            break;
+        }
+        workers[i].started = 1;
+        info->workers++;
+    }
+
+    /* a worker that couldn't be started leaves its batches to the others */
+
+    for (i = 0; i < maxWorkers; i++)
+    {
+        if (workers[i].started != 0)
+        {
+            pthread_join(workers[i].thread, NULL);
+        }
+        info->numOpened += workers[i].opened;
+        info->numUnreadable += workers[i].unreadable;
+        info->verifications += workers[i].verifications;
+        info->keysDerived += workers[i].keysDerived;
+        info->cacheHits += workers[i].cacheHits;
+    }
+
+    if (info->numEncrypted > 0 && info->workers == 0)
+    {
+        rc = gZipVerifyErr;
+    }
+
+    free(workers);
+    pthread_mutex_destroy(&(shared.cacheLock));
+    free(shared.cache);
+    free(shared.cryptKeys);
+    free(shared.hmacs);
+
+    return rc;
+}
+
+/* public functions */
+
+/*
+    zipVerifyRead - check passwords against the encrypted entries of
+                    the zip archive at path
+*/
+
+int zipVerifyRead(const char *path,
+                  const char * const *passwords,
+                  unsigned int numPasswords,
+                  int numWorkers,
+                  zipVerify_t *info)
+{
+    int fd = -1;
+    int err = gZipVerifyErr;
+
+    if (path == NULL || info == NULL)
+    {
+        return gZipVerifyErr;
+    }
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        memset(info, 0, sizeof(zipVerify_t));
+        return gZipVerifyErr;
+    }
+
+    err = zipVerifyReadFd(fd, passwords, numPasswords, numWorkers, info);
+
+    close(fd);
+
+    return err;
+}
+
+/*
+    zipVerifyReadFd - check passwords against the encrypted entries of
+                      the zip archive open on fd; the entries and their
+                      results are in info, which must be freed with
+                      zipVerifyFree()
+*/
+
+int zipVerifyReadFd(int fd,
+                    const char * const *passwords,
+                    unsigned int numPasswords,
+                    int numWorkers,
+                    zipVerify_t *info)
+{
+    struct stat sb;
+    archDirZip_t zip;
+    archDirCursor_t cd;
+    int err = gZipVerifyErr;
+
+    if (info == NULL)
+    {
+        return gZipVerifyErr;
+    }
+
+    memset(info, 0, sizeof(zipVerify_t));
+
+    if (fd < 0 || passwords == NULL || numPasswords == 0 ||
+        numPasswords > ZIPVERIFYMAXPASSWORDS ||
+        numWorkers < 1 || numWorkers > ZIPVERIFYMAXWORKERS ||
+        fstat(fd, &sb) != 0)
+    {
+        return gZipVerifyErr;
+    }
+
+    if (archDirZipFind(fd, sb.st_size, &zip) != gArchDirOkay)
+    {
+        return gZipVerifyErr;
+    }
+
+    if (archDirZipLoad(fd, &zip, ZIPVERIFYMAXCD, &cd) == gArchDirOkay)
+    {
+        err = zipVerifyParseCD(&cd, zip.numEntries, zip.delta, info);
+    }
+
+    archDirZipFree(&zip);
+
+    if (err == gZipVerifyOkay)
+    {
+        err = zipVerifyRun(fd, passwords, numPasswords, numWorkers, info);
+    }
+
+    if (err != gZipVerifyOkay)
+    {
+        zipVerifyFree(info);
+    }
+
+    return err;
+}
+
+/* zipVerifyFree - free the entries */
+
+void zipVerifyFree(zipVerify_t *info)
+{
+    if (info == NULL)
+    {
+        return;
+    }
+
+    free(info->entries);
+    free(info->names);
+    info->entries = NULL;
+    info->names = NULL;
+    info->numEncrypted = 0;
+    info->numOpened = 0;
+}
+
+/* zipVerifyCipherName - get the name of a cipher */
+
+const char *zipVerifyCipherName(zipCipher_t cipher)
+{
+    switch (cipher)
+    {
+        case ZipCipherZipCrypto:
+            return "ZipCrypto";
+        case ZipCipherAES128:
+            return "AES-128";
+        case ZipCipherAES192:
+            return "AES-192";
+        case ZipCipherAES256:
+            return "AES-256";
+        default:
+            break;
+    }
+
+    return "other";
+}
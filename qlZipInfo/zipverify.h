@@ -0,0 +1,160 @@
+/*
+    zipverify.h - check zip passwords with the entries' verifiers
+
+    History:
+
+    v. 0.1.0 (10/17/2026) - initial release
+
+    Based on:
+
+    https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+    https://www.winzip.com/en/support/aes-encryption/
+    https://www.rfc-editor.org/rfc/rfc8018
+
+    Copyright (c) 2026 Sriranga R. Veeraraghavan <ranga@calalum.org>
+
+    Permission is hereby granted, free of charge, to any person obtaining
+    a copy of this software and associated documentation files (the
+    "Software") to deal in the Software without restriction, including
+    without limitation the rights to use, copy, modify, merge, publish,
+    distribute, sublicense, and/or sell copies of the Software, and to
+    permit persons to whom the Software is furnished to do so, subject
+    to the following conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+    zipVerifyRead() finds which of a list of passwords opens each
+    encrypted entry of a zip archive, without decrypting any of the
+    entries' data:
+
+        - The central directory is read once, on the calling thread,
+          for the encrypted entries' names and local header offsets.
+        - numWorkers threads then take the entries ZIPVERIFYBATCH at
+          a time.  For each entry a worker reads the local header and
+          the few bytes after it: the 12 byte encryption header of a
+          ZipCrypto (traditional PKWARE) entry, or the salt and the 2
+          byte password verifier of a WinZip AES entry.
+        - A ZipCrypto password's keys are set up once, so each check
+          decrypts the 12 byte header and compares its last byte with
+          the entry's check byte.
+        - A WinZip AES check derives only the PBKDF2-HMAC-SHA1 block
+          (1,000 iterations) that holds the verifier, not the AES and
+          HMAC keys in front of it, from HMAC states that are set up
+          once per password.  Verifiers are cached by salt and
+          password, so entries that share a salt are checked once.
+
+    Each worker first tries the password that passed its last entry,
+    and then the others in order, and the first one that passes an
+    entry's verifier is reported.  A wrong password passes a ZipCrypto
+    check about once in 256 tries, and a WinZip AES check about once
+    in 65,536, so a password that passes should be confirmed by
+    extracting the entry.  Entries with other kinds of encryption
+    (PKWARE strong encryption) are listed but not checked.
+*/
+
+#ifndef qlZipInfo_zipverify_h
+#define qlZipInfo_zipverify_h
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/* return codes */
+
+enum
+{
+    gZipVerifyErr  = -1,
+    gZipVerifyOkay =  0,
+};
+
+/* the entry's password isn't in the list */
+
+#define ZIPVERIFYNOPASSWORD -1
+
+/* most bytes of central directory that are read */
+
+#define ZIPVERIFYMAXCD      (256 * 1024 * 1024)
+
+/* most entries that are checked */
+
+#define ZIPVERIFYMAXENTRIES 1000000
+
+/* most passwords */
+
+#define ZIPVERIFYMAXPASSWORDS 65536
+
+/* entries a worker takes at a time */
+
+#define ZIPVERIFYBATCH      32
+
+/* verifiers that are cached (a power of 2) */
+
+#define ZIPVERIFYCACHESLOTS 4096
+
+/* most workers */
+
+#define ZIPVERIFYMAXWORKERS 64
+
+/* ciphers */
+
+typedef enum
+{
+    ZipCipherZipCrypto = 0,
+    ZipCipherAES128    = 1,
+    ZipCipherAES192    = 2,
+    ZipCipherAES256    = 3,
+    ZipCipherOther     = 4,
+} zipCipher_t;
+
+/* an encrypted entry */
+
+typedef struct zipVerifyEntry
+{
+    const char *name;
+    uint64_t offset;
+    zipCipher_t cipher;
+    int password;
+} zipVerifyEntry_t;
+
+/* an archive */
+
+typedef struct zipVerify
+{
+    uint64_t numEntries;
+    uint32_t numEncrypted;
+    zipVerifyEntry_t *entries;
+    char *names;
+    uint32_t numOpened;
+    uint32_t numUnreadable;
+    uint64_t verifications;
+    uint64_t keysDerived;
+    uint64_t cacheHits;
+    unsigned int workers;
+} zipVerify_t;
+
+/* prototypes */
+
+int zipVerifyRead(const char *path,
+                  const char * const *passwords,
+                  unsigned int numPasswords,
+                  int numWorkers,
+                  zipVerify_t *info);
+int zipVerifyReadFd(int fd,
+                    const char * const *passwords,
+                    unsigned int numPasswords,
+                    int numWorkers,
+                    zipVerify_t *info);
+void zipVerifyFree(zipVerify_t *info);
+const char *zipVerifyCipherName(zipCipher_t cipher);
+
+#endif /* qlZipInfo_zipverify_h */